@@ -0,0 +1,638 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+
+/*
+===============================================================================
+
+	Bounding volume hierarchy over the polygons and brushes of a collision model.
+
+	The hierarchy is a flat array of four wide nodes built with the surface area
+	heuristic. Every polygon and brush is stored in exactly one leaf, the polygons
+	of a leaf are packed in groups of four with their bounds, normals and contents
+	so the cheap rejection tests of the polygon trace functions can be done four
+	at a time. Nodes and polygons are culled against the trace bounds which are the
+	same bounds the polygon trace functions reject against, so a trace through the
+	hierarchy finds the same collisions as a trace through the axial BSP tree.
+
+===============================================================================
+*/
+
+#pragma hdrstop
+#include "precompiled.h"
+
+
+#include "CollisionModel_local.h"
+
+idCVar cm_useBVH( "cm_useBVH", "0", CVAR_GAME | CVAR_BOOL, "trace through a bounding volume hierarchy instead of the BSP tree for map collision models built after this is set" );
+idCVar cm_testBVH( "cm_testBVH", "0", CVAR_GAME | CVAR_BOOL, "also trace through the BSP tree when using the bounding volume hierarchy and report differences" );
+
+#define BVH_NUM_BINS		16
+
+typedef struct cm_bvhPrimitive_s
+{
+	idBounds				bounds;
+	idVec3					center;
+	cm_polygon_t* 			polygon;
+	cm_brush_t* 			brush;
+} cm_bvhPrimitive_t;
+
+typedef struct cm_bvhBuild_s
+{
+	idList< cm_bvhNode_t >			nodes;
+	idList< cm_bvhLeaf_t >			leafs;
+	idList< cm_bvhPolygonGroup_t >	polygonGroups;
+	idList< cm_brush_t* >			brushes;
+} cm_bvhBuild_t;
+
+/*
+================
+CM_CollectBVHPrimitives_r
+================
+*/
+static void CM_CollectBVHPrimitives_r( cm_node_t* node, int checkCount, idList< cm_bvhPrimitive_t >& primitives )
+{
+	cm_polygonRef_t* pref;
+	cm_brushRef_t* bref;
+	
+	while( 1 )
+	{
+		for( pref = node->polygons; pref; pref = pref->next )
+		{
+			if( pref->p->checkcount == checkCount )
+			{
+				continue;
+			}
+			pref->p->checkcount = checkCount;
+			
+			cm_bvhPrimitive_t& prim = primitives.Alloc();
+			prim.bounds = pref->p->bounds;
+			prim.center = pref->p->bounds.GetCenter();
+			prim.polygon = pref->p;
+			prim.brush = NULL;
+		}
+		for( bref = node->brushes; bref; bref = bref->next )
+		{
+			if( bref->b->checkcount == checkCount )
+			{
+				continue;
+			}
+			bref->b->checkcount = checkCount;
+			
+			cm_bvhPrimitive_t& prim = primitives.Alloc();
+			prim.bounds = bref->b->bounds;
+			prim.center = bref->b->bounds.GetCenter();
+			prim.polygon = NULL;
+			prim.brush = bref->b;
+		}
+		if( node->planeType == -1 )
+		{
+			break;
+		}
+		CM_CollectBVHPrimitives_r( node->children[1], checkCount, primitives );
+		node = node->children[0];
+	}
+}
+
+/*
+================
+CM_BVHBoundsArea
+================
+*/
+static float CM_BVHBoundsArea( const idBounds& bounds )
+{
+	if( bounds.IsCleared() )
+	{
+		return 0.0f;
+	}
+	idVec3 size = bounds[1] - bounds[0];
+	return size[0] * size[1] + size[1] * size[2] + size[2] * size[0];
+}
+
+/*
+================
+CM_SplitBVHPrimitives
+
+  Sorts the primitives into two ranges with the binned surface area heuristic and
+  returns the number of primitives in the first range.
+================
+*/
+static int CM_SplitBVHPrimitives( cm_bvhPrimitive_t* prims, int numPrims )
+{
+	int i, axis, bin, bestSplit, numLeft;
+	float scale, cost, bestCost;
+	idBounds centerBounds;
+	idBounds binBounds[BVH_NUM_BINS], rightBounds[BVH_NUM_BINS];
+	int binCounts[BVH_NUM_BINS];
+	
+	centerBounds.Clear();
+	for( i = 0; i < numPrims; i++ )
+	{
+		centerBounds.AddPoint( prims[i].center );
+	}
+	
+	idVec3 size = centerBounds[1] - centerBounds[0];
+	axis = ( size[0] >= size[1] && size[0] >= size[2] ) ? 0 : ( ( size[1] >= size[2] ) ? 1 : 2 );
+	if( size[axis] < 0.01f )
+	{
+		// all centers at the same position, any split is as good as the other
+		return numPrims / 2;
+	}
+	scale = BVH_NUM_BINS / size[axis];
+	
+	for( i = 0; i < BVH_NUM_BINS; i++ )
+	{
+		binBounds[i].Clear();
+		binCounts[i] = 0;
+	}
+	for( i = 0; i < numPrims; i++ )
+	{
+		bin = idMath::ClampInt( 0, BVH_NUM_BINS - 1, ( int )( ( prims[i].center[axis] - centerBounds[0][axis] ) * scale ) );
+		binBounds[bin].AddBounds( prims[i].bounds );
+		binCounts[bin]++;
+	}
+	
+	// bounds of everything right of each split
+	rightBounds[BVH_NUM_BINS - 1] = binBounds[BVH_NUM_BINS - 1];
+	for( i = BVH_NUM_BINS - 2; i >= 0; i-- )
+	{
+		rightBounds[i] = rightBounds[i + 1];
+		rightBounds[i].AddBounds( binBounds[i] );
+	}
+	
+	idBounds leftBounds;
+	leftBounds.Clear();
+	bestSplit = -1;
+	bestCost = idMath::INFINITY;
+	numLeft = 0;
+	for( i = 0; i < BVH_NUM_BINS - 1; i++ )
+	{
+		leftBounds.AddBounds( binBounds[i] );
+		numLeft += binCounts[i];
+		if( numLeft == 0 || numLeft == numPrims )
+		{
+			continue;
+		}
+		cost = CM_BVHBoundsArea( leftBounds ) * numLeft + CM_BVHBoundsArea( rightBounds[i + 1] ) * ( numPrims - numLeft );
+		if( cost < bestCost )
+		{
+			bestCost = cost;
+			bestSplit = i;
+		}
+	}
+	if( bestSplit == -1 )
+	{
+		return numPrims / 2;
+	}
+	
+	// move the primitives left of the split to the front
+	numLeft = 0;
+	for( i = 0; i < numPrims; i++ )
+	{
+		bin = idMath::ClampInt( 0, BVH_NUM_BINS - 1, ( int )( ( prims[i].center[axis] - centerBounds[0][axis] ) * scale ) );
+		if( bin <= bestSplit )
+		{
+			SwapValues( prims[i], prims[numLeft] );
+			numLeft++;
+		}
+	}
+	return numLeft;
+}
+
+/*
+================
+CM_BuildBVHLeaf
+================
+*/
+static int CM_BuildBVHLeaf( cm_bvhBuild_t& build, cm_bvhPrimitive_t* prims, int numPrims )
+{
+	int i, j, k;
+	
+	cm_bvhLeaf_t& leaf = build.leafs.Alloc();
+	leaf.firstPolygonGroup = build.polygonGroups.Num();
+	leaf.numPolygonGroups = 0;
+	leaf.firstBrush = build.brushes.Num();
+	leaf.numBrushes = 0;
+	
+	cm_bvhPolygonGroup_t* group = NULL;
+	k = 4;
+	for( i = 0; i < numPrims; i++ )
+	{
+		if( prims[i].brush != NULL )
+		{
+			build.brushes.Append( prims[i].brush );
+			leaf.numBrushes++;
+			continue;
+		}
+		
+		if( k == 4 )
+		{
+			// start a new group with all entries unused
+			group = &build.polygonGroups.Alloc();
+			for( j = 0; j < 4; j++ )
+			{
+				group->bounds[0][j] = group->bounds[1][j] = group->bounds[2][j] = idMath::INFINITY;
+				group->bounds[3][j] = group->bounds[4][j] = group->bounds[5][j] = -idMath::INFINITY;
+				group->normal[0][j] = group->normal[1][j] = group->normal[2][j] = 0.0f;
+				group->contents[j] = 0;
+				group->polygons[j] = NULL;
+			}
+			leaf.numPolygonGroups++;
+			k = 0;
+		}
+		
+		const cm_polygon_t* p = prims[i].polygon;
+		for( j = 0; j < 3; j++ )
+		{
+			group->bounds[j][k] = p->bounds[0][j];
+			group->bounds[3 + j][k] = p->bounds[1][j];
+			group->normal[j][k] = p->plane.Normal()[j];
+		}
+		group->contents[k] = p->contents;
+		group->polygons[k] = prims[i].polygon;
+		k++;
+	}
+	
+	return build.leafs.Num() - 1;
+}
+
+/*
+================
+CM_BuildBVHNode_r
+================
+*/
+static int CM_BuildBVHNode_r( cm_bvhBuild_t& build, cm_bvhPrimitive_t* prims, int numPrims, int depth )
+{
+	int i, j, k, split, numRanges, nodeNum, child;
+	int first[4], count[4];
+	idBounds bounds;
+	
+	// split the largest range until there are four ranges or all ranges fit in a leaf
+	first[0] = 0;
+	count[0] = numPrims;
+	numRanges = 1;
+	while( numRanges < 4 )
+	{
+		j = -1;
+		for( i = 0; i < numRanges; i++ )
+		{
+			if( count[i] > CM_BVH_MAX_LEAF_PRIMITIVES && ( j == -1 || count[i] > count[j] ) )
+			{
+				j = i;
+			}
+		}
+		if( j == -1 )
+		{
+			break;
+		}
+		split = CM_SplitBVHPrimitives( prims + first[j], count[j] );
+		first[numRanges] = first[j] + split;
+		count[numRanges] = count[j] - split;
+		count[j] = split;
+		numRanges++;
+	}
+	
+	nodeNum = build.nodes.Num();
+	cm_bvhNode_t& node = build.nodes.Alloc();
+	for( i = 0; i < 4; i++ )
+	{
+		node.bounds[0][i] = node.bounds[1][i] = node.bounds[2][i] = idMath::INFINITY;
+		node.bounds[3][i] = node.bounds[4][i] = node.bounds[5][i] = -idMath::INFINITY;
+		node.children[i] = 0;
+	}
+	
+	for( i = 0; i < numRanges; i++ )
+	{
+		bounds.Clear();
+		for( k = 0; k < count[i]; k++ )
+		{
+			bounds.AddBounds( prims[first[i] + k].bounds );
+		}
+		
+		if( count[i] <= CM_BVH_MAX_LEAF_PRIMITIVES || depth >= CM_BVH_MAX_DEPTH - 1 )
+		{
+			child = -1 - CM_BuildBVHLeaf( build, prims + first[i], count[i] );
+		}
+		else
+		{
+			child = CM_BuildBVHNode_r( build, prims + first[i], count[i], depth + 1 );
+		}
+		
+		// the node list may have been reallocated
+		cm_bvhNode_t& n = build.nodes[nodeNum];
+		for( j = 0; j < 3; j++ )
+		{
+			n.bounds[j][i] = bounds[0][j];
+			n.bounds[3 + j][i] = bounds[1][j];
+		}
+		n.children[i] = child;
+	}
+	
+	return nodeNum;
+}
+
+/*
+================
+idCollisionModelManagerLocal::BuildBVH
+================
+*/
+void idCollisionModelManagerLocal::BuildBVH( cm_model_t* model )
+{
+	idList< cm_bvhPrimitive_t > primitives;
+	cm_bvhBuild_t build;
+	
+	FreeBVH( model );
+	
+	if( !model->node )
+	{
+		return;
+	}
+	
+	primitives.SetGranularity( 1024 );
+	checkCount++;
+	CM_CollectBVHPrimitives_r( model->node, checkCount, primitives );
+	if( primitives.Num() == 0 )
+	{
+		return;
+	}
+	
+	build.nodes.SetGranularity( 256 );
+	build.leafs.SetGranularity( 1024 );
+	build.polygonGroups.SetGranularity( 1024 );
+	build.brushes.SetGranularity( 1024 );
+	CM_BuildBVHNode_r( build, primitives.Ptr(), primitives.Num(), 0 );
+	
+	// copy to tight arrays
+	model->numBvhNodes = build.nodes.Num();
+	model->bvhNodes = ( cm_bvhNode_t* ) Mem_Alloc( model->numBvhNodes * sizeof( cm_bvhNode_t ), TAG_COLLISION );
+	memcpy( model->bvhNodes, build.nodes.Ptr(), model->numBvhNodes * sizeof( cm_bvhNode_t ) );
+	
+	model->numBvhLeafs = build.leafs.Num();
+	model->bvhLeafs = ( cm_bvhLeaf_t* ) Mem_Alloc( model->numBvhLeafs * sizeof( cm_bvhLeaf_t ), TAG_COLLISION );
+	memcpy( model->bvhLeafs, build.leafs.Ptr(), model->numBvhLeafs * sizeof( cm_bvhLeaf_t ) );
+	
+	model->numBvhPolygonGroups = build.polygonGroups.Num();
+	if( model->numBvhPolygonGroups > 0 )
+	{
+		model->bvhPolygonGroups = ( cm_bvhPolygonGroup_t* ) Mem_Alloc( model->numBvhPolygonGroups * sizeof( cm_bvhPolygonGroup_t ), TAG_COLLISION );
+		memcpy( model->bvhPolygonGroups, build.polygonGroups.Ptr(), model->numBvhPolygonGroups * sizeof( cm_bvhPolygonGroup_t ) );
+	}
+	
+	model->numBvhBrushes = build.brushes.Num();
+	if( model->numBvhBrushes > 0 )
+	{
+		model->bvhBrushes = ( cm_brush_t** ) Mem_Alloc( model->numBvhBrushes * sizeof( cm_brush_t* ), TAG_COLLISION );
+		memcpy( model->bvhBrushes, build.brushes.Ptr(), model->numBvhBrushes * sizeof( cm_brush_t* ) );
+	}
+	
+	model->usedMemory += model->numBvhNodes * sizeof( cm_bvhNode_t ) +
+						 model->numBvhLeafs * sizeof( cm_bvhLeaf_t ) +
+						 model->numBvhPolygonGroups * sizeof( cm_bvhPolygonGroup_t ) +
+						 model->numBvhBrushes * sizeof( cm_brush_t* );
+}
+
+/*
+================
+idCollisionModelManagerLocal::FreeBVH
+================
+*/
+void idCollisionModelManagerLocal::FreeBVH( cm_model_t* model )
+{
+	if( model->bvhNodes == NULL )
+	{
+		return;
+	}
+	
+	model->usedMemory -= model->numBvhNodes * sizeof( cm_bvhNode_t ) +
+						 model->numBvhLeafs * sizeof( cm_bvhLeaf_t ) +
+						 model->numBvhPolygonGroups * sizeof( cm_bvhPolygonGroup_t ) +
+						 model->numBvhBrushes * sizeof( cm_brush_t* );
+						 
+	Mem_Free( model->bvhNodes );
+	Mem_Free( model->bvhLeafs );
+	Mem_Free( model->bvhPolygonGroups );
+	Mem_Free( model->bvhBrushes );
+	model->bvhNodes = NULL;
+	model->bvhLeafs = NULL;
+	model->bvhPolygonGroups = NULL;
+	model->bvhBrushes = NULL;
+	model->numBvhNodes = model->numBvhLeafs = model->numBvhPolygonGroups = model->numBvhBrushes = 0;
+}
+
+/*
+================
+idCollisionModelManagerLocal::TraceTrmThroughBVHLeaf
+================
+*/
+void idCollisionModelManagerLocal::TraceTrmThroughBVHLeaf( cm_traceWork_t* tw, const cm_model_t* model, const cm_bvhLeaf_t* leaf )
+{
+	int i, j, mask;
+	
+	// position test
+	if( tw->positionTest )
+	{
+		// test if any of the trm vertices is inside a brush
+		for( i = 0; i < leaf->numBrushes; i++ )
+		{
+			if( idCollisionModelManagerLocal::TestTrmVertsInBrush( tw, model->bvhBrushes[leaf->firstBrush + i] ) )
+			{
+				return;
+			}
+		}
+		// if just testing a point we're done
+		if( tw->pointTrace )
+		{
+			return;
+		}
+	}
+	
+	// only translations reject polygons that are not approached at the front
+	const bool frontOnly = !tw->positionTest && !tw->rotation;
+	
+	const cm_bvhPolygonGroup_t* group = model->bvhPolygonGroups + leaf->firstPolygonGroup;
+	for( i = 0; i < leaf->numPolygonGroups; i++, group++ )
+	{
+		// reject polygons without the right contents, outside the trace bounds or facing away from the trace
+#if defined(USE_INTRINSICS)
+		__m128 overlap;
+		overlap = _mm_and_ps( _mm_cmple_ps( _mm_loadu_ps( group->bounds[0] ), _mm_set1_ps( tw->bounds[1][0] ) ), _mm_cmpge_ps( _mm_loadu_ps( group->bounds[3] ), _mm_set1_ps( tw->bounds[0][0] ) ) );
+		overlap = _mm_and_ps( overlap, _mm_and_ps( _mm_cmple_ps( _mm_loadu_ps( group->bounds[1] ), _mm_set1_ps( tw->bounds[1][1] ) ), _mm_cmpge_ps( _mm_loadu_ps( group->bounds[4] ), _mm_set1_ps( tw->bounds[0][1] ) ) ) );
+		overlap = _mm_and_ps( overlap, _mm_and_ps( _mm_cmple_ps( _mm_loadu_ps( group->bounds[2] ), _mm_set1_ps( tw->bounds[1][2] ) ), _mm_cmpge_ps( _mm_loadu_ps( group->bounds[5] ), _mm_set1_ps( tw->bounds[0][2] ) ) ) );
+		
+		__m128i contents = _mm_and_si128( _mm_loadu_si128( ( const __m128i* ) group->contents ), _mm_set1_epi32( tw->contents ) );
+		overlap = _mm_andnot_ps( _mm_castsi128_ps( _mm_cmpeq_epi32( contents, _mm_setzero_si128() ) ), overlap );
+		
+		if( frontOnly )
+		{
+			__m128 d = _mm_mul_ps( _mm_loadu_ps( group->normal[0] ), _mm_set1_ps( tw->dir[0] ) );
+			d = _mm_add_ps( d, _mm_mul_ps( _mm_loadu_ps( group->normal[1] ), _mm_set1_ps( tw->dir[1] ) ) );
+			d = _mm_add_ps( d, _mm_mul_ps( _mm_loadu_ps( group->normal[2] ), _mm_set1_ps( tw->dir[2] ) ) );
+			overlap = _mm_and_ps( overlap, _mm_cmple_ps( d, _mm_setzero_ps() ) );
+		}
+		mask = _mm_movemask_ps( overlap );
+#else
+		mask = 0;
+		for( j = 0; j < 4; j++ )
+		{
+			if( !( group->contents[j] & tw->contents ) )
+			{
+				continue;
+			}
+			if( group->bounds[0][j] > tw->bounds[1][0] || group->bounds[3][j] < tw->bounds[0][0] ||
+					group->bounds[1][j] > tw->bounds[1][1] || group->bounds[4][j] < tw->bounds[0][1] ||
+					group->bounds[2][j] > tw->bounds[1][2] || group->bounds[5][j] < tw->bounds[0][2] )
+			{
+				continue;
+			}
+			if( frontOnly && group->normal[0][j] * tw->dir[0] + group->normal[1][j] * tw->dir[1] + group->normal[2][j] * tw->dir[2] > 0.0f )
+			{
+				continue;
+			}
+			mask |= 1 << j;
+		}
+#endif
+		
+		for( j = 0; mask != 0; j++, mask >>= 1 )
+		{
+			if( !( mask & 1 ) )
+			{
+				continue;
+			}
+			
+			cm_polygon_t* p = group->polygons[j];
+			if( tw->positionTest )
+			{
+				if( idCollisionModelManagerLocal::TestTrmInPolygon( tw, p ) )
+				{
+					return;
+				}
+			}
+			else if( tw->rotation )
+			{
+				if( idCollisionModelManagerLocal::RotateTrmThroughPolygon( tw, p ) )
+				{
+					return;
+				}
+			}
+			else
+			{
+				if( idCollisionModelManagerLocal::TranslateTrmThroughPolygon( tw, p ) )
+				{
+					return;
+				}
+			}
+		}
+	}
+}
+
+/*
+================
+idCollisionModelManagerLocal::TraceThroughBVH
+
+  The trace bounds cover the whole movement, also for rotations, and shrink when
+  a translation collides so later nodes are culled against the nearest collision.
+================
+*/
+void idCollisionModelManagerLocal::TraceThroughBVH( cm_traceWork_t* tw )
+{
+	int i, mask, nodeNum, numChildren, stackDepth;
+	int stack[CM_BVH_MAX_DEPTH * 3 + 1];
+	int children[4];
+	float order[4];
+	const cm_model_t* model = tw->model;
+	
+	stack[0] = 0;
+	stackDepth = 1;
+	while( stackDepth > 0 )
+	{
+		if( tw->quickExit )
+		{
+			return;		// stop immediately
+		}
+		
+		// if already stuck in solid
+		if( tw->positionTest && tw->trace.fraction == 0.0f )
+		{
+			return;
+		}
+		
+		nodeNum = stack[--stackDepth];
+		if( nodeNum < 0 )
+		{
+			idCollisionModelManagerLocal::TraceTrmThroughBVHLeaf( tw, model, &model->bvhLeafs[-1 - nodeNum] );
+			continue;
+		}
+		
+		const cm_bvhNode_t* node = &model->bvhNodes[nodeNum];
+		
+#if defined(USE_INTRINSICS)
+		__m128 overlap;
+		overlap = _mm_and_ps( _mm_cmple_ps( _mm_loadu_ps( node->bounds[0] ), _mm_set1_ps( tw->bounds[1][0] ) ), _mm_cmpge_ps( _mm_loadu_ps( node->bounds[3] ), _mm_set1_ps( tw->bounds[0][0] ) ) );
+		overlap = _mm_and_ps( overlap, _mm_and_ps( _mm_cmple_ps( _mm_loadu_ps( node->bounds[1] ), _mm_set1_ps( tw->bounds[1][1] ) ), _mm_cmpge_ps( _mm_loadu_ps( node->bounds[4] ), _mm_set1_ps( tw->bounds[0][1] ) ) ) );
+		overlap = _mm_and_ps( overlap, _mm_and_ps( _mm_cmple_ps( _mm_loadu_ps( node->bounds[2] ), _mm_set1_ps( tw->bounds[1][2] ) ), _mm_cmpge_ps( _mm_loadu_ps( node->bounds[5] ), _mm_set1_ps( tw->bounds[0][2] ) ) ) );
+		mask = _mm_movemask_ps( overlap );
+#else
+		mask = 0;
+		for( i = 0; i < 4; i++ )
+		{
+			if( node->bounds[0][i] <= tw->bounds[1][0] && node->bounds[3][i] >= tw->bounds[0][0] &&
+					node->bounds[1][i] <= tw->bounds[1][1] && node->bounds[4][i] >= tw->bounds[0][1] &&
+					node->bounds[2][i] <= tw->bounds[1][2] && node->bounds[5][i] >= tw->bounds[0][2] )
+			{
+				mask |= 1 << i;
+			}
+		}
+#endif
+		
+		// push the children furthest along the trace direction first so the nearest ones are visited first
+		numChildren = 0;
+		for( i = 0; i < 4; i++ )
+		{
+			if( !( mask & ( 1 << i ) ) )
+			{
+				continue;
+			}
+			float d = ( node->bounds[0][i] + node->bounds[3][i] ) * tw->dir[0] +
+					  ( node->bounds[1][i] + node->bounds[4][i] ) * tw->dir[1] +
+					  ( node->bounds[2][i] + node->bounds[5][i] ) * tw->dir[2];
+			int j = numChildren++;
+			for( ; j > 0 && order[j - 1] < d; j-- )
+			{
+				order[j] = order[j - 1];
+				children[j] = children[j - 1];
+			}
+			order[j] = d;
+			children[j] = node->children[i];
+		}
+		for( i = 0; i < numChildren; i++ )
+		{
+			assert( stackDepth < ( int )( sizeof( stack ) / sizeof( stack[0] ) ) );
+			stack[stackDepth++] = children[i];
+		}
+	}
+}
@@ -61,11 +61,11 @@ bool idCollisionModelManagerLocal::TestTrmVertsInBrush( cm_traceWork_t* tw, cm_b
 	float d, bestd;
 	idVec3* p;
 	
-	if( b->checkcount == idCollisionModelManagerLocal::checkCount )
+	if( b->traceCheckcount[tw->slot] == tw->checkCount )
 	{
 		return false;
 	}
-	b->checkcount = idCollisionModelManagerLocal::checkCount;
+	b->traceCheckcount[tw->slot] = tw->checkCount;
 	
 	if( !( b->contents & tw->contents ) )
 	{
@@ -129,12 +129,13 @@ bool idCollisionModelManagerLocal::TestTrmVertsInBrush( cm_traceWork_t* tw, cm_b
 CM_SetTrmEdgeSidedness
 ================
 */
-#define CM_SetTrmEdgeSidedness( edge, bpl, epl, bitNum ) {						\
+#define CM_SetTrmEdgeSidedness( edge, bpl, epl, bitNum, slot ) {				\
 	const int mask = 1 << bitNum;												\
-	if ( ( edge->sideSet & mask ) == 0 ) {										\
+	cm_traceStamp_t* stamp = &(edge)->traceStamps[slot];						\
+	if ( ( stamp->sideSet & mask ) == 0 ) {										\
 		const float fl = (bpl).PermutedInnerProduct( epl );						\
-		edge->side = ( edge->side & ~mask ) | ( ( fl < 0.0f ) ? mask : 0 );		\
-		edge->sideSet |= mask;													\
+		stamp->side = ( stamp->side & ~mask ) | ( ( fl < 0.0f ) ? mask : 0 );	\
+		stamp->sideSet |= mask;													\
 	}																			\
 }
 
@@ -143,12 +144,13 @@ CM_SetTrmEdgeSidedness
 CM_SetTrmPolygonSidedness
 ================
 */
-#define CM_SetTrmPolygonSidedness( v, plane, bitNum ) {						\
+#define CM_SetTrmPolygonSidedness( v, plane, bitNum, slot ) {				\
 	const int mask = 1 << bitNum;											\
-	if ( ( (v)->sideSet & mask ) == 0 ) {									\
+	cm_traceStamp_t* stamp = &(v)->traceStamps[slot];						\
+	if ( ( stamp->sideSet & mask ) == 0 ) {									\
 		const float fl = plane.Distance( (v)->p );							\
-		(v)->side = ( (v)->side & ~mask ) | ( ( fl < 0.0f ) ? mask : 0 );		\
-		(v)->sideSet |= mask;												\
+		stamp->side = ( stamp->side & ~mask ) | ( ( fl < 0.0f ) ? mask : 0 );	\
+		stamp->sideSet |= mask;												\
 	}																		\
 }
 
@@ -169,11 +171,11 @@ bool idCollisionModelManagerLocal::TestTrmInPolygon( cm_traceWork_t* tw, cm_poly
 	cm_vertex_t* v, *v1, *v2;
 	
 	// if already checked this polygon
-	if( p->checkcount == idCollisionModelManagerLocal::checkCount )
+	if( p->traceCheckcount[tw->slot] == tw->checkCount )
 	{
 		return false;
 	}
-	p->checkcount = idCollisionModelManagerLocal::checkCount;
+	p->traceCheckcount[tw->slot] = tw->checkCount;
 	
 	// if this polygon does not have the right contents behind it
 	if( !( p->contents & tw->contents ) )
@@ -211,7 +213,7 @@ bool idCollisionModelManagerLocal::TestTrmInPolygon( cm_traceWork_t* tw, cm_poly
 			edgeNum = p->edges[i];
 			edge = tw->model->edges + abs( edgeNum );
 			// if this edge is already tested
-			if( edge->checkcount == idCollisionModelManagerLocal::checkCount )
+			if( edge->traceStamps[tw->slot].checkcount == tw->checkCount )
 			{
 				continue;
 			}
@@ -220,7 +222,7 @@ bool idCollisionModelManagerLocal::TestTrmInPolygon( cm_traceWork_t* tw, cm_poly
 			{
 				v = &tw->model->vertices[edge->vertexNum[j]];
 				// if this vertex is already tested
-				if( v->checkcount == idCollisionModelManagerLocal::checkCount )
+				if( v->traceStamps[tw->slot].checkcount == tw->checkCount )
 				{
 					continue;
 				}
@@ -262,20 +264,20 @@ bool idCollisionModelManagerLocal::TestTrmInPolygon( cm_traceWork_t* tw, cm_poly
 		edgeNum = p->edges[i];
 		edge = tw->model->edges + abs( edgeNum );
 		// reset sidedness cache if this is the first time we encounter this edge
-		if( edge->checkcount != idCollisionModelManagerLocal::checkCount )
+		if( edge->traceStamps[tw->slot].checkcount != tw->checkCount )
 		{
-			edge->sideSet = 0;
+			edge->traceStamps[tw->slot].sideSet = 0;
 		}
 		// pluecker coordinate for edge
 		tw->polygonEdgePlueckerCache[i].FromLine( tw->model->vertices[edge->vertexNum[0]].p,
 				tw->model->vertices[edge->vertexNum[1]].p );
 		v = &tw->model->vertices[edge->vertexNum[INT32_SIGNBITSET( edgeNum )]];
 		// reset sidedness cache if this is the first time we encounter this vertex
-		if( v->checkcount != idCollisionModelManagerLocal::checkCount )
+		if( v->traceStamps[tw->slot].checkcount != tw->checkCount )
 		{
-			v->sideSet = 0;
+			v->traceStamps[tw->slot].sideSet = 0;
 		}
-		v->checkcount = idCollisionModelManagerLocal::checkCount;
+		v->traceStamps[tw->slot].checkcount = tw->checkCount;
 	}
 	
 	// get side of polygon for each trm vertex
@@ -301,8 +303,8 @@ bool idCollisionModelManagerLocal::TestTrmInPolygon( cm_traceWork_t* tw, cm_poly
 			edgeNum = p->edges[j];
 			edge = tw->model->edges + abs( edgeNum );
 #if 1
-			CM_SetTrmEdgeSidedness( edge, tw->edges[i].pl, tw->polygonEdgePlueckerCache[j], i );
-			if( INT32_SIGNBITSET( edgeNum ) ^ ( ( edge->side >> i ) & 1 ) ^ flip )
+			CM_SetTrmEdgeSidedness( edge, tw->edges[i].pl, tw->polygonEdgePlueckerCache[j], i, tw->slot );
+			if( INT32_SIGNBITSET( edgeNum ) ^ ( ( edge->traceStamps[tw->slot].side >> i ) & 1 ) ^ flip )
 			{
 				break;
 			}
@@ -348,25 +350,25 @@ bool idCollisionModelManagerLocal::TestTrmInPolygon( cm_traceWork_t* tw, cm_poly
 	{
 		edgeNum = p->edges[i];
 		edge = tw->model->edges + abs( edgeNum );
-		if( edge->checkcount == idCollisionModelManagerLocal::checkCount )
+		if( edge->traceStamps[tw->slot].checkcount == tw->checkCount )
 		{
 			continue;
 		}
-		edge->checkcount = idCollisionModelManagerLocal::checkCount;
+		edge->traceStamps[tw->slot].checkcount = tw->checkCount;
 		
 		for( j = 0; j < tw->numPolys; j++ )
 		{
 #if 1
 			v1 = tw->model->vertices + edge->vertexNum[0];
-			CM_SetTrmPolygonSidedness( v1, tw->polys[j].plane, j );
+			CM_SetTrmPolygonSidedness( v1, tw->polys[j].plane, j, tw->slot );
 			v2 = tw->model->vertices + edge->vertexNum[1];
-			CM_SetTrmPolygonSidedness( v2, tw->polys[j].plane, j );
+			CM_SetTrmPolygonSidedness( v2, tw->polys[j].plane, j, tw->slot );
 			// if the polygon edge does not cross the trm polygon plane
-			if( !( ( ( v1->side ^ v2->side ) >> j ) & 1 ) )
+			if( !( ( ( v1->traceStamps[tw->slot].side ^ v2->traceStamps[tw->slot].side ) >> j ) & 1 ) )
 			{
 				continue;
 			}
-			flip = ( v1->side >> j ) & 1;
+			flip = ( v1->traceStamps[tw->slot].side >> j ) & 1;
 #else
 			float d1, d2;
 			
@@ -392,8 +394,8 @@ bool idCollisionModelManagerLocal::TestTrmInPolygon( cm_traceWork_t* tw, cm_poly
 				trmEdge = tw->edges + abs( trmEdgeNum );
 #if 1
 				bitNum = abs( trmEdgeNum );
-				CM_SetTrmEdgeSidedness( edge, trmEdge->pl, tw->polygonEdgePlueckerCache[i], bitNum );
-				if( INT32_SIGNBITSET( trmEdgeNum ) ^ ( ( edge->side >> bitNum ) & 1 ) ^ flip )
+				CM_SetTrmEdgeSidedness( edge, trmEdge->pl, tw->polygonEdgePlueckerCache[i], bitNum, tw->slot );
+				if( INT32_SIGNBITSET( trmEdgeNum ) ^ ( ( edge->traceStamps[tw->slot].side >> bitNum ) & 1 ) ^ flip )
 				{
 					break;
 				}
@@ -477,7 +479,7 @@ int idCollisionModelManagerLocal::PointContents( const idVec3 p, cmHandle_t mode
 	cm_brush_t* b;
 	idPlane* plane;
 	
-	node = idCollisionModelManagerLocal::PointNode( p, idCollisionModelManagerLocal::models[model] );
+	node = idCollisionModelManagerLocal::PointNode( p, idCollisionModelManagerLocal::GetModel( model ) );
 	for( bref = node->brushes; bref; bref = bref->next )
 	{
 		b = bref->b;
@@ -549,6 +551,8 @@ int idCollisionModelManagerLocal::ContentsTrm( trace_t* results, const idVec3& s
 	idVec3 dir;
 	ALIGN16( cm_traceWork_t tw );
 	
+	tw.getContacts = false;
+	
 	// fast point case
 	if( !trm || ( trm->bounds[1][0] - trm->bounds[0][0] <= 0.0f &&
 				  trm->bounds[1][1] - trm->bounds[0][1] <= 0.0f &&
@@ -563,8 +567,6 @@ int idCollisionModelManagerLocal::ContentsTrm( trace_t* results, const idVec3& s
 		return results->c.contents;
 	}
 	
-	idCollisionModelManagerLocal::checkCount++;
-	
 	tw.trace.fraction = 1.0f;
 	tw.trace.c.contents = 0;
 	tw.trace.c.type = CONTACT_NONE;
@@ -575,7 +577,7 @@ int idCollisionModelManagerLocal::ContentsTrm( trace_t* results, const idVec3& s
 	tw.pointTrace = false;
 	tw.quickExit = false;
 	tw.numContacts = 0;
-	tw.model = idCollisionModelManagerLocal::models[model];
+	tw.model = idCollisionModelManagerLocal::GetModel( model );
 	tw.start = start - modelOrigin;
 	tw.end = tw.start;
 	
@@ -728,7 +730,7 @@ int idCollisionModelManagerLocal::Contents( const idVec3& start,
 		common->Printf( "idCollisionModelManagerLocal::Contents: invalid model handle\n" );
 		return 0;
 	}
-	if( !idCollisionModelManagerLocal::models || !idCollisionModelManagerLocal::models[model] )
+	if( !idCollisionModelManagerLocal::models || !idCollisionModelManagerLocal::GetModel( model ) )
 	{
 		common->Printf( "idCollisionModelManagerLocal::Contents: invalid model\n" );
 		return 0;
@@ -381,7 +381,7 @@ void idCollisionModelManagerLocal::DrawModel( cmHandle_t handle, const idVec3& m
 		cm_drawColor.ClearModified();
 	}
 	
-	model = models[ handle ];
+	model = GetModel( handle );
 	viewPos = ( viewOrigin - modelOrigin ) * modelAxis.Transpose();
 	checkCount++;
 	DrawNodePolygons( model, model->node, modelOrigin, modelAxis, viewPos, radius );
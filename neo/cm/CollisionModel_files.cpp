@@ -45,6 +45,9 @@ If you have questions concerning this license or the applicable additional terms
 #define CM_FILEID			"CM"
 #define CM_FILEVERSION		"1.00"
 
+idCVar cm_skipBinaryCache(	"cm_skipBinaryCache",	"0",	CVAR_GAME | CVAR_BOOL,	"parse the text collision model files even when an up to date binary version exists" );
+idCVar cm_showLoadTime(		"cm_showLoadTime",		"0",	CVAR_GAME | CVAR_BOOL,	"print the time spent loading collision model files" );
+
 
 /*
 ===============================================================================
@@ -360,8 +363,7 @@ void idCollisionModelManagerLocal::ParseVertices( idLexer* src, cm_model_t* mode
 	for( i = 0; i < model->numVertices; i++ )
 	{
 		src->Parse1DMatrix( 3, model->vertices[i].p.ToFloatPtr() );
-		model->vertices[i].side = 0;
-		model->vertices[i].sideSet = 0;
+		memset( model->vertices[i].traceStamps, 0, sizeof( model->vertices[i].traceStamps ) );
 		model->vertices[i].checkcount = 0;
 	}
 	src->ExpectTokenString( "}" );
@@ -386,8 +388,7 @@ void idCollisionModelManagerLocal::ParseEdges( idLexer* src, cm_model_t* model )
 		model->edges[i].vertexNum[0] = src->ParseInt();
 		model->edges[i].vertexNum[1] = src->ParseInt();
 		src->ExpectTokenString( ")" );
-		model->edges[i].side = 0;
-		model->edges[i].sideSet = 0;
+		memset( model->edges[i].traceStamps, 0, sizeof( model->edges[i].traceStamps ) );
 		model->edges[i].internal = src->ParseInt();
 		model->edges[i].numUsers = src->ParseInt();
 		model->edges[i].normal = vec3_origin;
@@ -627,9 +628,12 @@ bool idCollisionModelManagerLocal::LoadCollisionModelFile( const char* name, uns
 	// and try to skip all the work
 	ID_TIME_T currentTimeStamp = fileSystem->GetTimestamp( fileName );
 	
+	const int startTime = Sys_Milliseconds();
+	const int firstModel = numModels;
+	
 	// see if we have a generated version of this
 	bool loaded = false;
-	idFileLocal file( fileSystem->OpenFileReadMemory( generatedFileName ) );
+	idFileLocal file( cm_skipBinaryCache.GetBool() ? NULL : fileSystem->OpenFileReadMemory( generatedFileName ) );
 	if( file != NULL )
 	{
 		int numEntries = 0;
@@ -657,6 +661,17 @@ bool idCollisionModelManagerLocal::LoadCollisionModelFile( const char* name, uns
 				models[ numModels ] = model;
 				numModels++;
 			}
+			
+			if( !loaded )
+			{
+				// drop the models loaded before the failure, they are parsed again from the source
+				for( int i = firstModel; i < numModels; i++ )
+				{
+					FreeModel( models[i] );
+					models[i] = NULL;
+				}
+				numModels = firstModel;
+			}
 		}
 	}
 	
@@ -746,5 +761,11 @@ bool idCollisionModelManagerLocal::LoadCollisionModelFile( const char* name, uns
 		}
 	}
 	
+	if( cm_showLoadTime.GetBool() )
+	{
+		common->Printf( "%s: %d collision models from the %s file in %d msec\n", fileName.c_str(), numModels - firstModel,
+						loaded ? "binary" : "text", Sys_Milliseconds() - startTime );
+	}
+	
 	return true;
 }
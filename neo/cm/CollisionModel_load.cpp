@@ -201,15 +201,11 @@ void idCollisionModelManagerLocal::Clear()
 	maxModels = 0;
 	numModels = 0;
 	models = NULL;
-	memset( trmPolygons, 0, sizeof( trmPolygons ) );
-	trmBrushes[0] = NULL;
+	memset( trmModels, 0, sizeof( trmModels ) );
 	trmMaterial = NULL;
 	numProcNodes = 0;
 	procNodes = NULL;
-	getContacts = false;
-	contacts = NULL;
-	maxContacts = 0;
-	numContacts = 0;
+	memset( traceSlotInUse, 0, sizeof( traceSlotInUse ) );
 }
 
 /*
@@ -416,6 +412,8 @@ void idCollisionModelManagerLocal::FreeModel( cm_model_t* model )
 	cm_brushRefBlock_t* brushRefBlock, *nextBrushRefBlock;
 	cm_nodeBlock_t* nodeBlock, *nextNodeBlock;
 	
+	// free the bounding volume hierarchy
+	FreeBVH( model );
 	// free the tree structure
 	if( model->node )
 	{
@@ -491,7 +489,8 @@ idCollisionModelManagerLocal::FreeTrmModelStructure
 */
 void idCollisionModelManagerLocal::FreeTrmModelStructure()
 {
-	int i;
+	int i, j;
+	cm_trmModel_t* trmModel;
 	
 	assert( models );
 	if( !models[MAX_SUBMODELS] )
@@ -499,15 +498,65 @@ void idCollisionModelManagerLocal::FreeTrmModelStructure()
 		return;
 	}
 	
-	for( i = 0; i < MAX_TRACEMODEL_POLYS; i++ )
+	for( i = 0; i < CM_MAX_TRM_MODELS; i++ )
 	{
-		FreePolygon( models[MAX_SUBMODELS], trmPolygons[i]->p );
+		trmModel = &trmModels[i];
+		if( !trmModel->model )
+		{
+			continue;
+		}
+		for( j = 0; j < MAX_TRACEMODEL_POLYS; j++ )
+		{
+			FreePolygon( trmModel->model, trmModel->polygons[j]->p );
+		}
+		FreeBrush( trmModel->model, trmModel->brush->b );
+		
+		trmModel->model->node->polygons = NULL;
+		trmModel->model->node->brushes = NULL;
+		FreeModel( trmModel->model );
+		trmModel->model = NULL;
 	}
-	FreeBrush( models[MAX_SUBMODELS], trmBrushes[0]->b );
-	
-	models[MAX_SUBMODELS]->node->polygons = NULL;
-	models[MAX_SUBMODELS]->node->brushes = NULL;
-	FreeModel( models[MAX_SUBMODELS] );
+	models[MAX_SUBMODELS] = NULL;
+}
+
+static ID_TLS				trmModelThread;				// index + 1 of the trace model owned by the calling thread
+static idSysInterlockedInteger numTrmModelThreads;
+
+/*
+================
+idCollisionModelManagerLocal::GetThreadTrmModel
+
+Each thread that sets up a trace model gets its own collision model to convert it into,
+threads are assigned a model the first time they set up a trace model
+================
+*/
+cm_trmModel_t* idCollisionModelManagerLocal::GetThreadTrmModel()
+{
+	int index = ( int )trmModelThread;
+	if( index == 0 )
+	{
+		index = numTrmModelThreads.Increment();
+		if( index > CM_MAX_TRM_MODELS )
+		{
+			common->FatalError( "idCollisionModelManagerLocal::GetThreadTrmModel: more than %d threads use trace models", CM_MAX_TRM_MODELS );
+		}
+		trmModelThread = ( ptrdiff_t )index;
+	}
+	return &trmModels[index - 1];
+}
+
+/*
+================
+idCollisionModelManagerLocal::GetModel
+================
+*/
+cm_model_t* idCollisionModelManagerLocal::GetModel( cmHandle_t model )
+{
+	if( model == TRACE_MODEL_HANDLE )
+	{
+		return GetThreadTrmModel()->model;
+	}
+	return models[model];
 }
 
 
@@ -628,6 +677,11 @@ cm_model_t* idCollisionModelManagerLocal::AllocModel()
 	model->brushRefBlocks = NULL;
 	model->polygonBlock = NULL;
 	model->brushBlock = NULL;
+	model->bvhNodes = NULL;
+	model->bvhLeafs = NULL;
+	model->bvhPolygonGroups = NULL;
+	model->bvhBrushes = NULL;
+	model->numBvhNodes = model->numBvhLeafs = model->numBvhPolygonGroups = model->numBvhBrushes = 0;
 	model->numPolygons = model->polygonMemory =
 							 model->numBrushes = model->brushMemory =
 										 model->numNodes = model->numBrushRefs =
@@ -826,26 +880,11 @@ idCollisionModelManagerLocal::SetupTrmModelStructure
 */
 void idCollisionModelManagerLocal::SetupTrmModelStructure()
 {
-	int i;
+	int i, j;
 	cm_node_t* node;
 	cm_model_t* model;
+	cm_trmModel_t* trmModel;
 	
-	// setup model
-	model = AllocModel();
-	
-	assert( models );
-	models[MAX_SUBMODELS] = model;
-	// create node to hold the collision data
-	node = ( cm_node_t* ) AllocNode( model, 1 );
-	node->planeType = -1;
-	model->node = node;
-	// allocate vertex and edge arrays
-	model->numVertices = 0;
-	model->maxVertices = MAX_TRACEMODEL_VERTS;
-	model->vertices = ( cm_vertex_t* ) Mem_ClearedAlloc( model->maxVertices * sizeof( cm_vertex_t ), TAG_COLLISION );
-	model->numEdges = 0;
-	model->maxEdges = MAX_TRACEMODEL_EDGES + 1;
-	model->edges = ( cm_edge_t* ) Mem_ClearedAlloc( model->maxEdges * sizeof( cm_edge_t ), TAG_COLLISION );
 	// create a material for the trace model polygons
 	trmMaterial = declManager->FindMaterial( "_tracemodel", false );
 	if( !trmMaterial )
@@ -853,35 +892,59 @@ void idCollisionModelManagerLocal::SetupTrmModelStructure()
 		common->FatalError( "_tracemodel material not found" );
 	}
 	
-	// allocate polygons
-	for( i = 0; i < MAX_TRACEMODEL_POLYS; i++ )
-	{
-		trmPolygons[i] = AllocPolygonReference( model, MAX_TRACEMODEL_POLYS );
-		trmPolygons[i]->p = AllocPolygon( model, MAX_TRACEMODEL_POLYEDGES );
-		trmPolygons[i]->p->bounds.Clear();
-		trmPolygons[i]->p->plane.Zero();
-		trmPolygons[i]->p->checkcount = 0;
-		trmPolygons[i]->p->contents = -1;		// all contents
-		trmPolygons[i]->p->material = trmMaterial;
-		trmPolygons[i]->p->numEdges = 0;
-	}
-	// allocate brush for position test
-	trmBrushes[0] = AllocBrushReference( model, 1 );
-	trmBrushes[0]->b = AllocBrush( model, MAX_TRACEMODEL_POLYS );
-	trmBrushes[0]->b->primitiveNum = 0;
-	trmBrushes[0]->b->bounds.Clear();
-	trmBrushes[0]->b->checkcount = 0;
-	trmBrushes[0]->b->contents = -1;		// all contents
-	trmBrushes[ 0 ]->b->material = trmMaterial;
-	trmBrushes[0]->b->numPlanes = 0;
+	for( i = 0; i < CM_MAX_TRM_MODELS; i++ )
+	{
+		trmModel = &trmModels[i];
+		
+		// setup model
+		model = AllocModel();
+		trmModel->model = model;
+		// create node to hold the collision data
+		node = ( cm_node_t* ) AllocNode( model, 1 );
+		node->planeType = -1;
+		model->node = node;
+		// allocate vertex and edge arrays
+		model->numVertices = 0;
+		model->maxVertices = MAX_TRACEMODEL_VERTS;
+		model->vertices = ( cm_vertex_t* ) Mem_ClearedAlloc( model->maxVertices * sizeof( cm_vertex_t ), TAG_COLLISION );
+		model->numEdges = 0;
+		model->maxEdges = MAX_TRACEMODEL_EDGES + 1;
+		model->edges = ( cm_edge_t* ) Mem_ClearedAlloc( model->maxEdges * sizeof( cm_edge_t ), TAG_COLLISION );
+		
+		// allocate polygons
+		for( j = 0; j < MAX_TRACEMODEL_POLYS; j++ )
+		{
+			trmModel->polygons[j] = AllocPolygonReference( model, MAX_TRACEMODEL_POLYS );
+			trmModel->polygons[j]->p = AllocPolygon( model, MAX_TRACEMODEL_POLYEDGES );
+			trmModel->polygons[j]->p->bounds.Clear();
+			trmModel->polygons[j]->p->plane.Zero();
+			trmModel->polygons[j]->p->checkcount = 0;
+			trmModel->polygons[j]->p->contents = -1;		// all contents
+			trmModel->polygons[j]->p->material = trmMaterial;
+			trmModel->polygons[j]->p->numEdges = 0;
+		}
+		// allocate brush for position test
+		trmModel->brush = AllocBrushReference( model, 1 );
+		trmModel->brush->b = AllocBrush( model, MAX_TRACEMODEL_POLYS );
+		trmModel->brush->b->primitiveNum = 0;
+		trmModel->brush->b->bounds.Clear();
+		trmModel->brush->b->checkcount = 0;
+		trmModel->brush->b->contents = -1;		// all contents
+		trmModel->brush->b->material = trmMaterial;
+		trmModel->brush->b->numPlanes = 0;
+	}
+	
+	// the last model slot keeps pointing at the first trace model so the handle stays valid
+	assert( models );
+	models[MAX_SUBMODELS] = trmModels[0].model;
 }
 
 /*
 ================
 idCollisionModelManagerLocal::SetupTrmModel
 
-Trace models (item boxes, etc) are converted to collision models on the fly, using the last model slot
-as a reusable temporary buffer
+Trace models (item boxes, etc) are converted to collision models on the fly, using a reusable temporary
+model owned by the calling thread, so each thread can set up and trace against its own trace model
 ================
 */
 cmHandle_t idCollisionModelManagerLocal::SetupTrmModel( const idTraceModel& trm, const idMaterial* material )
@@ -891,6 +954,7 @@ cmHandle_t idCollisionModelManagerLocal::SetupTrmModel( const idTraceModel& trm,
 	cm_edge_t* edge;
 	cm_polygon_t* poly;
 	cm_model_t* model;
+	cm_trmModel_t* trmModel;
 	const traceModelVert_t* trmVert;
 	const traceModelEdge_t* trmEdge;
 	const traceModelPoly_t* trmPoly;
@@ -902,7 +966,8 @@ cmHandle_t idCollisionModelManagerLocal::SetupTrmModel( const idTraceModel& trm,
 		material = trmMaterial;
 	}
 	
-	model = models[MAX_SUBMODELS];
+	trmModel = GetThreadTrmModel();
+	model = trmModel->model;
 	model->node->brushes = NULL;
 	model->node->polygons = NULL;
 	// if not a valid trace model
@@ -917,7 +982,6 @@ cmHandle_t idCollisionModelManagerLocal::SetupTrmModel( const idTraceModel& trm,
 	for( i = 0; i < trm.numVerts; i++, vertex++, trmVert++ )
 	{
 		vertex->p = *trmVert;
-		vertex->sideSet = 0;
 	}
 	// edges
 	model->numEdges = trm.numEdges;
@@ -929,14 +993,13 @@ cmHandle_t idCollisionModelManagerLocal::SetupTrmModel( const idTraceModel& trm,
 		edge->vertexNum[1] = trmEdge->v[1];
 		edge->normal = trmEdge->normal;
 		edge->internal = false;
-		edge->sideSet = 0;
 	}
 	// polygons
 	model->numPolygons = trm.numPolys;
 	trmPoly = trm.polys;
 	for( i = 0; i < trm.numPolys; i++, trmPoly++ )
 	{
-		poly = trmPolygons[i]->p;
+		poly = trmModel->polygons[i]->p;
 		poly->numEdges = trmPoly->numEdges;
 		for( j = 0; j < trmPoly->numEdges; j++ )
 		{
@@ -947,23 +1010,23 @@ cmHandle_t idCollisionModelManagerLocal::SetupTrmModel( const idTraceModel& trm,
 		poly->bounds = trmPoly->bounds;
 		poly->material = material;
 		// link polygon at node
-		trmPolygons[i]->next = model->node->polygons;
-		model->node->polygons = trmPolygons[i];
+		trmModel->polygons[i]->next = model->node->polygons;
+		model->node->polygons = trmModel->polygons[i];
 	}
 	// if the trace model is convex
 	if( trm.isConvex )
 	{
 		// setup brush for position test
-		trmBrushes[0]->b->numPlanes = trm.numPolys;
+		trmModel->brush->b->numPlanes = trm.numPolys;
 		for( i = 0; i < trm.numPolys; i++ )
 		{
-			trmBrushes[0]->b->planes[i] = trmPolygons[i]->p->plane;
+			trmModel->brush->b->planes[i] = trmModel->polygons[i]->p->plane;
 		}
-		trmBrushes[0]->b->bounds = trm.bounds;
+		trmModel->brush->b->bounds = trm.bounds;
 		// link brush at node
-		trmBrushes[0]->next = model->node->brushes;
-		trmBrushes[ 0 ]->b->material = material;
-		model->node->brushes = trmBrushes[0];
+		trmModel->brush->next = model->node->brushes;
+		trmModel->brush->b->material = material;
+		model->node->brushes = trmModel->brush;
 	}
 	// model bounds
 	model->bounds = trm.bounds;
@@ -3474,8 +3537,100 @@ void idCollisionModelManagerLocal::FinishModel( cm_model_t* model )
 						model->numBrushRefs * sizeof( cm_brushRef_t );
 }
 
-static const byte BCM_VERSION = 100;
+static const byte BCM_VERSION = 102;
 static const unsigned int BCM_MAGIC = ( 'B' << 24 ) | ( 'C' << 16 ) | ( 'M' << 16 ) | BCM_VERSION;
+static const unsigned int BCM_BYTE_ORDER = 0x01020304;
+
+/*
+The geometry of a binary model is stored as a single block with the header first and all sections at
+16 byte aligned offsets relative to the start of the block. The block is written in the byte order and
+float format of the machine that generated it, a block written on another platform is rejected through
+the byteOrder field and the model is regenerated from the source.
+*/
+typedef struct cm_binaryHeader_s
+{
+	unsigned int			byteOrder;			// BCM_BYTE_ORDER as written by the generating machine
+	int						size;				// size of the whole block including this header
+	idBounds				bounds;
+	int						contents;
+	int						isConvex;
+	int						numVertices;
+	int						numEdges;
+	int						numPolygons;
+	int						numPolygonEdges;
+	int						numBrushes;
+	int						numBrushPlanes;
+	int						numNodes;
+	int						numPolygonRefs;
+	int						numBrushRefs;
+	int						numMaterials;
+	int						numInternalEdges;
+	int						numSharpEdges;
+	int						numRemovedPolys;
+	int						numMergedPolys;
+	int						polygonMemory;		// size of the polygon block in memory
+	int						brushMemory;		// size of the brush block in memory
+	int						nameOffset;			// model name
+	int						vertexOffset;		// idVec3[numVertices]
+	int						edgeOffset;			// cm_binaryEdge_t[numEdges]
+	int						polygonOffset;		// cm_binaryPolygon_t[numPolygons]
+	int						polygonEdgeOffset;	// int[numPolygonEdges]
+	int						brushOffset;		// cm_binaryBrush_t[numBrushes]
+	int						brushPlaneOffset;	// idPlane[numBrushPlanes]
+	int						nodeOffset;			// cm_binaryNode_t[numNodes], depth first with the root first
+	int						polygonRefOffset;	// int[numPolygonRefs], polygon indexes
+	int						brushRefOffset;		// int[numBrushRefs], brush indexes
+	int						materialOffset;		// int[numMaterials] name offsets followed by the names
+} cm_binaryHeader_t;
+
+typedef struct cm_binaryEdge_s
+{
+	int						vertexNum[2];
+	idVec3					normal;
+	unsigned short			internal;
+	unsigned short			numUsers;
+} cm_binaryEdge_t;
+
+typedef struct cm_binaryPolygon_s
+{
+	idBounds				bounds;
+	idPlane					plane;
+	int						contents;
+	int						material;			// -1 for no material
+	int						firstEdge;
+	int						numEdges;
+} cm_binaryPolygon_t;
+
+typedef struct cm_binaryBrush_s
+{
+	idBounds				bounds;
+	int						contents;
+	int						material;			// -1 for no material
+	int						primitiveNum;
+	int						firstPlane;
+	int						numPlanes;
+} cm_binaryBrush_t;
+
+typedef struct cm_binaryNode_s
+{
+	int						planeType;
+	float					planeDist;
+	int						children[2];		// -1 for leaf nodes
+	int						firstPolygonRef;
+	int						numPolygonRefs;
+	int						firstBrushRef;
+	int						numBrushRefs;
+} cm_binaryNode_t;
+
+/*
+================
+CM_BinarySectionValid
+================
+*/
+static bool CM_BinarySectionValid( const cm_binaryHeader_t& header, int offset, int count, int elementSize )
+{
+	return ( offset >= ( int )sizeof( cm_binaryHeader_t ) && count >= 0 && offset <= header.size && count <= ( header.size - offset ) / elementSize );
+}
 
 /*
 ================
@@ -3484,7 +3639,8 @@ idCollisionModelManagerLocal::LoadBinaryModel
 */
 cm_model_t* idCollisionModelManagerLocal::LoadBinaryModelFromFile( idFile* file, ID_TIME_T sourceTimeStamp )
 {
-
+	int i, j;
+	
 	unsigned int magic = 0;
 	file->ReadBig( magic );
 	if( magic != BCM_MAGIC )
@@ -3501,155 +3657,238 @@ cm_model_t* idCollisionModelManagerLocal::LoadBinaryModelFromFile( idFile* file,
 	}
 	// RB end
 	
-	cm_model_t* model = AllocModel();
-	file->ReadString( model->name );
-	file->ReadBig( model->bounds );
-	file->ReadBig( model->contents );
-	file->ReadBig( model->isConvex );
-	file->ReadBig( model->numVertices );
-	file->ReadBig( model->numEdges );
-	file->ReadBig( model->numPolygons );
-	file->ReadBig( model->numBrushes );
-	file->ReadBig( model->numNodes );
-	file->ReadBig( model->numBrushRefs );
-	file->ReadBig( model->numPolygonRefs );
-	file->ReadBig( model->numInternalEdges );
-	file->ReadBig( model->numSharpEdges );
-	file->ReadBig( model->numRemovedPolys );
-	file->ReadBig( model->numMergedPolys );
+	cm_binaryHeader_t header;
+	if( file->Read( &header, sizeof( header ) ) != sizeof( header ) || header.byteOrder != BCM_BYTE_ORDER || header.size < ( int )sizeof( header ) )
+	{
+		return NULL;
+	}
 	
-	model->maxVertices = model->numVertices;
+	// read the whole block at once, from here on everything is resolved in memory
+	byte* data = ( byte* ) Mem_Alloc( header.size, TAG_COLLISION );
+	memcpy( data, &header, sizeof( header ) );
+	if( file->Read( data + sizeof( header ), header.size - sizeof( header ) ) != header.size - ( int )sizeof( header ) ||
+			!CM_BinarySectionValid( header, header.nameOffset, 1, 1 ) ||
+			!CM_BinarySectionValid( header, header.vertexOffset, header.numVertices, sizeof( idVec3 ) ) ||
+			!CM_BinarySectionValid( header, header.edgeOffset, header.numEdges, sizeof( cm_binaryEdge_t ) ) ||
+			!CM_BinarySectionValid( header, header.polygonOffset, header.numPolygons, sizeof( cm_binaryPolygon_t ) ) ||
+			!CM_BinarySectionValid( header, header.polygonEdgeOffset, header.numPolygonEdges, sizeof( int ) ) ||
+			!CM_BinarySectionValid( header, header.brushOffset, header.numBrushes, sizeof( cm_binaryBrush_t ) ) ||
+			!CM_BinarySectionValid( header, header.brushPlaneOffset, header.numBrushPlanes, sizeof( idPlane ) ) ||
+			!CM_BinarySectionValid( header, header.nodeOffset, header.numNodes, sizeof( cm_binaryNode_t ) ) ||
+			!CM_BinarySectionValid( header, header.polygonRefOffset, header.numPolygonRefs, sizeof( int ) ) ||
+			!CM_BinarySectionValid( header, header.brushRefOffset, header.numBrushRefs, sizeof( int ) ) ||
+			!CM_BinarySectionValid( header, header.materialOffset, header.numMaterials, sizeof( int ) ) ||
+			header.numNodes < 1 || data[header.size - 1] != '\0' )
+	{
+		Mem_Free( data );
+		return NULL;
+	}
+	
+	const idVec3* vertexPoints = ( const idVec3* )( data + header.vertexOffset );
+	const cm_binaryEdge_t* binaryEdges = ( const cm_binaryEdge_t* )( data + header.edgeOffset );
+	const cm_binaryPolygon_t* binaryPolygons = ( const cm_binaryPolygon_t* )( data + header.polygonOffset );
+	const int* polygonEdges = ( const int* )( data + header.polygonEdgeOffset );
+	const cm_binaryBrush_t* binaryBrushes = ( const cm_binaryBrush_t* )( data + header.brushOffset );
+	const idPlane* brushPlanes = ( const idPlane* )( data + header.brushPlaneOffset );
+	const cm_binaryNode_t* binaryNodes = ( const cm_binaryNode_t* )( data + header.nodeOffset );
+	const int* polygonRefs = ( const int* )( data + header.polygonRefOffset );
+	const int* brushRefs = ( const int* )( data + header.brushRefOffset );
+	const int* materialNames = ( const int* )( data + header.materialOffset );
+	
+	cm_model_t* model = AllocModel();
+	model->name = ( const char* )( data + header.nameOffset );
+	model->bounds = header.bounds;
+	model->contents = header.contents;
+	model->isConvex = ( header.isConvex != 0 );
+	model->numInternalEdges = header.numInternalEdges;
+	model->numSharpEdges = header.numSharpEdges;
+	model->numRemovedPolys = header.numRemovedPolys;
+	model->numMergedPolys = header.numMergedPolys;
+	
+	model->maxVertices = model->numVertices = header.numVertices;
 	model->vertices = ( cm_vertex_t* ) Mem_ClearedAlloc( model->maxVertices * sizeof( cm_vertex_t ), TAG_COLLISION );
-	for( int i = 0; i < model->numVertices; i++ )
+	for( i = 0; i < model->numVertices; i++ )
 	{
-		file->ReadBig( model->vertices[i].p );
-		file->ReadBig( model->vertices[i].checkcount );
-		file->ReadBig( model->vertices[i].side );
-		file->ReadBig( model->vertices[i].sideSet );
+		model->vertices[i].p = vertexPoints[i];
 	}
 	
-	model->maxEdges = model->numEdges;
+	bool valid = true;
+	
+	model->maxEdges = model->numEdges = header.numEdges;
 	model->edges = ( cm_edge_t* ) Mem_ClearedAlloc( model->maxEdges * sizeof( cm_edge_t ), TAG_COLLISION );
-	for( int i = 0; i < model->numEdges; i++ )
+	for( i = 0; i < model->numEdges; i++ )
+	{
+		if( ( unsigned int )binaryEdges[i].vertexNum[0] >= ( unsigned int )header.numVertices || ( unsigned int )binaryEdges[i].vertexNum[1] >= ( unsigned int )header.numVertices )
+		{
+			valid = false;
+			break;
+		}
+		model->edges[i].vertexNum[0] = binaryEdges[i].vertexNum[0];
+		model->edges[i].vertexNum[1] = binaryEdges[i].vertexNum[1];
+		model->edges[i].normal = binaryEdges[i].normal;
+		model->edges[i].internal = binaryEdges[i].internal;
+		model->edges[i].numUsers = binaryEdges[i].numUsers;
+	}
+	
+	idList< const idMaterial* > materials;
+	materials.SetNum( header.numMaterials );
+	for( i = 0; i < materials.Num() && valid; i++ )
 	{
-		file->ReadBig( model->edges[i].checkcount );
-		file->ReadBig( model->edges[i].internal );
-		file->ReadBig( model->edges[i].numUsers );
-		file->ReadBig( model->edges[i].side );
-		file->ReadBig( model->edges[i].sideSet );
-		file->ReadBig( model->edges[i].vertexNum[0] );
-		file->ReadBig( model->edges[i].vertexNum[1] );
-		file->ReadBig( model->edges[i].normal );
+		if( materialNames[i] < header.materialOffset || materialNames[i] >= header.size )
+		{
+			valid = false;
+			break;
+		}
+		const char* materialName = ( const char* )( data + materialNames[i] );
+		materials[i] = ( materialName[0] != '\0' ) ? declManager->FindMaterial( materialName ) : NULL;
 	}
 	
-	file->ReadBig( model->polygonMemory );
-	model->polygonBlock = ( cm_polygonBlock_t* ) Mem_ClearedAlloc( sizeof( cm_polygonBlock_t ) + model->polygonMemory, TAG_COLLISION );
-	model->polygonBlock->bytesRemaining = model->polygonMemory;
+	// all polygons and brushes go into a single block each, AllocPolygon and AllocBrush count them again
+	model->polygonBlock = ( cm_polygonBlock_t* ) Mem_ClearedAlloc( sizeof( cm_polygonBlock_t ) + header.polygonMemory, TAG_COLLISION );
+	model->polygonBlock->bytesRemaining = header.polygonMemory;
 	model->polygonBlock->next = ( ( byte* ) model->polygonBlock ) + sizeof( cm_polygonBlock_t );
+	model->numPolygons = model->polygonMemory = 0;
 	
-	file->ReadBig( model->brushMemory );
-	model->brushBlock = ( cm_brushBlock_t* ) Mem_ClearedAlloc( sizeof( cm_brushBlock_t ) + model->brushMemory, TAG_COLLISION );
-	model->brushBlock->bytesRemaining = model->brushMemory;
+	model->brushBlock = ( cm_brushBlock_t* ) Mem_ClearedAlloc( sizeof( cm_brushBlock_t ) + header.brushMemory, TAG_COLLISION );
+	model->brushBlock->bytesRemaining = header.brushMemory;
 	model->brushBlock->next = ( ( byte* ) model->brushBlock ) + sizeof( cm_brushBlock_t );
+	model->numBrushes = model->brushMemory = 0;
 	
-	int numMaterials = 0;
-	file->ReadBig( numMaterials );
-	
-	idList< const idMaterial* > materials;
-	materials.SetNum( numMaterials );
-	idStr materialName;
-	for( int i = 0; i < materials.Num(); i++ )
+	idList< cm_polygon_t* > polys;
+	polys.SetNum( header.numPolygons );
+	for( i = 0; i < polys.Num() && valid; i++ )
 	{
-		file->ReadString( materialName );
-		if( materialName.IsEmpty() )
+		const cm_binaryPolygon_t& bp = binaryPolygons[i];
+		if( bp.numEdges < 1 || bp.firstEdge < 0 || bp.firstEdge > header.numPolygonEdges - bp.numEdges || bp.material < -1 || bp.material >= materials.Num() )
 		{
-			materials[i] = NULL;
+			valid = false;
+			break;
 		}
-		else
+		cm_polygon_t* p = AllocPolygon( model, bp.numEdges );
+		p->bounds = bp.bounds;
+		p->plane = bp.plane;
+		p->contents = bp.contents;
+		p->material = ( bp.material >= 0 ) ? materials[bp.material] : NULL;
+		p->numEdges = bp.numEdges;
+		memcpy( p->edges, polygonEdges + bp.firstEdge, bp.numEdges * sizeof( p->edges[0] ) );
+		polys[i] = p;
+		
+		// edge numbers are signed by the direction the polygon uses the edge in
+		for( j = 0; j < bp.numEdges; j++ )
 		{
-			materials[i] = declManager->FindMaterial( materialName );
+			if( p->edges[j] <= -header.numEdges || p->edges[j] >= header.numEdges )
+			{
+				valid = false;
+				break;
+			}
 		}
 	}
-	idList< cm_polygon_t* > polys;
+	
 	idList< cm_brush_t* > brushes;
-	polys.SetNum( model->numPolygons );
-	brushes.SetNum( model->numBrushes );
-	for( int i = 0; i < polys.Num(); i++ )
-	{
-		int materialIndex = 0;
-		file->ReadBig( materialIndex );
-		int numEdges = 0;
-		file->ReadBig( numEdges );
-		polys[i] = AllocPolygon( model, numEdges );
-		polys[i]->numEdges = numEdges;
-		polys[i]->material = materials[materialIndex];
-		file->ReadBig( polys[i]->bounds );
-		file->ReadBig( polys[i]->checkcount );
-		file->ReadBig( polys[i]->contents );
-		file->ReadBig( polys[i]->plane );
-		file->ReadBigArray( polys[i]->edges, polys[i]->numEdges );
-	}
-	for( int i = 0; i < brushes.Num(); i++ )
-	{
-		int materialIndex = 0;
-		file->ReadBig( materialIndex );
-		int numPlanes = 0;
-		file->ReadBig( numPlanes );
-		brushes[i] = AllocBrush( model, numPlanes );
-		brushes[i]->numPlanes = numPlanes;
-		brushes[i]->material = materials[materialIndex];
-		file->ReadBig( brushes[i]->checkcount );
-		file->ReadBig( brushes[i]->bounds );
-		file->ReadBig( brushes[i]->contents );
-		file->ReadBig( brushes[i]->primitiveNum );
-		file->ReadBigArray( brushes[i]->planes, brushes[i]->numPlanes );
+	brushes.SetNum( header.numBrushes );
+	for( i = 0; i < brushes.Num() && valid; i++ )
+	{
+		const cm_binaryBrush_t& bb = binaryBrushes[i];
+		if( bb.numPlanes < 1 || bb.firstPlane < 0 || bb.firstPlane > header.numBrushPlanes - bb.numPlanes || bb.material < -1 || bb.material >= materials.Num() )
+		{
+			valid = false;
+			break;
+		}
+		cm_brush_t* b = AllocBrush( model, bb.numPlanes );
+		b->bounds = bb.bounds;
+		b->contents = bb.contents;
+		b->material = ( bb.material >= 0 ) ? materials[bb.material] : NULL;
+		b->primitiveNum = bb.primitiveNum;
+		b->numPlanes = bb.numPlanes;
+		memcpy( b->planes, brushPlanes + bb.firstPlane, bb.numPlanes * sizeof( b->planes[0] ) );
+		brushes[i] = b;
 	}
-	struct local
+	
+	// the nodes and references are each allocated from a single block
+	idList< cm_node_t* > nodes;
+	nodes.SetNum( header.numNodes );
+	for( i = 0; i < nodes.Num(); i++ )
+	{
+		nodes[i] = AllocNode( model, header.numNodes );
+	}
+	model->numNodes = header.numNodes;
+	model->numPolygonRefs = header.numPolygonRefs;
+	model->numBrushRefs = header.numBrushRefs;
+	
+	for( i = 0; i < nodes.Num() && valid; i++ )
 	{
-		static void ReadNodeTree( idFile* file, cm_model_t* model, cm_node_t* node, idList< cm_polygon_t* >& polys, idList< cm_brush_t* >& brushes )
+		const cm_binaryNode_t& bn = binaryNodes[i];
+		cm_node_t* node = nodes[i];
+		
+		if( bn.firstPolygonRef < 0 || bn.numPolygonRefs < 0 || bn.firstPolygonRef > header.numPolygonRefs - bn.numPolygonRefs ||
+				bn.firstBrushRef < 0 || bn.numBrushRefs < 0 || bn.firstBrushRef > header.numBrushRefs - bn.numBrushRefs )
 		{
-			file->ReadBig( node->planeType );
-			file->ReadBig( node->planeDist );
-			int i = 0;
-			while( file->ReadBig( i ) == sizeof( i ) && ( i >= 0 ) )
+			valid = false;
+			break;
+		}
+		
+		node->planeType = bn.planeType;
+		node->planeDist = bn.planeDist;
+		
+		// keep the references in the order they were written
+		cm_polygonRef_t** prefTail = &node->polygons;
+		for( j = 0; j < bn.numPolygonRefs; j++ )
+		{
+			int polyNum = polygonRefs[bn.firstPolygonRef + j];
+			if( polyNum < 0 || polyNum >= polys.Num() )
 			{
-				cm_polygonRef_t* pref = collisionModelManagerLocal.AllocPolygonReference( model, model->numPolygonRefs );
-				pref->p = polys[i];
-				pref->next = node->polygons;
-				node->polygons = pref;
+				valid = false;
+				break;
 			}
-			while( file->ReadBig( i ) == sizeof( i ) && ( i >= 0 ) )
+			cm_polygonRef_t* pref = AllocPolygonReference( model, header.numPolygonRefs );
+			pref->p = polys[polyNum];
+			pref->next = NULL;
+			*prefTail = pref;
+			prefTail = &pref->next;
+		}
+		cm_brushRef_t** brefTail = &node->brushes;
+		for( j = 0; j < bn.numBrushRefs; j++ )
+		{
+			int brushNum = brushRefs[bn.firstBrushRef + j];
+			if( brushNum < 0 || brushNum >= brushes.Num() )
 			{
-				cm_brushRef_t* bref = collisionModelManagerLocal.AllocBrushReference( model, model->numBrushRefs );
-				bref->b = brushes[i];
-				bref->next = node->brushes;
-				node->brushes = bref;
+				valid = false;
+				break;
 			}
-			if( node->planeType != -1 )
+			cm_brushRef_t* bref = AllocBrushReference( model, header.numBrushRefs );
+			bref->b = brushes[brushNum];
+			bref->next = NULL;
+			*brefTail = bref;
+			brefTail = &bref->next;
+		}
+		
+		if( node->planeType != -1 )
+		{
+			if( bn.children[0] <= i || bn.children[0] >= nodes.Num() || bn.children[1] <= i || bn.children[1] >= nodes.Num() )
 			{
-				node->children[0] = collisionModelManagerLocal.AllocNode( model, model->numNodes );
-				node->children[1] = collisionModelManagerLocal.AllocNode( model, model->numNodes );
-				node->children[0]->parent = node;
-				node->children[1]->parent = node;
-				ReadNodeTree( file, model, node->children[0], polys, brushes );
-				ReadNodeTree( file, model, node->children[1], polys, brushes );
+				valid = false;
+				break;
 			}
+			node->children[0] = nodes[bn.children[0]];
+			node->children[1] = nodes[bn.children[1]];
+			node->children[0]->parent = node;
+			node->children[1]->parent = node;
 		}
-	};
-	model->node = AllocNode( model, model->numNodes + 1 );
-	local::ReadNodeTree( file, model, model->node, polys, brushes );
+	}
+	
+	Mem_Free( data );
+	
+	if( !valid )
+	{
+		// the tree may be incomplete, all geometry is freed with the blocks
+		FreeModel( model );
+		return NULL;
+	}
 	
-	// We should have only allocated a single block, and used every entry in the block
-	// assert( model->nodeBlocks != NULL && model->nodeBlocks->next == NULL && model->nodeBlocks->nextNode == NULL );
-	assert( model->brushRefBlocks == NULL || ( model->brushRefBlocks->next == NULL && model->brushRefBlocks->nextRef == NULL ) );
-	assert( model->polygonRefBlocks == NULL || ( model->polygonRefBlocks->next == NULL && model->polygonRefBlocks->nextRef == NULL ) );
+	model->node = nodes[0];
 	
-	// RB: FIXME
-#if !defined(__x86_64__) && !defined(_WIN64)
 	assert( model->polygonBlock->bytesRemaining == 0 );
 	assert( model->brushBlock->bytesRemaining == 0 );
-#endif
-	// RB end
 	
 	model->usedMemory = model->numVertices * sizeof( cm_vertex_t ) +
 						model->numEdges * sizeof( cm_edge_t ) +
@@ -3683,131 +3922,231 @@ idCollisionModelManagerLocal::WriteBinaryModel
 */
 void idCollisionModelManagerLocal::WriteBinaryModelToFile( cm_model_t* model, idFile* file, ID_TIME_T sourceTimeStamp )
 {
-
-	file->WriteBig( BCM_MAGIC );
-	file->WriteBig( sourceTimeStamp );
-	file->WriteString( model->name );
-	file->WriteBig( model->bounds );
-	file->WriteBig( model->contents );
-	file->WriteBig( model->isConvex );
-	file->WriteBig( model->numVertices );
-	file->WriteBig( model->numEdges );
-	file->WriteBig( model->numPolygons );
-	file->WriteBig( model->numBrushes );
-	file->WriteBig( model->numNodes );
-	file->WriteBig( model->numBrushRefs );
-	file->WriteBig( model->numPolygonRefs );
-	file->WriteBig( model->numInternalEdges );
-	file->WriteBig( model->numSharpEdges );
-	file->WriteBig( model->numRemovedPolys );
-	file->WriteBig( model->numMergedPolys );
-	for( int i = 0; i < model->numVertices; i++ )
-	{
-		file->WriteBig( model->vertices[i].p );
-		file->WriteBig( model->vertices[i].checkcount );
-		file->WriteBig( model->vertices[i].side );
-		file->WriteBig( model->vertices[i].sideSet );
-	}
-	for( int i = 0; i < model->numEdges; i++ )
-	{
-		file->WriteBig( model->edges[i].checkcount );
-		file->WriteBig( model->edges[i].internal );
-		file->WriteBig( model->edges[i].numUsers );
-		file->WriteBig( model->edges[i].side );
-		file->WriteBig( model->edges[i].sideSet );
-		file->WriteBig( model->edges[i].vertexNum[0] );
-		file->WriteBig( model->edges[i].vertexNum[1] );
-		file->WriteBig( model->edges[i].normal );
-	}
-	file->WriteBig( model->polygonMemory );
-	file->WriteBig( model->brushMemory );
+	int i, offset;
+	
 	struct local
 	{
-		static void BuildUniqueLists( cm_node_t* node, idList< cm_polygon_t* >& polys, idList< cm_brush_t* >& brushes )
+		static int FindIndex( const idList< const void* >& list, const idHashIndex& hash, const void* ptr )
+		{
+			for( int i = hash.First( ( int )( ( intptr_t )ptr >> 4 ) ); i != -1; i = hash.Next( i ) )
+			{
+				if( list[i] == ptr )
+				{
+					return i;
+				}
+			}
+			return -1;
+		}
+		static int AddUnique( idList< const void* >& list, idHashIndex& hash, const void* ptr )
+		{
+			int index = FindIndex( list, hash, ptr );
+			if( index == -1 )
+			{
+				index = list.Append( ptr );
+				hash.Add( ( int )( ( intptr_t )ptr >> 4 ), index );
+			}
+			return index;
+		}
+		static void BuildUniqueLists( cm_node_t* node, idList< const void* >& polys, idHashIndex& polyHash, idList< const void* >& brushes, idHashIndex& brushHash )
 		{
 			for( cm_polygonRef_t* pr = node->polygons; pr != NULL; pr = pr->next )
 			{
-				polys.AddUnique( pr->p );
+				AddUnique( polys, polyHash, pr->p );
 			}
 			for( cm_brushRef_t* br = node->brushes; br != NULL; br = br->next )
 			{
-				brushes.AddUnique( br->b );
+				AddUnique( brushes, brushHash, br->b );
 			}
 			if( node->planeType != -1 )
 			{
-				BuildUniqueLists( node->children[0], polys, brushes );
-				BuildUniqueLists( node->children[1], polys, brushes );
+				BuildUniqueLists( node->children[0], polys, polyHash, brushes, brushHash );
+				BuildUniqueLists( node->children[1], polys, polyHash, brushes, brushHash );
 			}
 		}
-		static void WriteNodeTree( idFile* file, cm_node_t* node, idList< cm_polygon_t* >& polys, idList< cm_brush_t* >& brushes )
+		static int BuildNodeList( cm_node_t* node, idList< cm_binaryNode_t >& nodes, idList< int >& polygonRefs, idList< int >& brushRefs,
+								  const idList< const void* >& polys, const idHashIndex& polyHash, const idList< const void* >& brushes, const idHashIndex& brushHash )
 		{
-			file->WriteBig( node->planeType );
-			file->WriteBig( node->planeDist );
+			int index = nodes.Num();
+			cm_binaryNode_t& bn = nodes.Alloc();
+			bn.planeType = node->planeType;
+			bn.planeDist = node->planeDist;
+			bn.children[0] = bn.children[1] = -1;
+			bn.firstPolygonRef = polygonRefs.Num();
 			for( cm_polygonRef_t* pr = node->polygons; pr != NULL; pr = pr->next )
 			{
-				file->WriteBig( polys.FindIndex( pr->p ) );
+				polygonRefs.Append( FindIndex( polys, polyHash, pr->p ) );
 			}
-			file->WriteBig( -1 );
+			bn.numPolygonRefs = polygonRefs.Num() - bn.firstPolygonRef;
+			bn.firstBrushRef = brushRefs.Num();
 			for( cm_brushRef_t* br = node->brushes; br != NULL; br = br->next )
 			{
-				file->WriteBig( brushes.FindIndex( br->b ) );
+				brushRefs.Append( FindIndex( brushes, brushHash, br->b ) );
 			}
-			file->WriteBig( -1 );
+			bn.numBrushRefs = brushRefs.Num() - bn.firstBrushRef;
 			if( node->planeType != -1 )
 			{
-				WriteNodeTree( file, node->children[0], polys, brushes );
-				WriteNodeTree( file, node->children[1], polys, brushes );
+				int child0 = BuildNodeList( node->children[0], nodes, polygonRefs, brushRefs, polys, polyHash, brushes, brushHash );
+				int child1 = BuildNodeList( node->children[1], nodes, polygonRefs, brushRefs, polys, polyHash, brushes, brushHash );
+				nodes[index].children[0] = child0;
+				nodes[index].children[1] = child1;
 			}
+			return index;
 		}
 	};
-	idList< cm_polygon_t* > polys;
-	idList< cm_brush_t* > brushes;
-	local::BuildUniqueLists( model->node, polys, brushes );
+	
+	idList< const void* > polys;
+	idList< const void* > brushes;
+	idHashIndex polyHash( 4096, Max( 16, model->numPolygons ) );
+	idHashIndex brushHash( 1024, Max( 16, model->numBrushes ) );
+	local::BuildUniqueLists( model->node, polys, polyHash, brushes, brushHash );
 	assert( polys.Num() == model->numPolygons );
 	assert( brushes.Num() == model->numBrushes );
 	
+	idList< cm_binaryNode_t > nodes;
+	idList< int > polygonRefs;
+	idList< int > brushRefs;
+	nodes.SetGranularity( 1024 );
+	polygonRefs.SetGranularity( 1024 );
+	brushRefs.SetGranularity( 1024 );
+	local::BuildNodeList( model->node, nodes, polygonRefs, brushRefs, polys, polyHash, brushes, brushHash );
+	
 	idList< const idMaterial* > materials;
-	for( int i = 0; i < polys.Num(); i++ )
-	{
-		materials.AddUnique( polys[i]->material );
+	cm_binaryHeader_t header;
+	memset( &header, 0, sizeof( header ) );
+	
+	for( i = 0; i < polys.Num(); i++ )
+	{
+		const cm_polygon_t* p = ( const cm_polygon_t* )polys[i];
+		materials.AddUnique( p->material );
+		header.numPolygonEdges += p->numEdges;
+		header.polygonMemory += sizeof( cm_polygon_t ) + ( p->numEdges - 1 ) * sizeof( p->edges[0] );
+	}
+	for( i = 0; i < brushes.Num(); i++ )
+	{
+		const cm_brush_t* b = ( const cm_brush_t* )brushes[i];
+		materials.AddUnique( b->material );
+		header.numBrushPlanes += b->numPlanes;
+		header.brushMemory += sizeof( cm_brush_t ) + ( b->numPlanes - 1 ) * sizeof( b->planes[0] );
+	}
+	
+	header.byteOrder = BCM_BYTE_ORDER;
+	header.bounds = model->bounds;
+	header.contents = model->contents;
+	header.isConvex = model->isConvex;
+	header.numVertices = model->numVertices;
+	header.numEdges = model->numEdges;
+	header.numPolygons = polys.Num();
+	header.numBrushes = brushes.Num();
+	header.numNodes = nodes.Num();
+	header.numPolygonRefs = polygonRefs.Num();
+	header.numBrushRefs = brushRefs.Num();
+	header.numMaterials = materials.Num();
+	header.numInternalEdges = model->numInternalEdges;
+	header.numSharpEdges = model->numSharpEdges;
+	header.numRemovedPolys = model->numRemovedPolys;
+	header.numMergedPolys = model->numMergedPolys;
+	
+	// lay out the sections
+	offset = ALIGN( sizeof( header ), 16 );
+	header.nameOffset = offset;
+	offset = ALIGN( offset + model->name.Length() + 1, 16 );
+	header.vertexOffset = offset;
+	offset = ALIGN( offset + header.numVertices * sizeof( idVec3 ), 16 );
+	header.edgeOffset = offset;
+	offset = ALIGN( offset + header.numEdges * sizeof( cm_binaryEdge_t ), 16 );
+	header.polygonOffset = offset;
+	offset = ALIGN( offset + header.numPolygons * sizeof( cm_binaryPolygon_t ), 16 );
+	header.polygonEdgeOffset = offset;
+	offset = ALIGN( offset + header.numPolygonEdges * sizeof( int ), 16 );
+	header.brushOffset = offset;
+	offset = ALIGN( offset + header.numBrushes * sizeof( cm_binaryBrush_t ), 16 );
+	header.brushPlaneOffset = offset;
+	offset = ALIGN( offset + header.numBrushPlanes * sizeof( idPlane ), 16 );
+	header.nodeOffset = offset;
+	offset = ALIGN( offset + header.numNodes * sizeof( cm_binaryNode_t ), 16 );
+	header.polygonRefOffset = offset;
+	offset = ALIGN( offset + header.numPolygonRefs * sizeof( int ), 16 );
+	header.brushRefOffset = offset;
+	offset = ALIGN( offset + header.numBrushRefs * sizeof( int ), 16 );
+	header.materialOffset = offset;
+	offset += header.numMaterials * sizeof( int );
+	for( i = 0; i < materials.Num(); i++ )
+	{
+		offset += ( materials[i] != NULL ? idStr::Length( materials[i]->GetName() ) : 0 ) + 1;
+	}
+	header.size = ALIGN( offset, 16 );
+	
+	byte* data = ( byte* ) Mem_ClearedAlloc( header.size, TAG_COLLISION );
+	memcpy( data, &header, sizeof( header ) );
+	memcpy( data + header.nameOffset, model->name.c_str(), model->name.Length() + 1 );
+	
+	idVec3* vertexPoints = ( idVec3* )( data + header.vertexOffset );
+	for( i = 0; i < header.numVertices; i++ )
+	{
+		vertexPoints[i] = model->vertices[i].p;
+	}
+	
+	cm_binaryEdge_t* binaryEdges = ( cm_binaryEdge_t* )( data + header.edgeOffset );
+	for( i = 0; i < header.numEdges; i++ )
+	{
+		binaryEdges[i].vertexNum[0] = model->edges[i].vertexNum[0];
+		binaryEdges[i].vertexNum[1] = model->edges[i].vertexNum[1];
+		binaryEdges[i].normal = model->edges[i].normal;
+		binaryEdges[i].internal = model->edges[i].internal;
+		binaryEdges[i].numUsers = model->edges[i].numUsers;
+	}
+	
+	cm_binaryPolygon_t* binaryPolygons = ( cm_binaryPolygon_t* )( data + header.polygonOffset );
+	int* polygonEdges = ( int* )( data + header.polygonEdgeOffset );
+	int numPolygonEdges = 0;
+	for( i = 0; i < header.numPolygons; i++ )
+	{
+		const cm_polygon_t* p = ( const cm_polygon_t* )polys[i];
+		binaryPolygons[i].bounds = p->bounds;
+		binaryPolygons[i].plane = p->plane;
+		binaryPolygons[i].contents = p->contents;
+		binaryPolygons[i].material = materials.FindIndex( p->material );
+		binaryPolygons[i].firstEdge = numPolygonEdges;
+		binaryPolygons[i].numEdges = p->numEdges;
+		memcpy( polygonEdges + numPolygonEdges, p->edges, p->numEdges * sizeof( p->edges[0] ) );
+		numPolygonEdges += p->numEdges;
+	}
+	
+	cm_binaryBrush_t* binaryBrushes = ( cm_binaryBrush_t* )( data + header.brushOffset );
+	idPlane* brushPlanes = ( idPlane* )( data + header.brushPlaneOffset );
+	int numBrushPlanes = 0;
+	for( i = 0; i < header.numBrushes; i++ )
+	{
+		const cm_brush_t* b = ( const cm_brush_t* )brushes[i];
+		binaryBrushes[i].bounds = b->bounds;
+		binaryBrushes[i].contents = b->contents;
+		binaryBrushes[i].material = materials.FindIndex( b->material );
+		binaryBrushes[i].primitiveNum = b->primitiveNum;
+		binaryBrushes[i].firstPlane = numBrushPlanes;
+		binaryBrushes[i].numPlanes = b->numPlanes;
+		memcpy( brushPlanes + numBrushPlanes, b->planes, b->numPlanes * sizeof( b->planes[0] ) );
+		numBrushPlanes += b->numPlanes;
+	}
+	
+	memcpy( data + header.nodeOffset, nodes.Ptr(), header.numNodes * sizeof( cm_binaryNode_t ) );
+	memcpy( data + header.polygonRefOffset, polygonRefs.Ptr(), header.numPolygonRefs * sizeof( int ) );
+	memcpy( data + header.brushRefOffset, brushRefs.Ptr(), header.numBrushRefs * sizeof( int ) );
+	
+	int* materialNames = ( int* )( data + header.materialOffset );
+	offset = header.materialOffset + header.numMaterials * sizeof( int );
+	for( i = 0; i < header.numMaterials; i++ )
+	{
+		const char* materialName = ( materials[i] != NULL ) ? materials[i]->GetName() : "";
+		materialNames[i] = offset;
+		memcpy( data + offset, materialName, idStr::Length( materialName ) + 1 );
+		offset += idStr::Length( materialName ) + 1;
 	}
-	for( int i = 0; i < brushes.Num(); i++ )
-	{
-		materials.AddUnique( brushes[i]->material );
-	}
-	file->WriteBig( materials.Num() );
-	for( int i = 0; i < materials.Num(); i++ )
-	{
-		if( materials[i] == NULL )
-		{
-			file->WriteString( "" );
-		}
-		else
-		{
-			file->WriteString( materials[i]->GetName() );
-		}
-	}
-	for( int i = 0; i < polys.Num(); i++ )
-	{
-		file->WriteBig( ( int )materials.FindIndex( polys[i]->material ) );
-		file->WriteBig( polys[i]->numEdges );
-		file->WriteBig( polys[i]->bounds );
-		file->WriteBig( polys[i]->checkcount );
-		file->WriteBig( polys[i]->contents );
-		file->WriteBig( polys[i]->plane );
-		file->WriteBigArray( polys[i]->edges, polys[i]->numEdges );
-	}
-	for( int i = 0; i < brushes.Num(); i++ )
-	{
-		file->WriteBig( ( int )materials.FindIndex( brushes[i]->material ) );
-		file->WriteBig( brushes[i]->numPlanes );
-		file->WriteBig( brushes[i]->checkcount );
-		file->WriteBig( brushes[i]->bounds );
-		file->WriteBig( brushes[i]->contents );
-		file->WriteBig( brushes[i]->primitiveNum );
-		file->WriteBigArray( brushes[i]->planes, brushes[i]->numPlanes );
-	}
-	local::WriteNodeTree( file, model->node, polys, brushes );
+	
+	file->WriteBig( BCM_MAGIC );
+	file->WriteBig( sourceTimeStamp );
+	file->Write( data, header.size );
+	
+	Mem_Free( data );
 }
 
 /*
@@ -4284,6 +4623,15 @@ void idCollisionModelManagerLocal::BuildModels( const idMapFile* mapFile )
 		WriteCollisionModelsToFile( mapFile->GetName(), 0, numModels, mapFile->GetGeometryCRC() );
 	}
 	
+	// the bounding volume hierarchies are not stored in the file and built after loading
+	if( cm_useBVH.GetBool() )
+	{
+		for( i = 0; i < numModels; i++ )
+		{
+			BuildBVH( models[i] );
+		}
+	}
+	
 	timer.Stop();
 	
 	// print statistics on collision data
@@ -59,6 +59,11 @@ If you have questions concerning this license or the applicable additional terms
 #define VERTEX_EPSILON						0.1f
 #define CHOP_EPSILON						0.1f
 
+#define CM_MAX_TRACE_SLOTS					4		// max number of traces that can run concurrently
+#define CM_MAX_TRM_MODELS					8		// max number of threads that set up and trace against trace models
+#define CM_BVH_MAX_LEAF_PRIMITIVES			8		// max number of polygons and brushes in a bvh leaf
+#define CM_BVH_MAX_DEPTH					64		// max depth of the bvh, deeper ranges become leafs
+
 
 typedef struct cm_windingList_s
 {
@@ -80,14 +85,20 @@ Collision model
 ===============================================================================
 */
 
+typedef struct cm_traceStamp_s
+{
+	int						checkcount;			// stamp of the last trace that used this slot on the feature
+	// DG: use int instead of long for 64bit compatibility
+	unsigned int			side;				// each bit tells at which side the feature passes one of the trace model features
+	unsigned int			sideSet;			// each bit tells if sidedness for the trace model feature has been calculated yet
+	// DG end
+} cm_traceStamp_t;
+
 typedef struct cm_vertex_s
 {
 	idVec3					p;					// vertex point
 	int						checkcount;			// for multi-check avoidance
-	// DG: use int instead of long for 64bit compatibility
-	unsigned int			side;				// each bit tells at which side this vertex passes one of the trace model edges
-	unsigned int			sideSet;			// each bit tells if sidedness for the trace model edge has been calculated yet
-	// DG end
+	cm_traceStamp_t			traceStamps[CM_MAX_TRACE_SLOTS];	// per trace slot multi-check avoidance and sidedness
 } cm_vertex_t;
 
 typedef struct cm_edge_s
@@ -95,10 +106,7 @@ typedef struct cm_edge_s
 	int						checkcount;			// for multi-check avoidance
 	unsigned short			internal;			// a trace model can never collide with internal edges
 	unsigned short			numUsers;			// number of polygons using this edge
-	// DG: use int instead of long for 64bit compatibility
-	unsigned int			side;				// each bit tells at which side of this edge one of the trace model vertices passes
-	unsigned int			sideSet;			// each bit tells if sidedness for the trace model vertex has been calculated yet
-	// DG end
+	cm_traceStamp_t			traceStamps[CM_MAX_TRACE_SLOTS];	// per trace slot multi-check avoidance and sidedness
 	int						vertexNum[2];		// start and end point of edge
 	idVec3					normal;				// edge normal
 } cm_edge_t;
@@ -113,6 +121,7 @@ typedef struct cm_polygon_s
 {
 	idBounds				bounds;				// polygon bounds
 	int						checkcount;			// for multi-check avoidance
+	int						traceCheckcount[CM_MAX_TRACE_SLOTS];	// per trace slot multi-check avoidance
 	int						contents;			// contents behind polygon
 	const idMaterial* 		material;			// material
 	idPlane					plane;				// polygon plane
@@ -143,12 +152,14 @@ typedef struct cm_brush_s
 	cm_brush_s()
 	{
 		checkcount = 0;
+		memset( traceCheckcount, 0, sizeof( traceCheckcount ) );
 		contents = 0;
 		material = NULL;
 		primitiveNum = 0;
 		numPlanes = 0;
 	}
 	int						checkcount;			// for multi-check avoidance
+	int						traceCheckcount[CM_MAX_TRACE_SLOTS];	// per trace slot multi-check avoidance
 	idBounds				bounds;				// brush bounds
 	int						contents;			// contents of brush
 	const idMaterial* 		material;			// material
@@ -185,6 +196,28 @@ typedef struct cm_nodeBlock_s
 	struct cm_nodeBlock_s* next;				// next block with nodes
 } cm_nodeBlock_t;
 
+typedef struct cm_bvhNode_s
+{
+	float					bounds[6][4];		// child bounds, mins followed by maxs with one float per child
+	int						children[4];		// node index or -1 - leaf index
+} cm_bvhNode_t;
+
+typedef struct cm_bvhLeaf_s
+{
+	int						firstPolygonGroup;	// first group of four polygons
+	int						numPolygonGroups;	// number of polygon groups
+	int						firstBrush;			// first brush in cm_model_t->bvhBrushes
+	int						numBrushes;			// number of brushes
+} cm_bvhLeaf_t;
+
+typedef struct cm_bvhPolygonGroup_s
+{
+	float					bounds[6][4];		// polygon bounds, mins followed by maxs with one float per polygon
+	float					normal[3][4];		// polygon plane normals
+	int						contents[4];		// polygon contents, zero for unused entries
+	cm_polygon_t* 			polygons[4];		// polygons, NULL for unused entries
+} cm_bvhPolygonGroup_t;
+
 typedef struct cm_model_s
 {
 	idStr					name;				// model name
@@ -205,6 +238,15 @@ typedef struct cm_model_s
 	cm_brushRefBlock_t* 	brushRefBlocks;		// list with blocks of brush references
 	cm_polygonBlock_t* 		polygonBlock;		// memory block with all polygons
 	cm_brushBlock_t* 		brushBlock;			// memory block with all brushes
+	// bounding volume hierarchy used instead of the node tree for tracing when built
+	cm_bvhNode_t* 			bvhNodes;			// bvh nodes with the root first
+	cm_bvhLeaf_t* 			bvhLeafs;			// bvh leafs
+	cm_bvhPolygonGroup_t* 	bvhPolygonGroups;	// polygons packed in groups of four per leaf
+	cm_brush_t** 			bvhBrushes;			// brushes in leaf order
+	int						numBvhNodes;
+	int						numBvhLeafs;
+	int						numBvhPolygonGroups;
+	int						numBvhBrushes;
 	// statistics
 	int						numPolygons;
 	int						polygonMemory;
@@ -220,6 +262,14 @@ typedef struct cm_model_s
 	int						usedMemory;
 } cm_model_t;
 
+// collision model a thread converts its trace models into
+typedef struct cm_trmModel_s
+{
+	cm_model_t* 			model;
+	cm_polygonRef_t* 		polygons[MAX_TRACEMODEL_POLYS];
+	cm_brushRef_t* 			brush;
+} cm_trmModel_t;
+
 /*
 ===============================================================================
 
@@ -287,6 +337,9 @@ typedef struct cm_traceWork_s
 	bool getContacts;								// true if retrieving contacts
 	bool quickExit;									// set to quickly stop the collision detection calculations
 	
+	int slot;										// trace slot used for the stamps on the model features
+	int checkCount;									// unique stamp of this trace for multi-check avoidance
+	
 	idVec3 origin;									// origin of rotation in model space
 	idVec3 axis;									// rotation axis in model space
 	idMat3 matrix;									// rotates axis of rotation to the z-axis
@@ -388,6 +441,9 @@ private:			// CollisionMap_translate.cpp
 	bool			TranslateTrmThroughPolygon( cm_traceWork_t* tw, cm_polygon_t* p );
 	void			SetupTranslationHeartPlanes( cm_traceWork_t* tw );
 	void			SetupTrm( cm_traceWork_t* tw, const idTraceModel* trm );
+	void			Translation( cm_traceWork_t* tw, trace_t* results, const idVec3& start, const idVec3& end,
+								 const idTraceModel* trm, const idMat3& trmAxis, int contentMask,
+								 cmHandle_t model, const idVec3& modelOrigin, const idMat3& modelAxis );
 	
 private:			// CollisionMap_rotate.cpp
 	int				CollisionBetweenEdgeBounds( cm_traceWork_t* tw, const idVec3& va, const idVec3& vb,
@@ -412,7 +468,7 @@ private:			// CollisionMap_rotate.cpp
 			cm_vertex_t* v, idVec3& rotationOrigin );
 	bool			RotateTrmThroughPolygon( cm_traceWork_t* tw, cm_polygon_t* p );
 	void			BoundsForRotation( const idVec3& origin, const idVec3& axis, const idVec3& start, const idVec3& end, idBounds& bounds );
-	void			Rotation180( trace_t* results, const idVec3& rorg, const idVec3& axis,
+	void			Rotation180( cm_traceWork_t* tw, trace_t* results, const idVec3& rorg, const idVec3& axis,
 								 const float startAngle, const float endAngle, const idVec3& start,
 								 const idTraceModel* trm, const idMat3& trmAxis, int contentMask,
 								 cmHandle_t model, const idVec3& origin, const idMat3& modelAxis );
@@ -428,14 +484,26 @@ private:			// CollisionMap_contents.cpp
 								 cmHandle_t model, const idVec3& modelOrigin, const idMat3& modelAxis );
 								 
 private:			// CollisionMap_trace.cpp
+	void			BeginTrace( cm_traceWork_t* tw );
+	void			EndTrace( cm_traceWork_t* tw );
 	void			TraceTrmThroughNode( cm_traceWork_t* tw, cm_node_t* node );
 	void			TraceThroughAxialBSPTree_r( cm_traceWork_t* tw, cm_node_t* node, float p1f, float p2f, idVec3& p1, idVec3& p2 );
+	void			TraceThroughBSP( cm_traceWork_t* tw );
 	void			TraceThroughModel( cm_traceWork_t* tw );
 	void			RecurseProcBSP_r( trace_t* results, int parentNodeNum, int nodeNum, float p1f, float p2f, const idVec3& p1, const idVec3& p2 );
 	
+private:			// CollisionMap_bvh.cpp
+	void			BuildBVH( cm_model_t* model );
+	void			FreeBVH( cm_model_t* model );
+	void			TraceTrmThroughBVHLeaf( cm_traceWork_t* tw, const cm_model_t* model, const cm_bvhLeaf_t* leaf );
+	void			TraceThroughBVH( cm_traceWork_t* tw );
+	
 private:			// CollisionMap_load.cpp
 	void			Clear();
 	void			FreeTrmModelStructure();
+	// trace model and collision model for a handle, trace model handles are per thread
+	cm_trmModel_t* 	GetThreadTrmModel();
+	cm_model_t* 	GetModel( cmHandle_t model );
 	// model deallocation
 	void			RemovePolygonReferences_r( cm_node_t* node, cm_polygon_t* p );
 	void			RemoveBrushReferences_r( cm_node_t* node, cm_brush_t* b );
@@ -546,23 +614,22 @@ private:			// collision map data
 	int				loaded;
 	// for multi-check avoidance
 	int				checkCount;
+	// for multi-check avoidance of concurrent traces
+	idSysInterlockedInteger traceCheckCount;
+	interlockedInt_t traceSlotInUse[CM_MAX_TRACE_SLOTS];
 	// models
 	int				maxModels;
 	int				numModels;
 	cm_model_t** 	models;
-	// polygons and brush for trm model
-	cm_polygonRef_t* trmPolygons[MAX_TRACEMODEL_POLYS];
-	cm_brushRef_t* 	trmBrushes[1];
+	// models with polygons and brush for trace models, one for each thread
+	cm_trmModel_t	trmModels[CM_MAX_TRM_MODELS];
 	const idMaterial* trmMaterial;
 	// for data pruning
 	int				numProcNodes;
 	cm_procNode_t* 	procNodes;
-	// for retrieving contact points
-	bool			getContacts;
-	contactInfo_t* 	contacts;
-	int				maxContacts;
-	int				numContacts;
 };
 
 // for debugging
 extern idCVar cm_debugCollision;
+extern idCVar cm_useBVH;
+extern idCVar cm_testBVH;
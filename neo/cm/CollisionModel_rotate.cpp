@@ -555,7 +555,7 @@ void idCollisionModelManagerLocal::RotateTrmEdgeThroughPolygon( cm_traceWork_t*
 		edge = tw->model->edges + abs( edgeNum );
 		
 		// if this edge is already checked
-		if( edge->checkcount == idCollisionModelManagerLocal::checkCount )
+		if( edge->traceStamps[tw->slot].checkcount == tw->checkCount )
 		{
 			continue;
 		}
@@ -1194,11 +1194,11 @@ bool idCollisionModelManagerLocal::RotateTrmThroughPolygon( cm_traceWork_t* tw,
 	idVec3* rotationOrigin;
 	
 	// if already checked this polygon
-	if( p->checkcount == idCollisionModelManagerLocal::checkCount )
+	if( p->traceCheckcount[tw->slot] == tw->checkCount )
 	{
 		return false;
 	}
-	p->checkcount = idCollisionModelManagerLocal::checkCount;
+	p->traceCheckcount[tw->slot] = tw->checkCount;
 	
 	// if this polygon does not have the right contents behind it
 	if( !( p->contents & tw->contents ) )
@@ -1312,12 +1312,12 @@ bool idCollisionModelManagerLocal::RotateTrmThroughPolygon( cm_traceWork_t* tw,
 			edgeNum = p->edges[i];
 			e = tw->model->edges + abs( edgeNum );
 			
-			if( e->checkcount == idCollisionModelManagerLocal::checkCount )
+			if( e->traceStamps[tw->slot].checkcount == tw->checkCount )
 			{
 				continue;
 			}
 			// set edge check count
-			e->checkcount = idCollisionModelManagerLocal::checkCount;
+			e->traceStamps[tw->slot].checkcount = tw->checkCount;
 			// can never collide with internal edges
 			if( e->internal )
 			{
@@ -1330,12 +1330,12 @@ bool idCollisionModelManagerLocal::RotateTrmThroughPolygon( cm_traceWork_t* tw,
 				v = tw->model->vertices + e->vertexNum[k ^ INT32_SIGNBITSET( edgeNum )];
 				
 				// if this vertex is already checked
-				if( v->checkcount == idCollisionModelManagerLocal::checkCount )
+				if( v->traceStamps[tw->slot].checkcount == tw->checkCount )
 				{
 					continue;
 				}
 				// set vertex check count
-				v->checkcount = idCollisionModelManagerLocal::checkCount;
+				v->traceStamps[tw->slot].checkcount = tw->checkCount;
 				
 				// if the vertex is outside the trm rotation bounds
 				if( !tw->bounds.ContainsPoint( v->p ) )
@@ -1414,7 +1414,7 @@ void idCollisionModelManagerLocal::BoundsForRotation( const idVec3& origin, cons
 idCollisionModelManagerLocal::Rotation180
 ================
 */
-void idCollisionModelManagerLocal::Rotation180( trace_t* results, const idVec3& rorg, const idVec3& axis,
+void idCollisionModelManagerLocal::Rotation180( cm_traceWork_t* tw, trace_t* results, const idVec3& rorg, const idVec3& axis,
 		const float startAngle, const float endAngle, const idVec3& start,
 		const idTraceModel* trm, const idMat3& trmAxis, int contentMask,
 		cmHandle_t model, const idVec3& modelOrigin, const idMat3& modelAxis )
@@ -1429,77 +1429,74 @@ void idCollisionModelManagerLocal::Rotation180( trace_t* results, const idVec3&
 	cm_trmPolygon_t* poly;
 	cm_trmEdge_t* edge;
 	cm_trmVertex_t* vert;
-	ALIGN16( static cm_traceWork_t tw );
 	
 	if( model < 0 || model > MAX_SUBMODELS || model > idCollisionModelManagerLocal::maxModels )
 	{
 		common->Printf( "idCollisionModelManagerLocal::Rotation180: invalid model handle\n" );
 		return;
 	}
-	if( !idCollisionModelManagerLocal::models[model] )
+	if( !idCollisionModelManagerLocal::GetModel( model ) )
 	{
 		common->Printf( "idCollisionModelManagerLocal::Rotation180: invalid model\n" );
 		return;
 	}
 	
-	idCollisionModelManagerLocal::checkCount++;
-	
-	tw.trace.fraction = 1.0f;
-	tw.trace.c.contents = 0;
-	tw.trace.c.type = CONTACT_NONE;
-	tw.contents = contentMask;
-	tw.isConvex = true;
-	tw.rotation = true;
-	tw.positionTest = false;
-	tw.axisIntersectsTrm = false;
-	tw.quickExit = false;
-	tw.angle = endAngle - startAngle;
-	assert( tw.angle > -180.0f && tw.angle < 180.0f );
-	tw.maxTan = initialTan = idMath::Fabs( tan( ( idMath::PI / 360.0f ) * tw.angle ) );
-	tw.model = idCollisionModelManagerLocal::models[model];
-	tw.start = start - modelOrigin;
+	tw->trace.fraction = 1.0f;
+	tw->trace.c.contents = 0;
+	tw->trace.c.type = CONTACT_NONE;
+	tw->contents = contentMask;
+	tw->isConvex = true;
+	tw->rotation = true;
+	tw->positionTest = false;
+	tw->axisIntersectsTrm = false;
+	tw->quickExit = false;
+	tw->angle = endAngle - startAngle;
+	assert( tw->angle > -180.0f && tw->angle < 180.0f );
+	tw->maxTan = initialTan = idMath::Fabs( tan( ( idMath::PI / 360.0f ) * tw->angle ) );
+	tw->model = idCollisionModelManagerLocal::GetModel( model );
+	tw->start = start - modelOrigin;
 	// rotation axis, axis is assumed to be normalized
-	tw.axis = axis;
-//	assert( tw.axis[0] * tw.axis[0] + tw.axis[1] * tw.axis[1] + tw.axis[2] * tw.axis[2] > 0.99f );
-	// rotation origin projected into rotation plane through tw.start
-	tw.origin = rorg - modelOrigin;
-	d = ( tw.axis * tw.origin ) - ( tw.axis * tw.start );
-	tw.origin = tw.origin - d * tw.axis;
+	tw->axis = axis;
+//	assert( tw->axis[0] * tw->axis[0] + tw->axis[1] * tw->axis[1] + tw->axis[2] * tw->axis[2] > 0.99f );
+	// rotation origin projected into rotation plane through tw->start
+	tw->origin = rorg - modelOrigin;
+	d = ( tw->axis * tw->origin ) - ( tw->axis * tw->start );
+	tw->origin = tw->origin - d * tw->axis;
 	// radius of rotation
-	tw.radius = ( tw.start - tw.origin ).Length();
+	tw->radius = ( tw->start - tw->origin ).Length();
 	// maximum error of the circle approximation traced through the axial BSP tree
-	d = tw.radius * tw.radius - ( CIRCLE_APPROXIMATION_LENGTH * CIRCLE_APPROXIMATION_LENGTH * 0.25f );
+	d = tw->radius * tw->radius - ( CIRCLE_APPROXIMATION_LENGTH * CIRCLE_APPROXIMATION_LENGTH * 0.25f );
 	if( d > 0.0f )
 	{
-		maxErr = tw.radius - idMath::Sqrt( d );
+		maxErr = tw->radius - idMath::Sqrt( d );
 	}
 	else
 	{
-		maxErr = tw.radius;
+		maxErr = tw->radius;
 	}
 	
 	model_rotated = modelAxis.IsRotated();
 	if( model_rotated )
 	{
 		invModelAxis = modelAxis.Transpose();
-		tw.axis *= invModelAxis;
-		tw.origin *= invModelAxis;
+		tw->axis *= invModelAxis;
+		tw->origin *= invModelAxis;
 	}
 	
-	startRotation.Set( tw.origin, tw.axis, startAngle );
-	endRotation.Set( tw.origin, tw.axis, endAngle );
+	startRotation.Set( tw->origin, tw->axis, startAngle );
+	endRotation.Set( tw->origin, tw->axis, endAngle );
 	
 	// create matrix which rotates the rotation axis to the z-axis
-	tw.axis.NormalVectors( vr, vup );
-	tw.matrix[0][0] = vr[0];
-	tw.matrix[1][0] = vr[1];
-	tw.matrix[2][0] = vr[2];
-	tw.matrix[0][1] = -vup[0];
-	tw.matrix[1][1] = -vup[1];
-	tw.matrix[2][1] = -vup[2];
-	tw.matrix[0][2] = tw.axis[0];
-	tw.matrix[1][2] = tw.axis[1];
-	tw.matrix[2][2] = tw.axis[2];
+	tw->axis.NormalVectors( vr, vup );
+	tw->matrix[0][0] = vr[0];
+	tw->matrix[1][0] = vr[1];
+	tw->matrix[2][0] = vr[2];
+	tw->matrix[0][1] = -vup[0];
+	tw->matrix[1][1] = -vup[1];
+	tw->matrix[2][1] = -vup[2];
+	tw->matrix[0][2] = tw->axis[0];
+	tw->matrix[1][2] = tw->axis[1];
+	tw->matrix[2][2] = tw->axis[2];
 	
 	// if optimized point trace
 	if( !trm || ( trm->bounds[1][0] - trm->bounds[0][0] <= 0.0f &&
@@ -1510,52 +1507,52 @@ void idCollisionModelManagerLocal::Rotation180( trace_t* results, const idVec3&
 		if( model_rotated )
 		{
 			// rotate trace instead of model
-			tw.start *= invModelAxis;
+			tw->start *= invModelAxis;
 		}
-		tw.end = tw.start;
+		tw->end = tw->start;
 		// if we start at a specific angle
 		if( startAngle != 0.0f )
 		{
-			startRotation.RotatePoint( tw.start );
+			startRotation.RotatePoint( tw->start );
 		}
 		// calculate end position of rotation
-		endRotation.RotatePoint( tw.end );
+		endRotation.RotatePoint( tw->end );
 		
 		// calculate rotation origin projected into rotation plane through the vertex
-		tw.numVerts = 1;
-		tw.vertices[0].p = tw.start;
-		tw.vertices[0].endp = tw.end;
-		tw.vertices[0].used = true;
-		tw.vertices[0].rotationOrigin = tw.origin + tw.axis * ( tw.axis * ( tw.vertices[0].p - tw.origin ) );
-		BoundsForRotation( tw.vertices[0].rotationOrigin, tw.axis, tw.start, tw.end, tw.vertices[0].rotationBounds );
+		tw->numVerts = 1;
+		tw->vertices[0].p = tw->start;
+		tw->vertices[0].endp = tw->end;
+		tw->vertices[0].used = true;
+		tw->vertices[0].rotationOrigin = tw->origin + tw->axis * ( tw->axis * ( tw->vertices[0].p - tw->origin ) );
+		BoundsForRotation( tw->vertices[0].rotationOrigin, tw->axis, tw->start, tw->end, tw->vertices[0].rotationBounds );
 		// rotation bounds
-		tw.bounds = tw.vertices[0].rotationBounds;
-		tw.numEdges = tw.numPolys = 0;
+		tw->bounds = tw->vertices[0].rotationBounds;
+		tw->numEdges = tw->numPolys = 0;
 		
 		// collision with single point
-		tw.pointTrace = true;
+		tw->pointTrace = true;
 		
 		// extents is set to maximum error of the circle approximation traced through the axial BSP tree
-		tw.extents[0] = tw.extents[1] = tw.extents[2] = maxErr + CM_BOX_EPSILON;
+		tw->extents[0] = tw->extents[1] = tw->extents[2] = maxErr + CM_BOX_EPSILON;
 		
 		// setup rotation heart plane
-		tw.heartPlane1.SetNormal( tw.axis );
-		tw.heartPlane1.FitThroughPoint( tw.start );
-		tw.maxDistFromHeartPlane1 = CM_BOX_EPSILON;
+		tw->heartPlane1.SetNormal( tw->axis );
+		tw->heartPlane1.FitThroughPoint( tw->start );
+		tw->maxDistFromHeartPlane1 = CM_BOX_EPSILON;
 		
 		// trace through the model
-		idCollisionModelManagerLocal::TraceThroughModel( &tw );
+		idCollisionModelManagerLocal::TraceThroughModel( tw );
 		
 		// store results
-		*results = tw.trace;
+		*results = tw->trace;
 		results->endpos = start;
-		if( tw.maxTan == initialTan )
+		if( tw->maxTan == initialTan )
 		{
 			results->fraction = 1.0f;
 		}
 		else
 		{
-			results->fraction = idMath::Fabs( atan( tw.maxTan ) * ( 2.0f * 180.0f / idMath::PI ) / tw.angle );
+			results->fraction = idMath::Fabs( atan( tw->maxTan ) * ( 2.0f * 180.0f / idMath::PI ) / tw->angle );
 		}
 		assert( results->fraction <= 1.0f );
 		endRotation.Set( rorg, axis, startAngle + ( endAngle - startAngle ) * results->fraction );
@@ -1576,83 +1573,83 @@ void idCollisionModelManagerLocal::Rotation180( trace_t* results, const idVec3&
 		return;
 	}
 	
-	tw.pointTrace = false;
+	tw->pointTrace = false;
 	
 	// setup trm structure
-	idCollisionModelManagerLocal::SetupTrm( &tw, trm );
+	idCollisionModelManagerLocal::SetupTrm( tw, trm );
 	
 	trm_rotated = trmAxis.IsRotated();
 	
 	// calculate vertex positions
 	if( trm_rotated )
 	{
-		for( i = 0; i < tw.numVerts; i++ )
+		for( i = 0; i < tw->numVerts; i++ )
 		{
 			// rotate trm around the start position
-			tw.vertices[i].p *= trmAxis;
+			tw->vertices[i].p *= trmAxis;
 		}
 	}
-	for( i = 0; i < tw.numVerts; i++ )
+	for( i = 0; i < tw->numVerts; i++ )
 	{
 		// set trm at start position
-		tw.vertices[i].p += tw.start;
+		tw->vertices[i].p += tw->start;
 	}
 	if( model_rotated )
 	{
-		for( i = 0; i < tw.numVerts; i++ )
+		for( i = 0; i < tw->numVerts; i++ )
 		{
-			tw.vertices[i].p *= invModelAxis;
+			tw->vertices[i].p *= invModelAxis;
 		}
 	}
-	for( i = 0; i < tw.numVerts; i++ )
+	for( i = 0; i < tw->numVerts; i++ )
 	{
-		tw.vertices[i].endp = tw.vertices[i].p;
+		tw->vertices[i].endp = tw->vertices[i].p;
 	}
 	// if we start at a specific angle
 	if( startAngle != 0.0f )
 	{
-		for( i = 0; i < tw.numVerts; i++ )
+		for( i = 0; i < tw->numVerts; i++ )
 		{
-			startRotation.RotatePoint( tw.vertices[i].p );
+			startRotation.RotatePoint( tw->vertices[i].p );
 		}
 	}
-	for( i = 0; i < tw.numVerts; i++ )
+	for( i = 0; i < tw->numVerts; i++ )
 	{
 		// end position of vertex
-		endRotation.RotatePoint( tw.vertices[i].endp );
+		endRotation.RotatePoint( tw->vertices[i].endp );
 	}
 	
 	// add offset to start point
 	if( trm_rotated )
 	{
-		tw.start += trm->offset * trmAxis;
+		tw->start += trm->offset * trmAxis;
 	}
 	else
 	{
-		tw.start += trm->offset;
+		tw->start += trm->offset;
 	}
 	// if the model is rotated
 	if( model_rotated )
 	{
 		// rotate trace instead of model
-		tw.start *= invModelAxis;
+		tw->start *= invModelAxis;
 	}
-	tw.end = tw.start;
+	tw->end = tw->start;
 	// if we start at a specific angle
 	if( startAngle != 0.0f )
 	{
-		startRotation.RotatePoint( tw.start );
+		startRotation.RotatePoint( tw->start );
 	}
 	// calculate end position of rotation
-	endRotation.RotatePoint( tw.end );
+	endRotation.RotatePoint( tw->end );
 	
 	// setup trm vertices
-	for( vert = tw.vertices, i = 0; i < tw.numVerts; i++, vert++ )
+	for( vert = tw->vertices, i = 0; i < tw->numVerts; i++, vert++ )
 	{
 		// calculate rotation origin projected into rotation plane through the vertex
-		vert->rotationOrigin = tw.origin + tw.axis * ( tw.axis * ( vert->p - tw.origin ) );
+		vert->rotationOrigin = tw->origin + tw->axis * ( tw->axis * ( vert->p - tw->origin ) );
 		// calculate rotation bounds for this vertex
-		BoundsForRotation( vert->rotationOrigin, tw.axis, vert->p, vert->endp, vert->rotationBounds );
+		BoundsForRotation( vert->rotationOrigin, tw->axis, vert->p, vert->endp, vert->rotationBounds );
 		// if the rotation axis goes through the vertex then the vertex is not used
 		d = ( vert->p - vert->rotationOrigin ).LengthSqr();
 		if( d > ROTATION_AXIS_EPSILON * ROTATION_AXIS_EPSILON )
@@ -1662,102 +1659,102 @@ void idCollisionModelManagerLocal::Rotation180( trace_t* results, const idVec3&
 	}
 	
 	// setup trm edges
-	for( edge = tw.edges + 1, i = 1; i <= tw.numEdges; i++, edge++ )
+	for( edge = tw->edges + 1, i = 1; i <= tw->numEdges; i++, edge++ )
 	{
 		// if the rotation axis goes through both the edge vertices then the edge is not used
-		if( tw.vertices[edge->vertexNum[0]].used | tw.vertices[edge->vertexNum[1]].used )
+		if( tw->vertices[edge->vertexNum[0]].used | tw->vertices[edge->vertexNum[1]].used )
 		{
 			edge->used = true;
 		}
 		// edge start, end and pluecker coordinate
-		edge->start = tw.vertices[edge->vertexNum[0]].p;
-		edge->end = tw.vertices[edge->vertexNum[1]].p;
+		edge->start = tw->vertices[edge->vertexNum[0]].p;
+		edge->end = tw->vertices[edge->vertexNum[1]].p;
 		edge->pl.FromLine( edge->start, edge->end );
 		// pluecker coordinate for edge being rotated about the z-axis
-		at = ( edge->start - tw.origin ) * tw.matrix;
-		bt = ( edge->end - tw.origin ) * tw.matrix;
+		at = ( edge->start - tw->origin ) * tw->matrix;
+		bt = ( edge->end - tw->origin ) * tw->matrix;
 		edge->plzaxis.FromLine( at, bt );
 		// get edge rotation bounds from the rotation bounds of both vertices
-		edge->rotationBounds = tw.vertices[edge->vertexNum[0]].rotationBounds;
-		edge->rotationBounds.AddBounds( tw.vertices[edge->vertexNum[1]].rotationBounds );
+		edge->rotationBounds = tw->vertices[edge->vertexNum[0]].rotationBounds;
+		edge->rotationBounds.AddBounds( tw->vertices[edge->vertexNum[1]].rotationBounds );
 		// used to calculate if the rotation axis intersects the trm
 		edge->bitNum = 0;
 	}
 	
-	tw.bounds.Clear();
+	tw->bounds.Clear();
 	
 	// rotate trm polygon planes
 	if( trm_rotated & model_rotated )
 	{
 		tmpAxis = trmAxis * invModelAxis;
-		for( poly = tw.polys, i = 0; i < tw.numPolys; i++, poly++ )
+		for( poly = tw->polys, i = 0; i < tw->numPolys; i++, poly++ )
 		{
 			poly->plane *= tmpAxis;
 		}
 	}
 	else if( trm_rotated )
 	{
-		for( poly = tw.polys, i = 0; i < tw.numPolys; i++, poly++ )
+		for( poly = tw->polys, i = 0; i < tw->numPolys; i++, poly++ )
 		{
 			poly->plane *= trmAxis;
 		}
 	}
 	else if( model_rotated )
 	{
-		for( poly = tw.polys, i = 0; i < tw.numPolys; i++, poly++ )
+		for( poly = tw->polys, i = 0; i < tw->numPolys; i++, poly++ )
 		{
 			poly->plane *= invModelAxis;
 		}
 	}
 	
 	// setup trm polygons
-	for( poly = tw.polys, i = 0; i < tw.numPolys; i++, poly++ )
+	for( poly = tw->polys, i = 0; i < tw->numPolys; i++, poly++ )
 	{
 		poly->used = true;
 		// set trm polygon plane distance
-		poly->plane.FitThroughPoint( tw.edges[abs( poly->edges[0] )].start );
+		poly->plane.FitThroughPoint( tw->edges[abs( poly->edges[0] )].start );
 		// get polygon bounds from edge bounds
 		poly->rotationBounds.Clear();
 		for( j = 0; j < poly->numEdges; j++ )
 		{
 			// add edge rotation bounds to polygon rotation bounds
-			edge = &tw.edges[abs( poly->edges[j] )];
+			edge = &tw->edges[abs( poly->edges[j] )];
 			poly->rotationBounds.AddBounds( edge->rotationBounds );
 		}
 		// get trace bounds from polygon bounds
-		tw.bounds.AddBounds( poly->rotationBounds );
+		tw->bounds.AddBounds( poly->rotationBounds );
 	}
 	
 	// extents including the maximum error of the circle approximation traced through the axial BSP tree
 	for( i = 0; i < 3; i++ )
 	{
-		tw.size[0][i] = tw.bounds[0][i] - tw.start[i];
-		tw.size[1][i] = tw.bounds[1][i] - tw.start[i];
-		if( idMath::Fabs( tw.size[0][i] ) > idMath::Fabs( tw.size[1][i] ) )
+		tw->size[0][i] = tw->bounds[0][i] - tw->start[i];
+		tw->size[1][i] = tw->bounds[1][i] - tw->start[i];
+		if( idMath::Fabs( tw->size[0][i] ) > idMath::Fabs( tw->size[1][i] ) )
 		{
-			tw.extents[i] = idMath::Fabs( tw.size[0][i] ) + maxErr + CM_BOX_EPSILON;
+			tw->extents[i] = idMath::Fabs( tw->size[0][i] ) + maxErr + CM_BOX_EPSILON;
 		}
 		else
 		{
-			tw.extents[i] = idMath::Fabs( tw.size[1][i] ) + maxErr + CM_BOX_EPSILON;
+			tw->extents[i] = idMath::Fabs( tw->size[1][i] ) + maxErr + CM_BOX_EPSILON;
 		}
 	}
 	
 	// for back-face culling
-	if( tw.isConvex )
+	if( tw->isConvex )
 	{
-		if( tw.start == tw.origin )
+		if( tw->start == tw->origin )
 		{
-			tw.axisIntersectsTrm = true;
+			tw->axisIntersectsTrm = true;
 		}
 		else
 		{
 			// determine if the rotation axis intersects the trm
-			plaxis.FromRay( tw.origin, tw.axis );
-			for( poly = tw.polys, i = 0; i < tw.numPolys; i++, poly++ )
+			plaxis.FromRay( tw->origin, tw->axis );
+			for( poly = tw->polys, i = 0; i < tw->numPolys; i++, poly++ )
 			{
 				// back face cull polygons
-				if( poly->plane.Normal() * tw.axis > 0.0f )
+				if( poly->plane.Normal() * tw->axis > 0.0f )
 				{
 					continue;
 				}
@@ -1765,7 +1762,7 @@ void idCollisionModelManagerLocal::Rotation180( trace_t* results, const idVec3&
 				for( j = 0; j < poly->numEdges; j++ )
 				{
 					edgeNum = poly->edges[j];
-					edge = tw.edges + abs( edgeNum );
+					edge = tw->edges + abs( edgeNum );
 					if( ( edge->bitNum & 2 ) == 0 )
 					{
 						d = plaxis.PermutedInnerProduct( edge->pl );
@@ -1778,7 +1775,7 @@ void idCollisionModelManagerLocal::Rotation180( trace_t* results, const idVec3&
 				}
 				if( j >= poly->numEdges )
 				{
-					tw.axisIntersectsTrm = true;
+					tw->axisIntersectsTrm = true;
 					break;
 				}
 			}
@@ -1786,35 +1783,35 @@ void idCollisionModelManagerLocal::Rotation180( trace_t* results, const idVec3&
 	}
 	
 	// setup rotation heart plane
-	tw.heartPlane1.SetNormal( tw.axis );
-	tw.heartPlane1.FitThroughPoint( tw.start );
-	tw.maxDistFromHeartPlane1 = 0.0f;
-	for( i = 0; i < tw.numVerts; i++ )
+	tw->heartPlane1.SetNormal( tw->axis );
+	tw->heartPlane1.FitThroughPoint( tw->start );
+	tw->maxDistFromHeartPlane1 = 0.0f;
+	for( i = 0; i < tw->numVerts; i++ )
 	{
-		d = idMath::Fabs( tw.heartPlane1.Distance( tw.vertices[i].p ) );
-		if( d > tw.maxDistFromHeartPlane1 )
+		d = idMath::Fabs( tw->heartPlane1.Distance( tw->vertices[i].p ) );
+		if( d > tw->maxDistFromHeartPlane1 )
 		{
-			tw.maxDistFromHeartPlane1 = d;
+			tw->maxDistFromHeartPlane1 = d;
 		}
 	}
-	tw.maxDistFromHeartPlane1 += CM_BOX_EPSILON;
+	tw->maxDistFromHeartPlane1 += CM_BOX_EPSILON;
 	
 	// inverse rotation to rotate model vertices towards trace model
-	tw.modelVertexRotation.Set( tw.origin, tw.axis, -tw.angle );
+	tw->modelVertexRotation.Set( tw->origin, tw->axis, -tw->angle );
 	
 	// trace through the model
-	idCollisionModelManagerLocal::TraceThroughModel( &tw );
+	idCollisionModelManagerLocal::TraceThroughModel( tw );
 	
 	// store results
-	*results = tw.trace;
+	*results = tw->trace;
 	results->endpos = start;
-	if( tw.maxTan == initialTan )
+	if( tw->maxTan == initialTan )
 	{
 		results->fraction = 1.0f;
 	}
 	else
 	{
-		results->fraction = idMath::Fabs( atan( tw.maxTan ) * ( 2.0f * 180.0f / idMath::PI ) / tw.angle );
+		results->fraction = idMath::Fabs( atan( tw->maxTan ) * ( 2.0f * 180.0f / idMath::PI ) / tw->angle );
 	}
 	assert( results->fraction <= 1.0f );
 	endRotation.Set( rorg, axis, startAngle + ( endAngle - startAngle ) * results->fraction );
@@ -1849,12 +1846,15 @@ void idCollisionModelManagerLocal::Rotation( trace_t* results, const idVec3& sta
 {
 	idVec3 tmp;
 	float maxa, stepa, a, lasta;
+	ALIGN16( cm_traceWork_t tw );
 	
 	assert( ( ( byte* )&start ) < ( ( byte* )results ) || ( ( byte* )&start ) > ( ( ( byte* )results ) + sizeof( trace_t ) ) );
 	assert( ( ( byte* )&trmAxis ) < ( ( byte* )results ) || ( ( byte* )&trmAxis ) > ( ( ( byte* )results ) + sizeof( trace_t ) ) );
 	
 	memset( results, 0, sizeof( *results ) );
 	
+	tw.getContacts = false;
+	
 	// if special position test
 	if( rotation.GetAngle() == 0.0f )
 	{
@@ -1900,7 +1900,7 @@ void idCollisionModelManagerLocal::Rotation( trace_t* results, const idVec3& sta
 		for( lasta = 0.0f, a = stepa; fabs( a ) < fabs( maxa ) + 1.0f; lasta = a, a += stepa )
 		{
 			// partial rotation
-			idCollisionModelManagerLocal::Rotation180( results, rotation.GetOrigin(), rotation.GetVec(), lasta, a, start, trm, trmAxis, contentMask, model, modelOrigin, modelAxis );
+			idCollisionModelManagerLocal::Rotation180( &tw, results, rotation.GetOrigin(), rotation.GetVec(), lasta, a, start, trm, trmAxis, contentMask, model, modelOrigin, modelAxis );
 			// if there is a collision
 			if( results->fraction < 1.0f )
 			{
@@ -1913,7 +1913,7 @@ void idCollisionModelManagerLocal::Rotation( trace_t* results, const idVec3& sta
 		return;
 	}
 	
-	idCollisionModelManagerLocal::Rotation180( results, rotation.GetOrigin(), rotation.GetVec(), 0.0f, rotation.GetAngle(), start, trm, trmAxis, contentMask, model, modelOrigin, modelAxis );
+	idCollisionModelManagerLocal::Rotation180( &tw, results, rotation.GetOrigin(), rotation.GetVec(), 0.0f, rotation.GetAngle(), start, trm, trmAxis, contentMask, model, modelOrigin, modelAxis );
 	
 #ifdef _DEBUG
 	// test for missed collisions
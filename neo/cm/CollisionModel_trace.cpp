@@ -43,6 +43,58 @@ If you have questions concerning this license or the applicable additional terms
 /*
 ===============================================================================
 
+Trace slots
+
+Every trace claims one of the trace slots while it walks the model. The
+visit stamps and sidedness caches on the model features are kept per slot
+so traces from different threads never share scratch state. The stamps
+themselves are unique over all slots which makes it unnecessary to clear
+a slot before it is reused.
+
+===============================================================================
+*/
+
+/*
+================
+idCollisionModelManagerLocal::BeginTrace
+
+There is a slot for every thread that can trace at the same time, the game thread,
+the job threads and one spare. A trace never starts another trace so running out
+of slots means more threads trace than accounted for.
+================
+*/
+void idCollisionModelManagerLocal::BeginTrace( cm_traceWork_t* tw )
+{
+	int i;
+	
+	for( i = 0; i < CM_MAX_TRACE_SLOTS; i++ )
+	{
+		if( traceSlotInUse[i] == 0 && Sys_InterlockedCompareExchange( traceSlotInUse[i], 0, 1 ) == 0 )
+		{
+			tw->slot = i;
+			tw->checkCount = traceCheckCount.Increment();
+			return;
+		}
+	}
+	
+	assert( false );
+	common->FatalError( "idCollisionModelManagerLocal::BeginTrace: more than %d concurrent traces", CM_MAX_TRACE_SLOTS );
+}
+
+/*
+================
+idCollisionModelManagerLocal::EndTrace
+================
+*/
+void idCollisionModelManagerLocal::EndTrace( cm_traceWork_t* tw )
+{
+	assert( traceSlotInUse[tw->slot] != 0 );
+	Sys_InterlockedExchange( traceSlotInUse[tw->slot], 0 );
+}
+
+/*
+===============================================================================
+
 Trace through the spatial subdivision
 
 ===============================================================================
@@ -243,10 +295,10 @@ void idCollisionModelManagerLocal::TraceThroughAxialBSPTree_r( cm_traceWork_t* t
 
 /*
 ================
-idCollisionModelManagerLocal::TraceThroughModel
+idCollisionModelManagerLocal::TraceThroughBSP
 ================
 */
-void idCollisionModelManagerLocal::TraceThroughModel( cm_traceWork_t* tw )
+void idCollisionModelManagerLocal::TraceThroughBSP( cm_traceWork_t* tw )
 {
 	float d;
 	int i, numSteps;
@@ -294,3 +346,45 @@ void idCollisionModelManagerLocal::TraceThroughModel( cm_traceWork_t* tw )
 		idCollisionModelManagerLocal::TraceThroughAxialBSPTree_r( tw, tw->model->node, 0, 1, start, tw->end );
 	}
 }
+
+/*
+================
+idCollisionModelManagerLocal::TraceThroughModel
+================
+*/
+void idCollisionModelManagerLocal::TraceThroughModel( cm_traceWork_t* tw )
+{
+	cm_traceWork_t* bspTw = NULL;
+	
+	idCollisionModelManagerLocal::BeginTrace( tw );
+	
+	if( tw->model->bvhNodes == NULL )
+	{
+		idCollisionModelManagerLocal::TraceThroughBSP( tw );
+		idCollisionModelManagerLocal::EndTrace( tw );
+		return;
+	}
+	
+	// keep a copy of the trace work to compare against the BSP tree
+	if( cm_testBVH.GetBool() && !tw->getContacts )
+	{
+		bspTw = ( cm_traceWork_t* ) Mem_Alloc( sizeof( cm_traceWork_t ), TAG_COLLISION );
+		memcpy( bspTw, tw, sizeof( cm_traceWork_t ) );
+	}
+	
+	idCollisionModelManagerLocal::TraceThroughBVH( tw );
+	
+	if( bspTw != NULL )
+	{
+		// the copy needs its own stamp to test the features again
+		bspTw->checkCount = traceCheckCount.Increment();
+		idCollisionModelManagerLocal::TraceThroughBSP( bspTw );
+		if( bspTw->trace.fraction != tw->trace.fraction )
+		{
+			common->Printf( "cm_testBVH: model %s: BVH fraction %f, BSP fraction %f\n", tw->model->name.c_str(), tw->trace.fraction, bspTw->trace.fraction );
+		}
+		Mem_Free( bspTw );
+	}
+	
+	idCollisionModelManagerLocal::EndTrace( tw );
+}
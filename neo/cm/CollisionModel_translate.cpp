@@ -206,14 +206,15 @@ CM_SetVertexSidedness
   stores for the given model vertex at which side of one of the trm edges it passes
 ================
 */
-ID_INLINE void CM_SetVertexSidedness( cm_vertex_t* v, const idPluecker& vpl, const idPluecker& epl, const int bitNum )
+ID_INLINE void CM_SetVertexSidedness( cm_vertex_t* v, const idPluecker& vpl, const idPluecker& epl, const int bitNum, const int slot )
 {
 	const int mask = 1 << bitNum;
-	if( ( v->sideSet & mask ) == 0 )
+	cm_traceStamp_t* stamp = &v->traceStamps[slot];
+	if( ( stamp->sideSet & mask ) == 0 )
 	{
 		const float fl = vpl.PermutedInnerProduct( epl );
-		v->side = ( v->side & ~mask ) | ( ( fl < 0.0f ) ? mask : 0 );
-		v->sideSet |= mask;
+		stamp->side = ( stamp->side & ~mask ) | ( ( fl < 0.0f ) ? mask : 0 );
+		stamp->sideSet |= mask;
 	}
 }
 
@@ -224,14 +225,15 @@ CM_SetEdgeSidedness
   stores for the given model edge at which side one of the trm vertices
 ================
 */
-ID_INLINE void CM_SetEdgeSidedness( cm_edge_t* edge, const idPluecker& vpl, const idPluecker& epl, const int bitNum )
+ID_INLINE void CM_SetEdgeSidedness( cm_edge_t* edge, const idPluecker& vpl, const idPluecker& epl, const int bitNum, const int slot )
 {
 	const int mask = 1 << bitNum;
-	if( ( edge->sideSet & mask ) == 0 )
+	cm_traceStamp_t* stamp = &edge->traceStamps[slot];
+	if( ( stamp->sideSet & mask ) == 0 )
 	{
 		const float fl = vpl.PermutedInnerProduct( epl );
-		edge->side = ( edge->side & ~mask ) | ( ( fl < 0.0f ) ? mask : 0 );
-		edge->sideSet |= mask;
+		stamp->side = ( stamp->side & ~mask ) | ( ( fl < 0.0f ) ? mask : 0 );
+		stamp->sideSet |= mask;
 	}
 }
 
@@ -255,7 +257,7 @@ void idCollisionModelManagerLocal::TranslateTrmEdgeThroughPolygon( cm_traceWork_
 		edgeNum = poly->edges[i];
 		edge = tw->model->edges + abs( edgeNum );
 		// if this edge is already checked
-		if( edge->checkcount == idCollisionModelManagerLocal::checkCount )
+		if( edge->traceStamps[tw->slot].checkcount == tw->checkCount )
 		{
 			continue;
 		}
@@ -266,20 +268,20 @@ void idCollisionModelManagerLocal::TranslateTrmEdgeThroughPolygon( cm_traceWork_
 		}
 		pl = &tw->polygonEdgePlueckerCache[i];
 		// get the sides at which the trm edge vertices pass the polygon edge
-		CM_SetEdgeSidedness( edge, *pl, tw->vertices[trmEdge->vertexNum[0]].pl, trmEdge->vertexNum[0] );
-		CM_SetEdgeSidedness( edge, *pl, tw->vertices[trmEdge->vertexNum[1]].pl, trmEdge->vertexNum[1] );
+		CM_SetEdgeSidedness( edge, *pl, tw->vertices[trmEdge->vertexNum[0]].pl, trmEdge->vertexNum[0], tw->slot );
+		CM_SetEdgeSidedness( edge, *pl, tw->vertices[trmEdge->vertexNum[1]].pl, trmEdge->vertexNum[1], tw->slot );
 		// if the trm edge start and end vertex do not pass the polygon edge at different sides
-		if( !( ( ( edge->side >> trmEdge->vertexNum[0] ) ^ ( edge->side >> trmEdge->vertexNum[1] ) ) & 1 ) )
+		if( !( ( ( edge->traceStamps[tw->slot].side >> trmEdge->vertexNum[0] ) ^ ( edge->traceStamps[tw->slot].side >> trmEdge->vertexNum[1] ) ) & 1 ) )
 		{
 			continue;
 		}
 		// get the sides at which the polygon edge vertices pass the trm edge
 		v1 = tw->model->vertices + edge->vertexNum[INT32_SIGNBITSET( edgeNum )];
-		CM_SetVertexSidedness( v1, tw->polygonVertexPlueckerCache[i], trmEdge->pl, trmEdge->bitNum );
+		CM_SetVertexSidedness( v1, tw->polygonVertexPlueckerCache[i], trmEdge->pl, trmEdge->bitNum, tw->slot );
 		v2 = tw->model->vertices + edge->vertexNum[INT32_SIGNBITNOTSET( edgeNum )];
-		CM_SetVertexSidedness( v2, tw->polygonVertexPlueckerCache[i + 1], trmEdge->pl, trmEdge->bitNum );
+		CM_SetVertexSidedness( v2, tw->polygonVertexPlueckerCache[i + 1], trmEdge->pl, trmEdge->bitNum, tw->slot );
 		// if the polygon edge start and end vertex do not pass the trm edge at different sides
-		if( !( ( v1->side ^ v2->side ) & ( 1 << trmEdge->bitNum ) ) )
+		if( !( ( v1->traceStamps[tw->slot].side ^ v2->traceStamps[tw->slot].side ) & ( 1 << trmEdge->bitNum ) ) )
 		{
 			continue;
 		}
@@ -400,8 +402,8 @@ void idCollisionModelManagerLocal::TranslateTrmVertexThroughPolygon( cm_traceWor
 		{
 			edgeNum = poly->edges[i];
 			edge = tw->model->edges + abs( edgeNum );
-			CM_SetEdgeSidedness( edge, tw->polygonEdgePlueckerCache[i], v->pl, bitNum );
-			if( INT32_SIGNBITSET( edgeNum ) ^ ( ( edge->side >> bitNum ) & 1 ) )
+			CM_SetEdgeSidedness( edge, tw->polygonEdgePlueckerCache[i], v->pl, bitNum, tw->slot );
+			if( INT32_SIGNBITSET( edgeNum ) ^ ( ( edge->traceStamps[tw->slot].side >> bitNum ) & 1 ) )
 			{
 				return;
 			}
@@ -451,17 +453,17 @@ void idCollisionModelManagerLocal::TranslatePointThroughPolygon( cm_traceWork_t*
 			edgeNum = poly->edges[i];
 			edge = tw->model->edges + abs( edgeNum );
 			// if we didn't yet calculate the sidedness for this edge
-			if( edge->checkcount != idCollisionModelManagerLocal::checkCount )
+			if( edge->traceStamps[tw->slot].checkcount != tw->checkCount )
 			{
 				float fl;
-				edge->checkcount = idCollisionModelManagerLocal::checkCount;
+				edge->traceStamps[tw->slot].checkcount = tw->checkCount;
 				pl.FromLine( tw->model->vertices[edge->vertexNum[0]].p, tw->model->vertices[edge->vertexNum[1]].p );
 				fl = v->pl.PermutedInnerProduct( pl );
-				edge->side = ( fl < 0.0f );
+				edge->traceStamps[tw->slot].side = ( fl < 0.0f );
 			}
 			// if the point passes the edge at the wrong side
-			//if ( (edgeNum > 0) == edge->side ) {
-			if( INT32_SIGNBITSET( edgeNum ) ^ edge->side )
+			//if ( (edgeNum > 0) == edge->traceStamps[tw->slot].side ) {
+			if( INT32_SIGNBITSET( edgeNum ) ^ edge->traceStamps[tw->slot].side )
 			{
 				return;
 			}
@@ -510,8 +512,8 @@ void idCollisionModelManagerLocal::TranslateVertexThroughTrmPolygon( cm_traceWor
 			edgeNum = trmpoly->edges[i];
 			edge = tw->edges + abs( edgeNum );
 			
-			CM_SetVertexSidedness( v, pl, edge->pl, edge->bitNum );
-			if( INT32_SIGNBITSET( edgeNum ) ^ ( ( v->side >> edge->bitNum ) & 1 ) )
+			CM_SetVertexSidedness( v, pl, edge->pl, edge->bitNum, tw->slot );
+			if( INT32_SIGNBITSET( edgeNum ) ^ ( ( v->traceStamps[tw->slot].side >> edge->bitNum ) & 1 ) )
 			{
 				return;
 			}
@@ -558,11 +560,11 @@ bool idCollisionModelManagerLocal::TranslateTrmThroughPolygon( cm_traceWork_t* t
 	cm_edge_t* e;
 	
 	// if already checked this polygon
-	if( p->checkcount == idCollisionModelManagerLocal::checkCount )
+	if( p->traceCheckcount[tw->slot] == tw->checkCount )
 	{
 		return false;
 	}
-	p->checkcount = idCollisionModelManagerLocal::checkCount;
+	p->traceCheckcount[tw->slot] = tw->checkCount;
 	
 	// if this polygon does not have the right contents behind it
 	if( !( p->contents & tw->contents ) )
@@ -626,9 +628,9 @@ bool idCollisionModelManagerLocal::TranslateTrmThroughPolygon( cm_traceWork_t* t
 			edgeNum = p->edges[i];
 			e = tw->model->edges + abs( edgeNum );
 			// reset sidedness cache if this is the first time we encounter this edge during this trace
-			if( e->checkcount != idCollisionModelManagerLocal::checkCount )
+			if( e->traceStamps[tw->slot].checkcount != tw->checkCount )
 			{
-				e->sideSet = 0;
+				e->traceStamps[tw->slot].sideSet = 0;
 			}
 			// pluecker coordinate for edge
 			tw->polygonEdgePlueckerCache[i].FromLine( tw->model->vertices[e->vertexNum[0]].p,
@@ -636,9 +638,9 @@ bool idCollisionModelManagerLocal::TranslateTrmThroughPolygon( cm_traceWork_t* t
 					
 			v = &tw->model->vertices[e->vertexNum[INT32_SIGNBITSET( edgeNum )]];
 			// reset sidedness cache if this is the first time we encounter this vertex during this trace
-			if( v->checkcount != idCollisionModelManagerLocal::checkCount )
+			if( v->traceStamps[tw->slot].checkcount != tw->checkCount )
 			{
-				v->sideSet = 0;
+				v->traceStamps[tw->slot].sideSet = 0;
 			}
 			// pluecker coordinate for vertex movement vector
 			tw->polygonVertexPlueckerCache[i].FromRay( v->p, -tw->dir );
@@ -672,12 +674,12 @@ bool idCollisionModelManagerLocal::TranslateTrmThroughPolygon( cm_traceWork_t* t
 			edgeNum = p->edges[i];
 			e = tw->model->edges + abs( edgeNum );
 			
-			if( e->checkcount == idCollisionModelManagerLocal::checkCount )
+			if( e->traceStamps[tw->slot].checkcount == tw->checkCount )
 			{
 				continue;
 			}
 			// set edge check count
-			e->checkcount = idCollisionModelManagerLocal::checkCount;
+			e->traceStamps[tw->slot].checkcount = tw->checkCount;
 			// can never collide with internal edges
 			if( e->internal )
 			{
@@ -689,12 +691,12 @@ bool idCollisionModelManagerLocal::TranslateTrmThroughPolygon( cm_traceWork_t* t
 			
 				v = tw->model->vertices + e->vertexNum[k ^ INT32_SIGNBITSET( edgeNum )];
 				// if this vertex is already checked
-				if( v->checkcount == idCollisionModelManagerLocal::checkCount )
+				if( v->traceStamps[tw->slot].checkcount == tw->checkCount )
 				{
 					continue;
 				}
 				// set vertex check count
-				v->checkcount = idCollisionModelManagerLocal::checkCount;
+				v->traceStamps[tw->slot].checkcount = tw->checkCount;
 				
 				// if the vertex is outside the trace bounds
 				if( !tw->bounds.ContainsPoint( v->p ) )
@@ -815,6 +817,25 @@ void idCollisionModelManagerLocal::Translation( trace_t* results, const idVec3&
 		const idTraceModel* trm, const idMat3& trmAxis, int contentMask,
 		cmHandle_t model, const idVec3& modelOrigin, const idMat3& modelAxis )
 {
+	ALIGN16( cm_traceWork_t tw );
+	
+	tw.getContacts = false;
+	tw.contacts = NULL;
+	tw.maxContacts = 0;
+	idCollisionModelManagerLocal::Translation( &tw, results, start, end, trm, trmAxis, contentMask, model, modelOrigin, modelAxis );
+}
+
+/*
+================
+idCollisionModelManagerLocal::Translation
+
+  the trace work is owned by the caller so multiple threads can trace at the same time
+================
+*/
+void idCollisionModelManagerLocal::Translation( cm_traceWork_t* tw, trace_t* results, const idVec3& start, const idVec3& end,
+		const idTraceModel* trm, const idMat3& trmAxis, int contentMask,
+		cmHandle_t model, const idVec3& modelOrigin, const idMat3& modelAxis )
+{
 
 	int i, j;
 	float dist;
@@ -824,7 +845,6 @@ void idCollisionModelManagerLocal::Translation( trace_t* results, const idVec3&
 	cm_trmPolygon_t* poly;
 	cm_trmEdge_t* edge;
 	cm_trmVertex_t* vert;
-	ALIGN16( static cm_traceWork_t tw );
 	
 	assert( ( ( byte* )&start ) < ( ( byte* )results ) || ( ( byte* )&start ) >= ( ( ( byte* )results ) + sizeof( trace_t ) ) );
 	assert( ( ( byte* )&end ) < ( ( byte* )results ) || ( ( byte* )&end ) >= ( ( ( byte* )results ) + sizeof( trace_t ) ) );
@@ -837,7 +857,7 @@ void idCollisionModelManagerLocal::Translation( trace_t* results, const idVec3&
 		common->Printf( "idCollisionModelManagerLocal::Translation: invalid model handle\n" );
 		return;
 	}
-	if( !idCollisionModelManagerLocal::models[model] )
+	if( !idCollisionModelManagerLocal::GetModel( model ) )
 	{
 		common->Printf( "idCollisionModelManagerLocal::Translation: invalid model\n" );
 		return;
@@ -855,7 +875,7 @@ void idCollisionModelManagerLocal::Translation( trace_t* results, const idVec3&
 	// test whether or not stuck to begin with
 	if( cm_debugCollision.GetBool() )
 	{
-		if( !entered && !idCollisionModelManagerLocal::getContacts )
+		if( !entered && !tw->getContacts )
 		{
 			entered = 1;
 			// if already messed up to begin with
@@ -868,24 +888,19 @@ void idCollisionModelManagerLocal::Translation( trace_t* results, const idVec3&
 	}
 #endif
 	
-	idCollisionModelManagerLocal::checkCount++;
-	
-	tw.trace.fraction = 1.0f;
-	tw.trace.c.contents = 0;
-	tw.trace.c.type = CONTACT_NONE;
-	tw.contents = contentMask;
-	tw.isConvex = true;
-	tw.rotation = false;
-	tw.positionTest = false;
-	tw.quickExit = false;
-	tw.getContacts = idCollisionModelManagerLocal::getContacts;
-	tw.contacts = idCollisionModelManagerLocal::contacts;
-	tw.maxContacts = idCollisionModelManagerLocal::maxContacts;
-	tw.numContacts = 0;
-	tw.model = idCollisionModelManagerLocal::models[model];
-	tw.start = start - modelOrigin;
-	tw.end = end - modelOrigin;
-	tw.dir = end - start;
+	tw->trace.fraction = 1.0f;
+	tw->trace.c.contents = 0;
+	tw->trace.c.type = CONTACT_NONE;
+	tw->contents = contentMask;
+	tw->isConvex = true;
+	tw->rotation = false;
+	tw->positionTest = false;
+	tw->quickExit = false;
+	tw->numContacts = 0;
+	tw->model = idCollisionModelManagerLocal::GetModel( model );
+	tw->start = start - modelOrigin;
+	tw->end = end - modelOrigin;
+	tw->dir = end - start;
 	
 	model_rotated = modelAxis.IsRotated();
 	if( model_rotated )
@@ -902,43 +917,43 @@ void idCollisionModelManagerLocal::Translation( trace_t* results, const idVec3&
 		if( model_rotated )
 		{
 			// rotate trace instead of model
-			tw.start *= invModelAxis;
-			tw.end *= invModelAxis;
-			tw.dir *= invModelAxis;
+			tw->start *= invModelAxis;
+			tw->end *= invModelAxis;
+			tw->dir *= invModelAxis;
 		}
 		
 		// trace bounds
 		for( i = 0; i < 3; i++ )
 		{
-			if( tw.start[i] < tw.end[i] )
+			if( tw->start[i] < tw->end[i] )
 			{
-				tw.bounds[0][i] = tw.start[i] - CM_BOX_EPSILON;
-				tw.bounds[1][i] = tw.end[i] + CM_BOX_EPSILON;
+				tw->bounds[0][i] = tw->start[i] - CM_BOX_EPSILON;
+				tw->bounds[1][i] = tw->end[i] + CM_BOX_EPSILON;
 			}
 			else
 			{
-				tw.bounds[0][i] = tw.end[i] - CM_BOX_EPSILON;
-				tw.bounds[1][i] = tw.start[i] + CM_BOX_EPSILON;
+				tw->bounds[0][i] = tw->end[i] - CM_BOX_EPSILON;
+				tw->bounds[1][i] = tw->start[i] + CM_BOX_EPSILON;
 			}
 		}
-		tw.extents[0] = tw.extents[1] = tw.extents[2] = CM_BOX_EPSILON;
-		tw.size.Zero();
+		tw->extents[0] = tw->extents[1] = tw->extents[2] = CM_BOX_EPSILON;
+		tw->size.Zero();
 		
 		// setup trace heart planes
-		idCollisionModelManagerLocal::SetupTranslationHeartPlanes( &tw );
-		tw.maxDistFromHeartPlane1 = CM_BOX_EPSILON;
-		tw.maxDistFromHeartPlane2 = CM_BOX_EPSILON;
+		idCollisionModelManagerLocal::SetupTranslationHeartPlanes( tw );
+		tw->maxDistFromHeartPlane1 = CM_BOX_EPSILON;
+		tw->maxDistFromHeartPlane2 = CM_BOX_EPSILON;
 		// collision with single point
-		tw.numVerts = 1;
-		tw.vertices[0].p = tw.start;
-		tw.vertices[0].endp = tw.vertices[0].p + tw.dir;
-		tw.vertices[0].pl.FromRay( tw.vertices[0].p, tw.dir );
-		tw.numEdges = tw.numPolys = 0;
-		tw.pointTrace = true;
+		tw->numVerts = 1;
+		tw->vertices[0].p = tw->start;
+		tw->vertices[0].endp = tw->vertices[0].p + tw->dir;
+		tw->vertices[0].pl.FromRay( tw->vertices[0].p, tw->dir );
+		tw->numEdges = tw->numPolys = 0;
+		tw->pointTrace = true;
 		// trace through the model
-		idCollisionModelManagerLocal::TraceThroughModel( &tw );
+		idCollisionModelManagerLocal::TraceThroughModel( tw );
 		// store results
-		*results = tw.trace;
+		*results = tw->trace;
 		results->endpos = start + results->fraction * ( end - start );
 		results->endAxis = mat3_identity;
 		
@@ -953,12 +968,11 @@ void idCollisionModelManagerLocal::Translation( trace_t* results, const idVec3&
 			results->c.point += modelOrigin;
 			results->c.dist += modelOrigin * results->c.normal;
 		}
-		idCollisionModelManagerLocal::numContacts = tw.numContacts;
 		return;
 	}
 	
 	// the trace fraction is too inaccurate to describe translations over huge distances
-	if( tw.dir.LengthSqr() > Square( CM_MAX_TRACE_DIST ) )
+	if( tw->dir.LengthSqr() > Square( CM_MAX_TRACE_DIST ) )
 	{
 		results->fraction = 0.0f;
 		results->endpos = start;
@@ -974,34 +988,34 @@ void idCollisionModelManagerLocal::Translation( trace_t* results, const idVec3&
 		return;
 	}
 	
-	tw.pointTrace = false;
-	tw.size.Clear();
+	tw->pointTrace = false;
+	tw->size.Clear();
 	
 	// setup trm structure
-	idCollisionModelManagerLocal::SetupTrm( &tw, trm );
+	idCollisionModelManagerLocal::SetupTrm( tw, trm );
 	
 	trm_rotated = trmAxis.IsRotated();
 	
 	// calculate vertex positions
 	if( trm_rotated )
 	{
-		for( i = 0; i < tw.numVerts; i++ )
+		for( i = 0; i < tw->numVerts; i++ )
 		{
 			// rotate trm around the start position
-			tw.vertices[i].p *= trmAxis;
+			tw->vertices[i].p *= trmAxis;
 		}
 	}
-	for( i = 0; i < tw.numVerts; i++ )
+	for( i = 0; i < tw->numVerts; i++ )
 	{
 		// set trm at start position
-		tw.vertices[i].p += tw.start;
+		tw->vertices[i].p += tw->start;
 	}
 	if( model_rotated )
 	{
-		for( i = 0; i < tw.numVerts; i++ )
+		for( i = 0; i < tw->numVerts; i++ )
 		{
 			// rotate trm around model instead of rotating the model
-			tw.vertices[i].p *= invModelAxis;
+			tw->vertices[i].p *= invModelAxis;
 		}
 	}
 	
@@ -1009,187 +1023,186 @@ void idCollisionModelManagerLocal::Translation( trace_t* results, const idVec3&
 	if( trm_rotated )
 	{
 		dir = trm->offset * trmAxis;
-		tw.start += dir;
-		tw.end += dir;
+		tw->start += dir;
+		tw->end += dir;
 	}
 	else
 	{
-		tw.start += trm->offset;
-		tw.end += trm->offset;
+		tw->start += trm->offset;
+		tw->end += trm->offset;
 	}
 	if( model_rotated )
 	{
 		// rotate trace instead of model
-		tw.start *= invModelAxis;
-		tw.end *= invModelAxis;
-		tw.dir *= invModelAxis;
+		tw->start *= invModelAxis;
+		tw->end *= invModelAxis;
+		tw->dir *= invModelAxis;
 	}
 	
 	// rotate trm polygon planes
 	if( trm_rotated & model_rotated )
 	{
 		tmpAxis = trmAxis * invModelAxis;
-		for( poly = tw.polys, i = 0; i < tw.numPolys; i++, poly++ )
+		for( poly = tw->polys, i = 0; i < tw->numPolys; i++, poly++ )
 		{
 			poly->plane *= tmpAxis;
 		}
 	}
 	else if( trm_rotated )
 	{
-		for( poly = tw.polys, i = 0; i < tw.numPolys; i++, poly++ )
+		for( poly = tw->polys, i = 0; i < tw->numPolys; i++, poly++ )
 		{
 			poly->plane *= trmAxis;
 		}
 	}
 	else if( model_rotated )
 	{
-		for( poly = tw.polys, i = 0; i < tw.numPolys; i++, poly++ )
+		for( poly = tw->polys, i = 0; i < tw->numPolys; i++, poly++ )
 		{
 			poly->plane *= invModelAxis;
 		}
 	}
 	
 	// setup trm polygons
-	for( poly = tw.polys, i = 0; i < tw.numPolys; i++, poly++ )
+	for( poly = tw->polys, i = 0; i < tw->numPolys; i++, poly++ )
 	{
 		// if the trm poly plane is facing in the movement direction
-		dist = poly->plane.Normal() * tw.dir;
+		dist = poly->plane.Normal() * tw->dir;
 		if( dist > 0.0f || ( !trm->isConvex && dist == 0.0f ) )
 		{
 			// this trm poly and it's edges and vertices need to be used for collision
 			poly->used = true;
 			for( j = 0; j < poly->numEdges; j++ )
 			{
-				edge = &tw.edges[abs( poly->edges[j] )];
+				edge = &tw->edges[abs( poly->edges[j] )];
 				edge->used = true;
-				tw.vertices[edge->vertexNum[0]].used = true;
-				tw.vertices[edge->vertexNum[1]].used = true;
+				tw->vertices[edge->vertexNum[0]].used = true;
+				tw->vertices[edge->vertexNum[1]].used = true;
 			}
 		}
 	}
 	
 	// setup trm vertices
-	for( vert = tw.vertices, i = 0; i < tw.numVerts; i++, vert++ )
+	for( vert = tw->vertices, i = 0; i < tw->numVerts; i++, vert++ )
 	{
 		if( !vert->used )
 		{
 			continue;
 		}
 		// get axial trm size after rotations
-		tw.size.AddPoint( vert->p - tw.start );
+		tw->size.AddPoint( vert->p - tw->start );
 		// calculate the end position of each vertex for a full trace
-		vert->endp = vert->p + tw.dir;
+		vert->endp = vert->p + tw->dir;
 		// pluecker coordinate for vertex movement line
-		vert->pl.FromRay( vert->p, tw.dir );
+		vert->pl.FromRay( vert->p, tw->dir );
 	}
 	
 	// setup trm edges
-	for( edge = tw.edges + 1, i = 1; i <= tw.numEdges; i++, edge++ )
+	for( edge = tw->edges + 1, i = 1; i <= tw->numEdges; i++, edge++ )
 	{
 		if( !edge->used )
 		{
 			continue;
 		}
 		// edge start, end and pluecker coordinate
-		edge->start = tw.vertices[edge->vertexNum[0]].p;
-		edge->end = tw.vertices[edge->vertexNum[1]].p;
+		edge->start = tw->vertices[edge->vertexNum[0]].p;
+		edge->end = tw->vertices[edge->vertexNum[1]].p;
 		edge->pl.FromLine( edge->start, edge->end );
 		// calculate normal of plane through movement plane created by the edge
 		dir = edge->start - edge->end;
-		edge->cross[0] = dir[0] * tw.dir[1] - dir[1] * tw.dir[0];
-		edge->cross[1] = dir[0] * tw.dir[2] - dir[2] * tw.dir[0];
-		edge->cross[2] = dir[1] * tw.dir[2] - dir[2] * tw.dir[1];
+		edge->cross[0] = dir[0] * tw->dir[1] - dir[1] * tw->dir[0];
+		edge->cross[1] = dir[0] * tw->dir[2] - dir[2] * tw->dir[0];
+		edge->cross[2] = dir[1] * tw->dir[2] - dir[2] * tw->dir[1];
 		// bit for vertex sidedness bit cache
 		edge->bitNum = i;
 	}
 	
 	// set trm plane distances
-	for( poly = tw.polys, i = 0; i < tw.numPolys; i++, poly++ )
+	for( poly = tw->polys, i = 0; i < tw->numPolys; i++, poly++ )
 	{
 		if( poly->used )
 		{
-			poly->plane.FitThroughPoint( tw.edges[abs( poly->edges[0] )].start );
+			poly->plane.FitThroughPoint( tw->edges[abs( poly->edges[0] )].start );
 		}
 	}
 	
 	// bounds for full trace, a little bit larger for epsilons
 	for( i = 0; i < 3; i++ )
 	{
-		if( tw.start[i] < tw.end[i] )
+		if( tw->start[i] < tw->end[i] )
 		{
-			tw.bounds[0][i] = tw.start[i] + tw.size[0][i] - CM_BOX_EPSILON;
-			tw.bounds[1][i] = tw.end[i] + tw.size[1][i] + CM_BOX_EPSILON;
+			tw->bounds[0][i] = tw->start[i] + tw->size[0][i] - CM_BOX_EPSILON;
+			tw->bounds[1][i] = tw->end[i] + tw->size[1][i] + CM_BOX_EPSILON;
 		}
 		else
 		{
-			tw.bounds[0][i] = tw.end[i] + tw.size[0][i] - CM_BOX_EPSILON;
-			tw.bounds[1][i] = tw.start[i] + tw.size[1][i] + CM_BOX_EPSILON;
+			tw->bounds[0][i] = tw->end[i] + tw->size[0][i] - CM_BOX_EPSILON;
+			tw->bounds[1][i] = tw->start[i] + tw->size[1][i] + CM_BOX_EPSILON;
 		}
-		if( idMath::Fabs( tw.size[0][i] ) > idMath::Fabs( tw.size[1][i] ) )
+		if( idMath::Fabs( tw->size[0][i] ) > idMath::Fabs( tw->size[1][i] ) )
 		{
-			tw.extents[i] = idMath::Fabs( tw.size[0][i] ) + CM_BOX_EPSILON;
+			tw->extents[i] = idMath::Fabs( tw->size[0][i] ) + CM_BOX_EPSILON;
 		}
 		else
 		{
-			tw.extents[i] = idMath::Fabs( tw.size[1][i] ) + CM_BOX_EPSILON;
+			tw->extents[i] = idMath::Fabs( tw->size[1][i] ) + CM_BOX_EPSILON;
 		}
 	}
 	
 	// setup trace heart planes
-	idCollisionModelManagerLocal::SetupTranslationHeartPlanes( &tw );
-	tw.maxDistFromHeartPlane1 = 0;
-	tw.maxDistFromHeartPlane2 = 0;
+	idCollisionModelManagerLocal::SetupTranslationHeartPlanes( tw );
+	tw->maxDistFromHeartPlane1 = 0;
+	tw->maxDistFromHeartPlane2 = 0;
 	// calculate maximum trm vertex distance from both heart planes
-	for( vert = tw.vertices, i = 0; i < tw.numVerts; i++, vert++ )
+	for( vert = tw->vertices, i = 0; i < tw->numVerts; i++, vert++ )
 	{
 		if( !vert->used )
 		{
 			continue;
 		}
-		dist = idMath::Fabs( tw.heartPlane1.Distance( vert->p ) );
-		if( dist > tw.maxDistFromHeartPlane1 )
+		dist = idMath::Fabs( tw->heartPlane1.Distance( vert->p ) );
+		if( dist > tw->maxDistFromHeartPlane1 )
 		{
-			tw.maxDistFromHeartPlane1 = dist;
+			tw->maxDistFromHeartPlane1 = dist;
 		}
-		dist = idMath::Fabs( tw.heartPlane2.Distance( vert->p ) );
-		if( dist > tw.maxDistFromHeartPlane2 )
+		dist = idMath::Fabs( tw->heartPlane2.Distance( vert->p ) );
+		if( dist > tw->maxDistFromHeartPlane2 )
 		{
-			tw.maxDistFromHeartPlane2 = dist;
+			tw->maxDistFromHeartPlane2 = dist;
 		}
 	}
 	// for epsilons
-	tw.maxDistFromHeartPlane1 += CM_BOX_EPSILON;
-	tw.maxDistFromHeartPlane2 += CM_BOX_EPSILON;
+	tw->maxDistFromHeartPlane1 += CM_BOX_EPSILON;
+	tw->maxDistFromHeartPlane2 += CM_BOX_EPSILON;
 	
 	// trace through the model
-	idCollisionModelManagerLocal::TraceThroughModel( &tw );
+	idCollisionModelManagerLocal::TraceThroughModel( tw );
 	
 	// if we're getting contacts
-	if( tw.getContacts )
+	if( tw->getContacts )
 	{
 		// move all contacts to world space
 		if( model_rotated )
 		{
-			for( i = 0; i < tw.numContacts; i++ )
+			for( i = 0; i < tw->numContacts; i++ )
 			{
-				tw.contacts[i].normal *= modelAxis;
-				tw.contacts[i].point *= modelAxis;
+				tw->contacts[i].normal *= modelAxis;
+				tw->contacts[i].point *= modelAxis;
 			}
 		}
 		if( modelOrigin != vec3_origin )
 		{
-			for( i = 0; i < tw.numContacts; i++ )
+			for( i = 0; i < tw->numContacts; i++ )
 			{
-				tw.contacts[i].point += modelOrigin;
-				tw.contacts[i].dist += modelOrigin * tw.contacts[i].normal;
+				tw->contacts[i].point += modelOrigin;
+				tw->contacts[i].dist += modelOrigin * tw->contacts[i].normal;
 			}
 		}
-		idCollisionModelManagerLocal::numContacts = tw.numContacts;
 	}
 	else
 	{
 		// store results
-		*results = tw.trace;
+		*results = tw->trace;
 		results->endpos = start + results->fraction * ( end - start );
 		results->endAxis = trmAxis;
 		
@@ -1215,7 +1228,7 @@ void idCollisionModelManagerLocal::Translation( trace_t* results, const idVec3&
 	// test for missed collisions
 	if( cm_debugCollision.GetBool() )
 	{
-		if( !entered && !idCollisionModelManagerLocal::getContacts )
+		if( !entered && !tw->getContacts )
 		{
 			entered = 1;
 			// if the trm is stuck in the model
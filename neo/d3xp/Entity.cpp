@@ -1066,6 +1066,12 @@ idEntity::BecomeActive
 */
 void idEntity::BecomeActive( int flags )
 {
+	// the active entities are only changed on the game thread when physics islands are done
+	if( gameLocal.physicsIslands.DeferThinkFlags( this, flags, true ) )
+	{
+		return;
+	}
+	
 	if( ( flags & TH_PHYSICS ) )
 	{
 		// enable the team master if this entity is part of a physics team
@@ -1106,6 +1112,11 @@ idEntity::BecomeInactive
 */
 void idEntity::BecomeInactive( int flags )
 {
+	if( gameLocal.physicsIslands.DeferThinkFlags( this, flags, false ) )
+	{
+		return;
+	}
+	
 	if( ( flags & TH_PHYSICS ) )
 	{
 		// may only disable physics on a team master if no team members are running physics or bound to a joints
@@ -2958,8 +2969,11 @@ bool idEntity::RunPhysics()
 	trace_t		results;
 	bool		moved;
 	
+	// physics evaluated on an island this frame may have come to rest since
+	const bool evaluated = gameLocal.physicsIslands.GetEvaluated( this, moved );
+	
 	// don't run physics if not enabled
-	if( !( thinkFlags & TH_PHYSICS ) )
+	if( !( thinkFlags & TH_PHYSICS ) && !evaluated )
 	{
 		// however do update any animation controllers
 		if( UpdateAnimationControllers() )
@@ -3001,8 +3015,11 @@ bool idEntity::RunPhysics()
 		if( part->physics )
 		{
 		
-			// run physics
-			moved = part->physics->Evaluate( GetPhysicsTimeStep(), endTime );
+			// run physics, entities on islands are never part of a team
+			if( !evaluated )
+			{
+				moved = part->physics->Evaluate( GetPhysicsTimeStep(), endTime );
+			}
 			
 			// check if the object is blocked
 			blockingEntity = part->physics->GetBlockingEntity();
@@ -230,6 +230,7 @@ void idGameLocal::Clear()
 	testmodel = NULL;
 	testFx = NULL;
 	clip.Shutdown();
+	physicsIslands.Shutdown();
 	pvs.Shutdown();
 	sessionCommand.Clear();
 	locationEntities = NULL;
@@ -803,6 +804,12 @@ void idGameLocal::Warning( const char* fmt, ... ) const
 	idStr::vsnPrintf( text, sizeof( text ), fmt, argptr );
 	va_end( argptr );
 	
+	// printing is not thread safe, warnings from physics islands are printed when the islands are done
+	if( physicsIslands.DeferWarning( text, false ) )
+	{
+		return;
+	}
+	
 	thread = idThread::CurrentThread();
 	if( thread )
 	{
@@ -834,6 +841,11 @@ void idGameLocal::DWarning( const char* fmt, ... ) const
 	idStr::vsnPrintf( text, sizeof( text ), fmt, argptr );
 	va_end( argptr );
 	
+	if( physicsIslands.DeferWarning( text, true ) )
+	{
+		return;
+	}
+	
 	thread = idThread::CurrentThread();
 	if( thread )
 	{
@@ -1050,6 +1062,7 @@ void idGameLocal::LoadMap( const char* mapName, int randseed )
 	cinematicMaxSkipTime = 0;
 	
 	clip.Init();
+	physicsIslands.Init();
 	
 	common->UpdateLevelLoadPacifier();
 	
@@ -1668,6 +1681,7 @@ void idGameLocal::MapShutdown()
 	common->UpdateLevelLoadPacifier();
 	
 	clip.Shutdown();
+	physicsIslands.Shutdown();
 	idClipModel::ClearTraceModelCache();
 	
 	common->UpdateLevelLoadPacifier();
@@ -2689,6 +2703,7 @@ void idGameLocal::RunFrame( idUserCmdMgr& cmdMgr, gameReturn_t& ret )
 						{
 							continue;
 						}
+						physicsIslands.Run( ent );
 						RunEntityThink( *ent, cmdMgr );
 						num++;
 					}
@@ -2756,6 +2771,12 @@ void idGameLocal::RunFrame( idUserCmdMgr& cmdMgr, gameReturn_t& ret )
 						timer_think.Milliseconds(), timer_events.Milliseconds(), num );
 			}
 			
+			// display the number of active and sleeping rigid bodies
+			if( rb_showCounters.GetBool() )
+			{
+				idPhysics_RigidBody::ShowCounters();
+			}
+			
 			BuildReturnValue( ret );
 			
 			// see if a target_sessionCommand has forced a changelevel
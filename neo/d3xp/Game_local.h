@@ -96,6 +96,7 @@ void gameError( const char* fmt, ... );
 
 #include "physics/Clip.h"
 #include "physics/Push.h"
+#include "physics/PhysicsIslands.h"
 
 #include "Pvs.h"
 #include "Leaderboards.h"
@@ -319,6 +320,7 @@ public:
 	
 	idClip					clip;					// collision detection
 	idPush					push;					// geometric pushing
+	idPhysicsIslands		physicsIslands;			// parallel evaluation of independent rigid bodies and articulated figures
 	idPVS					pvs;					// potential visible set
 	
 	idTestModel* 			testmodel;				// for development testing of models
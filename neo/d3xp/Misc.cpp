@@ -1714,6 +1714,10 @@ void idStaticEntity::Spawn()
 	{
 		BecomeActive( TH_THINK );
 	}
+	
+	// let the renderer merge it with the other static models in the area,
+	// unless it will be moved around by whatever it is bound to
+	renderEntity.allowStaticMerge = !hidden && !runGui && spawnArgs.FindKey( "bind" ) == NULL;
 }
 
 /*
@@ -1661,6 +1661,40 @@ static void Cmd_AASStats_f( const idCmdArgs& args )
 	}
 }
 
+/*
+==================
+Cmd_BenchmarkClipTraces_f
+==================
+*/
+static void Cmd_BenchmarkClipTraces_f( const idCmdArgs& args )
+{
+	int iterations;
+	
+	if( !gameLocal.CheatsOk() )
+	{
+		return;
+	}
+	
+	if( args.Argc() > 2 )
+	{
+		gameLocal.Printf( "usage: clipBenchmarkTraces [iterations]\n" );
+		return;
+	}
+	
+	iterations = ( args.Argc() == 2 ) ? Max( 1, atoi( args.Argv( 1 ) ) ) : 10;
+	gameLocal.clip.BenchmarkRecordedTraces( iterations );
+}
+
+/*
+==================
+Cmd_ClearClipTraces_f
+==================
+*/
+static void Cmd_ClearClipTraces_f( const idCmdArgs& args )
+{
+	gameLocal.clip.ClearRecordedTraces();
+}
+
 /*
 ==================
 Cmd_TestDamage_f
@@ -2730,6 +2764,8 @@ void idGameLocal::InitConsoleCommands()
 	cmdSystem->AddCommand( "saveLights",			Cmd_SaveLights_f,			CMD_FL_GAME | CMD_FL_CHEAT,	"saves all lights to the .map file" );
 	cmdSystem->AddCommand( "saveParticles",			Cmd_SaveParticles_f,		CMD_FL_GAME | CMD_FL_CHEAT,	"saves all lights to the .map file" );
 	cmdSystem->AddCommand( "clearLights",			Cmd_ClearLights_f,			CMD_FL_GAME | CMD_FL_CHEAT,	"clears all lights" );
+	cmdSystem->AddCommand( "clipBenchmarkTraces",	Cmd_BenchmarkClipTraces_f,	CMD_FL_GAME | CMD_FL_CHEAT,	"replays the recorded collision traces one at a time and batched" );
+	cmdSystem->AddCommand( "clipClearRecordedTraces",	Cmd_ClearClipTraces_f,	CMD_FL_GAME | CMD_FL_CHEAT,	"clears the recorded collision traces" );
 	cmdSystem->AddCommand( "gameError",				Cmd_GameError_f,			CMD_FL_GAME | CMD_FL_CHEAT,	"causes a game error" );
 	
 	cmdSystem->AddCommand( "disasmScript",			Cmd_DisasmScript_f,			CMD_FL_GAME | CMD_FL_CHEAT,	"disassembles script" );
@@ -109,6 +109,8 @@ idCVar g_showTriggers(				"g_showTriggers",			"0",			CVAR_GAME | CVAR_BOOL, "dra
 idCVar g_showCollisionWorld(		"g_showCollisionWorld",		"0",			CVAR_GAME | CVAR_BOOL, "" );
 idCVar g_showCollisionModels(		"g_showCollisionModels",	"0",			CVAR_GAME | CVAR_BOOL, "" );
 idCVar g_showCollisionTraces(		"g_showCollisionTraces",	"0",			CVAR_GAME | CVAR_BOOL, "" );
+idCVar g_recordCollisionTraces(		"g_recordCollisionTraces",	"0",			CVAR_GAME | CVAR_BOOL, "records point and box traces for clipBenchmarkTraces" );
+idCVar g_parallelCollisionTraces(	"g_parallelCollisionTraces",	"1",		CVAR_GAME | CVAR_BOOL, "spreads batched traces over the job threads" );
 idCVar g_maxShowDistance(			"g_maxShowDistance",		"128",			CVAR_GAME | CVAR_FLOAT, "" );
 idCVar g_showEntityInfo(			"g_showEntityInfo",			"0",			CVAR_GAME | CVAR_BOOL, "" );
 idCVar g_showviewpos(				"g_showviewpos",			"0",			CVAR_GAME | CVAR_BOOL, "" );
@@ -195,6 +197,9 @@ idCVar af_useLinearTime(			"af_useLinearTime",			"1",			CVAR_GAME | CVAR_BOOL, "
 idCVar af_useImpulseFriction(		"af_useImpulseFriction",	"0",			CVAR_GAME | CVAR_BOOL, "use impulse based contact friction" );
 idCVar af_useJointImpulseFriction(	"af_useJointImpulseFriction","0",			CVAR_GAME | CVAR_BOOL, "use impulse based joint friction" );
 idCVar af_useSymmetry(				"af_useSymmetry",			"1",			CVAR_GAME | CVAR_BOOL, "use constraint matrix symmetry" );
+idCVar af_useBlockLCP(				"af_useBlockLCP",			"0",			CVAR_GAME | CVAR_BOOL, "use the iterative block Gauss-Seidel solver for auxiliary constraints" );
+idCVar af_lcpWarmStart(				"af_lcpWarmStart",			"1",			CVAR_GAME | CVAR_BOOL, "warm start the iterative LCP solver with the constraint forces of the previous frame" );
+idCVar af_lcpIterations(			"af_lcpIterations",			"32",			CVAR_GAME | CVAR_INTEGER, "maximum number of iterations of the iterative LCP solver", 1, 1024 );
 idCVar af_skipSelfCollision(		"af_skipSelfCollision",		"0",			CVAR_GAME | CVAR_BOOL, "skip self collision detection" );
 idCVar af_skipLimits(				"af_skipLimits",			"0",			CVAR_GAME | CVAR_BOOL, "skip joint limits" );
 idCVar af_skipFriction(				"af_skipFriction",			"0",			CVAR_GAME | CVAR_BOOL, "skip friction" );
@@ -228,6 +233,12 @@ idCVar rb_showMass(					"rb_showMass",				"0",			CVAR_GAME | CVAR_BOOL, "show th
 idCVar rb_showInertia(				"rb_showInertia",			"0",			CVAR_GAME | CVAR_BOOL, "show the inertia tensor of each rigid body" );
 idCVar rb_showVelocity(				"rb_showVelocity",			"0",			CVAR_GAME | CVAR_BOOL, "show the velocity of each rigid body" );
 idCVar rb_showActive(				"rb_showActive",			"0",			CVAR_GAME | CVAR_BOOL, "show rigid bodies that are not at rest" );
+idCVar rb_showCounters(				"rb_showCounters",			"0",			CVAR_GAME | CVAR_BOOL, "print the number of active and sleeping rigid bodies and their contact points" );
+idCVar rb_contactCache(				"rb_contactCache",			"1",			CVAR_GAME | CVAR_BOOL, "keep rigid body contacts between frames to warm start the contact impulses and put bodies holding still to sleep" );
+idCVar rb_contactIterations(			"rb_contactIterations",		"4",			CVAR_GAME | CVAR_INTEGER, "number of iterations solving the rigid body contact impulses", 1, 16 );
+
+idCVar g_parallelPhysics(			"g_parallelPhysics",		"0",			CVAR_GAME | CVAR_BOOL, "evaluate independent islands of moveables and ragdolls on the job threads" );
+idCVar g_showPhysicsIslands(		"g_showPhysicsIslands",		"0",			CVAR_GAME | CVAR_BOOL, "print the number of physics islands and the time spent evaluating them" );
 
 // The default values for player movement cvars are set in def/player.def
 idCVar pm_jumpheight(				"pm_jumpheight",			"48",			CVAR_GAME | CVAR_NETWORKSYNC | CVAR_FLOAT, "approximate hieght the player can jump" );
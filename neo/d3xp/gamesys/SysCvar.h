@@ -69,6 +69,8 @@ extern idCVar	g_showTriggers;
 extern idCVar	g_showCollisionWorld;
 extern idCVar	g_showCollisionModels;
 extern idCVar	g_showCollisionTraces;
+extern idCVar	g_recordCollisionTraces;
+extern idCVar	g_parallelCollisionTraces;
 extern idCVar	g_maxShowDistance;
 extern idCVar	g_showEntityInfo;
 extern idCVar	g_showviewpos;
@@ -124,6 +126,9 @@ extern idCVar	af_useLinearTime;
 extern idCVar	af_useImpulseFriction;
 extern idCVar	af_useJointImpulseFriction;
 extern idCVar	af_useSymmetry;
+extern idCVar	af_useBlockLCP;
+extern idCVar	af_lcpWarmStart;
+extern idCVar	af_lcpIterations;
 extern idCVar	af_skipSelfCollision;
 extern idCVar	af_skipLimits;
 extern idCVar	af_skipFriction;
@@ -157,6 +162,12 @@ extern idCVar	rb_showMass;
 extern idCVar	rb_showInertia;
 extern idCVar	rb_showVelocity;
 extern idCVar	rb_showActive;
+extern idCVar	rb_showCounters;
+extern idCVar	rb_contactCache;
+extern idCVar	rb_contactIterations;
+
+extern idCVar	g_parallelPhysics;
+extern idCVar	g_showPhysicsIslands;
 
 extern idCVar	pm_jumpheight;
 extern idCVar	pm_stepsize;
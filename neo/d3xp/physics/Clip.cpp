@@ -32,25 +32,18 @@ If you have questions concerning this license or the applicable additional terms
 
 #include "../Game_local.h"
 
-#define	MAX_SECTOR_DEPTH				12
-#define MAX_SECTORS						((1<<(MAX_SECTOR_DEPTH+1))-1)
+#define	CLIP_PROXY_MARGIN				16.0f		// leaf bounds are expanded so small moves don't change the tree
+#define MIN_CLIP_NODES					1024
+#define MAX_CLIP_TREE_DEPTH				256
 
-typedef struct clipSector_s
+typedef struct clipNode_s
 {
-	int						axis;		// -1 = leaf node
-	float					dist;
-	struct clipSector_s* 	children[2];
-	struct clipLink_s* 		clipLinks;
-} clipSector_t;
-
-typedef struct clipLink_s
-{
-	idClipModel* 			clipModel;
-	struct clipSector_s* 	sector;
-	struct clipLink_s* 		prevInSector;
-	struct clipLink_s* 		nextInSector;
-	struct clipLink_s* 		nextLink;
-} clipLink_t;
+	idBounds				bounds;			// expanded clip model bounds for leaves, union of the children otherwise
+	idClipModel* 			clipModel;		// NULL for internal nodes
+	int						parent;			// next free node when not in use
+	int						children[2];	// -1 for leaf nodes
+	int						height;			// 0 for leaves, -1 for free nodes
+} clipNode_t;
 
 typedef struct trmCache_s
 {
@@ -61,9 +54,42 @@ typedef struct trmCache_s
 	idMat3					inertiaTensor;
 } trmCache_t;
 
-idVec3 vec3_boxEpsilon( CM_BOX_EPSILON, CM_BOX_EPSILON, CM_BOX_EPSILON );
+// clip models gathered once for all traces in a batch, the bounds are stored per axis for the SIMD overlap tests
+typedef struct clipTraceCandidates_s
+{
+	int						num;
+	idClipModel* 			clipModels[MAX_GENTITIES];
+	float					bounds[6][MAX_GENTITIES];	// mins followed by maxs, padded to a multiple of 4 with empty bounds
+} clipTraceCandidates_t;
+
+// part of a trace batch that runs on a job thread
+typedef struct clipTraceJob_s
+{
+	idClip* 				clip;
+	clipTrace_t* 			traces;
+	int						numTraces;
+	int						numTraceCalls;
+} clipTraceJob_t;
+
+// point or box trace captured for clipBenchmarkTraces
+typedef struct clipRecordedTrace_s
+{
+	idVec3					start;
+	idVec3					end;
+	idBounds				bounds;
+	int						contentMask;
+	int						passEntityNum;
+} clipRecordedTrace_t;
+
+const static int			MAX_TRACE_BATCH_JOBS = 64;
+const static int			MIN_TRACES_PER_JOB = 8;
+const static int			MAX_RECORDED_TRACES = 65536;
 
-idBlockAlloc<clipLink_t, 1024>	clipLinkAllocator;
+static idList<clipRecordedTrace_t>	recordedTraces;
+
+static ID_TLS						clipThreadIsland;		// island of the clip models moved by the calling thread
+
+idVec3 vec3_boxEpsilon( CM_BOX_EPSILON, CM_BOX_EPSILON, CM_BOX_EPSILON );
 
 
 /*
@@ -404,8 +430,9 @@ void idClipModel::Init()
 	collisionModelHandle = 0;
 	renderModelHandle = -1;
 	traceModelIndex = -1;
-	clipLinks = NULL;
-	touchCount = -1;
+	clipTree = NULL;
+	clipProxy = -1;
+	island = NULL;
 }
 
 /*
@@ -487,8 +514,9 @@ idClipModel::idClipModel( const idClipModel* model )
 		LoadModel( *GetCachedTraceModel( model->traceModelIndex ) );
 	}
 	renderModelHandle = model->renderModelHandle;
-	clipLinks = NULL;
-	touchCount = -1;
+	clipTree = NULL;
+	clipProxy = -1;
+	island = NULL;
 }
 
 /*
@@ -533,8 +561,8 @@ void idClipModel::Save( idSaveGame* savefile ) const
 	}
 	savefile->WriteInt( traceModelIndex );
 	savefile->WriteInt( renderModelHandle );
-	savefile->WriteBool( clipLinks != NULL );
-	savefile->WriteInt( touchCount );
+	savefile->WriteBool( clipProxy != -1 );
+	savefile->WriteInt( clipProxy );
 }
 
 /*
@@ -574,12 +602,12 @@ void idClipModel::Restore( idRestoreGame* savefile )
 	}
 	savefile->ReadInt( renderModelHandle );
 	savefile->ReadBool( linked );
-	savefile->ReadInt( touchCount );
+	savefile->ReadInt( clipProxy );
 	
 	// the render model will be set when the clip model is linked
 	renderModelHandle = -1;
-	clipLinks = NULL;
-	touchCount = -1;
+	clipTree = NULL;
+	clipProxy = -1;
 	
 	if( linked )
 	{
@@ -594,7 +622,7 @@ idClipModel::SetPosition
 */
 void idClipModel::SetPosition( const idVec3& newOrigin, const idMat3& newAxis )
 {
-	if( clipLinks )
+	if( clipProxy != -1 )
 	{
 		Unlink();	// unlink from old position
 	}
@@ -651,65 +679,18 @@ idClipModel::Unlink
 */
 void idClipModel::Unlink()
 {
-	clipLink_t* link;
-	
-	for( link = clipLinks; link; link = clipLinks )
-	{
-		clipLinks = link->nextLink;
-		if( link->prevInSector )
-		{
-			link->prevInSector->nextInSector = link->nextInSector;
-		}
-		else
-		{
-			link->sector->clipLinks = link->nextInSector;
-		}
-		if( link->nextInSector )
-		{
-			link->nextInSector->prevInSector = link->prevInSector;
-		}
-		clipLinkAllocator.Free( link );
-	}
-}
-
-/*
-===============
-idClipModel::Link_r
-===============
-*/
-void idClipModel::Link_r( struct clipSector_s* node )
-{
-	clipLink_t* link;
-	
-	while( node->axis != -1 )
+	if( island != NULL )
 	{
-		if( absBounds[0][node->axis] > node->dist )
-		{
-			node = node->children[0];
-		}
-		else if( absBounds[1][node->axis] < node->dist )
-		{
-			node = node->children[1];
-		}
-		else
-		{
-			Link_r( node->children[0] );
-			node = node->children[1];
-		}
+		// the proxy is updated when the island ends
+		clipTree = NULL;
+		return;
 	}
-	
-	link = clipLinkAllocator.Alloc();
-	link->clipModel = this;
-	link->sector = node;
-	link->nextInSector = node->clipLinks;
-	link->prevInSector = NULL;
-	if( node->clipLinks )
+	if( clipProxy != -1 )
 	{
-		node->clipLinks->prevInSector = link;
+		clipTree->DestroyClipProxy( clipProxy );
+		clipProxy = -1;
 	}
-	node->clipLinks = link;
-	link->nextLink = clipLinks;
-	clipLinks = link;
+	clipTree = NULL;
 }
 
 /*
@@ -726,13 +707,9 @@ void idClipModel::Link( idClip& clp )
 		return;
 	}
 	
-	if( clipLinks )
-	{
-		Unlink();	// unlink from old position
-	}
-	
 	if( bounds.IsCleared() )
 	{
+		Unlink();
 		return;
 	}
 	
@@ -754,7 +731,24 @@ void idClipModel::Link( idClip& clp )
 	absBounds[0] -= vec3_boxEpsilon;
 	absBounds[1] += vec3_boxEpsilon;
 	
-	Link_r( clp.clipSectors );
+	if( island != NULL )
+	{
+		// the proxy is updated when the island ends
+		clipTree = &clp;
+		return;
+	}
+	
+	if( clipProxy != -1 && clipTree == &clp )
+	{
+		// only moves in the tree when the model left the expanded leaf bounds
+		clp.MoveClipProxy( clipProxy );
+	}
+	else
+	{
+		Unlink();
+		clipTree = &clp;
+		clipProxy = clp.CreateClipProxy( this );
+	}
 }
 
 /*
@@ -807,69 +801,368 @@ idClip::idClip
 */
 idClip::idClip()
 {
-	numClipSectors = 0;
-	clipSectors = NULL;
+	clipNodes = NULL;
+	maxClipNodes = numClipNodes = 0;
+	freeClipNode = rootClipNode = -1;
 	worldBounds.Zero();
-	numRotations = numTranslations = numMotions = numRenderModelTraces = numContents = numContacts = 0;
+	traceCandidates = NULL;
+	traceJobList = NULL;
+}
+
+/*
+===============
+ClipBoundsUnion
+===============
+*/
+static ID_INLINE idBounds ClipBoundsUnion( const idBounds& a, const idBounds& b )
+{
+	return idBounds( idVec3( Min( a[0][0], b[0][0] ), Min( a[0][1], b[0][1] ), Min( a[0][2], b[0][2] ) ),
+					 idVec3( Max( a[1][0], b[1][0] ), Max( a[1][1], b[1][1] ), Max( a[1][2], b[1][2] ) ) );
+}
+
+/*
+===============
+ClipBoundsArea
+===============
+*/
+static ID_INLINE float ClipBoundsArea( const idBounds& b )
+{
+	const idVec3 size = b[1] - b[0];
+	return 2.0f * ( size[0] * size[1] + size[1] * size[2] + size[2] * size[0] );
+}
+
+/*
+===============
+idClip::AllocClipNode
+===============
+*/
+int idClip::AllocClipNode()
+{
+	int i, nodeNum;
+	
+	if( freeClipNode == -1 )
+	{
+		// grow the node pool and chain the new nodes into the free list
+		int newMaxNodes = Max( MIN_CLIP_NODES, maxClipNodes * 2 );
+		clipNode_t* newNodes = new( TAG_PHYSICS_CLIP ) clipNode_t[newMaxNodes];
+		if( clipNodes != NULL )
+		{
+			memcpy( newNodes, clipNodes, maxClipNodes * sizeof( clipNode_t ) );
+			delete[] clipNodes;
+		}
+		clipNodes = newNodes;
+		
+		for( i = maxClipNodes; i < newMaxNodes; i++ )
+		{
+			clipNodes[i].parent = ( i < newMaxNodes - 1 ) ? i + 1 : -1;
+			clipNodes[i].height = -1;
+		}
+		freeClipNode = maxClipNodes;
+		maxClipNodes = newMaxNodes;
+	}
+	
+	nodeNum = freeClipNode;
+	clipNode_t& node = clipNodes[nodeNum];
+	freeClipNode = node.parent;
+	node.bounds.Clear();
+	node.clipModel = NULL;
+	node.parent = -1;
+	node.children[0] = node.children[1] = -1;
+	node.height = 0;
+	numClipNodes++;
+	
+	return nodeNum;
+}
+
+/*
+===============
+idClip::FreeClipNode
+===============
+*/
+void idClip::FreeClipNode( int nodeNum )
+{
+	assert( nodeNum >= 0 && nodeNum < maxClipNodes && numClipNodes > 0 );
+	
+	clipNodes[nodeNum].clipModel = NULL;
+	clipNodes[nodeNum].parent = freeClipNode;
+	clipNodes[nodeNum].height = -1;
+	freeClipNode = nodeNum;
+	numClipNodes--;
+}
+
+/*
+===============
+idClip::CreateClipProxy
+===============
+*/
+int idClip::CreateClipProxy( idClipModel* clipModel )
+{
+	int proxy = AllocClipNode();
+	
+	clipNodes[proxy].bounds = clipModel->absBounds.Expand( CLIP_PROXY_MARGIN );
+	clipNodes[proxy].clipModel = clipModel;
+	InsertClipLeaf( proxy );
+	
+	return proxy;
+}
+
+/*
+===============
+idClip::DestroyClipProxy
+===============
+*/
+void idClip::DestroyClipProxy( int proxy )
+{
+	assert( clipNodes[proxy].children[0] == -1 );
+	
+	RemoveClipLeaf( proxy );
+	FreeClipNode( proxy );
+}
+
+/*
+===============
+idClip::MoveClipProxy
+
+  Reinserts the leaf when the clip model bounds are no longer inside the expanded leaf bounds.
+===============
+*/
+void idClip::MoveClipProxy( int proxy )
+{
+	clipNode_t& node = clipNodes[proxy];
+	const idBounds& absBounds = node.clipModel->absBounds;
+	
+	if(	absBounds[0][0] >= node.bounds[0][0] && absBounds[1][0] <= node.bounds[1][0] &&
+			absBounds[0][1] >= node.bounds[0][1] && absBounds[1][1] <= node.bounds[1][1] &&
+			absBounds[0][2] >= node.bounds[0][2] && absBounds[1][2] <= node.bounds[1][2] )
+	{
+		return;
+	}
+	
+	RemoveClipLeaf( proxy );
+	node.bounds = absBounds.Expand( CLIP_PROXY_MARGIN );
+	InsertClipLeaf( proxy );
 }
 
 /*
 ===============
-idClip::CreateClipSectors_r
+idClip::InsertClipLeaf
 
-Builds a uniformly subdivided tree for the given world size
+  Walks down the tree to the sibling with the smallest increase in surface area and
+  rebalances the nodes on the way back up.
 ===============
 */
-clipSector_t* idClip::CreateClipSectors_r( const int depth, const idBounds& bounds, idVec3& maxSector )
+void idClip::InsertClipLeaf( int leaf )
 {
-	int				i;
-	clipSector_t*	anode;
-	idVec3			size;
-	idBounds		front, back;
+	int nodeNum, sibling, oldParent, newParent, child0, child1;
+	float area, combinedArea, cost, inheritanceCost, cost0, cost1;
+	idBounds leafBounds;
 	
-	anode = &clipSectors[idClip::numClipSectors];
-	idClip::numClipSectors++;
+	if( rootClipNode == -1 )
+	{
+		rootClipNode = leaf;
+		clipNodes[leaf].parent = -1;
+		return;
+	}
 	
-	if( depth == MAX_SECTOR_DEPTH )
+	leafBounds = clipNodes[leaf].bounds;
+	nodeNum = rootClipNode;
+	while( clipNodes[nodeNum].children[0] != -1 )
 	{
-		anode->axis = -1;
-		anode->children[0] = anode->children[1] = NULL;
+		child0 = clipNodes[nodeNum].children[0];
+		child1 = clipNodes[nodeNum].children[1];
 		
-		for( i = 0; i < 3; i++ )
+		area = ClipBoundsArea( clipNodes[nodeNum].bounds );
+		combinedArea = ClipBoundsArea( ClipBoundsUnion( clipNodes[nodeNum].bounds, leafBounds ) );
+		
+		// cost of creating a new parent for this node and the new leaf
+		cost = 2.0f * combinedArea;
+		
+		// minimum cost of pushing the leaf further down the tree
+		inheritanceCost = 2.0f * ( combinedArea - area );
+		
+		cost0 = ClipBoundsArea( ClipBoundsUnion( clipNodes[child0].bounds, leafBounds ) ) + inheritanceCost;
+		if( clipNodes[child0].children[0] != -1 )
 		{
-			if( bounds[1][i] - bounds[0][i] > maxSector[i] )
-			{
-				maxSector[i] = bounds[1][i] - bounds[0][i];
-			}
+			cost0 -= ClipBoundsArea( clipNodes[child0].bounds );
+		}
+		cost1 = ClipBoundsArea( ClipBoundsUnion( clipNodes[child1].bounds, leafBounds ) ) + inheritanceCost;
+		if( clipNodes[child1].children[0] != -1 )
+		{
+			cost1 -= ClipBoundsArea( clipNodes[child1].bounds );
+		}
+		
+		if( cost < cost0 && cost < cost1 )
+		{
+			break;
+		}
+		
+		nodeNum = ( cost0 < cost1 ) ? child0 : child1;
+	}
+	sibling = nodeNum;
+	
+	// create a new parent for the sibling and the leaf
+	newParent = AllocClipNode();
+	oldParent = clipNodes[sibling].parent;
+	clipNodes[newParent].parent = oldParent;
+	clipNodes[newParent].bounds = ClipBoundsUnion( leafBounds, clipNodes[sibling].bounds );
+	clipNodes[newParent].height = clipNodes[sibling].height + 1;
+	clipNodes[newParent].children[0] = sibling;
+	clipNodes[newParent].children[1] = leaf;
+	clipNodes[sibling].parent = newParent;
+	clipNodes[leaf].parent = newParent;
+	
+	if( oldParent != -1 )
+	{
+		if( clipNodes[oldParent].children[0] == sibling )
+		{
+			clipNodes[oldParent].children[0] = newParent;
+		}
+		else
+		{
+			clipNodes[oldParent].children[1] = newParent;
 		}
-		return anode;
 	}
+	else
+	{
+		rootClipNode = newParent;
+	}
+	
+	// fix the heights and bounds of the ancestors
+	for( nodeNum = clipNodes[leaf].parent; nodeNum != -1; nodeNum = clipNodes[nodeNum].parent )
+	{
+		nodeNum = BalanceClipNode( nodeNum );
+		
+		child0 = clipNodes[nodeNum].children[0];
+		child1 = clipNodes[nodeNum].children[1];
+		clipNodes[nodeNum].height = 1 + Max( clipNodes[child0].height, clipNodes[child1].height );
+		clipNodes[nodeNum].bounds = ClipBoundsUnion( clipNodes[child0].bounds, clipNodes[child1].bounds );
+	}
+}
+
+/*
+===============
+idClip::RemoveClipLeaf
+===============
+*/
+void idClip::RemoveClipLeaf( int leaf )
+{
+	int nodeNum, parent, grandParent, sibling, child0, child1;
+	
+	if( leaf == rootClipNode )
+	{
+		rootClipNode = -1;
+		return;
+	}
+	
+	parent = clipNodes[leaf].parent;
+	grandParent = clipNodes[parent].parent;
+	sibling = ( clipNodes[parent].children[0] == leaf ) ? clipNodes[parent].children[1] : clipNodes[parent].children[0];
 	
-	size = bounds[1] - bounds[0];
-	if( size[0] >= size[1] && size[0] >= size[2] )
+	FreeClipNode( parent );
+	
+	if( grandParent == -1 )
 	{
-		anode->axis = 0;
+		rootClipNode = sibling;
+		clipNodes[sibling].parent = -1;
+		return;
 	}
-	else if( size[1] >= size[0] && size[1] >= size[2] )
+	
+	// connect the sibling to the grand parent
+	if( clipNodes[grandParent].children[0] == parent )
 	{
-		anode->axis = 1;
+		clipNodes[grandParent].children[0] = sibling;
 	}
 	else
 	{
-		anode->axis = 2;
+		clipNodes[grandParent].children[1] = sibling;
+	}
+	clipNodes[sibling].parent = grandParent;
+	
+	for( nodeNum = grandParent; nodeNum != -1; nodeNum = clipNodes[nodeNum].parent )
+	{
+		nodeNum = BalanceClipNode( nodeNum );
+		
+		child0 = clipNodes[nodeNum].children[0];
+		child1 = clipNodes[nodeNum].children[1];
+		clipNodes[nodeNum].height = 1 + Max( clipNodes[child0].height, clipNodes[child1].height );
+		clipNodes[nodeNum].bounds = ClipBoundsUnion( clipNodes[child0].bounds, clipNodes[child1].bounds );
+	}
+}
+
+/*
+===============
+idClip::BalanceClipNode
+
+  Rotates the higher child up when the heights of the children differ by more than one.
+  Returns the node that took the place of the given node.
+===============
+*/
+int idClip::BalanceClipNode( int nodeNum )
+{
+	int up, down, keep, balance, upParent, child0, child1;
+	
+	clipNode_t& a = clipNodes[nodeNum];
+	if( a.children[0] == -1 || a.height < 2 )
+	{
+		return nodeNum;
+	}
+	
+	balance = clipNodes[a.children[1]].height - clipNodes[a.children[0]].height;
+	if( balance >= -1 && balance <= 1 )
+	{
+		return nodeNum;
 	}
 	
-	anode->dist = 0.5f * ( bounds[1][anode->axis] + bounds[0][anode->axis] );
+	// the higher child moves up and takes the place of this node
+	const int upSide = ( balance > 1 ) ? 1 : 0;
+	up = a.children[upSide];
+	clipNode_t& u = clipNodes[up];
+	child0 = u.children[0];
+	child1 = u.children[1];
+	
+	u.children[0] = nodeNum;
+	u.parent = a.parent;
+	a.parent = up;
 	
-	front = bounds;
-	back = bounds;
+	upParent = u.parent;
+	if( upParent != -1 )
+	{
+		if( clipNodes[upParent].children[0] == nodeNum )
+		{
+			clipNodes[upParent].children[0] = up;
+		}
+		else
+		{
+			clipNodes[upParent].children[1] = up;
+		}
+	}
+	else
+	{
+		rootClipNode = up;
+	}
 	
-	front[0][anode->axis] = back[1][anode->axis] = anode->dist;
+	// the higher grand child stays with the moved up node, the other one replaces it below this node
+	if( clipNodes[child0].height > clipNodes[child1].height )
+	{
+		keep = child0;
+		down = child1;
+	}
+	else
+	{
+		keep = child1;
+		down = child0;
+	}
+	u.children[1] = keep;
+	a.children[upSide] = down;
+	clipNodes[down].parent = nodeNum;
 	
-	anode->children[0] = CreateClipSectors_r( depth + 1, front, maxSector );
-	anode->children[1] = CreateClipSectors_r( depth + 1, back, maxSector );
+	const int other = a.children[upSide ^ 1];
+	a.bounds = ClipBoundsUnion( clipNodes[other].bounds, clipNodes[down].bounds );
+	a.height = 1 + Max( clipNodes[other].height, clipNodes[down].height );
+	u.bounds = ClipBoundsUnion( a.bounds, clipNodes[keep].bounds );
+	u.height = 1 + Max( a.height, clipNodes[keep].height );
 	
-	return anode;
+	return up;
 }
 
 /*
@@ -880,28 +1173,27 @@ idClip::Init
 void idClip::Init()
 {
 	cmHandle_t h;
-	idVec3 size, maxSector = vec3_origin;
+	idVec3 size;
 	
-	// clear clip sectors
-	clipSectors = new( TAG_PHYSICS_CLIP ) clipSector_t[MAX_SECTORS];
-	memset( clipSectors, 0, MAX_SECTORS * sizeof( clipSector_t ) );
-	numClipSectors = 0;
-	touchCount = -1;
+	// clear the clip model tree
+	clipNodes = NULL;
+	maxClipNodes = numClipNodes = 0;
+	freeClipNode = rootClipNode = -1;
 	// get world map bounds
 	h = collisionModelManager->LoadModel( "worldMap" );
 	collisionModelManager->GetModelBounds( h, worldBounds );
-	// create world sectors
-	CreateClipSectors_r( 0, worldBounds, maxSector );
 	
 	size = worldBounds[1] - worldBounds[0];
 	gameLocal.Printf( "map bounds are (%1.1f, %1.1f, %1.1f)\n", size[0], size[1], size[2] );
-	gameLocal.Printf( "max clip sector is (%1.1f, %1.1f, %1.1f)\n", maxSector[0], maxSector[1], maxSector[2] );
 	
 	// initialize a default clip model
 	defaultClipModel.LoadModel( idTraceModel( idBounds( idVec3( 0, 0, 0 ) ).Expand( 8 ) ) );
 	
-	// set counters to zero
-	numRotations = numTranslations = numMotions = numRenderModelTraces = numContents = numContacts = 0;
+	// candidate lists and jobs for batched traces
+	traceCandidates = new( TAG_PHYSICS_CLIP ) clipTraceCandidates_t[2];
+	traceJobList = parallelJobManager->AllocJobList( JOBLIST_GAME, JOBLIST_PRIORITY_MEDIUM, MAX_TRACE_BATCH_JOBS, 0, NULL );
+	
+	ClearStatistics();
 }
 
 /*
@@ -911,8 +1203,28 @@ idClip::Shutdown
 */
 void idClip::Shutdown()
 {
-	delete[] clipSectors;
-	clipSectors = NULL;
+	// clip models that are still linked no longer have a proxy
+	for( int i = 0; i < maxClipNodes; i++ )
+	{
+		if( clipNodes[i].height == 0 && clipNodes[i].clipModel != NULL )
+		{
+			clipNodes[i].clipModel->clipTree = NULL;
+			clipNodes[i].clipModel->clipProxy = -1;
+		}
+	}
+	delete[] clipNodes;
+	clipNodes = NULL;
+	maxClipNodes = numClipNodes = 0;
+	freeClipNode = rootClipNode = -1;
+	
+	delete[] traceCandidates;
+	traceCandidates = NULL;
+	
+	if( traceJobList != NULL )
+	{
+		parallelJobManager->FreeJobList( traceJobList );
+		traceJobList = NULL;
+	}
 	
 	// free the trace model used for the temporaryClipModel
 	if( temporaryClipModel.traceModelIndex != -1 )
@@ -927,118 +1239,144 @@ void idClip::Shutdown()
 		idClipModel::FreeTraceModel( defaultClipModel.traceModelIndex );
 		defaultClipModel.traceModelIndex = -1;
 	}
-	
-	clipLinkAllocator.Shutdown();
 }
 
 /*
-====================
-idClip::ClipModelsTouchingBounds_r
-====================
+================
+idClip::ClipModelsTouchingBounds
+================
 */
-typedef struct listParms_s
-{
-	idBounds		bounds;
-	int				contentMask;
-	idClipModel**		list;
-	int				count;
-	int				maxCount;
-} listParms_t;
-
-void idClip::ClipModelsTouchingBounds_r( const struct clipSector_s* node, listParms_t& parms ) const
+int idClip::ClipModelsTouchingBounds( const idBounds& bounds, int contentMask, idClipModel** clipModelList, int maxCount ) const
 {
-
-	while( node->axis != -1 )
+	int nodeNum, count, stackDepth, stack[MAX_CLIP_TREE_DEPTH];
+	idBounds checkBounds;
+	
+	if(	bounds[0][0] > bounds[1][0] ||
+			bounds[0][1] > bounds[1][1] ||
+			bounds[0][2] > bounds[1][2] )
 	{
-		if( parms.bounds[0][node->axis] > node->dist )
-		{
-			node = node->children[0];
-		}
-		else if( parms.bounds[1][node->axis] < node->dist )
+		// we should not go through the tree for degenerate or backwards bounds
+		assert( false );
+		return 0;
+	}
+	
+	checkBounds[0] = bounds[0] - vec3_boxEpsilon;
+	checkBounds[1] = bounds[1] + vec3_boxEpsilon;
+	
+	numBoundsQueries.Increment();
+	
+	count = 0;
+	stackDepth = 0;
+	if( rootClipNode != -1 )
+	{
+		stack[stackDepth++] = rootClipNode;
+	}
+	
+	while( stackDepth > 0 )
+	{
+		const clipNode_t& node = clipNodes[stack[--stackDepth]];
+		
+		if(	node.bounds[0][0] > checkBounds[1][0] ||
+				node.bounds[1][0] < checkBounds[0][0] ||
+				node.bounds[0][1] > checkBounds[1][1] ||
+				node.bounds[1][1] < checkBounds[0][1] ||
+				node.bounds[0][2] > checkBounds[1][2] ||
+				node.bounds[1][2] < checkBounds[0][2] )
 		{
-			node = node->children[1];
+			continue;
 		}
-		else
+		
+		if( node.children[0] != -1 )
 		{
-			ClipModelsTouchingBounds_r( node->children[0], parms );
-			node = node->children[1];
+			if( stackDepth + 2 > MAX_CLIP_TREE_DEPTH )
+			{
+				gameLocal.Warning( "idClip::ClipModelsTouchingBounds: tree too deep" );
+				continue;
+			}
+			stack[stackDepth++] = node.children[0];
+			stack[stackDepth++] = node.children[1];
+			continue;
 		}
-	}
-	
-	for( clipLink_t* link = node->clipLinks; link; link = link->nextInSector )
-	{
-		idClipModel*	check = link->clipModel;
 		
-		// if the clip model is enabled
-		if( !check->enabled )
+		idClipModel*	check = node.clipModel;
+		
+		// clip models moving in an island are only seen from the thread moving them
+		if( check->island != NULL )
 		{
 			continue;
 		}
 		
-		// avoid duplicates in the list
-		if( check->touchCount == touchCount )
+		numBoundsCandidates.Increment();
+		
+		// if the clip model is enabled
+		if( !check->enabled )
 		{
 			continue;
 		}
 		
 		// if the clip model does not have any contents we are looking for
-		if( !( check->contents & parms.contentMask ) )
+		if( !( check->contents & contentMask ) )
 		{
 			continue;
 		}
 		
 		// if the bounds really do overlap
-		if(	check->absBounds[0][0] > parms.bounds[1][0] ||
-				check->absBounds[1][0] < parms.bounds[0][0] ||
-				check->absBounds[0][1] > parms.bounds[1][1] ||
-				check->absBounds[1][1] < parms.bounds[0][1] ||
-				check->absBounds[0][2] > parms.bounds[1][2] ||
-				check->absBounds[1][2] < parms.bounds[0][2] )
+		if(	check->absBounds[0][0] > checkBounds[1][0] ||
+				check->absBounds[1][0] < checkBounds[0][0] ||
+				check->absBounds[0][1] > checkBounds[1][1] ||
+				check->absBounds[1][1] < checkBounds[0][1] ||
+				check->absBounds[0][2] > checkBounds[1][2] ||
+				check->absBounds[1][2] < checkBounds[0][2] )
 		{
 			continue;
 		}
 		
-		if( parms.count >= parms.maxCount )
+		if( count >= maxCount )
 		{
-			gameLocal.Warning( "idClip::ClipModelsTouchingBounds_r: max count" );
-			return;
+			gameLocal.Warning( "idClip::ClipModelsTouchingBounds: max count" );
+			return count;
 		}
 		
-		check->touchCount = touchCount;
-		parms.list[parms.count] = check;
-		parms.count++;
+		clipModelList[count] = check;
+		count++;
 	}
-}
-
-/*
-================
-idClip::ClipModelsTouchingBounds
-================
-*/
-int idClip::ClipModelsTouchingBounds( const idBounds& bounds, int contentMask, idClipModel** clipModelList, int maxCount ) const
-{
-	listParms_t parms;
 	
-	if(	bounds[0][0] > bounds[1][0] ||
-			bounds[0][1] > bounds[1][1] ||
-			bounds[0][2] > bounds[1][2] )
+	const clipIsland_t* island = ( const clipIsland_t* )( ptrdiff_t )clipThreadIsland;
+	if( island != NULL )
 	{
-		// we should not go through the tree for degenerate or backwards bounds
-		assert( false );
-		return 0;
+		for( int i = 0; i < island->clipModels.Num(); i++ )
+		{
+			idClipModel* check = island->clipModels[i];
+			
+			// if the clip model is linked, enabled and has any of the contents we are looking for
+			if( check->clipTree == NULL || !check->enabled || !( check->contents & contentMask ) )
+			{
+				continue;
+			}
+			
+			// if the bounds really do overlap
+			if(	check->absBounds[0][0] > checkBounds[1][0] ||
+					check->absBounds[1][0] < checkBounds[0][0] ||
+					check->absBounds[0][1] > checkBounds[1][1] ||
+					check->absBounds[1][1] < checkBounds[0][1] ||
+					check->absBounds[0][2] > checkBounds[1][2] ||
+					check->absBounds[1][2] < checkBounds[0][2] )
+			{
+				continue;
+			}
+			
+			if( count >= maxCount )
+			{
+				gameLocal.Warning( "idClip::ClipModelsTouchingBounds: max count" );
+				return count;
+			}
+			
+			clipModelList[count] = check;
+			count++;
+		}
 	}
 	
-	parms.bounds[0] = bounds[0] - vec3_boxEpsilon;
-	parms.bounds[1] = bounds[1] + vec3_boxEpsilon;
-	parms.contentMask = contentMask;
-	parms.list = clipModelList;
-	parms.count = 0;
-	parms.maxCount = maxCount;
-	
-	touchCount++;
-	ClipModelsTouchingBounds_r( clipSectors, parms );
-	
-	return parms.count;
+	return count;
 }
 
 /*
@@ -1289,12 +1627,12 @@ void idClip::TranslationEntities( trace_t& results, const idVec3& start, const i
 		
 		if( touch->renderModelHandle != -1 )
 		{
-			idClip::numRenderModelTraces++;
+			idClip::numRenderModelTraces.Increment();
 			TraceRenderModel( trace, start, end, radius, trmAxis, touch );
 		}
 		else
 		{
-			idClip::numTranslations++;
+			idClip::numTranslations.Increment();
 			collisionModelManager->Translation( &trace, start, end, trm, trmAxis, contentMask,
 												touch->Handle(), touch->origin, touch->axis );
 		}
@@ -1334,10 +1672,15 @@ bool idClip::Translation( trace_t& results, const idVec3& start, const idVec3& e
 	
 	trm = TraceModelForClipModel( mdl );
 	
+	if( g_recordCollisionTraces.GetBool() && idLib::IsMainThread() )
+	{
+		RecordTrace( start, end, trm, trmAxis, contentMask, passEntity );
+	}
+	
 	if( !passEntity || passEntity->entityNumber != ENTITYNUM_WORLD )
 	{
 		// test world
-		idClip::numTranslations++;
+		idClip::numTranslations.Increment();
 		collisionModelManager->Translation( &results, start, end, trm, trmAxis, contentMask, 0, vec3_origin, mat3_default );
 		results.c.entityNum = results.fraction != 1.0f ? ENTITYNUM_WORLD : ENTITYNUM_NONE;
 		if( results.fraction == 0.0f )
@@ -1377,12 +1720,12 @@ bool idClip::Translation( trace_t& results, const idVec3& start, const idVec3& e
 		
 		if( touch->renderModelHandle != -1 )
 		{
-			idClip::numRenderModelTraces++;
+			idClip::numRenderModelTraces.Increment();
 			TraceRenderModel( trace, start, end, radius, trmAxis, touch );
 		}
 		else
 		{
-			idClip::numTranslations++;
+			idClip::numTranslations.Increment();
 			collisionModelManager->Translation( &trace, start, end, trm, trmAxis, contentMask,
 												touch->Handle(), touch->origin, touch->axis );
 		}
@@ -1402,6 +1745,315 @@ bool idClip::Translation( trace_t& results, const idVec3& start, const idVec3& e
 	return ( results.fraction < 1.0f );
 }
 
+/*
+===============================================================
+
+	Batched traces
+
+===============================================================
+*/
+
+/*
+============
+ClipTraceIsPoint
+============
+*/
+static ID_INLINE bool ClipTraceIsPoint( const idBounds& bounds )
+{
+	return ( bounds[1][0] - bounds[0][0] <= 0.0f && bounds[1][1] - bounds[0][1] <= 0.0f && bounds[1][2] - bounds[0][2] <= 0.0f );
+}
+
+/*
+============
+ClipTraceBatchJob
+============
+*/
+void ClipTraceBatchJob( clipTraceJob_t* job )
+{
+	job->numTraceCalls = 0;
+	job->clip->TraceBatchCandidates( job->traces, job->numTraces, job->clip->traceCandidates[0], job->numTraceCalls );
+}
+
+REGISTER_PARALLEL_JOB( ClipTraceBatchJob, "ClipTraceBatchJob" );
+
+/*
+============
+idClip::TraceBatchCandidates
+
+  Traces against the world when the candidates are the job safe collision models and then against
+  all candidates that overlap the bounds of the remaining trace.
+============
+*/
+void idClip::TraceBatchCandidates( clipTrace_t* traces, const int numTraces, const clipTraceCandidates_t& candidates, int& numTraceCalls ) const
+{
+	int i, j, k, mask;
+	bool point;
+	float radius;
+	idBounds trmBounds, traceBounds;
+	idTraceModel trm;
+	idClipModel* touch;
+	idEntity* passOwner;
+	trace_t trace;
+	const bool traceWorld = ( &candidates == &traceCandidates[0] );
+	
+	trmBounds.Clear();
+	
+	for( i = 0; i < numTraces; i++ )
+	{
+		clipTrace_t& t = traces[i];
+		
+		// consecutive traces often use the same box
+		point = ClipTraceIsPoint( t.bounds );
+		if( !point && !trmBounds.Compare( t.bounds ) )
+		{
+			trm.SetupBox( t.bounds );
+			trmBounds = t.bounds;
+		}
+		
+		if( traceWorld )
+		{
+			if( !t.passEntity || t.passEntity->entityNumber != ENTITYNUM_WORLD )
+			{
+				numTraceCalls++;
+				collisionModelManager->Translation( &t.results, t.start, t.end, point ? NULL : &trm, mat3_identity, t.contentMask, 0, vec3_origin, mat3_default );
+				t.results.c.entityNum = t.results.fraction != 1.0f ? ENTITYNUM_WORLD : ENTITYNUM_NONE;
+			}
+			else
+			{
+				memset( &t.results, 0, sizeof( t.results ) );
+				t.results.fraction = 1.0f;
+				t.results.endpos = t.end;
+				t.results.endAxis = mat3_identity;
+			}
+		}
+		
+		if( t.results.fraction == 0.0f || candidates.num == 0 )
+		{
+			continue;
+		}
+		
+		if( point )
+		{
+			traceBounds.FromPointTranslation( t.start, t.results.endpos - t.start );
+			radius = 0.0f;
+		}
+		else
+		{
+			traceBounds.FromBoundsTranslation( t.bounds, t.start, mat3_identity, t.results.endpos - t.start );
+			radius = t.bounds.GetRadius();
+		}
+		traceBounds[0] -= vec3_boxEpsilon;
+		traceBounds[1] += vec3_boxEpsilon;
+		
+		if( t.passEntity && t.passEntity->GetPhysics()->GetNumClipModels() > 0 )
+		{
+			passOwner = t.passEntity->GetPhysics()->GetClipModel()->GetOwner();
+		}
+		else
+		{
+			passOwner = NULL;
+		}
+		
+#if defined(USE_INTRINSICS)
+		const __m128 minx = _mm_set1_ps( traceBounds[0][0] );
+		const __m128 miny = _mm_set1_ps( traceBounds[0][1] );
+		const __m128 minz = _mm_set1_ps( traceBounds[0][2] );
+		const __m128 maxx = _mm_set1_ps( traceBounds[1][0] );
+		const __m128 maxy = _mm_set1_ps( traceBounds[1][1] );
+		const __m128 maxz = _mm_set1_ps( traceBounds[1][2] );
+#endif
+		
+		for( j = 0; j < candidates.num && t.results.fraction > 0.0f; j += 4 )
+		{
+			// test the trace bounds against four candidates at once
+#if defined(USE_INTRINSICS)
+			__m128 overlap;
+			overlap = _mm_and_ps( _mm_cmple_ps( _mm_loadu_ps( &candidates.bounds[0][j] ), maxx ), _mm_cmpge_ps( _mm_loadu_ps( &candidates.bounds[3][j] ), minx ) );
+			overlap = _mm_and_ps( overlap, _mm_and_ps( _mm_cmple_ps( _mm_loadu_ps( &candidates.bounds[1][j] ), maxy ), _mm_cmpge_ps( _mm_loadu_ps( &candidates.bounds[4][j] ), miny ) ) );
+			overlap = _mm_and_ps( overlap, _mm_and_ps( _mm_cmple_ps( _mm_loadu_ps( &candidates.bounds[2][j] ), maxz ), _mm_cmpge_ps( _mm_loadu_ps( &candidates.bounds[5][j] ), minz ) ) );
+			mask = _mm_movemask_ps( overlap );
+#else
+			mask = 0;
+			for( k = 0; k < 4; k++ )
+			{
+				if( candidates.bounds[0][j + k] <= traceBounds[1][0] && candidates.bounds[3][j + k] >= traceBounds[0][0] &&
+						candidates.bounds[1][j + k] <= traceBounds[1][1] && candidates.bounds[4][j + k] >= traceBounds[0][1] &&
+						candidates.bounds[2][j + k] <= traceBounds[1][2] && candidates.bounds[5][j + k] >= traceBounds[0][2] )
+				{
+					mask |= 1 << k;
+				}
+			}
+#endif
+			
+			for( k = 0; k < 4 && mask != 0; k++, mask >>= 1 )
+			{
+				if( !( mask & 1 ) )
+				{
+					continue;
+				}
+				
+				touch = candidates.clipModels[j + k];
+				
+				// if the clip model does not have any contents this trace is looking for
+				if( !( touch->contents & t.contentMask ) )
+				{
+					continue;
+				}
+				
+				// same rules as GetTraceClipModels
+				if( t.passEntity )
+				{
+					if( touch->entity == t.passEntity || touch->entity == passOwner )
+					{
+						continue;
+					}
+					if( touch->owner && ( touch->owner == t.passEntity || touch->owner == passOwner ) )
+					{
+						continue;
+					}
+				}
+				
+				numTraceCalls++;
+				if( touch->renderModelHandle != -1 )
+				{
+					TraceRenderModel( trace, t.start, t.end, radius, mat3_identity, touch );
+				}
+				else
+				{
+					collisionModelManager->Translation( &trace, t.start, t.end, point ? NULL : &trm, mat3_identity, t.contentMask,
+														touch->Handle(), touch->origin, touch->axis );
+				}
+				
+				if( trace.fraction < t.results.fraction )
+				{
+					t.results = trace;
+					t.results.c.entityNum = touch->entity->entityNumber;
+					t.results.c.id = touch->id;
+					if( t.results.fraction == 0.0f )
+					{
+						break;
+					}
+				}
+			}
+		}
+	}
+}
+
+/*
+============
+idClip::TraceBatch
+
+  Gathers the clip models once for all traces. The world and the clip models with static
+  collision models can be traced on the job threads, trace models and render models share
+  data between traces and are always traced on the calling thread afterwards.
+============
+*/
+void idClip::TraceBatch( clipTrace_t* traces, const int numTraces, bool parallel )
+{
+	int i, j, num, contentMask, numJobs, numTraceCalls;
+	idClipModel* touch, *clipModelList[MAX_GENTITIES];
+	idBounds totalBounds, traceBounds;
+	clipTraceJob_t jobs[MAX_TRACE_BATCH_JOBS];
+	
+	if( numTraces <= 0 )
+	{
+		return;
+	}
+	
+	numBatchedTraces.Add( numTraces );
+	
+	// bounds and contents of all traces
+	totalBounds.Clear();
+	contentMask = 0;
+	for( i = 0; i < numTraces; i++ )
+	{
+		if( ClipTraceIsPoint( traces[i].bounds ) )
+		{
+			traceBounds.FromPointTranslation( traces[i].start, traces[i].end - traces[i].start );
+		}
+		else
+		{
+			traceBounds.FromBoundsTranslation( traces[i].bounds, traces[i].start, mat3_identity, traces[i].end - traces[i].start );
+		}
+		totalBounds.AddBounds( traceBounds );
+		contentMask |= traces[i].contentMask;
+	}
+	
+	num = ClipModelsTouchingBounds( totalBounds, contentMask, clipModelList, MAX_GENTITIES );
+	if( num >= MAX_GENTITIES )
+	{
+		// the traces are spread out too far to share the clip models
+		for( i = 0; i < numTraces; i++ )
+		{
+			if( ClipTraceIsPoint( traces[i].bounds ) )
+			{
+				TracePoint( traces[i].results, traces[i].start, traces[i].end, traces[i].contentMask, traces[i].passEntity );
+			}
+			else
+			{
+				TraceBounds( traces[i].results, traces[i].start, traces[i].end, traces[i].bounds, traces[i].contentMask, traces[i].passEntity );
+			}
+		}
+		return;
+	}
+	
+	// split the candidates into job safe collision models and models that are traced on this thread
+	traceCandidates[0].num = traceCandidates[1].num = 0;
+	for( i = 0; i < num; i++ )
+	{
+		touch = clipModelList[i];
+		clipTraceCandidates_t& candidates = traceCandidates[( touch->renderModelHandle == -1 && touch->collisionModelHandle != 0 ) ? 0 : 1];
+		candidates.clipModels[candidates.num] = touch;
+		for( j = 0; j < 3; j++ )
+		{
+			candidates.bounds[j][candidates.num] = touch->absBounds[0][j];
+			candidates.bounds[3 + j][candidates.num] = touch->absBounds[1][j];
+		}
+		candidates.num++;
+	}
+	for( i = 0; i < 2; i++ )
+	{
+		clipTraceCandidates_t& candidates = traceCandidates[i];
+		for( j = candidates.num; j < MAX_GENTITIES && ( j & 3 ) != 0; j++ )
+		{
+			candidates.bounds[0][j] = candidates.bounds[1][j] = candidates.bounds[2][j] = idMath::INFINITY;
+			candidates.bounds[3][j] = candidates.bounds[4][j] = candidates.bounds[5][j] = -idMath::INFINITY;
+		}
+	}
+	
+	numTraceCalls = 0;
+	
+	if( parallel && g_parallelCollisionTraces.GetBool() && numTraces >= 2 * MIN_TRACES_PER_JOB )
+	{
+		int tracesPerJob = Max( MIN_TRACES_PER_JOB, ( numTraces + MAX_TRACE_BATCH_JOBS - 1 ) / MAX_TRACE_BATCH_JOBS );
+		
+		numJobs = 0;
+		for( i = 0; i < numTraces; i += tracesPerJob )
+		{
+			jobs[numJobs].clip = this;
+			jobs[numJobs].traces = traces + i;
+			jobs[numJobs].numTraces = Min( tracesPerJob, numTraces - i );
+			traceJobList->AddJob( ( jobRun_t )ClipTraceBatchJob, &jobs[numJobs] );
+			numJobs++;
+		}
+		traceJobList->Submit();
+		traceJobList->Wait();
+		
+		for( i = 0; i < numJobs; i++ )
+		{
+			numTraceCalls += jobs[i].numTraceCalls;
+		}
+	}
+	else
+	{
+		TraceBatchCandidates( traces, numTraces, traceCandidates[0], numTraceCalls );
+	}
+	
+	TraceBatchCandidates( traces, numTraces, traceCandidates[1], numTraceCalls );
+	
+	numTranslations.Add( numTraceCalls );
+}
+
 /*
 ============
 idClip::Rotation
@@ -1421,7 +2073,7 @@ bool idClip::Rotation( trace_t& results, const idVec3& start, const idRotation&
 	if( !passEntity || passEntity->entityNumber != ENTITYNUM_WORLD )
 	{
 		// test world
-		idClip::numRotations++;
+		idClip::numRotations.Increment();
 		collisionModelManager->Rotation( &results, start, rotation, trm, trmAxis, contentMask, 0, vec3_origin, mat3_default );
 		results.c.entityNum = results.fraction != 1.0f ? ENTITYNUM_WORLD : ENTITYNUM_NONE;
 		if( results.fraction == 0.0f )
@@ -1463,7 +2115,7 @@ bool idClip::Rotation( trace_t& results, const idVec3& start, const idRotation&
 			continue;
 		}
 		
-		idClip::numRotations++;
+		idClip::numRotations.Increment();
 		collisionModelManager->Rotation( &trace, start, rotation, trm, trmAxis, contentMask,
 										 touch->Handle(), touch->origin, touch->axis );
 										 
@@ -1536,7 +2188,7 @@ bool idClip::Motion( trace_t& results, const idVec3& start, const idVec3& end, c
 	if( !passEntity || passEntity->entityNumber != ENTITYNUM_WORLD )
 	{
 		// translational collision with world
-		idClip::numTranslations++;
+		idClip::numTranslations.Increment();
 		collisionModelManager->Translation( &translationalTrace, start, end, trm, trmAxis, contentMask, 0, vec3_origin, mat3_default );
 		translationalTrace.c.entityNum = translationalTrace.fraction != 1.0f ? ENTITYNUM_WORLD : ENTITYNUM_NONE;
 	}
@@ -1578,12 +2230,12 @@ bool idClip::Motion( trace_t& results, const idVec3& start, const idVec3& end, c
 			
 			if( touch->renderModelHandle != -1 )
 			{
-				idClip::numRenderModelTraces++;
+				idClip::numRenderModelTraces.Increment();
 				TraceRenderModel( trace, start, end, radius, trmAxis, touch );
 			}
 			else
 			{
-				idClip::numTranslations++;
+				idClip::numTranslations.Increment();
 				collisionModelManager->Translation( &trace, start, end, trm, trmAxis, contentMask,
 													touch->Handle(), touch->origin, touch->axis );
 			}
@@ -1612,7 +2264,7 @@ bool idClip::Motion( trace_t& results, const idVec3& start, const idVec3& end, c
 	if( !passEntity || passEntity->entityNumber != ENTITYNUM_WORLD )
 	{
 		// rotational collision with world
-		idClip::numRotations++;
+		idClip::numRotations.Increment();
 		collisionModelManager->Rotation( &rotationalTrace, endPosition, endRotation, trm, trmAxis, contentMask, 0, vec3_origin, mat3_default );
 		rotationalTrace.c.entityNum = rotationalTrace.fraction != 1.0f ? ENTITYNUM_WORLD : ENTITYNUM_NONE;
 	}
@@ -1648,7 +2300,7 @@ bool idClip::Motion( trace_t& results, const idVec3& start, const idVec3& end, c
 				continue;
 			}
 			
-			idClip::numRotations++;
+			idClip::numRotations.Increment();
 			collisionModelManager->Rotation( &trace, endPosition, endRotation, trm, trmAxis, contentMask,
 											 touch->Handle(), touch->origin, touch->axis );
 											 
@@ -1698,7 +2350,7 @@ int idClip::Contacts( contactInfo_t* contacts, const int maxContacts, const idVe
 	if( !passEntity || passEntity->entityNumber != ENTITYNUM_WORLD )
 	{
 		// test world
-		idClip::numContacts++;
+		idClip::numContacts.Increment();
 		numContacts = collisionModelManager->Contacts( contacts, maxContacts, start, dir, depth, trm, trmAxis, contentMask, 0, vec3_origin, mat3_default );
 	}
 	else
@@ -1744,7 +2396,7 @@ int idClip::Contacts( contactInfo_t* contacts, const int maxContacts, const idVe
 			continue;
 		}
 		
-		idClip::numContacts++;
+		idClip::numContacts.Increment();
 		n = collisionModelManager->Contacts( contacts + numContacts, maxContacts - numContacts,
 											 start, dir, depth, trm, trmAxis, contentMask,
 											 touch->Handle(), touch->origin, touch->axis );
@@ -1782,7 +2434,7 @@ int idClip::Contents( const idVec3& start, const idClipModel* mdl, const idMat3&
 	if( !passEntity || passEntity->entityNumber != ENTITYNUM_WORLD )
 	{
 		// test world
-		idClip::numContents++;
+		idClip::numContents.Increment();
 		contents = collisionModelManager->Contents( start, trm, trmAxis, contentMask, 0, vec3_origin, mat3_default );
 	}
 	else
@@ -1834,7 +2486,7 @@ int idClip::Contents( const idVec3& start, const idClipModel* mdl, const idMat3&
 			continue;
 		}
 		
-		idClip::numContents++;
+		idClip::numContents.Increment();
 		if( collisionModelManager->Contents( start, trm, trmAxis, contentMask, touch->Handle(), touch->origin, touch->axis ) )
 		{
 			contents |= ( touch->contents & contentMask );
@@ -1854,7 +2506,7 @@ void idClip::TranslationModel( trace_t& results, const idVec3& start, const idVe
 							   cmHandle_t model, const idVec3& modelOrigin, const idMat3& modelAxis )
 {
 	const idTraceModel* trm = TraceModelForClipModel( mdl );
-	idClip::numTranslations++;
+	idClip::numTranslations.Increment();
 	collisionModelManager->Translation( &results, start, end, trm, trmAxis, contentMask, model, modelOrigin, modelAxis );
 }
 
@@ -1868,7 +2520,7 @@ void idClip::RotationModel( trace_t& results, const idVec3& start, const idRotat
 							cmHandle_t model, const idVec3& modelOrigin, const idMat3& modelAxis )
 {
 	const idTraceModel* trm = TraceModelForClipModel( mdl );
-	idClip::numRotations++;
+	idClip::numRotations.Increment();
 	collisionModelManager->Rotation( &results, start, rotation, trm, trmAxis, contentMask, model, modelOrigin, modelAxis );
 }
 
@@ -1882,7 +2534,7 @@ int idClip::ContactsModel( contactInfo_t* contacts, const int maxContacts, const
 						   cmHandle_t model, const idVec3& modelOrigin, const idMat3& modelAxis )
 {
 	const idTraceModel* trm = TraceModelForClipModel( mdl );
-	idClip::numContacts++;
+	idClip::numContacts.Increment();
 	return collisionModelManager->Contacts( contacts, maxContacts, start, dir, depth, trm, trmAxis, contentMask, model, modelOrigin, modelAxis );
 }
 
@@ -1896,7 +2548,7 @@ int idClip::ContentsModel( const idVec3& start,
 						   cmHandle_t model, const idVec3& modelOrigin, const idMat3& modelAxis )
 {
 	const idTraceModel* trm = TraceModelForClipModel( mdl );
-	idClip::numContents++;
+	idClip::numContents.Increment();
 	return collisionModelManager->Contents( start, trm, trmAxis, contentMask, model, modelOrigin, modelAxis );
 }
 
@@ -1977,6 +2629,55 @@ bool idClip::GetModelContactFeature( const contactInfo_t& contact, const idClipM
 	return true;
 }
 
+/*
+============
+idClip::BeginIsland
+============
+*/
+void idClip::BeginIsland( clipIsland_t& island )
+{
+	for( int i = 0; i < island.clipModels.Num(); i++ )
+	{
+		island.clipModels[i]->island = &island;
+	}
+}
+
+/*
+============
+idClip::EndIsland
+
+  moves the proxies of the island clip models to where the models were last linked
+============
+*/
+void idClip::EndIsland( clipIsland_t& island )
+{
+	for( int i = 0; i < island.clipModels.Num(); i++ )
+	{
+		idClipModel* clipModel = island.clipModels[i];
+		
+		clipModel->island = NULL;
+		if( clipModel->clipTree != NULL )
+		{
+			clipModel->Link( *clipModel->clipTree );
+		}
+		else if( clipModel->clipProxy != -1 )
+		{
+			DestroyClipProxy( clipModel->clipProxy );
+			clipModel->clipProxy = -1;
+		}
+	}
+}
+
+/*
+============
+idClip::SetThreadIsland
+============
+*/
+void idClip::SetThreadIsland( const clipIsland_t* island )
+{
+	clipThreadIsland = ( ptrdiff_t )island;
+}
+
 /*
 ============
 idClip::PrintStatistics
@@ -1984,9 +2685,163 @@ idClip::PrintStatistics
 */
 void idClip::PrintStatistics()
 {
-	gameLocal.Printf( "t = %-3d, r = %-3d, m = %-3d, render = %-3d, contents = %-3d, contacts = %-3d\n",
-					  numTranslations, numRotations, numMotions, numRenderModelTraces, numContents, numContacts );
-	numRotations = numTranslations = numMotions = numRenderModelTraces = numContents = numContacts = 0;
+	const int boundsQueries = numBoundsQueries.GetValue();
+	const int boundsCandidates = numBoundsCandidates.GetValue();
+	gameLocal.Printf( "t = %-3d, r = %-3d, m = %-3d, render = %-3d, contents = %-3d, contacts = %-3d, batched = %-3d\n",
+					  numTranslations.GetValue(), numRotations.GetValue(), numMotions.GetValue(), numRenderModelTraces.GetValue(),
+					  numContents.GetValue(), numContacts.GetValue(), numBatchedTraces.GetValue() );
+	gameLocal.Printf( "bounds queries = %-3d, candidates = %-3d (%1.1f per query), clip nodes = %d\n", boundsQueries, boundsCandidates,
+					  boundsQueries ? ( float )boundsCandidates / boundsQueries : 0.0f, numClipNodes );
+	ClearStatistics();
+}
+
+/*
+============
+idClip::ClearStatistics
+============
+*/
+void idClip::ClearStatistics()
+{
+	numRotations.SetValue( 0 );
+	numTranslations.SetValue( 0 );
+	numMotions.SetValue( 0 );
+	numRenderModelTraces.SetValue( 0 );
+	numContents.SetValue( 0 );
+	numContacts.SetValue( 0 );
+	numBatchedTraces.SetValue( 0 );
+	numBoundsQueries.SetValue( 0 );
+	numBoundsCandidates.SetValue( 0 );
+}
+
+/*
+============
+idClip::RecordTrace
+============
+*/
+void idClip::RecordTrace( const idVec3& start, const idVec3& end, const idTraceModel* trm, const idMat3& trmAxis, int contentMask, const idEntity* passEntity ) const
+{
+	clipRecordedTrace_t recorded;
+	
+	if( recordedTraces.Num() >= MAX_RECORDED_TRACES )
+	{
+		return;
+	}
+	
+	// only point and axial box traces can be replayed as a batch
+	if( !trm )
+	{
+		recorded.bounds.Zero();
+	}
+	else if( trm->type == TRM_BOX && !trmAxis.IsRotated() )
+	{
+		recorded.bounds = trm->bounds;
+	}
+	else
+	{
+		return;
+	}
+	
+	recorded.start = start;
+	recorded.end = end;
+	recorded.contentMask = contentMask;
+	recorded.passEntityNum = passEntity ? passEntity->entityNumber : ENTITYNUM_NONE;
+	recordedTraces.Append( recorded );
+}
+
+/*
+============
+idClip::ClearRecordedTraces
+============
+*/
+void idClip::ClearRecordedTraces()
+{
+	recordedTraces.Clear();
+}
+
+/*
+============
+idClip::BenchmarkRecordedTraces
+
+  Replays the recorded traces one at a time and as a batch and compares the results.
+============
+*/
+void idClip::BenchmarkRecordedTraces( int iterations )
+{
+	int i, j, numBatchErrors, numParallelErrors;
+	uint64 startTime, singleTime, batchTime, parallelTime;
+	idList<clipTrace_t> traces;
+	idList<trace_t> results;
+	
+	if( recordedTraces.Num() == 0 )
+	{
+		gameLocal.Printf( "no recorded traces, set g_recordCollisionTraces to 1 to record traces\n" );
+		return;
+	}
+	
+	const bool recording = g_recordCollisionTraces.GetBool();
+	g_recordCollisionTraces.SetBool( false );
+	
+	traces.SetNum( recordedTraces.Num() );
+	results.SetNum( recordedTraces.Num() );
+	for( i = 0; i < recordedTraces.Num(); i++ )
+	{
+		const clipRecordedTrace_t& recorded = recordedTraces[i];
+		traces[i].start = recorded.start;
+		traces[i].end = recorded.end;
+		traces[i].bounds = recorded.bounds;
+		traces[i].contentMask = recorded.contentMask;
+		traces[i].passEntity = ( recorded.passEntityNum >= 0 && recorded.passEntityNum < MAX_GENTITIES ) ? gameLocal.entities[recorded.passEntityNum] : NULL;
+	}
+	
+	singleTime = batchTime = parallelTime = 0;
+	numBatchErrors = numParallelErrors = 0;
+	for( i = 0; i < iterations; i++ )
+	{
+		startTime = Sys_Microseconds();
+		for( j = 0; j < traces.Num(); j++ )
+		{
+			if( ClipTraceIsPoint( traces[j].bounds ) )
+			{
+				TracePoint( results[j], traces[j].start, traces[j].end, traces[j].contentMask, traces[j].passEntity );
+			}
+			else
+			{
+				TraceBounds( results[j], traces[j].start, traces[j].end, traces[j].bounds, traces[j].contentMask, traces[j].passEntity );
+			}
+		}
+		singleTime += Sys_Microseconds() - startTime;
+		
+		startTime = Sys_Microseconds();
+		TraceBatch( traces.Ptr(), traces.Num(), false );
+		batchTime += Sys_Microseconds() - startTime;
+		
+		for( j = 0; j < traces.Num(); j++ )
+		{
+			if( idMath::Fabs( traces[j].results.fraction - results[j].fraction ) > 1e-4f )
+			{
+				numBatchErrors++;
+			}
+		}
+		
+		startTime = Sys_Microseconds();
+		TraceBatch( traces.Ptr(), traces.Num(), true );
+		parallelTime += Sys_Microseconds() - startTime;
+		
+		for( j = 0; j < traces.Num(); j++ )
+		{
+			if( idMath::Fabs( traces[j].results.fraction - results[j].fraction ) > 1e-4f )
+			{
+				numParallelErrors++;
+			}
+		}
+	}
+	
+	g_recordCollisionTraces.SetBool( recording );
+	
+	gameLocal.Printf( "%d traces, %d iterations\n", traces.Num(), iterations );
+	gameLocal.Printf( "single:   %6d usec\n", ( int )( singleTime / iterations ) );
+	gameLocal.Printf( "batch:    %6d usec, %d mismatches\n", ( int )( batchTime / iterations ), numBatchErrors );
+	gameLocal.Printf( "parallel: %6d usec, %d mismatches\n", ( int )( parallelTime / iterations ), numParallelErrors );
 }
 
 /*
@@ -44,6 +44,12 @@ class idClip;
 class idClipModel;
 class idEntity;
 
+// clip models that move on a single thread while the clip model tree stays read-only
+typedef struct clipIsland_s
+{
+	idList<idClipModel*>	clipModels;
+} clipIsland_t;
+
 //===============================================================
 //
 //	idClipModel
@@ -73,7 +79,7 @@ public:
 	
 	void					Link( idClip& clp );				// must have been linked with an entity and id before
 	void					Link( idClip& clp, idEntity* ent, int newId, const idVec3& newOrigin, const idMat3& newAxis, int renderModelHandle = -1 );
-	void					Unlink();						// unlink from sectors
+	void					Unlink();						// unlink from the clip model tree
 	void					SetPosition( const idVec3& newOrigin, const idMat3& newAxis );	// unlinks the clip model
 	void					Translate( const idVec3& translation );							// unlinks the clip model
 	void					Rotate( const idRotation& rotation );							// unlinks the clip model
@@ -124,11 +130,11 @@ private:
 	int						traceModelIndex;		// trace model used for collision detection
 	int						renderModelHandle;		// render model def handle
 	
-	struct clipLink_s* 		clipLinks;				// links into sectors
-	int						touchCount;
+	idClip* 				clipTree;				// clip the model is linked into
+	int						clipProxy;				// leaf node in the clip model tree, -1 if not linked
+	clipIsland_t* 			island;					// island the model moves in, tree links are deferred while set
 	
 	void					Init();			// initialize
-	void					Link_r( struct clipSector_s* node );
 	
 	static int				AllocTraceModel( const idTraceModel& trm, bool persistantThroughSaves = true );
 	static void				FreeTraceModel( int traceModelIndex );
@@ -243,7 +249,7 @@ ID_INLINE bool idClipModel::IsTraceModel() const
 
 ID_INLINE bool idClipModel::IsLinked() const
 {
-	return ( clipLinks != NULL );
+	return ( clipTree != NULL );
 }
 
 ID_INLINE bool idClipModel::IsEnabled() const
@@ -272,10 +278,22 @@ ID_INLINE const idTraceModel* idClipModel::GetTraceModel() const
 //
 //===============================================================
 
+// point or bounds translation for idClip::TraceBatch, zero sized bounds trace a point
+typedef struct clipTrace_s
+{
+	idVec3					start;
+	idVec3					end;
+	idBounds				bounds;			// bounds relative to the start and end position
+	int						contentMask;
+	const idEntity* 		passEntity;
+	trace_t					results;
+} clipTrace_t;
+
 class idClip
 {
 
 	friend class idClipModel;
+	friend void ClipTraceBatchJob( struct clipTraceJob_s* job );
 	
 public:
 	idClip();
@@ -300,7 +318,9 @@ public:
 										int contentMask, const idEntity* passEntity );
 	bool					TraceBounds( trace_t& results, const idVec3& start, const idVec3& end, const idBounds& bounds,
 										 int contentMask, const idEntity* passEntity );
-										 
+	// multiple point and bounds translations that share the clip model gathering, optionally spread over the job threads
+	void					TraceBatch( clipTrace_t* traces, const int numTraces, bool parallel );
+	
 	// clip versus a specific model
 	void					TranslationModel( trace_t& results, const idVec3& start, const idVec3& end,
 			const idClipModel* mdl, const idMat3& trmAxis, int contentMask,
@@ -331,30 +351,56 @@ public:
 	
 	// stats and debug drawing
 	void					PrintStatistics();
+	void					BenchmarkRecordedTraces( int iterations );
+	void					ClearRecordedTraces();
 	void					DrawClipModels( const idVec3& eye, const float radius, const idEntity* passEntity );
 	bool					DrawModelContactFeature( const contactInfo_t& contact, const idClipModel* clipModel, int lifetime ) const;
 	
+	// islands of clip models that link and unlink without touching the clip model tree,
+	// queries from a thread only see the clip models of the island set for that thread
+	void					BeginIsland( clipIsland_t& island );
+	void					EndIsland( clipIsland_t& island );
+	static void				SetThreadIsland( const clipIsland_t* island );
+	
 private:
-	int						numClipSectors;
-	struct clipSector_s* 	clipSectors;
+	// dynamic bounds tree with a leaf for every linked clip model
+	struct clipNode_s* 		clipNodes;
+	int						maxClipNodes;
+	int						numClipNodes;
+	int						freeClipNode;
+	int						rootClipNode;
 	idBounds				worldBounds;
 	idClipModel				temporaryClipModel;
 	idClipModel				defaultClipModel;
-	mutable int				touchCount;
-	// statistics
-	int						numTranslations;
-	int						numRotations;
-	int						numMotions;
-	int						numRenderModelTraces;
-	int						numContents;
-	int						numContacts;
+	// batched traces
+	struct clipTraceCandidates_s* traceCandidates;
+	idParallelJobList* 		traceJobList;
+	// statistics, counted from the physics and trace jobs as well
+	idSysInterlockedInteger	numTranslations;
+	idSysInterlockedInteger	numRotations;
+	idSysInterlockedInteger	numMotions;
+	idSysInterlockedInteger	numRenderModelTraces;
+	idSysInterlockedInteger	numContents;
+	idSysInterlockedInteger	numContacts;
+	idSysInterlockedInteger	numBatchedTraces;
+	mutable idSysInterlockedInteger	numBoundsQueries;
+	mutable idSysInterlockedInteger	numBoundsCandidates;
 	
 private:
-	struct clipSector_s* 	CreateClipSectors_r( const int depth, const idBounds& bounds, idVec3& maxSector );
-	void					ClipModelsTouchingBounds_r( const struct clipSector_s* node, struct listParms_s& parms ) const;
+	void					ClearStatistics();
+	int						AllocClipNode();
+	void					FreeClipNode( int nodeNum );
+	int						CreateClipProxy( idClipModel* clipModel );
+	void					DestroyClipProxy( int proxy );
+	void					MoveClipProxy( int proxy );
+	void					InsertClipLeaf( int leaf );
+	void					RemoveClipLeaf( int leaf );
+	int						BalanceClipNode( int nodeNum );
 	const idTraceModel* 	TraceModelForClipModel( const idClipModel* mdl ) const;
 	int						GetTraceClipModels( const idBounds& bounds, int contentMask, const idEntity* passEntity, idClipModel** clipModelList ) const;
 	void					TraceRenderModel( trace_t& trace, const idVec3& start, const idVec3& end, const float radius, const idMat3& axis, idClipModel* touch ) const;
+	void					TraceBatchCandidates( clipTrace_t* traces, const int numTraces, const struct clipTraceCandidates_s& candidates, int& numTraceCalls ) const;
+	void					RecordTrace( const idVec3& start, const idVec3& end, const idTraceModel* trm, const idMat3& trmAxis, int contentMask, const idEntity* passEntity ) const;
 };
 
 
@@ -0,0 +1,879 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#pragma hdrstop
+#include "precompiled.h"
+
+#include "../Game_local.h"
+
+#define ISLAND_BOUNDS_MARGIN			4.0f		// extra distance kept between bodies in separate islands
+
+const static int			MAX_ISLAND_JOBS = 32;
+const static int			MIN_ISLAND_JOB_ENTITIES = 4;
+
+typedef enum
+{
+	ISLANDCALL_COLLIDE,
+	ISLANDCALL_APPLY_IMPULSE,
+	ISLANDCALL_ADD_CONTACT_ENTITY,
+	ISLANDCALL_ACTIVATE_PHYSICS,
+	ISLANDCALL_BECOME_ACTIVE,
+	ISLANDCALL_BECOME_INACTIVE,
+	ISLANDCALL_WARNING,
+	ISLANDCALL_DWARNING
+} islandCallType_t;
+
+// entity call from physics evaluation that waits until all islands are done
+typedef struct physicsIslandCall_s
+{
+	islandCallType_t		type;
+	idEntityPtr<idEntity>	ent;
+	idEntityPtr<idEntity>	other;
+	int						id;				// clip model id or think flags
+	idVec3					point;
+	idVec3					vec;			// impulse or collision velocity
+	trace_t					collision;
+	idStr					text;
+} physicsIslandCall_t;
+
+typedef struct physicsIsland_s
+{
+	int						index;
+	bool					mainThread;		// articulated figures touching other entities are evaluated in order on the game thread
+	idPhysics_AF* 			articulatedFigure;	// lone articulated figure that is only solved on a job
+	bool					solve;			// true if the lone articulated figure is not at rest
+	idList<idEntity*>		entities;		// in active entity order
+	clipIsland_t			clip;
+	idList<physicsIslandCall_t> calls;
+} physicsIsland_t;
+
+typedef struct physicsIslandEntity_s
+{
+	int						island;			// candidate number while building islands, island number while evaluating, -1 otherwise
+	int						frame;			// frame the physics were evaluated on an island
+	int						spawnId;
+	bool					moved;
+} physicsIslandEntity_t;
+
+// contiguous range of islands evaluated on a job thread
+typedef struct physicsIslandJob_s
+{
+	idPhysicsIslands* 		physicsIslands;
+	int						firstIsland;
+	int						numIslands;
+} physicsIslandJob_t;
+
+static ID_TLS				threadIsland;		// island evaluated by the calling thread
+
+/*
+============
+ThreadIsland
+============
+*/
+static ID_INLINE physicsIsland_t* ThreadIsland()
+{
+	return ( physicsIsland_t* )( ptrdiff_t )threadIsland;
+}
+
+/*
+============
+IslandRoot
+============
+*/
+static ID_INLINE int IslandRoot( int* parents, int i )
+{
+	while( parents[i] != i )
+	{
+		parents[i] = parents[parents[i]];
+		i = parents[i];
+	}
+	return i;
+}
+
+/*
+============
+PhysicsIslandJob
+============
+*/
+void PhysicsIslandJob( physicsIslandJob_t* job )
+{
+	for( int i = job->firstIsland; i < job->firstIsland + job->numIslands; i++ )
+	{
+		physicsIsland_t* island = job->physicsIslands->islands[i];
+		if( !island->mainThread && ( island->articulatedFigure == NULL || island->solve ) )
+		{
+			job->physicsIslands->EvaluateIsland( *island );
+		}
+	}
+}
+
+REGISTER_PARALLEL_JOB( PhysicsIslandJob, "PhysicsIslandJob" );
+
+/*
+============
+idPhysicsIslands::idPhysicsIslands
+============
+*/
+idPhysicsIslands::idPhysicsIslands()
+{
+	lastFrame = -1;
+	entities = NULL;
+	numIslands = 0;
+	jobs = NULL;
+	jobList = NULL;
+}
+
+/*
+============
+idPhysicsIslands::Init
+============
+*/
+void idPhysicsIslands::Init()
+{
+	entities = new( TAG_PHYSICS ) physicsIslandEntity_t[MAX_GENTITIES];
+	for( int i = 0; i < MAX_GENTITIES; i++ )
+	{
+		entities[i].island = -1;
+		entities[i].frame = -1;
+		entities[i].spawnId = 0;
+		entities[i].moved = false;
+	}
+	
+	jobs = new( TAG_PHYSICS ) physicsIslandJob_t[MAX_ISLAND_JOBS];
+	jobList = parallelJobManager->AllocJobList( JOBLIST_GAME, JOBLIST_PRIORITY_MEDIUM, MAX_ISLAND_JOBS, 0, NULL );
+	
+	lastFrame = -1;
+	numIslands = 0;
+}
+
+/*
+============
+idPhysicsIslands::Shutdown
+============
+*/
+void idPhysicsIslands::Shutdown()
+{
+	delete[] entities;
+	entities = NULL;
+	
+	delete[] jobs;
+	jobs = NULL;
+	
+	if( jobList != NULL )
+	{
+		parallelJobManager->FreeJobList( jobList );
+		jobList = NULL;
+	}
+	
+	islands.DeleteContents( true );
+	candidates.Clear();
+	candidateParents.Clear();
+	candidateBounds.Clear();
+	numIslands = 0;
+}
+
+/*
+============
+idPhysicsIslands::IsCandidate
+
+  only entities that do nothing but run physics before their physics are evaluated
+============
+*/
+bool idPhysicsIslands::IsCandidate( idEntity* ent ) const
+{
+	if( ent->timeGroup != TIME_GROUP1 || !( ent->thinkFlags & TH_PHYSICS ) )
+	{
+		return false;
+	}
+	
+	// physics teams are moved together by the team master
+	if( ent->GetTeamMaster() != NULL || ent->GetBindMaster() != NULL )
+	{
+		return false;
+	}
+	
+	idPhysics* physics = ent->GetPhysics();
+	if( physics == NULL || physics->IsAtRest() )
+	{
+		return false;
+	}
+	
+	if( physics->IsType( idPhysics_RigidBody::Type ) )
+	{
+		// moveables following a spline set their velocity before running physics,
+		// barrels check if they are at rest before running physics
+		return ( ent->IsType( idMoveable::Type ) && !ent->IsType( idBarrel::Type ) && !( ent->thinkFlags & TH_THINK ) );
+	}
+	
+	if( physics->IsType( idPhysics_AF::Type ) )
+	{
+		return ent->IsType( idAFEntity_Generic::Type );
+	}
+	
+	return false;
+}
+
+/*
+============
+idPhysicsIslands::GatherCandidates
+============
+*/
+void idPhysicsIslands::GatherCandidates( idEntity* first )
+{
+	candidates.SetNum( 0 );
+	for( idEntity* ent = first; ent != NULL; ent = ent->activeNode.Next() )
+	{
+		if( IsCandidate( ent ) )
+		{
+			candidates.Append( ent );
+		}
+	}
+}
+
+/*
+============
+idPhysicsIslands::BuildIslands
+
+  Candidates end up in the same island when the bounds they can move through
+  this frame overlap or when they were in contact after the previous frame.
+  Islands are numbered in active entity order so the results don't depend on
+  the number of threads.
+============
+*/
+void idPhysicsIslands::BuildIslands()
+{
+	int i, j, k, root, other;
+	float timeStep, speed;
+	idEntity* ent;
+	idPhysics* physics;
+	idClipModel* clipModel;
+	physicsIsland_t* island;
+	
+	// only players use a different physics time step
+	timeStep = MS2SEC( gameLocal.time - gameLocal.previousTime );
+	
+	candidateParents.SetNum( candidates.Num() );
+	candidateBounds.SetNum( candidates.Num() );
+	
+	// bounds of everything each candidate can touch this frame
+	for( i = 0; i < candidates.Num(); i++ )
+	{
+		ent = candidates[i];
+		physics = ent->GetPhysics();
+		
+		speed = 0.0f;
+		for( j = 0; j < physics->GetNumClipModels(); j++ )
+		{
+			clipModel = physics->GetClipModel( j );
+			if( clipModel != NULL )
+			{
+				speed = Max( speed, physics->GetLinearVelocity( j ).Length() + physics->GetAngularVelocity( j ).Length() * clipModel->GetBounds().GetRadius() );
+			}
+		}
+		speed += physics->GetGravity().Length() * timeStep;
+		
+		candidateBounds[i] = physics->GetAbsBounds().Expand( speed * timeStep + ISLAND_BOUNDS_MARGIN );
+		candidateParents[i] = i;
+		entities[ent->entityNumber].island = i;
+	}
+	
+	// join candidates that can touch each other
+	for( i = 0; i < candidates.Num(); i++ )
+	{
+		for( j = i + 1; j < candidates.Num(); j++ )
+		{
+			if( candidateBounds[i].IntersectsBounds( candidateBounds[j] ) )
+			{
+				root = IslandRoot( candidateParents.Ptr(), i );
+				other = IslandRoot( candidateParents.Ptr(), j );
+				candidateParents[Max( root, other )] = Min( root, other );
+			}
+		}
+	}
+	
+	// join candidates that were in contact
+	for( i = 0; i < candidates.Num(); i++ )
+	{
+		physics = candidates[i]->GetPhysics();
+		for( j = 0; j < physics->GetNumContacts(); j++ )
+		{
+			k = physics->GetContact( j ).entityNum;
+			if( k < 0 || k >= MAX_GENTITIES || entities[k].island == -1 )
+			{
+				continue;
+			}
+			root = IslandRoot( candidateParents.Ptr(), i );
+			other = IslandRoot( candidateParents.Ptr(), entities[k].island );
+			candidateParents[Max( root, other )] = Min( root, other );
+		}
+	}
+	
+	// every root is the first candidate of its island
+	numIslands = 0;
+	for( i = 0; i < candidates.Num(); i++ )
+	{
+		ent = candidates[i];
+		root = IslandRoot( candidateParents.Ptr(), i );
+		if( root == i )
+		{
+			if( numIslands >= islands.Num() )
+			{
+				islands.Append( new( TAG_PHYSICS ) physicsIsland_t );
+			}
+			island = islands[numIslands];
+			island->index = numIslands++;
+			island->mainThread = false;
+			island->articulatedFigure = NULL;
+			island->solve = false;
+			island->entities.SetNum( 0 );
+			island->clip.clipModels.SetNum( 0 );
+			island->calls.SetNum( 0 );
+		}
+		else
+		{
+			island = islands[entities[candidates[root]->entityNumber].island];
+		}
+		
+		entities[ent->entityNumber].island = island->index;
+		island->entities.Append( ent );
+		
+		physics = ent->GetPhysics();
+		for( j = 0; j < physics->GetNumClipModels(); j++ )
+		{
+			clipModel = physics->GetClipModel( j );
+			if( clipModel != NULL )
+			{
+				island->clip.clipModels.Append( clipModel );
+			}
+		}
+	}
+	
+	// articulated figures on their own are solved on a job, together with other entities they are evaluated in order
+	for( i = 0; i < numIslands; i++ )
+	{
+		island = islands[i];
+		for( j = 0; j < island->entities.Num(); j++ )
+		{
+			physics = island->entities[j]->GetPhysics();
+			if( !physics->IsType( idPhysics_AF::Type ) )
+			{
+				continue;
+			}
+			// the articulated figure timings are shared by all figures
+			if( island->entities.Num() == 1 && !af_showTimings.GetBool() )
+			{
+				island->articulatedFigure = static_cast<idPhysics_AF*>( physics );
+			}
+			else
+			{
+				island->mainThread = true;
+			}
+		}
+	}
+}
+
+/*
+============
+idPhysicsIslands::PrepareIsland
+
+  gathers the contacts of a lone articulated figure on the game thread
+============
+*/
+void idPhysicsIslands::PrepareIsland( physicsIsland_t& island )
+{
+	idEntity* ent = island.entities[0];
+	
+	threadIsland = ( ptrdiff_t )&island;
+	idClip::SetThreadIsland( &island.clip );
+	
+	if( !ent->fl.solidForTeam )
+	{
+		island.articulatedFigure->DisableClip();
+	}
+	island.articulatedFigure->SaveState();
+	
+	island.solve = island.articulatedFigure->PrepareEvaluate( gameLocal.time - gameLocal.previousTime, gameLocal.time );
+	
+	idClip::SetThreadIsland( NULL );
+	threadIsland = 0;
+}
+
+/*
+============
+idPhysicsIslands::FinishIsland
+
+  applies the solve of a lone articulated figure on the game thread
+============
+*/
+void idPhysicsIslands::FinishIsland( physicsIsland_t& island )
+{
+	idEntity* ent = island.entities[0];
+	
+	threadIsland = ( ptrdiff_t )&island;
+	idClip::SetThreadIsland( &island.clip );
+	
+	if( island.solve )
+	{
+		island.articulatedFigure->FinishEvaluate( gameLocal.time );
+	}
+	
+	if( !ent->fl.solidForTeam )
+	{
+		island.articulatedFigure->EnableClip();
+	}
+	
+	physicsIslandEntity_t& result = entities[ent->entityNumber];
+	result.frame = gameLocal.framenum;
+	result.spawnId = gameLocal.GetSpawnId( ent );
+	result.moved = island.solve;
+	
+	idClip::SetThreadIsland( NULL );
+	threadIsland = 0;
+}
+
+/*
+============
+idPhysicsIslands::EvaluateIsland
+============
+*/
+void idPhysicsIslands::EvaluateIsland( physicsIsland_t& island )
+{
+	const int timeStep = gameLocal.time - gameLocal.previousTime;
+	
+	threadIsland = ( ptrdiff_t )&island;
+	idClip::SetThreadIsland( &island.clip );
+	
+	// the contacts and results of a lone articulated figure are handled on the game thread
+	if( island.articulatedFigure != NULL )
+	{
+		island.articulatedFigure->SolveEvaluate( gameLocal.time );
+		
+		idClip::SetThreadIsland( NULL );
+		threadIsland = 0;
+		return;
+	}
+	
+	for( int i = 0; i < island.entities.Num(); i++ )
+	{
+		idEntity* ent = island.entities[i];
+		idPhysics* physics = ent->GetPhysics();
+		
+		// same as idEntity::RunPhysics for an entity without a team
+		if( !ent->fl.solidForTeam )
+		{
+			physics->DisableClip();
+		}
+		physics->SaveState();
+		
+		const bool moved = physics->Evaluate( timeStep, gameLocal.time );
+		
+		if( !ent->fl.solidForTeam )
+		{
+			physics->EnableClip();
+		}
+		
+		physicsIslandEntity_t& result = entities[ent->entityNumber];
+		result.frame = gameLocal.framenum;
+		result.spawnId = gameLocal.GetSpawnId( ent );
+		result.moved = moved;
+	}
+	
+	idClip::SetThreadIsland( NULL );
+	threadIsland = 0;
+}
+
+/*
+============
+idPhysicsIslands::FlushIsland
+============
+*/
+void idPhysicsIslands::FlushIsland( physicsIsland_t& island )
+{
+	for( int i = 0; i < island.calls.Num(); i++ )
+	{
+		const physicsIslandCall_t& call = island.calls[i];
+		idEntity* ent = call.ent.GetEntity();
+		idEntity* other = call.other.GetEntity();
+		
+		switch( call.type )
+		{
+			case ISLANDCALL_COLLIDE:
+				if( ent != NULL )
+				{
+					ent->Collide( call.collision, call.vec );
+				}
+				break;
+			case ISLANDCALL_APPLY_IMPULSE:
+				if( ent != NULL && other != NULL )
+				{
+					ent->ApplyImpulse( other, call.id, call.point, call.vec );
+				}
+				break;
+			case ISLANDCALL_ADD_CONTACT_ENTITY:
+				if( ent != NULL && other != NULL )
+				{
+					ent->AddContactEntity( other );
+				}
+				break;
+			case ISLANDCALL_ACTIVATE_PHYSICS:
+				if( ent != NULL && other != NULL )
+				{
+					ent->ActivatePhysics( other );
+				}
+				break;
+			case ISLANDCALL_BECOME_ACTIVE:
+				if( ent != NULL )
+				{
+					ent->BecomeActive( call.id );
+				}
+				break;
+			case ISLANDCALL_BECOME_INACTIVE:
+				if( ent != NULL )
+				{
+					ent->BecomeInactive( call.id );
+				}
+				break;
+			case ISLANDCALL_WARNING:
+				gameLocal.Warning( "%s", call.text.c_str() );
+				break;
+			case ISLANDCALL_DWARNING:
+				gameLocal.DWarning( "%s", call.text.c_str() );
+				break;
+		}
+	}
+	island.calls.SetNum( 0 );
+}
+
+/*
+============
+idPhysicsIslands::Run
+
+  Called for every thinking entity, the islands are built and evaluated once per
+  frame when the first candidate is about to think. Pushers and actors are sorted
+  to the front of the active entities so they have moved by then.
+============
+*/
+void idPhysicsIslands::Run( idEntity* ent )
+{
+	int i, numJobs, numJobEntities, jobEntities, entitiesPerJob;
+	physicsIslandJob_t* job;
+	physicsIsland_t* island;
+	idTimer timer;
+	
+	if( lastFrame == gameLocal.framenum )
+	{
+		return;
+	}
+	
+	// the rigid body debug drawing is not thread safe
+	if( !g_parallelPhysics.GetBool() || common->IsClient() || rb_showBodies.GetBool() || rb_showMass.GetBool() ||
+			rb_showInertia.GetBool() || rb_showVelocity.GetBool() || rb_showActive.GetBool() )
+	{
+		lastFrame = gameLocal.framenum;
+		return;
+	}
+	
+	if( !IsCandidate( ent ) )
+	{
+		return;
+	}
+	lastFrame = gameLocal.framenum;
+	
+	timer.Start();
+	
+	GatherCandidates( ent );
+	BuildIslands();
+	
+	for( i = 0; i < numIslands; i++ )
+	{
+		gameLocal.clip.BeginIsland( islands[i]->clip );
+	}
+	
+	// gather the contacts of the lone articulated figures before any job runs
+	for( i = 0; i < numIslands; i++ )
+	{
+		if( islands[i]->articulatedFigure != NULL )
+		{
+			PrepareIsland( *islands[i] );
+		}
+	}
+	
+	// spread the rigid body islands over jobs with a similar number of entities, every articulated figure gets its own job
+	numJobs = 0;
+	numJobEntities = 0;
+	for( i = 0; i < numIslands; i++ )
+	{
+		if( !islands[i]->mainThread && islands[i]->articulatedFigure == NULL )
+		{
+			numJobEntities += islands[i]->entities.Num();
+		}
+	}
+	entitiesPerJob = Max( MIN_ISLAND_JOB_ENTITIES, ( numJobEntities + MAX_ISLAND_JOBS - 1 ) / MAX_ISLAND_JOBS );
+	job = NULL;
+	jobEntities = 0;
+	for( i = 0; i < numIslands; i++ )
+	{
+		island = islands[i];
+		if( island->mainThread || ( island->articulatedFigure != NULL && !island->solve ) )
+		{
+			continue;
+		}
+		if( job == NULL || ( numJobs < MAX_ISLAND_JOBS && ( jobEntities >= entitiesPerJob || island->articulatedFigure != NULL ) ) )
+		{
+			job = &jobs[numJobs++];
+			job->physicsIslands = this;
+			job->firstIsland = i;
+			jobEntities = 0;
+		}
+		job->numIslands = i + 1 - job->firstIsland;
+		jobEntities += ( island->articulatedFigure != NULL ) ? entitiesPerJob : island->entities.Num();
+	}
+	
+	if( numJobs > 1 )
+	{
+		for( i = 0; i < numJobs; i++ )
+		{
+			jobList->AddJob( ( jobRun_t )PhysicsIslandJob, &jobs[i] );
+		}
+		jobList->Submit();
+	}
+	else if( numJobs == 1 )
+	{
+		PhysicsIslandJob( &jobs[0] );
+	}
+	
+	// islands where articulated figures touch other entities are evaluated on the game thread while the jobs run
+	for( i = 0; i < numIslands; i++ )
+	{
+		if( islands[i]->mainThread )
+		{
+			EvaluateIsland( *islands[i] );
+		}
+	}
+	
+	if( numJobs > 1 )
+	{
+		jobList->Wait();
+	}
+	
+	// apply the results of the lone articulated figures in island order
+	for( i = 0; i < numIslands; i++ )
+	{
+		if( islands[i]->articulatedFigure != NULL )
+		{
+			FinishIsland( *islands[i] );
+		}
+	}
+	
+	// link the clip models into the tree at their new positions
+	for( i = 0; i < numIslands; i++ )
+	{
+		gameLocal.clip.EndIsland( islands[i]->clip );
+	}
+	for( i = 0; i < candidates.Num(); i++ )
+	{
+		entities[candidates[i]->entityNumber].island = -1;
+	}
+	
+	// run the calls that reached outside the islands in island order
+	for( i = 0; i < numIslands; i++ )
+	{
+		FlushIsland( *islands[i] );
+	}
+	
+	timer.Stop();
+	
+	if( g_showPhysicsIslands.GetBool() )
+	{
+		gameLocal.Printf( "%d: physics islands: %d entities, %d islands, %d jobs, %.2f ms\n",
+						  gameLocal.time, candidates.Num(), numIslands, numJobs, timer.Milliseconds() );
+	}
+}
+
+/*
+============
+idPhysicsIslands::GetEvaluated
+============
+*/
+bool idPhysicsIslands::GetEvaluated( const idEntity* ent, bool& moved )
+{
+	if( entities == NULL )
+	{
+		return false;
+	}
+	
+	physicsIslandEntity_t& result = entities[ent->entityNumber];
+	if( result.frame != gameLocal.framenum || result.spawnId != gameLocal.GetSpawnId( ent ) )
+	{
+		return false;
+	}
+	result.frame = -1;
+	moved = result.moved;
+	return true;
+}
+
+/*
+============
+idPhysicsIslands::IsOutsideIsland
+============
+*/
+bool idPhysicsIslands::IsOutsideIsland( const idEntity* ent, const physicsIsland_t* island ) const
+{
+	return ( entities[ent->entityNumber].island != island->index );
+}
+
+/*
+============
+idPhysicsIslands::Collide
+
+  collision callbacks can spawn and remove entities so they always wait for the islands
+============
+*/
+bool idPhysicsIslands::Collide( idEntity* ent, const trace_t& collision, const idVec3& velocity )
+{
+	physicsIsland_t* island = ThreadIsland();
+	if( island == NULL )
+	{
+		return ent->Collide( collision, velocity );
+	}
+	
+	physicsIslandCall_t& call = island->calls.Alloc();
+	call.type = ISLANDCALL_COLLIDE;
+	call.ent = ent;
+	call.other = NULL;
+	call.collision = collision;
+	call.vec = velocity;
+	return false;
+}
+
+/*
+============
+idPhysicsIslands::ApplyImpulse
+============
+*/
+void idPhysicsIslands::ApplyImpulse( idEntity* ent, idEntity* other, int id, const idVec3& point, const idVec3& impulse )
+{
+	physicsIsland_t* island = ThreadIsland();
+	if( island == NULL || !IsOutsideIsland( ent, island ) )
+	{
+		ent->ApplyImpulse( other, id, point, impulse );
+		return;
+	}
+	
+	physicsIslandCall_t& call = island->calls.Alloc();
+	call.type = ISLANDCALL_APPLY_IMPULSE;
+	call.ent = ent;
+	call.other = other;
+	call.id = id;
+	call.point = point;
+	call.vec = impulse;
+}
+
+/*
+============
+idPhysicsIslands::AddContactEntity
+============
+*/
+void idPhysicsIslands::AddContactEntity( idEntity* ent, idEntity* other )
+{
+	physicsIsland_t* island = ThreadIsland();
+	if( island == NULL || !IsOutsideIsland( ent, island ) )
+	{
+		ent->AddContactEntity( other );
+		return;
+	}
+	
+	physicsIslandCall_t& call = island->calls.Alloc();
+	call.type = ISLANDCALL_ADD_CONTACT_ENTITY;
+	call.ent = ent;
+	call.other = other;
+}
+
+/*
+============
+idPhysicsIslands::ActivatePhysics
+============
+*/
+void idPhysicsIslands::ActivatePhysics( idEntity* ent, idEntity* other )
+{
+	physicsIsland_t* island = ThreadIsland();
+	if( island == NULL || !IsOutsideIsland( ent, island ) )
+	{
+		ent->ActivatePhysics( other );
+		return;
+	}
+	
+	physicsIslandCall_t& call = island->calls.Alloc();
+	call.type = ISLANDCALL_ACTIVATE_PHYSICS;
+	call.ent = ent;
+	call.other = other;
+}
+
+/*
+============
+idPhysicsIslands::DeferThinkFlags
+
+  the active entity list is only changed on the game thread after all islands are done
+============
+*/
+bool idPhysicsIslands::DeferThinkFlags( idEntity* ent, int flags, bool active )
+{
+	physicsIsland_t* island = ThreadIsland();
+	if( island == NULL )
+	{
+		return false;
+	}
+	
+	physicsIslandCall_t& call = island->calls.Alloc();
+	call.type = active ? ISLANDCALL_BECOME_ACTIVE : ISLANDCALL_BECOME_INACTIVE;
+	call.ent = ent;
+	call.other = NULL;
+	call.id = flags;
+	return true;
+}
+
+/*
+============
+idPhysicsIslands::DeferWarning
+============
+*/
+bool idPhysicsIslands::DeferWarning( const char* text, bool developer ) const
+{
+	physicsIsland_t* island = ThreadIsland();
+	if( island == NULL )
+	{
+		return false;
+	}
+	
+	physicsIslandCall_t& call = island->calls.Alloc();
+	call.type = developer ? ISLANDCALL_DWARNING : ISLANDCALL_WARNING;
+	call.ent = NULL;
+	call.other = NULL;
+	call.text = text;
+	return true;
+}
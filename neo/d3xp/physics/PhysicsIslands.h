@@ -0,0 +1,99 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#ifndef __PHYSICSISLANDS_H__
+#define __PHYSICSISLANDS_H__
+
+/*
+===============================================================================
+
+  Evaluates the physics of independent groups of rigid bodies and articulated
+  figures in parallel.
+
+  Active bodies whose motion this frame can't reach each other are placed in
+  separate islands. Each island is evaluated on a single thread against the
+  read-only clip model tree, calls from the physics to entities outside the
+  island are queued and run on the game thread after all islands are done.
+
+  An articulated figure in an island of its own gathers its contacts and
+  applies its results on the game thread, only the constraint solve and
+  integration run on a job. Articulated figures that share an island with
+  other entities are evaluated in order on the game thread.
+
+===============================================================================
+*/
+
+class idPhysicsIslands
+{
+
+	friend void PhysicsIslandJob( struct physicsIslandJob_s* job );
+	
+public:
+	idPhysicsIslands();
+	
+	void					Init();
+	void					Shutdown();
+	
+	// evaluates the physics of all island entities when the first of them is about to think
+	void					Run( idEntity* ent );
+	// returns true if the physics of the entity were evaluated on an island this frame, only once
+	bool					GetEvaluated( const idEntity* ent, bool& moved );
+	
+	// entity calls made from physics evaluation, calls outside the island of the calling thread are queued
+	bool					Collide( idEntity* ent, const trace_t& collision, const idVec3& velocity );
+	void					ApplyImpulse( idEntity* ent, idEntity* other, int id, const idVec3& point, const idVec3& impulse );
+	void					AddContactEntity( idEntity* ent, idEntity* other );
+	void					ActivatePhysics( idEntity* ent, idEntity* other );
+	
+	// returns true if the think flag or warning was queued because the calling thread is evaluating an island
+	bool					DeferThinkFlags( idEntity* ent, int flags, bool active );
+	bool					DeferWarning( const char* text, bool developer ) const;
+	
+private:
+	int						lastFrame;				// frame the islands were last evaluated
+	struct physicsIslandEntity_s* entities;		// island and evaluation result for each entity number
+	idList<idEntity*>		candidates;				// entities evaluated on islands this frame
+	idList<int>				candidateParents;		// union-find forest over the candidates
+	idList<idBounds>		candidateBounds;		// bounds each candidate can move through this frame
+	idList<struct physicsIsland_s*> islands;		// islands reused between frames
+	int						numIslands;
+	struct physicsIslandJob_s* jobs;
+	idParallelJobList* 		jobList;
+	
+private:
+	bool					IsCandidate( idEntity* ent ) const;
+	void					GatherCandidates( idEntity* first );
+	void					BuildIslands();
+	void					PrepareIsland( struct physicsIsland_s& island );
+	void					EvaluateIsland( struct physicsIsland_s& island );
+	void					FinishIsland( struct physicsIsland_s& island );
+	void					FlushIsland( struct physicsIsland_s& island );
+	bool					IsOutsideIsland( const idEntity* ent, const struct physicsIsland_s* island ) const;
+};
+
+#endif /* !__PHYSICSISLANDS_H__ */
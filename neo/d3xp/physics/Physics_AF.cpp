@@ -40,6 +40,7 @@ const float LIMIT_ERROR_REDUCTION			= 0.3f;
 const float LCP_EPSILON						= 1e-7f;
 const float LIMIT_LCP_EPSILON				= 1e-4f;
 const float CONTACT_LCP_EPSILON				= 1e-6f;
+const float CONTACT_WARM_START_DISTANCE		= 1.0f;
 const float CENTER_OF_MASS_EPSILON			= 1e-4f;
 const float NO_MOVE_TIME					= 1.0f;
 const float NO_MOVE_TRANSLATION_TOLERANCE	= 10.0f;
@@ -3408,6 +3409,17 @@ void idAFConstraint_Contact::Setup( idAFBody* b1, idAFBody* b2, contactInfo_t& c
 	
 	assert( b1 );
 	
+	// only keep the force of the previous frame for warm starting if this is the same contact
+	if( b1 != body1 || b2 != body2 || c.entityNum != contact.entityNum || c.id != contact.id ||
+			( c.point - contact.point ).LengthSqr() > Square( CONTACT_WARM_START_DISTANCE ) )
+	{
+		lm.Zero();
+		if( fc )
+		{
+			fc->lm.Zero();
+		}
+	}
+	
 	body1 = b1;
 	body2 = b2;
 	contact = c;
@@ -5876,18 +5888,49 @@ void idPhysics_AF::AuxiliaryForces( float timeStep )
 		}
 	}
 	
+	// warm start the iterative solver with the constraint forces of the previous frame
+	if( af_useBlockLCP.GetBool() && af_lcpWarmStart.GetBool() )
+	{
+		for( k = 0, i = 0; i < auxiliaryConstraints.Num(); i++ )
+		{
+			constraint = auxiliaryConstraints[i];
+			for( j = 0; j < constraint->J1.GetNumRows(); j++, k++ )
+			{
+				lm[k] = constraint->lm[j];
+			}
+		}
+	}
+	else
+	{
+		lm.Zero();
+	}
+	
 #ifdef AF_TIMINGS
-	timer_lcp.Start();
+	timerLCP.Start();
 #endif
 	
 	// calculate lagrange multipliers for auxiliary constraints
-	if( !lcp->Solve( jmk, lm, rhs, lo, hi, boxIndex ) )
+	if( af_useBlockLCP.GetBool() )
+	{
+		blockLcp->SetMaxIterations( af_lcpIterations.GetInteger() );
+		if( !blockLcp->Solve( jmk, lm, rhs, lo, hi, boxIndex ) )
+		{
+#ifdef AF_TIMINGS
+			timerLCP.Stop();
+#endif
+			return;
+		}
+	}
+	else if( !lcp->Solve( jmk, lm, rhs, lo, hi, boxIndex ) )
 	{
+#ifdef AF_TIMINGS
+		timerLCP.Stop();
+#endif
 		return;		// bad monkey!
 	}
 	
 #ifdef AF_TIMINGS
-	timer_lcp.Stop();
+	timerLCP.Stop();
 #endif
 	
 	// calculate auxiliary constraint forces
@@ -6121,10 +6164,10 @@ bool idPhysics_AF::CollisionImpulse( float timeStep, idAFBody* body, trace_t& co
 	impulse = ( impulseNumerator / impulseDenominator ) * collision.c.normal;
 	
 	// apply impact to other entity
-	ent->ApplyImpulse( self, collision.c.id, collision.c.point, -impulse );
+	gameLocal.physicsIslands.ApplyImpulse( ent, self, collision.c.id, collision.c.point, -impulse );
 	
 	// callback to self to let the entity know about the impact
-	return self->Collide( collision, velocity );
+	return gameLocal.physicsIslands.Collide( self, collision, velocity );
 }
 
 /*
@@ -7037,6 +7080,27 @@ idPhysics_AF::Evaluate
 ================
 */
 bool idPhysics_AF::Evaluate( int timeStepMSec, int endTimeMSec )
+{
+	if( !PrepareEvaluate( timeStepMSec, endTimeMSec ) )
+	{
+		return false;
+	}
+	
+	SolveEvaluate( endTimeMSec );
+	
+	FinishEvaluate( endTimeMSec );
+	
+	return true;
+}
+
+/*
+================
+idPhysics_AF::PrepareEvaluate
+
+  gathers the contacts on the game thread, returns false if the figure does not need to be evaluated
+================
+*/
+bool idPhysics_AF::PrepareEvaluate( int timeStepMSec, int endTimeMSec )
 {
 	float timeStep;
 	
@@ -7088,11 +7152,13 @@ bool idPhysics_AF::Evaluate( int timeStepMSec, int endTimeMSec )
 	AddPushVelocity( -current.pushVelocity );
 	
 #ifdef AF_TIMINGS
-	timer_total.Start();
-#endif
-	
-#ifdef AF_TIMINGS
-	timer_collision.Start();
+	timerTotal.Clear();
+	timerPrimary.Clear();
+	timerAuxiliary.Clear();
+	timerCollision.Clear();
+	timerLCP.Clear();
+	timerTotal.Start();
+	timerCollision.Start();
 #endif
 	
 	// evaluate contacts
@@ -7102,7 +7168,27 @@ bool idPhysics_AF::Evaluate( int timeStepMSec, int endTimeMSec )
 	SetupContactConstraints();
 	
 #ifdef AF_TIMINGS
-	timer_collision.Stop();
+	timerCollision.Stop();
+	timerTotal.Stop();
+#endif
+	
+	return true;
+}
+
+/*
+================
+idPhysics_AF::SolveEvaluate
+
+  solves the constraints and moves the bodies to the next state,
+  this only touches the figure itself and the clip model tree so it can run on a job thread
+================
+*/
+void idPhysics_AF::SolveEvaluate( int endTimeMSec )
+{
+	float timeStep = current.lastTimeStep;
+	
+#ifdef AF_TIMINGS
+	timerTotal.Start();
 #endif
 	
 	// evaluate constraint equations
@@ -7115,16 +7201,17 @@ bool idPhysics_AF::Evaluate( int timeStepMSec, int endTimeMSec )
 	AddFrameConstraints();
 	
 #ifdef AF_TIMINGS
-	int i, numPrimary = 0, numAuxiliary = 0;
+	int i;
+	numPrimaryRows = numAuxiliaryRows = 0;
 	for( i = 0; i < primaryConstraints.Num(); i++ )
 	{
-		numPrimary += primaryConstraints[i]->J1.GetNumRows();
+		numPrimaryRows += primaryConstraints[i]->J1.GetNumRows();
 	}
 	for( i = 0; i < auxiliaryConstraints.Num(); i++ )
 	{
-		numAuxiliary += auxiliaryConstraints[i]->J1.GetNumRows();
+		numAuxiliaryRows += auxiliaryConstraints[i]->J1.GetNumRows();
 	}
-	timer_pc.Start();
+	timerPrimary.Start();
 #endif
 	
 	// factor matrices for primary constraints
@@ -7134,41 +7221,35 @@ bool idPhysics_AF::Evaluate( int timeStepMSec, int endTimeMSec )
 	PrimaryForces( timeStep );
 	
 #ifdef AF_TIMINGS
-	timer_pc.Stop();
-	timer_ac.Start();
+	timerPrimary.Stop();
+	timerAuxiliary.Start();
 #endif
 	
 	// calculate and apply auxiliary constraint forces
 	AuxiliaryForces( timeStep );
 	
 #ifdef AF_TIMINGS
-	timer_ac.Stop();
+	timerAuxiliary.Stop();
 #endif
 	
 	// evolve current state to next state
 	Evolve( timeStep );
 	
-	// debug graphics
-	DebugDraw();
-	
 	// clear external forces on all bodies
 	ClearExternalForce();
 	
-	// apply contact force to other entities
-	ApplyContactForces();
-	
 	// remove all frame constraints
 	RemoveFrameConstraints();
 	
 #ifdef AF_TIMINGS
-	timer_collision.Start();
+	timerCollision.Start();
 #endif
 	
 	// check for collisions between current and next state
 	CheckForCollisions( timeStep );
 	
 #ifdef AF_TIMINGS
-	timer_collision.Stop();
+	timerCollision.Stop();
 #endif
 	
 	// swap the current and next state
@@ -7180,6 +7261,32 @@ bool idPhysics_AF::Evaluate( int timeStepMSec, int endTimeMSec )
 		DisableClip();
 	}
 	
+#ifdef AF_TIMINGS
+	timerTotal.Stop();
+#endif
+}
+
+/*
+================
+idPhysics_AF::FinishEvaluate
+
+  applies the results of the solve to the figure and other entities on the game thread
+================
+*/
+void idPhysics_AF::FinishEvaluate( int endTimeMSec )
+{
+	float timeStep = current.lastTimeStep;
+	
+#ifdef AF_TIMINGS
+	timerTotal.Start();
+#endif
+	
+	// debug graphics
+	DebugDraw();
+	
+	// apply contact force to other entities
+	ApplyContactForces();
+	
 	// apply collision impulses
 	if( ApplyCollisions( timeStep ) )
 	{
@@ -7212,16 +7319,23 @@ bool idPhysics_AF::Evaluate( int timeStepMSec, int endTimeMSec )
 	}
 	
 #ifdef AF_TIMINGS
-	timer_total.Stop();
+	timerTotal.Stop();
+	
+	// the frame totals are only touched here on the game thread
+	timer_total += timerTotal;
+	timer_pc += timerPrimary;
+	timer_ac += timerAuxiliary;
+	timer_collision += timerCollision;
+	timer_lcp += timerLCP;
 	
 	if( af_showTimings.GetInteger() == 1 )
 	{
 		gameLocal.Printf( "%12s: t %1.4f pc %2d, %1.4f ac %2d %1.4f lcp %1.4f cd %1.4f\n",
 						  self->name.c_str(),
-						  timer_total.Milliseconds(),
-						  numPrimary, timer_pc.Milliseconds(),
-						  numAuxiliary, timer_ac.Milliseconds() - timer_lcp.Milliseconds(),
-						  timer_lcp.Milliseconds(), timer_collision.Milliseconds() );
+						  timerTotal.Milliseconds(),
+						  numPrimaryRows, timerPrimary.Milliseconds(),
+						  numAuxiliaryRows, timerAuxiliary.Milliseconds() - timerLCP.Milliseconds(),
+						  timerLCP.Milliseconds(), timerCollision.Milliseconds() );
 	}
 	else if( af_showTimings.GetInteger() == 2 )
 	{
@@ -7231,8 +7345,8 @@ bool idPhysics_AF::Evaluate( int timeStepMSec, int endTimeMSec )
 			gameLocal.Printf( "af %d: t %1.4f pc %2d, %1.4f ac %2d %1.4f lcp %1.4f cd %1.4f\n",
 							  numArticulatedFigures,
 							  timer_total.Milliseconds(),
-							  numPrimary, timer_pc.Milliseconds(),
-							  numAuxiliary, timer_ac.Milliseconds() - timer_lcp.Milliseconds(),
+							  numPrimaryRows, timer_pc.Milliseconds(),
+							  numAuxiliaryRows, timer_ac.Milliseconds() - timer_lcp.Milliseconds(),
 							  timer_lcp.Milliseconds(), timer_collision.Milliseconds() );
 		}
 	}
@@ -7248,8 +7362,6 @@ bool idPhysics_AF::Evaluate( int timeStepMSec, int endTimeMSec )
 		timer_lcp.Clear();
 	}
 #endif
-	
-	return true;
 }
 
 /*
@@ -7478,6 +7590,7 @@ idPhysics_AF::idPhysics_AF()
 	masterBody = NULL;
 	
 	lcp = idLCP::AllocSymmetric();
+	blockLcp = idLCP::AllocBlockGaussSeidel();
 	
 	memset( &current, 0, sizeof( current ) );
 	current.atRest = -1;
@@ -7524,6 +7637,9 @@ idPhysics_AF::idPhysics_AF()
 	worldConstraintsLocked = false;
 	forcePushable = false;
 	
+	numPrimaryRows = 0;
+	numAuxiliaryRows = 0;
+	
 #ifdef AF_TIMINGS
 	lastTimerReset = 0;
 #endif
@@ -7557,6 +7673,7 @@ idPhysics_AF::~idPhysics_AF()
 	}
 	
 	delete lcp;
+	delete blockLcp;
 	
 	if( masterBody )
 	{
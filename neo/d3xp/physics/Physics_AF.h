@@ -586,6 +586,8 @@ protected:
 class idAFConstraint_ContactFriction : public idAFConstraint
 {
 
+	friend class idAFConstraint_Contact;
+	
 public:
 	idAFConstraint_ContactFriction();
 	void					Setup( idAFConstraint_Contact* cc );
@@ -1088,6 +1090,11 @@ public:
 	// update the clip model positions
 	void					UpdateClipModels();
 	
+	// Evaluate split in three steps, only SolveEvaluate may run outside the game thread
+	bool					PrepareEvaluate( int timeStepMSec, int endTimeMSec );
+	void					SolveEvaluate( int endTimeMSec );
+	void					FinishEvaluate( int endTimeMSec );
+	
 public:	// common physics interface
 	void					SetClipModel( idClipModel* model, float density, int id = 0, bool freeOld = true );
 	idClipModel* 			GetClipModel( int id = 0 ) const;
@@ -1214,6 +1221,16 @@ private:
 	
 	idAFBody* 				masterBody;						// master body
 	idLCP* 					lcp;							// linear complementarity problem solver
+	idLCP* 					blockLcp;						// iterative solver warm started with the previous frame
+	
+	// timings of the last evaluation, kept per figure because the evaluation steps of different figures interleave
+	idTimer					timerTotal;
+	idTimer					timerPrimary;
+	idTimer					timerAuxiliary;
+	idTimer					timerCollision;
+	idTimer					timerLCP;
+	int						numPrimaryRows;
+	int						numAuxiliaryRows;
 	
 private:
 	void					BuildTrees();
@@ -847,7 +847,7 @@ void idPhysics_Base::AddContactEntitiesForContacts()
 		ent = gameLocal.entities[ contacts[i].entityNum ];
 		if( ent && ent != self )
 		{
-			ent->AddContactEntity( self );
+			gameLocal.physicsIslands.AddContactEntity( ent, self );
 		}
 	}
 }
@@ -867,7 +867,7 @@ void idPhysics_Base::ActivateContactEntities()
 		ent = contactEntities[i].GetEntity();
 		if( ent )
 		{
-			ent->ActivatePhysics( self );
+			gameLocal.physicsIslands.ActivatePhysics( ent, self );
 		}
 		else
 		{
@@ -35,6 +35,9 @@ CLASS_DECLARATION( idPhysics_Base, idPhysics_RigidBody )
 END_CLASS
 
 const float STOP_SPEED		= 10.0f;
+const int SLEEP_TIME		= 1000;			// time a body has to hold still before it is put to sleep
+const float SLEEP_DISTANCE	= 1.0f;			// distance a body may drift while holding still
+const float SLEEP_ROTATION	= 0.02f;		// change of axis a body may have while holding still
 
 
 #undef RB_TIMINGS
@@ -166,7 +169,7 @@ bool idPhysics_RigidBody::CollisionImpulse( const trace_t& collision, idVec3& im
 	}
 	
 	// callback to self to let the entity know about the collision
-	return self->Collide( collision, velocity );
+	return gameLocal.physicsIslands.Collide( self, collision, velocity );
 }
 
 /*
@@ -219,35 +222,165 @@ bool idPhysics_RigidBody::CheckForCollisions( const float deltaTime, rigidBodyPS
 	return collided;
 }
 
+/*
+================
+RigidBodyContactBefore
+
+  Orders contacts by what is in contact.
+================
+*/
+static bool RigidBodyContactBefore( const contactInfo_t& a, const contactInfo_t& b )
+{
+	if( a.entityNum != b.entityNum )
+	{
+		return ( a.entityNum < b.entityNum );
+	}
+	if( a.id != b.id )
+	{
+		return ( a.id < b.id );
+	}
+	if( a.type != b.type )
+	{
+		return ( a.type < b.type );
+	}
+	if( a.modelFeature != b.modelFeature )
+	{
+		return ( a.modelFeature < b.modelFeature );
+	}
+	return ( a.trmFeature < b.trmFeature );
+}
+
+/*
+================
+idPhysics_RigidBody::UpdateContactManifold
+
+  Sorts the contacts in a stable order and carries the impulses of the contacts that persisted
+  since the last evaluation over to the contact manifold. Contacts are identified by the entity,
+  clip model and features in contact.
+================
+*/
+void idPhysics_RigidBody::UpdateContactManifold()
+{
+	int i, j;
+	idStaticList<rigidBodyContactPoint_t, RB_MAX_CONTACTS> old;
+	
+	// solve the contacts in the same order every frame
+	for( i = 1; i < contacts.Num(); i++ )
+	{
+		for( j = i; j > 0 && RigidBodyContactBefore( contacts[j], contacts[j - 1] ); j-- )
+		{
+			SwapValues( contacts[j], contacts[j - 1] );
+		}
+	}
+	
+	old = manifold;
+	manifold.SetNum( contacts.Num() );
+	
+	for( i = 0; i < contacts.Num(); i++ )
+	{
+		const contactInfo_t& c = contacts[i];
+		rigidBodyContactPoint_t& point = manifold[i];
+		
+		point.entityNum = c.entityNum;
+		point.id = c.id;
+		point.type = c.type;
+		point.modelFeature = c.modelFeature;
+		point.trmFeature = c.trmFeature;
+		point.normalForce = 0.0f;
+		point.numFrames = 0;
+		
+		if( !rb_contactCache.GetBool() )
+		{
+			continue;
+		}
+		
+		for( j = 0; j < old.Num(); j++ )
+		{
+			if( old[j].entityNum == c.entityNum && old[j].id == c.id && old[j].type == c.type &&
+					old[j].modelFeature == c.modelFeature && old[j].trmFeature == c.trmFeature )
+			{
+				point.normalForce = old[j].normalForce;
+				point.numFrames = old[j].numFrames + 1;
+				old.RemoveIndexFast( j );
+				break;
+			}
+		}
+	}
+}
+
 /*
 ================
 idPhysics_RigidBody::ContactFriction
 
+  Solves the normal impulses of all contacts together with sequential impulses which never pull,
+  warm started with the impulses of the contacts that persisted since the last evaluation.
   Does not solve friction for multiple simultaneous contacts but applies contact friction in isolation.
   Uses absolute velocity at the contact points instead of the velocity relative to the contact object.
 ================
 */
 void idPhysics_RigidBody::ContactFriction( float deltaTime )
 {
-	int i;
-	float magnitude, impulseNumerator, impulseDenominator;
+	int i, j, numIterations;
+	float magnitude, impulseNumerator, impulseDenominator, oldImpulse;
+	float normalImpulse[RB_MAX_CONTACTS], normalMass[RB_MAX_CONTACTS];
 	idMat3 inverseWorldInertiaTensor;
 	idVec3 linearVelocity, angularVelocity;
-	idVec3 massCenter, r, velocity, normal, impulse, normalVelocity;
+	idVec3 massCenter, r[RB_MAX_CONTACTS], velocity, normal, impulse, normalVelocity;
 	
 	inverseWorldInertiaTensor = current.i.orientation.Transpose() * inverseInertiaTensor * current.i.orientation;
 	
 	massCenter = current.i.position + centerOfMass * current.i.orientation;
 	
+	numIterations = idMath::ClampInt( 1, 16, rb_contactIterations.GetInteger() );
+	
+	// apply the normal impulses of the last evaluation
 	for( i = 0; i < contacts.Num(); i++ )
 	{
-	
-		r = contacts[i].point - massCenter;
+		r[i] = contacts[i].point - massCenter;
+		normal = contacts[i].normal;
+		normalMass[i] = 1.0f / ( inverseMass + ( ( inverseWorldInertiaTensor * r[i].Cross( normal ) ).Cross( r[i] ) * normal ) );
+		normalImpulse[i] = manifold[i].normalForce * deltaTime;
 		
+		if( normalImpulse[i] > 0.0f )
+		{
+			impulse = normalImpulse[i] * normal;
+			current.i.linearMomentum += impulse;
+			current.i.angularMomentum += r[i].Cross( impulse );
+		}
+	}
+	
+	// remove the velocity towards the surface at all contact points
+	for( j = 0; j < numIterations; j++ )
+	{
+		for( i = 0; i < contacts.Num(); i++ )
+		{
+			// calculate velocity at contact point
+			linearVelocity = inverseMass * current.i.linearMomentum;
+			angularVelocity = inverseWorldInertiaTensor * current.i.angularMomentum;
+			velocity = linearVelocity + angularVelocity.Cross( r[i] );
+			
+			// accumulate the impulse but never pull the body towards the surface
+			oldImpulse = normalImpulse[i];
+			normalImpulse[i] -= ( velocity * contacts[i].normal ) * normalMass[i];
+			if( normalImpulse[i] < 0.0f )
+			{
+				normalImpulse[i] = 0.0f;
+			}
+			
+			// apply impulse
+			impulse = ( normalImpulse[i] - oldImpulse ) * contacts[i].normal;
+			current.i.linearMomentum += impulse;
+			current.i.angularMomentum += r[i].Cross( impulse );
+		}
+	}
+	
+	for( i = 0; i < contacts.Num(); i++ )
+	{
+	
 		// calculate velocity at contact point
 		linearVelocity = inverseMass * current.i.linearMomentum;
 		angularVelocity = inverseWorldInertiaTensor * current.i.angularMomentum;
-		velocity = linearVelocity + angularVelocity.Cross( r );
+		velocity = linearVelocity + angularVelocity.Cross( r[i] );
 		
 		// velocity along normal vector
 		normalVelocity = ( velocity * contacts[i].normal ) * contacts[i].normal;
@@ -256,26 +389,15 @@ void idPhysics_RigidBody::ContactFriction( float deltaTime )
 		normal = -( velocity - normalVelocity );
 		magnitude = normal.Normalize();
 		impulseNumerator = contactFriction * magnitude;
-		impulseDenominator = inverseMass + ( ( inverseWorldInertiaTensor * r.Cross( normal ) ).Cross( r ) * normal );
+		impulseDenominator = inverseMass + ( ( inverseWorldInertiaTensor * r[i].Cross( normal ) ).Cross( r[i] ) * normal );
 		impulse = ( impulseNumerator / impulseDenominator ) * normal;
 		
 		// apply friction impulse
 		current.i.linearMomentum += impulse;
-		current.i.angularMomentum += r.Cross( impulse );
+		current.i.angularMomentum += r[i].Cross( impulse );
 		
-		// if moving towards the surface at the contact point
-		if( normalVelocity * contacts[i].normal < 0.0f )
-		{
-			// calculate impulse
-			normal = -normalVelocity;
-			impulseNumerator = normal.Normalize();
-			impulseDenominator = inverseMass + ( ( inverseWorldInertiaTensor * r.Cross( normal ) ).Cross( r ) * normal );
-			impulse = ( impulseNumerator / impulseDenominator ) * normal;
-			
-			// apply impulse
-			current.i.linearMomentum += impulse;
-			current.i.angularMomentum += r.Cross( impulse );
-		}
+		// remember the normal impulse to warm start the next evaluation
+		manifold[i].normalForce = normalImpulse[i] / deltaTime;
 	}
 }
 
@@ -377,6 +499,71 @@ bool idPhysics_RigidBody::TestIfAtRest() const
 	return true;
 }
 
+/*
+================
+idPhysics_RigidBody::TestIfSleeping
+
+  Returns true if the body held still on the same contacts for some time.
+  Catches bodies at rest TestIfAtRest misses, like a barrel lying on its side on two contact points.
+================
+*/
+bool idPhysics_RigidBody::TestIfSleeping()
+{
+	int i;
+	idVec3 v, av, normal;
+	idMat3 inverseWorldInertiaTensor;
+	
+	if( !rb_contactCache.GetBool() || manifold.Num() == 0 )
+	{
+		sleepTime = -1;
+		return false;
+	}
+	
+	// all contacts need to have persisted since the last evaluation
+	normal.Zero();
+	for( i = 0; i < manifold.Num(); i++ )
+	{
+		if( manifold[i].numFrames == 0 )
+		{
+			sleepTime = -1;
+			return false;
+		}
+		normal += contacts[i].normal;
+	}
+	normal.Normalize();
+	
+	// if on a too steep surface
+	if( ( normal * gravityNormal ) > -0.7f )
+	{
+		sleepTime = -1;
+		return false;
+	}
+	
+	// linear and rotational velocity of body
+	v = inverseMass * current.i.linearMomentum;
+	inverseWorldInertiaTensor = current.i.orientation * inverseInertiaTensor * current.i.orientation.Transpose();
+	av = inverseWorldInertiaTensor * current.i.angularMomentum;
+	
+	// if moving too fast
+	if( v.LengthSqr() > Square( STOP_SPEED ) || av.LengthSqr() > STOP_SPEED )
+	{
+		sleepTime = -1;
+		return false;
+	}
+	
+	// start holding still when first slow enough or drifted away from where the body started to hold still
+	if( sleepTime < 0 || ( current.i.position - sleepOrigin ).LengthSqr() > Square( SLEEP_DISTANCE ) ||
+			!current.i.orientation.Compare( sleepAxis, SLEEP_ROTATION ) )
+	{
+		sleepTime = gameLocal.time;
+		sleepOrigin = current.i.position;
+		sleepAxis = current.i.orientation;
+		return false;
+	}
+	
+	return ( gameLocal.time - sleepTime >= SLEEP_TIME );
+}
+
 /*
 ================
 idPhysics_RigidBody::DropToFloorAndRest
@@ -507,6 +694,10 @@ idPhysics_RigidBody::idPhysics_RigidBody()
 	hasMaster = false;
 	isOrientated = false;
 	
+	sleepTime = -1;
+	sleepOrigin.Zero();
+	sleepAxis.Identity();
+	
 #ifdef RB_TIMINGS
 	lastTimerReset = 0;
 #endif
@@ -778,6 +969,7 @@ idPhysics_RigidBody::Rest
 void idPhysics_RigidBody::Rest()
 {
 	current.atRest = gameLocal.time;
+	sleepTime = -1;
 	current.i.linearMomentum.Zero();
 	current.i.angularMomentum.Zero();
 	self->BecomeInactive( TH_PHYSICS );
@@ -811,8 +1003,17 @@ idPhysics_RigidBody::Activate
 */
 void idPhysics_RigidBody::Activate()
 {
+	bool wasAtRest = ( current.atRest >= 0 );
+	
 	current.atRest = -1;
+	sleepTime = -1;
 	self->BecomeActive( TH_PHYSICS );
+	
+	// wake up the bodies resting on this one right away so a sleeping stack wakes up as a whole
+	if( wasAtRest && rb_contactCache.GetBool() )
+	{
+		ActivateContactEntities();
+	}
 }
 
 /*
@@ -1006,8 +1207,11 @@ bool idPhysics_RigidBody::Evaluate( int timeStepMSec, int endTimeMSec )
 		timer_collision.Stop();
 #endif
 		
+		// match the contacts with the contact manifold of the last evaluation
+		UpdateContactManifold();
+		
 		// check if the body has come to rest
-		if( TestIfAtRest() )
+		if( TestIfAtRest() || TestIfSleeping() )
 		{
 			// put to rest
 			Rest();
@@ -1032,7 +1236,7 @@ bool idPhysics_RigidBody::Evaluate( int timeStepMSec, int endTimeMSec )
 		if( ent && ( !cameToRest || !ent->IsAtRest() ) )
 		{
 			// apply impact to other entity
-			ent->ApplyImpulse( self, collision.c.id, collision.c.point, -impulse );
+			gameLocal.physicsIslands.ApplyImpulse( ent, self, collision.c.id, collision.c.point, -impulse );
 		}
 	}
 	
@@ -1528,13 +1732,13 @@ bool idPhysics_RigidBody::EvaluateContacts()
 	
 	ClearContacts();
 	
-	contacts.SetNum( 10 );
+	contacts.SetNum( RB_MAX_CONTACTS );
 	
 	dir.SubVec3( 0 ) = current.i.linearMomentum + current.lastTimeStep * gravityVector * mass;
 	dir.SubVec3( 1 ) = current.i.angularMomentum;
 	dir.SubVec3( 0 ).Normalize();
 	dir.SubVec3( 1 ).Normalize();
-	num = gameLocal.clip.Contacts( &contacts[0], 10, clipModel->GetOrigin(),
+	num = gameLocal.clip.Contacts( &contacts[0], RB_MAX_CONTACTS, clipModel->GetOrigin(),
 								   dir, CONTACT_EPSILON, clipModel, clipModel->GetAxis(), clipMask, self );
 	contacts.SetNum( num );
 	
@@ -1688,3 +1892,45 @@ void idPhysics_RigidBody::ReadFromSnapshot( const idBitMsg& msg )
 		clipModel->Link( gameLocal.clip, self, clipModel->GetId(), next.i.position, next.i.orientation );
 	}
 }
+
+/*
+================
+idPhysics_RigidBody::ShowCounters
+================
+*/
+void idPhysics_RigidBody::ShowCounters()
+{
+	int i, numActive, numSleeping, numPoints, numWarmStarted;
+	idEntity* ent;
+	const idPhysics_RigidBody* rb;
+	
+	numActive = numSleeping = numPoints = numWarmStarted = 0;
+	
+	for( ent = gameLocal.spawnedEntities.Next(); ent != NULL; ent = ent->spawnNode.Next() )
+	{
+		if( ent->GetPhysics() == NULL || !ent->GetPhysics()->IsType( idPhysics_RigidBody::Type ) )
+		{
+			continue;
+		}
+		rb = static_cast<const idPhysics_RigidBody*>( ent->GetPhysics() );
+		if( rb->current.atRest >= 0 )
+		{
+			numSleeping++;
+			continue;
+		}
+		numActive++;
+		
+		// contact points solved by the active bodies this frame
+		numPoints += rb->manifold.Num();
+		for( i = 0; i < rb->manifold.Num(); i++ )
+		{
+			if( rb->manifold[i].numFrames > 0 )
+			{
+				numWarmStarted++;
+			}
+		}
+	}
+	
+	gameLocal.Printf( "%d: rigid bodies: %d active, %d sleeping, %d contact points, %d warm started\n",
+					  gameLocal.time, numActive, numSleeping, numPoints, numWarmStarted );
+}
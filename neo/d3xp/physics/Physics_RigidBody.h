@@ -45,6 +45,8 @@ extern const int	RB_VELOCITY_TOTAL_BITS;
 extern const int	RB_VELOCITY_EXPONENT_BITS;
 extern const int	RB_VELOCITY_MANTISSA_BITS;
 
+#define RB_MAX_CONTACTS			10					// maximum number of contacts and contact manifold points
+
 typedef struct rididBodyIState_s
 {
 	idVec3					position;					// position of trace model
@@ -84,6 +86,18 @@ typedef struct rigidBodyPState_s
 	}
 } rigidBodyPState_t;
 
+// contact point kept between frames to warm start the contact impulses
+typedef struct rigidBodyContactPoint_s
+{
+	int						entityNum;					// entity in contact with
+	int						id;							// id of clip model in contact with
+	int						type;						// contact type
+	int						modelFeature;				// contact feature on model
+	int						trmFeature;					// contact feature on trace model
+	float					normalForce;				// accumulated normal impulse divided by the time step
+	int						numFrames;					// number of consecutive frames the contact persisted
+} rigidBodyContactPoint_t;
+
 class idPhysics_RigidBody : public idPhysics_Base
 {
 
@@ -176,6 +190,9 @@ public:	// common physics interface
 	void					WriteToSnapshot( idBitMsg& msg ) const;
 	void					ReadFromSnapshot( const idBitMsg& msg );
 	
+	// prints the number of active and sleeping rigid bodies and their cached contact points
+	static void				ShowCounters();
+	
 private:
 	// state of the rigid body
 	rigidBodyPState_t		current;
@@ -209,14 +226,22 @@ private:
 	bool					hasMaster;
 	bool					isOrientated;
 	
+	// contact manifold, one point for each contact of the last evaluation in the same order
+	idStaticList<rigidBodyContactPoint_t, RB_MAX_CONTACTS> manifold;
+	int						sleepTime;					// time the body started to hold still, -1 if moving
+	idVec3					sleepOrigin;				// position when the body started to hold still
+	idMat3					sleepAxis;					// orientation when the body started to hold still
+	
 private:
 	friend void				RigidBodyDerivatives( const float t, const void* clientData, const float* state, float* derivatives );
 	void					Integrate( const float deltaTime, rigidBodyPState_t& next );
 	bool					CheckForCollisions( const float deltaTime, rigidBodyPState_t& next, trace_t& collision );
 	bool					CollisionImpulse( const trace_t& collision, idVec3& impulse );
 	void					ContactFriction( float deltaTime );
+	void					UpdateContactManifold();
 	void					DropToFloorAndRest();
 	bool					TestIfAtRest() const;
+	bool					TestIfSleeping();
 	void					Rest();
 	void					DebugDraw();
 };
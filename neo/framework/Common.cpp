@@ -2044,6 +2044,10 @@ CONSOLE_COMMAND( testSIMD, "test SIMD code", NULL )
 {
 	idSIMD::Test_f( args );
 }
+CONSOLE_COMMAND( testLCP, "test LCP solvers", NULL )
+{
+	idLCP::Test_f( args );
+}
 
 // RB begin
 CONSOLE_COMMAND( testFormattingSizes, "test printf format security", 0 )
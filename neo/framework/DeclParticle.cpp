@@ -511,6 +511,7 @@ idParticleStage* idDeclParticle::ParseParticleStage( idLexer& src )
 	
 	// derive values
 	stage->cycleMsec = ( stage->particleLife + stage->deadTime ) * 1000;
+	stage->BakeParms();
 	
 	return stage;
 }
@@ -734,6 +735,8 @@ bool idDeclParticle::LoadBinary( idFile* file, unsigned int checksum )
 		file->ReadFloat( s->boundsExpansion );
 		file->ReadVec3( s->bounds[0] );
 		file->ReadVec3( s->bounds[1] );
+		
+		s->BakeParms();
 	}
 	
 	file->ReadVec3( bounds[0] );
@@ -1066,6 +1069,15 @@ float idParticleParm::Integrate( float frac, idRandom& rand ) const
 	return ( from + frac * ( to - from ) * 0.5f ) * frac;
 }
 
+void idParticleParm::Bake( float* samples, int numSamples ) const
+{
+	idRandom rand;
+	for( int i = 0; i <= numSamples; i++ )
+	{
+		samples[i] = Eval( ( float )i / numSamples, rand );
+	}
+}
+
 /*
 ====================================================================================
 
@@ -1118,6 +1130,7 @@ idParticleStage::idParticleStage()
 	hidden = false;
 	boundsExpansion = 0.0f;
 	bounds.Clear();
+	BakeParms();
 }
 
 /*
@@ -1192,6 +1205,21 @@ void idParticleStage::Default()
 	randomDistribution = true;
 	entityColor = false;
 	cycleMsec = ( particleLife + deadTime ) * 1000;
+	BakeParms();
+}
+
+/*
+================
+idParticleStage::BakeParms
+
+Samples the size and aspect parms so the batched particle path can evaluate
+table driven parms with a lerp instead of a table lookup per particle
+================
+*/
+void idParticleStage::BakeParms()
+{
+	size.Bake( sizeSamples, PARTICLE_PARM_SAMPLES );
+	aspect.Bake( aspectSamples, PARTICLE_PARM_SAMPLES );
 }
 
 /*
@@ -1875,6 +1903,8 @@ void idParticleStage::operator=( const idParticleStage& src )
 	orientationParms[3] = src.orientationParms[3];
 	size = src.size;
 	aspect = src.aspect;
+	memcpy( sizeSamples, src.sizeSamples, sizeof( sizeSamples ) );
+	memcpy( aspectSamples, src.aspectSamples, sizeof( aspectSamples ) );
 	color = src.color;
 	fadeColor = src.fadeColor;
 	fadeInFraction = src.fadeInFraction;
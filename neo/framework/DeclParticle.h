@@ -54,8 +54,13 @@ public:
 	
 	float					Eval( float frac, idRandom& rand ) const;
 	float					Integrate( float frac, idRandom& rand ) const;
+	// samples Eval() at numSamples + 1 evenly spaced fractions
+	void					Bake( float* samples, int numSamples ) const;
 };
 
+// number of intervals a table driven size or aspect is baked into
+static const int PARTICLE_PARM_SAMPLES = 64;
+
 
 typedef enum
 {
@@ -120,6 +125,7 @@ public:
 	~idParticleStage() {}
 	
 	void					Default();
+	void					BakeParms();					// must be called after size or aspect change
 	int						NumQuadsPerParticle() const;	// includes trails and cross faded animations
 	// returns the number of verts created, which will range from 0 to 4*NumQuadsPerParticle()
 	int						CreateParticle( particleGen_t* g, idDrawVert* verts ) const;
@@ -185,6 +191,8 @@ public:
 	
 	idParticleParm			size;
 	idParticleParm			aspect;				// greater than 1 makes the T axis longer
+	float					sizeSamples[PARTICLE_PARM_SAMPLES + 1];		// derived, for the batched particle path
+	float					aspectSamples[PARTICLE_PARM_SAMPLES + 1];	// derived
 	
 	idVec4					color;
 	idVec4					fadeColor;			// either 0 0 0 0 for additive, or 1 1 1 0 for blended materials
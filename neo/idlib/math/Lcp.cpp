@@ -3356,6 +3356,319 @@ bool idLCP_Symmetric::Solve( const idMatX& o_m, idVecX& o_x, const idVecX& o_b,
 	return true;
 }
 
+/*
+================================================================================================
+
+	idLCP_BlockGaussSeidel
+
+================================================================================================
+*/
+
+const float LCP_GS_EPSILON				= 1e-4f;
+
+/*
+================================================
+idLCP_BlockGaussSeidel
+
+Projected Gauss-Seidel solver for symmetric positive semi-definite matrices. The non-zero
+pattern of the matrix is gathered first and variables that are not coupled through the
+matrix or a box index are split into independent blocks. Each block is iterated until it
+converges or the maximum number of iterations is reached. The incoming 'x' is used as the
+initial guess so a solution from a previous frame can be used to warm start the solver.
+================================================
+*/
+class idLCP_BlockGaussSeidel : public idLCP
+{
+public:
+	virtual bool	Solve( const idMatX& o_m, idVecX& o_x, const idVecX& o_b, const idVecX& o_lo, const idVecX& o_hi, const int* o_boxIndex );
+	
+private:
+	idList<int>		rowStart;			// first off-diagonal non-zero of each row
+	idList<int>		columns;			// columns of the off-diagonal non-zeros
+	idList<int>		parent;				// union-find parent used to merge coupled variables
+	idList<int>		blockStart;			// first variable of each block
+	idList<int>		order;				// variables sorted per block with box constrained variables last
+	
+	int				FindBlock( int i );
+	void			MergeBlocks( int i, int j );
+	float			GetError( const idMatX& m, const idVecX& x, const idVecX& b, const idVecX& lo, const idVecX& hi, const int* boxIndex, int i ) const;
+};
+
+/*
+========================
+idLCP_BlockGaussSeidel::FindBlock
+========================
+*/
+int idLCP_BlockGaussSeidel::FindBlock( int i )
+{
+	while( parent[i] != i )
+	{
+		parent[i] = parent[parent[i]];
+		i = parent[i];
+	}
+	return i;
+}
+
+/*
+========================
+idLCP_BlockGaussSeidel::MergeBlocks
+========================
+*/
+void idLCP_BlockGaussSeidel::MergeBlocks( int i, int j )
+{
+	i = FindBlock( i );
+	j = FindBlock( j );
+	if( i != j )
+	{
+		parent[Max( i, j )] = Min( i, j );
+	}
+}
+
+/*
+========================
+idLCP_BlockGaussSeidel::GetError
+
+Returns how much variable i violates the complementarity conditions.
+========================
+*/
+float idLCP_BlockGaussSeidel::GetError( const idMatX& m, const idVecX& x, const idVecX& b, const idVecX& lo, const idVecX& hi, const int* boxIndex, int i ) const
+{
+	const float* row = m[i];
+	float t = row[i] * x[i] - b[i];
+	for( int c = rowStart[i]; c < rowStart[i + 1]; c++ )
+	{
+		t += row[columns[c]] * x[columns[c]];
+	}
+	
+	float l = lo[i];
+	float h = hi[i];
+	if( boxIndex != NULL && boxIndex[i] >= 0 )
+	{
+		float s = x[boxIndex[i]];
+		if( l != -idMath::INFINITY )
+		{
+			l = - idMath::Fabs( l * s );
+		}
+		if( h != idMath::INFINITY )
+		{
+			h = idMath::Fabs( h * s );
+		}
+	}
+	
+	if( x[i] <= l + LCP_BOUND_EPSILON )
+	{
+		return Max( -t, 0.0f );
+	}
+	if( x[i] >= h - LCP_BOUND_EPSILON )
+	{
+		return Max( t, 0.0f );
+	}
+	return idMath::Fabs( t );
+}
+
+/*
+========================
+idLCP_BlockGaussSeidel::Solve
+========================
+*/
+bool idLCP_BlockGaussSeidel::Solve( const idMatX& o_m, idVecX& o_x, const idVecX& o_b, const idVecX& o_lo, const idVecX& o_hi, const int* o_boxIndex )
+{
+	const int n = o_m.GetNumRows();
+	
+	assert( ( ( n + 3 ) & ~3 ) == o_m.GetNumColumns() || n == o_m.GetNumColumns() );
+	assert( o_x.GetSize() == n );
+	assert( o_b.GetSize() == n );
+	assert( o_lo.GetSize() == n );
+	assert( o_hi.GetSize() == n );
+	
+	// gather the off-diagonal non-zeros and merge coupled variables into blocks
+	rowStart.SetNum( n + 1 );
+	columns.SetNum( n * n );
+	parent.SetNum( n );
+	for( int i = 0; i < n; i++ )
+	{
+		parent[i] = i;
+	}
+	
+	int numColumns = 0;
+	for( int i = 0; i < n; i++ )
+	{
+		const float* row = o_m[i];
+		rowStart[i] = numColumns;
+		for( int j = 0; j < n; j++ )
+		{
+			if( row[j] != 0.0f && j != i )
+			{
+				columns[numColumns++] = j;
+				MergeBlocks( i, j );
+			}
+		}
+		if( o_boxIndex != NULL && o_boxIndex[i] >= 0 )
+		{
+			MergeBlocks( i, o_boxIndex[i] );
+		}
+	}
+	rowStart[n] = numColumns;
+	
+	// number the blocks
+	int* blockNum = ( int* ) _alloca16( n * sizeof( int ) );
+	int* rowBlock = ( int* ) _alloca16( n * sizeof( int ) );
+	int numBlocks = 0;
+	for( int i = 0; i < n; i++ )
+	{
+		blockNum[i] = -1;
+	}
+	for( int i = 0; i < n; i++ )
+	{
+		int root = FindBlock( i );
+		if( blockNum[root] < 0 )
+		{
+			blockNum[root] = numBlocks++;
+		}
+		rowBlock[i] = blockNum[root];
+	}
+	
+	// sort the variables per block, the box constrained variables are solved last within a block
+	blockStart.SetNum( numBlocks + 1 );
+	for( int i = 0; i <= numBlocks; i++ )
+	{
+		blockStart[i] = 0;
+	}
+	for( int i = 0; i < n; i++ )
+	{
+		blockStart[rowBlock[i] + 1]++;
+	}
+	for( int i = 0; i < numBlocks; i++ )
+	{
+		blockStart[i + 1] += blockStart[i];
+	}
+	
+	int* next = ( int* ) _alloca16( ( numBlocks + 1 ) * sizeof( int ) );
+	memcpy( next, blockStart.Ptr(), ( numBlocks + 1 ) * sizeof( int ) );
+	
+	order.SetNum( n );
+	for( int pass = 0; pass < 2; pass++ )
+	{
+		for( int i = 0; i < n; i++ )
+		{
+			bool box = ( o_boxIndex != NULL && o_boxIndex[i] >= 0 );
+			if( box == ( pass != 0 ) )
+			{
+				order[next[rowBlock[i]]++] = i;
+			}
+		}
+	}
+	
+	// variables without a positive diagonal cannot be solved for and exert no force
+	float* invDiag = ( float* ) _alloca16( n * sizeof( float ) );
+	for( int i = 0; i < n; i++ )
+	{
+		float d = o_m[i][i];
+		if( d > 0.0f )
+		{
+			invDiag[i] = 1.0f / d;
+		}
+		else
+		{
+			invDiag[i] = 0.0f;
+			o_x[i] = 0.0f;
+		}
+	}
+	
+	int numFailed = 0;
+	float maxError = 0.0f;
+	
+	for( int block = 0; block < numBlocks; block++ )
+	{
+		bool converged = false;
+		
+		for( int iteration = 0; iteration < maxIterations && !converged; iteration++ )
+		{
+			float maxDelta = 0.0f;
+			float maxForce = 0.0f;
+			
+			for( int k = blockStart[block]; k < blockStart[block + 1]; k++ )
+			{
+				const int i = order[k];
+				if( invDiag[i] == 0.0f )
+				{
+					continue;
+				}
+				
+				const float* row = o_m[i];
+				float r = o_b[i] - row[i] * o_x[i];
+				for( int c = rowStart[i]; c < rowStart[i + 1]; c++ )
+				{
+					r -= row[columns[c]] * o_x[columns[c]];
+				}
+				
+				float l = o_lo[i];
+				float h = o_hi[i];
+				if( o_boxIndex != NULL && o_boxIndex[i] >= 0 )
+				{
+					float s = o_x[o_boxIndex[i]];
+					if( l != -idMath::INFINITY )
+					{
+						l = - idMath::Fabs( l * s );
+					}
+					if( h != idMath::INFINITY )
+					{
+						h = idMath::Fabs( h * s );
+					}
+				}
+				
+				float x = o_x[i] + r * invDiag[i];
+				if( x < l )
+				{
+					x = l;
+				}
+				else if( x > h )
+				{
+					x = h;
+				}
+				
+				maxDelta = Max( maxDelta, idMath::Fabs( x - o_x[i] ) );
+				maxForce = Max( maxForce, idMath::Fabs( x ) );
+				o_x[i] = x;
+			}
+			
+			converged = ( maxDelta <= LCP_GS_EPSILON * Max( maxForce, 1.0f ) );
+		}
+		
+		if( !converged )
+		{
+			numFailed++;
+			for( int k = blockStart[block]; k < blockStart[block + 1]; k++ )
+			{
+				maxError = Max( maxError, GetError( o_m, o_x, o_b, o_lo, o_hi, o_boxIndex, order[k] ) );
+			}
+		}
+	}
+	
+	for( int i = 0; i < n; i++ )
+	{
+		if( IEEE_FLT_IS_NAN( o_x[i] ) || IEEE_FLT_IS_INF( o_x[i] ) )
+		{
+			if( lcp_showFailures.GetBool() )
+			{
+				idLib::Printf( "idLCP_BlockGaussSeidel::Solve: diverged\n" );
+			}
+			o_x.Zero();
+			return false;
+		}
+	}
+	
+	if( numFailed )
+	{
+		if( lcp_showFailures.GetBool() )
+		{
+			idLib::Printf( "idLCP_BlockGaussSeidel::Solve: %d of %d blocks did not converge in %d iterations (error %1.4f)\n", numFailed, numBlocks, maxIterations, maxError );
+		}
+	}
+	
+	return true;
+}
+
 /*
 ================================================================================================
 
@@ -3388,6 +3701,18 @@ idLCP* idLCP::AllocSymmetric()
 	return lcp;
 }
 
+/*
+========================
+idLCP::AllocBlockGaussSeidel
+========================
+*/
+idLCP* idLCP::AllocBlockGaussSeidel()
+{
+	idLCP* lcp = new idLCP_BlockGaussSeidel;
+	lcp->SetMaxIterations( 32 );
+	return lcp;
+}
+
 /*
 ========================
 idLCP::~idLCP
@@ -3417,6 +3742,166 @@ int idLCP::GetMaxIterations()
 	return maxIterations;
 }
 
+/*
+========================
+RagdollStack_Test
+
+Times the solvers on block diagonal systems shaped like the auxiliary constraints of a stack
+of ragdolls. Every ragdoll adds a dense block with contacts, box constrained contact friction
+and joint limits. The block Gauss-Seidel solver is timed both from zero and warm started from
+the solution of a slightly different system as happens from one frame to the next.
+========================
+*/
+#define TEST_RAGDOLL_BODIES			12
+#define TEST_RAGDOLL_CONTACTS		6
+#define TEST_RAGDOLL_LIMITS			8
+#define TEST_RAGDOLL_MAX_STACK		8
+#define NUM_RAGDOLL_TESTS			20
+
+static void RagdollStack_Test()
+{
+	const int blockSize = TEST_RAGDOLL_CONTACTS * 3 + TEST_RAGDOLL_LIMITS;
+	
+	idLCP* square = idLCP::AllocSquare();
+	idLCP* symmetric = idLCP::AllocSymmetric();
+	idLCP* gaussSeidel = idLCP::AllocBlockGaussSeidel();
+	
+	idRandom srnd( 13 );
+	idTimer timer;
+	idMatX m, jacobian;
+	idVecX b, nextB, lo, hi, x, reference, warm;
+	idList<int> boxIndex;
+	
+	jacobian.SetSize( blockSize, TEST_RAGDOLL_BODIES * 6 );
+	
+	for( int numRagdolls = 1; numRagdolls <= TEST_RAGDOLL_MAX_STACK; numRagdolls <<= 1 )
+	{
+		const int n = numRagdolls * blockSize;
+		
+		m.Zero( n, n );
+		b.SetSize( n );
+		nextB.SetSize( n );
+		lo.SetSize( n );
+		hi.SetSize( n );
+		boxIndex.SetNum( n );
+		
+		for( int r = 0; r < numRagdolls; r++ )
+		{
+			const int first = r * blockSize;
+			
+			// the constraint matrix of a single ragdoll is J * M^-1 * J^T
+			for( int i = 0; i < jacobian.GetNumRows(); i++ )
+			{
+				for( int j = 0; j < jacobian.GetNumColumns(); j++ )
+				{
+					jacobian[i][j] = srnd.CRandomFloat();
+				}
+			}
+			for( int i = 0; i < blockSize; i++ )
+			{
+				for( int j = 0; j < blockSize; j++ )
+				{
+					float dot = 0.0f;
+					for( int k = 0; k < jacobian.GetNumColumns(); k++ )
+					{
+						dot += jacobian[i][k] * jacobian[j][k];
+					}
+					m[first + i][first + j] = dot;
+				}
+				m[first + i][first + i] += 1e-2f;
+			}
+			
+			for( int i = 0; i < blockSize; i++ )
+			{
+				const int v = first + i;
+				b[v] = srnd.CRandomFloat() * 10.0f;
+				nextB[v] = b[v] + srnd.CRandomFloat() * 0.1f;
+				if( i < TEST_RAGDOLL_CONTACTS )
+				{
+					// contact
+					lo[v] = 0.0f;
+					hi[v] = idMath::INFINITY;
+					boxIndex[v] = -1;
+				}
+				else if( i < TEST_RAGDOLL_CONTACTS * 3 )
+				{
+					// contact friction
+					lo[v] = -0.5f;
+					hi[v] = 0.5f;
+					boxIndex[v] = first + ( i - TEST_RAGDOLL_CONTACTS ) / 2;
+				}
+				else
+				{
+					// joint limit
+					lo[v] = 0.0f;
+					hi[v] = idMath::INFINITY;
+					boxIndex[v] = -1;
+				}
+			}
+		}
+		
+		double msSquare = idMath::INFINITY;
+		for( int j = 0; j < NUM_RAGDOLL_TESTS; j++ )
+		{
+			x.Zero( n );
+			timer.Clear();
+			timer.Start();
+			square->Solve( m, x, b, lo, hi, boxIndex.Ptr() );
+			timer.Stop();
+			msSquare = Min( msSquare, timer.Milliseconds() );
+		}
+		
+		double msSymmetric = idMath::INFINITY;
+		for( int j = 0; j < NUM_RAGDOLL_TESTS; j++ )
+		{
+			reference.Zero( n );
+			timer.Clear();
+			timer.Start();
+			symmetric->Solve( m, reference, b, lo, hi, boxIndex.Ptr() );
+			timer.Stop();
+			msSymmetric = Min( msSymmetric, timer.Milliseconds() );
+		}
+		
+		double msCold = idMath::INFINITY;
+		for( int j = 0; j < NUM_RAGDOLL_TESTS; j++ )
+		{
+			x.Zero( n );
+			timer.Clear();
+			timer.Start();
+			gaussSeidel->Solve( m, x, b, lo, hi, boxIndex.Ptr() );
+			timer.Stop();
+			msCold = Min( msCold, timer.Milliseconds() );
+		}
+		
+		float coldError = 0.0f;
+		for( int i = 0; i < n; i++ )
+		{
+			coldError = Max( coldError, idMath::Fabs( x[i] - reference[i] ) );
+		}
+		
+		double msWarm = idMath::INFINITY;
+		for( int j = 0; j < NUM_RAGDOLL_TESTS; j++ )
+		{
+			warm = x;
+			timer.Clear();
+			timer.Start();
+			gaussSeidel->Solve( m, warm, nextB, lo, hi, boxIndex.Ptr() );
+			timer.Stop();
+			msWarm = Min( msWarm, timer.Milliseconds() );
+		}
+		
+		idLib::Printf( "%d ragdolls, %d variables:\n", numRagdolls, n );
+		idLib::Printf( "  idLCP_Square              %8.3f ms\n", msSquare );
+		idLib::Printf( "  idLCP_Symmetric           %8.3f ms\n", msSymmetric );
+		idLib::Printf( "  idLCP_BlockGaussSeidel    %8.3f ms (max difference %1.4f)\n", msCold, coldError );
+		idLib::Printf( "  idLCP_BlockGaussSeidel    %8.3f ms (warm started)\n", msWarm );
+	}
+	
+	delete square;
+	delete symmetric;
+	delete gaussSeidel;
+}
+
 /*
 ========================
 idLCP::Test_f
@@ -3430,4 +3915,5 @@ void idLCP::Test_f( const idCmdArgs& args )
 	LowerTriangularSolveTranspose_Test();
 	LDLT_Factor_Test();
 #endif
+	RagdollStack_Test();
 }
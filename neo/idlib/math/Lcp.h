@@ -55,6 +55,10 @@ If boxIndex != NULL and boxIndex[i] != -1, then
 
 Before calculating any of the bounded x[i] with boxIndex[i] != -1, the solver calculates all
 unbounded x[i] and all x[i] with boxIndex[i] == -1.
+
+The pivoting solvers ignore the incoming 'x'. The iterative block Gauss-Seidel solver starts
+from the incoming 'x', which allows warm starting with the solution of the previous frame, and
+stops after the maximum number of iterations even if it has not converged yet.
 ================================================
 */
 class idLCP
@@ -62,6 +66,7 @@ class idLCP
 public:
 	static idLCP* 	AllocSquare();		// 'A' must be a square matrix
 	static idLCP* 	AllocSymmetric();	// 'A' must be a symmetric matrix
+	static idLCP* 	AllocBlockGaussSeidel();	// 'A' must be symmetric positive semi-definite, 'x' is the initial guess
 	
 	virtual			~idLCP();
 	
@@ -36,11 +36,8 @@ If you have questions concerning this license or the applicable additional terms
 //
 //===============================================================
 
-float	idMatX::temp[MATX_MAX_TEMP + 4];
-// RB: changed int to intptr_t
-float* 	idMatX::tempPtr = ( float* )( ( ( intptr_t ) idMatX::temp + 15 ) & ~15 );
-// RB end
-int		idMatX::tempIndex = 0;
+ALIGN16( ID_THREAD_LOCAL float idMatX::temp[MATX_MAX_TEMP] );
+ID_THREAD_LOCAL int idMatX::tempIndex = 0;
 
 
 /*
@@ -1283,96 +1280,7 @@ idMatX::LU_Factor
 */
 bool idMatX::LU_Factor( int* index, float* det )
 {
-	int i, j, k, newi, min;
-	double s, t, d, w;
-	
-	// if partial pivoting should be used
-	if( index )
-	{
-		for( i = 0; i < numRows; i++ )
-		{
-			index[i] = i;
-		}
-	}
-	
-	w = 1.0f;
-	min = Min( numRows, numColumns );
-	for( i = 0; i < min; i++ )
-	{
-	
-		newi = i;
-		s = idMath::Fabs( ( *this )[i][i] );
-		
-		if( index )
-		{
-			// find the largest absolute pivot
-			for( j = i + 1; j < numRows; j++ )
-			{
-				t = idMath::Fabs( ( *this )[j][i] );
-				if( t > s )
-				{
-					newi = j;
-					s = t;
-				}
-			}
-		}
-		
-		if( s == 0.0f )
-		{
-			return false;
-		}
-		
-		if( newi != i && index )
-		{
-		
-			w = -w;
-			
-			// swap index elements
-			k = index[i];
-			index[i] = index[newi];
-			index[newi] = k;
-			
-			// swap rows
-			for( j = 0; j < numColumns; j++ )
-			{
-				t = ( *this )[newi][j];
-				( *this )[newi][j] = ( *this )[i][j];
-				( *this )[i][j] = t;
-			}
-		}
-		
-		if( i < numRows )
-		{
-			d = 1.0f / ( *this )[i][i];
-			for( j = i + 1; j < numRows; j++ )
-			{
-				( *this )[j][i] *= d;
-			}
-		}
-		
-		if( i < min - 1 )
-		{
-			for( j = i + 1; j < numRows; j++ )
-			{
-				d = ( *this )[j][i];
-				for( k = i + 1; k < numColumns; k++ )
-				{
-					( *this )[j][k] -= d * ( *this )[i][k];
-				}
-			}
-		}
-	}
-	
-	if( det )
-	{
-		for( i = 0; i < numRows; i++ )
-		{
-			w *= ( *this )[i][i];
-		}
-		*det = w;
-	}
-	
-	return true;
+	return SIMDProcessor->MatX_LU_Factor( *this, index, det );
 }
 
 /*
@@ -2968,43 +2876,9 @@ idMatX::Cholesky_Factor
 */
 bool idMatX::Cholesky_Factor()
 {
-	int i, j, k;
-	float* invSqrt;
-	double sum;
-	
 	assert( numRows == numColumns );
 	
-	invSqrt = ( float* ) _alloca16( numRows * sizeof( float ) );
-	
-	for( i = 0; i < numRows; i++ )
-	{
-	
-		for( j = 0; j < i; j++ )
-		{
-		
-			sum = ( *this )[i][j];
-			for( k = 0; k < j; k++ )
-			{
-				sum -= ( *this )[i][k] * ( *this )[j][k];
-			}
-			( *this )[i][j] = sum * invSqrt[j];
-		}
-		
-		sum = ( *this )[i][i];
-		for( k = 0; k < i; k++ )
-		{
-			sum -= ( *this )[i][k] * ( *this )[i][k];
-		}
-		
-		if( sum <= 0.0f )
-		{
-			return false;
-		}
-		
-		invSqrt[i] = idMath::InvSqrt( sum );
-		( *this )[i][i] = invSqrt[i] * sum;
-	}
-	return true;
+	return SIMDProcessor->MatX_Cholesky_Factor( *this, numRows );
 }
 
 /*
@@ -3478,45 +3352,9 @@ idMatX::LDLT_Factor
 */
 bool idMatX::LDLT_Factor()
 {
-	int i, j, k;
-	float* v;
-	double d, sum;
-	
 	assert( numRows == numColumns );
 	
-	v = ( float* ) _alloca16( numRows * sizeof( float ) );
-	
-	for( i = 0; i < numRows; i++ )
-	{
-	
-		sum = ( *this )[i][i];
-		for( j = 0; j < i; j++ )
-		{
-			d = ( *this )[i][j];
-			v[j] = ( *this )[j][j] * d;
-			sum -= v[j] * d;
-		}
-		
-		if( sum == 0.0f )
-		{
-			return false;
-		}
-		
-		( *this )[i][i] = sum;
-		d = 1.0f / sum;
-		
-		for( j = i + 1; j < numRows; j++ )
-		{
-			sum = ( *this )[j][i];
-			for( k = 0; k < i; k++ )
-			{
-				sum -= ( *this )[j][k] * v[k];
-			}
-			( *this )[j][i] = sum * d;
-		}
-	}
-	
-	return true;
+	return SIMDProcessor->MatX_LDLT_Factor( *this, numRows );
 }
 
 /*
@@ -3904,22 +3742,13 @@ idMatX::LDLT_Solve
 */
 void idMatX::LDLT_Solve( idVecX& x, const idVecX& b ) const
 {
-	int i, j;
-	double sum;
+	int i;
 	
 	assert( numRows == numColumns );
 	assert( x.GetSize() >= numRows && b.GetSize() >= numRows );
 	
 	// solve L
-	for( i = 0; i < numRows; i++ )
-	{
-		sum = b[i];
-		for( j = 0; j < i; j++ )
-		{
-			sum -= ( *this )[i][j] * x[j];
-		}
-		x[i] = sum;
-	}
+	SIMDProcessor->MatX_LowerTriangularSolve( *this, x.ToFloatPtr(), b.ToFloatPtr(), numRows );
 	
 	// solve D
 	for( i = 0; i < numRows; i++ )
@@ -3928,15 +3757,7 @@ void idMatX::LDLT_Solve( idVecX& x, const idVecX& b ) const
 	}
 	
 	// solve Lt
-	for( i = numRows - 2; i >= 0; i-- )
-	{
-		sum = x[i];
-		for( j = i + 1; j < numRows; j++ )
-		{
-			sum -= ( *this )[j][i] * x[j];
-		}
-		x[i] = sum;
-	}
+	SIMDProcessor->MatX_LowerTriangularSolveTranspose( *this, x.ToFloatPtr(), x.ToFloatPtr(), numRows );
 }
 
 /*
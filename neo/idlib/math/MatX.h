@@ -36,7 +36,7 @@ idMatX - arbitrary sized dense real matrix
 
 The matrix lives on 16 byte aligned and 16 byte padded memory.
 
-NOTE: due to the temporary memory pool idMatX cannot be used by multiple threads.
+The temporary memory pool used for intermediate results is local to each thread.
 
 ===============================================================================
 */
@@ -261,9 +261,8 @@ private:
 	int				alloced;				// floats allocated, if -1 then mat points to data set with SetData
 	float* 			mat;					// memory the matrix is stored
 	
-	static float	temp[MATX_MAX_TEMP + 4];	// used to store intermediate results
-	static float* 	tempPtr;				// pointer to 16 byte aligned temporary memory
-	static int		tempIndex;				// index into memory pool, wraps around
+	ALIGN16( static ID_THREAD_LOCAL float temp[MATX_MAX_TEMP] );	// used to store intermediate results
+	static ID_THREAD_LOCAL int	tempIndex;	// index into memory pool, wraps around
 	
 private:
 	void			SetTempSize( int rows, int columns );
@@ -299,7 +298,7 @@ idMatX::~idMatX
 ID_INLINE idMatX::~idMatX()
 {
 	// if not temp memory
-	if( mat != NULL && ( mat < idMatX::tempPtr || mat > idMatX::tempPtr + MATX_MAX_TEMP ) && alloced != -1 )
+	if( mat != NULL && ( mat < idMatX::temp || mat > idMatX::temp + MATX_MAX_TEMP ) && alloced != -1 )
 	{
 		Mem_Free16( mat );
 	}
@@ -725,7 +724,7 @@ ID_INLINE void idMatX::SetSize( int rows, int columns )
 {
 	if( rows != numRows || columns != numColumns || mat == NULL )
 	{
-		assert( mat < idMatX::tempPtr || mat > idMatX::tempPtr + MATX_MAX_TEMP );
+		assert( mat < idMatX::temp || mat > idMatX::temp + MATX_MAX_TEMP );
 		int alloc = ( rows * columns + 3 ) & ~3;
 		if( alloc > alloced && alloced != -1 )
 		{
@@ -757,7 +756,7 @@ ID_INLINE void idMatX::SetTempSize( int rows, int columns )
 	{
 		idMatX::tempIndex = 0;
 	}
-	mat = idMatX::tempPtr + idMatX::tempIndex;
+	mat = idMatX::temp + idMatX::tempIndex;
 	idMatX::tempIndex += newSize;
 	alloced = newSize;
 	numRows = rows;
@@ -772,7 +771,7 @@ idMatX::SetData
 */
 ID_INLINE void idMatX::SetData( int rows, int columns, float* data )
 {
-	assert( mat < idMatX::tempPtr || mat > idMatX::tempPtr + MATX_MAX_TEMP );
+	assert( mat < idMatX::temp || mat > idMatX::temp + MATX_MAX_TEMP );
 	if( mat != NULL && alloced != -1 )
 	{
 		Mem_Free16( mat );
@@ -1477,24 +1476,7 @@ idMatX::Multiply
 ID_INLINE void idMatX::Multiply( idVecX& dst, const idVecX& vec ) const
 {
 	dst.SetSize( numRows );
-	const float* mPtr = mat;
-	const float* vPtr = vec.ToFloatPtr();
-	float* dstPtr = dst.ToFloatPtr();
-	float* temp = ( float* )_alloca16( numRows * sizeof( float ) );
-	for( int i = 0; i < numRows; i++ )
-	{
-		float sum = mPtr[0] * vPtr[0];
-		for( int j = 1; j < numColumns; j++ )
-		{
-			sum += mPtr[j] * vPtr[j];
-		}
-		temp[i] = sum;
-		mPtr += numColumns;
-	}
-	for( int i = 0; i < numRows; i++ )
-	{
-		dstPtr[i] = temp[i];
-	}
+	SIMDProcessor->MatX_MultiplyVecX( dst, *this, vec );
 }
 
 /*
@@ -1505,24 +1487,7 @@ idMatX::MultiplyAdd
 ID_INLINE void idMatX::MultiplyAdd( idVecX& dst, const idVecX& vec ) const
 {
 	assert( dst.GetSize() == numRows );
-	const float* mPtr = mat;
-	const float* vPtr = vec.ToFloatPtr();
-	float* dstPtr = dst.ToFloatPtr();
-	float* temp = ( float* )_alloca16( numRows * sizeof( float ) );
-	for( int i = 0; i < numRows; i++ )
-	{
-		float sum = mPtr[0] * vPtr[0];
-		for( int j = 1; j < numColumns; j++ )
-		{
-			sum += mPtr[j] * vPtr[j];
-		}
-		temp[i] = dstPtr[i] + sum;
-		mPtr += numColumns;
-	}
-	for( int i = 0; i < numRows; i++ )
-	{
-		dstPtr[i] = temp[i];
-	}
+	SIMDProcessor->MatX_MultiplyAddVecX( dst, *this, vec );
 }
 
 /*
@@ -1533,24 +1498,7 @@ idMatX::MultiplySub
 ID_INLINE void idMatX::MultiplySub( idVecX& dst, const idVecX& vec ) const
 {
 	assert( dst.GetSize() == numRows );
-	const float* mPtr = mat;
-	const float* vPtr = vec.ToFloatPtr();
-	float* dstPtr = dst.ToFloatPtr();
-	float* temp = ( float* )_alloca16( numRows * sizeof( float ) );
-	for( int i = 0; i < numRows; i++ )
-	{
-		float sum = mPtr[0] * vPtr[0];
-		for( int j = 1; j < numColumns; j++ )
-		{
-			sum += mPtr[j] * vPtr[j];
-		}
-		temp[i] = dstPtr[i] - sum;
-		mPtr += numColumns;
-	}
-	for( int i = 0; i < numRows; i++ )
-	{
-		dstPtr[i] = temp[i];
-	}
+	SIMDProcessor->MatX_MultiplySubVecX( dst, *this, vec );
 }
 
 /*
@@ -1561,24 +1509,7 @@ idMatX::TransposeMultiply
 ID_INLINE void idMatX::TransposeMultiply( idVecX& dst, const idVecX& vec ) const
 {
 	dst.SetSize( numColumns );
-	const float* vPtr = vec.ToFloatPtr();
-	float* dstPtr = dst.ToFloatPtr();
-	float* temp = ( float* )_alloca16( numColumns * sizeof( float ) );
-	for( int i = 0; i < numColumns; i++ )
-	{
-		const float* mPtr = mat + i;
-		float sum = mPtr[0] * vPtr[0];
-		for( int j = 1; j < numRows; j++ )
-		{
-			mPtr += numColumns;
-			sum += mPtr[0] * vPtr[j];
-		}
-		temp[i] = sum;
-	}
-	for( int i = 0; i < numColumns; i++ )
-	{
-		dstPtr[i] = temp[i];
-	}
+	SIMDProcessor->MatX_TransposeMultiplyVecX( dst, *this, vec );
 }
 
 /*
@@ -1589,24 +1520,7 @@ idMatX::TransposeMultiplyAdd
 ID_INLINE void idMatX::TransposeMultiplyAdd( idVecX& dst, const idVecX& vec ) const
 {
 	assert( dst.GetSize() == numColumns );
-	const float* vPtr = vec.ToFloatPtr();
-	float* dstPtr = dst.ToFloatPtr();
-	float* temp = ( float* )_alloca16( numColumns * sizeof( float ) );
-	for( int i = 0; i < numColumns; i++ )
-	{
-		const float* mPtr = mat + i;
-		float sum = mPtr[0] * vPtr[0];
-		for( int j = 1; j < numRows; j++ )
-		{
-			mPtr += numColumns;
-			sum += mPtr[0] * vPtr[j];
-		}
-		temp[i] = dstPtr[i] + sum;
-	}
-	for( int i = 0; i < numColumns; i++ )
-	{
-		dstPtr[i] = temp[i];
-	}
+	SIMDProcessor->MatX_TransposeMultiplyAddVecX( dst, *this, vec );
 }
 
 /*
@@ -1617,24 +1531,7 @@ idMatX::TransposeMultiplySub
 ID_INLINE void idMatX::TransposeMultiplySub( idVecX& dst, const idVecX& vec ) const
 {
 	assert( dst.GetSize() == numColumns );
-	const float* vPtr = vec.ToFloatPtr();
-	float* dstPtr = dst.ToFloatPtr();
-	float* temp = ( float* )_alloca16( numColumns * sizeof( float ) );
-	for( int i = 0; i < numColumns; i++ )
-	{
-		const float* mPtr = mat + i;
-		float sum = mPtr[0] * vPtr[0];
-		for( int j = 1; j < numRows; j++ )
-		{
-			mPtr += numColumns;
-			sum += mPtr[0] * vPtr[j];
-		}
-		temp[i] = dstPtr[i] - sum;
-	}
-	for( int i = 0; i < numColumns; i++ )
-	{
-		dstPtr[i] = temp[i];
-	}
+	SIMDProcessor->MatX_TransposeMultiplySubVecX( dst, *this, vec );
 }
 
 /*
@@ -36,6 +36,7 @@ If you have questions concerning this license or the applicable additional terms
 
 #include "Simd_Generic.h"
 #include "Simd_SSE.h"
+#include "Simd_AVX2.h"
 
 idSIMDProcessor*		processor = NULL;			// pointer to SIMD processor
 idSIMDProcessor* 	generic = NULL;				// pointer to generic SIMD implementation
@@ -78,10 +79,19 @@ void idSIMD::InitProcessor( const char* module, bool forceGeneric )
 		if( processor == NULL )
 		{
 #if defined(USE_INTRINSICS)
-			if( ( cpuid & CPUID_MMX ) && ( cpuid & CPUID_SSE ) )
+			if( ( cpuid & CPUID_MMX ) && ( cpuid & CPUID_SSE ) && ( cpuid & CPUID_AVX2 ) && ( cpuid & CPUID_FMA3 ) )
+			{
+				processor = new( TAG_MATH ) idSIMD_AVX2<idSIMD_SSE>;
+			}
+			else if( ( cpuid & CPUID_MMX ) && ( cpuid & CPUID_SSE ) )
 			{
 				processor = new( TAG_MATH ) idSIMD_SSE;
 			}
+			else if( ( cpuid & CPUID_AVX2 ) && ( cpuid & CPUID_FMA3 ) )
+			{
+				// only the idMatX kernels change, the rest stays generic
+				processor = new( TAG_MATH ) idSIMD_AVX2<idSIMD_Generic>;
+			}
 			else
 #endif
 			{
@@ -183,8 +193,26 @@ double ticksPerNanosecond;
 #define StopRecordTime( end )				\
 	end = mach_absolute_time();
 
-#else // not _MSC_VER and _M_IX86 or __APPLE__
-// FIXME: meaningful values/functions here for Linux?
+#elif defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+
+// read the time stamp counter through the compiler intrinsic where inline assembly is not available
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define ReadTimeStampCounter()				__rdtsc()
+#else
+#define ReadTimeStampCounter()				__builtin_ia32_rdtsc()
+#endif
+
+#define TIME_TYPE uint64_t
+
+#define StartRecordTime( start )			\
+	start = ReadTimeStampCounter();
+
+#define StopRecordTime( end )				\
+	end = ReadTimeStampCounter();
+
+#else // not _MSC_VER and _M_IX86 or __APPLE__ or x86
+// FIXME: meaningful values/functions here for other CPUs?
 #define TIME_TYPE int
 
 #define StartRecordTime( start )			\
@@ -956,6 +984,370 @@ void TestUntransformJoints()
 	PrintClocks( va( "   simd->UntransformJoints() %s", result ), COUNT, bestClocksSIMD, bestClocksGeneric );
 }
 
+#define MATX_NUMTESTS		64			// number of tests for the matrix routines, the big sizes are slow
+#define MATX_SIMD_EPSILON	1e-3f
+
+static const int matxSizes[] = { 6, 12, 24, 50, 100, 200 };
+
+/*
+============
+RandomMatX
+============
+*/
+static void RandomMatX( idMatX& mat, idRandom& rnd, const int rows, const int columns )
+{
+	mat.SetSize( rows, columns );
+	for( int i = 0; i < rows; i++ )
+	{
+		for( int j = 0; j < columns; j++ )
+		{
+			mat[i][j] = rnd.CRandomFloat();
+		}
+	}
+}
+
+/*
+============
+RandomPositiveDefiniteMatX
+
+  symmetric and diagonally dominant so the factorizations never break down
+============
+*/
+static void RandomPositiveDefiniteMatX( idMatX& mat, idRandom& rnd, const int size )
+{
+	mat.SetSize( size, size );
+	for( int i = 0; i < size; i++ )
+	{
+		for( int j = 0; j < i; j++ )
+		{
+			mat[i][j] = mat[j][i] = rnd.CRandomFloat();
+		}
+		mat[i][i] = size + rnd.RandomFloat();
+	}
+}
+
+/*
+============
+RandomVecX
+============
+*/
+static void RandomVecX( idVecX& vec, idRandom& rnd, const int size )
+{
+	vec.SetSize( size );
+	for( int i = 0; i < size; i++ )
+	{
+		vec[i] = rnd.CRandomFloat();
+	}
+}
+
+/*
+============
+TestMatXMultiplyVecX
+============
+*/
+void TestMatXMultiplyVecX()
+{
+	int i, j;
+	TIME_TYPE start, end, bestClocksGeneric, bestClocksSIMD;
+	idMatX mat;
+	idVecX src, dst1, dst2;
+	const char* result;
+	
+	idRandom srnd( RANDOM_SEED );
+	
+	for( i = 0; i < ARRAY_COUNT( matxSizes ); i++ )
+	{
+		const int size = matxSizes[i];
+		
+		RandomMatX( mat, srnd, size, size );
+		RandomVecX( src, srnd, size );
+		dst1.SetSize( size );
+		dst2.SetSize( size );
+		
+		bestClocksGeneric = 0;
+		for( j = 0; j < MATX_NUMTESTS; j++ )
+		{
+			StartRecordTime( start );
+			p_generic->MatX_MultiplyVecX( dst1, mat, src );
+			StopRecordTime( end );
+			GetBest( start, end, bestClocksGeneric );
+		}
+		PrintClocks( va( "generic->MatX_MultiplyVecX( %dx%d )", size, size ), size, bestClocksGeneric );
+		
+		bestClocksSIMD = 0;
+		for( j = 0; j < MATX_NUMTESTS; j++ )
+		{
+			StartRecordTime( start );
+			p_simd->MatX_MultiplyVecX( dst2, mat, src );
+			StopRecordTime( end );
+			GetBest( start, end, bestClocksSIMD );
+		}
+		
+		result = dst1.Compare( dst2, MATX_SIMD_EPSILON ) ? "ok" : S_COLOR_RED"X";
+		PrintClocks( va( "   simd->MatX_MultiplyVecX( %dx%d ) %s", size, size, result ), size, bestClocksSIMD, bestClocksGeneric );
+	}
+}
+
+/*
+============
+TestMatXTransposeMultiplyVecX
+============
+*/
+void TestMatXTransposeMultiplyVecX()
+{
+	int i, j;
+	TIME_TYPE start, end, bestClocksGeneric, bestClocksSIMD;
+	idMatX mat;
+	idVecX src, dst1, dst2;
+	const char* result;
+	
+	idRandom srnd( RANDOM_SEED );
+	
+	for( i = 0; i < ARRAY_COUNT( matxSizes ); i++ )
+	{
+		const int size = matxSizes[i];
+		
+		RandomMatX( mat, srnd, size, size );
+		RandomVecX( src, srnd, size );
+		dst1.SetSize( size );
+		dst2.SetSize( size );
+		
+		bestClocksGeneric = 0;
+		for( j = 0; j < MATX_NUMTESTS; j++ )
+		{
+			StartRecordTime( start );
+			p_generic->MatX_TransposeMultiplyVecX( dst1, mat, src );
+			StopRecordTime( end );
+			GetBest( start, end, bestClocksGeneric );
+		}
+		PrintClocks( va( "generic->MatX_TransposeMultiplyVecX( %dx%d )", size, size ), size, bestClocksGeneric );
+		
+		bestClocksSIMD = 0;
+		for( j = 0; j < MATX_NUMTESTS; j++ )
+		{
+			StartRecordTime( start );
+			p_simd->MatX_TransposeMultiplyVecX( dst2, mat, src );
+			StopRecordTime( end );
+			GetBest( start, end, bestClocksSIMD );
+		}
+		
+		result = dst1.Compare( dst2, MATX_SIMD_EPSILON ) ? "ok" : S_COLOR_RED"X";
+		PrintClocks( va( "   simd->MatX_TransposeMultiplyVecX( %dx%d ) %s", size, size, result ), size, bestClocksSIMD, bestClocksGeneric );
+	}
+}
+
+/*
+============
+TestMatXLowerTriangularSolve
+============
+*/
+void TestMatXLowerTriangularSolve()
+{
+	int i, j;
+	TIME_TYPE start, end, bestClocksGeneric, bestClocksSIMD;
+	idMatX L;
+	idVecX b, x1, x2;
+	const char* result;
+	
+	idRandom srnd( RANDOM_SEED );
+	
+	for( i = 0; i < ARRAY_COUNT( matxSizes ); i++ )
+	{
+		const int size = matxSizes[i];
+		
+		RandomPositiveDefiniteMatX( L, srnd, size );
+		p_generic->MatX_LDLT_Factor( L, size );
+		RandomVecX( b, srnd, size );
+		x1.SetSize( size );
+		x2.SetSize( size );
+		
+		bestClocksGeneric = 0;
+		for( j = 0; j < MATX_NUMTESTS; j++ )
+		{
+			StartRecordTime( start );
+			p_generic->MatX_LowerTriangularSolve( L, x1.ToFloatPtr(), b.ToFloatPtr(), size );
+			StopRecordTime( end );
+			GetBest( start, end, bestClocksGeneric );
+		}
+		PrintClocks( va( "generic->MatX_LowerTriangularSolve( %dx%d )", size, size ), size, bestClocksGeneric );
+		
+		bestClocksSIMD = 0;
+		for( j = 0; j < MATX_NUMTESTS; j++ )
+		{
+			StartRecordTime( start );
+			p_simd->MatX_LowerTriangularSolve( L, x2.ToFloatPtr(), b.ToFloatPtr(), size );
+			StopRecordTime( end );
+			GetBest( start, end, bestClocksSIMD );
+		}
+		
+		result = x1.Compare( x2, MATX_SIMD_EPSILON ) ? "ok" : S_COLOR_RED"X";
+		PrintClocks( va( "   simd->MatX_LowerTriangularSolve( %dx%d ) %s", size, size, result ), size, bestClocksSIMD, bestClocksGeneric );
+		
+		bestClocksGeneric = 0;
+		for( j = 0; j < MATX_NUMTESTS; j++ )
+		{
+			StartRecordTime( start );
+			p_generic->MatX_LowerTriangularSolveTranspose( L, x1.ToFloatPtr(), b.ToFloatPtr(), size );
+			StopRecordTime( end );
+			GetBest( start, end, bestClocksGeneric );
+		}
+		PrintClocks( va( "generic->MatX_LowerTriangularSolveTranspose( %dx%d )", size, size ), size, bestClocksGeneric );
+		
+		bestClocksSIMD = 0;
+		for( j = 0; j < MATX_NUMTESTS; j++ )
+		{
+			StartRecordTime( start );
+			p_simd->MatX_LowerTriangularSolveTranspose( L, x2.ToFloatPtr(), b.ToFloatPtr(), size );
+			StopRecordTime( end );
+			GetBest( start, end, bestClocksSIMD );
+		}
+		
+		result = x1.Compare( x2, MATX_SIMD_EPSILON ) ? "ok" : S_COLOR_RED"X";
+		PrintClocks( va( "   simd->MatX_LowerTriangularSolveTranspose( %dx%d ) %s", size, size, result ), size, bestClocksSIMD, bestClocksGeneric );
+	}
+}
+
+/*
+============
+TestMatXLUFactor
+============
+*/
+void TestMatXLUFactor()
+{
+	int i, j;
+	TIME_TYPE start, end, bestClocksGeneric, bestClocksSIMD;
+	idMatX src, m1, m2;
+	idTempArray< int > index1( 256 );
+	idTempArray< int > index2( 256 );
+	float det1 = 0.0f, det2 = 0.0f;
+	const char* result;
+	
+	idRandom srnd( RANDOM_SEED );
+	
+	for( i = 0; i < ARRAY_COUNT( matxSizes ); i++ )
+	{
+		const int size = matxSizes[i];
+		
+		RandomMatX( src, srnd, size, size );
+		
+		bestClocksGeneric = 0;
+		for( j = 0; j < MATX_NUMTESTS; j++ )
+		{
+			m1 = src;
+			StartRecordTime( start );
+			p_generic->MatX_LU_Factor( m1, index1.Ptr(), &det1 );
+			StopRecordTime( end );
+			GetBest( start, end, bestClocksGeneric );
+		}
+		PrintClocks( va( "generic->MatX_LU_Factor( %dx%d )", size, size ), size, bestClocksGeneric );
+		
+		bestClocksSIMD = 0;
+		for( j = 0; j < MATX_NUMTESTS; j++ )
+		{
+			m2 = src;
+			StartRecordTime( start );
+			p_simd->MatX_LU_Factor( m2, index2.Ptr(), &det2 );
+			StopRecordTime( end );
+			GetBest( start, end, bestClocksSIMD );
+		}
+		
+		result = ( m1.Compare( m2, MATX_SIMD_EPSILON ) && memcmp( index1.Ptr(), index2.Ptr(), size * sizeof( int ) ) == 0 ) ? "ok" : S_COLOR_RED"X";
+		PrintClocks( va( "   simd->MatX_LU_Factor( %dx%d ) %s", size, size, result ), size, bestClocksSIMD, bestClocksGeneric );
+	}
+}
+
+/*
+============
+TestMatXCholeskyFactor
+============
+*/
+void TestMatXCholeskyFactor()
+{
+	int i, j;
+	TIME_TYPE start, end, bestClocksGeneric, bestClocksSIMD;
+	idMatX src, m1, m2;
+	const char* result;
+	
+	idRandom srnd( RANDOM_SEED );
+	
+	for( i = 0; i < ARRAY_COUNT( matxSizes ); i++ )
+	{
+		const int size = matxSizes[i];
+		
+		RandomPositiveDefiniteMatX( src, srnd, size );
+		
+		bestClocksGeneric = 0;
+		for( j = 0; j < MATX_NUMTESTS; j++ )
+		{
+			m1 = src;
+			StartRecordTime( start );
+			p_generic->MatX_Cholesky_Factor( m1, size );
+			StopRecordTime( end );
+			GetBest( start, end, bestClocksGeneric );
+		}
+		PrintClocks( va( "generic->MatX_Cholesky_Factor( %dx%d )", size, size ), size, bestClocksGeneric );
+		
+		bestClocksSIMD = 0;
+		for( j = 0; j < MATX_NUMTESTS; j++ )
+		{
+			m2 = src;
+			StartRecordTime( start );
+			p_simd->MatX_Cholesky_Factor( m2, size );
+			StopRecordTime( end );
+			GetBest( start, end, bestClocksSIMD );
+		}
+		
+		result = m1.Compare( m2, MATX_SIMD_EPSILON ) ? "ok" : S_COLOR_RED"X";
+		PrintClocks( va( "   simd->MatX_Cholesky_Factor( %dx%d ) %s", size, size, result ), size, bestClocksSIMD, bestClocksGeneric );
+	}
+}
+
+/*
+============
+TestMatXLDLTFactor
+============
+*/
+void TestMatXLDLTFactor()
+{
+	int i, j;
+	TIME_TYPE start, end, bestClocksGeneric, bestClocksSIMD;
+	idMatX src, m1, m2;
+	const char* result;
+	
+	idRandom srnd( RANDOM_SEED );
+	
+	for( i = 0; i < ARRAY_COUNT( matxSizes ); i++ )
+	{
+		const int size = matxSizes[i];
+		
+		RandomPositiveDefiniteMatX( src, srnd, size );
+		
+		bestClocksGeneric = 0;
+		for( j = 0; j < MATX_NUMTESTS; j++ )
+		{
+			m1 = src;
+			StartRecordTime( start );
+			p_generic->MatX_LDLT_Factor( m1, size );
+			StopRecordTime( end );
+			GetBest( start, end, bestClocksGeneric );
+		}
+		PrintClocks( va( "generic->MatX_LDLT_Factor( %dx%d )", size, size ), size, bestClocksGeneric );
+		
+		bestClocksSIMD = 0;
+		for( j = 0; j < MATX_NUMTESTS; j++ )
+		{
+			m2 = src;
+			StartRecordTime( start );
+			p_simd->MatX_LDLT_Factor( m2, size );
+			StopRecordTime( end );
+			GetBest( start, end, bestClocksSIMD );
+		}
+		
+		result = m1.Compare( m2, MATX_SIMD_EPSILON ) ? "ok" : S_COLOR_RED"X";
+		PrintClocks( va( "   simd->MatX_LDLT_Factor( %dx%d ) %s", size, size, result ), size, bestClocksSIMD, bestClocksGeneric );
+	}
+}
+
 /*
 ============
 TestMath
@@ -1399,10 +1791,26 @@ void idSIMD::Test_f( const idCmdArgs& args )
 			}
 			p_simd = new( TAG_MATH ) idSIMD_SSE;
 		}
+		else if( idStr::Icmp( argString, "AVX2" ) == 0 )
+		{
+			if( !( cpuid & CPUID_AVX2 ) || !( cpuid & CPUID_FMA3 ) )
+			{
+				common->Printf( "CPU does not support AVX2 & FMA3\n" );
+				return;
+			}
+			if( ( cpuid & CPUID_MMX ) && ( cpuid & CPUID_SSE ) )
+			{
+				p_simd = new( TAG_MATH ) idSIMD_AVX2<idSIMD_SSE>;
+			}
+			else
+			{
+				p_simd = new( TAG_MATH ) idSIMD_AVX2<idSIMD_Generic>;
+			}
+		}
 		else
 #endif
 		{
-			common->Printf( "invalid argument, use: MMX, 3DNow, SSE, SSE2, SSE3, AltiVec\n" );
+			common->Printf( "invalid argument, use: MMX, 3DNow, SSE, SSE2, SSE3, AVX2, AltiVec\n" );
 			return;
 		}
 	}
@@ -1429,6 +1837,24 @@ void idSIMD::Test_f( const idCmdArgs& args )
 	
 	idLib::common->Printf( "====================================\n" );
 	
+	TestMatXMultiplyVecX();
+	TestMatXTransposeMultiplyVecX();
+	TestMatXLowerTriangularSolve();
+	TestMatXLUFactor();
+	TestMatXCholeskyFactor();
+	TestMatXLDLTFactor();
+	
+	idLib::common->Printf( "====================================\n" );
+	
+	// the idMatX self tests go through SIMDProcessor
+	idSIMDProcessor* oldProcessor = SIMDProcessor;
+	SIMDProcessor = p_simd;
+	idLib::common->Printf( "idMatX::Test() using %s\n", p_simd->GetName() );
+	idMatX::Test();
+	SIMDProcessor = oldProcessor;
+	
+	idLib::common->Printf( "====================================\n" );
+	
 	idLib::common->SetRefreshOnPrint( false );
 	
 	if( p_simd != processor )
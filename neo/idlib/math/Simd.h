@@ -112,6 +112,23 @@ public:
 	virtual void VPCALL ConvertJointMatsToJointQuats( idJointQuat* jointQuats, const idJointMat* jointMats, const int numJoints ) = 0;
 	virtual void VPCALL TransformJoints( idJointMat* jointMats, const int* parents, const int firstJoint, const int lastJoint ) = 0;
 	virtual void VPCALL UntransformJoints( idJointMat* jointMats, const int* parents, const int firstJoint, const int lastJoint ) = 0;
+	
+	// matrix math, dst may be the same vector as vec
+	virtual void VPCALL MatX_MultiplyVecX( idVecX& dst, const idMatX& mat, const idVecX& vec ) = 0;
+	virtual void VPCALL MatX_MultiplyAddVecX( idVecX& dst, const idMatX& mat, const idVecX& vec ) = 0;
+	virtual void VPCALL MatX_MultiplySubVecX( idVecX& dst, const idMatX& mat, const idVecX& vec ) = 0;
+	virtual void VPCALL MatX_TransposeMultiplyVecX( idVecX& dst, const idMatX& mat, const idVecX& vec ) = 0;
+	virtual void VPCALL MatX_TransposeMultiplyAddVecX( idVecX& dst, const idMatX& mat, const idVecX& vec ) = 0;
+	virtual void VPCALL MatX_TransposeMultiplySubVecX( idVecX& dst, const idMatX& mat, const idVecX& vec ) = 0;
+	
+	// triangular solves with an implicit unit diagonal, if skip > 0 the first skip elements of x are assumed to be valid already
+	virtual void VPCALL MatX_LowerTriangularSolve( const idMatX& L, float* x, const float* b, const int n, int skip = 0 ) = 0;
+	virtual void VPCALL MatX_LowerTriangularSolveTranspose( const idMatX& L, float* x, const float* b, const int n ) = 0;
+	
+	// in-place factorizations of the top left n x n block, same results as the idMatX methods with the same name
+	virtual bool VPCALL MatX_LU_Factor( idMatX& mat, int* index, float* det ) = 0;
+	virtual bool VPCALL MatX_Cholesky_Factor( idMatX& mat, const int n ) = 0;
+	virtual bool VPCALL MatX_LDLT_Factor( idMatX& mat, const int n ) = 0;
 };
 
 // pointer to SIMD processor
@@ -0,0 +1,803 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+
+#pragma hdrstop
+#include "precompiled.h"
+#include "Simd_Generic.h"
+#include "Simd_SSE.h"
+#include "Simd_AVX2.h"
+
+//===============================================================
+//
+//	AVX2 implementation of idSIMDProcessor
+//
+//===============================================================
+
+#if defined(USE_INTRINSICS)
+
+#include <immintrin.h>
+
+// GCC and clang only emit AVX2 and FMA instructions for functions that ask for them
+// the small helpers that pass AVX vectors around are always inlined, so no __m256 crosses a call
+#if defined(__GNUC__)
+#define AVX2_TARGET			__attribute__( ( target( "avx2,fma" ) ) )
+#define AVX2_INLINE			inline __attribute__( ( always_inline, target( "avx2,fma" ) ) )
+#else
+#define AVX2_TARGET
+#define AVX2_INLINE			ID_FORCE_INLINE
+#endif
+
+// below this size the masked loads and horizontal sums cost more than the generic loops
+#define MATX_MIN_SIZE		8
+
+// number of columns factored together, the panel stays in the L1 cache while the trailing rows stream through
+#define MATX_BLOCK_SIZE		8
+
+static const int tailMask[16] = { -1, -1, -1, -1, -1, -1, -1, -1, 0, 0, 0, 0, 0, 0, 0, 0 };
+
+/*
+============
+TailMask
+
+  mask for a masked load or store of the first count < 8 floats
+============
+*/
+static AVX2_INLINE __m256i TailMask( const int count )
+{
+	return _mm256_loadu_si256( ( const __m256i* )( tailMask + 8 - count ) );
+}
+
+/*
+============
+HorizontalSum
+============
+*/
+static AVX2_INLINE float HorizontalSum( const __m256 a )
+{
+	__m128 s = _mm_add_ps( _mm256_castps256_ps128( a ), _mm256_extractf128_ps( a, 1 ) );
+	s = _mm_add_ps( s, _mm_movehl_ps( s, s ) );
+	s = _mm_add_ss( s, _mm_shuffle_ps( s, s, _MM_SHUFFLE( 1, 1, 1, 1 ) ) );
+	return _mm_cvtss_f32( s );
+}
+
+/*
+============
+HorizontalSum4
+
+  returns the four sums of the elements of a0, a1, a2 and a3
+============
+*/
+static AVX2_INLINE __m128 HorizontalSum4( const __m256 a0, const __m256 a1, const __m256 a2, const __m256 a3 )
+{
+	__m256 s = _mm256_hadd_ps( _mm256_hadd_ps( a0, a1 ), _mm256_hadd_ps( a2, a3 ) );
+	return _mm_add_ps( _mm256_castps256_ps128( s ), _mm256_extractf128_ps( s, 1 ) );
+}
+
+/*
+============
+DotProduct
+============
+*/
+static AVX2_TARGET float DotProduct( const float* a, const float* b, const int count )
+{
+	__m256 sum0 = _mm256_setzero_ps();
+	__m256 sum1 = _mm256_setzero_ps();
+	
+	int i = 0;
+	for( ; i + 16 <= count; i += 16 )
+	{
+		sum0 = _mm256_fmadd_ps( _mm256_loadu_ps( a + i + 0 ), _mm256_loadu_ps( b + i + 0 ), sum0 );
+		sum1 = _mm256_fmadd_ps( _mm256_loadu_ps( a + i + 8 ), _mm256_loadu_ps( b + i + 8 ), sum1 );
+	}
+	if( i + 8 <= count )
+	{
+		sum0 = _mm256_fmadd_ps( _mm256_loadu_ps( a + i ), _mm256_loadu_ps( b + i ), sum0 );
+		i += 8;
+	}
+	if( i < count )
+	{
+		const __m256i mask = TailMask( count - i );
+		sum1 = _mm256_fmadd_ps( _mm256_maskload_ps( a + i, mask ), _mm256_maskload_ps( b + i, mask ), sum1 );
+	}
+	return HorizontalSum( _mm256_add_ps( sum0, sum1 ) );
+}
+
+/*
+============
+DotProduct4
+
+  returns the dot products of a with b0, b1, b2 and b3, a is only loaded once
+============
+*/
+static AVX2_INLINE __m128 DotProduct4( const float* a, const float* b0, const float* b1, const float* b2, const float* b3, const int count )
+{
+	__m256 sum0 = _mm256_setzero_ps();
+	__m256 sum1 = _mm256_setzero_ps();
+	__m256 sum2 = _mm256_setzero_ps();
+	__m256 sum3 = _mm256_setzero_ps();
+	
+	int i = 0;
+	for( ; i + 8 <= count; i += 8 )
+	{
+		const __m256 va = _mm256_loadu_ps( a + i );
+		sum0 = _mm256_fmadd_ps( va, _mm256_loadu_ps( b0 + i ), sum0 );
+		sum1 = _mm256_fmadd_ps( va, _mm256_loadu_ps( b1 + i ), sum1 );
+		sum2 = _mm256_fmadd_ps( va, _mm256_loadu_ps( b2 + i ), sum2 );
+		sum3 = _mm256_fmadd_ps( va, _mm256_loadu_ps( b3 + i ), sum3 );
+	}
+	if( i < count )
+	{
+		const __m256i mask = TailMask( count - i );
+		const __m256 va = _mm256_maskload_ps( a + i, mask );
+		sum0 = _mm256_fmadd_ps( va, _mm256_maskload_ps( b0 + i, mask ), sum0 );
+		sum1 = _mm256_fmadd_ps( va, _mm256_maskload_ps( b1 + i, mask ), sum1 );
+		sum2 = _mm256_fmadd_ps( va, _mm256_maskload_ps( b2 + i, mask ), sum2 );
+		sum3 = _mm256_fmadd_ps( va, _mm256_maskload_ps( b3 + i, mask ), sum3 );
+	}
+	return HorizontalSum4( sum0, sum1, sum2, sum3 );
+}
+
+/*
+============
+DotProduct4
+
+  dst[0..3] = the dot products of a with b0, b1, b2 and b3, for callers compiled without AVX
+============
+*/
+static AVX2_TARGET void DotProduct4( float* dst, const float* a, const float* b0, const float* b1, const float* b2, const float* b3, const int count )
+{
+	_mm_storeu_ps( dst, DotProduct4( a, b0, b1, b2, b3, count ) );
+}
+
+/*
+============
+MulAdd
+
+  dst += scale * src
+============
+*/
+static AVX2_TARGET void MulAdd( float* dst, const float* src, const float scale, const int count )
+{
+	const __m256 s = _mm256_set1_ps( scale );
+	
+	int i = 0;
+	for( ; i + 8 <= count; i += 8 )
+	{
+		_mm256_storeu_ps( dst + i, _mm256_fmadd_ps( _mm256_loadu_ps( src + i ), s, _mm256_loadu_ps( dst + i ) ) );
+	}
+	if( i < count )
+	{
+		const __m256i mask = TailMask( count - i );
+		_mm256_maskstore_ps( dst + i, mask, _mm256_fmadd_ps( _mm256_maskload_ps( src + i, mask ), s, _mm256_maskload_ps( dst + i, mask ) ) );
+	}
+}
+
+/*
+============
+MulAdd4
+
+  dst += scale0 * src0 + scale1 * src1 + scale2 * src2 + scale3 * src3, dst is only loaded and stored once
+============
+*/
+static AVX2_TARGET void MulAdd4( float* dst, const float* src0, const float* src1, const float* src2, const float* src3,
+								 const float scale0, const float scale1, const float scale2, const float scale3, const int count )
+{
+	const __m256 s0 = _mm256_set1_ps( scale0 );
+	const __m256 s1 = _mm256_set1_ps( scale1 );
+	const __m256 s2 = _mm256_set1_ps( scale2 );
+	const __m256 s3 = _mm256_set1_ps( scale3 );
+	
+	int i = 0;
+	for( ; i + 8 <= count; i += 8 )
+	{
+		__m256 d = _mm256_loadu_ps( dst + i );
+		d = _mm256_fmadd_ps( _mm256_loadu_ps( src0 + i ), s0, d );
+		d = _mm256_fmadd_ps( _mm256_loadu_ps( src1 + i ), s1, d );
+		d = _mm256_fmadd_ps( _mm256_loadu_ps( src2 + i ), s2, d );
+		d = _mm256_fmadd_ps( _mm256_loadu_ps( src3 + i ), s3, d );
+		_mm256_storeu_ps( dst + i, d );
+	}
+	if( i < count )
+	{
+		const __m256i mask = TailMask( count - i );
+		__m256 d = _mm256_maskload_ps( dst + i, mask );
+		d = _mm256_fmadd_ps( _mm256_maskload_ps( src0 + i, mask ), s0, d );
+		d = _mm256_fmadd_ps( _mm256_maskload_ps( src1 + i, mask ), s1, d );
+		d = _mm256_fmadd_ps( _mm256_maskload_ps( src2 + i, mask ), s2, d );
+		d = _mm256_fmadd_ps( _mm256_maskload_ps( src3 + i, mask ), s3, d );
+		_mm256_maskstore_ps( dst + i, mask, d );
+	}
+}
+
+/*
+============
+Mul
+
+  dst = src0 * src1 per element
+============
+*/
+static AVX2_TARGET void Mul( float* dst, const float* src0, const float* src1, const int count )
+{
+	int i = 0;
+	for( ; i + 8 <= count; i += 8 )
+	{
+		_mm256_storeu_ps( dst + i, _mm256_mul_ps( _mm256_loadu_ps( src0 + i ), _mm256_loadu_ps( src1 + i ) ) );
+	}
+	for( ; i < count; i++ )
+	{
+		dst[i] = src0[i] * src1[i];
+	}
+}
+
+/*
+============
+MultiplyRows
+
+  dst = mat * vec, four rows at a time so every load of vec is used four times
+============
+*/
+static AVX2_TARGET void MultiplyRows( float* dst, const float* mat, const float* vec, const int numRows, const int numColumns )
+{
+	int i = 0;
+	for( ; i + 4 <= numRows; i += 4 )
+	{
+		const float* m = mat + i * numColumns;
+		_mm_storeu_ps( dst + i, DotProduct4( vec, m, m + numColumns, m + 2 * numColumns, m + 3 * numColumns, numColumns ) );
+	}
+	for( ; i < numRows; i++ )
+	{
+		dst[i] = DotProduct( mat + i * numColumns, vec, numColumns );
+	}
+}
+
+/*
+============
+MultiplyColumns
+
+  dst = mat' * vec, the rows are accumulated in memory order instead of walking down the columns
+============
+*/
+static AVX2_TARGET void MultiplyColumns( float* dst, const float* mat, const float* vec, const int numRows, const int numColumns )
+{
+	memset( dst, 0, numColumns * sizeof( float ) );
+	
+	int i = 0;
+	for( ; i + 4 <= numRows; i += 4 )
+	{
+		const float* m = mat + i * numColumns;
+		MulAdd4( dst, m, m + numColumns, m + 2 * numColumns, m + 3 * numColumns, vec[i + 0], vec[i + 1], vec[i + 2], vec[i + 3], numColumns );
+	}
+	for( ; i < numRows; i++ )
+	{
+		MulAdd( dst, mat + i * numColumns, vec[i], numColumns );
+	}
+}
+
+/*
+============
+UpdatePanel
+
+  Subtracts the contributions of the first p factored columns from the lower triangle of the
+  columns [p, p+nb) in all rows r >= p: m[r][p+c] -= dot( m[r][0..p), w[c][0..p) ).
+  The nb rows of w stay in the L1 cache while the rows of m stream through once.
+============
+*/
+static AVX2_TARGET void UpdatePanel( float* m, const int stride, const int n, const int p, const int nb, const float* w, const int wStride )
+{
+	if( p == 0 )
+	{
+		return;
+	}
+	
+	for( int r = p; r < n; r++ )
+	{
+		float* mr = m + r * stride;
+		const int count = Min( nb, r - p + 1 );
+		
+		int c = 0;
+		for( ; c + 4 <= count; c += 4 )
+		{
+			const float* wc = w + c * wStride;
+			const __m128 s = DotProduct4( mr, wc, wc + wStride, wc + 2 * wStride, wc + 3 * wStride, p );
+			_mm_storeu_ps( mr + p + c, _mm_sub_ps( _mm_loadu_ps( mr + p + c ), s ) );
+		}
+		for( ; c < count; c++ )
+		{
+			mr[p + c] -= DotProduct( mr, w + c * wStride, p );
+		}
+	}
+}
+
+/*
+============
+idSIMD_AVX2::GetName
+============
+*/
+template<>
+const char* idSIMD_AVX2<idSIMD_Generic>::GetName() const
+{
+	return "generic code with AVX2 & FMA3 matrix kernels";
+}
+
+template<>
+const char* idSIMD_AVX2<idSIMD_SSE>::GetName() const
+{
+	return "MMX & SSE & AVX2 & FMA3";
+}
+
+/*
+============
+idSIMD_AVX2::MatX_MultiplyVecX
+============
+*/
+template<class base>
+AVX2_TARGET void VPCALL idSIMD_AVX2<base>::MatX_MultiplyVecX( idVecX& dst, const idMatX& mat, const idVecX& vec )
+{
+	const int numRows = mat.GetNumRows();
+	float* temp = ( float* )_alloca16( numRows * sizeof( float ) );
+	MultiplyRows( temp, mat.ToFloatPtr(), vec.ToFloatPtr(), numRows, mat.GetNumColumns() );
+	memcpy( dst.ToFloatPtr(), temp, numRows * sizeof( float ) );
+}
+
+/*
+============
+idSIMD_AVX2::MatX_MultiplyAddVecX
+============
+*/
+template<class base>
+AVX2_TARGET void VPCALL idSIMD_AVX2<base>::MatX_MultiplyAddVecX( idVecX& dst, const idMatX& mat, const idVecX& vec )
+{
+	const int numRows = mat.GetNumRows();
+	float* temp = ( float* )_alloca16( numRows * sizeof( float ) );
+	MultiplyRows( temp, mat.ToFloatPtr(), vec.ToFloatPtr(), numRows, mat.GetNumColumns() );
+	MulAdd( dst.ToFloatPtr(), temp, 1.0f, numRows );
+}
+
+/*
+============
+idSIMD_AVX2::MatX_MultiplySubVecX
+============
+*/
+template<class base>
+AVX2_TARGET void VPCALL idSIMD_AVX2<base>::MatX_MultiplySubVecX( idVecX& dst, const idMatX& mat, const idVecX& vec )
+{
+	const int numRows = mat.GetNumRows();
+	float* temp = ( float* )_alloca16( numRows * sizeof( float ) );
+	MultiplyRows( temp, mat.ToFloatPtr(), vec.ToFloatPtr(), numRows, mat.GetNumColumns() );
+	MulAdd( dst.ToFloatPtr(), temp, -1.0f, numRows );
+}
+
+/*
+============
+idSIMD_AVX2::MatX_TransposeMultiplyVecX
+============
+*/
+template<class base>
+AVX2_TARGET void VPCALL idSIMD_AVX2<base>::MatX_TransposeMultiplyVecX( idVecX& dst, const idMatX& mat, const idVecX& vec )
+{
+	const int numColumns = mat.GetNumColumns();
+	
+	if( numColumns < MATX_MIN_SIZE )
+	{
+		idSIMD_Generic::MatX_TransposeMultiplyVecX( dst, mat, vec );
+		return;
+	}
+	
+	float* temp = ( float* )_alloca16( numColumns * sizeof( float ) );
+	MultiplyColumns( temp, mat.ToFloatPtr(), vec.ToFloatPtr(), mat.GetNumRows(), numColumns );
+	memcpy( dst.ToFloatPtr(), temp, numColumns * sizeof( float ) );
+}
+
+/*
+============
+idSIMD_AVX2::MatX_TransposeMultiplyAddVecX
+============
+*/
+template<class base>
+AVX2_TARGET void VPCALL idSIMD_AVX2<base>::MatX_TransposeMultiplyAddVecX( idVecX& dst, const idMatX& mat, const idVecX& vec )
+{
+	const int numColumns = mat.GetNumColumns();
+	
+	if( numColumns < MATX_MIN_SIZE )
+	{
+		idSIMD_Generic::MatX_TransposeMultiplyAddVecX( dst, mat, vec );
+		return;
+	}
+	
+	float* temp = ( float* )_alloca16( numColumns * sizeof( float ) );
+	MultiplyColumns( temp, mat.ToFloatPtr(), vec.ToFloatPtr(), mat.GetNumRows(), numColumns );
+	MulAdd( dst.ToFloatPtr(), temp, 1.0f, numColumns );
+}
+
+/*
+============
+idSIMD_AVX2::MatX_TransposeMultiplySubVecX
+============
+*/
+template<class base>
+AVX2_TARGET void VPCALL idSIMD_AVX2<base>::MatX_TransposeMultiplySubVecX( idVecX& dst, const idMatX& mat, const idVecX& vec )
+{
+	const int numColumns = mat.GetNumColumns();
+	
+	if( numColumns < MATX_MIN_SIZE )
+	{
+		idSIMD_Generic::MatX_TransposeMultiplySubVecX( dst, mat, vec );
+		return;
+	}
+	
+	float* temp = ( float* )_alloca16( numColumns * sizeof( float ) );
+	MultiplyColumns( temp, mat.ToFloatPtr(), vec.ToFloatPtr(), mat.GetNumRows(), numColumns );
+	MulAdd( dst.ToFloatPtr(), temp, -1.0f, numColumns );
+}
+
+/*
+============
+idSIMD_AVX2::MatX_LowerTriangularSolve
+
+  solves x in Lx = b for the n * n sub-matrix of L
+  if skip > 0 the first skip elements of x are assumed to be valid already
+  L has to be a lower triangular matrix with (implicit) ones on the diagonal
+  x == b is allowed
+============
+*/
+template<class base>
+AVX2_TARGET void VPCALL idSIMD_AVX2<base>::MatX_LowerTriangularSolve( const idMatX& L, float* x, const float* b, const int n, int skip )
+{
+	if( n < MATX_MIN_SIZE )
+	{
+		idSIMD_Generic::MatX_LowerTriangularSolve( L, x, b, n, skip );
+		return;
+	}
+	
+	ALIGN16( float s[4] );
+	
+	int i = skip;
+	
+	// the dot products of four rows with the solved part of x share the loads of x
+	for( ; i + 4 <= n; i += 4 )
+	{
+		const float* l0 = L[i + 0];
+		const float* l1 = L[i + 1];
+		const float* l2 = L[i + 2];
+		const float* l3 = L[i + 3];
+		
+		DotProduct4( s, x, l0, l1, l2, l3, i );
+		
+		// solve the small triangle on the diagonal
+		const float x0 = b[i + 0] - s[0];
+		const float x1 = b[i + 1] - s[1] - l1[i] * x0;
+		const float x2 = b[i + 2] - s[2] - l2[i] * x0 - l2[i + 1] * x1;
+		const float x3 = b[i + 3] - s[3] - l3[i] * x0 - l3[i + 1] * x1 - l3[i + 2] * x2;
+		
+		x[i + 0] = x0;
+		x[i + 1] = x1;
+		x[i + 2] = x2;
+		x[i + 3] = x3;
+	}
+	for( ; i < n; i++ )
+	{
+		x[i] = b[i] - DotProduct( L[i], x, i );
+	}
+}
+
+/*
+============
+idSIMD_AVX2::MatX_LowerTriangularSolveTranspose
+
+  solves x in L'x = b for the n * n sub-matrix of L
+  L has to be a lower triangular matrix with (implicit) ones on the diagonal
+  x == b is allowed
+============
+*/
+template<class base>
+AVX2_TARGET void VPCALL idSIMD_AVX2<base>::MatX_LowerTriangularSolveTranspose( const idMatX& L, float* x, const float* b, const int n )
+{
+	if( n < MATX_MIN_SIZE )
+	{
+		idSIMD_Generic::MatX_LowerTriangularSolveTranspose( L, x, b, n );
+		return;
+	}
+	
+	if( x != b )
+	{
+		memcpy( x, b, n * sizeof( float ) );
+	}
+	
+	// walk up four rows at a time and subtract their contributions from all elements above them,
+	// this reads L in memory order instead of walking down the columns
+	int i = n;
+	for( ; i >= 4; i -= 4 )
+	{
+		const float* l0 = L[i - 4];
+		const float* l1 = L[i - 3];
+		const float* l2 = L[i - 2];
+		const float* l3 = L[i - 1];
+		
+		// solve the small triangle on the diagonal
+		const float x3 = x[i - 1];
+		const float x2 = x[i - 2] - l3[i - 2] * x3;
+		const float x1 = x[i - 3] - l3[i - 3] * x3 - l2[i - 3] * x2;
+		const float x0 = x[i - 4] - l3[i - 4] * x3 - l2[i - 4] * x2 - l1[i - 4] * x1;
+		
+		x[i - 4] = x0;
+		x[i - 3] = x1;
+		x[i - 2] = x2;
+		
+		MulAdd4( x, l0, l1, l2, l3, -x0, -x1, -x2, -x3, i - 4 );
+	}
+	for( i--; i > 0; i-- )
+	{
+		MulAdd( x, L[i], -x[i], i );
+	}
+}
+
+/*
+============
+idSIMD_AVX2::MatX_LU_Factor
+
+  in-place factorization: LU
+  L is a triangular matrix stored in the lower triangle.
+  L has ones on the diagonal that are not stored.
+  U is a triangular matrix stored in the upper triangle.
+  If index != NULL partial pivoting is used for numerical stability.
+  If index != NULL it must point to an array of numRow integers and is used to keep track of the row permutation.
+  If det != NULL the determinant of the matrix is calculated and stored.
+============
+*/
+template<class base>
+AVX2_TARGET bool VPCALL idSIMD_AVX2<base>::MatX_LU_Factor( idMatX& mat, int* index, float* det )
+{
+	int i, j, newi, min;
+	float s, t, d;
+	double w;
+	
+	const int numRows = mat.GetNumRows();
+	const int numColumns = mat.GetNumColumns();
+	
+	if( Min( numRows, numColumns ) < MATX_MIN_SIZE )
+	{
+		return idSIMD_Generic::MatX_LU_Factor( mat, index, det );
+	}
+	
+	// if partial pivoting should be used
+	if( index )
+	{
+		for( i = 0; i < numRows; i++ )
+		{
+			index[i] = i;
+		}
+	}
+	
+	w = 1.0f;
+	min = Min( numRows, numColumns );
+	for( i = 0; i < min; i++ )
+	{
+	
+		newi = i;
+		s = idMath::Fabs( mat[i][i] );
+		
+		if( index )
+		{
+			// find the largest absolute pivot
+			for( j = i + 1; j < numRows; j++ )
+			{
+				t = idMath::Fabs( mat[j][i] );
+				if( t > s )
+				{
+					newi = j;
+					s = t;
+				}
+			}
+		}
+		
+		if( s == 0.0f )
+		{
+			return false;
+		}
+		
+		if( newi != i && index )
+		{
+		
+			w = -w;
+			
+			SwapValues( index[i], index[newi] );
+			
+			float* r0 = mat[i];
+			float* r1 = mat[newi];
+			for( j = 0; j < numColumns; j++ )
+			{
+				SwapValues( r0[j], r1[j] );
+			}
+		}
+		
+		if( i < numRows )
+		{
+			d = 1.0f / mat[i][i];
+			for( j = i + 1; j < numRows; j++ )
+			{
+				mat[j][i] *= d;
+			}
+		}
+		
+		// rank one update of the trailing rows with the pivot row
+		if( i < min - 1 )
+		{
+			const float* ri = mat[i] + i + 1;
+			for( j = i + 1; j < numRows; j++ )
+			{
+				MulAdd( mat[j] + i + 1, ri, -mat[j][i], numColumns - i - 1 );
+			}
+		}
+	}
+	
+	if( det )
+	{
+		for( i = 0; i < numRows; i++ )
+		{
+			w *= mat[i][i];
+		}
+		*det = w;
+	}
+	
+	return true;
+}
+
+/*
+============
+idSIMD_AVX2::MatX_Cholesky_Factor
+
+  in-place Cholesky factorization: LL'
+  L is a triangular matrix stored in the lower triangle.
+  The upper triangle is not cleared.
+  The initial matrix has to be symmetric positive definite.
+
+  Blocked left-looking factorization: the contributions of all factored columns are
+  subtracted from a panel of MATX_BLOCK_SIZE columns at once before the panel is factored.
+============
+*/
+template<class base>
+AVX2_TARGET bool VPCALL idSIMD_AVX2<base>::MatX_Cholesky_Factor( idMatX& mat, const int n )
+{
+	float* m = mat.ToFloatPtr();
+	const int stride = mat.GetNumColumns();
+	
+	for( int p = 0; p < n; p += MATX_BLOCK_SIZE )
+	{
+		const int nb = Min( MATX_BLOCK_SIZE, n - p );
+		
+		// the rows of the panel in L are the weights
+		UpdatePanel( m, stride, n, p, nb, m + p * stride, stride );
+		
+		for( int c = 0; c < nb; c++ )
+		{
+			const int i = p + c;
+			float* li = m + i * stride;
+			
+			float sum = li[i];
+			for( int k = p; k < i; k++ )
+			{
+				sum -= li[k] * li[k];
+			}
+			if( sum <= 0.0f )
+			{
+				return false;
+			}
+			
+			const float invSqrt = idMath::InvSqrt( sum );
+			li[i] = invSqrt * sum;
+			
+			for( int j = i + 1; j < n; j++ )
+			{
+				float* lj = m + j * stride;
+				sum = lj[i];
+				for( int k = p; k < i; k++ )
+				{
+					sum -= lj[k] * li[k];
+				}
+				lj[i] = sum * invSqrt;
+			}
+		}
+	}
+	return true;
+}
+
+/*
+============
+idSIMD_AVX2::MatX_LDLT_Factor
+
+  in-place factorization: LDL'
+  L is a triangular matrix stored in the lower triangle.
+  L has ones on the diagonal that are not stored.
+  D is a diagonal matrix stored on the diagonal.
+  The upper triangle is not cleared.
+  The initial matrix has to be symmetric.
+
+  Blocked the same way as MatX_Cholesky_Factor with the panel rows scaled by D.
+============
+*/
+template<class base>
+AVX2_TARGET bool VPCALL idSIMD_AVX2<base>::MatX_LDLT_Factor( idMatX& mat, const int n )
+{
+	float* m = mat.ToFloatPtr();
+	const int stride = mat.GetNumColumns();
+	float* diag = ( float* )_alloca16( n * sizeof( float ) );
+	float* w = ( float* )_alloca16( MATX_BLOCK_SIZE * n * sizeof( float ) );
+	ALIGN16( float v[MATX_BLOCK_SIZE] );
+	
+	for( int p = 0; p < n; p += MATX_BLOCK_SIZE )
+	{
+		const int nb = Min( MATX_BLOCK_SIZE, n - p );
+		
+		// weights are the rows of the panel in L scaled by D
+		for( int c = 0; c < nb; c++ )
+		{
+			Mul( w + c * p, m + ( p + c ) * stride, diag, p );
+		}
+		
+		UpdatePanel( m, stride, n, p, nb, w, p );
+		
+		for( int c = 0; c < nb; c++ )
+		{
+			const int i = p + c;
+			float* li = m + i * stride;
+			
+			float sum = li[i];
+			for( int k = 0; k < c; k++ )
+			{
+				v[k] = diag[p + k] * li[p + k];
+				sum -= v[k] * li[p + k];
+			}
+			
+			if( sum == 0.0f )
+			{
+				return false;
+			}
+			
+			li[i] = diag[i] = sum;
+			const float d = 1.0f / sum;
+			
+			for( int j = i + 1; j < n; j++ )
+			{
+				float* lj = m + j * stride;
+				sum = lj[i];
+				for( int k = 0; k < c; k++ )
+				{
+					sum -= lj[p + k] * v[k];
+				}
+				lj[i] = sum * d;
+			}
+		}
+	}
+	return true;
+}
+
+template class idSIMD_AVX2<idSIMD_Generic>;
+template class idSIMD_AVX2<idSIMD_SSE>;
+
+#endif
@@ -0,0 +1,72 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+
+#ifndef __MATH_SIMD_AVX2_H__
+#define __MATH_SIMD_AVX2_H__
+
+/*
+===============================================================================
+
+	AVX2 implementation of idSIMDProcessor
+
+	Only selected when the CPU reports both AVX2 and FMA3. The functions are
+	compiled for these instruction sets individually so the rest of the code
+	still runs on older processors.
+
+	Only the idMatX kernels are implemented here, everything else comes from
+	the processor the AVX2 kernels are layered on, idSIMD_SSE when the CPU
+	reports MMX and SSE or idSIMD_Generic otherwise.
+
+===============================================================================
+*/
+
+#if defined(USE_INTRINSICS)
+
+template<class base>
+class idSIMD_AVX2 : public base
+{
+public:
+	virtual const char* VPCALL GetName() const;
+	
+	virtual void VPCALL MatX_MultiplyVecX( idVecX& dst, const idMatX& mat, const idVecX& vec );
+	virtual void VPCALL MatX_MultiplyAddVecX( idVecX& dst, const idMatX& mat, const idVecX& vec );
+	virtual void VPCALL MatX_MultiplySubVecX( idVecX& dst, const idMatX& mat, const idVecX& vec );
+	virtual void VPCALL MatX_TransposeMultiplyVecX( idVecX& dst, const idMatX& mat, const idVecX& vec );
+	virtual void VPCALL MatX_TransposeMultiplyAddVecX( idVecX& dst, const idMatX& mat, const idVecX& vec );
+	virtual void VPCALL MatX_TransposeMultiplySubVecX( idVecX& dst, const idMatX& mat, const idVecX& vec );
+	virtual void VPCALL MatX_LowerTriangularSolve( const idMatX& L, float* x, const float* b, const int n, int skip = 0 );
+	virtual void VPCALL MatX_LowerTriangularSolveTranspose( const idMatX& L, float* x, const float* b, const int n );
+	virtual bool VPCALL MatX_LU_Factor( idMatX& mat, int* index, float* det );
+	virtual bool VPCALL MatX_Cholesky_Factor( idMatX& mat, const int n );
+	virtual bool VPCALL MatX_LDLT_Factor( idMatX& mat, const int n );
+};
+
+#endif
+
+#endif /* !__MATH_SIMD_AVX2_H__ */
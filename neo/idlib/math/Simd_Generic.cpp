@@ -234,3 +234,435 @@ void VPCALL idSIMD_Generic::UntransformJoints( idJointMat* jointMats, const int*
 		jointMats[i] /= jointMats[parents[i]];
 	}
 }
+
+/*
+============
+idSIMD_Generic::MatX_MultiplyVecX
+============
+*/
+void VPCALL idSIMD_Generic::MatX_MultiplyVecX( idVecX& dst, const idMatX& mat, const idVecX& vec )
+{
+	const int numRows = mat.GetNumRows();
+	const int numColumns = mat.GetNumColumns();
+	const float* mPtr = mat.ToFloatPtr();
+	const float* vPtr = vec.ToFloatPtr();
+	float* dstPtr = dst.ToFloatPtr();
+	float* temp = ( float* )_alloca16( numRows * sizeof( float ) );
+	for( int i = 0; i < numRows; i++ )
+	{
+		float sum = mPtr[0] * vPtr[0];
+		for( int j = 1; j < numColumns; j++ )
+		{
+			sum += mPtr[j] * vPtr[j];
+		}
+		temp[i] = sum;
+		mPtr += numColumns;
+	}
+	for( int i = 0; i < numRows; i++ )
+	{
+		dstPtr[i] = temp[i];
+	}
+}
+
+/*
+============
+idSIMD_Generic::MatX_MultiplyAddVecX
+============
+*/
+void VPCALL idSIMD_Generic::MatX_MultiplyAddVecX( idVecX& dst, const idMatX& mat, const idVecX& vec )
+{
+	const int numRows = mat.GetNumRows();
+	const int numColumns = mat.GetNumColumns();
+	const float* mPtr = mat.ToFloatPtr();
+	const float* vPtr = vec.ToFloatPtr();
+	float* dstPtr = dst.ToFloatPtr();
+	float* temp = ( float* )_alloca16( numRows * sizeof( float ) );
+	for( int i = 0; i < numRows; i++ )
+	{
+		float sum = mPtr[0] * vPtr[0];
+		for( int j = 1; j < numColumns; j++ )
+		{
+			sum += mPtr[j] * vPtr[j];
+		}
+		temp[i] = dstPtr[i] + sum;
+		mPtr += numColumns;
+	}
+	for( int i = 0; i < numRows; i++ )
+	{
+		dstPtr[i] = temp[i];
+	}
+}
+
+/*
+============
+idSIMD_Generic::MatX_MultiplySubVecX
+============
+*/
+void VPCALL idSIMD_Generic::MatX_MultiplySubVecX( idVecX& dst, const idMatX& mat, const idVecX& vec )
+{
+	const int numRows = mat.GetNumRows();
+	const int numColumns = mat.GetNumColumns();
+	const float* mPtr = mat.ToFloatPtr();
+	const float* vPtr = vec.ToFloatPtr();
+	float* dstPtr = dst.ToFloatPtr();
+	float* temp = ( float* )_alloca16( numRows * sizeof( float ) );
+	for( int i = 0; i < numRows; i++ )
+	{
+		float sum = mPtr[0] * vPtr[0];
+		for( int j = 1; j < numColumns; j++ )
+		{
+			sum += mPtr[j] * vPtr[j];
+		}
+		temp[i] = dstPtr[i] - sum;
+		mPtr += numColumns;
+	}
+	for( int i = 0; i < numRows; i++ )
+	{
+		dstPtr[i] = temp[i];
+	}
+}
+
+/*
+============
+idSIMD_Generic::MatX_TransposeMultiplyVecX
+============
+*/
+void VPCALL idSIMD_Generic::MatX_TransposeMultiplyVecX( idVecX& dst, const idMatX& mat, const idVecX& vec )
+{
+	const int numRows = mat.GetNumRows();
+	const int numColumns = mat.GetNumColumns();
+	const float* vPtr = vec.ToFloatPtr();
+	float* dstPtr = dst.ToFloatPtr();
+	float* temp = ( float* )_alloca16( numColumns * sizeof( float ) );
+	for( int i = 0; i < numColumns; i++ )
+	{
+		const float* mPtr = mat.ToFloatPtr() + i;
+		float sum = mPtr[0] * vPtr[0];
+		for( int j = 1; j < numRows; j++ )
+		{
+			mPtr += numColumns;
+			sum += mPtr[0] * vPtr[j];
+		}
+		temp[i] = sum;
+	}
+	for( int i = 0; i < numColumns; i++ )
+	{
+		dstPtr[i] = temp[i];
+	}
+}
+
+/*
+============
+idSIMD_Generic::MatX_TransposeMultiplyAddVecX
+============
+*/
+void VPCALL idSIMD_Generic::MatX_TransposeMultiplyAddVecX( idVecX& dst, const idMatX& mat, const idVecX& vec )
+{
+	const int numRows = mat.GetNumRows();
+	const int numColumns = mat.GetNumColumns();
+	const float* vPtr = vec.ToFloatPtr();
+	float* dstPtr = dst.ToFloatPtr();
+	float* temp = ( float* )_alloca16( numColumns * sizeof( float ) );
+	for( int i = 0; i < numColumns; i++ )
+	{
+		const float* mPtr = mat.ToFloatPtr() + i;
+		float sum = mPtr[0] * vPtr[0];
+		for( int j = 1; j < numRows; j++ )
+		{
+			mPtr += numColumns;
+			sum += mPtr[0] * vPtr[j];
+		}
+		temp[i] = dstPtr[i] + sum;
+	}
+	for( int i = 0; i < numColumns; i++ )
+	{
+		dstPtr[i] = temp[i];
+	}
+}
+
+/*
+============
+idSIMD_Generic::MatX_TransposeMultiplySubVecX
+============
+*/
+void VPCALL idSIMD_Generic::MatX_TransposeMultiplySubVecX( idVecX& dst, const idMatX& mat, const idVecX& vec )
+{
+	const int numRows = mat.GetNumRows();
+	const int numColumns = mat.GetNumColumns();
+	const float* vPtr = vec.ToFloatPtr();
+	float* dstPtr = dst.ToFloatPtr();
+	float* temp = ( float* )_alloca16( numColumns * sizeof( float ) );
+	for( int i = 0; i < numColumns; i++ )
+	{
+		const float* mPtr = mat.ToFloatPtr() + i;
+		float sum = mPtr[0] * vPtr[0];
+		for( int j = 1; j < numRows; j++ )
+		{
+			mPtr += numColumns;
+			sum += mPtr[0] * vPtr[j];
+		}
+		temp[i] = dstPtr[i] - sum;
+	}
+	for( int i = 0; i < numColumns; i++ )
+	{
+		dstPtr[i] = temp[i];
+	}
+}
+
+/*
+============
+idSIMD_Generic::MatX_LowerTriangularSolve
+
+  solves x in Lx = b for the n * n sub-matrix of L
+  if skip > 0 the first skip elements of x are assumed to be valid already
+  L has to be a lower triangular matrix with (implicit) ones on the diagonal
+  x == b is allowed
+============
+*/
+void VPCALL idSIMD_Generic::MatX_LowerTriangularSolve( const idMatX& L, float* x, const float* b, const int n, int skip )
+{
+	for( int i = skip; i < n; i++ )
+	{
+		const float* lPtr = L[i];
+		double sum = b[i];
+		for( int j = 0; j < i; j++ )
+		{
+			sum -= lPtr[j] * x[j];
+		}
+		x[i] = sum;
+	}
+}
+
+/*
+============
+idSIMD_Generic::MatX_LowerTriangularSolveTranspose
+
+  solves x in L'x = b for the n * n sub-matrix of L
+  L has to be a lower triangular matrix with (implicit) ones on the diagonal
+  x == b is allowed
+============
+*/
+void VPCALL idSIMD_Generic::MatX_LowerTriangularSolveTranspose( const idMatX& L, float* x, const float* b, const int n )
+{
+	for( int i = n - 1; i >= 0; i-- )
+	{
+		double sum = b[i];
+		for( int j = i + 1; j < n; j++ )
+		{
+			sum -= L[j][i] * x[j];
+		}
+		x[i] = sum;
+	}
+}
+
+/*
+============
+idSIMD_Generic::MatX_LU_Factor
+
+  in-place factorization: LU
+  L is a triangular matrix stored in the lower triangle.
+  L has ones on the diagonal that are not stored.
+  U is a triangular matrix stored in the upper triangle.
+  If index != NULL partial pivoting is used for numerical stability.
+  If index != NULL it must point to an array of numRow integers and is used to keep track of the row permutation.
+  If det != NULL the determinant of the matrix is calculated and stored.
+============
+*/
+bool VPCALL idSIMD_Generic::MatX_LU_Factor( idMatX& mat, int* index, float* det )
+{
+	int i, j, k, newi, min;
+	double s, t, d, w;
+	
+	const int numRows = mat.GetNumRows();
+	const int numColumns = mat.GetNumColumns();
+	
+	// if partial pivoting should be used
+	if( index )
+	{
+		for( i = 0; i < numRows; i++ )
+		{
+			index[i] = i;
+		}
+	}
+	
+	w = 1.0f;
+	min = Min( numRows, numColumns );
+	for( i = 0; i < min; i++ )
+	{
+	
+		newi = i;
+		s = idMath::Fabs( mat[i][i] );
+		
+		if( index )
+		{
+			// find the largest absolute pivot
+			for( j = i + 1; j < numRows; j++ )
+			{
+				t = idMath::Fabs( mat[j][i] );
+				if( t > s )
+				{
+					newi = j;
+					s = t;
+				}
+			}
+		}
+		
+		if( s == 0.0f )
+		{
+			return false;
+		}
+		
+		if( newi != i && index )
+		{
+		
+			w = -w;
+			
+			// swap index elements
+			k = index[i];
+			index[i] = index[newi];
+			index[newi] = k;
+			
+			// swap rows
+			for( j = 0; j < numColumns; j++ )
+			{
+				t = mat[newi][j];
+				mat[newi][j] = mat[i][j];
+				mat[i][j] = t;
+			}
+		}
+		
+		if( i < numRows )
+		{
+			d = 1.0f / mat[i][i];
+			for( j = i + 1; j < numRows; j++ )
+			{
+				mat[j][i] *= d;
+			}
+		}
+		
+		if( i < min - 1 )
+		{
+			for( j = i + 1; j < numRows; j++ )
+			{
+				d = mat[j][i];
+				for( k = i + 1; k < numColumns; k++ )
+				{
+					mat[j][k] -= d * mat[i][k];
+				}
+			}
+		}
+	}
+	
+	if( det )
+	{
+		for( i = 0; i < numRows; i++ )
+		{
+			w *= mat[i][i];
+		}
+		*det = w;
+	}
+	
+	return true;
+}
+
+/*
+============
+idSIMD_Generic::MatX_Cholesky_Factor
+
+  in-place Cholesky factorization: LL'
+  L is a triangular matrix stored in the lower triangle.
+  The upper triangle is not cleared.
+  The initial matrix has to be symmetric positive definite.
+============
+*/
+bool VPCALL idSIMD_Generic::MatX_Cholesky_Factor( idMatX& mat, const int n )
+{
+	int i, j, k;
+	float* invSqrt;
+	double sum;
+	
+	invSqrt = ( float* ) _alloca16( n * sizeof( float ) );
+	
+	for( i = 0; i < n; i++ )
+	{
+	
+		for( j = 0; j < i; j++ )
+		{
+		
+			sum = mat[i][j];
+			for( k = 0; k < j; k++ )
+			{
+				sum -= mat[i][k] * mat[j][k];
+			}
+			mat[i][j] = sum * invSqrt[j];
+		}
+		
+		sum = mat[i][i];
+		for( k = 0; k < i; k++ )
+		{
+			sum -= mat[i][k] * mat[i][k];
+		}
+		
+		if( sum <= 0.0f )
+		{
+			return false;
+		}
+		
+		invSqrt[i] = idMath::InvSqrt( sum );
+		mat[i][i] = invSqrt[i] * sum;
+	}
+	return true;
+}
+
+/*
+============
+idSIMD_Generic::MatX_LDLT_Factor
+
+  in-place factorization: LDL'
+  L is a triangular matrix stored in the lower triangle.
+  L has ones on the diagonal that are not stored.
+  D is a diagonal matrix stored on the diagonal.
+  The upper triangle is not cleared.
+  The initial matrix has to be symmetric.
+============
+*/
+bool VPCALL idSIMD_Generic::MatX_LDLT_Factor( idMatX& mat, const int n )
+{
+	int i, j, k;
+	float* v;
+	double d, sum;
+	
+	v = ( float* ) _alloca16( n * sizeof( float ) );
+	
+	for( i = 0; i < n; i++ )
+	{
+	
+		sum = mat[i][i];
+		for( j = 0; j < i; j++ )
+		{
+			d = mat[i][j];
+			v[j] = mat[j][j] * d;
+			sum -= v[j] * d;
+		}
+		
+		if( sum == 0.0f )
+		{
+			return false;
+		}
+		
+		mat[i][i] = sum;
+		d = 1.0f / sum;
+		
+		for( j = i + 1; j < n; j++ )
+		{
+			sum = mat[j][i];
+			for( k = 0; k < i; k++ )
+			{
+				sum -= mat[j][k] * v[k];
+			}
+			mat[j][i] = sum * d;
+		}
+	}
+	
+	return true;
+}
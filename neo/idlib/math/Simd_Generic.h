@@ -57,6 +57,18 @@ public:
 	virtual void VPCALL ConvertJointMatsToJointQuats( idJointQuat* jointQuats, const idJointMat* jointMats, const int numJoints );
 	virtual void VPCALL TransformJoints( idJointMat* jointMats, const int* parents, const int firstJoint, const int lastJoint );
 	virtual void VPCALL UntransformJoints( idJointMat* jointMats, const int* parents, const int firstJoint, const int lastJoint );
+	
+	virtual void VPCALL MatX_MultiplyVecX( idVecX& dst, const idMatX& mat, const idVecX& vec );
+	virtual void VPCALL MatX_MultiplyAddVecX( idVecX& dst, const idMatX& mat, const idVecX& vec );
+	virtual void VPCALL MatX_MultiplySubVecX( idVecX& dst, const idMatX& mat, const idVecX& vec );
+	virtual void VPCALL MatX_TransposeMultiplyVecX( idVecX& dst, const idMatX& mat, const idVecX& vec );
+	virtual void VPCALL MatX_TransposeMultiplyAddVecX( idVecX& dst, const idMatX& mat, const idVecX& vec );
+	virtual void VPCALL MatX_TransposeMultiplySubVecX( idVecX& dst, const idMatX& mat, const idVecX& vec );
+	virtual void VPCALL MatX_LowerTriangularSolve( const idMatX& L, float* x, const float* b, const int n, int skip = 0 );
+	virtual void VPCALL MatX_LowerTriangularSolveTranspose( const idMatX& L, float* x, const float* b, const int n );
+	virtual bool VPCALL MatX_LU_Factor( idMatX& mat, int* index, float* det );
+	virtual bool VPCALL MatX_Cholesky_Factor( idMatX& mat, const int n );
+	virtual bool VPCALL MatX_LDLT_Factor( idMatX& mat, const int n );
 };
 
 #endif /* !__MATH_SIMD_GENERIC_H__ */
@@ -36,7 +36,7 @@ idVecX - arbitrary sized vector
 
 The vector lives on 16 byte aligned and 16 byte padded memory.
 
-NOTE: due to the temporary memory pool idVecX cannot be used by multiple threads
+The temporary memory pool used for intermediate results is local to each thread.
 
 ===============================================================================
 */
@@ -121,9 +121,8 @@ private:
 	int				alloced;				// if -1 p points to data set with SetData
 	float* 			p;						// memory the vector is stored
 	
-	static float	temp[VECX_MAX_TEMP + 4];	// used to store intermediate results
-	static float* 	tempPtr;				// pointer to 16 byte aligned temporary memory
-	static int		tempIndex;				// index into memory pool, wraps around
+	ALIGN16( static ID_THREAD_LOCAL float temp[VECX_MAX_TEMP] );	// used to store intermediate results
+	static ID_THREAD_LOCAL int	tempIndex;	// index into memory pool, wraps around
 	
 	ID_INLINE void	SetTempSize( int size );
 };
@@ -172,7 +171,7 @@ idVecX::~idVecX
 ID_INLINE idVecX::~idVecX()
 {
 	// if not temp memory
-	if( p && ( p < idVecX::tempPtr || p >= idVecX::tempPtr + VECX_MAX_TEMP ) && alloced != -1 )
+	if( p && ( p < idVecX::temp || p >= idVecX::temp + VECX_MAX_TEMP ) && alloced != -1 )
 	{
 		Mem_Free16( p );
 	}
@@ -520,7 +519,7 @@ idVecX::SetSize
 */
 ID_INLINE void idVecX::SetSize( int newSize )
 {
-	//assert( p < idVecX::tempPtr || p > idVecX::tempPtr + VECX_MAX_TEMP );
+	//assert( p < idVecX::temp || p > idVecX::temp + VECX_MAX_TEMP );
 	if( newSize != size || p == NULL )
 	{
 		int alloc = ( newSize + 3 ) & ~3;
@@ -589,7 +588,7 @@ ID_INLINE void idVecX::SetTempSize( int newSize )
 	{
 		idVecX::tempIndex = 0;
 	}
-	p = idVecX::tempPtr + idVecX::tempIndex;
+	p = idVecX::temp + idVecX::tempIndex;
 	idVecX::tempIndex += alloced;
 	VECX_CLEAREND();
 }
@@ -601,7 +600,7 @@ idVecX::SetData
 */
 ID_INLINE void idVecX::SetData( int length, float* data )
 {
-	if( p != NULL && ( p < idVecX::tempPtr || p >= idVecX::tempPtr + VECX_MAX_TEMP ) && alloced != -1 )
+	if( p != NULL && ( p < idVecX::temp || p >= idVecX::temp + VECX_MAX_TEMP ) && alloced != -1 )
 	{
 		Mem_Free16( p );
 	}
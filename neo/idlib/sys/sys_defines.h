@@ -248,6 +248,13 @@ bulk of the codebase, so it is the best place for analyze pragmas.
 #endif
 // RB end
 
+// thread local storage for plain data, unlike ID_TLS this can be used for arrays
+#if defined(_MSC_VER)
+#define ID_THREAD_LOCAL __declspec(thread)
+#else
+#define ID_THREAD_LOCAL __thread
+#endif
+
 
 // I don't want to disable "warning C6031: Return value ignored" from /analyze
 // but there are several cases with sprintf where we pre-initialized the variables
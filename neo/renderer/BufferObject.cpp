@@ -75,6 +75,11 @@ UnbindBufferObjects
 */
 void UnbindBufferObjects()
 {
+	if( r_nullRenderer.GetBool() )
+	{
+		return;
+	}
+	
 	glBindBuffer( GL_ARRAY_BUFFER, 0 );
 	glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, 0 );
 }
@@ -186,26 +191,33 @@ bool idVertexBuffer::AllocBufferObject( const void* data, int allocSize )
 	int numBytes = GetAllocedSize();
 	
 	
-	// clear out any previous error
-	glGetError();
-	
-	GLuint bufferObject = 0xFFFF;
-	glGenBuffers( 1, & bufferObject );
-	if( bufferObject == 0xFFFF )
+	if( r_nullRenderer.GetBool() )
 	{
-		idLib::FatalError( "idVertexBuffer::AllocBufferObject: failed" );
+		apiObject = Mem_Alloc16( numBytes, TAG_RENDER );
 	}
-	glBindBuffer( GL_ARRAY_BUFFER, bufferObject );
-	
-	// these are rewritten every frame
-	glBufferData( GL_ARRAY_BUFFER, numBytes, NULL, bufferUsage );
-	apiObject = reinterpret_cast< void* >( bufferObject );
-	
-	GLenum err = glGetError();
-	if( err == GL_OUT_OF_MEMORY )
+	else
 	{
-		idLib::Warning( "idVertexBuffer::AllocBufferObject: allocation failed" );
-		allocationFailed = true;
+		// clear out any previous error
+		glGetError();
+		
+		GLuint bufferObject = 0xFFFF;
+		glGenBuffers( 1, & bufferObject );
+		if( bufferObject == 0xFFFF )
+		{
+			idLib::FatalError( "idVertexBuffer::AllocBufferObject: failed" );
+		}
+		glBindBuffer( GL_ARRAY_BUFFER, bufferObject );
+		
+		// these are rewritten every frame
+		glBufferData( GL_ARRAY_BUFFER, numBytes, NULL, bufferUsage );
+		apiObject = reinterpret_cast< void* >( bufferObject );
+		
+		GLenum err = glGetError();
+		if( err == GL_OUT_OF_MEMORY )
+		{
+			idLib::Warning( "idVertexBuffer::AllocBufferObject: allocation failed" );
+			allocationFailed = true;
+		}
 	}
 	
 	
@@ -252,6 +264,13 @@ void idVertexBuffer::FreeBufferObject()
 		idLib::Printf( "vertex buffer free %p, api %p (%i bytes)\n", this, GetAPIObject(), GetSize() );
 	}
 	
+	if( r_nullRenderer.GetBool() )
+	{
+		Mem_Free16( apiObject );
+		ClearWithoutFreeing();
+		return;
+	}
+	
 	// RB: 64 bit fixes, changed GLuint to GLintptrARB
 	GLintptr bufferObject = reinterpret_cast< GLintptr >( apiObject );
 	glDeleteBuffers( 1, ( const unsigned int* ) & bufferObject );
@@ -319,6 +338,12 @@ void idVertexBuffer::Update( const void* data, int updateSize ) const
 	
 	int numBytes = ( updateSize + 15 ) & ~15;
 	
+	if( r_nullRenderer.GetBool() )
+	{
+		memcpy( ( byte* )apiObject + GetOffset(), data, numBytes );
+		return;
+	}
+	
 	// RB: 64 bit fixes, changed GLuint to GLintptrARB
 	GLintptr bufferObject = reinterpret_cast< GLintptr >( apiObject );
 	// RB end
@@ -344,6 +369,13 @@ void* idVertexBuffer::MapBuffer( bufferMapType_t mapType ) const
 	
 	void* buffer = NULL;
 	
+	if( r_nullRenderer.GetBool() )
+	{
+		buffer = ( byte* )apiObject + GetOffset();
+		SetMapped();
+		return buffer;
+	}
+	
 	// RB: 64 bit fixes, changed GLuint to GLintptrARB
 	GLintptr bufferObject = reinterpret_cast< GLintptr >( apiObject );
 	// RB end
@@ -400,6 +432,12 @@ void idVertexBuffer::UnmapBuffer() const
 	assert( apiObject != NULL );
 	assert( IsMapped() );
 	
+	if( r_nullRenderer.GetBool() )
+	{
+		SetUnmapped();
+		return;
+	}
+	
 	// RB: 64 bit fixes, changed GLuint to GLintptrARB
 	GLintptr bufferObject = reinterpret_cast< GLintptr >( apiObject );
 	// RB end
@@ -478,27 +516,34 @@ bool idIndexBuffer::AllocBufferObject( const void* data, int allocSize )
 	int numBytes = GetAllocedSize();
 	
 	
-	// clear out any previous error
-	glGetError();
-	
-	GLuint bufferObject = 0xFFFF;
-	glGenBuffers( 1, & bufferObject );
-	if( bufferObject == 0xFFFF )
+	if( r_nullRenderer.GetBool() )
 	{
-		GLenum error = glGetError();
-		idLib::FatalError( "idIndexBuffer::AllocBufferObject: failed - GL_Error %d", error );
+		apiObject = Mem_Alloc16( numBytes, TAG_RENDER );
 	}
-	glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, bufferObject );
-	
-	// these are rewritten every frame
-	glBufferData( GL_ELEMENT_ARRAY_BUFFER, numBytes, NULL, bufferUsage );
-	apiObject = reinterpret_cast< void* >( bufferObject );
-	
-	GLenum err = glGetError();
-	if( err == GL_OUT_OF_MEMORY )
+	else
 	{
-		idLib::Warning( "idIndexBuffer:AllocBufferObject: allocation failed" );
-		allocationFailed = true;
+		// clear out any previous error
+		glGetError();
+		
+		GLuint bufferObject = 0xFFFF;
+		glGenBuffers( 1, & bufferObject );
+		if( bufferObject == 0xFFFF )
+		{
+			GLenum error = glGetError();
+			idLib::FatalError( "idIndexBuffer::AllocBufferObject: failed - GL_Error %d", error );
+		}
+		glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, bufferObject );
+		
+		// these are rewritten every frame
+		glBufferData( GL_ELEMENT_ARRAY_BUFFER, numBytes, NULL, bufferUsage );
+		apiObject = reinterpret_cast< void* >( bufferObject );
+		
+		GLenum err = glGetError();
+		if( err == GL_OUT_OF_MEMORY )
+		{
+			idLib::Warning( "idIndexBuffer:AllocBufferObject: allocation failed" );
+			allocationFailed = true;
+		}
 	}
 	
 	
@@ -545,6 +590,13 @@ void idIndexBuffer::FreeBufferObject()
 		idLib::Printf( "index buffer free %p, api %p (%i bytes)\n", this, GetAPIObject(), GetSize() );
 	}
 	
+	if( r_nullRenderer.GetBool() )
+	{
+		Mem_Free16( apiObject );
+		ClearWithoutFreeing();
+		return;
+	}
+	
 	// RB: 64 bit fixes, changed GLuint to GLintptrARB
 	GLintptr bufferObject = reinterpret_cast< GLintptr >( apiObject );
 	glDeleteBuffers( 1, ( const unsigned int* )& bufferObject );
@@ -613,6 +665,12 @@ void idIndexBuffer::Update( const void* data, int updateSize ) const
 	
 	int numBytes = ( updateSize + 15 ) & ~15;
 	
+	if( r_nullRenderer.GetBool() )
+	{
+		memcpy( ( byte* )apiObject + GetOffset(), data, numBytes );
+		return;
+	}
+	
 	// RB: 64 bit fixes, changed GLuint to GLintptrARB
 	GLintptr bufferObject = reinterpret_cast< GLintptr >( apiObject );
 	// RB end
@@ -639,6 +697,13 @@ void* idIndexBuffer::MapBuffer( bufferMapType_t mapType ) const
 	
 	void* buffer = NULL;
 	
+	if( r_nullRenderer.GetBool() )
+	{
+		buffer = ( byte* )apiObject + GetOffset();
+		SetMapped();
+		return buffer;
+	}
+	
 	// RB: 64 bit fixes, changed GLuint to GLintptrARB
 	GLintptr bufferObject = reinterpret_cast< GLintptr >( apiObject );
 	// RB end
@@ -690,6 +755,12 @@ void idIndexBuffer::UnmapBuffer() const
 	assert( apiObject != NULL );
 	assert( IsMapped() );
 	
+	if( r_nullRenderer.GetBool() )
+	{
+		SetUnmapped();
+		return;
+	}
+	
 	// RB: 64 bit fixes, changed GLuint to GLintptrARB
 	GLintptr bufferObject = reinterpret_cast< GLintptr >( apiObject );
 	// RB end
@@ -767,12 +838,19 @@ bool idJointBuffer::AllocBufferObject( const float* joints, int numAllocJoints )
 	
 	const int numBytes = GetAllocedSize();
 	
-	GLuint buffer = 0;
-	glGenBuffers( 1, &buffer );
-	glBindBuffer( GL_UNIFORM_BUFFER, buffer );
-	glBufferData( GL_UNIFORM_BUFFER, numBytes, NULL, GL_STREAM_DRAW );
-	glBindBuffer( GL_UNIFORM_BUFFER, 0 );
-	apiObject = reinterpret_cast< void* >( buffer );
+	if( r_nullRenderer.GetBool() )
+	{
+		apiObject = Mem_Alloc16( numBytes, TAG_JOINTBUFFER );
+	}
+	else
+	{
+		GLuint buffer = 0;
+		glGenBuffers( 1, &buffer );
+		glBindBuffer( GL_UNIFORM_BUFFER, buffer );
+		glBufferData( GL_UNIFORM_BUFFER, numBytes, NULL, GL_STREAM_DRAW );
+		glBindBuffer( GL_UNIFORM_BUFFER, 0 );
+		apiObject = reinterpret_cast< void* >( buffer );
+	}
 	
 	if( r_showBuffers.GetBool() )
 	{
@@ -817,6 +895,13 @@ void idJointBuffer::FreeBufferObject()
 		idLib::Printf( "joint buffer free %p, api %p (%i joints)\n", this, GetAPIObject(), GetNumJoints() );
 	}
 	
+	if( r_nullRenderer.GetBool() )
+	{
+		Mem_Free16( apiObject );
+		ClearWithoutFreeing();
+		return;
+	}
+	
 	// RB: 64 bit fixes, changed GLuint to GLintptrARB
 	GLintptr buffer = reinterpret_cast< GLintptr >( apiObject );
 	
@@ -887,6 +972,12 @@ void idJointBuffer::Update( const float* joints, int numUpdateJoints ) const
 	
 	const int numBytes = numUpdateJoints * 3 * 4 * sizeof( float );
 	
+	if( r_nullRenderer.GetBool() )
+	{
+		memcpy( ( byte* )apiObject + GetOffset(), joints, numBytes );
+		return;
+	}
+	
 	// RB: 64 bit fixes, changed GLuint to GLintptrARB
 	glBindBuffer( GL_UNIFORM_BUFFER, reinterpret_cast< GLintptr >( apiObject ) );
 	// RB end
@@ -909,6 +1000,13 @@ float* idJointBuffer::MapBuffer( bufferMapType_t mapType ) const
 	
 	void* buffer = NULL;
 	
+	if( r_nullRenderer.GetBool() )
+	{
+		buffer = ( byte* )apiObject + GetOffset();
+		SetMapped();
+		return ( float* )buffer;
+	}
+	
 	// RB: 64 bit fixes, changed GLuint to GLintptrARB
 	glBindBuffer( GL_UNIFORM_BUFFER, reinterpret_cast< GLintptr >( apiObject ) );
 	// RB end
@@ -943,6 +1041,12 @@ void idJointBuffer::UnmapBuffer() const
 	assert( apiObject != NULL );
 	assert( IsMapped() );
 	
+	if( r_nullRenderer.GetBool() )
+	{
+		SetUnmapped();
+		return;
+	}
+	
 	// RB: 64 bit fixes, changed GLuint to GLintptrARB
 	glBindBuffer( GL_UNIFORM_BUFFER, reinterpret_cast< GLintptr >( apiObject ) );
 	// RB end
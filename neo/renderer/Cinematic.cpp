@@ -66,8 +66,33 @@ extern "C"
 }
 #endif
 
+idCVar r_cinematicDecodeAhead( "r_cinematicDecodeAhead", "1", CVAR_RENDERER | CVAR_BOOL, "decode cinematic frames on a worker thread before they are shown" );
+idCVar r_showCinematics( "r_showCinematics", "0", CVAR_RENDERER | CVAR_BOOL, "print decode time and dropped frames of playing cinematics" );
+
+// number of decoded frames each cinematic keeps, the one on screen plus the ones decoded ahead
+const int CIN_DECODE_FRAMES		= 4;
+
+class idCinematicLocal;
+
+/*
+================================================
+idCinematicDecodeThread decodes the frames after the one that was just uploaded while the
+game keeps running. The cinematic waits for it before it touches the decoder again, so
+the decoder state is only ever used by one thread at a time.
+================================================
+*/
+class idCinematicDecodeThread : public idSysThread
+{
+public:
+	virtual int			Run();
+	
+	idCinematicLocal*	cinematic;
+};
+
 class idCinematicLocal : public idCinematic
 {
+	friend class idCinematicDecodeThread;
+	
 public:
 	idCinematicLocal();
 	virtual					~idCinematicLocal();
@@ -97,6 +122,8 @@ private:
 	cinData_t				ImageForTimeFFMPEG( int milliseconds );
 	bool					InitFromFFMPEGFile( const char* qpath, bool looping );
 	void					FFMPEGReset();
+	bool					FFMPEGDecodeFrame( bool keep );
+	void					FFMPEGConvertFrame( byte* rgba );
 #endif
 	idImage*				img;
 	bool					isRoQ;
@@ -142,6 +169,35 @@ private:
 	bool					half;
 	bool					smootheddouble;
 	bool					inMemory;
+	bool					decodeEnded;			// the decode thread ran into the end of the file
+	
+	// RoQ read buffer and codebooks, these used to be shared by all cinematics
+	byte* 					file;
+	unsigned short* 		vq2;
+	unsigned short* 		vq4;
+	unsigned short* 		vq8;
+	
+	// decode ahead
+	idCinematicDecodeThread* decodeThread;
+	byte* 					decodedFrames[CIN_DECODE_FRAMES];
+	int						decodedFrameNums[CIN_DECODE_FRAMES];
+	int						decodeAheadTo;			// the decode thread stops after this frame
+	int						uploadedFrame;
+	
+	uint64					decodeTime;				// microseconds spent decoding, both threads
+	int						framesDecoded;
+	int						framesDropped;
+	
+	int						CurrentFrame() const;
+	bool					DecodeNextFrame( bool keep );
+	void					DecodeAhead();
+	void					StartDecodeAhead( int frameNum );
+	void					FinishDecodeAhead();
+	void					ClearDecodedFrames();
+	void					FreeDecodedFrames();
+	byte* 					FindDecodedFrame( int frameNum );
+	byte* 					AllocDecodedFrame( int frameNum );
+	void					UploadFrame( const byte* rgba, int frameNum );
 	
 	void					RoQ_init();
 	void					blitVQQuad32fs( byte** status, unsigned char* data );
@@ -165,6 +221,7 @@ private:
 	void					RoQPrepMcomp( int xoff, int yoff );
 	void					RoQReset();
 	// RB end
+	bool					RoQDecodeFrame( bool keep );
 };
 
 // Carl: ROQ files from original Doom 3
@@ -192,10 +249,6 @@ static int				ROQ_UG_tab[256];
 static int				ROQ_VG_tab[256];
 static int				ROQ_VR_tab[256];
 // RB end
-static byte* 			file = NULL;
-static unsigned short* 	vq2 = NULL;
-static unsigned short* 	vq4 = NULL;
-static unsigned short* 	vq8 = NULL;
 
 
 
@@ -235,12 +288,6 @@ void idCinematic::InitCinematic()
 		ROQ_VG_tab[i] = ( int )( ( -t_vg * x ) + ( 1 << 5 ) );
 		ROQ_YY_tab[i] = ( int )( ( i << 6 ) | ( i >> 2 ) );
 	}
-	
-	file = ( byte* )Mem_Alloc( 65536, TAG_CINEMATIC );
-	vq2 = ( word* )Mem_Alloc( 256 * 16 * 4 * sizeof( word ), TAG_CINEMATIC );
-	vq4 = ( word* )Mem_Alloc( 256 * 64 * 4 * sizeof( word ), TAG_CINEMATIC );
-	vq8 = ( word* )Mem_Alloc( 256 * 256 * 4 * sizeof( word ), TAG_CINEMATIC );
-	
 }
 
 /*
@@ -250,15 +297,6 @@ idCinematicLocal::ShutdownCinematic
 */
 void idCinematic::ShutdownCinematic()
 {
-	// Carl: Original Doom 3 RoQ files:
-	Mem_Free( file );
-	file = NULL;
-	Mem_Free( vq2 );
-	vq2 = NULL;
-	Mem_Free( vq4 );
-	vq4 = NULL;
-	Mem_Free( vq8 );
-	vq8 = NULL;
 }
 
 /*
@@ -405,6 +443,24 @@ idCinematicLocal::idCinematicLocal()
 	status = FMV_EOF;
 	buf = NULL;
 	iFile = NULL;
+	file = NULL;
+	vq2 = NULL;
+	vq4 = NULL;
+	vq8 = NULL;
+	
+	decodeThread = NULL;
+	for( int i = 0; i < CIN_DECODE_FRAMES; i++ )
+	{
+		decodedFrames[i] = NULL;
+		decodedFrameNums[i] = -1;
+	}
+	decodeAheadTo = -1;
+	uploadedFrame = -1;
+	decodeEnded = false;
+	decodeTime = 0;
+	framesDecoded = 0;
+	framesDropped = 0;
+	
 	img = globalImages->AllocStandaloneImage( "_cinematic" );
 	if( img != NULL )
 	{
@@ -433,6 +489,14 @@ idCinematicLocal::~idCinematicLocal()
 	qStatus[0] = NULL;
 	Mem_Free( qStatus[1] );
 	qStatus[1] = NULL;
+	Mem_Free( file );
+	file = NULL;
+	Mem_Free( vq2 );
+	vq2 = NULL;
+	Mem_Free( vq4 );
+	vq4 = NULL;
+	Mem_Free( vq8 );
+	vq8 = NULL;
 	
 #if defined(USE_FFMPEG)
 	// Carl: ffmpeg for bink and other video files:
@@ -587,6 +651,7 @@ void idCinematicLocal::FFMPEGReset()
 	//startTime = 0;
 	
 	framePos = -1;
+	ClearDecodedFrames();
 	
 	if( av_seek_frame( fmt_ctx, video_stream_index, 0, 0 ) >= 0 )
 	{
@@ -632,7 +697,20 @@ bool idCinematicLocal::InitFromFile( const char* qpath, bool amilooping )
 	//	fileName = "video\\idlogo.roq";
 	//}
 	
-	iFile = fileSystem->OpenFileRead( fileName );
+	decodeTime = 0;
+	framesDecoded = 0;
+	framesDropped = 0;
+	
+	// files inside resource containers share the container's file handle, so read them
+	// into memory up front if the decode thread is going to read from them
+	if( r_cinematicDecodeAhead.GetBool() && fileSystem->UsingResourceFiles() )
+	{
+		iFile = fileSystem->OpenFileReadMemory( fileName );
+	}
+	else
+	{
+		iFile = fileSystem->OpenFileRead( fileName );
+	}
 	
 	// Carl: If the RoQ file doesn't exist, try using ffmpeg instead:
 	if( !iFile )
@@ -663,6 +741,14 @@ bool idCinematicLocal::InitFromFile( const char* qpath, bool amilooping )
 	startTime = 0;	//Sys_Milliseconds();
 	buf = NULL;
 	
+	if( file == NULL )
+	{
+		file = ( byte* )Mem_Alloc( 65536, TAG_CINEMATIC );
+		vq2 = ( word* )Mem_Alloc( 256 * 16 * 4 * sizeof( word ), TAG_CINEMATIC );
+		vq4 = ( word* )Mem_Alloc( 256 * 64 * 4 * sizeof( word ), TAG_CINEMATIC );
+		vq8 = ( word* )Mem_Alloc( 256 * 256 * 4 * sizeof( word ), TAG_CINEMATIC );
+	}
+	
 	iFile->Read( file, 16 );
 	
 	RoQID = ( unsigned short )( file[0] ) + ( unsigned short )( file[1] ) * 256;
@@ -693,6 +779,14 @@ idCinematicLocal::Close
 */
 void idCinematicLocal::Close()
 {
+	// the decode thread has to be stopped before anything it uses goes away
+	if( decodeThread != NULL )
+	{
+		delete decodeThread;
+		decodeThread = NULL;
+	}
+	FreeDecodedFrames();
+	
 	if( image )
 	{
 		Mem_Free( ( void* )image );
@@ -742,6 +836,11 @@ int idCinematicLocal::AnimationLength()
 // RB begin
 bool idCinematicLocal::IsPlaying() const
 {
+	// status can change while the decode thread runs
+	if( decodeThread != NULL )
+	{
+		decodeThread->WaitForThread();
+	}
 	return ( status == FMV_PLAY );
 }
 // RB end
@@ -753,10 +852,237 @@ idCinematicLocal::ResetTime
 */
 void idCinematicLocal::ResetTime( int time )
 {
+	FinishDecodeAhead();
+	
 	startTime = time; //originally this was: ( backEnd.viewDef ) ? 1000 * backEnd.viewDef->floatTime : -1;
 	status = FMV_PLAY;
 }
 
+/*
+==============
+idCinematicDecodeThread::Run
+==============
+*/
+int idCinematicDecodeThread::Run()
+{
+	cinematic->DecodeAhead();
+	return 0;
+}
+
+/*
+==============
+idCinematicLocal::CurrentFrame
+
+The frame the decoder produced last
+==============
+*/
+int idCinematicLocal::CurrentFrame() const
+{
+#if defined(USE_FFMPEG)
+	if( !isRoQ )
+	{
+		return framePos;
+	}
+#endif
+	return numQuads;
+}
+
+/*
+==============
+idCinematicLocal::DecodeNextFrame
+
+Decodes one frame and keeps a copy of it if asked to, returns false when it
+runs into the end of the file.
+==============
+*/
+bool idCinematicLocal::DecodeNextFrame( bool keep )
+{
+	uint64 decodeStart = Sys_Microseconds();
+	
+	bool decoded;
+#if defined(USE_FFMPEG)
+	if( !isRoQ )
+	{
+		decoded = FFMPEGDecodeFrame( keep );
+	}
+	else
+#endif
+	{
+		decoded = RoQDecodeFrame( keep );
+	}
+	
+	decodeTime += Sys_Microseconds() - decodeStart;
+	if( decoded )
+	{
+		framesDecoded++;
+	}
+	return decoded;
+}
+
+/*
+==============
+idCinematicLocal::DecodeAhead
+
+Runs on the decode thread
+==============
+*/
+void idCinematicLocal::DecodeAhead()
+{
+	while( !decodeEnded && CurrentFrame() < decodeAheadTo )
+	{
+		if( !DecodeNextFrame( true ) )
+		{
+			decodeEnded = true;
+			break;
+		}
+	}
+}
+
+/*
+==============
+idCinematicLocal::StartDecodeAhead
+
+Lets the decode thread fill the frames after frameNum while the game keeps running
+==============
+*/
+void idCinematicLocal::StartDecodeAhead( int frameNum )
+{
+	if( !r_cinematicDecodeAhead.GetBool() || status != FMV_PLAY || decodeEnded )
+	{
+		return;
+	}
+	
+	// frameNum may still be on screen, so its slot in the ring stays untouched
+	decodeAheadTo = frameNum + CIN_DECODE_FRAMES - 1;
+	if( CurrentFrame() >= decodeAheadTo )
+	{
+		return;
+	}
+	
+	if( decodeThread == NULL )
+	{
+		// every cinematic decodes its first frame when it's loaded, most of them are never
+		// played so only start a thread once playback gets past that
+		if( frameNum <= 1 )
+		{
+			return;
+		}
+		decodeThread = new( TAG_CINEMATIC ) idCinematicDecodeThread();
+		decodeThread->cinematic = this;
+		decodeThread->StartWorkerThread( "Cinematic", CORE_ANY, THREAD_BELOW_NORMAL );
+	}
+	decodeThread->SignalWork();
+}
+
+/*
+==============
+idCinematicLocal::FinishDecodeAhead
+
+Has to be called before the decoder state is touched on the calling thread
+==============
+*/
+void idCinematicLocal::FinishDecodeAhead()
+{
+	if( decodeThread != NULL )
+	{
+		decodeThread->WaitForThread();
+	}
+}
+
+/*
+==============
+idCinematicLocal::ClearDecodedFrames
+
+Forgets the decoded frames after the decoder was reset
+==============
+*/
+void idCinematicLocal::ClearDecodedFrames()
+{
+	for( int i = 0; i < CIN_DECODE_FRAMES; i++ )
+	{
+		decodedFrameNums[i] = -1;
+	}
+	uploadedFrame = -1;
+	decodeEnded = false;
+}
+
+/*
+==============
+idCinematicLocal::FreeDecodedFrames
+==============
+*/
+void idCinematicLocal::FreeDecodedFrames()
+{
+	for( int i = 0; i < CIN_DECODE_FRAMES; i++ )
+	{
+		Mem_Free16( decodedFrames[i] );
+		decodedFrames[i] = NULL;
+	}
+	ClearDecodedFrames();
+}
+
+/*
+==============
+idCinematicLocal::FindDecodedFrame
+==============
+*/
+byte* idCinematicLocal::FindDecodedFrame( int frameNum )
+{
+	if( frameNum < 0 )
+	{
+		return NULL;
+	}
+	int slot = frameNum % CIN_DECODE_FRAMES;
+	if( decodedFrameNums[slot] != frameNum )
+	{
+		return NULL;
+	}
+	return decodedFrames[slot];
+}
+
+/*
+==============
+idCinematicLocal::AllocDecodedFrame
+==============
+*/
+byte* idCinematicLocal::AllocDecodedFrame( int frameNum )
+{
+	int slot = frameNum % CIN_DECODE_FRAMES;
+	if( decodedFrames[slot] == NULL )
+	{
+		decodedFrames[slot] = ( byte* )Mem_Alloc16( CIN_WIDTH * CIN_HEIGHT * 4, TAG_CINEMATIC );
+	}
+	decodedFrameNums[slot] = frameNum;
+	return decodedFrames[slot];
+}
+
+/*
+==============
+idCinematicLocal::UploadFrame
+==============
+*/
+void idCinematicLocal::UploadFrame( const byte* rgba, int frameNum )
+{
+	if( rgba == NULL || frameNum == uploadedFrame )
+	{
+		return;
+	}
+	
+	// every frame that was skipped over was decoded for nothing
+	if( uploadedFrame >= 0 && frameNum > uploadedFrame + 1 )
+	{
+		framesDropped += frameNum - uploadedFrame - 1;
+	}
+	uploadedFrame = frameNum;
+	
+	img->UploadScratch( rgba, CIN_WIDTH, CIN_HEIGHT );
+	
+	if( r_showCinematics.GetBool() )
+	{
+		common->Printf( "%s: frame %d, %d decoded, %d dropped, %.2f ms decode per frame\n", fileName.c_str(), frameNum, framesDecoded, framesDropped, framesDecoded > 0 ? decodeTime * 0.001f / framesDecoded : 0.0f );
+	}
+}
+
 /*
 ==============
 idCinematicLocal::ImageForTime
@@ -797,6 +1123,9 @@ cinData_t idCinematicLocal::ImageForTime( int thisTime )
 		return cinData;
 	}
 	
+	// the decode thread owns the decoder until it's done
+	FinishDecodeAhead();
+	
 	if( status == FMV_EOF || status == FMV_IDLE )
 	{
 		return cinData;
@@ -818,7 +1147,34 @@ cinData_t idCinematicLocal::ImageForTime( int thisTime )
 		tfps = 0;
 	}
 	
-	if( tfps < numQuads )
+	// numQuads is 1 after the first frame
+	int frameNum = Max( tfps, 1 );
+	
+	const byte* frameImage = FindDecodedFrame( frameNum );
+	if( frameImage != NULL || frameNum == uploadedFrame )
+	{
+		cinData.imageWidth = CIN_WIDTH;
+		cinData.imageHeight = CIN_HEIGHT;
+		cinData.status = status;
+		UploadFrame( frameImage, frameNum );
+		cinData.image = img;
+		
+		StartDecodeAhead( frameNum );
+		return cinData;
+	}
+	
+	// the frame wasn't decoded ahead, so we're behind and have to catch up here
+	uint64 decodeStart = Sys_Microseconds();
+	int decodedBefore = numQuads;
+	
+	if( decodeEnded )
+	{
+		// the decode thread ran into the end, handle it the same way as if it had happened here
+		decodeEnded = false;
+		status = FMV_EOF;
+	}
+	
+	if( frameNum < numQuads )
 	{
 		RoQReset();
 		buf = NULL;
@@ -834,12 +1190,17 @@ cinData_t idCinematicLocal::ImageForTime( int thisTime )
 	}
 	else
 	{
-		while( ( tfps != numQuads && status == FMV_PLAY ) )
+		while( ( frameNum != numQuads && status == FMV_PLAY ) )
 		{
 			RoQInterrupt();
 		}
 	}
 	
+	if( numQuads > decodedBefore )
+	{
+		framesDecoded += numQuads - decodedBefore;
+	}
+	
 	if( status == FMV_LOOPED )
 	{
 		status = FMV_PLAY;
@@ -872,16 +1233,108 @@ cinData_t idCinematicLocal::ImageForTime( int thisTime )
 			RoQShutdown();
 		}
 	}
+	decodeTime += Sys_Microseconds() - decodeStart;
 	
 	cinData.imageWidth = CIN_WIDTH;
 	cinData.imageHeight = CIN_HEIGHT;
 	cinData.status = status;
-	img->UploadScratch( image, CIN_WIDTH, CIN_HEIGHT );
+	UploadFrame( buf, numQuads );
 	cinData.image = img;
 	
+	StartDecodeAhead( numQuads );
 	return cinData;
 }
 
+/*
+==============
+CIN_YUV420PToRGBA
+
+BT.601 video range, the same as what swscale does for these videos. The intrinsics
+path does eight pixels at a time with the same fixed point math as the scalar one,
+so both give identical results.
+==============
+*/
+#if defined(USE_FFMPEG)
+static const int CIN_YUV_Y		= 74;	// 1.164 * 64
+static const int CIN_YUV_VR		= 102;	// 1.596 * 64
+static const int CIN_YUV_UG		= 25;	// 0.392 * 64
+static const int CIN_YUV_VG		= 52;	// 0.813 * 64
+static const int CIN_YUV_UB		= 129;	// 2.017 * 64
+
+static void CIN_YUV420PToRGBA( const byte* yPlane, int yStride, const byte* uPlane, const byte* vPlane, int uvStride, byte* rgba, int width, int height )
+{
+#if defined(USE_INTRINSICS)
+	const __m128i vector_zero = _mm_setzero_si128();
+	const __m128i vector_alpha = _mm_set1_epi8( ( char )0xFF );
+	const __m128i vector_y_bias = _mm_set1_epi16( 16 );
+	const __m128i vector_uv_bias = _mm_set1_epi16( 128 );
+	const __m128i vector_y = _mm_set1_epi16( CIN_YUV_Y );
+	const __m128i vector_vr = _mm_set1_epi16( CIN_YUV_VR );
+	const __m128i vector_ug = _mm_set1_epi16( CIN_YUV_UG );
+	const __m128i vector_vg = _mm_set1_epi16( CIN_YUV_VG );
+	const __m128i vector_ub = _mm_set1_epi16( CIN_YUV_UB );
+#endif
+	
+	for( int j = 0; j < height; j++ )
+	{
+		const byte* yRow = yPlane + j * yStride;
+		const byte* uRow = uPlane + ( j >> 1 ) * uvStride;
+		const byte* vRow = vPlane + ( j >> 1 ) * uvStride;
+		byte* dst = rgba + j * width * 4;
+		
+		int i = 0;
+		
+#if defined(USE_INTRINSICS)
+		for( ; i + 8 <= width; i += 8 )
+		{
+			int u4, v4;
+			memcpy( &u4, uRow + ( i >> 1 ), 4 );
+			memcpy( &v4, vRow + ( i >> 1 ), 4 );
+			
+			__m128i y = _mm_unpacklo_epi8( _mm_loadl_epi64( ( const __m128i* )( yRow + i ) ), vector_zero );
+			__m128i u = _mm_cvtsi32_si128( u4 );
+			__m128i v = _mm_cvtsi32_si128( v4 );
+			
+			// each chroma sample covers two pixels
+			u = _mm_unpacklo_epi8( _mm_unpacklo_epi8( u, u ), vector_zero );
+			v = _mm_unpacklo_epi8( _mm_unpacklo_epi8( v, v ), vector_zero );
+			
+			y = _mm_mullo_epi16( _mm_sub_epi16( y, vector_y_bias ), vector_y );
+			u = _mm_sub_epi16( u, vector_uv_bias );
+			v = _mm_sub_epi16( v, vector_uv_bias );
+			
+			// saturating adds are fine, anything that saturates clamps to 255 anyway
+			__m128i r = _mm_adds_epi16( y, _mm_mullo_epi16( v, vector_vr ) );
+			__m128i g = _mm_subs_epi16( _mm_subs_epi16( y, _mm_mullo_epi16( u, vector_ug ) ), _mm_mullo_epi16( v, vector_vg ) );
+			__m128i b = _mm_adds_epi16( y, _mm_mullo_epi16( u, vector_ub ) );
+			
+			r = _mm_packus_epi16( _mm_srai_epi16( r, 6 ), vector_zero );
+			g = _mm_packus_epi16( _mm_srai_epi16( g, 6 ), vector_zero );
+			b = _mm_packus_epi16( _mm_srai_epi16( b, 6 ), vector_zero );
+			
+			__m128i rg = _mm_unpacklo_epi8( r, g );
+			__m128i ba = _mm_unpacklo_epi8( b, vector_alpha );
+			
+			_mm_storeu_si128( ( __m128i* )( dst + i * 4 + 0 ), _mm_unpacklo_epi16( rg, ba ) );
+			_mm_storeu_si128( ( __m128i* )( dst + i * 4 + 16 ), _mm_unpackhi_epi16( rg, ba ) );
+		}
+#endif
+		
+		for( ; i < width; i++ )
+		{
+			int y = ( yRow[i] - 16 ) * CIN_YUV_Y;
+			int u = uRow[i >> 1] - 128;
+			int v = vRow[i >> 1] - 128;
+			
+			dst[i * 4 + 0] = ( byte )idMath::ClampInt( 0, 255, ( y + v * CIN_YUV_VR ) >> 6 );
+			dst[i * 4 + 1] = ( byte )idMath::ClampInt( 0, 255, ( y - u * CIN_YUV_UG - v * CIN_YUV_VG ) >> 6 );
+			dst[i * 4 + 2] = ( byte )idMath::ClampInt( 0, 255, ( y + u * CIN_YUV_UB ) >> 6 );
+			dst[i * 4 + 3] = 255;
+		}
+	}
+}
+#endif
+
 /*
 ==============
 idCinematicLocal::ImageForTimeFFMPEG
@@ -909,6 +1362,9 @@ cinData_t idCinematicLocal::ImageForTimeFFMPEG( int thisTime )
 		return cinData;
 	}
 	
+	// the decode thread owns the decoder until it's done
+	FinishDecodeAhead();
+	
 	if( ( !hasFrame ) || startTime == -1 )
 	{
 		if( startTime == -1 )
@@ -924,44 +1380,27 @@ cinData_t idCinematicLocal::ImageForTimeFFMPEG( int thisTime )
 		desiredFrame = 0;
 	}
 	
-	if( desiredFrame < framePos )
+	const byte* frameImage = FindDecodedFrame( desiredFrame );
+	if( frameImage == NULL && !( hasFrame && desiredFrame == uploadedFrame ) )
 	{
-		FFMPEGReset();
-	}
-	
-	if( hasFrame && desiredFrame == framePos )
-	{
-		cinData.imageWidth = CIN_WIDTH;
-		cinData.imageHeight = CIN_HEIGHT;
-		cinData.status = status;
-		cinData.image = img;
-		return cinData;
-	}
-	
-	AVPacket packet;
-	while( framePos < desiredFrame )
-	{
-		int frameFinished = 0;
+		if( desiredFrame < framePos )
+		{
+			FFMPEGReset();
+		}
 		
-		// Do a single frame by getting packets until we have a full frame
-		while( !frameFinished )
+		// we're behind, decode up to the desired frame but only convert that one
+		while( framePos < desiredFrame )
 		{
-			// if we got to the end or failed
-			if( av_read_frame( fmt_ctx, &packet ) < 0 )
+			if( !DecodeNextFrame( framePos + 1 == desiredFrame ) )
 			{
 				// can't read any more, set to EOF
 				status = FMV_EOF;
-				if( looping )
+				if( looping && framePos >= 0 )
 				{
 					desiredFrame = 0;
 					FFMPEGReset();
 					framePos = -1;
 					startTime = thisTime;
-					if( av_read_frame( fmt_ctx, &packet ) < 0 )
-					{
-						status = FMV_IDLE;
-						return cinData;
-					}
 					status = FMV_PLAY;
 				}
 				else
@@ -970,31 +1409,78 @@ cinData_t idCinematicLocal::ImageForTimeFFMPEG( int thisTime )
 					return cinData;
 				}
 			}
-			// Is this a packet from the video stream?
-			if( packet.stream_index == video_stream_index )
-			{
-				// Decode video frame
-				avcodec_decode_video2( dec_ctx, frame, &frameFinished, &packet );
-			}
-			// Free the packet that was allocated by av_read_frame
-			av_free_packet( &packet );
 		}
-		
-		framePos++;
+		frameImage = FindDecodedFrame( desiredFrame );
 	}
 	
-	// We have reached the desired frame
-	// Convert the image from its native format to RGB
-	sws_scale( img_convert_ctx, frame->data, frame->linesize, 0, dec_ctx->height, frame2->data, frame2->linesize );
 	cinData.imageWidth = CIN_WIDTH;
 	cinData.imageHeight = CIN_HEIGHT;
 	cinData.status = status;
-	img->UploadScratch( image, CIN_WIDTH, CIN_HEIGHT );
+	UploadFrame( frameImage, desiredFrame );
 	hasFrame = true;
 	cinData.image = img;
 	
+	StartDecodeAhead( desiredFrame );
 	return cinData;
 }
+
+/*
+==============
+idCinematicLocal::FFMPEGDecodeFrame
+
+Reads packets until the next frame is done
+==============
+*/
+bool idCinematicLocal::FFMPEGDecodeFrame( bool keep )
+{
+	AVPacket packet;
+	int frameFinished = 0;
+	
+	// Do a single frame by getting packets until we have a full frame
+	while( !frameFinished )
+	{
+		// if we got to the end or failed
+		if( av_read_frame( fmt_ctx, &packet ) < 0 )
+		{
+			return false;
+		}
+		// Is this a packet from the video stream?
+		if( packet.stream_index == video_stream_index )
+		{
+			// Decode video frame
+			avcodec_decode_video2( dec_ctx, frame, &frameFinished, &packet );
+		}
+		// Free the packet that was allocated by av_read_frame
+		av_free_packet( &packet );
+	}
+	
+	framePos++;
+	
+	if( keep )
+	{
+		FFMPEGConvertFrame( AllocDecodedFrame( framePos ) );
+	}
+	return true;
+}
+
+/*
+==============
+idCinematicLocal::FFMPEGConvertFrame
+
+Converts the decoded frame from its native format to RGBA
+==============
+*/
+void idCinematicLocal::FFMPEGConvertFrame( byte* rgba )
+{
+	if( dec_ctx->pix_fmt == AV_PIX_FMT_YUV420P && dec_ctx->width == CIN_WIDTH && dec_ctx->height == CIN_HEIGHT )
+	{
+		CIN_YUV420PToRGBA( frame->data[0], frame->linesize[0], frame->data[1], frame->data[2], frame->linesize[1], rgba, CIN_WIDTH, CIN_HEIGHT );
+		return;
+	}
+	
+	avpicture_fill( ( AVPicture* )frame2, rgba, AV_PIX_FMT_BGR32, CIN_WIDTH, CIN_HEIGHT );
+	sws_scale( img_convert_ctx, frame->data, frame->linesize, 0, dec_ctx->height, frame2->data, frame2->linesize );
+}
 #endif
 
 /*
@@ -1988,7 +2474,8 @@ idCinematicLocal::RoQReset
 */
 void idCinematicLocal::RoQReset()
 {
-
+	ClearDecodedFrames();
+	
 	iFile->Seek( 0, FS_SEEK_SET );
 	iFile->Read( file, 16 );
 	RoQ_init();
@@ -2499,6 +2986,52 @@ void idCinematicLocal::RoQShutdown()
 	fileName = "";
 }
 
+/*
+==============
+idCinematicLocal::RoQDecodeFrame
+
+Runs RoQInterrupt until the next frame is done
+==============
+*/
+bool idCinematicLocal::RoQDecodeFrame( bool keep )
+{
+	if( buf == NULL || status != FMV_PLAY || decodeEnded || RoQPlayed >= ROQSize )
+	{
+		return false;
+	}
+	
+	// don't let RoQInterrupt loop back to the start, ImageForTime handles the end of the
+	// file once the frames before it have been shown
+	bool wasLooping = looping;
+	looping = false;
+	
+	int frameNum = numQuads;
+	while( numQuads == frameNum && status == FMV_PLAY )
+	{
+		RoQInterrupt();
+	}
+	
+	looping = wasLooping;
+	
+	if( status == FMV_EOF )
+	{
+		// remembered until ImageForTime runs out of decoded frames
+		status = FMV_PLAY;
+		decodeEnded = true;
+	}
+	
+	if( numQuads != frameNum + 1 )
+	{
+		return false;
+	}
+	
+	if( keep )
+	{
+		memcpy( AllocDecodedFrame( numQuads ), buf, CIN_WIDTH * CIN_HEIGHT * 4 );
+	}
+	return true;
+}
+
 //===========================================
 
 /*
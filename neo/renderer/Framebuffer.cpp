@@ -81,6 +81,12 @@ void Framebuffer::Init()
 	
 	backEnd.glState.currentFramebuffer = NULL;
 	
+	// the null renderer never draws, so there is nothing to render into
+	if( r_nullRenderer.GetBool() )
+	{
+		return;
+	}
+	
 	// SHADOWMAPS
 	
 	int width, height;
@@ -202,6 +208,11 @@ void Framebuffer::Init()
 
 void Framebuffer::CheckFramebuffers()
 {
+	if( globalFramebuffers.hdrFBO == NULL )
+	{
+		return;
+	}
+	
 	if( globalFramebuffers.hdrFBO->GetWidth() != glConfig.nativeScreenWidth || globalFramebuffers.hdrFBO->GetHeight() != glConfig.nativeScreenHeight )
 	{
 		Unbind();
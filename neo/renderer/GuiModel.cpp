@@ -35,6 +35,11 @@ const float idGuiModel::STEREO_DEPTH_NEAR = 0.0f;
 const float idGuiModel::STEREO_DEPTH_MID  = 0.5f;
 const float idGuiModel::STEREO_DEPTH_FAR  = 1.0f;
 
+// how many batches back a surface may be moved to join one with the same state
+static const int GUI_BATCH_SEARCH = 64;
+
+idCVar r_batchGuiSurfaces( "r_batchGuiSurfaces", "1", CVAR_RENDERER | CVAR_BOOL, "merge gui surfaces with the same material and state when they don't overlap" );
+
 /*
 ================
 idGuiModel::idGuiModel
@@ -47,6 +52,26 @@ idGuiModel::idGuiModel()
 	{
 		shaderParms[i] = 1.0f;
 	}
+	
+	vertexBlock = 0;
+	indexBlock = 0;
+	vertexPointer = ( idDrawVert* )Mem_Alloc16( MAX_VERTS * sizeof( idDrawVert ), TAG_MODEL );
+	indexPointer = ( triIndex_t* )Mem_Alloc16( MAX_INDEXES * sizeof( triIndex_t ), TAG_MODEL );
+	batchIndexPointer = ( triIndex_t* )Mem_Alloc16( MAX_INDEXES * sizeof( triIndex_t ), TAG_MODEL );
+	numVerts = 0;
+	numIndexes = 0;
+}
+
+/*
+================
+idGuiModel::~idGuiModel
+================
+*/
+idGuiModel::~idGuiModel()
+{
+	Mem_Free16( vertexPointer );
+	Mem_Free16( indexPointer );
+	Mem_Free16( batchIndexPointer );
 }
 
 /*
@@ -58,6 +83,9 @@ Begins collecting draw commands into surfaces
 */
 void idGuiModel::Clear()
 {
+	// everything staged so far has either been emitted or is being thrown away
+	numVerts = 0;
+	numIndexes = 0;
 	surfaces.SetNum( 0 );
 	AdvanceSurf();
 }
@@ -87,15 +115,125 @@ idGuiModel::BeginFrame
 */
 void idGuiModel::BeginFrame()
 {
-	vertexBlock = vertexCache.AllocVertex( NULL, ALIGN( MAX_VERTS * sizeof( idDrawVert ), VERTEX_CACHE_ALIGN ) );
-	indexBlock = vertexCache.AllocIndex( NULL, ALIGN( MAX_INDEXES * sizeof( triIndex_t ), INDEX_CACHE_ALIGN ) );
-	vertexPointer = ( idDrawVert* )vertexCache.MappedVertexBuffer( vertexBlock );
-	indexPointer = ( triIndex_t* )vertexCache.MappedIndexBuffer( indexBlock );
-	numVerts = 0;
-	numIndexes = 0;
+	vertexBlock = 0;
+	indexBlock = 0;
 	Clear();
 }
 
+/*
+================
+R_GuiBoundsOverlap
+
+Only the screen plane matters, surfaces that merely share an edge don't overlap
+================
+*/
+static ID_INLINE bool R_GuiBoundsOverlap( const idBounds& a, const idBounds& b )
+{
+	if( a[1].x <= b[0].x || a[1].y <= b[0].y || a[0].x >= b[1].x || a[0].y >= b[1].y )
+	{
+		return false;
+	}
+	return true;
+}
+
+/*
+================
+idGuiModel::BatchSurfaces
+
+Every material or state change in the gui code starts a new surface, so text and
+icons drawn in alternation produce long runs of tiny surfaces. A surface can be
+pulled back into an earlier surface with the same state as long as nothing drawn
+in between overlaps it, which keeps the painter's order intact.
+
+Glyphs of a font page and the bitmaps of a swf atlas share a single material, so
+they merge like any other surface.
+
+Fills batches and batchIndexPointer, returns the number of indexes written.
+================
+*/
+int idGuiModel::BatchSurfaces()
+{
+	batches.SetNum( 0 );
+	batchBounds.SetNum( 0 );
+	surfaceBatch.SetNum( surfaces.Num() );
+	
+	for( int i = 0; i < surfaces.Num(); i++ )
+	{
+		const guiModelSurface_t& guiSurf = surfaces[i];
+		
+		surfaceBatch[i] = -1;
+		if( guiSurf.numIndexes == 0 )
+		{
+			continue;
+		}
+		
+		idBounds bounds;
+		bounds.Clear();
+		const triIndex_t* indexes = indexPointer + guiSurf.firstIndex;
+		for( int j = 0; j < guiSurf.numIndexes; j++ )
+		{
+			bounds.AddPoint( vertexPointer[ indexes[j] ].xyz );
+		}
+		
+		// walk back until we find a batch with the same state, or something
+		// that would be drawn over by this surface if it was moved back
+		int batchNum = -1;
+		const int firstBatch = Max( batches.Num() - GUI_BATCH_SEARCH, 0 );
+		for( int j = batches.Num() - 1; j >= firstBatch; j-- )
+		{
+			const guiModelSurface_t& batch = batches[j];
+			if( batch.material == guiSurf.material && batch.glState == guiSurf.glState && batch.stereoType == guiSurf.stereoType )
+			{
+				batchNum = j;
+				break;
+			}
+			if( R_GuiBoundsOverlap( bounds, batchBounds[j] ) )
+			{
+				break;
+			}
+		}
+		
+		if( batchNum == -1 )
+		{
+			batchNum = batches.Append( guiSurf );
+			batches[batchNum].numIndexes = 0;
+			batchBounds.Append( bounds );
+		}
+		else
+		{
+			batchBounds[batchNum].AddBounds( bounds );
+		}
+		batches[batchNum].numIndexes += guiSurf.numIndexes;
+		surfaceBatch[i] = batchNum;
+	}
+	
+	// lay the batches out back to back, keeping each one 16 byte aligned
+	int numBatchIndexes = 0;
+	for( int i = 0; i < batches.Num(); i++ )
+	{
+		numBatchIndexes = ALIGN( numBatchIndexes, 8 );
+		batches[i].firstIndex = numBatchIndexes;
+		numBatchIndexes += batches[i].numIndexes;
+		batches[i].numIndexes = 0;
+	}
+	
+	// copy the indexes in the original order so each batch draws its
+	// surfaces in the order they were submitted
+	for( int i = 0; i < surfaces.Num(); i++ )
+	{
+		if( surfaceBatch[i] == -1 )
+		{
+			continue;
+		}
+		const guiModelSurface_t& guiSurf = surfaces[i];
+		guiModelSurface_t& batch = batches[ surfaceBatch[i] ];
+		memcpy( batchIndexPointer + batch.firstIndex + batch.numIndexes, indexPointer + guiSurf.firstIndex, guiSurf.numIndexes * sizeof( triIndex_t ) );
+		batch.numIndexes += guiSurf.numIndexes;
+	}
+	
+	return numBatchIndexes;
+}
+
 idCVar	stereoRender_defaultGuiDepth( "stereoRender_defaultGuiDepth", "0", CVAR_RENDERER, "Fraction of separation when not specified" );
 /*
 ================
@@ -107,7 +245,32 @@ For full screen GUIs, we can add in per-surface stereoscopic depth effects
 void idGuiModel::EmitSurfaces( float modelMatrix[16], float modelViewMatrix[16],
 							   bool depthHack, bool allowFullScreenStereoDepth, bool linkAsEntity )
 {
-
+	if( numIndexes == 0 )
+	{
+		return;
+	}
+	
+	const idList<guiModelSurface_t, TAG_MODEL>* emitSurfaces = &surfaces;
+	const triIndex_t* emitIndexes = indexPointer;
+	int numEmitIndexes = numIndexes;
+	if( r_batchGuiSurfaces.GetBool() )
+	{
+		numEmitIndexes = BatchSurfaces();
+		emitSurfaces = &batches;
+		emitIndexes = batchIndexPointer;
+	}
+	
+	tr.pc.c_guiModelSurfaces += surfaces.Num();
+	tr.pc.c_guiModelBatches += emitSurfaces->Num();
+	
+	// copy the staged geometry into frame-temporary buffer memory
+	vertexBlock = vertexCache.AllocVertex( vertexPointer, ALIGN( numVerts * sizeof( idDrawVert ), VERTEX_CACHE_ALIGN ) );
+	indexBlock = vertexCache.AllocIndex( emitIndexes, ALIGN( numEmitIndexes * sizeof( triIndex_t ), INDEX_CACHE_ALIGN ) );
+	if( vertexBlock == 0 || indexBlock == 0 )
+	{
+		return;
+	}
+	
 	viewEntity_t* guiSpace = ( viewEntity_t* )R_ClearedFrameAlloc( sizeof( *guiSpace ), FRAME_ALLOC_VIEW_ENTITY );
 	memcpy( guiSpace->modelMatrix, modelMatrix, sizeof( guiSpace->modelMatrix ) );
 	memcpy( guiSpace->modelViewMatrix, modelViewMatrix, sizeof( guiSpace->modelViewMatrix ) );
@@ -141,9 +304,9 @@ void idGuiModel::EmitSurfaces( float modelMatrix[16], float modelViewMatrix[16],
 	float defaultStereoDepth = stereoRender_defaultGuiDepth.GetFloat();	// default to at-screen
 	
 	// add the surfaces to this view
-	for( int i = 0; i < surfaces.Num(); i++ )
+	for( int i = 0; i < emitSurfaces->Num(); i++ )
 	{
-		const guiModelSurface_t& guiSurf = surfaces[i];
+		const guiModelSurface_t& guiSurf = ( *emitSurfaces )[i];
 		if( guiSurf.numIndexes == 0 )
 		{
 			continue;
@@ -406,21 +569,9 @@ idDrawVert* idGuiModel::AllocTris( int vertCount, const triIndex_t* tempIndexes,
 	
 	surf->numIndexes += indexCount;
 	
-	if( ( startIndex & 1 ) || ( indexCount & 1 ) )
-	{
-		// slow for write combined memory!
-		// this should be very rare, since quads are always an even index count
-		for( int i = 0; i < indexCount; i++ )
-		{
-			indexPointer[startIndex + i] = startVert + tempIndexes[i];
-		}
-	}
-	else
+	for( int i = 0; i < indexCount; i++ )
 	{
-		for( int i = 0; i < indexCount; i += 2 )
-		{
-			WriteIndexPair( indexPointer + startIndex + i, startVert + tempIndexes[i], startVert + tempIndexes[i + 1] );
-		}
+		indexPointer[startIndex + i] = startVert + tempIndexes[i];
 	}
 	
 	return vertexPointer + startVert;
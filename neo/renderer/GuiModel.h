@@ -41,20 +41,21 @@ class idGuiModel
 {
 public:
 	idGuiModel();
+	~idGuiModel();
 	
 	void	Clear();
 	
 	void	WriteToDemo( idDemoFile* demo );
 	void	ReadFromDemo( idDemoFile* demo );
 	
-	// allocates memory for verts and indexes in frame-temporary buffer memory
+	// resets the staging buffers for a new frame
 	void	BeginFrame();
 	
 	void	EmitToCurrentView( float modelMatrix[16], bool depthHack );
 	void	EmitFullScreen();
 	
-	// the returned pointer will be in write-combined memory, so only make contiguous
-	// 32 bit writes and never read from it.
+	// the returned pointer is in cached staging memory, the verts are copied to
+	// frame-temporary buffer memory when the surfaces are emitted.
 	idDrawVert* AllocTris( int numVerts, const triIndex_t* indexes, int numIndexes, const idMaterial* material,
 						   const uint64 glState, const stereoDepthType_t stereoType );
 						   
@@ -63,6 +64,7 @@ private:
 	void	AdvanceSurf();
 	void	EmitSurfaces( float modelMatrix[16], float modelViewMatrix[16],
 						  bool depthHack, bool allowFullScreenStereoDepth, bool linkAsEntity );
+	int		BatchSurfaces();
 						  
 	guiModelSurface_t* 			surf;
 	
@@ -80,10 +82,14 @@ private:
 	vertCacheHandle_t			indexBlock;
 	idDrawVert* 				vertexPointer;
 	triIndex_t* 				indexPointer;
+	triIndex_t* 				batchIndexPointer;
 	
 	int		numVerts;
 	int		numIndexes;
 	
 	idList<guiModelSurface_t, TAG_MODEL>	surfaces;
+	idList<guiModelSurface_t, TAG_MODEL>	batches;
+	idList<idBounds, TAG_MODEL>				batchBounds;
+	idList<int, TAG_MODEL>					surfaceBatch;
 };
 
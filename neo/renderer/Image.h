@@ -203,6 +203,12 @@ public:
 		return texnum != TEXTURE_NOT_LOADED;
 	}
 	
+	// true if the texture storage is owned by another image with identical contents
+	bool		IsShared() const
+	{
+		return sharedImage != NULL;
+	}
+	
 	static void			GetGeneratedName( idStr& _name, const textureUsage_t& _usage, const cubeFiles_t& _cube );
 	
 private:
@@ -211,6 +217,13 @@ private:
 	void				AllocImage();
 	void				DeriveOpts();
 	
+	// runtime content deduplication
+	void				ComputeContentDigest( idBinaryImage& im );
+	bool				ShareContentWith( idImage* owner );
+	void				ReleaseSharedStorage();
+	int					ContentKey() const;
+	bool				ContentMatches( const idImage* other ) const;
+	
 	// parameters that define this image
 	idStr				imgName;				// game path, including extension (except for cube maps), may be an image program
 	cubeFiles_t			cubeFiles;				// If this is a cube map, and if so, what kind
@@ -230,6 +243,13 @@ private:
 	
 	int					refCount;				// overall ref count
 	
+	// if set, texnum belongs to sharedImage because both have identical .bimage payloads
+	idImage* 			sharedImage;
+	int					numSharedRefs;			// number of images using our texnum
+	int					contentIndex;			// index into idImageManager::contentImages, -1 if never registered
+	bool				contentValid;			// contentDigest describes the currently loaded texture
+	byte				contentDigest[16];		// MD5 of the bimage headers and payload
+	
 	static const GLuint TEXTURE_NOT_LOADED = 0xFFFFFFFF;
 	
 	GLuint				texnum;				// gl texture binding
@@ -260,6 +280,12 @@ ID_INLINE idImage::idImage( const char* name ) : imgName( name )
 	sourceFileTime = FILE_NOT_FOUND_TIMESTAMP;
 	binaryFileTime = FILE_NOT_FOUND_TIMESTAMP;
 	refCount = 0;
+	
+	sharedImage = NULL;
+	numSharedRefs = 0;
+	contentIndex = -1;
+	contentValid = false;
+	memset( contentDigest, 0, sizeof( contentDigest ) );
 }
 
 
@@ -279,6 +305,8 @@ public:
 	{
 		insideLevelLoad = false;
 		preloadingMapImages = false;
+		levelSharedImages = 0;
+		levelSharedBytes = 0;
 	}
 	
 	void				Init();
@@ -387,9 +415,20 @@ public:
 	
 	bool				ExcludePreloadImage( const char* name );
 	
+	// runtime deduplication of images with identical contents, see idImage::ActuallyLoadImage
+	idImage* 			FindImageByContent( const idImage* image ) const;
+	void				RegisterImageContent( idImage* image, int oldKey );
+	void				TransferSharedImages( idImage* oldOwner );
+	void				PrintSharedImages() const;
+	
 	idList<idImage*, TAG_IDLIB_LIST_IMAGE>	images;
 	idHashIndex			imageHash;
 	
+	idList<idImage*, TAG_IDLIB_LIST_IMAGE>	contentImages;
+	idHashIndex			contentHash;
+	int					levelSharedImages;			// images that reused existing storage during this level load
+	int					levelSharedBytes;			// texture memory saved by that
+	
 	bool				insideLevelLoad;			// don't actually load images now
 	bool				preloadingMapImages;		// unless this is set
 };
@@ -38,6 +38,7 @@ idImageManager	imageManager;
 idImageManager* globalImages = &imageManager;
 
 idCVar preLoad_Images( "preLoad_Images", "1", CVAR_SYSTEM | CVAR_BOOL, "preload images during beginlevelload" );
+idCVar image_shareIdentical( "image_shareIdentical", "1", CVAR_RENDERER | CVAR_BOOL, "share one texture between images whose generated data is identical" );
 
 /*
 ===============
@@ -235,7 +236,10 @@ void R_ListImages_f( const idCmdArgs& args )
 			common->Printf( "%4i:",	i );
 			image->Print();
 		}
-		totalSize += image->StorageSize();
+		if( !image->IsShared() )
+		{
+			totalSize += image->StorageSize();
+		}
 		count++;
 	}
 	
@@ -268,6 +272,16 @@ void R_ListImages_f( const idCmdArgs& args )
 	common->Printf( " %5.1f total megabytes of images\n\n\n", totalSize / ( 1024 * 1024.0 ) );
 }
 
+/*
+===============
+R_ListSharedImages_f
+===============
+*/
+void R_ListSharedImages_f( const idCmdArgs& args )
+{
+	globalImages->PrintSharedImages();
+}
+
 /*
 ==============
 AllocImage
@@ -784,6 +798,7 @@ void idImageManager::Init()
 	
 	cmdSystem->AddCommand( "reloadImages", R_ReloadImages_f, CMD_FL_RENDERER, "reloads images" );
 	cmdSystem->AddCommand( "listImages", R_ListImages_f, CMD_FL_RENDERER, "lists images" );
+	cmdSystem->AddCommand( "listSharedImages", R_ListSharedImages_f, CMD_FL_RENDERER, "lists images that share the texture of an identical image" );
 	cmdSystem->AddCommand( "combineCubeImages", R_CombineCubeImages_f, CMD_FL_RENDERER, "combines six images for roq compression" );
 	
 	// should forceLoadImages be here?
@@ -798,6 +813,8 @@ void idImageManager::Shutdown()
 {
 	images.DeleteContents( true );
 	imageHash.Clear();
+	contentImages.Clear();
+	contentHash.Clear();
 	
 }
 
@@ -810,6 +827,8 @@ Frees all images used by the previous level
 void idImageManager::BeginLevelLoad()
 {
 	insideLevelLoad = true;
+	levelSharedImages = 0;
+	levelSharedBytes = 0;
 	
 	for( int i = 0 ; i < images.Num() ; i++ )
 	{
@@ -938,10 +957,122 @@ void idImageManager::EndLevelLoad()
 	
 	int	end = Sys_Milliseconds();
 	common->Printf( "%5i images loaded in %5.1f seconds\n", loadCount, ( end - start ) * 0.001 );
+	if( levelSharedImages > 0 )
+	{
+		common->Printf( "%5i images share identical data, %5.1f MB saved\n", levelSharedImages, levelSharedBytes / ( 1024 * 1024.0 ) );
+	}
 	common->Printf( "----------------------------------------\n" );
 	//R_ListImages_f( idCmdArgs( "sorted sorted", false ) );
 }
 
+/*
+===============
+idImageManager::FindImageByContent
+
+Returns a loaded image that owns its texture and has exactly the same
+generated data and sampler state, or NULL.
+===============
+*/
+idImage* idImageManager::FindImageByContent( const idImage* image ) const
+{
+	const int key = image->ContentKey();
+	for( int i = contentHash.First( key ); i != -1; i = contentHash.Next( i ) )
+	{
+		idImage* other = contentImages[i];
+		if( other == image || !other->contentValid || other->sharedImage != NULL || !other->IsLoaded() )
+		{
+			continue;
+		}
+		if( image->ContentMatches( other ) )
+		{
+			return other;
+		}
+	}
+	return NULL;
+}
+
+/*
+===============
+idImageManager::RegisterImageContent
+
+Images keep their slot in contentImages forever, only the hash key moves when the
+contents change on a reload.
+===============
+*/
+void idImageManager::RegisterImageContent( idImage* image, int oldKey )
+{
+	const int key = image->ContentKey();
+	if( image->contentIndex == -1 )
+	{
+		image->contentIndex = contentImages.Append( image );
+		contentHash.Add( key, image->contentIndex );
+	}
+	else if( key != oldKey )
+	{
+		contentHash.Remove( oldKey, image->contentIndex );
+		contentHash.Add( key, image->contentIndex );
+	}
+}
+
+/*
+===============
+idImageManager::TransferSharedImages
+
+The owner of a shared texture is being purged, promote the first image using it
+to be the new owner and point all others at that one.
+===============
+*/
+void idImageManager::TransferSharedImages( idImage* oldOwner )
+{
+	idImage* newOwner = NULL;
+	for( int i = 0; i < images.Num(); i++ )
+	{
+		idImage* image = images[i];
+		if( image->sharedImage != oldOwner )
+		{
+			continue;
+		}
+		if( newOwner == NULL )
+		{
+			newOwner = image;
+			newOwner->sharedImage = NULL;
+			newOwner->numSharedRefs = 0;
+		}
+		else
+		{
+			image->sharedImage = newOwner;
+			newOwner->numSharedRefs++;
+		}
+	}
+	oldOwner->numSharedRefs = 0;
+}
+
+/*
+===============
+idImageManager::PrintSharedImages
+===============
+*/
+void idImageManager::PrintSharedImages() const
+{
+	int count = 0;
+	int totalSize = 0;
+	
+	for( int i = 0; i < images.Num(); i++ )
+	{
+		const idImage* image = images[i];
+		if( image->sharedImage == NULL )
+		{
+			continue;
+		}
+		common->Printf( "%4ik %s -> %s\n", image->StorageSize() / 1024, image->GetName(), image->sharedImage->GetName() );
+		totalSize += image->StorageSize();
+		count++;
+	}
+	
+	common->Printf( "%i images share storage, %5.1f MB saved\n", count, totalSize / ( 1024 * 1024.0 ) );
+	common->Printf( "last level load: %i images, %5.1f MB saved\n", levelSharedImages, levelSharedBytes / ( 1024 * 1024.0 ) );
+}
+
 /*
 ===============
 idImageManager::StartBuild
@@ -32,6 +32,8 @@ If you have questions concerning this license or the applicable additional terms
 
 #include "tr_local.h"
 
+extern idCVar image_shareIdentical;
+
 /*
 ================
 BitsForFormat
@@ -566,6 +568,23 @@ void idImage::ActuallyLoadImage( bool fromBackEnd )
 		binaryFileTime = im.WriteGeneratedFile( sourceFileTime );
 	}
 	
+	// reuse the texture of an already loaded image with the same payload,
+	// this catches identical pixels under different names or image programs
+	if( image_shareIdentical.GetBool() )
+	{
+		const int oldKey = ContentKey();
+		ComputeContentDigest( im );
+		globalImages->RegisterImageContent( this, oldKey );
+		
+		idImage* owner = globalImages->FindImageByContent( this );
+		if( owner != NULL && ShareContentWith( owner ) )
+		{
+			globalImages->levelSharedImages++;
+			globalImages->levelSharedBytes += StorageSize();
+			return;
+		}
+	}
+	
 	AllocImage();
 	
 	
@@ -575,6 +594,123 @@ void idImage::ActuallyLoadImage( bool fromBackEnd )
 		const byte* data = im.GetImageData( i );
 		SubImageUpload( img.level, 0, 0, img.destZ, img.width, img.height, data );
 	}
+	
+	contentValid = image_shareIdentical.GetBool();
+}
+
+/*
+===============
+idImage::ComputeContentDigest
+
+Hashes everything that ends up in the texture object: the storage layout,
+the sampler state and the payload of every level.
+===============
+*/
+void idImage::ComputeContentDigest( idBinaryImage& im )
+{
+	MD5_CTX ctx;
+	MD5_Init( &ctx );
+	
+	const int desc[8] = { opts.textureType, opts.format, opts.colorFormat, opts.width, opts.height, opts.numLevels, filter, repeat };
+	MD5_Update( &ctx, ( const unsigned char* )desc, sizeof( desc ) );
+	
+	for( int i = 0; i < im.NumImages(); i++ )
+	{
+		const bimageImage_t& img = im.GetImageHeader( i );
+		const int imgDesc[5] = { img.level, img.destZ, img.width, img.height, img.dataSize };
+		MD5_Update( &ctx, ( const unsigned char* )imgDesc, sizeof( imgDesc ) );
+		MD5_Update( &ctx, im.GetImageData( i ), img.dataSize );
+	}
+	
+	MD5_Final( &ctx, contentDigest );
+}
+
+/*
+===============
+idImage::ContentKey
+===============
+*/
+int idImage::ContentKey() const
+{
+	int key;
+	memcpy( &key, contentDigest, sizeof( key ) );
+	return key;
+}
+
+/*
+===============
+idImage::ContentMatches
+===============
+*/
+bool idImage::ContentMatches( const idImage* other ) const
+{
+	if( memcmp( contentDigest, other->contentDigest, sizeof( contentDigest ) ) != 0 )
+	{
+		return false;
+	}
+	
+	// the digest covers these as well, but a collision must never alias incompatible textures
+	return ( filter == other->filter && repeat == other->repeat
+			 && opts.textureType == other->opts.textureType
+			 && opts.format == other->opts.format
+			 && opts.colorFormat == other->opts.colorFormat
+			 && opts.width == other->opts.width
+			 && opts.height == other->opts.height
+			 && opts.numLevels == other->opts.numLevels );
+}
+
+/*
+===============
+idImage::ShareContentWith
+
+Drops our own texture and binds to the storage of owner instead.
+===============
+*/
+bool idImage::ShareContentWith( idImage* owner )
+{
+	if( owner == this || owner->sharedImage != NULL || !owner->IsLoaded() )
+	{
+		return false;
+	}
+	
+	PurgeImage();
+	
+	texnum = owner->texnum;
+	internalFormat = owner->internalFormat;
+	dataFormat = owner->dataFormat;
+	dataType = owner->dataType;
+	
+	sharedImage = owner;
+	owner->numSharedRefs++;
+	contentValid = true;
+	
+	return true;
+}
+
+/*
+===============
+idImage::ReleaseSharedStorage
+
+Called by PurgeImage before the texture object is deleted. Images that only borrow
+their storage just forget it, owners hand it over to one of their users so the
+texture stays alive.
+===============
+*/
+void idImage::ReleaseSharedStorage()
+{
+	if( sharedImage != NULL )
+	{
+		sharedImage->numSharedRefs--;
+		sharedImage = NULL;
+		texnum = TEXTURE_NOT_LOADED;
+	}
+	else if( numSharedRefs > 0 )
+	{
+		globalImages->TransferSharedImages( this );
+		texnum = TEXTURE_NOT_LOADED;
+	}
+	
+	contentValid = false;
 }
 
 /*
@@ -596,6 +732,11 @@ void idImage::Bind()
 		ActuallyLoadImage( true );
 	}
 	
+	if( r_nullRenderer.GetBool() )
+	{
+		return;
+	}
+	
 	const int texUnit = backEnd.glState.currenttmu;
 	
 	// RB: added support for more types
@@ -701,6 +842,11 @@ CopyFramebuffer
 */
 void idImage::CopyFramebuffer( int x, int y, int imageWidth, int imageHeight )
 {
+	if( r_nullRenderer.GetBool() )
+	{
+		return;
+	}
+	
 	int target = GL_TEXTURE_2D;
 	switch( opts.textureType )
 	{
@@ -786,6 +932,11 @@ CopyDepthbuffer
 */
 void idImage::CopyDepthbuffer( int x, int y, int imageWidth, int imageHeight )
 {
+	if( r_nullRenderer.GetBool() )
+	{
+		return;
+	}
+	
 	glBindTexture( ( opts.textureType == TT_CUBIC ) ? GL_TEXTURE_CUBE_MAP : GL_TEXTURE_2D, texnum );
 	
 	opts.width = imageWidth;
@@ -885,6 +1036,10 @@ void idImage::Print() const
 	{
 		common->Printf( "F" );
 	}
+	else if( sharedImage != NULL )
+	{
+		common->Printf( "S" );
+	}
 	else
 	{
 		common->Printf( " " );
@@ -1040,6 +1195,10 @@ void idImage::SetSamplerState( textureFilter_t tf, textureRepeat_t tr )
 	}
 	filter = tf;
 	repeat = tr;
+	if( r_nullRenderer.GetBool() )
+	{
+		return;
+	}
 	glBindTexture( ( opts.textureType == TT_CUBIC ) ? GL_TEXTURE_CUBE_MAP : GL_TEXTURE_2D, texnum );
 	SetTexParameters();
 }
@@ -69,6 +69,7 @@ typedef struct mtrParsingData_s
 	shaderStage_t	parseStages[MAX_SHADER_STAGES];
 	
 	bool			registersAreConstant;
+	int				registerDependencies;		// expDependency_t bits
 	bool			forceOverlays;
 } mtrParsingData_t;
 
@@ -96,6 +97,7 @@ void idMaterial::CommonInit()
 	numRegisters = 0;
 	expressionRegisters = NULL;
 	constantRegisters = NULL;
+	registerDependencies = EXP_DEPEND_NONE;
 	numStages = 0;
 	numAmbientStages = 0;
 	stages = NULL;
@@ -640,106 +642,127 @@ int idMaterial::ParseTerm( idLexer& src )
 	if( !token.Icmp( "time" ) )
 	{
 		pd->registersAreConstant = false;
+		pd->registerDependencies |= EXP_DEPEND_TIME;
 		return EXP_REG_TIME;
 	}
 	if( !token.Icmp( "parm0" ) )
 	{
 		pd->registersAreConstant = false;
+		pd->registerDependencies |= EXP_DEPEND_ENTITY;
 		return EXP_REG_PARM0;
 	}
 	if( !token.Icmp( "parm1" ) )
 	{
 		pd->registersAreConstant = false;
+		pd->registerDependencies |= EXP_DEPEND_ENTITY;
 		return EXP_REG_PARM1;
 	}
 	if( !token.Icmp( "parm2" ) )
 	{
 		pd->registersAreConstant = false;
+		pd->registerDependencies |= EXP_DEPEND_ENTITY;
 		return EXP_REG_PARM2;
 	}
 	if( !token.Icmp( "parm3" ) )
 	{
 		pd->registersAreConstant = false;
+		pd->registerDependencies |= EXP_DEPEND_ENTITY;
 		return EXP_REG_PARM3;
 	}
 	if( !token.Icmp( "parm4" ) )
 	{
 		pd->registersAreConstant = false;
+		pd->registerDependencies |= EXP_DEPEND_ENTITY;
 		return EXP_REG_PARM4;
 	}
 	if( !token.Icmp( "parm5" ) )
 	{
 		pd->registersAreConstant = false;
+		pd->registerDependencies |= EXP_DEPEND_ENTITY;
 		return EXP_REG_PARM5;
 	}
 	if( !token.Icmp( "parm6" ) )
 	{
 		pd->registersAreConstant = false;
+		pd->registerDependencies |= EXP_DEPEND_ENTITY;
 		return EXP_REG_PARM6;
 	}
 	if( !token.Icmp( "parm7" ) )
 	{
 		pd->registersAreConstant = false;
+		pd->registerDependencies |= EXP_DEPEND_ENTITY;
 		return EXP_REG_PARM7;
 	}
 	if( !token.Icmp( "parm8" ) )
 	{
 		pd->registersAreConstant = false;
+		pd->registerDependencies |= EXP_DEPEND_ENTITY;
 		return EXP_REG_PARM8;
 	}
 	if( !token.Icmp( "parm9" ) )
 	{
 		pd->registersAreConstant = false;
+		pd->registerDependencies |= EXP_DEPEND_ENTITY;
 		return EXP_REG_PARM9;
 	}
 	if( !token.Icmp( "parm10" ) )
 	{
 		pd->registersAreConstant = false;
+		pd->registerDependencies |= EXP_DEPEND_ENTITY;
 		return EXP_REG_PARM10;
 	}
 	if( !token.Icmp( "parm11" ) )
 	{
 		pd->registersAreConstant = false;
+		pd->registerDependencies |= EXP_DEPEND_ENTITY;
 		return EXP_REG_PARM11;
 	}
 	if( !token.Icmp( "global0" ) )
 	{
 		pd->registersAreConstant = false;
+		pd->registerDependencies |= EXP_DEPEND_GLOBAL;
 		return EXP_REG_GLOBAL0;
 	}
 	if( !token.Icmp( "global1" ) )
 	{
 		pd->registersAreConstant = false;
+		pd->registerDependencies |= EXP_DEPEND_GLOBAL;
 		return EXP_REG_GLOBAL1;
 	}
 	if( !token.Icmp( "global2" ) )
 	{
 		pd->registersAreConstant = false;
+		pd->registerDependencies |= EXP_DEPEND_GLOBAL;
 		return EXP_REG_GLOBAL2;
 	}
 	if( !token.Icmp( "global3" ) )
 	{
 		pd->registersAreConstant = false;
+		pd->registerDependencies |= EXP_DEPEND_GLOBAL;
 		return EXP_REG_GLOBAL3;
 	}
 	if( !token.Icmp( "global4" ) )
 	{
 		pd->registersAreConstant = false;
+		pd->registerDependencies |= EXP_DEPEND_GLOBAL;
 		return EXP_REG_GLOBAL4;
 	}
 	if( !token.Icmp( "global5" ) )
 	{
 		pd->registersAreConstant = false;
+		pd->registerDependencies |= EXP_DEPEND_GLOBAL;
 		return EXP_REG_GLOBAL5;
 	}
 	if( !token.Icmp( "global6" ) )
 	{
 		pd->registersAreConstant = false;
+		pd->registerDependencies |= EXP_DEPEND_GLOBAL;
 		return EXP_REG_GLOBAL6;
 	}
 	if( !token.Icmp( "global7" ) )
 	{
 		pd->registersAreConstant = false;
+		pd->registerDependencies |= EXP_DEPEND_GLOBAL;
 		return EXP_REG_GLOBAL7;
 	}
 	if( !token.Icmp( "fragmentPrograms" ) )
@@ -750,6 +773,7 @@ int idMaterial::ParseTerm( idLexer& src )
 	if( !token.Icmp( "sound" ) )
 	{
 		pd->registersAreConstant = false;
+		pd->registerDependencies |= EXP_DEPEND_SOUND;
 		return EmitOp( 0, 0, OP_TYPE_SOUND );
 	}
 	
@@ -1771,6 +1795,7 @@ void idMaterial::ParseStage( idLexer& src, const textureRepeat_t trpDefault )
 			ss->color.registers[2] = EXP_REG_PARM2;
 			ss->color.registers[3] = EXP_REG_PARM3;
 			pd->registersAreConstant = false;
+			pd->registerDependencies |= EXP_DEPEND_ENTITY;
 			continue;
 		}
 		
@@ -2207,6 +2232,7 @@ void idMaterial::ParseMaterial( idLexer& src )
 	
 	numStages = 0;
 	pd->registersAreConstant = true;			// until shown otherwise
+	pd->registerDependencies = EXP_DEPEND_NONE;
 	textureRepeat_t	trpDefault = TR_REPEAT;		// allow a global setting for repeat
 	
 	while( 1 )
@@ -2847,6 +2873,10 @@ bool idMaterial::Parse( const char* text, const int textLength, bool allowBinary
 		memcpy( stages, pd->parseStages, numStages * sizeof( stages[0] ) );
 	}
 	
+	// evaluate everything that only depends on constants now instead of per surface
+	FoldConstantOps();
+	registerDependencies = pd->registerDependencies;
+	
 	if( numOps )
 	{
 		ops = ( expOp_t* )R_StaticAlloc( numOps * sizeof( ops[0] ), TAG_MATERIAL );
@@ -2953,6 +2983,66 @@ void idMaterial::AddReference()
 	}
 }
 
+/*
+===============
+R_EvaluateExpressionOp
+===============
+*/
+static ID_INLINE float R_EvaluateExpressionOp( const expOp_t* op, const float* registers, idSoundEmitter* soundEmitter )
+{
+	int b;
+	
+	switch( op->opType )
+	{
+		case OP_TYPE_ADD:
+			return registers[op->a] + registers[op->b];
+		case OP_TYPE_SUBTRACT:
+			return registers[op->a] - registers[op->b];
+		case OP_TYPE_MULTIPLY:
+			return registers[op->a] * registers[op->b];
+		case OP_TYPE_DIVIDE:
+			return registers[op->a] / registers[op->b];
+		case OP_TYPE_MOD:
+			b = ( int )registers[op->b];
+			b = b != 0 ? b : 1;
+			return ( int )registers[op->a] % b;
+		case OP_TYPE_TABLE:
+		{
+			const idDeclTable* table = static_cast<const idDeclTable*>( declManager->DeclByIndex( DECL_TABLE, op->a ) );
+			return table->TableLookup( registers[op->b] );
+		}
+		case OP_TYPE_SOUND:
+			if( r_forceSoundOpAmplitude.GetFloat() > 0 )
+			{
+				return r_forceSoundOpAmplitude.GetFloat();
+			}
+			else if( soundEmitter )
+			{
+				return soundEmitter->CurrentAmplitude();
+			}
+			return 0;
+		case OP_TYPE_GT:
+			return registers[ op->a ] > registers[op->b];
+		case OP_TYPE_GE:
+			return registers[ op->a ] >= registers[op->b];
+		case OP_TYPE_LT:
+			return registers[ op->a ] < registers[op->b];
+		case OP_TYPE_LE:
+			return registers[ op->a ] <= registers[op->b];
+		case OP_TYPE_EQ:
+			return registers[ op->a ] == registers[op->b];
+		case OP_TYPE_NE:
+			return registers[ op->a ] != registers[op->b];
+		case OP_TYPE_AND:
+			return registers[ op->a ] && registers[op->b];
+		case OP_TYPE_OR:
+			return registers[ op->a ] || registers[op->b];
+		default:
+			common->FatalError( "R_EvaluateExpressionOp: bad opcode" );
+	}
+	return 0;
+}
+
 /*
 ===============
 idMaterial::EvaluateRegisters
@@ -2969,110 +3059,22 @@ void idMaterial::EvaluateRegisters(
 	const float		floatTime,
 	idSoundEmitter* soundEmitter ) const
 {
-
-	int		i, b;
-	expOp_t*	op;
-	
-	// copy the material constants
-	for( i = EXP_REG_NUM_PREDEFINED ; i < numRegisters ; i++ )
+	// copy the material constants, including the results of folded ops
+	if( numRegisters > EXP_REG_NUM_PREDEFINED )
 	{
-		registers[i] = expressionRegisters[i];
+		memcpy( registers + EXP_REG_NUM_PREDEFINED, expressionRegisters + EXP_REG_NUM_PREDEFINED, ( numRegisters - EXP_REG_NUM_PREDEFINED ) * sizeof( float ) );
 	}
 	
 	// copy the local and global parameters
 	registers[EXP_REG_TIME] = floatTime;
-	registers[EXP_REG_PARM0] = localShaderParms[0];
-	registers[EXP_REG_PARM1] = localShaderParms[1];
-	registers[EXP_REG_PARM2] = localShaderParms[2];
-	registers[EXP_REG_PARM3] = localShaderParms[3];
-	registers[EXP_REG_PARM4] = localShaderParms[4];
-	registers[EXP_REG_PARM5] = localShaderParms[5];
-	registers[EXP_REG_PARM6] = localShaderParms[6];
-	registers[EXP_REG_PARM7] = localShaderParms[7];
-	registers[EXP_REG_PARM8] = localShaderParms[8];
-	registers[EXP_REG_PARM9] = localShaderParms[9];
-	registers[EXP_REG_PARM10] = localShaderParms[10];
-	registers[EXP_REG_PARM11] = localShaderParms[11];
-	registers[EXP_REG_GLOBAL0] = globalShaderParms[0];
-	registers[EXP_REG_GLOBAL1] = globalShaderParms[1];
-	registers[EXP_REG_GLOBAL2] = globalShaderParms[2];
-	registers[EXP_REG_GLOBAL3] = globalShaderParms[3];
-	registers[EXP_REG_GLOBAL4] = globalShaderParms[4];
-	registers[EXP_REG_GLOBAL5] = globalShaderParms[5];
-	registers[EXP_REG_GLOBAL6] = globalShaderParms[6];
-	registers[EXP_REG_GLOBAL7] = globalShaderParms[7];
-	
-	op = ops;
-	for( i = 0 ; i < numOps ; i++, op++ )
-	{
-		switch( op->opType )
-		{
-			case OP_TYPE_ADD:
-				registers[op->c] = registers[op->a] + registers[op->b];
-				break;
-			case OP_TYPE_SUBTRACT:
-				registers[op->c] = registers[op->a] - registers[op->b];
-				break;
-			case OP_TYPE_MULTIPLY:
-				registers[op->c] = registers[op->a] * registers[op->b];
-				break;
-			case OP_TYPE_DIVIDE:
-				registers[op->c] = registers[op->a] / registers[op->b];
-				break;
-			case OP_TYPE_MOD:
-				b = ( int )registers[op->b];
-				b = b != 0 ? b : 1;
-				registers[op->c] = ( int )registers[op->a] % b;
-				break;
-			case OP_TYPE_TABLE:
-			{
-				const idDeclTable* table = static_cast<const idDeclTable*>( declManager->DeclByIndex( DECL_TABLE, op->a ) );
-				registers[op->c] = table->TableLookup( registers[op->b] );
-			}
-			break;
-			case OP_TYPE_SOUND:
-				if( r_forceSoundOpAmplitude.GetFloat() > 0 )
-				{
-					registers[op->c] = r_forceSoundOpAmplitude.GetFloat();
-				}
-				else if( soundEmitter )
-				{
-					registers[op->c] = soundEmitter->CurrentAmplitude();
-				}
-				else
-				{
-					registers[op->c] = 0;
-				}
-				break;
-			case OP_TYPE_GT:
-				registers[op->c] = registers[ op->a ] > registers[op->b];
-				break;
-			case OP_TYPE_GE:
-				registers[op->c] = registers[ op->a ] >= registers[op->b];
-				break;
-			case OP_TYPE_LT:
-				registers[op->c] = registers[ op->a ] < registers[op->b];
-				break;
-			case OP_TYPE_LE:
-				registers[op->c] = registers[ op->a ] <= registers[op->b];
-				break;
-			case OP_TYPE_EQ:
-				registers[op->c] = registers[ op->a ] == registers[op->b];
-				break;
-			case OP_TYPE_NE:
-				registers[op->c] = registers[ op->a ] != registers[op->b];
-				break;
-			case OP_TYPE_AND:
-				registers[op->c] = registers[ op->a ] && registers[op->b];
-				break;
-			case OP_TYPE_OR:
-				registers[op->c] = registers[ op->a ] || registers[op->b];
-				break;
-			default:
-				common->FatalError( "R_EvaluateExpression: bad opcode" );
-		}
-	}
+	memcpy( registers + EXP_REG_PARM0, localShaderParms, ( EXP_REG_GLOBAL0 - EXP_REG_PARM0 ) * sizeof( float ) );
+	memcpy( registers + EXP_REG_GLOBAL0, globalShaderParms, ( EXP_REG_NUM_PREDEFINED - EXP_REG_GLOBAL0 ) * sizeof( float ) );
 	
+	const expOp_t* op = ops;
+	for( int i = 0 ; i < numOps ; i++, op++ )
+	{
+		registers[op->c] = R_EvaluateExpressionOp( op, registers, soundEmitter );
+	}
 }
 
 /*
@@ -3236,6 +3238,55 @@ void idMaterial::CheckForConstantRegisters()
 	EvaluateRegisters( constantRegisters, shaderParms, viewDef.renderView.shaderParms, 0.0f, 0 );
 }
 
+/*
+==================
+idMaterial::FoldConstantOps
+
+EmitOp only folds additions and multiplications while parsing. Now that the
+whole material is known, every op whose operands are all constant is evaluated
+into its temporary register, which EvaluateRegisters copies with the constants,
+and dropped from the op list, leaving only the ops that depend on time, parms
+or sound.
+==================
+*/
+void idMaterial::FoldConstantOps()
+{
+	bool registerIsConstant[MAX_EXPRESSION_REGISTERS];
+	for( int i = 0; i < numRegisters; i++ )
+	{
+		registerIsConstant[i] = !pd->registerIsTemporary[i];
+	}
+	
+	int numKept = 0;
+	for( int i = 0; i < numOps; i++ )
+	{
+		const expOp_t& op = pd->shaderOps[i];
+		
+		bool constant;
+		if( op.opType == OP_TYPE_SOUND )
+		{
+			constant = false;
+		}
+		else if( op.opType == OP_TYPE_TABLE )
+		{
+			constant = registerIsConstant[op.b];
+		}
+		else
+		{
+			constant = registerIsConstant[op.a] && registerIsConstant[op.b];
+		}
+		
+		if( constant )
+		{
+			pd->shaderRegisters[op.c] = R_EvaluateExpressionOp( &op, pd->shaderRegisters, NULL );
+			registerIsConstant[op.c] = true;
+			continue;
+		}
+		pd->shaderOps[numKept++] = op;
+	}
+	numOps = numKept;
+}
+
 /*
 ===================
 idMaterial::ImageName
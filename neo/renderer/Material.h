@@ -147,6 +147,16 @@ typedef struct
 	int				a, b, c;
 } expOp_t;
 
+// which per surface inputs the registers of a material are derived from
+typedef enum
+{
+	EXP_DEPEND_NONE		= 0,
+	EXP_DEPEND_TIME		= BIT( 0 ),
+	EXP_DEPEND_ENTITY	= BIT( 1 ),		// entity shaderParms
+	EXP_DEPEND_GLOBAL	= BIT( 2 ),		// renderView shaderParms
+	EXP_DEPEND_SOUND	= BIT( 3 )		// sound emitter amplitude
+} expDependency_t;
+
 typedef struct
 {
 	int				registers[4];
@@ -788,6 +798,12 @@ public:
 		return constantRegisters;
 	};
 	
+	// expDependency_t bits for the inputs EvaluateRegisters reads
+	int					GetRegisterDependencies() const
+	{
+		return registerDependencies;
+	}
+	
 	bool				SuppressInSubview() const
 	{
 		return suppressInSubview;
@@ -845,6 +861,7 @@ private:
 	void				MultiplyTextureMatrix( textureStage_t* ts, int registers[2][3] );	// FIXME: for some reason the const is bad for gcc and Mac
 	void				SortInteractionStages();
 	void				AddImplicitStages( const textureRepeat_t trpDefault = TR_REPEAT );
+	void				FoldConstantOps();
 	void				CheckForConstantRegisters();
 	void				SetFastPathImages();
 	
@@ -901,6 +918,7 @@ private:
 	float* 				expressionRegisters;
 	
 	float* 				constantRegisters;	// NULL if ops ever reference globalParms or entityParms
+	int					registerDependencies;	// expDependency_t bits
 	
 	int					numStages;
 	int					numAmbientStages;
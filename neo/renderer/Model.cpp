@@ -43,8 +43,9 @@ idCVar idRenderModelStatic::r_mergeModelSurfaces( "r_mergeModelSurfaces", "1", C
 idCVar idRenderModelStatic::r_slopVertex( "r_slopVertex", "0.01", CVAR_RENDERER, "merge xyz coordinates this far apart" );
 idCVar idRenderModelStatic::r_slopTexCoord( "r_slopTexCoord", "0.001", CVAR_RENDERER, "merge texture coordinates this far apart" );
 idCVar idRenderModelStatic::r_slopNormal( "r_slopNormal", "0.02", CVAR_RENDERER, "merge normals that dot less than this" );
+idCVar r_useParallelFinishSurfaces( "r_useParallelFinishSurfaces", "1", CVAR_RENDERER | CVAR_BOOL, "clean up the surfaces of a model in parallel with jobs" );
 
-static const byte BRM_VERSION = 108;
+static const byte BRM_VERSION = 109;
 static const unsigned int BRM_MAGIC = ( 'B' << 24 ) | ( 'R' << 16 ) | ( 'M' << 8 ) | BRM_VERSION;
 
 /*
@@ -121,6 +122,12 @@ void idRenderModelStatic::Print() const
 			common->Printf( "\n" );
 		}
 	}
+	
+	for( int i = 0; i < lodSurfaces.Num(); i++ )
+	{
+		const modelSurfaceLOD_t& lod = lodSurfaces[i];
+		common->Printf( "%2i: %5i %5i lod, error %.2f\n", lod.surfaceNum, lod.geometry->numVerts, lod.geometry->numIndexes / 3, lod.maxError );
+	}
 }
 
 /*
@@ -146,6 +153,12 @@ int idRenderModelStatic::Memory() const
 		totalBytes += R_TriSurfMemory( surf->geometry );
 	}
 	
+	totalBytes += lodSurfaces.MemoryUsed();
+	for( int j = 0; j < lodSurfaces.Num(); j++ )
+	{
+		totalBytes += R_TriSurfMemory( lodSurfaces[j].geometry );
+	}
+	
 	return totalBytes;
 }
 
@@ -353,6 +366,251 @@ void idRenderModelStatic::InitFromFile( const char* fileName )
 	
 	// create the bounds for culling and dynamic surface creation
 	FinishSurfaces();
+	
+	// build simplified versions of the cleaned surfaces for distant views
+	GenerateSurfaceLODs();
+}
+
+/*
+========================
+idRenderModelStatic::ReadBinaryTriSurf
+========================
+*/
+void idRenderModelStatic::ReadBinaryTriSurf( idFile* file, srfTriangles_t& tri )
+{
+	bool temp;
+	
+	file->ReadVec3( tri.bounds[0] );
+	file->ReadVec3( tri.bounds[1] );
+	
+	int ambientViewCount = 0;	// FIXME: remove
+	file->ReadBig( ambientViewCount );
+	file->ReadBig( tri.generateNormals );
+	file->ReadBig( tri.tangentsCalculated );
+	file->ReadBig( tri.perfectHull );
+	file->ReadBig( tri.referencedIndexes );
+	
+	file->ReadBig( tri.numVerts );
+	tri.verts = NULL;
+	int numInFile = 0;
+	file->ReadBig( numInFile );
+	if( numInFile > 0 )
+	{
+		R_AllocStaticTriSurfVerts( &tri, tri.numVerts );
+		assert( tri.verts != NULL );
+		for( int j = 0; j < tri.numVerts; j++ )
+		{
+			file->ReadVec3( tri.verts[j].xyz );
+			file->ReadBigArray( tri.verts[j].st, 2 );
+			file->ReadBigArray( tri.verts[j].normal, 4 );
+			file->ReadBigArray( tri.verts[j].tangent, 4 );
+			file->ReadBigArray( tri.verts[j].color, sizeof( tri.verts[j].color ) / sizeof( tri.verts[j].color[0] ) );
+			file->ReadBigArray( tri.verts[j].color2, sizeof( tri.verts[j].color2 ) / sizeof( tri.verts[j].color2[0] ) );
+		}
+	}
+	
+	file->ReadBig( numInFile );
+	if( numInFile == 0 )
+	{
+		tri.preLightShadowVertexes = NULL;
+	}
+	else
+	{
+		R_AllocStaticTriSurfPreLightShadowVerts( &tri, numInFile );
+		for( int j = 0; j < numInFile; j++ )
+		{
+			file->ReadVec4( tri.preLightShadowVertexes[ j ].xyzw );
+		}
+	}
+	
+	file->ReadBig( tri.numIndexes );
+	tri.indexes = NULL;
+	tri.silIndexes = NULL;
+	if( tri.numIndexes > 0 )
+	{
+		R_AllocStaticTriSurfIndexes( &tri, tri.numIndexes );
+		file->ReadBigArray( tri.indexes, tri.numIndexes );
+	}
+	file->ReadBig( numInFile );
+	if( numInFile > 0 )
+	{
+		R_AllocStaticTriSurfSilIndexes( &tri, tri.numIndexes );
+		file->ReadBigArray( tri.silIndexes, tri.numIndexes );
+	}
+	
+	file->ReadBig( tri.numMirroredVerts );
+	tri.mirroredVerts = NULL;
+	if( tri.numMirroredVerts > 0 )
+	{
+		R_AllocStaticTriSurfMirroredVerts( &tri, tri.numMirroredVerts );
+		file->ReadBigArray( tri.mirroredVerts, tri.numMirroredVerts );
+	}
+	
+	file->ReadBig( tri.numDupVerts );
+	tri.dupVerts = NULL;
+	if( tri.numDupVerts > 0 )
+	{
+		R_AllocStaticTriSurfDupVerts( &tri, tri.numDupVerts );
+		file->ReadBigArray( tri.dupVerts, tri.numDupVerts * 2 );
+	}
+	
+	file->ReadBig( tri.numSilEdges );
+	tri.silEdges = NULL;
+	if( tri.numSilEdges > 0 )
+	{
+		R_AllocStaticTriSurfSilEdges( &tri, tri.numSilEdges );
+		assert( tri.silEdges != NULL );
+		for( int j = 0; j < tri.numSilEdges; j++ )
+		{
+			file->ReadBig( tri.silEdges[j].p1 );
+			file->ReadBig( tri.silEdges[j].p2 );
+			file->ReadBig( tri.silEdges[j].v1 );
+			file->ReadBig( tri.silEdges[j].v2 );
+		}
+	}
+	
+	file->ReadBig( temp );
+	tri.dominantTris = NULL;
+	if( temp )
+	{
+		R_AllocStaticTriSurfDominantTris( &tri, tri.numVerts );
+		assert( tri.dominantTris != NULL );
+		for( int j = 0; j < tri.numVerts; j++ )
+		{
+			file->ReadBig( tri.dominantTris[j].v2 );
+			file->ReadBig( tri.dominantTris[j].v3 );
+			file->ReadFloat( tri.dominantTris[j].normalizationScale[0] );
+			file->ReadFloat( tri.dominantTris[j].normalizationScale[1] );
+			file->ReadFloat( tri.dominantTris[j].normalizationScale[2] );
+		}
+	}
+	
+	file->ReadBig( tri.numShadowIndexesNoFrontCaps );
+	file->ReadBig( tri.numShadowIndexesNoCaps );
+	file->ReadBig( tri.shadowCapPlaneBits );
+	
+	tri.ambientSurface = NULL;
+	tri.nextDeferredFree = NULL;
+	tri.indexCache = 0;
+	tri.ambientCache = 0;
+	tri.shadowCache = 0;
+}
+
+/*
+========================
+idRenderModelStatic::WriteBinaryTriSurf
+========================
+*/
+void idRenderModelStatic::WriteBinaryTriSurf( idFile* file, const srfTriangles_t& tri )
+{
+	file->WriteVec3( tri.bounds[0] );
+	file->WriteVec3( tri.bounds[1] );
+	
+	int ambientViewCount = 0;	// FIXME: remove
+	file->WriteBig( ambientViewCount );
+	file->WriteBig( tri.generateNormals );
+	file->WriteBig( tri.tangentsCalculated );
+	file->WriteBig( tri.perfectHull );
+	file->WriteBig( tri.referencedIndexes );
+	
+	// shadow models use numVerts but have no verts
+	file->WriteBig( tri.numVerts );
+	if( tri.verts != NULL )
+	{
+		file->WriteBig( tri.numVerts );
+	}
+	else
+	{
+		file->WriteBig( ( int ) 0 );
+	}
+	
+	if( tri.numVerts > 0 && tri.verts != NULL )
+	{
+		for( int j = 0; j < tri.numVerts; j++ )
+		{
+			file->WriteVec3( tri.verts[j].xyz );
+			file->WriteBigArray( tri.verts[j].st, 2 );
+			file->WriteBigArray( tri.verts[j].normal, 4 );
+			file->WriteBigArray( tri.verts[j].tangent, 4 );
+			file->WriteBigArray( tri.verts[j].color, sizeof( tri.verts[j].color ) / sizeof( tri.verts[j].color[0] ) );
+			file->WriteBigArray( tri.verts[j].color2, sizeof( tri.verts[j].color2 ) / sizeof( tri.verts[j].color2[0] ) );
+		}
+	}
+	
+	if( tri.preLightShadowVertexes != NULL )
+	{
+		file->WriteBig( tri.numVerts * 2 );
+		for( int j = 0; j < tri.numVerts * 2; j++ )
+		{
+			file->WriteVec4( tri.preLightShadowVertexes[ j ].xyzw );
+		}
+	}
+	else
+	{
+		file->WriteBig( ( int ) 0 );
+	}
+	
+	file->WriteBig( tri.numIndexes );
+	
+	if( tri.numIndexes > 0 )
+	{
+		file->WriteBigArray( tri.indexes, tri.numIndexes );
+	}
+	
+	if( tri.silIndexes != NULL )
+	{
+		file->WriteBig( tri.numIndexes );
+	}
+	else
+	{
+		file->WriteBig( ( int ) 0 );
+	}
+	
+	if( tri.numIndexes > 0 && tri.silIndexes != NULL )
+	{
+		file->WriteBigArray( tri.silIndexes, tri.numIndexes );
+	}
+	
+	file->WriteBig( tri.numMirroredVerts );
+	if( tri.numMirroredVerts > 0 )
+	{
+		file->WriteBigArray( tri.mirroredVerts, tri.numMirroredVerts );
+	}
+	
+	file->WriteBig( tri.numDupVerts );
+	if( tri.numDupVerts > 0 )
+	{
+		file->WriteBigArray( tri.dupVerts, tri.numDupVerts * 2 );
+	}
+	
+	file->WriteBig( tri.numSilEdges );
+	if( tri.numSilEdges > 0 )
+	{
+		for( int j = 0; j < tri.numSilEdges; j++ )
+		{
+			file->WriteBig( tri.silEdges[j].p1 );
+			file->WriteBig( tri.silEdges[j].p2 );
+			file->WriteBig( tri.silEdges[j].v1 );
+			file->WriteBig( tri.silEdges[j].v2 );
+		}
+	}
+	
+	file->WriteBig( tri.dominantTris != NULL );
+	if( tri.dominantTris != NULL )
+	{
+		for( int j = 0; j < tri.numVerts; j++ )
+		{
+			file->WriteBig( tri.dominantTris[j].v2 );
+			file->WriteBig( tri.dominantTris[j].v3 );
+			file->WriteFloat( tri.dominantTris[j].normalizationScale[0] );
+			file->WriteFloat( tri.dominantTris[j].normalizationScale[1] );
+			file->WriteFloat( tri.dominantTris[j].normalizationScale[2] );
+		}
+	}
+	
+	file->WriteBig( tri.numShadowIndexesNoFrontCaps );
+	file->WriteBig( tri.numShadowIndexesNoCaps );
+	file->WriteBig( tri.shadowCapPlaneBits );
 }
 
 /*
@@ -407,127 +665,8 @@ bool idRenderModelStatic::LoadBinaryModel( idFile* file, const ID_TIME_T sourceT
 		surfaces[i].geometry = NULL;
 		if( isGeometry )
 		{
-			bool temp;
-			
 			surfaces[i].geometry = R_AllocStaticTriSurf();
-			
-			// Read the contents of srfTriangles_t
-			srfTriangles_t& tri = *surfaces[i].geometry;
-			
-			file->ReadVec3( tri.bounds[0] );
-			file->ReadVec3( tri.bounds[1] );
-			
-			int ambientViewCount = 0;	// FIXME: remove
-			file->ReadBig( ambientViewCount );
-			file->ReadBig( tri.generateNormals );
-			file->ReadBig( tri.tangentsCalculated );
-			file->ReadBig( tri.perfectHull );
-			file->ReadBig( tri.referencedIndexes );
-			
-			file->ReadBig( tri.numVerts );
-			tri.verts = NULL;
-			int numInFile = 0;
-			file->ReadBig( numInFile );
-			if( numInFile > 0 )
-			{
-				R_AllocStaticTriSurfVerts( &tri, tri.numVerts );
-				assert( tri.verts != NULL );
-				for( int j = 0; j < tri.numVerts; j++ )
-				{
-					file->ReadVec3( tri.verts[j].xyz );
-					file->ReadBigArray( tri.verts[j].st, 2 );
-					file->ReadBigArray( tri.verts[j].normal, 4 );
-					file->ReadBigArray( tri.verts[j].tangent, 4 );
-					file->ReadBigArray( tri.verts[j].color, sizeof( tri.verts[j].color ) / sizeof( tri.verts[j].color[0] ) );
-					file->ReadBigArray( tri.verts[j].color2, sizeof( tri.verts[j].color2 ) / sizeof( tri.verts[j].color2[0] ) );
-				}
-			}
-			
-			file->ReadBig( numInFile );
-			if( numInFile == 0 )
-			{
-				tri.preLightShadowVertexes = NULL;
-			}
-			else
-			{
-				R_AllocStaticTriSurfPreLightShadowVerts( &tri, numInFile );
-				for( int j = 0; j < numInFile; j++ )
-				{
-					file->ReadVec4( tri.preLightShadowVertexes[ j ].xyzw );
-				}
-			}
-			
-			file->ReadBig( tri.numIndexes );
-			tri.indexes = NULL;
-			tri.silIndexes = NULL;
-			if( tri.numIndexes > 0 )
-			{
-				R_AllocStaticTriSurfIndexes( &tri, tri.numIndexes );
-				file->ReadBigArray( tri.indexes, tri.numIndexes );
-			}
-			file->ReadBig( numInFile );
-			if( numInFile > 0 )
-			{
-				R_AllocStaticTriSurfSilIndexes( &tri, tri.numIndexes );
-				file->ReadBigArray( tri.silIndexes, tri.numIndexes );
-			}
-			
-			file->ReadBig( tri.numMirroredVerts );
-			tri.mirroredVerts = NULL;
-			if( tri.numMirroredVerts > 0 )
-			{
-				R_AllocStaticTriSurfMirroredVerts( &tri, tri.numMirroredVerts );
-				file->ReadBigArray( tri.mirroredVerts, tri.numMirroredVerts );
-			}
-			
-			file->ReadBig( tri.numDupVerts );
-			tri.dupVerts = NULL;
-			if( tri.numDupVerts > 0 )
-			{
-				R_AllocStaticTriSurfDupVerts( &tri, tri.numDupVerts );
-				file->ReadBigArray( tri.dupVerts, tri.numDupVerts * 2 );
-			}
-			
-			file->ReadBig( tri.numSilEdges );
-			tri.silEdges = NULL;
-			if( tri.numSilEdges > 0 )
-			{
-				R_AllocStaticTriSurfSilEdges( &tri, tri.numSilEdges );
-				assert( tri.silEdges != NULL );
-				for( int j = 0; j < tri.numSilEdges; j++ )
-				{
-					file->ReadBig( tri.silEdges[j].p1 );
-					file->ReadBig( tri.silEdges[j].p2 );
-					file->ReadBig( tri.silEdges[j].v1 );
-					file->ReadBig( tri.silEdges[j].v2 );
-				}
-			}
-			
-			file->ReadBig( temp );
-			tri.dominantTris = NULL;
-			if( temp )
-			{
-				R_AllocStaticTriSurfDominantTris( &tri, tri.numVerts );
-				assert( tri.dominantTris != NULL );
-				for( int j = 0; j < tri.numVerts; j++ )
-				{
-					file->ReadBig( tri.dominantTris[j].v2 );
-					file->ReadBig( tri.dominantTris[j].v3 );
-					file->ReadFloat( tri.dominantTris[j].normalizationScale[0] );
-					file->ReadFloat( tri.dominantTris[j].normalizationScale[1] );
-					file->ReadFloat( tri.dominantTris[j].normalizationScale[2] );
-				}
-			}
-			
-			file->ReadBig( tri.numShadowIndexesNoFrontCaps );
-			file->ReadBig( tri.numShadowIndexesNoCaps );
-			file->ReadBig( tri.shadowCapPlaneBits );
-			
-			tri.ambientSurface = NULL;
-			tri.nextDeferredFree = NULL;
-			tri.indexCache = 0;
-			tri.ambientCache = 0;
-			tri.shadowCache = 0;
+			ReadBinaryTriSurf( file, *surfaces[i].geometry );
 		}
 	}
 	
@@ -548,6 +687,17 @@ bool idRenderModelStatic::LoadBinaryModel( idFile* file, const ID_TIME_T sourceT
 	file->ReadBig( hasInteractingSurfaces );
 	file->ReadBig( hasShadowCastingSurfaces );
 	
+	int numSurfaceLODs;
+	file->ReadBig( numSurfaceLODs );
+	lodSurfaces.SetNum( numSurfaceLODs );
+	for( int i = 0; i < lodSurfaces.Num(); i++ )
+	{
+		file->ReadBig( lodSurfaces[i].surfaceNum );
+		file->ReadFloat( lodSurfaces[i].maxError );
+		lodSurfaces[i].geometry = R_AllocStaticTriSurf();
+		ReadBinaryTriSurf( file, *lodSurfaces[i].geometry );
+	}
+	
 	return true;
 }
 
@@ -591,116 +741,7 @@ void idRenderModelStatic::WriteBinaryModel( idFile* file, ID_TIME_T* _timeStamp
 		file->WriteBig( surfaces[i].geometry != NULL );
 		if( surfaces[i].geometry != NULL )
 		{
-			srfTriangles_t& tri = *surfaces[i].geometry;
-			
-			file->WriteVec3( tri.bounds[0] );
-			file->WriteVec3( tri.bounds[1] );
-			
-			int ambientViewCount = 0;	// FIXME: remove
-			file->WriteBig( ambientViewCount );
-			file->WriteBig( tri.generateNormals );
-			file->WriteBig( tri.tangentsCalculated );
-			file->WriteBig( tri.perfectHull );
-			file->WriteBig( tri.referencedIndexes );
-			
-			// shadow models use numVerts but have no verts
-			file->WriteBig( tri.numVerts );
-			if( tri.verts != NULL )
-			{
-				file->WriteBig( tri.numVerts );
-			}
-			else
-			{
-				file->WriteBig( ( int ) 0 );
-			}
-			
-			if( tri.numVerts > 0 && tri.verts != NULL )
-			{
-				for( int j = 0; j < tri.numVerts; j++ )
-				{
-					file->WriteVec3( tri.verts[j].xyz );
-					file->WriteBigArray( tri.verts[j].st, 2 );
-					file->WriteBigArray( tri.verts[j].normal, 4 );
-					file->WriteBigArray( tri.verts[j].tangent, 4 );
-					file->WriteBigArray( tri.verts[j].color, sizeof( tri.verts[j].color ) / sizeof( tri.verts[j].color[0] ) );
-					file->WriteBigArray( tri.verts[j].color2, sizeof( tri.verts[j].color2 ) / sizeof( tri.verts[j].color2[0] ) );
-				}
-			}
-			
-			if( tri.preLightShadowVertexes != NULL )
-			{
-				file->WriteBig( tri.numVerts * 2 );
-				for( int j = 0; j < tri.numVerts * 2; j++ )
-				{
-					file->WriteVec4( tri.preLightShadowVertexes[ j ].xyzw );
-				}
-			}
-			else
-			{
-				file->WriteBig( ( int ) 0 );
-			}
-			
-			file->WriteBig( tri.numIndexes );
-			
-			if( tri.numIndexes > 0 )
-			{
-				file->WriteBigArray( tri.indexes, tri.numIndexes );
-			}
-			
-			if( tri.silIndexes != NULL )
-			{
-				file->WriteBig( tri.numIndexes );
-			}
-			else
-			{
-				file->WriteBig( ( int ) 0 );
-			}
-			
-			if( tri.numIndexes > 0 && tri.silIndexes != NULL )
-			{
-				file->WriteBigArray( tri.silIndexes, tri.numIndexes );
-			}
-			
-			file->WriteBig( tri.numMirroredVerts );
-			if( tri.numMirroredVerts > 0 )
-			{
-				file->WriteBigArray( tri.mirroredVerts, tri.numMirroredVerts );
-			}
-			
-			file->WriteBig( tri.numDupVerts );
-			if( tri.numDupVerts > 0 )
-			{
-				file->WriteBigArray( tri.dupVerts, tri.numDupVerts * 2 );
-			}
-			
-			file->WriteBig( tri.numSilEdges );
-			if( tri.numSilEdges > 0 )
-			{
-				for( int j = 0; j < tri.numSilEdges; j++ )
-				{
-					file->WriteBig( tri.silEdges[j].p1 );
-					file->WriteBig( tri.silEdges[j].p2 );
-					file->WriteBig( tri.silEdges[j].v1 );
-					file->WriteBig( tri.silEdges[j].v2 );
-				}
-			}
-			
-			file->WriteBig( tri.dominantTris != NULL );
-			if( tri.dominantTris != NULL )
-			{
-				for( int j = 0; j < tri.numVerts; j++ )
-				{
-					file->WriteBig( tri.dominantTris[j].v2 );
-					file->WriteBig( tri.dominantTris[j].v3 );
-					file->WriteFloat( tri.dominantTris[j].normalizationScale[0] );
-					file->WriteFloat( tri.dominantTris[j].normalizationScale[1] );
-					file->WriteFloat( tri.dominantTris[j].normalizationScale[2] );
-				}
-			}
-			
-			file->WriteBig( tri.numShadowIndexesNoFrontCaps );
-			file->WriteBig( tri.numShadowIndexesNoCaps );
-			file->WriteBig( tri.shadowCapPlaneBits );
+			WriteBinaryTriSurf( file, *surfaces[i].geometry );
 		}
 	}
 	
@@ -722,6 +763,14 @@ void idRenderModelStatic::WriteBinaryModel( idFile* file, ID_TIME_T* _timeStamp
 	file->WriteBig( hasDrawingSurfaces );
 	file->WriteBig( hasInteractingSurfaces );
 	file->WriteBig( hasShadowCastingSurfaces );
+	
+	file->WriteBig( lodSurfaces.Num() );
+	for( int i = 0; i < lodSurfaces.Num(); i++ )
+	{
+		file->WriteBig( lodSurfaces[i].surfaceNum );
+		file->WriteFloat( lodSurfaces[i].maxError );
+		WriteBinaryTriSurf( file, *lodSurfaces[i].geometry );
+	}
 }
 
 // RB begin
@@ -1101,6 +1150,29 @@ int idRenderModelStatic::NearestJoint( int surfaceNum, int a, int b, int c ) con
 //=====================================================================
 
 
+/*
+================
+R_CleanupTrianglesJob
+
+The surfaces of a model share no data, so they are cleaned up in parallel.
+================
+*/
+struct cleanupTrianglesParms_t
+{
+	srfTriangles_t* 	tri;
+	bool				createNormals;
+	bool				useUnsmoothedTangents;
+	bool				optimizeOrder;
+	bool				optimizeOverdraw;
+};
+
+static void R_CleanupTrianglesJob( const cleanupTrianglesParms_t* parms )
+{
+	R_CleanupTriangles( parms->tri, parms->createNormals, true, parms->useUnsmoothedTangents, parms->optimizeOrder, parms->optimizeOverdraw, false );
+}
+
+REGISTER_PARALLEL_JOB( R_CleanupTrianglesJob, "R_CleanupTrianglesJob" );
+
 /*
 ================
 idRenderModelStatic::FinishSurfaces
@@ -1211,11 +1283,53 @@ void idRenderModelStatic::FinishSurfaces()
 	}
 	
 	// clean the surfaces
+	idList<cleanupTrianglesParms_t> cleanupParms;
+	cleanupParms.SetNum( surfaces.Num() );
+	for( i = 0; i < surfaces.Num(); i++ )
+	{
+		const modelSurface_t*	surf = &surfaces[i];
+		
+		// blended surfaces rely on the authored triangle order, and deforms like
+		// autosprites and tubes on the authored quads
+		const materialCoverage_t coverage = surf->shader->Coverage();
+		const bool optimizeOrder = ( coverage != MC_TRANSLUCENT && surf->shader->Deform() == DFRM_NONE );
+		cleanupParms[i].tri = surf->geometry;
+		cleanupParms[i].createNormals = surf->geometry->generateNormals;
+		cleanupParms[i].useUnsmoothedTangents = surf->shader->UseUnsmoothedTangents();
+		cleanupParms[i].optimizeOrder = optimizeOrder;
+		cleanupParms[i].optimizeOverdraw = ( optimizeOrder && coverage == MC_OPAQUE );
+	}
+	
+	if( r_useParallelFinishSurfaces.GetBool() && surfaces.Num() > 1 && tr.loadJobList != NULL )
+	{
+		for( i = 0; i < cleanupParms.Num(); i++ )
+		{
+			tr.loadJobList->AddJob( ( jobRun_t )R_CleanupTrianglesJob, &cleanupParms[i] );
+		}
+		tr.loadJobList->Submit();
+		tr.loadJobList->Wait();
+	}
+	else
+	{
+		for( i = 0; i < cleanupParms.Num(); i++ )
+		{
+			R_CleanupTrianglesJob( &cleanupParms[i] );
+		}
+	}
+	
+	// derive the normals and tangents of all surfaces together, so large surfaces can be split over jobs
+	idList<srfTriangles_t*> cleanedTris;
+	cleanedTris.SetNum( surfaces.Num() );
+	for( i = 0; i < surfaces.Num(); i++ )
+	{
+		cleanedTris[i] = surfaces[i].geometry;
+	}
+	R_DeriveTangentsForSurfaces( cleanedTris.Ptr(), cleanedTris.Num() );
+	
 	for( i = 0; i < surfaces.Num(); i++ )
 	{
 		const modelSurface_t*	surf = &surfaces[i];
 		
-		R_CleanupTriangles( surf->geometry, surf->geometry->generateNormals, true, surf->shader->UseUnsmoothedTangents() );
 		if( surf->shader->SurfaceCastsShadow() )
 		{
 			totalVerts += surf->geometry->numVerts;
@@ -3284,6 +3398,8 @@ void idRenderModelStatic::PurgeModel()
 	}
 	surfaces.Clear();
 	
+	FreeSurfaceLODs();
+	
 	if( jointsInverted != NULL )
 	{
 		Mem_Free( jointsInverted );
@@ -3311,6 +3427,10 @@ void idRenderModelStatic::FreeVertexCache()
 		}
 		R_FreeStaticTriSurfVertexCaches( tri );
 	}
+	for( int j = 0; j < lodSurfaces.Num(); j++ )
+	{
+		R_FreeStaticTriSurfVertexCaches( lodSurfaces[j].geometry );
+	}
 }
 
 /*
@@ -3463,6 +3583,8 @@ bool idRenderModelStatic::DeleteSurfaceWithId( int id )
 	{
 		if( surfaces[i].id == id )
 		{
+			// the simplified surfaces are indexed by surface number
+			FreeSurfaceLODs();
 			R_FreeStaticTriSurf( surfaces[i].geometry );
 			surfaces.RemoveIndex( i );
 			return true;
@@ -3482,6 +3604,7 @@ void idRenderModelStatic::DeleteSurfacesWithNegativeId()
 	{
 		if( surfaces[i].id < 0 )
 		{
+			FreeSurfaceLODs();
 			R_FreeStaticTriSurf( surfaces[i].geometry );
 			surfaces.RemoveIndex( i );
 			i--;
@@ -132,6 +132,14 @@ struct modelSurface_t
 	srfTriangles_t* 			geometry;
 };
 
+// simplified geometry for a model surface, generated at load time
+struct modelSurfaceLOD_t
+{
+	int							surfaceNum;
+	float						maxError;				// largest deviation from the original surface, in model units
+	srfTriangles_t* 			geometry;
+};
+
 enum dynamicModel_t
 {
 	DM_STATIC,		// never creates a dynamic model
@@ -245,6 +253,24 @@ public:
 	// get a pointer to a surface
 	virtual const modelSurface_t* Surface( int surfaceNum ) const = 0;
 	
+	// returns the coarsest simplified geometry for the surface that stays within
+	// allowedError model units of the original, or NULL if the surface should be
+	// drawn at full detail
+	virtual srfTriangles_t* 	SurfaceLOD( int surfaceNum, float allowedError ) const
+	{
+		return NULL;
+	}
+	
+	// all simplified surfaces, so they can be put in static vertex buffers
+	virtual int					NumSurfaceLODs() const
+	{
+		return 0;
+	}
+	virtual const modelSurfaceLOD_t* GetSurfaceLOD( int lodNum ) const
+	{
+		return NULL;
+	}
+	
 	// Allocates surface triangles.
 	// Allocates memory for srfTriangles_t::verts and srfTriangles_t::indexes
 	// The allocated memory is not initialized.
@@ -880,7 +880,7 @@ drawSurf_t* idRenderModelDecal::CreateDecalDrawSurf( const viewEntity_t* space,
 	drawSurf->extraGLState = 0;
 	drawSurf->renderZFail = 0;
 	
-	R_SetupDrawSurfShader( drawSurf, material, &space->entityDef->parms );
+	R_SetupDrawSurfShader( drawSurf, material, space->entityDef );
 	
 	return drawSurf;
 }
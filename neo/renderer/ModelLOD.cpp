@@ -0,0 +1,811 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#pragma hdrstop
+#include "precompiled.h"
+
+#include "tr_local.h"
+#include "Model_local.h"
+
+/*
+===============================================================================
+
+	Static model surface simplification
+
+	Surfaces are reduced with quadric error metric half edge collapses in
+	position space, using the silIndexes so texture seams don't split the mesh.
+	A vertex is only ever moved onto one of its neighbours, so the simplified
+	surfaces reuse the original idDrawVerts and need no attribute interpolation.
+
+	Vertexes on open or non-manifold edges are never collapsed and every
+	collapse must pass the link condition, so a closed surface stays closed
+	and the silhouette edges of each level are valid for shadow volumes.
+
+===============================================================================
+*/
+
+idCVar idRenderModelStatic::r_generateModelLODs( "r_generateModelLODs", "1", CVAR_BOOL | CVAR_RENDERER, "build simplified surfaces when loading static models" );
+idCVar idRenderModelStatic::r_lodMinTriangles( "r_lodMinTriangles", "256", CVAR_INTEGER | CVAR_RENDERER, "don't simplify surfaces with fewer triangles than this" );
+
+static const int	MAX_SURFACE_LODS = 3;			// each level targets half the triangles of the previous one
+static const int	LOD_MIN_LEVEL_TRIANGLES = 32;	// don't build levels smaller than this
+static const float	LOD_MIN_REDUCTION = 0.8f;		// stop if a level doesn't remove at least 20% of the triangles
+static const float	LOD_MIN_NORMAL_DOT = 0.5f;		// reject collapses that rotate a triangle more than 60 degrees
+
+/*
+================================================
+idSimplifyQuadric
+
+Sum of squared distances to a set of planes.
+Doubles are needed for models far from their origin.
+================================================
+*/
+class idSimplifyQuadric
+{
+public:
+	void	Clear()
+	{
+		memset( q, 0, sizeof( q ) );
+	}
+	
+	void	AddPlane( const idVec3& n, const double d )
+	{
+		q[0] += n.x * n.x;
+		q[1] += n.x * n.y;
+		q[2] += n.x * n.z;
+		q[3] += n.x * d;
+		q[4] += n.y * n.y;
+		q[5] += n.y * n.z;
+		q[6] += n.y * d;
+		q[7] += n.z * n.z;
+		q[8] += n.z * d;
+		q[9] += d * d;
+	}
+	
+	void	Add( const idSimplifyQuadric& other )
+	{
+		for( int i = 0; i < 10; i++ )
+		{
+			q[i] += other.q[i];
+		}
+	}
+	
+	double	Error( const idVec3& p ) const
+	{
+		const double x = p.x;
+		const double y = p.y;
+		const double z = p.z;
+		return	x * x * q[0] + 2.0 * x * y * q[1] + 2.0 * x * z * q[2] + 2.0 * x * q[3]
+				+ y * y * q[4] + 2.0 * y * z * q[5] + 2.0 * y * q[6]
+				+ z * z * q[7] + 2.0 * z * q[8] + q[9];
+	}
+	
+private:
+	double	q[10];
+};
+
+struct simplifyCollapse_t
+{
+	int		from;			// position removed by the collapse
+	int		to;				// position it is moved onto
+	float	cost;
+};
+
+/*
+================================================
+idTriSurfSimplifier
+================================================
+*/
+class idTriSurfSimplifier
+{
+public:
+	void				Init( const srfTriangles_t* tri );
+	
+	// collapses edges until the surface has targetTris triangles or no more valid
+	// collapses remain, returns false if nothing could be removed
+	bool				Simplify( int targetTris );
+	
+	// allocates a new surface with the current triangles and only the vertexes they reference
+	srfTriangles_t* 	CreateTriSurf() const;
+	
+	int					NumTris() const
+	{
+		return numLiveTris;
+	}
+	float				MaxError() const
+	{
+		return maxError;
+	}
+	
+private:
+	void				BuildAdjacency();
+	bool				EvaluateCollapse( int from, int to, float& cost );
+	void				ApplyCollapse( int from, int to );
+	int					FindAttributeVertex( int drawVert ) const;
+	
+	const srfTriangles_t* 	srcTri;
+	
+	idList<int>			drawIndexes;		// current triangles using the original idDrawVerts
+	idList<int>			posIndexes;			// current triangles using the first vertex at each position
+	idList<bool>		triRemoved;
+	int					numLiveTris;
+	float				maxError;
+	
+	idList<idSimplifyQuadric> quadrics;		// indexed by position
+	idList<bool>		locked;				// positions on open or non-manifold edges
+	idList<bool>		dirty;				// positions touched in the current pass
+	
+	idList<int>			vertTriStart;		// triangles using each position for the current pass
+	idList<int>			vertTris;
+	
+	idList<int>			mark;				// scratch stamps for the link condition
+	int					markCount;
+	
+	int					numAttributeRemaps;	// draw vertex replacements for the collapse being evaluated
+	int					attributeRemap[2][2];
+};
+
+/*
+====================
+idTriSurfSimplifier::Init
+====================
+*/
+void idTriSurfSimplifier::Init( const srfTriangles_t* tri )
+{
+	srcTri = tri;
+	
+	const int numVerts = tri->numVerts;
+	const int numIndexes = tri->numIndexes;
+	
+	drawIndexes.SetNum( numIndexes );
+	posIndexes.SetNum( numIndexes );
+	for( int i = 0; i < numIndexes; i++ )
+	{
+		drawIndexes[i] = tri->indexes[i];
+		posIndexes[i] = tri->silIndexes[i];
+	}
+	
+	triRemoved.SetNum( numIndexes / 3 );
+	numLiveTris = numIndexes / 3;
+	maxError = 0.0f;
+	
+	quadrics.SetNum( numVerts );
+	locked.SetNum( numVerts );
+	dirty.SetNum( numVerts );
+	mark.SetNum( numVerts );
+	for( int i = 0; i < numVerts; i++ )
+	{
+		quadrics[i].Clear();
+		locked[i] = false;
+		mark[i] = 0;
+	}
+	markCount = 0;
+	
+	// every position starts out with the planes of the triangles that use it
+	for( int i = 0; i < numIndexes; i += 3 )
+	{
+		triRemoved[i / 3] = false;
+		
+		const idVec3& a = tri->verts[posIndexes[i + 0]].xyz;
+		const idVec3& b = tri->verts[posIndexes[i + 1]].xyz;
+		const idVec3& c = tri->verts[posIndexes[i + 2]].xyz;
+		
+		idVec3 normal = ( c - a ).Cross( b - a );
+		if( normal.Normalize() == 0.0f )
+		{
+			continue;
+		}
+		const double d = -( normal * a );
+		
+		for( int j = 0; j < 3; j++ )
+		{
+			quadrics[posIndexes[i + j]].AddPlane( normal, d );
+		}
+	}
+	
+	// lock every position on an edge that isn't shared by exactly two triangles,
+	// moving those would open or tear the hull
+	idHashIndex edgeHash( 1024, numIndexes );
+	idList<int> edgeVerts;
+	idList<int> edgeCounts;
+	edgeVerts.SetGranularity( 1024 );
+	edgeCounts.SetGranularity( 512 );
+	for( int i = 0; i < numIndexes; i += 3 )
+	{
+		for( int j = 0; j < 3; j++ )
+		{
+			const int v1 = Min( posIndexes[i + j], posIndexes[i + ( j + 1 ) % 3] );
+			const int v2 = Max( posIndexes[i + j], posIndexes[i + ( j + 1 ) % 3] );
+			
+			const int key = edgeHash.GenerateKey( v1, v2 );
+			int edge;
+			for( edge = edgeHash.First( key ); edge >= 0; edge = edgeHash.Next( edge ) )
+			{
+				if( edgeVerts[edge * 2 + 0] == v1 && edgeVerts[edge * 2 + 1] == v2 )
+				{
+					break;
+				}
+			}
+			if( edge < 0 )
+			{
+				edge = edgeCounts.Append( 0 );
+				edgeVerts.Append( v1 );
+				edgeVerts.Append( v2 );
+				edgeHash.Add( key, edge );
+			}
+			edgeCounts[edge]++;
+		}
+	}
+	for( int i = 0; i < edgeCounts.Num(); i++ )
+	{
+		if( edgeCounts[i] != 2 )
+		{
+			locked[edgeVerts[i * 2 + 0]] = true;
+			locked[edgeVerts[i * 2 + 1]] = true;
+		}
+	}
+}
+
+/*
+====================
+idTriSurfSimplifier::BuildAdjacency
+====================
+*/
+void idTriSurfSimplifier::BuildAdjacency()
+{
+	const int numVerts = srcTri->numVerts;
+	
+	vertTriStart.SetNum( numVerts + 1 );
+	memset( vertTriStart.Ptr(), 0, vertTriStart.Num() * sizeof( vertTriStart[0] ) );
+	
+	for( int i = 0; i < posIndexes.Num(); i++ )
+	{
+		if( !triRemoved[i / 3] )
+		{
+			vertTriStart[posIndexes[i] + 1]++;
+		}
+	}
+	for( int i = 0; i < numVerts; i++ )
+	{
+		vertTriStart[i + 1] += vertTriStart[i];
+	}
+	
+	vertTris.SetNum( vertTriStart[numVerts] );
+	idList<int> fill;
+	fill.SetNum( numVerts );
+	memcpy( fill.Ptr(), vertTriStart.Ptr(), numVerts * sizeof( int ) );
+	
+	for( int i = 0; i < posIndexes.Num(); i++ )
+	{
+		if( !triRemoved[i / 3] )
+		{
+			vertTris[fill[posIndexes[i]]++] = i / 3;
+		}
+	}
+}
+
+/*
+====================
+idTriSurfSimplifier::FindAttributeVertex
+
+Returns the draw vertex that replaces drawVert in the collapse being evaluated.
+====================
+*/
+int idTriSurfSimplifier::FindAttributeVertex( int drawVert ) const
+{
+	for( int i = 0; i < numAttributeRemaps; i++ )
+	{
+		if( attributeRemap[i][0] == drawVert )
+		{
+			return attributeRemap[i][1];
+		}
+	}
+	return -1;
+}
+
+/*
+====================
+idTriSurfSimplifier::EvaluateCollapse
+
+Checks if the position from can be moved onto to without changing the topology,
+flipping triangles or losing a texture seam.
+====================
+*/
+bool idTriSurfSimplifier::EvaluateCollapse( int from, int to, float& cost )
+{
+	if( locked[from] )
+	{
+		return false;
+	}
+	
+	// the two triangles on the edge disappear, their draw vertexes
+	// tell which attributes replace the ones at from
+	numAttributeRemaps = 0;
+	int numShared = 0;
+	int opposite[2];
+	for( int i = vertTriStart[from]; i < vertTriStart[from + 1]; i++ )
+	{
+		const int* pos = &posIndexes[vertTris[i] * 3];
+		const int* draw = &drawIndexes[vertTris[i] * 3];
+		
+		int fromCorner = -1;
+		int toCorner = -1;
+		for( int j = 0; j < 3; j++ )
+		{
+			if( pos[j] == from )
+			{
+				fromCorner = j;
+			}
+			else if( pos[j] == to )
+			{
+				toCorner = j;
+			}
+		}
+		if( toCorner == -1 )
+		{
+			continue;
+		}
+		if( numShared == 2 )
+		{
+			return false;
+		}
+		opposite[numShared++] = pos[3 - fromCorner - toCorner];
+		
+		const int fromDraw = draw[fromCorner];
+		const int toDraw = draw[toCorner];
+		const int existing = FindAttributeVertex( fromDraw );
+		if( existing == -1 )
+		{
+			attributeRemap[numAttributeRemaps][0] = fromDraw;
+			attributeRemap[numAttributeRemaps][1] = toDraw;
+			numAttributeRemaps++;
+		}
+		else if( existing != toDraw )
+		{
+			// the edge is a seam at to but not at from
+			return false;
+		}
+	}
+	if( numShared != 2 || opposite[0] == opposite[1] )
+	{
+		return false;
+	}
+	
+	// link condition: the only positions connected to both ends of the edge
+	// may be the ones opposite it, or the collapse would pinch the surface
+	markCount++;
+	for( int i = vertTriStart[to]; i < vertTriStart[to + 1]; i++ )
+	{
+		const int* pos = &posIndexes[vertTris[i] * 3];
+		for( int j = 0; j < 3; j++ )
+		{
+			mark[pos[j]] = markCount;
+		}
+	}
+	for( int i = vertTriStart[from]; i < vertTriStart[from + 1]; i++ )
+	{
+		const int* pos = &posIndexes[vertTris[i] * 3];
+		for( int j = 0; j < 3; j++ )
+		{
+			const int v = pos[j];
+			if( v != from && v != to && v != opposite[0] && v != opposite[1] && mark[v] == markCount )
+			{
+				return false;
+			}
+		}
+	}
+	
+	// the remaining triangles must keep their facing and their texture mapping
+	const idVec3& toXyz = srcTri->verts[to].xyz;
+	for( int i = vertTriStart[from]; i < vertTriStart[from + 1]; i++ )
+	{
+		const int* pos = &posIndexes[vertTris[i] * 3];
+		const int* draw = &drawIndexes[vertTris[i] * 3];
+		
+		idVec3 xyz[3];
+		int fromCorner = 0;
+		bool shared = false;
+		for( int j = 0; j < 3; j++ )
+		{
+			xyz[j] = srcTri->verts[pos[j]].xyz;
+			if( pos[j] == from )
+			{
+				fromCorner = j;
+			}
+			else if( pos[j] == to )
+			{
+				shared = true;
+			}
+		}
+		if( shared )
+		{
+			continue;
+		}
+		if( FindAttributeVertex( draw[fromCorner] ) == -1 )
+		{
+			// this side of a seam doesn't touch the edge
+			return false;
+		}
+		
+		const idVec3 oldNormal = ( xyz[2] - xyz[0] ).Cross( xyz[1] - xyz[0] );
+		xyz[fromCorner] = toXyz;
+		const idVec3 newNormal = ( xyz[2] - xyz[0] ).Cross( xyz[1] - xyz[0] );
+		
+		const float oldLength = oldNormal.Length();
+		const float newLength = newNormal.Length();
+		if( newLength < idMath::FLT_SMALLEST_NON_DENORMAL )
+		{
+			return false;
+		}
+		if( oldNormal * newNormal < LOD_MIN_NORMAL_DOT * oldLength * newLength )
+		{
+			return false;
+		}
+	}
+	
+	idSimplifyQuadric q = quadrics[from];
+	q.Add( quadrics[to] );
+	cost = ( float )Max( q.Error( toXyz ), 0.0 );
+	
+	return true;
+}
+
+/*
+====================
+idTriSurfSimplifier::ApplyCollapse
+
+Must directly follow a successful EvaluateCollapse for the same edge.
+====================
+*/
+void idTriSurfSimplifier::ApplyCollapse( int from, int to )
+{
+	for( int i = vertTriStart[from]; i < vertTriStart[from + 1]; i++ )
+	{
+		const int t = vertTris[i];
+		int* pos = &posIndexes[t * 3];
+		int* draw = &drawIndexes[t * 3];
+		
+		for( int j = 0; j < 3; j++ )
+		{
+			dirty[pos[j]] = true;
+		}
+		
+		if( pos[0] == to || pos[1] == to || pos[2] == to )
+		{
+			triRemoved[t] = true;
+			numLiveTris--;
+			continue;
+		}
+		
+		for( int j = 0; j < 3; j++ )
+		{
+			if( pos[j] == from )
+			{
+				draw[j] = FindAttributeVertex( draw[j] );
+				pos[j] = to;
+			}
+		}
+	}
+	
+	quadrics[to].Add( quadrics[from] );
+}
+
+/*
+====================
+SortCollapsesByCost
+====================
+*/
+static int SortCollapsesByCost( const void* a, const void* b )
+{
+	const float costA = ( ( const simplifyCollapse_t* )a )->cost;
+	const float costB = ( ( const simplifyCollapse_t* )b )->cost;
+	if( costA < costB )
+	{
+		return -1;
+	}
+	if( costA > costB )
+	{
+		return 1;
+	}
+	return 0;
+}
+
+/*
+====================
+idTriSurfSimplifier::Simplify
+
+Each pass sorts all valid collapses by cost and performs the cheapest ones
+that don't touch a vertex already changed in the same pass.
+====================
+*/
+bool idTriSurfSimplifier::Simplify( int targetTris )
+{
+	const int startTris = numLiveTris;
+	
+	idList<simplifyCollapse_t> collapses;
+	collapses.SetGranularity( 1024 );
+	
+	while( numLiveTris > targetTris )
+	{
+		BuildAdjacency();
+		
+		// each interior edge is seen from both of its triangles, so only use
+		// the winding where it goes from the lower to the higher position
+		collapses.SetNum( 0 );
+		for( int i = 0; i < posIndexes.Num(); i += 3 )
+		{
+			if( triRemoved[i / 3] )
+			{
+				continue;
+			}
+			for( int j = 0; j < 3; j++ )
+			{
+				const int v1 = posIndexes[i + j];
+				const int v2 = posIndexes[i + ( j + 1 ) % 3];
+				if( v1 >= v2 )
+				{
+					continue;
+				}
+				
+				simplifyCollapse_t collapse;
+				collapse.cost = idMath::INFINITY;
+				float cost;
+				if( EvaluateCollapse( v1, v2, cost ) )
+				{
+					collapse.from = v1;
+					collapse.to = v2;
+					collapse.cost = cost;
+				}
+				if( EvaluateCollapse( v2, v1, cost ) && cost < collapse.cost )
+				{
+					collapse.from = v2;
+					collapse.to = v1;
+					collapse.cost = cost;
+				}
+				if( collapse.cost < idMath::INFINITY )
+				{
+					collapses.Append( collapse );
+				}
+			}
+		}
+		
+		if( collapses.Num() == 0 )
+		{
+			break;
+		}
+		
+		qsort( collapses.Ptr(), collapses.Num(), sizeof( collapses[0] ), SortCollapsesByCost );
+		
+		memset( dirty.Ptr(), 0, dirty.Num() * sizeof( dirty[0] ) );
+		
+		const int passTris = numLiveTris;
+		for( int i = 0; i < collapses.Num() && numLiveTris > targetTris; i++ )
+		{
+			const simplifyCollapse_t& collapse = collapses[i];
+			if( dirty[collapse.from] || dirty[collapse.to] )
+			{
+				continue;
+			}
+			
+			// the adjacency of clean positions is unchanged, but the
+			// attribute remapping has to be rebuilt for this edge
+			float cost;
+			if( !EvaluateCollapse( collapse.from, collapse.to, cost ) )
+			{
+				continue;
+			}
+			ApplyCollapse( collapse.from, collapse.to );
+			
+			maxError = Max( maxError, idMath::Sqrt( cost ) );
+		}
+		
+		if( numLiveTris == passTris )
+		{
+			break;
+		}
+	}
+	
+	return numLiveTris < startTris;
+}
+
+/*
+====================
+idTriSurfSimplifier::CreateTriSurf
+====================
+*/
+srfTriangles_t* idTriSurfSimplifier::CreateTriSurf() const
+{
+	idList<int> vertRemap;
+	vertRemap.SetNum( srcTri->numVerts );
+	memset( vertRemap.Ptr(), -1, vertRemap.Num() * sizeof( vertRemap[0] ) );
+	
+	int numVerts = 0;
+	for( int i = 0; i < drawIndexes.Num(); i++ )
+	{
+		if( !triRemoved[i / 3] && vertRemap[drawIndexes[i]] == -1 )
+		{
+			vertRemap[drawIndexes[i]] = numVerts++;
+		}
+	}
+	
+	srfTriangles_t* newTri = R_AllocStaticTriSurf();
+	newTri->generateNormals = srcTri->generateNormals;
+	
+	newTri->numVerts = numVerts;
+	R_AllocStaticTriSurfVerts( newTri, numVerts );
+	for( int i = 0; i < srcTri->numVerts; i++ )
+	{
+		if( vertRemap[i] != -1 )
+		{
+			newTri->verts[vertRemap[i]] = srcTri->verts[i];
+		}
+	}
+	
+	newTri->numIndexes = numLiveTris * 3;
+	R_AllocStaticTriSurfIndexes( newTri, newTri->numIndexes );
+	int numIndexes = 0;
+	for( int i = 0; i < drawIndexes.Num(); i++ )
+	{
+		if( !triRemoved[i / 3] )
+		{
+			newTri->indexes[numIndexes++] = vertRemap[drawIndexes[i]];
+		}
+	}
+	
+	return newTri;
+}
+
+//=============================================================================
+
+/*
+================
+idRenderModelStatic::GenerateSurfaceLODs
+
+Builds up to MAX_SURFACE_LODS simplified versions of every large surface.
+Must be called after FinishSurfaces so the silIndexes exist.
+================
+*/
+void idRenderModelStatic::GenerateSurfaceLODs()
+{
+	FreeSurfaceLODs();
+	
+	if( !r_generateModelLODs.GetBool() || fastLoad || isStaticWorldModel || IsDynamicModel() != DM_STATIC )
+	{
+		return;
+	}
+	
+	const int minTriangles = Max( r_lodMinTriangles.GetInteger(), LOD_MIN_LEVEL_TRIANGLES * 2 );
+	
+	for( int i = 0; i < surfaces.Num(); i++ )
+	{
+		const modelSurface_t* surf = &surfaces[i];
+		const srfTriangles_t* tri = surf->geometry;
+		
+		if( tri == NULL || tri->silIndexes == NULL || surf->shader == NULL )
+		{
+			continue;
+		}
+		if( tri->numIndexes / 3 < minTriangles )
+		{
+			continue;
+		}
+		// deforms like autosprites depend on the exact triangles
+		if( surf->shader->Deform() != DFRM_NONE )
+		{
+			continue;
+		}
+		
+		idTriSurfSimplifier simplifier;
+		simplifier.Init( tri );
+		
+		int prevTris = tri->numIndexes / 3;
+		for( int level = 1; level <= MAX_SURFACE_LODS; level++ )
+		{
+			const int targetTris = ( tri->numIndexes / 3 ) >> level;
+			if( targetTris < LOD_MIN_LEVEL_TRIANGLES )
+			{
+				break;
+			}
+			if( !simplifier.Simplify( targetTris ) || simplifier.NumTris() > prevTris * LOD_MIN_REDUCTION )
+			{
+				break;
+			}
+			
+			srfTriangles_t* lodTri = simplifier.CreateTriSurf();
+			
+			const materialCoverage_t coverage = surf->shader->Coverage();
+			R_CleanupTriangles( lodTri, lodTri->generateNormals, true, surf->shader->UseUnsmoothedTangents(),
+								coverage != MC_TRANSLUCENT, coverage == MC_OPAQUE );
+			
+			modelSurfaceLOD_t& lod = lodSurfaces.Alloc();
+			lod.surfaceNum = i;
+			lod.maxError = simplifier.MaxError();
+			lod.geometry = lodTri;
+			
+			prevTris = simplifier.NumTris();
+		}
+	}
+}
+
+/*
+================
+idRenderModelStatic::FreeSurfaceLODs
+================
+*/
+void idRenderModelStatic::FreeSurfaceLODs()
+{
+	for( int i = 0; i < lodSurfaces.Num(); i++ )
+	{
+		R_FreeStaticTriSurf( lodSurfaces[i].geometry );
+	}
+	lodSurfaces.Clear();
+}
+
+/*
+================
+idRenderModelStatic::SurfaceLOD
+================
+*/
+srfTriangles_t* idRenderModelStatic::SurfaceLOD( int surfaceNum, float allowedError ) const
+{
+	srfTriangles_t* best = NULL;
+	for( int i = 0; i < lodSurfaces.Num(); i++ )
+	{
+		const modelSurfaceLOD_t& lod = lodSurfaces[i];
+		if( lod.surfaceNum < surfaceNum )
+		{
+			continue;
+		}
+		if( lod.surfaceNum > surfaceNum || lod.maxError > allowedError )
+		{
+			break;
+		}
+		best = lod.geometry;
+	}
+	return best;
+}
+
+/*
+================
+idRenderModelStatic::NumSurfaceLODs
+================
+*/
+int idRenderModelStatic::NumSurfaceLODs() const
+{
+	return lodSurfaces.Num();
+}
+
+/*
+================
+idRenderModelStatic::GetSurfaceLOD
+================
+*/
+const modelSurfaceLOD_t* idRenderModelStatic::GetSurfaceLOD( int lodNum ) const
+{
+	return &lodSurfaces[lodNum];
+}
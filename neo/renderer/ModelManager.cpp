@@ -812,6 +812,10 @@ void idRenderModelManagerLocal::EndLevelLoad()
 			{
 				R_CreateStaticBuffersForTri( *( model->Surface( j )->geometry ) );
 			}
+			for( int j = 0; j < model->NumSurfaceLODs(); j++ )
+			{
+				R_CreateStaticBuffersForTri( *( model->GetSurfaceLOD( j )->geometry ) );
+			}
 		}
 	}
 	
@@ -792,7 +792,7 @@ drawSurf_t* idRenderModelOverlay::CreateOverlayDrawSurf( const viewEntity_t* spa
 	drawSurf->extraGLState = 0;
 	drawSurf->renderZFail = 0;
 	
-	R_SetupDrawSurfShader( drawSurf, material, &space->entityDef->parms );
+	R_SetupDrawSurfShader( drawSurf, material, space->entityDef );
 	R_SetupDrawSurfJoints( drawSurf, newTri, NULL );
 	
 	return drawSurf;
@@ -82,6 +82,9 @@ public:
 	virtual int					NumSurfaces() const;
 	virtual int					NumBaseSurfaces() const;
 	virtual const modelSurface_t* Surface( int surfaceNum ) const;
+	virtual srfTriangles_t* 	SurfaceLOD( int surfaceNum, float allowedError ) const;
+	virtual int					NumSurfaceLODs() const;
+	virtual const modelSurfaceLOD_t* GetSurfaceLOD( int lodNum ) const;
 	virtual srfTriangles_t* 	AllocSurfaceTriangles( int numVerts, int numIndexes ) const;
 	virtual void				FreeSurfaceTriangles( srfTriangles_t* tris ) const;
 	virtual bool				IsStaticWorldModel() const;
@@ -131,8 +134,12 @@ public:
 	void						DeleteSurfacesWithNegativeId();
 	bool						FindSurfaceWithId( int id, int& surfaceNum ) const;
 	
+	void						GenerateSurfaceLODs();
+	void						FreeSurfaceLODs();
+	
 public:
 	idList<modelSurface_t, TAG_MODEL>	surfaces;
+	idList<modelSurfaceLOD_t, TAG_MODEL> lodSurfaces;		// sorted by surface, then by increasing error
 	idBounds					bounds;
 	int							overlaysAdded;
 	
@@ -142,6 +149,9 @@ public:
 	vertCacheHandle_t			jointsInvertedBuffer;
 	
 protected:
+	static void					ReadBinaryTriSurf( idFile* file, srfTriangles_t& tri );
+	static void					WriteBinaryTriSurf( idFile* file, const srfTriangles_t& tri );
+	
 	int							lastModifiedFrame;
 	int							lastArchivedFrame;
 	
@@ -161,6 +171,8 @@ protected:
 	static idCVar				r_slopVertex;			// merge xyz coordinates this far apart
 	static idCVar				r_slopTexCoord;			// merge texture coordinates this far apart
 	static idCVar				r_slopNormal;			// merge normals that dot less than this
+	static idCVar				r_generateModelLODs;	// build simplified surfaces when loading static models
+	static idCVar				r_lodMinTriangles;		// don't simplify surfaces smaller than this
 };
 
 /*
@@ -34,6 +34,817 @@ If you have questions concerning this license or the applicable additional terms
 
 static const char* parametricParticle_SnapshotName = "_ParametricParticle_Snapshot_";
 
+/*
+===============================================================================
+
+	Particle snapshot
+
+	Everything a parametric particle system generates is a function of the
+	inputs below, so a snapshot built from identical inputs can be handed back
+	as is, skipping the regeneration of every stage.
+
+===============================================================================
+*/
+
+typedef struct
+{
+	const idDeclParticle* 	particleSystem;
+	int						time;
+	float					shaderParms[MAX_ENTITY_SHADER_PARMS];
+	idMat3					entityAxis;
+	idMat3					viewAxis;
+} particleSnapshotKey_t;
+
+class idRenderModelPrtSnapshot : public idRenderModelStatic
+{
+public:
+	idRenderModelPrtSnapshot()
+	{
+		keyValid = false;
+	}
+	
+	particleSnapshotKey_t	key;
+	bool					keyValid;
+};
+
+/*
+====================
+R_ParticleSnapshotKey
+====================
+*/
+static void R_ParticleSnapshotKey( const idDeclParticle* particleSystem, const renderEntity_t* renderEntity, const viewDef_t* viewDef, particleSnapshotKey_t& key )
+{
+	// clear the padding so the keys can be compared with memcmp
+	memset( &key, 0, sizeof( key ) );
+	
+	key.particleSystem = particleSystem;
+	key.time = viewDef->renderView.time[renderEntity->timeGroup];
+	memcpy( key.shaderParms, renderEntity->shaderParms, sizeof( key.shaderParms ) );
+	key.entityAxis = renderEntity->axis;
+	key.viewAxis = viewDef->renderView.viewaxis;
+}
+
+/*
+===============================================================================
+
+	Batched particle evaluation
+
+	Live particles of a stage are gathered into batches, and the fade, origin
+	and quad math is done for four particles at a time on structure of arrays
+	data. The random numbers are still drawn one particle at a time in the same
+	order as idParticleStage::CreateParticle, so both paths produce the same
+	particles. Custom paths and aimed particles always use the per particle code.
+
+===============================================================================
+*/
+
+static const int PARTICLE_BATCH_SIZE = 64;
+
+enum
+{
+	PRAND_DIST0,		// distribution draws, three for a rect or sphere, two for a cylinder
+	PRAND_DIST1,
+	PRAND_DIST2,
+	PRAND_CONE0,		// cone direction draws
+	PRAND_CONE1,
+	PRAND_ANGLE,		// initial angle draw
+	PRAND_COUNT
+};
+
+struct particleBatch_t
+{
+	int						count;
+	int						index[PARTICLE_BATCH_SIZE];
+	int						seed[PARTICLE_BATCH_SIZE];
+	dword					color[PARTICLE_BATCH_SIZE];
+	ALIGN16( float			frac[PARTICLE_BATCH_SIZE] );
+	ALIGN16( float			age[PARTICLE_BATCH_SIZE] );
+	ALIGN16( float			rand[PRAND_COUNT][PARTICLE_BATCH_SIZE] );
+	ALIGN16( float			origin[3][PARTICLE_BATCH_SIZE] );
+	ALIGN16( float			left[3][PARTICLE_BATCH_SIZE] );
+	ALIGN16( float			up[3][PARTICLE_BATCH_SIZE] );
+};
+
+/*
+====================
+R_ParticleStageCanBatch
+====================
+*/
+static bool R_ParticleStageCanBatch( const idParticleStage* stage )
+{
+	if( !r_useParticleBatches.GetBool() )
+	{
+		return false;
+	}
+	return ( stage->customPathType == PPATH_STANDARD && stage->orientation != POR_AIMED );
+}
+
+/*
+====================
+R_EvalParticleSamples
+
+Evaluates a parm from its baked samples, which is exact for linear parms
+====================
+*/
+static ID_INLINE float R_EvalParticleSamples( const idParticleParm& parm, const float* samples, float frac )
+{
+	if( parm.table == NULL )
+	{
+		return parm.from + frac * ( parm.to - parm.from );
+	}
+	float f = frac * PARTICLE_PARM_SAMPLES;
+	int i = idMath::ClampInt( 0, PARTICLE_PARM_SAMPLES - 1, ( int )f );
+	f -= i;
+	return samples[i] + ( samples[i + 1] - samples[i] ) * f;
+}
+
+/*
+====================
+R_ParticleIntegrate
+
+Same as idParticleParm::Integrate without the warning spam for tables
+====================
+*/
+static ID_INLINE float R_ParticleIntegrate( const idParticleParm& parm, float frac )
+{
+	if( parm.table != NULL )
+	{
+		return 0.0f;
+	}
+	return ( parm.from + frac * ( parm.to - parm.from ) * 0.5f ) * frac;
+}
+
+#if defined(USE_INTRINSICS)
+
+/*
+====================
+R_SinCos16_SSE
+
+Four wide version of idMath::SinCos16
+====================
+*/
+static ID_INLINE void R_SinCos16_SSE( __m128 a, __m128& s, __m128& c )
+{
+	const __m128 vector_float_zero = _mm_setzero_ps();
+	const __m128 vector_float_one = _mm_set1_ps( 1.0f );
+	const __m128 vector_float_pi = _mm_set1_ps( idMath::PI );
+	const __m128 vector_float_two_pi = _mm_set1_ps( idMath::TWO_PI );
+	
+	// bring the angle into [0, TWO_PI)
+	const __m128 outside = _mm_or_ps( _mm_cmplt_ps( a, vector_float_zero ), _mm_cmpge_ps( a, vector_float_two_pi ) );
+	const __m128 q = _mm_mul_ps( a, _mm_set1_ps( idMath::ONEOVER_TWOPI ) );
+	__m128 fq = _mm_cvtepi32_ps( _mm_cvttps_epi32( q ) );
+	fq = _mm_sub_ps( fq, _mm_and_ps( _mm_cmpgt_ps( fq, q ), vector_float_one ) );
+	a = _mm_sel_ps( a, _mm_sub_ps( a, _mm_mul_ps( fq, vector_float_two_pi ) ), outside );
+	
+	// fold into [-HALF_PI, HALF_PI]
+	const __m128 belowPi = _mm_cmplt_ps( a, vector_float_pi );
+	const __m128 aboveHalfPi = _mm_cmpgt_ps( a, _mm_set1_ps( idMath::HALF_PI ) );
+	const __m128 aboveThreeHalfPi = _mm_cmpgt_ps( a, _mm_set1_ps( idMath::PI + idMath::HALF_PI ) );
+	const __m128 mirror = _mm_sel_ps( _mm_cmple_ps( a, _mm_set1_ps( idMath::PI + idMath::HALF_PI ) ), aboveHalfPi, belowPi );
+	const __m128 wrap = _mm_andnot_ps( belowPi, aboveThreeHalfPi );
+	a = _mm_sel_ps( a, _mm_sub_ps( vector_float_pi, a ), mirror );
+	a = _mm_sel_ps( a, _mm_sub_ps( a, vector_float_two_pi ), wrap );
+	const __m128 d = _mm_sel_ps( vector_float_one, _mm_set1_ps( -1.0f ), mirror );
+	
+	const __m128 t = _mm_mul_ps( a, a );
+	
+	__m128 ps = _mm_madd_ps( _mm_set1_ps( -2.39e-08f ), t, _mm_set1_ps( 2.7526e-06f ) );
+	ps = _mm_madd_ps( ps, t, _mm_set1_ps( -1.98409e-04f ) );
+	ps = _mm_madd_ps( ps, t, _mm_set1_ps( 8.3333315e-03f ) );
+	ps = _mm_madd_ps( ps, t, _mm_set1_ps( -1.666666664e-01f ) );
+	ps = _mm_madd_ps( ps, t, vector_float_one );
+	s = _mm_mul_ps( a, ps );
+	
+	__m128 pc = _mm_madd_ps( _mm_set1_ps( -2.605e-07f ), t, _mm_set1_ps( 2.47609e-05f ) );
+	pc = _mm_madd_ps( pc, t, _mm_set1_ps( -1.3888397e-03f ) );
+	pc = _mm_madd_ps( pc, t, _mm_set1_ps( 4.16666418e-02f ) );
+	pc = _mm_madd_ps( pc, t, _mm_set1_ps( -4.999999963e-01f ) );
+	pc = _mm_madd_ps( pc, t, vector_float_one );
+	c = _mm_mul_ps( d, pc );
+}
+
+#endif
+
+/*
+====================
+R_ParticleBatchColors
+
+Calculates the faded color of every particle in the batch and drops the
+ones that are completely faded out
+====================
+*/
+static void R_ParticleBatchColors( const idParticleStage* stage, const renderEntity_t* renderEntity, particleBatch_t& batch )
+{
+	const idVec4 baseColor = ( stage->entityColor ) ? idVec4( renderEntity->shaderParms[0], renderEntity->shaderParms[1], renderEntity->shaderParms[2], renderEntity->shaderParms[3] ) : stage->color;
+	
+#if defined(USE_INTRINSICS)
+	const __m128 vector_float_one = _mm_set1_ps( 1.0f );
+	const __m128 vector_float_255 = _mm_set1_ps( 255.0f );
+	const __m128 fadeIn = _mm_set1_ps( stage->fadeInFraction );
+	const __m128 fadeOut = _mm_set1_ps( stage->fadeOutFraction );
+	const __m128 fadeIndex = _mm_set1_ps( stage->fadeIndexFraction );
+	const __m128 totalParticles = _mm_set1_ps( ( float )stage->totalParticles );
+	const __m128i totalParticlesInt = _mm_set1_epi32( stage->totalParticles );
+	
+	for( int i = 0; i < batch.count; i += 4 )
+	{
+		const __m128 frac = _mm_load_ps( batch.frac + i );
+		__m128 fade = vector_float_one;
+		
+		// most particles fade in at the beginning and fade out at the end
+		fade = _mm_sel_ps( fade, _mm_mul_ps( fade, _mm_div_ps( frac, fadeIn ) ), _mm_cmplt_ps( frac, fadeIn ) );
+		const __m128 invFrac = _mm_sub_ps( vector_float_one, frac );
+		fade = _mm_sel_ps( fade, _mm_mul_ps( fade, _mm_div_ps( invFrac, fadeOut ) ), _mm_cmplt_ps( invFrac, fadeOut ) );
+		
+		if( stage->fadeIndexFraction )
+		{
+			const __m128i index = _mm_loadu_si128( ( const __m128i* )( batch.index + i ) );
+			const __m128 indexFrac = _mm_div_ps( _mm_cvtepi32_ps( _mm_sub_epi32( totalParticlesInt, index ) ), totalParticles );
+			fade = _mm_sel_ps( fade, _mm_mul_ps( fade, _mm_div_ps( indexFrac, fadeIndex ) ), _mm_cmplt_ps( indexFrac, fadeIndex ) );
+		}
+		
+		const __m128 invFade = _mm_sub_ps( vector_float_one, fade );
+		
+		__m128i packed = _mm_setzero_si128();
+		for( int j = 0; j < 4; j++ )
+		{
+			__m128 fcolor = _mm_add_ps( _mm_mul_ps( _mm_set1_ps( baseColor[j] ), fade ), _mm_mul_ps( _mm_set1_ps( stage->fadeColor[j] ), invFade ) );
+			fcolor = _mm_min_ps( _mm_max_ps( _mm_mul_ps( fcolor, vector_float_255 ), _mm_setzero_ps() ), vector_float_255 );
+			packed = _mm_or_si128( packed, _mm_slli_epi32( _mm_cvttps_epi32( fcolor ), j * 8 ) );
+		}
+		_mm_storeu_si128( ( __m128i* )( batch.color + i ), packed );
+	}
+#else
+	for( int i = 0; i < batch.count; i++ )
+	{
+		const float frac = batch.frac[i];
+		float fade = 1.0f;
+		
+		if( frac < stage->fadeInFraction )
+		{
+			fade *= ( frac / stage->fadeInFraction );
+		}
+		if( 1.0f - frac < stage->fadeOutFraction )
+		{
+			fade *= ( ( 1.0f - frac ) / stage->fadeOutFraction );
+		}
+		if( stage->fadeIndexFraction )
+		{
+			float indexFrac = ( stage->totalParticles - batch.index[i] ) / ( float )stage->totalParticles;
+			if( indexFrac < stage->fadeIndexFraction )
+			{
+				fade *= indexFrac / stage->fadeIndexFraction;
+			}
+		}
+		
+		byte color[4];
+		for( int j = 0; j < 4; j++ )
+		{
+			float fcolor = baseColor[j] * fade + stage->fadeColor[j] * ( 1.0f - fade );
+			color[j] = idMath::ClampInt( 0, 255, idMath::Ftoi( fcolor * 255.0f ) );
+		}
+		batch.color[i] = *reinterpret_cast<dword*>( color );
+	}
+#endif
+	
+	// if a particle is completely faded out, kill it
+	int numLive = 0;
+	for( int i = 0; i < batch.count; i++ )
+	{
+		if( batch.color[i] == 0 )
+		{
+			continue;
+		}
+		batch.index[numLive] = batch.index[i];
+		batch.seed[numLive] = batch.seed[i];
+		batch.color[numLive] = batch.color[i];
+		batch.frac[numLive] = batch.frac[i];
+		batch.age[numLive] = batch.age[i];
+		numLive++;
+	}
+	batch.count = numLive;
+}
+
+/*
+====================
+R_ParticleBatchRandoms
+
+Draws the random numbers for the origin and angle, in the order ParticleOrigin
+and ParticleVerts would have drawn them
+====================
+*/
+static void R_ParticleBatchRandoms( const idParticleStage* stage, particleBatch_t& batch )
+{
+	for( int i = 0; i < batch.count; i++ )
+	{
+		idRandom random( batch.seed[i] );
+		
+		switch( stage->distributionType )
+		{
+			case PDIST_RECT:
+			{
+				batch.rand[PRAND_DIST0][i] = ( stage->randomDistribution ) ? random.CRandomFloat() : 1.0f;
+				batch.rand[PRAND_DIST1][i] = ( stage->randomDistribution ) ? random.CRandomFloat() : 1.0f;
+				batch.rand[PRAND_DIST2][i] = ( stage->randomDistribution ) ? random.CRandomFloat() : 1.0f;
+				break;
+			}
+			case PDIST_CYLINDER:
+			{
+				batch.rand[PRAND_DIST0][i] = ( stage->randomDistribution ) ? random.CRandomFloat() : 1.0f;
+				batch.rand[PRAND_DIST1][i] = ( stage->randomDistribution ) ? random.CRandomFloat() : 1.0f;
+				batch.rand[PRAND_DIST2][i] = 0.0f;
+				break;
+			}
+			case PDIST_SPHERE:
+			{
+				float x = 1.0f, y = 1.0f, z = 1.0f;
+				if( stage->randomDistribution )
+				{
+					// iterating with rejection is the only way to get an even distribution over a sphere
+					do
+					{
+						x = random.CRandomFloat();
+						y = random.CRandomFloat();
+						z = random.CRandomFloat();
+					}
+					while( x * x + y * y + z * z > 1.0f );
+				}
+				batch.rand[PRAND_DIST0][i] = x;
+				batch.rand[PRAND_DIST1][i] = y;
+				batch.rand[PRAND_DIST2][i] = z;
+				break;
+			}
+		}
+		
+		if( stage->directionType == PDIR_CONE )
+		{
+			batch.rand[PRAND_CONE0][i] = random.CRandomFloat();
+			batch.rand[PRAND_CONE1][i] = random.CRandomFloat();
+		}
+		else
+		{
+			batch.rand[PRAND_CONE0][i] = 0.0f;
+			batch.rand[PRAND_CONE1][i] = 0.0f;
+		}
+		
+		batch.rand[PRAND_ANGLE][i] = ( stage->initialAngle ) ? 0.0f : random.RandomFloat();
+	}
+}
+
+/*
+====================
+R_ParticleBatchOrigins
+
+Standard path origin with offset, velocity and gravity, see idParticleStage::ParticleOrigin
+====================
+*/
+static void R_ParticleBatchOrigins( const idParticleStage* stage, const renderEntity_t* renderEntity, particleBatch_t& batch )
+{
+	const float ring = stage->distributionParms[3];
+	const float deltaSpeed = stage->speed.to - stage->speed.from;
+	
+	idVec3 gravity( 0.0f, 0.0f, -stage->gravity );
+	if( stage->worldGravity )
+	{
+		gravity *= renderEntity->axis.Transpose();
+	}
+	
+#if defined(USE_INTRINSICS)
+	const __m128 vector_float_zero = _mm_setzero_ps();
+	const __m128 vector_float_one = _mm_set1_ps( 1.0f );
+	const __m128 vector_float_ring = _mm_set1_ps( ring );
+	const __m128 vector_float_one_minus_ring = _mm_set1_ps( 1.0f - ring );
+	const __m128 vector_float_ring_sqr = _mm_set1_ps( ring * ring );
+	
+	for( int i = 0; i < batch.count; i += 4 )
+	{
+		const __m128 r0 = _mm_load_ps( batch.rand[PRAND_DIST0] + i );
+		const __m128 r1 = _mm_load_ps( batch.rand[PRAND_DIST1] + i );
+		const __m128 r2 = _mm_load_ps( batch.rand[PRAND_DIST2] + i );
+		
+		__m128 ox, oy, oz;
+		
+		switch( stage->distributionType )
+		{
+			case PDIST_RECT:
+			{
+				ox = r0;
+				oy = r1;
+				oz = r2;
+				break;
+			}
+			case PDIST_CYLINDER:
+			{
+				R_SinCos16_SSE( _mm_mul_ps( r0, _mm_set1_ps( idMath::TWO_PI ) ), ox, oy );
+				oz = r1;
+				if( ring > 0.0f )
+				{
+					// reproject points that are inside the ringFraction to the outer band
+					const __m128 radiusSqr = _mm_madd_ps( ox, ox, _mm_mul_ps( oy, oy ) );
+					const __m128 f = _mm_div_ps( _mm_sqrt_ps( radiusSqr ), vector_float_ring );
+					const __m128 rescale = _mm_mul_ps( _mm_div_ps( vector_float_one, f ), _mm_madd_ps( f, vector_float_one_minus_ring, vector_float_ring ) );
+					const __m128 inside = _mm_cmplt_ps( radiusSqr, vector_float_ring_sqr );
+					ox = _mm_sel_ps( ox, _mm_mul_ps( ox, rescale ), inside );
+					oy = _mm_sel_ps( oy, _mm_mul_ps( oy, rescale ), inside );
+				}
+				break;
+			}
+			default:
+			{
+				ox = r0;
+				oy = r1;
+				oz = r2;
+				if( ring > 0.0f )
+				{
+					const __m128 radiusSqr = _mm_madd_ps( ox, ox, _mm_madd_ps( oy, oy, _mm_mul_ps( oz, oz ) ) );
+					const __m128 f = _mm_div_ps( _mm_sqrt_ps( radiusSqr ), vector_float_ring );
+					const __m128 rescale = _mm_mul_ps( _mm_div_ps( vector_float_one, f ), _mm_madd_ps( f, vector_float_one_minus_ring, vector_float_ring ) );
+					const __m128 inside = _mm_cmplt_ps( radiusSqr, vector_float_ring_sqr );
+					ox = _mm_sel_ps( ox, _mm_mul_ps( ox, rescale ), inside );
+					oy = _mm_sel_ps( oy, _mm_mul_ps( oy, rescale ), inside );
+					oz = _mm_sel_ps( oz, _mm_mul_ps( oz, rescale ), inside );
+				}
+				break;
+			}
+		}
+		
+		// offset will effect all particle origin types
+		ox = _mm_madd_ps( ox, _mm_set1_ps( stage->distributionParms[0] ), _mm_set1_ps( stage->offset.x ) );
+		oy = _mm_madd_ps( oy, _mm_set1_ps( stage->distributionParms[1] ), _mm_set1_ps( stage->offset.y ) );
+		oz = _mm_madd_ps( oz, _mm_set1_ps( stage->distributionParms[2] ), _mm_set1_ps( stage->offset.z ) );
+		
+		// add the velocity over time
+		__m128 dx, dy, dz;
+		if( stage->directionType == PDIR_CONE )
+		{
+			const __m128 angle1 = _mm_mul_ps( _mm_load_ps( batch.rand[PRAND_CONE0] + i ), _mm_set1_ps( stage->directionParms[0] * idMath::M_DEG2RAD ) );
+			const __m128 angle2 = _mm_mul_ps( _mm_load_ps( batch.rand[PRAND_CONE1] + i ), _mm_set1_ps( idMath::PI ) );
+			
+			__m128 s1, c1, s2, c2;
+			R_SinCos16_SSE( angle1, s1, c1 );
+			R_SinCos16_SSE( angle2, s2, c2 );
+			
+			dx = _mm_mul_ps( s1, c2 );
+			dy = _mm_mul_ps( s1, s2 );
+			dz = c1;
+		}
+		else
+		{
+			const __m128 lengthSqr = _mm_madd_ps( ox, ox, _mm_madd_ps( oy, oy, _mm_mul_ps( oz, oz ) ) );
+			__m128 invLength = _mm_sqrt_ps( _mm_div_ps( vector_float_one, lengthSqr ) );
+			invLength = _mm_sel_ps( _mm_set1_ps( idMath::INFINITY ), invLength, _mm_cmpgt_ps( lengthSqr, _mm_set1_ps( idMath::FLT_SMALLEST_NON_DENORMAL ) ) );
+			
+			dx = _mm_mul_ps( ox, invLength );
+			dy = _mm_mul_ps( oy, invLength );
+			dz = _mm_add_ps( _mm_mul_ps( oz, invLength ), _mm_set1_ps( stage->directionParms[0] ) );
+		}
+		
+		const __m128 frac = _mm_load_ps( batch.frac + i );
+		const __m128 age = _mm_load_ps( batch.age + i );
+		
+		__m128 iSpeed = vector_float_zero;
+		if( stage->speed.table == NULL )
+		{
+			iSpeed = _mm_mul_ps( _mm_madd_ps( _mm_mul_ps( frac, _mm_set1_ps( deltaSpeed ) ), _mm_set1_ps( 0.5f ), _mm_set1_ps( stage->speed.from ) ), frac );
+		}
+		iSpeed = _mm_mul_ps( iSpeed, _mm_set1_ps( stage->particleLife ) );
+		
+		// add gravity
+		const __m128 ageSqr = _mm_mul_ps( age, age );
+		ox = _mm_madd_ps( dx, iSpeed, _mm_madd_ps( _mm_set1_ps( gravity.x ), ageSqr, ox ) );
+		oy = _mm_madd_ps( dy, iSpeed, _mm_madd_ps( _mm_set1_ps( gravity.y ), ageSqr, oy ) );
+		oz = _mm_madd_ps( dz, iSpeed, _mm_madd_ps( _mm_set1_ps( gravity.z ), ageSqr, oz ) );
+		
+		_mm_store_ps( batch.origin[0] + i, ox );
+		_mm_store_ps( batch.origin[1] + i, oy );
+		_mm_store_ps( batch.origin[2] + i, oz );
+	}
+#else
+	for( int i = 0; i < batch.count; i++ )
+	{
+		idVec3 origin( batch.rand[PRAND_DIST0][i], batch.rand[PRAND_DIST1][i], batch.rand[PRAND_DIST2][i] );
+		
+		if( stage->distributionType == PDIST_CYLINDER )
+		{
+			idMath::SinCos16( origin[0] * idMath::TWO_PI, origin[0], origin[1] );
+			origin[2] = batch.rand[PRAND_DIST1][i];
+			
+			float radiusSqr = origin[0] * origin[0] + origin[1] * origin[1];
+			if( ring > 0.0f && radiusSqr < ring * ring )
+			{
+				float f = idMath::Sqrt( radiusSqr ) / ring;
+				float rescale = ( 1.0f / f ) * ( ring + f * ( 1.0f - ring ) );
+				origin[0] *= rescale;
+				origin[1] *= rescale;
+			}
+		}
+		else if( stage->distributionType == PDIST_SPHERE )
+		{
+			float radiusSqr = origin.LengthSqr();
+			if( ring > 0.0f && radiusSqr < ring * ring )
+			{
+				float f = idMath::Sqrt( radiusSqr ) / ring;
+				origin *= ( 1.0f / f ) * ( ring + f * ( 1.0f - ring ) );
+			}
+		}
+		
+		origin[0] *= stage->distributionParms[0];
+		origin[1] *= stage->distributionParms[1];
+		origin[2] *= stage->distributionParms[2];
+		origin += stage->offset;
+		
+		idVec3 dir;
+		if( stage->directionType == PDIR_CONE )
+		{
+			float s1, c1, s2, c2;
+			idMath::SinCos16( batch.rand[PRAND_CONE0][i] * stage->directionParms[0] * idMath::M_DEG2RAD, s1, c1 );
+			idMath::SinCos16( batch.rand[PRAND_CONE1][i] * idMath::PI, s2, c2 );
+			dir.Set( s1 * c2, s1 * s2, c1 );
+		}
+		else
+		{
+			dir = origin;
+			dir.Normalize();
+			dir[2] += stage->directionParms[0];
+		}
+		
+		const float age = batch.age[i];
+		origin += dir * R_ParticleIntegrate( stage->speed, batch.frac[i] ) * stage->particleLife;
+		origin += gravity * age * age;
+		
+		batch.origin[0][i] = origin[0];
+		batch.origin[1][i] = origin[1];
+		batch.origin[2][i] = origin[2];
+	}
+#endif
+}
+
+/*
+====================
+R_ParticleBatchQuads
+
+Sized and rotated quad axes for every particle, see idParticleStage::ParticleVerts
+====================
+*/
+static void R_ParticleBatchQuads( const idParticleStage* stage, const renderEntity_t* renderEntity, const viewDef_t* viewDef, particleBatch_t& batch )
+{
+	ALIGN16( float width[PARTICLE_BATCH_SIZE] );
+	ALIGN16( float height[PARTICLE_BATCH_SIZE] );
+	ALIGN16( float angleMove[PARTICLE_BATCH_SIZE] );
+	
+	for( int i = 0; i < batch.count; i++ )
+	{
+		const float frac = batch.frac[i];
+		width[i] = R_EvalParticleSamples( stage->size, stage->sizeSamples, frac );
+		height[i] = width[i] * R_EvalParticleSamples( stage->aspect, stage->aspectSamples, frac );
+		angleMove[i] = R_ParticleIntegrate( stage->rotationSpeed, frac ) * stage->particleLife;
+		// have half the particles rotate each way
+		if( ( batch.index[i] & 1 ) == 0 )
+		{
+			angleMove[i] = -angleMove[i];
+		}
+	}
+	
+	// oriented in viewer space
+	idVec3 entityLeft, entityUp;
+	renderEntity->axis.ProjectVector( viewDef->renderView.viewaxis[1], entityLeft );
+	renderEntity->axis.ProjectVector( viewDef->renderView.viewaxis[2], entityUp );
+	
+#if defined(USE_INTRINSICS)
+	const __m128 vector_float_zero = _mm_setzero_ps();
+	const __m128 angleScale = _mm_set1_ps( idMath::PI / 180.0f );
+	
+	for( int i = 0; i < batch.count; i += 4 )
+	{
+		__m128 angle = ( stage->initialAngle ) ? _mm_set1_ps( stage->initialAngle ) : _mm_mul_ps( _mm_load_ps( batch.rand[PRAND_ANGLE] + i ), _mm_set1_ps( 360.0f ) );
+		angle = _mm_mul_ps( _mm_add_ps( angle, _mm_load_ps( angleMove + i ) ), angleScale );
+		
+		__m128 s, c;
+		R_SinCos16_SSE( angle, s, c );
+		
+		const __m128 w = _mm_load_ps( width + i );
+		const __m128 h = _mm_load_ps( height + i );
+		const __m128 ws = _mm_mul_ps( w, s );
+		const __m128 wc = _mm_mul_ps( w, c );
+		const __m128 hs = _mm_mul_ps( h, s );
+		const __m128 hc = _mm_mul_ps( h, c );
+		
+		__m128 lx, ly, lz, ux, uy, uz;
+		switch( stage->orientation )
+		{
+			case POR_Z:
+			{
+				lx = ws;
+				ly = wc;
+				lz = vector_float_zero;
+				ux = hc;
+				uy = _mm_sub_ps( vector_float_zero, hs );
+				uz = vector_float_zero;
+				break;
+			}
+			case POR_X:
+			{
+				lx = vector_float_zero;
+				ly = wc;
+				lz = ws;
+				ux = vector_float_zero;
+				uy = _mm_sub_ps( vector_float_zero, hs );
+				uz = hc;
+				break;
+			}
+			case POR_Y:
+			{
+				lx = wc;
+				ly = vector_float_zero;
+				lz = ws;
+				ux = _mm_sub_ps( vector_float_zero, hs );
+				uy = vector_float_zero;
+				uz = hc;
+				break;
+			}
+			default:
+			{
+				lx = _mm_madd_ps( _mm_set1_ps( entityLeft.x ), wc, _mm_mul_ps( _mm_set1_ps( entityUp.x ), ws ) );
+				ly = _mm_madd_ps( _mm_set1_ps( entityLeft.y ), wc, _mm_mul_ps( _mm_set1_ps( entityUp.y ), ws ) );
+				lz = _mm_madd_ps( _mm_set1_ps( entityLeft.z ), wc, _mm_mul_ps( _mm_set1_ps( entityUp.z ), ws ) );
+				ux = _mm_sub_ps( _mm_mul_ps( _mm_set1_ps( entityUp.x ), hc ), _mm_mul_ps( _mm_set1_ps( entityLeft.x ), hs ) );
+				uy = _mm_sub_ps( _mm_mul_ps( _mm_set1_ps( entityUp.y ), hc ), _mm_mul_ps( _mm_set1_ps( entityLeft.y ), hs ) );
+				uz = _mm_sub_ps( _mm_mul_ps( _mm_set1_ps( entityUp.z ), hc ), _mm_mul_ps( _mm_set1_ps( entityLeft.z ), hs ) );
+				break;
+			}
+		}
+		
+		_mm_store_ps( batch.left[0] + i, lx );
+		_mm_store_ps( batch.left[1] + i, ly );
+		_mm_store_ps( batch.left[2] + i, lz );
+		_mm_store_ps( batch.up[0] + i, ux );
+		_mm_store_ps( batch.up[1] + i, uy );
+		_mm_store_ps( batch.up[2] + i, uz );
+	}
+#else
+	for( int i = 0; i < batch.count; i++ )
+	{
+		float angle = ( stage->initialAngle ) ? stage->initialAngle : 360.0f * batch.rand[PRAND_ANGLE][i];
+		angle = ( angle + angleMove[i] ) * ( idMath::PI / 180.0f );
+		
+		float s, c;
+		idMath::SinCos16( angle, s, c );
+		
+		idVec3 left, up;
+		switch( stage->orientation )
+		{
+			case POR_Z:
+				left.Set( s, c, 0.0f );
+				up.Set( c, -s, 0.0f );
+				break;
+			case POR_X:
+				left.Set( 0.0f, c, s );
+				up.Set( 0.0f, -s, c );
+				break;
+			case POR_Y:
+				left.Set( c, 0.0f, s );
+				up.Set( -s, 0.0f, c );
+				break;
+			default:
+				left = entityLeft * c + entityUp * s;
+				up = entityUp * c - entityLeft * s;
+				break;
+		}
+		left *= width[i];
+		up *= height[i];
+		
+		batch.left[0][i] = left[0];
+		batch.left[1][i] = left[1];
+		batch.left[2][i] = left[2];
+		batch.up[0][i] = up[0];
+		batch.up[1][i] = up[1];
+		batch.up[2][i] = up[2];
+	}
+#endif
+}
+
+/*
+====================
+R_ParticleBatchVerts
+
+Writes the quads, and the cross faded animation quads, of the batch
+====================
+*/
+static int R_ParticleBatchVerts( const idParticleStage* stage, const particleBatch_t& batch, idDrawVert* verts )
+{
+	int numVerts = 0;
+	
+	for( int i = 0; i < batch.count; i++ )
+	{
+		idDrawVert* v = verts + numVerts;
+		
+		v[0].Clear();
+		v[1].Clear();
+		v[2].Clear();
+		v[3].Clear();
+		
+		v[0].SetColor( batch.color[i] );
+		v[1].SetColor( batch.color[i] );
+		v[2].SetColor( batch.color[i] );
+		v[3].SetColor( batch.color[i] );
+		
+		const idVec3 origin( batch.origin[0][i], batch.origin[1][i], batch.origin[2][i] );
+		const idVec3 left( batch.left[0][i], batch.left[1][i], batch.left[2][i] );
+		const idVec3 up( batch.up[0][i], batch.up[1][i], batch.up[2][i] );
+		
+		v[0].xyz = origin - left + up;
+		v[1].xyz = origin + left + up;
+		v[2].xyz = origin - left - up;
+		v[3].xyz = origin + left - up;
+		
+		if( stage->animationFrames <= 1 )
+		{
+			v[0].SetTexCoord( 0.0f, 0.0f );
+			v[1].SetTexCoord( 1.0f, 0.0f );
+			v[2].SetTexCoord( 0.0f, 1.0f );
+			v[3].SetTexCoord( 1.0f, 1.0f );
+			numVerts += 4;
+			continue;
+		}
+		
+		// strip animation, the second quad shows the next frame and they are cross faded
+		const float width = 1.0f / stage->animationFrames;
+		const float floatFrame = ( stage->animationRate ) ? batch.age[i] * stage->animationRate : batch.frac[i] * stage->animationFrames;
+		const int intFrame = ( int )floatFrame;
+		const float frac = floatFrame - intFrame;
+		const float iFrac = 1.0f - frac;
+		const float s = width * intFrame;
+		
+		v[0].SetTexCoord( s, 0.0f );
+		v[1].SetTexCoord( s + width, 0.0f );
+		v[2].SetTexCoord( s, 1.0f );
+		v[3].SetTexCoord( s + width, 1.0f );
+		
+		for( int j = 0; j < 4; j++ )
+		{
+			v[4 + j] = v[j];
+			
+			const idVec2 st = v[4 + j].GetTexCoord();
+			v[4 + j].SetTexCoord( st.x + width, st.y );
+			
+			for( int k = 0; k < 4; k++ )
+			{
+				v[4 + j].color[k] *= frac;
+				v[j].color[k] *= iFrac;
+			}
+		}
+		numVerts += 8;
+	}
+	
+	return numVerts;
+}
+
+/*
+====================
+R_FlushParticleBatch
+
+Returns the number of verts written
+====================
+*/
+static int R_FlushParticleBatch( const idParticleStage* stage, const renderEntity_t* renderEntity, const viewDef_t* viewDef, particleBatch_t& batch, idDrawVert* verts )
+{
+	// pad the batch to a multiple of four with harmless particles
+	for( int i = batch.count; i < ( ( batch.count + 3 ) & ~3 ); i++ )
+	{
+		batch.index[i] = 0;
+		batch.frac[i] = 0.5f;
+		batch.age[i] = 0.0f;
+	}
+	
+	R_ParticleBatchColors( stage, renderEntity, batch );
+	
+	if( batch.count > 0 )
+	{
+		R_ParticleBatchRandoms( stage, batch );
+		
+		for( int i = batch.count; i < ( ( batch.count + 3 ) & ~3 ); i++ )
+		{
+			batch.index[i] = 0;
+			batch.frac[i] = 0.5f;
+			batch.age[i] = 0.0f;
+			for( int j = 0; j < PRAND_COUNT; j++ )
+			{
+				batch.rand[j][i] = 0.5f;
+			}
+		}
+		
+		R_ParticleBatchOrigins( stage, renderEntity, batch );
+		R_ParticleBatchQuads( stage, renderEntity, viewDef, batch );
+	}
+	
+	const int numVerts = R_ParticleBatchVerts( stage, batch, verts );
+	
+	batch.count = 0;
+	
+	return numVerts;
+}
+
 /*
 ====================
 idRenderModelPrt::idRenderModelPrt
@@ -73,7 +884,7 @@ idRenderModelPrt::InstantiateDynamicModel
 */
 idRenderModel* idRenderModelPrt::InstantiateDynamicModel( const struct renderEntity_s* renderEntity, const viewDef_t* viewDef, idRenderModel* cachedModel )
 {
-	idRenderModelStatic*	staticModel;
+	idRenderModelPrtSnapshot*	staticModel;
 	
 	if( cachedModel && !r_useCachedDynamicModels.GetBool() )
 	{
@@ -105,19 +916,32 @@ idRenderModel* idRenderModelPrt::InstantiateDynamicModel( const struct renderEnt
 	if( cachedModel != NULL )
 	{
 	
-		assert( dynamic_cast<idRenderModelStatic*>( cachedModel ) != NULL );
+		assert( dynamic_cast<idRenderModelPrtSnapshot*>( cachedModel ) != NULL );
 		assert( idStr::Icmp( cachedModel->Name(), parametricParticle_SnapshotName ) == 0 );
 		
-		staticModel = static_cast<idRenderModelStatic*>( cachedModel );
+		staticModel = static_cast<idRenderModelPrtSnapshot*>( cachedModel );
 		
 	}
 	else
 	{
 	
-		staticModel = new( TAG_MODEL ) idRenderModelStatic;
+		staticModel = new( TAG_MODEL ) idRenderModelPrtSnapshot;
 		staticModel->InitEmpty( parametricParticle_SnapshotName );
 	}
 	
+	// mirrors, subviews and paused game time regenerate from the same inputs, so the
+	// previous snapshot can be reused, the vertex caches are refreshed by the caller
+	particleSnapshotKey_t key;
+	R_ParticleSnapshotKey( particleSystem, renderEntity, viewDef, key );
+	if( staticModel->keyValid && memcmp( &key, &staticModel->key, sizeof( key ) ) == 0 )
+	{
+		return staticModel;
+	}
+	staticModel->key = key;
+	staticModel->keyValid = true;
+	
+	particleBatch_t batch;
+	
 	particleGen_t g;
 	
 	g.renderEnt = renderEntity;
@@ -170,11 +994,27 @@ idRenderModel* idRenderModelPrt::InstantiateDynamicModel( const struct renderEnt
 			surf->geometry = R_AllocStaticTriSurf();
 			R_AllocStaticTriSurfVerts( surf->geometry, 4 * count );
 			R_AllocStaticTriSurfIndexes( surf->geometry, 6 * count );
+			
+			// the quads are always in the same order, so the indexes only need to be built once
+			triIndex_t* indexes = surf->geometry->indexes;
+			for( int i = 0; i < 4 * count; i += 4 )
+			{
+				indexes[0] = i + 0;
+				indexes[1] = i + 2;
+				indexes[2] = i + 3;
+				indexes[3] = i + 0;
+				indexes[4] = i + 3;
+				indexes[5] = i + 1;
+				indexes += 6;
+			}
 		}
 		
 		int numVerts = 0;
 		idDrawVert* verts = surf->geometry->verts;
 		
+		const bool useBatch = R_ParticleStageCanBatch( stage );
+		batch.count = 0;
+		
 		for( int index = 0; index < stage->totalParticles; index++ )
 		{
 			g.index = index;
@@ -235,30 +1075,34 @@ idRenderModel* idRenderModelPrt::InstantiateDynamicModel( const struct renderEnt
 			
 			g.age = g.frac * stage->particleLife;
 			
+			if( useBatch )
+			{
+				batch.index[batch.count] = index;
+				batch.seed[batch.count] = g.random.GetSeed();
+				batch.frac[batch.count] = g.frac;
+				batch.age[batch.count] = g.age;
+				if( ++batch.count == PARTICLE_BATCH_SIZE )
+				{
+					numVerts += R_FlushParticleBatch( stage, renderEntity, viewDef, batch, verts + numVerts );
+				}
+				continue;
+			}
+			
 			// if the particle doesn't get drawn because it is faded out or beyond a kill region, don't increment the verts
 			numVerts += stage->CreateParticle( &g, verts + numVerts );
 		}
 		
-		// numVerts must be a multiple of 4
-		assert( ( numVerts & 3 ) == 0 && numVerts <= 4 * count );
-		
-		// build the indexes
-		int	numIndexes = 0;
-		triIndex_t* indexes = surf->geometry->indexes;
-		for( int i = 0; i < numVerts; i += 4 )
+		if( batch.count > 0 )
 		{
-			indexes[numIndexes + 0] = i + 0;
-			indexes[numIndexes + 1] = i + 2;
-			indexes[numIndexes + 2] = i + 3;
-			indexes[numIndexes + 3] = i + 0;
-			indexes[numIndexes + 4] = i + 3;
-			indexes[numIndexes + 5] = i + 1;
-			numIndexes += 6;
+			numVerts += R_FlushParticleBatch( stage, renderEntity, viewDef, batch, verts + numVerts );
 		}
 		
+		// numVerts must be a multiple of 4
+		assert( ( numVerts & 3 ) == 0 && numVerts <= 4 * count );
+		
 		surf->geometry->tangentsCalculated = false;
 		surf->geometry->numVerts = numVerts;
-		surf->geometry->numIndexes = numIndexes;
+		surf->geometry->numIndexes = numVerts / 4 * 6;
 		surf->geometry->bounds = stage->bounds;		// just always draw the particles
 	}
 	
@@ -46,6 +46,12 @@ void idImage::SubImageUpload( int mipLevel, int x, int y, int z, int width, int
 {
 	assert( x >= 0 && y >= 0 && mipLevel >= 0 && width >= 0 && height >= 0 && mipLevel < opts.numLevels );
 	
+	// the null renderer has no texture storage to upload into
+	if( r_nullRenderer.GetBool() )
+	{
+		return;
+	}
+	
 	int compressedSize = 0;
 	
 	if( IsCompressed() )
@@ -167,6 +173,11 @@ idImage::SetTexParameters
 */
 void idImage::SetTexParameters()
 {
+	if( r_nullRenderer.GetBool() )
+	{
+		return;
+	}
+	
 	int target = GL_TEXTURE_2D;
 	switch( opts.textureType )
 	{
@@ -503,6 +514,15 @@ void idImage::AllocImage()
 		return;
 	}
 	
+	// the null renderer never touches GL, but hands out a unique name
+	// so the image counts as loaded and is never reloaded on demand
+	if( r_nullRenderer.GetBool() )
+	{
+		static GLuint nullTexnum = 0;
+		texnum = ++nullTexnum;
+		return;
+	}
+	
 	// generate the texture number
 	glGenTextures( 1, ( GLuint* )&texnum );
 	assert( texnum != TEXTURE_NOT_LOADED );
@@ -633,9 +653,15 @@ idImage::PurgeImage
 */
 void idImage::PurgeImage()
 {
+	// never delete storage another image still uses
+	ReleaseSharedStorage();
+	
 	if( texnum != TEXTURE_NOT_LOADED )
 	{
-		glDeleteTextures( 1, ( GLuint* )&texnum );	// this should be the ONLY place it is ever called!
+		if( !r_nullRenderer.GetBool() )
+		{
+			glDeleteTextures( 1, ( GLuint* )&texnum );	// this should be the ONLY place it is ever called!
+		}
 		texnum = TEXTURE_NOT_LOADED;
 	}
 	// clear all the current binding caches, so the next bind will do a real one
@@ -55,6 +55,9 @@ idRenderEntityLocal::idRenderEntityLocal()
 	firstInteraction		= NULL;
 	lastInteraction			= NULL;
 	needsPortalSky			= false;
+	staticBatch				= -1;
+	memset( registerCache, 0, sizeof( registerCache ) );
+	nextRegisterCache		= 0;
 }
 
 void idRenderEntityLocal::FreeRenderEntity()
@@ -108,6 +111,10 @@ idRenderLightLocal::idRenderLightLocal()
 	firstInteraction		= NULL;
 	lastInteraction			= NULL;
 	
+	entityRefCacheGeneration		= 0;
+	entityRefCacheConnectedAreaNum	= 0;
+	entityRefCacheConnectedMode		= 0;
+	
 	baseLightProject.Zero();
 	inverseBaseLightProject.Zero();
 }
@@ -493,6 +493,11 @@ void idRenderProgManager::Unbind()
 	currentVertexShader = -1;
 	currentFragmentShader = -1;
 	
+	if( r_nullRenderer.GetBool() )
+	{
+		return;
+	}
+	
 	glUseProgram( 0 );
 }
 
@@ -1702,7 +1702,12 @@ idRenderProgManager::LoadGLSLShader
 */
 GLuint idRenderProgManager::LoadGLSLShader( GLenum target, const char* name, const char* nameOutSuffix, uint32 shaderFeatures, bool builtin, idList<int>& uniforms )
 {
-
+	// the null renderer never draws, so skip the conversion and compile
+	if( r_nullRenderer.GetBool() )
+	{
+		return INVALID_PROGID;
+	}
+	
 	idStr inFile;
 	idStr outFileHLSL;
 	idStr outFileGLSL;
@@ -2121,6 +2126,16 @@ void idRenderProgManager::LoadGLSLProgram( const int programIndex, const int ver
 		return; // Already loaded
 	}
 	
+	if( r_nullRenderer.GetBool() )
+	{
+		// keep the shader indexes so FindGLSLProgram still matches, but don't link anything
+		prog.name = vertexShaders[ vertexShaderIndex ].name;
+		prog.name.StripFileExtension();
+		prog.fragmentShaderIndex = fragmentShaderIndex;
+		prog.vertexShaderIndex = vertexShaderIndex;
+		return;
+	}
+	
 	GLuint vertexProgID = ( vertexShaderIndex != -1 ) ? vertexShaders[ vertexShaderIndex ].progId : INVALID_PROGID;
 	GLuint fragmentProgID = ( fragmentShaderIndex != -1 ) ? fragmentShaders[ fragmentShaderIndex ].progId : INVALID_PROGID;
 	
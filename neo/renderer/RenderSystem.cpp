@@ -58,13 +58,15 @@ static void R_PerformanceCounters()
 	
 	if( r_showDynamic.GetBool() )
 	{
-		common->Printf( "callback:%i md5:%i dfrmVerts:%i dfrmTris:%i tangTris:%i guis:%i\n",
+		common->Printf( "callback:%i md5:%i dfrmVerts:%i dfrmTris:%i tangTris:%i guis:%i guiSurfs:%i guiBatches:%i\n",
 						tr.pc.c_entityDefCallbacks,
 						tr.pc.c_generateMd5,
 						tr.pc.c_deformedVerts,
 						tr.pc.c_deformedIndexes / 3,
 						tr.pc.c_tangentIndexes / 3,
-						tr.pc.c_guiSurfs
+						tr.pc.c_guiSurfs,
+						tr.pc.c_guiModelSurfaces,
+						tr.pc.c_guiModelBatches
 					  );
 	}
 	
@@ -126,7 +128,11 @@ void idRenderSystemLocal::RenderCommandBuffers( const emptyCommand_t* const cmdH
 	
 	// r_skipRender is usually more usefull, because it will still
 	// draw 2D graphics
-	if( !r_skipBackEnd.GetBool() )
+	if( r_nullRenderer.GetBool() )
+	{
+		RB_ExecuteNullBackEndCommands( cmdHead );
+	}
+	else if( !r_skipBackEnd.GetBool() )
 	{
 #if !defined(USE_GLES2) && !defined(USE_GLES3)
 		if( glConfig.timerQueryAvailable )
@@ -296,7 +302,7 @@ static void R_CheckCvars()
 		}
 	}
 	
-	if( r_antiAliasing.IsModified() )
+	if( r_antiAliasing.IsModified() && !r_nullRenderer.GetBool() )
 	{
 		switch( r_antiAliasing.GetInteger() )
 		{
@@ -742,7 +748,7 @@ void idRenderSystemLocal::SwapCommandBuffers_FinishRendering(
 	
 	
 	// After coming back from an autoswap, we won't have anything to render
-	if( frameData->cmdHead->next != NULL )
+	if( frameData->cmdHead->next != NULL && !r_nullRenderer.GetBool() )
 	{
 		// wait for our fence to hit, which means the swap has actually happened
 		// We must do this before clearing any resources the GPU may be using
@@ -1084,7 +1090,7 @@ idRenderSystemLocal::CaptureRenderToFile
 */
 void idRenderSystemLocal::CaptureRenderToFile( const char* fileName, bool fixAlpha )
 {
-	if( !R_IsInitialized() )
+	if( !R_IsInitialized() || r_nullRenderer.GetBool() )
 	{
 		return;
 	}
@@ -85,6 +85,8 @@ idCVar r_useSilRemap( "r_useSilRemap", "1", CVAR_RENDERER | CVAR_BOOL, "consider
 idCVar r_useNodeCommonChildren( "r_useNodeCommonChildren", "1", CVAR_RENDERER | CVAR_BOOL, "stop pushing reference bounds early when possible" );
 idCVar r_useShadowSurfaceScissor( "r_useShadowSurfaceScissor", "1", CVAR_RENDERER | CVAR_BOOL, "scissor shadows by the scissor rect of the interaction surfaces" );
 idCVar r_useCachedDynamicModels( "r_useCachedDynamicModels", "1", CVAR_RENDERER | CVAR_BOOL, "cache snapshots of dynamic models" );
+idCVar r_useCachedShaderRegisters( "r_useCachedShaderRegisters", "1", CVAR_RENDERER | CVAR_BOOL, "evaluate the registers of a material once per entity and frame" );
+idCVar r_useParticleBatches( "r_useParticleBatches", "1", CVAR_RENDERER | CVAR_BOOL, "evaluate particle stages four particles at a time with SIMD" );
 idCVar r_useSeamlessCubeMap( "r_useSeamlessCubeMap", "1", CVAR_RENDERER | CVAR_BOOL, "use ARB_seamless_cube_map if available" );
 idCVar r_useSRGB( "r_useSRGB", "0", CVAR_RENDERER | CVAR_INTEGER | CVAR_ARCHIVE, "1 = both texture and framebuffer, 2 = framebuffer only, 3 = texture only" );
 idCVar r_maxAnisotropicFiltering( "r_maxAnisotropicFiltering", "8", CVAR_RENDERER | CVAR_ARCHIVE | CVAR_INTEGER, "limit aniso filtering" );
@@ -113,6 +115,7 @@ idCVar r_skipInteractions( "r_skipInteractions", "0", CVAR_RENDERER | CVAR_BOOL,
 idCVar r_skipDynamicTextures( "r_skipDynamicTextures", "0", CVAR_RENDERER | CVAR_BOOL, "don't dynamically create textures" );
 idCVar r_skipCopyTexture( "r_skipCopyTexture", "0", CVAR_RENDERER | CVAR_BOOL, "do all rendering, but don't actually copyTexSubImage2D" );
 idCVar r_skipBackEnd( "r_skipBackEnd", "0", CVAR_RENDERER | CVAR_BOOL, "don't draw anything" );
+idCVar r_nullRenderer( "r_nullRenderer", "0", CVAR_RENDERER | CVAR_INIT | CVAR_BOOL, "run the full frontend without a window or GL context, for headless benchmarking" );
 idCVar r_skipRender( "r_skipRender", "0", CVAR_RENDERER | CVAR_BOOL, "skip 3D rendering, but pass 2D" );
 // RB begin
 idCVar r_skipRenderContext( "r_skipRenderContext", "0", CVAR_RENDERER | CVAR_BOOL, "DISABLED: NULL the rendering context during backend 3D rendering" );
@@ -818,6 +821,99 @@ safeMode:
 
 idStr extensions_string;
 
+/*
+==================
+R_InitNullRenderer
+
+Sets up a renderer without a window or GL context.  The frontend, the
+vertex cache and the frame data all run as usual, but images, buffers
+and programs never reach the driver and the backend only consumes the
+command buffer.  Used with timedemo to benchmark the frontend and game
+code on machines without a GPU.
+==================
+*/
+static void R_InitNullRenderer()
+{
+	common->Printf( "Using null renderer\n" );
+	
+	glConfig.vendor_string = "null";
+	glConfig.renderer_string = "null";
+	glConfig.version_string = "0.0";
+	glConfig.shading_language_string = "0.0";
+	glConfig.extensions_string = "";
+	glConfig.wgl_extensions_string = "";
+	
+	glConfig.glVersion = 0.0f;
+	glConfig.vendor = VENDOR_NVIDIA;
+	glConfig.driverType = GLDRV_OPENGL3X;
+	
+	glConfig.maxTextureSize = 16384;
+	glConfig.maxTextureCoords = 8;
+	glConfig.maxTextureImageUnits = 16;
+	glConfig.uniformBufferOffsetAlignment = 256;
+	glConfig.maxTextureAnisotropy = 1.0f;
+	
+	glConfig.colorBits = 32;
+	glConfig.depthBits = 24;
+	glConfig.stencilBits = 8;
+	
+	// leave the optional capabilities off so nothing probes for them
+	glConfig.multitextureAvailable = false;
+	glConfig.directStateAccess = false;
+	glConfig.textureCompressionAvailable = false;
+	glConfig.anisotropicFilterAvailable = false;
+	glConfig.textureLODBiasAvailable = false;
+	glConfig.seamlessCubeMapAvailable = false;
+	glConfig.sRGBFramebufferAvailable = false;
+	glConfig.vertexBufferObjectAvailable = false;
+	glConfig.mapBufferRangeAvailable = false;
+	glConfig.vertexArrayObjectAvailable = false;
+	glConfig.drawElementsBaseVertexAvailable = false;
+	glConfig.fragmentProgramAvailable = false;
+	glConfig.glslAvailable = false;
+	glConfig.uniformBufferAvailable = true;
+	glConfig.twoSidedStencilAvailable = false;
+	glConfig.depthBoundsTestAvailable = false;
+	glConfig.syncAvailable = false;
+	glConfig.timerQueryAvailable = false;
+	glConfig.occlusionQueryAvailable = false;
+	glConfig.debugOutputAvailable = false;
+	glConfig.swapControlTearAvailable = false;
+	glConfig.gremedyStringMarkerAvailable = false;
+	glConfig.vertexHalfFloatAvailable = false;
+	glConfig.framebufferObjectAvailable = false;
+	glConfig.maxRenderbufferSize = 16384;
+	glConfig.maxColorAttachments = 8;
+	glConfig.framebufferBlitAvailable = false;
+	
+	// match a typical GL3 desktop so the frontend takes the same skinning path
+	glConfig.gpuSkinningAvailable = true;
+	
+	glConfig.stereo3Dmode = STEREO3D_OFF;
+	glConfig.nativeScreenWidth = r_customWidth.GetInteger();
+	glConfig.nativeScreenHeight = r_customHeight.GetInteger();
+	glConfig.displayFrequency = 60;
+	glConfig.isFullscreen = 0;
+	glConfig.isStereoPixelFormat = false;
+	glConfig.stereoPixelFormatAvailable = false;
+	glConfig.multisamples = 0;
+	glConfig.physicalScreenWidthInCentimeters = 100.0f;
+	glConfig.pixelAspect = 1.0f;
+	
+	r_initialized = true;
+	
+	// the event loop and the game controllers work without a window
+	Sys_InitInput();
+	
+	// programs are still registered so materials can reference them,
+	// the GLSL compile and link steps are skipped
+	renderProgManager.Init();
+	
+	vertexCache.Init();
+	
+	R_InitFrameData();
+}
+
 /*
 ==================
 R_InitOpenGL
@@ -844,6 +940,12 @@ void R_InitOpenGL()
 		common->FatalError( "R_InitOpenGL called while active" );
 	}
 	
+	if( r_nullRenderer.GetBool() )
+	{
+		R_InitNullRenderer();
+		return;
+	}
+	
 	// DG: make sure SDL has setup video so getting supported modes in R_SetNewMode() works
 	GLimp_PreInit();
 	// DG end
@@ -962,7 +1064,7 @@ bool GL_CheckErrors_( const char* filename, int line )
 	char	s[64];
 	int		i;
 	
-	if( r_ignoreGLErrors.GetBool() )
+	if( r_ignoreGLErrors.GetBool() || r_nullRenderer.GetBool() )
 	{
 		return false;
 	}
@@ -1390,6 +1492,12 @@ void idRenderSystemLocal::TakeScreenshot( int width, int height, const char* fil
 	int			i, j, c, temp;
 	idStr finalFileName;
 	
+	if( r_nullRenderer.GetBool() )
+	{
+		common->Printf( "Screenshots are not available with the null renderer\n" );
+		return;
+	}
+	
 	finalFileName.Format( "%s.%s", fileName, fileExten[exten] );
 	
 	takingScreenshot = true;
@@ -2161,6 +2269,11 @@ void R_SetColorMappings()
 		tr.gammaTable[i] = idMath::ClampInt( 0, 0xFFFF, inf );
 	}
 	
+	if( r_nullRenderer.GetBool() )
+	{
+		return;
+	}
+	
 	GLimp_SetGamma( tr.gammaTable, tr.gammaTable, tr.gammaTable );
 }
 
@@ -2298,7 +2411,7 @@ R_VidRestart_f
 void R_VidRestart_f( const idCmdArgs& args )
 {
 	// if OpenGL isn't started, do nothing
-	if( !R_IsInitialized() )
+	if( !R_IsInitialized() || r_nullRenderer.GetBool() )
 	{
 		return;
 	}
@@ -2505,6 +2618,8 @@ void R_InitCommands()
 	cmdSystem->AddCommand( "testVideo", R_TestVideo_f, CMD_FL_RENDERER | CMD_FL_CHEAT, "displays the given cinematic", idCmdSystem::ArgCompletion_VideoName );
 	cmdSystem->AddCommand( "reportSurfaceAreas", R_ReportSurfaceAreas_f, CMD_FL_RENDERER, "lists all used materials sorted by surface area" );
 	cmdSystem->AddCommand( "showInteractionMemory", R_ShowInteractionMemory_f, CMD_FL_RENDERER, "shows memory used by interactions" );
+	cmdSystem->AddCommand( "testDeriveTangents", R_TestDeriveTangents_f, CMD_FL_RENDERER, "compares the fast normal and tangent derivation with the reference code" );
+	cmdSystem->AddCommand( "benchmarkShadowVolumes", R_BenchmarkShadowVolumes_f, CMD_FL_RENDERER, "captures the dynamic shadow volume jobs of a frame and times them serially, in parallel and split" );
 	cmdSystem->AddCommand( "vid_restart", R_VidRestart_f, CMD_FL_RENDERER, "restarts renderSystem" );
 	cmdSystem->AddCommand( "listRenderEntityDefs", R_ListRenderEntityDefs_f, CMD_FL_RENDERER, "lists the entity defs" );
 	cmdSystem->AddCommand( "listRenderLightDefs", R_ListRenderLightDefs_f, CMD_FL_RENDERER, "lists the light defs" );
@@ -2562,6 +2677,7 @@ void idRenderSystemLocal::Clear()
 	}
 	
 	frontEndJobList = NULL;
+	loadJobList = NULL;
 }
 
 /*
@@ -2828,6 +2944,7 @@ void idRenderSystemLocal::Init()
 	}
 	
 	frontEndJobList = parallelJobManager->AllocJobList( JOBLIST_RENDERER_FRONTEND, JOBLIST_PRIORITY_MEDIUM, 2048, 0, NULL );
+	loadJobList = parallelJobManager->AllocJobList( JOBLIST_UTILITY, JOBLIST_PRIORITY_MEDIUM, 2048, 0, NULL );
 	
 	// make sure the command buffers are ready to accept the first screen update
 	SwapCommandBuffers( NULL, NULL, NULL, NULL );
@@ -2875,6 +2992,7 @@ void idRenderSystemLocal::Shutdown()
 	delete guiModel;
 	
 	parallelJobManager->FreeJobList( frontEndJobList );
+	parallelJobManager->FreeJobList( loadJobList );
 	
 	Clear();
 	
@@ -3017,6 +3135,11 @@ void idRenderSystemLocal::InitOpenGL()
 		// Reloading images here causes the rendertargets to get deleted. Figure out how to handle this properly on 360
 		globalImages->ReloadImages( true );
 		
+		if( r_nullRenderer.GetBool() )
+		{
+			return;
+		}
+		
 		int err = glGetError();
 		if( err != GL_NO_ERROR )
 		{
@@ -3034,7 +3157,10 @@ void idRenderSystemLocal::ShutdownOpenGL()
 {
 	// free the context and close the window
 	R_ShutdownFrameData();
-	GLimp_Shutdown();
+	if( !r_nullRenderer.GetBool() )
+	{
+		GLimp_Shutdown();
+	}
 	r_initialized = false;
 }
 
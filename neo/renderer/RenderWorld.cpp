@@ -150,6 +150,8 @@ idRenderWorldLocal::idRenderWorldLocal()
 	
 	portalAreas = NULL;
 	numPortalAreas = 0;
+	connectedAreaNum = 0;
+	entityRefGeneration = 1;
 	
 	doublePortals = NULL;
 	numInterAreaPortals = 0;
@@ -321,12 +323,19 @@ void idRenderWorldLocal::UpdateEntityDef( qhandle_t entityHandle, const renderEn
 					// only clear the dynamic model and interaction surfaces if they exist
 					c_callbackUpdate++;
 					R_ClearEntityDefDynamicModel( def );
+					R_ClearEntityDefRegisterCache( def );
 					def->parms = *re;
 					return;
 				}
 			}
 		}
 		
+		// the entity is no longer static, so its batch goes back to separate entities
+		if( def->staticBatch != -1 )
+		{
+			BreakStaticBatch( def->staticBatch );
+		}
+		
 		// save any decals if the model is the same, allowing marks to move with entities
 		if( def->parms.hModel == re->hModel )
 		{
@@ -348,6 +357,7 @@ void idRenderWorldLocal::UpdateEntityDef( qhandle_t entityHandle, const renderEn
 	}
 	
 	def->parms = *re;
+	R_ClearEntityDefRegisterCache( def );
 	
 	def->lastModifiedFrameNum = tr.frameCount;
 	def->archived = false;
@@ -395,6 +405,11 @@ void idRenderWorldLocal::FreeEntityDef( qhandle_t entityHandle )
 		return;
 	}
 	
+	if( def->staticBatch != -1 )
+	{
+		BreakStaticBatch( def->staticBatch );
+	}
+	
 	R_FreeEntityDefDerivedData( def, false, false );
 	
 	if( common->WriteDemo() && def->archived )
@@ -700,6 +715,13 @@ void idRenderWorldLocal::ProjectDecal( qhandle_t entityHandle, const idFixedWind
 		return;
 	}
 	
+	// merged entities are drawn by their batch, which is in world space
+	if( def->staticBatch != -1 )
+	{
+		ProjectDecal( staticBatches[ def->staticBatch ].entityHandle, winding, projectionOrigin, parallel, fadeDepth, material, startTime );
+		return;
+	}
+	
 	const idRenderModel* model = def->parms.hModel;
 	
 	if( model == NULL || model->IsDynamicModel() != DM_STATIC || def->parms.callback != NULL )
@@ -1705,6 +1727,9 @@ void idRenderWorldLocal::AddEntityRefToArea( idRenderEntityLocal* def, portalAre
 	ref->areaPrev = area->entityRefs.areaPrev;
 	ref->areaNext->areaPrev = ref;
 	ref->areaPrev->areaNext = ref;
+	
+	// lights touching this area have to rebuild their cached entity lists
+	area->entityRefGeneration = ++entityRefGeneration;
 }
 
 /*
@@ -1758,6 +1783,10 @@ void idRenderWorldLocal::GenerateAllInteractions()
 	
 	generateAllInteractionsCalled = false;
 	
+	// everything is spawned, so the static models can be merged before
+	// their interactions are created
+	MergeStaticEntityDefs();
+	
 	// let the interaction creation code know that it shouldn't
 	// try and do any view specific optimizations
 	tr.viewDef = NULL;
@@ -159,6 +159,7 @@ typedef struct renderEntity_s
 	// this automatically implies noShadow
 	bool					noOverlays;				// force no overlays on this model
 	bool					skipMotionBlur;			// Mask out this object during motion blur
+	bool					allowStaticMerge;		// never changes, may be merged with other static models at level load
 	int						forceUpdate;			// force an update (NOTE: not a bool to keep this struct a multiple of 4 bytes)
 	int						timeGroup;
 	int						xrayIndex;
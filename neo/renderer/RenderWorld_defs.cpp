@@ -126,6 +126,7 @@ void R_FreeEntityDefDerivedData( idRenderEntityLocal* def, bool keepDecals, bool
 		// unlink from the area
 		ref->areaNext->areaPrev = ref->areaPrev;
 		ref->areaPrev->areaNext = ref->areaNext;
+		ref->area->entityRefGeneration = ++def->world->entityRefGeneration;
 		
 		// put it back on the free list for reuse
 		def->world->areaReferenceAllocator.Free( ref );
@@ -527,6 +528,9 @@ void R_FreeLightDefDerivedData( idRenderLightLocal* ldef )
 		ldef->world->areaReferenceAllocator.Free( lref );
 	}
 	ldef->references = NULL;
+	
+	// the cached entity list is only valid for the old light volume
+	ldef->entityRefCacheGeneration = 0;
 }
 
 // RB begin
@@ -771,6 +775,9 @@ void R_FreeDerivedData()
 	{
 		idRenderWorldLocal* rw = tr.worlds[j];
 		
+		// the merged models are built from the models that are about to be reloaded
+		rw->FreeStaticBatches();
+		
 		for( int i = 0; i < rw->entityDefs.Num(); i++ )
 		{
 			idRenderEntityLocal* def = rw->entityDefs[i];
@@ -414,9 +414,11 @@ idRenderWorldLocal::SetupAreaRefs
 void idRenderWorldLocal::SetupAreaRefs()
 {
 	connectedAreaNum = 0;
+	entityRefGeneration = 1;
 	for( int i = 0; i < numPortalAreas; i++ )
 	{
 		portalAreas[i].areaNum = i;
+		portalAreas[i].entityRefGeneration = 0;
 		portalAreas[i].lightRefs.areaNext =
 			portalAreas[i].lightRefs.areaPrev = &portalAreas[i].lightRefs;
 		portalAreas[i].entityRefs.areaNext =
@@ -753,6 +755,8 @@ void idRenderWorldLocal::FreeDefs()
 {
 	generateAllInteractionsCalled = false;
 	
+	FreeStaticBatches();
+	
 	if( interactionTable )
 	{
 		R_StaticFree( interactionTable );
@@ -69,6 +69,7 @@ typedef struct portalArea_s
 	portal_t* 		portals;		// never changes after load
 	areaReference_t	entityRefs;		// head/tail of doubly linked list, may change
 	areaReference_t	lightRefs;		// head/tail of doubly linked list, may change
+	uint64			entityRefGeneration;	// world->entityRefGeneration when an entity was last linked in or out
 } portalArea_t;
 
 
@@ -96,6 +97,15 @@ struct reusableOverlay_t
 	idRenderModelOverlay* 	overlays;
 };
 
+// func_static models that never change are merged at level load into a single model
+// for each area, spatial cell and set of entity parms, see RenderWorld_merge.cpp
+struct staticBatch_t
+{
+	idRenderModel* 			model;					// surfaces are in world space, freed with the world
+	qhandle_t				entityHandle;			// entityDef drawing the model, -1 once the batch was broken up
+	idList<qhandle_t, TAG_MODEL>	members;		// entityDefs merged into the model
+};
+
 struct portalStack_t;
 
 class idRenderWorldLocal : public idRenderWorld
@@ -169,6 +179,7 @@ public:
 	portalArea_t* 			portalAreas;
 	int						numPortalAreas;
 	int						connectedAreaNum;		// incremented every time a door portal state changes
+	uint64					entityRefGeneration;	// incremented every time an entity is linked into or out of an area, starts at 1, 64 bits so it never wraps
 	
 	idScreenRect* 			areaScreenRect;
 	
@@ -202,6 +213,8 @@ public:
 	
 	bool					generateAllInteractionsCalled;
 	
+	idList<staticBatch_t, TAG_MODEL>	staticBatches;
+	
 	//-----------------------
 	// RenderWorld_load.cpp
 	
@@ -253,6 +266,13 @@ public:
 	}
 	void					ShowPortals();
 	
+	//--------------------------
+	// RenderWorld_merge.cpp
+	
+	void					MergeStaticEntityDefs();
+	void					BreakStaticBatch( int batchNum );
+	void					FreeStaticBatches();
+	
 	//--------------------------
 	// RenderWorld_demo.cpp
 	
@@ -0,0 +1,508 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#pragma hdrstop
+#include "precompiled.h"
+
+#include "tr_local.h"
+
+/*
+===============================================================================
+
+	Static model merging
+
+	Once everything is spawned, the entityDefs the game flagged with allowStaticMerge
+	are grouped by the area their center is in, a spatial cell inside that area and
+	all entity parms that affect drawing.  Each group with more than one member is
+	transformed into world space and merged into a single model with one surface
+	per material, which is drawn by a single entityDef instead of the members.
+
+	The cells keep the batches small enough that frustum, portal and light culling
+	still reject most of a batch that is off screen.
+
+	If a merged entity is ever updated or freed, its whole batch is broken up and the
+	members go back to being separate entities.  The merged model is kept until the
+	world is freed, because the back end may still be drawing it.
+
+===============================================================================
+*/
+
+idCVar r_mergeStaticEntities( "r_mergeStaticEntities", "1", CVAR_RENDERER | CVAR_BOOL, "merge static models into one model per area and material at level load" );
+idCVar r_mergeStaticEntitiesCellSize( "r_mergeStaticEntitiesCellSize", "1024", CVAR_RENDERER | CVAR_FLOAT, "models further apart than this are merged into separate batches, so they still cull individually" );
+
+static const int	MAX_STATIC_BATCH_VERTS = 32768;		// leaves room for mirrored vertexes below the 16 bit index limit
+
+struct staticBatchGroup_t
+{
+	int								areaNum;
+	int								cell[3];
+	idList<idRenderEntityLocal*>	members;
+};
+
+struct staticBatchSurface_t
+{
+	const idMaterial* 				shader;
+	const idRenderEntityLocal* 		def;
+	const srfTriangles_t* 			tri;
+};
+
+/*
+===================
+R_EntityCanBeMerged
+===================
+*/
+static bool R_EntityCanBeMerged( const idRenderEntityLocal* def )
+{
+	const renderEntity_t& parms = def->parms;
+	
+	if( !parms.allowStaticMerge || def->staticBatch != -1 || def->entityRefs == NULL )
+	{
+		return false;
+	}
+	
+	const idRenderModel* model = parms.hModel;
+	if( model == NULL || model->IsDefaultModel() || model->IsDynamicModel() != DM_STATIC || !model->ModelHasDrawingSurfaces() )
+	{
+		return false;
+	}
+	
+	// large meshes are better off with their simplified surfaces
+	if( model->NumSurfaceLODs() > 0 )
+	{
+		return false;
+	}
+	
+	if( parms.callback != NULL || parms.joints != NULL || parms.remoteRenderView != NULL ||
+			parms.referenceShader != NULL || parms.referenceSound != NULL )
+	{
+		return false;
+	}
+	for( int i = 0; i < MAX_RENDERENTITY_GUI; i++ )
+	{
+		if( parms.gui[i] != NULL )
+		{
+			return false;
+		}
+	}
+	
+	if( parms.suppressSurfaceInViewID != 0 || parms.suppressShadowInViewID != 0 || parms.suppressShadowInLightID != 0 ||
+			parms.allowSurfaceInViewID != 0 || parms.weaponDepthHack || parms.modelDepthHack != 0.0f || parms.noSelfShadow )
+	{
+		return false;
+	}
+	
+	// the members are never drawn once merged, so they must not carry decals or overlays of their
+	// own; later decals are redirected to the batch, and overlays only go on DM_CACHED models
+	if( def->decals != NULL || def->overlays != NULL )
+	{
+		return false;
+	}
+	
+	// scaled or mirrored axis would need the normals and winding fixed up
+	if( idMath::Fabs( parms.axis.Determinant() - 1.0f ) > 0.01f )
+	{
+		return false;
+	}
+	
+	for( int i = 0; i < model->NumSurfaces(); i++ )
+	{
+		const modelSurface_t* surf = model->Surface( i );
+		const idMaterial* shader = R_RemapShaderBySkin( surf->shader, parms.customSkin, parms.customShader );
+		if( shader == NULL )
+		{
+			continue;
+		}
+		
+		// these depend on the model space or on the entity itself
+		if( shader->Deform() != DFRM_NONE || shader->HasSubview() || shader->HasGui() || shader->IsLOD() )
+		{
+			return false;
+		}
+		
+		// the back sides were already added when the model was loaded,
+		// and would be added again when the batch is finished
+		if( shader->ShouldCreateBackSides() )
+		{
+			return false;
+		}
+		
+		const srfTriangles_t* tri = surf->geometry;
+		if( tri == NULL || tri->verts == NULL || tri->indexes == NULL || tri->numVerts > MAX_STATIC_BATCH_VERTS )
+		{
+			return false;
+		}
+	}
+	
+	return true;
+}
+
+/*
+===================
+R_EntityParmsCanShareBatch
+
+Merged surfaces are evaluated with the parms of the batch entity,
+so everything that can change how they draw has to match.
+===================
+*/
+static bool R_EntityParmsCanShareBatch( const renderEntity_t& a, const renderEntity_t& b )
+{
+	if( memcmp( a.shaderParms, b.shaderParms, sizeof( a.shaderParms ) ) != 0 )
+	{
+		return false;
+	}
+	return	a.noShadow == b.noShadow &&
+			a.noDynamicInteractions == b.noDynamicInteractions &&
+			a.noOverlays == b.noOverlays &&
+			a.skipMotionBlur == b.skipMotionBlur &&
+			a.timeGroup == b.timeGroup &&
+			a.xrayIndex == b.xrayIndex;
+}
+
+/*
+===================
+R_AddStaticBatchSurface
+
+Transforms the surfaces into world space and appends them to the model as a single surface.
+===================
+*/
+static void R_AddStaticBatchSurface( idRenderModel* model, const idMaterial* shader, const staticBatchSurface_t* surfs, int numSurfs )
+{
+	int numVerts = 0;
+	int numIndexes = 0;
+	for( int i = 0; i < numSurfs; i++ )
+	{
+		numVerts += surfs[i].tri->numVerts;
+		numIndexes += surfs[i].tri->numIndexes;
+	}
+	
+	srfTriangles_t* tri = R_AllocStaticTriSurf();
+	R_AllocStaticTriSurfVerts( tri, numVerts );
+	R_AllocStaticTriSurfIndexes( tri, numIndexes );
+	
+	for( int i = 0; i < numSurfs; i++ )
+	{
+		const srfTriangles_t* src = surfs[i].tri;
+		const idVec3& origin = surfs[i].def->parms.origin;
+		const idMat3& axis = surfs[i].def->parms.axis;
+		
+		const int firstVert = tri->numVerts;
+		for( int j = 0; j < src->numVerts; j++ )
+		{
+			idDrawVert& v = tri->verts[firstVert + j];
+			v = src->verts[j];
+			v.xyz = src->verts[j].xyz * axis + origin;
+			v.SetNormal( src->verts[j].GetNormal() * axis );
+			v.SetTangent( src->verts[j].GetTangent() * axis );
+		}
+		for( int j = 0; j < src->numIndexes; j++ )
+		{
+			tri->indexes[tri->numIndexes + j] = src->indexes[j] + firstVert;
+		}
+		
+		tri->numVerts += src->numVerts;
+		tri->numIndexes += src->numIndexes;
+	}
+	
+	modelSurface_t surf;
+	surf.id = 0;
+	surf.shader = shader;
+	surf.geometry = tri;
+	model->AddSurface( surf );
+}
+
+/*
+===================
+R_CreateStaticBatchModel
+
+Returns NULL if the merged model doesn't fit in the static vertex cache.
+===================
+*/
+static idRenderModel* R_CreateStaticBatchModel( const char* name, const idList<idRenderEntityLocal*>& members )
+{
+	idList<staticBatchSurface_t> surfs;
+	for( int i = 0; i < members.Num(); i++ )
+	{
+		const idRenderEntityLocal* def = members[i];
+		const idRenderModel* model = def->parms.hModel;
+		for( int j = 0; j < model->NumSurfaces(); j++ )
+		{
+			const modelSurface_t* surf = model->Surface( j );
+			const idMaterial* shader = R_RemapShaderBySkin( surf->shader, def->parms.customSkin, def->parms.customShader );
+			if( shader == NULL || surf->geometry->numIndexes == 0 )
+			{
+				continue;
+			}
+			staticBatchSurface_t& s = surfs.Alloc();
+			s.shader = shader;
+			s.def = def;
+			s.tri = surf->geometry;
+		}
+	}
+	
+	idRenderModel* model = renderModelManager->AllocModel();
+	model->InitEmpty( name );
+	
+	// one surface per material, split where the vertexes would overflow the index range
+	idList<bool> merged;
+	merged.AssureSize( surfs.Num(), false );
+	idList<staticBatchSurface_t> chunk;
+	for( int i = 0; i < surfs.Num(); i++ )
+	{
+		if( merged[i] )
+		{
+			continue;
+		}
+		const idMaterial* shader = surfs[i].shader;
+		
+		chunk.SetNum( 0 );
+		int numVerts = 0;
+		for( int j = i; j < surfs.Num(); j++ )
+		{
+			if( merged[j] || surfs[j].shader != shader )
+			{
+				continue;
+			}
+			if( numVerts + surfs[j].tri->numVerts > MAX_STATIC_BATCH_VERTS )
+			{
+				R_AddStaticBatchSurface( model, shader, chunk.Ptr(), chunk.Num() );
+				chunk.SetNum( 0 );
+				numVerts = 0;
+			}
+			chunk.Append( surfs[j] );
+			numVerts += surfs[j].tri->numVerts;
+			merged[j] = true;
+		}
+		R_AddStaticBatchSurface( model, shader, chunk.Ptr(), chunk.Num() );
+	}
+	
+	model->FinishSurfaces();
+	
+	// the static vertex cache can't grow, so leave some room for anything loaded later
+	int vertexBytes = 0;
+	int indexBytes = 0;
+	for( int i = 0; i < model->NumSurfaces(); i++ )
+	{
+		const srfTriangles_t* tri = model->Surface( i )->geometry;
+		vertexBytes += ALIGN( tri->numVerts * sizeof( tri->verts[0] ), VERTEX_CACHE_ALIGN );
+		vertexBytes += ALIGN( tri->numVerts * 2 * sizeof( idShadowVert ), VERTEX_CACHE_ALIGN );
+		indexBytes += ALIGN( tri->numIndexes * sizeof( tri->indexes[0] ), INDEX_CACHE_ALIGN );
+	}
+	if( vertexCache.staticData.vertexMemUsed.GetValue() + vertexBytes > STATIC_VERTEX_MEMORY - STATIC_VERTEX_MEMORY / 8 ||
+			vertexCache.staticData.indexMemUsed.GetValue() + indexBytes > STATIC_INDEX_MEMORY - STATIC_INDEX_MEMORY / 8 )
+	{
+		delete model;
+		return NULL;
+	}
+	
+	for( int i = 0; i < model->NumSurfaces(); i++ )
+	{
+		R_CreateStaticBuffersForTri( *( model->Surface( i )->geometry ) );
+	}
+	
+	return model;
+}
+
+/*
+===================
+idRenderWorldLocal::MergeStaticEntityDefs
+
+Called by GenerateAllInteractions after the level has been spawned.
+===================
+*/
+void idRenderWorldLocal::MergeStaticEntityDefs()
+{
+	if( !r_mergeStaticEntities.GetBool() || staticBatches.Num() > 0 )
+	{
+		return;
+	}
+	
+	int start = Sys_Milliseconds();
+	
+	const float cellSize = Max( r_mergeStaticEntitiesCellSize.GetFloat(), 64.0f );
+	
+	idList<staticBatchGroup_t> groups;
+	for( int i = numPortalAreas; i < entityDefs.Num(); i++ )
+	{
+		idRenderEntityLocal* def = entityDefs[i];
+		if( def == NULL || !R_EntityCanBeMerged( def ) )
+		{
+			continue;
+		}
+		
+		const idVec3 center = def->globalReferenceBounds.GetCenter();
+		const int areaNum = PointInArea( center );
+		if( areaNum < 0 )
+		{
+			continue;
+		}
+		
+		int cell[3];
+		for( int j = 0; j < 3; j++ )
+		{
+			cell[j] = idMath::Ftoi( idMath::Floor( center[j] / cellSize ) );
+		}
+		
+		int groupNum;
+		for( groupNum = 0; groupNum < groups.Num(); groupNum++ )
+		{
+			const staticBatchGroup_t& group = groups[groupNum];
+			if( group.areaNum == areaNum && group.cell[0] == cell[0] && group.cell[1] == cell[1] && group.cell[2] == cell[2] &&
+					R_EntityParmsCanShareBatch( group.members[0]->parms, def->parms ) )
+			{
+				break;
+			}
+		}
+		if( groupNum == groups.Num() )
+		{
+			staticBatchGroup_t& group = groups.Alloc();
+			group.areaNum = areaNum;
+			group.cell[0] = cell[0];
+			group.cell[1] = cell[1];
+			group.cell[2] = cell[2];
+		}
+		groups[groupNum].members.Append( def );
+	}
+	
+	int numMerged = 0;
+	for( int i = 0; i < groups.Num(); i++ )
+	{
+		const staticBatchGroup_t& group = groups[i];
+		if( group.members.Num() < 2 )
+		{
+			continue;
+		}
+		
+		common->UpdateLevelLoadPacifier();
+		
+		idRenderModel* model = R_CreateStaticBatchModel( va( "_staticBatch%i", staticBatches.Num() ), group.members );
+		if( model == NULL )
+		{
+			common->Warning( "idRenderWorldLocal::MergeStaticEntityDefs: static vertex cache is too full to merge more models" );
+			break;
+		}
+		
+		const renderEntity_t& memberParms = group.members[0]->parms;
+		
+		// take the entity number of a member, the 0 from the memset would be the first player
+		renderEntity_t re;
+		memset( &re, 0, sizeof( re ) );
+		re.hModel = model;
+		re.entityNum = memberParms.entityNum;
+		re.axis.Identity();
+		memcpy( re.shaderParms, memberParms.shaderParms, sizeof( re.shaderParms ) );
+		re.noShadow = memberParms.noShadow;
+		re.noDynamicInteractions = memberParms.noDynamicInteractions;
+		re.noOverlays = memberParms.noOverlays;
+		re.skipMotionBlur = memberParms.skipMotionBlur;
+		re.timeGroup = memberParms.timeGroup;
+		re.xrayIndex = memberParms.xrayIndex;
+		
+		const int batchNum = staticBatches.Num();
+		staticBatch_t& batch = staticBatches.Alloc();
+		batch.model = model;
+		batch.entityHandle = AddEntityDef( &re );
+		
+		// the members stay in entityDefs for the game, but are no longer in any area
+		for( int j = 0; j < group.members.Num(); j++ )
+		{
+			idRenderEntityLocal* def = group.members[j];
+			assert( def->decals == NULL && def->overlays == NULL );
+			R_FreeEntityDefDerivedData( def, false, true );
+			def->staticBatch = batchNum;
+			batch.members.Append( def->index );
+		}
+		numMerged += group.members.Num();
+	}
+	
+	int end = Sys_Milliseconds();
+	
+	common->Printf( "%i static models merged into %i batches in %i msec\n", numMerged, staticBatches.Num(), end - start );
+}
+
+/*
+===================
+idRenderWorldLocal::BreakStaticBatch
+
+Puts the members of a batch back into the areas as separate entities.
+===================
+*/
+void idRenderWorldLocal::BreakStaticBatch( int batchNum )
+{
+	staticBatch_t& batch = staticBatches[batchNum];
+	if( batch.entityHandle == -1 )
+	{
+		return;
+	}
+	
+	FreeEntityDef( batch.entityHandle );
+	batch.entityHandle = -1;
+	
+	for( int i = 0; i < batch.members.Num(); i++ )
+	{
+		idRenderEntityLocal* def = entityDefs[ batch.members[i] ];
+		def->staticBatch = -1;
+		R_CreateEntityRefs( def );
+	}
+	
+	if( r_showUpdates.GetBool() )
+	{
+		common->Printf( "broke up static batch %i with %i models\n", batchNum, batch.members.Num() );
+	}
+	
+	batch.members.Clear();
+}
+
+/*
+===================
+idRenderWorldLocal::FreeStaticBatches
+
+The members are left without any area references, so this
+is only used when all the entityDefs are freed or relinked.
+===================
+*/
+void idRenderWorldLocal::FreeStaticBatches()
+{
+	for( int i = 0; i < staticBatches.Num(); i++ )
+	{
+		staticBatch_t& batch = staticBatches[i];
+		if( batch.entityHandle != -1 )
+		{
+			FreeEntityDef( batch.entityHandle );
+		}
+		for( int j = 0; j < batch.members.Num(); j++ )
+		{
+			idRenderEntityLocal* def = entityDefs[ batch.members[j] ];
+			if( def != NULL )
+			{
+				def->staticBatch = -1;
+			}
+		}
+		delete batch.model;
+	}
+	staticBatches.Clear();
+}
@@ -31,10 +31,27 @@ If you have questions concerning this license or the applicable additional terms
 #include "../../../idlib/sys/sys_intrinsics.h"
 #include "../../../idlib/geometry/DrawVert_intrinsics.h"
 
+#if defined(USE_INTRINSICS)
+#include <immintrin.h>
+#endif
+
 #if defined(USE_INTRINSICS)
 static const __m128i vector_int_neg_one		= _mm_set_epi32( -1, -1, -1, -1 );
 #endif
 
+#if defined(USE_INTRINSICS)
+// the AVX2 functions are compiled for AVX2 and FMA3 individually and only called when the CPU reports both
+#if defined(__GNUC__)
+#define AVX2_TARGET							__attribute__( ( target( "avx2,fma" ) ) )
+#else
+#define AVX2_TARGET
+#endif
+#define _mm256_madd_ps( a, b, c )			_mm256_fmadd_ps( (a), (b), (c) )
+#define _mm256_nmsub_ps( a, b, c )			_mm256_fnmadd_ps( (a), (b), (c) )
+
+#define AVX2_BATCH_TRIANGLES				32		// triangles gathered for one call to TriangleFacingCulled_AVX2
+#endif
+
 /*
 =====================
 TriangleFacing_SSE2
@@ -132,7 +149,160 @@ static ID_FORCE_INLINE __m128i TriangleCulled_SSE2(	const __m128& vert0X, const
 	return _mm_castps_si128( _mm_cmpeq_ps( b0, zero ) );
 }
 
-#else
+#endif
+
+#if defined(USE_INTRINSICS)
+
+/*
+=====================
+TransposeTriangles_AVX2
+
+Transposes the vertices of 8 triangles, where 'v' points to the 3 vertices of each triangle in order,
+into 8-wide X, Y and Z vectors. The lower 128 bits hold triangles 0-3 and the upper 128 bits triangles 4-7.
+=====================
+*/
+static ID_FORCE_INLINE AVX2_TARGET void TransposeTriangles_AVX2( const float* const* v, __m256* vertX, __m256* vertY, __m256* vertZ )
+{
+	for( int k = 0; k < 3; k++ )
+	{
+		const __m256 vertAE = _mm256_insertf128_ps( _mm256_castps128_ps256( _mm_load_ps( v[0 * 3 + k] ) ), _mm_load_ps( v[4 * 3 + k] ), 1 );
+		const __m256 vertBF = _mm256_insertf128_ps( _mm256_castps128_ps256( _mm_load_ps( v[1 * 3 + k] ) ), _mm_load_ps( v[5 * 3 + k] ), 1 );
+		const __m256 vertCG = _mm256_insertf128_ps( _mm256_castps128_ps256( _mm_load_ps( v[2 * 3 + k] ) ), _mm_load_ps( v[6 * 3 + k] ), 1 );
+		const __m256 vertDH = _mm256_insertf128_ps( _mm256_castps128_ps256( _mm_load_ps( v[3 * 3 + k] ) ), _mm_load_ps( v[7 * 3 + k] ), 1 );
+		
+		const __m256 rX = _mm256_unpacklo_ps( vertAE, vertCG );	// vertA.x, vertC.x, vertA.z, vertC.z | vertE.x, vertG.x, vertE.z, vertG.z
+		const __m256 rY = _mm256_unpackhi_ps( vertAE, vertCG );	// vertA.y, vertC.y, vertA.w, vertC.w | vertE.y, vertG.y, vertE.w, vertG.w
+		const __m256 rZ = _mm256_unpacklo_ps( vertBF, vertDH );	// vertB.x, vertD.x, vertB.z, vertD.z | vertF.x, vertH.x, vertF.z, vertH.z
+		const __m256 rW = _mm256_unpackhi_ps( vertBF, vertDH );	// vertB.y, vertD.y, vertB.w, vertD.w | vertF.y, vertH.y, vertF.w, vertH.w
+		
+		vertX[k] = _mm256_unpacklo_ps( rX, rZ );				// vertA.x, vertB.x, vertC.x, vertD.x | vertE.x, vertF.x, vertG.x, vertH.x
+		vertY[k] = _mm256_unpackhi_ps( rX, rZ );				// vertA.y, vertB.y, vertC.y, vertD.y | vertE.y, vertF.y, vertG.y, vertH.y
+		vertZ[k] = _mm256_unpacklo_ps( rY, rW );				// vertA.z, vertB.z, vertC.z, vertD.z | vertE.z, vertF.z, vertG.z, vertH.z
+	}
+}
+
+/*
+=====================
+TriangleFacing_AVX2
+=====================
+*/
+static ID_FORCE_INLINE AVX2_TARGET __m256 TriangleFacing_AVX2( const __m256* vertX, const __m256* vertY, const __m256* vertZ,
+		const __m256& lightOriginX, const __m256& lightOriginY, const __m256& lightOriginZ )
+{
+	const __m256 sX = _mm256_sub_ps( vertX[1], vertX[0] );
+	const __m256 sY = _mm256_sub_ps( vertY[1], vertY[0] );
+	const __m256 sZ = _mm256_sub_ps( vertZ[1], vertZ[0] );
+	
+	const __m256 tX = _mm256_sub_ps( vertX[2], vertX[0] );
+	const __m256 tY = _mm256_sub_ps( vertY[2], vertY[0] );
+	const __m256 tZ = _mm256_sub_ps( vertZ[2], vertZ[0] );
+	
+	const __m256 normalX = _mm256_nmsub_ps( tZ, sY, _mm256_mul_ps( tY, sZ ) );
+	const __m256 normalY = _mm256_nmsub_ps( tX, sZ, _mm256_mul_ps( tZ, sX ) );
+	const __m256 normalZ = _mm256_nmsub_ps( tY, sX, _mm256_mul_ps( tX, sY ) );
+	const __m256 normalW = _mm256_madd_ps( normalX, vertX[0], _mm256_madd_ps( normalY, vertY[0], _mm256_mul_ps( normalZ, vertZ[0] ) ) );
+	
+	const __m256 delta = _mm256_nmsub_ps( lightOriginX, normalX, _mm256_nmsub_ps( lightOriginY, normalY, _mm256_nmsub_ps( lightOriginZ, normalZ, normalW ) ) );
+	return _mm256_cmp_ps( delta, _mm256_setzero_ps(), _CMP_LT_OQ );
+}
+
+/*
+=====================
+TriangleCulled_AVX2
+
+The clip space of the 'lightProject' is assumed to be in the range [0, 1].
+The 'lightProject' holds the 16 matrix elements, each splat across a vector.
+=====================
+*/
+static ID_FORCE_INLINE AVX2_TARGET __m256 TriangleCulled_AVX2( const __m256* vertX, const __m256* vertY, const __m256* vertZ, const __m256* lightProject )
+{
+	__m256 c[4][3];
+	for( int i = 0; i < 4; i++ )
+	{
+		const __m256* mvp = lightProject + i * 4;
+		for( int k = 0; k < 3; k++ )
+		{
+			c[i][k] = _mm256_madd_ps( vertX[k], mvp[0], _mm256_madd_ps( vertY[k], mvp[1], _mm256_madd_ps( vertZ[k], mvp[2], mvp[3] ) ) );
+		}
+	}
+	
+	const __m256 zero = _mm256_setzero_ps();
+	
+	__m256 b0 = _mm256_or_ps( _mm256_or_ps( _mm256_cmp_ps( c[0][0], zero, _CMP_GT_OQ ), _mm256_cmp_ps( c[0][1], zero, _CMP_GT_OQ ) ), _mm256_cmp_ps( c[0][2], zero, _CMP_GT_OQ ) );
+	__m256 b1 = _mm256_or_ps( _mm256_or_ps( _mm256_cmp_ps( c[1][0], zero, _CMP_GT_OQ ), _mm256_cmp_ps( c[1][1], zero, _CMP_GT_OQ ) ), _mm256_cmp_ps( c[1][2], zero, _CMP_GT_OQ ) );
+	__m256 b2 = _mm256_or_ps( _mm256_or_ps( _mm256_cmp_ps( c[2][0], zero, _CMP_GT_OQ ), _mm256_cmp_ps( c[2][1], zero, _CMP_GT_OQ ) ), _mm256_cmp_ps( c[2][2], zero, _CMP_GT_OQ ) );
+	__m256 b3 = _mm256_or_ps( _mm256_or_ps( _mm256_cmp_ps( c[3][0], c[0][0], _CMP_GT_OQ ), _mm256_cmp_ps( c[3][1], c[0][1], _CMP_GT_OQ ) ), _mm256_cmp_ps( c[3][2], c[0][2], _CMP_GT_OQ ) );
+	__m256 b4 = _mm256_or_ps( _mm256_or_ps( _mm256_cmp_ps( c[3][0], c[1][0], _CMP_GT_OQ ), _mm256_cmp_ps( c[3][1], c[1][1], _CMP_GT_OQ ) ), _mm256_cmp_ps( c[3][2], c[1][2], _CMP_GT_OQ ) );
+	__m256 b5 = _mm256_or_ps( _mm256_or_ps( _mm256_cmp_ps( c[3][0], c[2][0], _CMP_GT_OQ ), _mm256_cmp_ps( c[3][1], c[2][1], _CMP_GT_OQ ) ), _mm256_cmp_ps( c[3][2], c[2][2], _CMP_GT_OQ ) );
+	
+	b0 = _mm256_and_ps( b0, b1 );
+	b2 = _mm256_and_ps( b2, b3 );
+	b4 = _mm256_and_ps( b4, b5 );
+	b0 = _mm256_and_ps( b0, b2 );
+	b0 = _mm256_and_ps( b0, b4 );
+	
+	return _mm256_cmp_ps( b0, zero, _CMP_EQ_OQ );
+}
+
+/*
+=====================
+TriangleFacingCulled_AVX2
+
+Stores the facing and culled bytes of 'numTriangles' triangles, a multiple of 8, where 'v' points to the
+3 vertices of each triangle in order, and adds the number of facing triangles to the 4-wide 'numFrontFacing' counters.
+=====================
+*/
+static AVX2_TARGET void TriangleFacingCulled_AVX2( byte* facing, byte* culled, const float* const* v, const int numTriangles,
+		const idVec3& lightOrigin, const idRenderMatrix& lightProject, const bool cullShadowTrianglesToLight, __m128i& numFrontFacing )
+{
+	assert( ( numTriangles & 7 ) == 0 );
+	
+	const __m256 lightOriginX = _mm256_broadcast_ss( &lightOrigin.x );
+	const __m256 lightOriginY = _mm256_broadcast_ss( &lightOrigin.y );
+	const __m256 lightOriginZ = _mm256_broadcast_ss( &lightOrigin.z );
+	
+	__m256 lightProject8[16];
+	for( int k = 0; k < 16; k++ )
+	{
+		lightProject8[k] = _mm256_broadcast_ss( &lightProject[k >> 2][k & 3] );
+	}
+	
+	const __m256 cullShadowTrianglesToLightMask = _mm256_castsi256_ps( _mm256_set1_epi32( cullShadowTrianglesToLight ? -1 : 0 ) );
+	
+	for( int i = 0; i < numTriangles; i += 8, v += 8 * 3 )
+	{
+		__m256 vertX[3];
+		__m256 vertY[3];
+		__m256 vertZ[3];
+		TransposeTriangles_AVX2( v, vertX, vertY, vertZ );
+		
+		const __m256 triangleCulled = TriangleCulled_AVX2( vertX, vertY, vertZ, lightProject8 );
+		
+		__m256 triangleFacing = TriangleFacing_AVX2( vertX, vertY, vertZ, lightOriginX, lightOriginY, lightOriginZ );
+		
+		// optionally make triangles that are outside the light frustum facing so they do not contribute to the shadow volume
+		triangleFacing = _mm256_or_ps( triangleFacing, _mm256_and_ps( triangleCulled, cullShadowTrianglesToLightMask ) );
+		
+		// store culled
+		const __m128i culled_lo = _mm_castps_si128( _mm256_castps256_ps128( triangleCulled ) );
+		const __m128i culled_hi = _mm_castps_si128( _mm256_extractf128_ps( triangleCulled, 1 ) );
+		const __m128i culled_s = _mm_packs_epi32( culled_lo, culled_hi );
+		_mm_storel_epi64( ( __m128i* )&culled[i], _mm_packs_epi16( culled_s, culled_s ) );
+		
+		// store facing
+		const __m128i facing_lo = _mm_castps_si128( _mm256_castps256_ps128( triangleFacing ) );
+		const __m128i facing_hi = _mm_castps_si128( _mm256_extractf128_ps( triangleFacing, 1 ) );
+		const __m128i facing_s = _mm_packs_epi32( facing_lo, facing_hi );
+		_mm_storel_epi64( ( __m128i* )&facing[i], _mm_packs_epi16( facing_s, facing_s ) );
+		
+		// count the number of facing triangles, the masks are -1 for facing triangles
+		numFrontFacing = _mm_sub_epi32( numFrontFacing, _mm_add_epi32( facing_lo, facing_hi ) );
+	}
+}
+
+#endif
+
+#if !defined(USE_INTRINSICS)
 
 /*
 =====================
@@ -228,7 +398,7 @@ static int CalculateTriangleFacingCulledStatic( byte* __restrict facing, byte* _
 		const idDrawVert* __restrict verts, const int numVerts,
 		const idVec3& lightOrigin, const idVec3& viewOrigin,
 		bool cullShadowTrianglesToLight, const idRenderMatrix& lightProject,
-		bool* insideShadowVolume, const float radius )
+		bool* insideShadowVolume, const float radius, bool useAVX2 )
 {
 
 	assert_spu_local_store( facing );
@@ -251,7 +421,8 @@ static int CalculateTriangleFacingCulledStatic( byte* __restrict facing, byte* _
 	
 #if defined(USE_INTRINSICS)
 	
-	idODSStreamedIndexedArray< idDrawVert, triIndex_t, 32, SBT_QUAD, 4 * 3 > indexedVertsODS( verts, numVerts, indexes, numIndexes );
+	// larger batches so the 8-wide loop is not starved
+	idODSStreamedIndexedArray< idDrawVert, triIndex_t, 128, SBT_QUAD, 4 * 3 > indexedVertsODS( verts, numVerts, indexes, numIndexes );
 	
 	const __m128 lightOriginX = _mm_splat_ps( _mm_load_ss( &lightOrigin.x ), 0 );
 	const __m128 lightOriginY = _mm_splat_ps( _mm_load_ss( &lightOrigin.y ), 0 );
@@ -264,6 +435,7 @@ static int CalculateTriangleFacingCulledStatic( byte* __restrict facing, byte* _
 	
 	const __m128i cullShadowTrianglesToLightMask = cullShadowTrianglesToLight ? vector_int_neg_one : vector_int_zero;
 	
+	
 	__m128i numFrontFacing = _mm_setzero_si128();
 	
 	for( int i = 0, j = 0; i < numIndexes; )
@@ -274,6 +446,19 @@ static int CalculateTriangleFacingCulledStatic( byte* __restrict facing, byte* _
 		const int batchEnd4x = batchEnd - 4 * 3;
 		const int indexStart = j;
 		
+		while( useAVX2 && i <= batchEnd - 8 * 3 )
+		{
+			const int numTriangles = Min( ( batchEnd - i ) / ( 8 * 3 ) * 8, AVX2_BATCH_TRIANGLES );
+			const float* v[AVX2_BATCH_TRIANGLES * 3];
+			for( int k = 0; k < numTriangles * 3; k++ )
+			{
+				v[k] = indexedVertsODS[i + k].xyz.ToFloatPtr();
+			}
+			TriangleFacingCulled_AVX2( &facing[j], &culled[j], v, numTriangles, lightOrigin, lightProject, cullShadowTrianglesToLight, numFrontFacing );
+			i += numTriangles * 3;
+			j += numTriangles;
+		}
+		
 		for( ; i <= batchEnd4x; i += 4 * 3, j += 4 )
 		{
 			const __m128 vertA0 = _mm_load_ps( indexedVertsODS[i + 0 * 3 + 0].xyz.ToFloatPtr() );
@@ -419,21 +604,65 @@ static int CalculateTriangleFacingCulledStatic( byte* __restrict facing, byte* _
 #endif
 }
 
+/*
+=====================
+SkinShadowVolumeVerts
+=====================
+*/
+static void SkinShadowVolumeVerts( idVec4* __restrict tempVerts, const idDrawVert* __restrict verts, const int numVerts, const idJointMat* __restrict joints )
+{
+	assert_spu_local_store( joints );
+	assert_not_spu_local_store( verts );
+	
+#if defined(USE_INTRINSICS)
+	
+	idODSStreamedArray< idDrawVert, 32, SBT_DOUBLE, 1 > vertsODS( verts, numVerts );
+	
+	for( int i = 0; i < numVerts; )
+	{
+	
+		const int nextNumVerts = vertsODS.FetchNextBatch() - 1;
+		
+		for( ; i <= nextNumVerts; i++ )
+		{
+			__m128 v = LoadSkinnedDrawVertPosition( vertsODS[i], joints );
+			_mm_store_ps( tempVerts[i].ToFloatPtr(), v );
+		}
+	}
+	
+#else
+	
+	idODSStreamedArray< idDrawVert, 32, SBT_DOUBLE, 1 > vertsODS( verts, numVerts );
+	
+	for( int i = 0; i < numVerts; )
+	{
+	
+		const int nextNumVerts = vertsODS.FetchNextBatch() - 1;
+	
+		for( ; i <= nextNumVerts; i++ )
+		{
+			tempVerts[i].ToVec3() = Scalar_LoadSkinnedDrawVertPosition( vertsODS[i], joints );
+			tempVerts[i].w = 1.0f;
+		}
+	}
+	
+#endif
+}
+
 /*
 =====================
 CalculateTriangleFacingCulledSkinned
+
+The vertices must already have been skinned into 'tempVerts' with SkinShadowVolumeVerts().
 =====================
 */
-static int CalculateTriangleFacingCulledSkinned( byte* __restrict facing, byte* __restrict culled, idVec4* __restrict tempVerts, const triIndex_t* __restrict indexes, int numIndexes,
-		const idDrawVert* __restrict verts, const int numVerts, const idJointMat* __restrict joints,
+static int CalculateTriangleFacingCulledSkinned( byte* __restrict facing, byte* __restrict culled, const idVec4* __restrict tempVerts, const triIndex_t* __restrict indexes, int numIndexes,
 		const idVec3& lightOrigin, const idVec3& viewOrigin,
 		bool cullShadowTrianglesToLight, const idRenderMatrix& lightProject,
-		bool* insideShadowVolume, const float radius )
+		bool* insideShadowVolume, const float radius, bool useAVX2 )
 {
 	assert_spu_local_store( facing );
-	assert_spu_local_store( joints );
 	assert_not_spu_local_store( indexes );
-	assert_not_spu_local_store( verts );
 	
 	if( insideShadowVolume != NULL )
 	{
@@ -451,20 +680,6 @@ static int CalculateTriangleFacingCulledSkinned( byte* __restrict facing, byte*
 	
 #if defined(USE_INTRINSICS)
 	
-	idODSStreamedArray< idDrawVert, 32, SBT_DOUBLE, 1 > vertsODS( verts, numVerts );
-	
-	for( int i = 0; i < numVerts; )
-	{
-	
-		const int nextNumVerts = vertsODS.FetchNextBatch() - 1;
-		
-		for( ; i <= nextNumVerts; i++ )
-		{
-			__m128 v = LoadSkinnedDrawVertPosition( vertsODS[i], joints );
-			_mm_store_ps( tempVerts[i].ToFloatPtr(), v );
-		}
-	}
-	
 	idODSStreamedArray< triIndex_t, 256, SBT_QUAD, 4 * 3 > indexesODS( indexes, numIndexes );
 	
 	const __m128 lightOriginX = _mm_splat_ps( _mm_load_ss( &lightOrigin.x ), 0 );
@@ -478,6 +693,7 @@ static int CalculateTriangleFacingCulledSkinned( byte* __restrict facing, byte*
 	
 	const __m128i cullShadowTrianglesToLightMask = cullShadowTrianglesToLight ? vector_int_neg_one : vector_int_zero;
 	
+	
 	__m128i numFrontFacing = _mm_setzero_si128();
 	
 	for( int i = 0, j = 0; i < numIndexes; )
@@ -488,6 +704,19 @@ static int CalculateTriangleFacingCulledSkinned( byte* __restrict facing, byte*
 		const int batchEnd4x = batchEnd - 4 * 3;
 		const int indexStart = j;
 		
+		while( useAVX2 && i <= batchEnd - 8 * 3 )
+		{
+			const int numTriangles = Min( ( batchEnd - i ) / ( 8 * 3 ) * 8, AVX2_BATCH_TRIANGLES );
+			const float* v[AVX2_BATCH_TRIANGLES * 3];
+			for( int k = 0; k < numTriangles * 3; k++ )
+			{
+				v[k] = tempVerts[indexesODS[i + k]].ToFloatPtr();
+			}
+			TriangleFacingCulled_AVX2( &facing[j], &culled[j], v, numTriangles, lightOrigin, lightProject, cullShadowTrianglesToLight, numFrontFacing );
+			i += numTriangles * 3;
+			j += numTriangles;
+		}
+		
 		for( ; i <= batchEnd4x; i += 4 * 3, j += 4 )
 		{
 			const int indexA0 = indexesODS[( i + 0 * 3 + 0 )];
@@ -597,20 +826,6 @@ static int CalculateTriangleFacingCulledSkinned( byte* __restrict facing, byte*
 	
 #else
 	
-	idODSStreamedArray< idDrawVert, 32, SBT_DOUBLE, 1 > vertsODS( verts, numVerts );
-	
-	for( int i = 0; i < numVerts; )
-	{
-	
-		const int nextNumVerts = vertsODS.FetchNextBatch() - 1;
-	
-		for( ; i <= nextNumVerts; i++ )
-		{
-			tempVerts[i].ToVec3() = Scalar_LoadSkinnedDrawVertPosition( vertsODS[i], joints );
-			tempVerts[i].w = 1.0f;
-		}
-	}
-	
 	idODSStreamedArray< triIndex_t, 256, SBT_QUAD, 1 > indexesODS( indexes, numIndexes );
 	
 	const byte cullShadowTrianglesToLightMask = cullShadowTrianglesToLight ? 255 : 0;
@@ -1156,48 +1371,19 @@ void R_CreateLightTriangles( triIndex_t* __restrict lightIndices, triIndex_t* __
 	
 #endif
 }
-
 /*
 =====================
-DynamicShadowVolumeJob
-
-Creates shadow volume indices for a surface that intersects a light.
-Optionally also creates new surface indices with just the triangles
-inside the light volume. These indices will be unique for a given
-light / surface combination.
+SetupShadowVolume
 
-The shadow volume indices are created using the original surface vertices.
-However, the indices are setup to be used with a shadow volume vertex buffer
-with all vertices duplicated where the even vertices have the same positions
-as the surface vertices (at the near cap) and each odd vertex has the
-same position as the previous even vertex but is projected to infinity
-(the far cap) in the vertex program.
+Calculates the shadow depth bounds and whether or not the view may be inside the shadow volume.
+Returns false if the shadow volume is depth culled.
 =====================
 */
-void DynamicShadowVolumeJob( const dynamicShadowVolumeParms_t* parms )
+static bool SetupShadowVolume( const dynamicShadowVolumeParms_t* parms, float& shadowZMin, float& shadowZMax, bool& renderZFail, bool& preciseInsideTest )
 {
-	if( parms->tempFacing == NULL )
-	{
-		*const_cast< byte** >( &parms->tempFacing ) = ( byte* )_alloca16( TEMP_FACING( parms->numIndexes ) );
-	}
-	if( parms->tempCulled == NULL )
-	{
-		*const_cast< byte** >( &parms->tempCulled ) = ( byte* )_alloca16( TEMP_CULL( parms->numIndexes ) );
-	}
-	if( parms->tempVerts == NULL && parms->joints != NULL )
-	{
-		*const_cast< idVec4** >( &parms->tempVerts ) = ( idVec4* )_alloca16( TEMP_VERTS( parms->numVerts ) );
-	}
-	if( parms->indexBuffer == NULL )
-	{
-		*const_cast< triIndex_t** >( &parms->indexBuffer ) = ( triIndex_t* )_alloca16( OUTPUT_INDEX_BUFFER_SIZE );
-	}
-	
-	assert( parms->joints == NULL || parms->numJoints > 0 );
-	
 	// Calculate the shadow depth bounds.
-	float shadowZMin = parms->lightZMin;
-	float shadowZMax = parms->lightZMax;
+	shadowZMin = parms->lightZMin;
+	shadowZMax = parms->lightZMax;
 	if( parms->useShadowDepthBounds )
 	{
 		idRenderMatrix::DepthBoundsForShadowBounds( shadowZMin, shadowZMax, parms->triangleMVP, parms->triangleBounds, parms->localLightOrigin, true );
@@ -1205,51 +1391,48 @@ void DynamicShadowVolumeJob( const dynamicShadowVolumeParms_t* parms )
 		shadowZMax = Min( shadowZMax, parms->lightZMax );
 	}
 	
-	bool renderZFail = false;
-	int numShadowIndices = 0;
-	int numLightIndices = 0;
+	renderZFail = false;
+	preciseInsideTest = false;
 	
 	// The shadow volume may be depth culled if either the shadow volume was culled to the view frustum or if the
 	// depth range of the visible part of the shadow volume is outside the depth range of the light volume.
-	if( shadowZMin < shadowZMax )
+	if( shadowZMin >= shadowZMax )
 	{
+		return false;
+	}
 	
-		// Check if we need to render the shadow volume with Z-fail.
-		bool* preciseInsideShadowVolume = NULL;
-		// If the view is potentially inside the shadow volume bounds we may need to render with Z-fail.
-		if( R_ViewPotentiallyInsideInfiniteShadowVolume( parms->triangleBounds, parms->localLightOrigin, parms->localViewOrigin, parms->zNear * INSIDE_SHADOW_VOLUME_EXTRA_STRETCH ) )
-		{
-			// Optionally perform a more precise test to see whether or not the view is inside the shadow volume.
-			if( parms->useShadowPreciseInsideTest )
-			{
-				preciseInsideShadowVolume = & renderZFail;
-			}
-			else
-			{
-				renderZFail = true;
-			}
-		}
-		
-		// Calculate the facing of each triangle and cull each triangle to the light volume.
-		// Optionally also calculate more precisely whether or not the view is inside the shadow volume.
-		int numFrontFacing = 0;
-		if( parms->joints != NULL )
+	// Check if we need to render the shadow volume with Z-fail.
+	// If the view is potentially inside the shadow volume bounds we may need to render with Z-fail.
+	if( R_ViewPotentiallyInsideInfiniteShadowVolume( parms->triangleBounds, parms->localLightOrigin, parms->localViewOrigin, parms->zNear * INSIDE_SHADOW_VOLUME_EXTRA_STRETCH ) )
+	{
+		// Optionally perform a more precise test to see whether or not the view is inside the shadow volume.
+		if( parms->useShadowPreciseInsideTest )
 		{
-			numFrontFacing = CalculateTriangleFacingCulledSkinned( parms->tempFacing, parms->tempCulled, parms->tempVerts, parms->indexes, parms->numIndexes,
-							 parms->verts, parms->numVerts, parms->joints,
-							 parms->localLightOrigin, parms->localViewOrigin,
-							 parms->cullShadowTrianglesToLight, parms->localLightProject,
-							 preciseInsideShadowVolume, parms->zNear * INSIDE_SHADOW_VOLUME_EXTRA_STRETCH );
+			preciseInsideTest = true;
 		}
 		else
 		{
-			numFrontFacing = CalculateTriangleFacingCulledStatic( parms->tempFacing, parms->tempCulled, parms->indexes, parms->numIndexes,
-							 parms->verts, parms->numVerts,
-							 parms->localLightOrigin, parms->localViewOrigin,
-							 parms->cullShadowTrianglesToLight, parms->localLightProject,
-							 preciseInsideShadowVolume, parms->zNear * INSIDE_SHADOW_VOLUME_EXTRA_STRETCH );
+			renderZFail = true;
 		}
-		
+	}
+	return true;
+}
+
+/*
+=====================
+FinishShadowVolume
+
+Creates the shadow volume and light indices from the triangle facing and culling
+and writes out the results.
+=====================
+*/
+static void FinishShadowVolume( const dynamicShadowVolumeParms_t* parms, triIndex_t* indexBuffer, bool depthCulled, int numFrontFacing, bool renderZFail, float shadowZMin, float shadowZMax )
+{
+	int numShadowIndices = 0;
+	int numLightIndices = 0;
+	
+	if( !depthCulled )
+	{
 		// Create shadow volume indices.
 		if( parms->shadowIndices != NULL )
 		{
@@ -1269,7 +1452,7 @@ void DynamicShadowVolumeJob( const dynamicShadowVolumeParms_t* parms )
 				bool renderShadowCaps = parms->forceShadowCaps || renderZFail;
 				
 				// Create new triangles along the silhouette planes and optionally add end-cap triangles on the model and on the distant projection.
-				R_CreateShadowVolumeTriangles( parms->shadowIndices, parms->indexBuffer, numShadowIndices, parms->tempFacing,
+				R_CreateShadowVolumeTriangles( parms->shadowIndices, indexBuffer, numShadowIndices, parms->tempFacing,
 											   parms->silEdges, parms->numSilEdges, parms->indexes, parms->numIndexes, renderShadowCaps );
 											   
 				assert( numShadowIndices <= parms->maxShadowIndices );
@@ -1279,7 +1462,7 @@ void DynamicShadowVolumeJob( const dynamicShadowVolumeParms_t* parms )
 		// Create new indices with only the triangles that are inside the light volume.
 		if( parms->lightIndices != NULL )
 		{
-			R_CreateLightTriangles( parms->lightIndices, parms->indexBuffer, numLightIndices, parms->tempCulled, parms->indexes, parms->numIndexes );
+			R_CreateLightTriangles( parms->lightIndices, indexBuffer, numLightIndices, parms->tempCulled, parms->indexes, parms->numIndexes );
 			
 			assert( numLightIndices <= parms->maxLightIndices );
 		}
@@ -1316,4 +1499,191 @@ void DynamicShadowVolumeJob( const dynamicShadowVolumeParms_t* parms )
 	}
 }
 
+/*
+=====================
+DynamicShadowVolumeJob
+
+Creates shadow volume indices for a surface that intersects a light.
+Optionally also creates new surface indices with just the triangles
+inside the light volume. These indices will be unique for a given
+light / surface combination.
+
+The shadow volume indices are created using the original surface vertices.
+However, the indices are setup to be used with a shadow volume vertex buffer
+with all vertices duplicated where the even vertices have the same positions
+as the surface vertices (at the near cap) and each odd vertex has the
+same position as the previous even vertex but is projected to infinity
+(the far cap) in the vertex program.
+=====================
+*/
+void DynamicShadowVolumeJob( const dynamicShadowVolumeParms_t* parms )
+{
+	if( parms->tempFacing == NULL )
+	{
+		*const_cast< byte** >( &parms->tempFacing ) = ( byte* )_alloca16( TEMP_FACING( parms->numIndexes ) );
+	}
+	if( parms->tempCulled == NULL )
+	{
+		*const_cast< byte** >( &parms->tempCulled ) = ( byte* )_alloca16( TEMP_CULL( parms->numIndexes ) );
+	}
+	if( parms->tempVerts == NULL && parms->joints != NULL )
+	{
+		*const_cast< idVec4** >( &parms->tempVerts ) = ( idVec4* )_alloca16( TEMP_VERTS( parms->numVerts ) );
+	}
+	if( parms->indexBuffer == NULL )
+	{
+		*const_cast< triIndex_t** >( &parms->indexBuffer ) = ( triIndex_t* )_alloca16( OUTPUT_INDEX_BUFFER_SIZE );
+	}
+	
+	assert( parms->joints == NULL || parms->numJoints > 0 );
+	
+	float shadowZMin;
+	float shadowZMax;
+	bool renderZFail;
+	bool preciseInsideTest;
+	int numFrontFacing = 0;
+	
+	const bool depthCulled = !SetupShadowVolume( parms, shadowZMin, shadowZMax, renderZFail, preciseInsideTest );
+	if( !depthCulled )
+	{
+		bool* preciseInsideShadowVolume = preciseInsideTest ? &renderZFail : NULL;
+		
+		// Calculate the facing of each triangle and cull each triangle to the light volume.
+		// Optionally also calculate more precisely whether or not the view is inside the shadow volume.
+		if( parms->joints != NULL )
+		{
+			SkinShadowVolumeVerts( parms->tempVerts, parms->verts, parms->numVerts, parms->joints );
+			
+			numFrontFacing = CalculateTriangleFacingCulledSkinned( parms->tempFacing, parms->tempCulled, parms->tempVerts, parms->indexes, parms->numIndexes,
+							 parms->localLightOrigin, parms->localViewOrigin,
+							 parms->cullShadowTrianglesToLight, parms->localLightProject,
+							 preciseInsideShadowVolume, parms->zNear * INSIDE_SHADOW_VOLUME_EXTRA_STRETCH, parms->useAVX2 );
+		}
+		else
+		{
+			numFrontFacing = CalculateTriangleFacingCulledStatic( parms->tempFacing, parms->tempCulled, parms->indexes, parms->numIndexes,
+							 parms->verts, parms->numVerts,
+							 parms->localLightOrigin, parms->localViewOrigin,
+							 parms->cullShadowTrianglesToLight, parms->localLightProject,
+							 preciseInsideShadowVolume, parms->zNear * INSIDE_SHADOW_VOLUME_EXTRA_STRETCH, parms->useAVX2 );
+		}
+	}
+	
+	FinishShadowVolume( parms, parms->indexBuffer, depthCulled, numFrontFacing, renderZFail, shadowZMin, shadowZMax );
+}
+
+/*
+=====================
+DynamicShadowVolume_SetupSplit
+
+Sets up a surface to be processed by several jobs. The parms must have the temp
+buffers allocated and 'subParms' must hold the vertex and triangle ranges. First
+a DynamicShadowVolumeSkinJob is run for each sub parms of a skinned surface, and
+once all of those have completed a DynamicShadowVolumeFacingJob is run for each
+sub parms. The last facing job to complete creates the indices for the surface.
+=====================
+*/
+void DynamicShadowVolume_SetupSplit( dynamicShadowVolumeSplit_t* split, const dynamicShadowVolumeParms_t* parms, dynamicShadowVolumeSubParms_t* subParms, int numSubParms )
+{
+	assert( parms->tempFacing != NULL && parms->tempCulled != NULL );
+	assert( parms->joints == NULL || parms->tempVerts != NULL );
+	
+	split->parms = parms;
+	split->subParms = subParms;
+	split->numSubParms = numSubParms;
+	split->depthCulled = !SetupShadowVolume( parms, split->shadowZMin, split->shadowZMax, split->renderZFail, split->preciseInsideTest );
+	split->numUnfinished = numSubParms;
+	split->next = NULL;
+	
+	for( int i = 0; i < numSubParms; i++ )
+	{
+		assert( ( subParms[i].firstTriangle % SHADOW_VOLUME_SPLIT_ALIGN ) == 0 );
+		subParms[i].split = split;
+		subParms[i].numFrontFacing = 0;
+		subParms[i].insideShadowVolume = false;
+	}
+}
+
+/*
+=====================
+DynamicShadowVolumeSkinJob
+=====================
+*/
+void DynamicShadowVolumeSkinJob( const dynamicShadowVolumeSubParms_t* subParms )
+{
+	const dynamicShadowVolumeSplit_t* split = subParms->split;
+	const dynamicShadowVolumeParms_t* parms = split->parms;
+	
+	if( split->depthCulled || parms->joints == NULL || subParms->numVerts <= 0 )
+	{
+		return;
+	}
+	
+	SkinShadowVolumeVerts( parms->tempVerts + subParms->firstVert, parms->verts + subParms->firstVert, subParms->numVerts, parms->joints );
+}
+
+/*
+=====================
+DynamicShadowVolumeFacingJob
+
+Calculates the facing and culling of a range of triangles. The triangle ranges
+start at a multiple of SHADOW_VOLUME_SPLIT_ALIGN so the SIMD stores of one job
+never touch the facing or culled bytes of another job.
+=====================
+*/
+void DynamicShadowVolumeFacingJob( dynamicShadowVolumeSubParms_t* subParms )
+{
+	dynamicShadowVolumeSplit_t* split = subParms->split;
+	const dynamicShadowVolumeParms_t* parms = split->parms;
+	
+	if( !split->depthCulled && subParms->numTriangles > 0 )
+	{
+		byte* facing = parms->tempFacing + subParms->firstTriangle;
+		byte* culled = parms->tempCulled + subParms->firstTriangle;
+		const triIndex_t* indexes = parms->indexes + subParms->firstTriangle * 3;
+		const int numIndexes = subParms->numTriangles * 3;
+		bool* insideShadowVolume = split->preciseInsideTest ? &subParms->insideShadowVolume : NULL;
+		
+		if( parms->joints != NULL )
+		{
+			subParms->numFrontFacing = CalculateTriangleFacingCulledSkinned( facing, culled, parms->tempVerts, indexes, numIndexes,
+									   parms->localLightOrigin, parms->localViewOrigin,
+									   parms->cullShadowTrianglesToLight, parms->localLightProject,
+									   insideShadowVolume, parms->zNear * INSIDE_SHADOW_VOLUME_EXTRA_STRETCH, parms->useAVX2 );
+		}
+		else
+		{
+			subParms->numFrontFacing = CalculateTriangleFacingCulledStatic( facing, culled, indexes, numIndexes,
+									   parms->verts, parms->numVerts,
+									   parms->localLightOrigin, parms->localViewOrigin,
+									   parms->cullShadowTrianglesToLight, parms->localLightProject,
+									   insideShadowVolume, parms->zNear * INSIDE_SHADOW_VOLUME_EXTRA_STRETCH, parms->useAVX2 );
+		}
+	}
+	
+	// the last job to finish merges the results and creates the indices for the whole surface
+	if( Sys_InterlockedDecrement( split->numUnfinished ) != 0 )
+	{
+		return;
+	}
+	
+	int numFrontFacing = 0;
+	bool renderZFail = split->renderZFail;
+	for( int i = 0; i < split->numSubParms; i++ )
+	{
+		numFrontFacing += split->subParms[i].numFrontFacing;
+		renderZFail |= split->subParms[i].insideShadowVolume;
+	}
+	
+	triIndex_t* indexBuffer = parms->indexBuffer;
+	if( indexBuffer == NULL )
+	{
+		indexBuffer = ( triIndex_t* )_alloca16( OUTPUT_INDEX_BUFFER_SIZE );
+	}
+	
+	FinishShadowVolume( parms, indexBuffer, split->depthCulled, numFrontFacing, renderZFail, split->shadowZMin, split->shadowZMax );
+}
+
 REGISTER_PARALLEL_JOB( DynamicShadowVolumeJob, "DynamicShadowVolumeJob" );
+REGISTER_PARALLEL_JOB( DynamicShadowVolumeSkinJob, "DynamicShadowVolumeSkinJob" );
+REGISTER_PARALLEL_JOB( DynamicShadowVolumeFacingJob, "DynamicShadowVolumeFacingJob" );
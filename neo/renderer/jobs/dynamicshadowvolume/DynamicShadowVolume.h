@@ -46,14 +46,21 @@ particularly important for spot lights that would otherwise cast shadows in all
 However, there can also be significant savings when a small point light touches a large
 model like for instance a world model.
 
+A surface with many triangles can be split over several jobs so a single large skinned
+model does not serialize the front end. The vertices are first skinned in parallel by
+vertex range, after which the triangle facing and culling is calculated in parallel by
+triangle range. The last job to finish merges the results and creates the shadow volume
+and light indices for the whole surface.
+
 ================================================================================================
 */
 
 #define TEMP_ROUND16( x )				( ( x + 15 ) & ~15 )
-#define TEMP_FACING( numIndexes )		TEMP_ROUND16( ( ( numIndexes / 3 + 3 ) & ~3 ) + 1 )	// rounded up for SIMD, plus 1 for dangling edges
-#define TEMP_CULL( numIndexes )			TEMP_ROUND16( ( ( numIndexes / 3 + 3 ) & ~3 ) )		// rounded up for SIMD
+#define TEMP_FACING( numIndexes )		TEMP_ROUND16( ( ( numIndexes / 3 + 7 ) & ~7 ) + 1 )	// rounded up for SIMD, plus 1 for dangling edges
+#define TEMP_CULL( numIndexes )			TEMP_ROUND16( ( ( numIndexes / 3 + 7 ) & ~7 ) )		// rounded up for SIMD
 #define TEMP_VERTS( numVerts )			TEMP_ROUND16( numVerts * sizeof( idVec4 ) )
 #define OUTPUT_INDEX_BUFFER_SIZE		4096
+#define SHADOW_VOLUME_SPLIT_ALIGN		32		// triangle ranges of split jobs start at a multiple of this for aligned index access
 
 struct silEdge_t
 {
@@ -90,6 +97,7 @@ struct dynamicShadowVolumeParms_t
 	bool							forceShadowCaps;
 	bool							useShadowPreciseInsideTest;
 	bool							useShadowDepthBounds;
+	bool							useAVX2;				// the CPU reports AVX2 and FMA3
 	// temp
 	byte* 							tempFacing;				// temp buffer in SPU local memory
 	byte* 							tempCulled;				// temp buffer in SPU local memory
@@ -111,8 +119,54 @@ struct dynamicShadowVolumeParms_t
 	int								pad;
 };
 
+struct dynamicShadowVolumeSplit_t;
+
+/*
+================================================
+dynamicShadowVolumeSubParms_t
+================================================
+*/
+struct dynamicShadowVolumeSubParms_t
+{
+	// input
+	dynamicShadowVolumeSplit_t* 	split;
+	int								firstVert;
+	int								numVerts;
+	int								firstTriangle;			// multiple of SHADOW_VOLUME_SPLIT_ALIGN
+	int								numTriangles;
+	// output
+	int								numFrontFacing;
+	bool							insideShadowVolume;
+};
+
+/*
+================================================
+dynamicShadowVolumeSplit_t
+
+The temp buffers of the parms must be allocated up front because they are
+shared by all the sub jobs.
+================================================
+*/
+struct dynamicShadowVolumeSplit_t
+{
+	const dynamicShadowVolumeParms_t* 	parms;
+	dynamicShadowVolumeSubParms_t* 	subParms;
+	int								numSubParms;
+	float							shadowZMin;
+	float							shadowZMax;
+	bool							depthCulled;
+	bool							renderZFail;
+	bool							preciseInsideTest;
+	interlockedInt_t				numUnfinished;			// sub jobs that still need to calculate facing
+	// next split in the current frame
+	dynamicShadowVolumeSplit_t* 	next;
+};
+
 
 void DynamicShadowVolumeJob( const dynamicShadowVolumeParms_t* parms );
+void DynamicShadowVolume_SetupSplit( dynamicShadowVolumeSplit_t* split, const dynamicShadowVolumeParms_t* parms, dynamicShadowVolumeSubParms_t* subParms, int numSubParms );
+void DynamicShadowVolumeSkinJob( const dynamicShadowVolumeSubParms_t* subParms );
+void DynamicShadowVolumeFacingJob( dynamicShadowVolumeSubParms_t* subParms );
 void DynamicShadowVolume_SetupSPURSHeader( CellSpursJob128* job, const dynamicShadowVolumeParms_t* parms );
 
 #endif // !__DYNAMICSHADOWVOLUME_H__
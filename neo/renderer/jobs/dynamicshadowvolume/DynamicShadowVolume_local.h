@@ -30,6 +30,7 @@ If you have questions concerning this license or the applicable additional terms
 
 #include "../../../idlib/ParallelJobList_JobHeaders.h"
 #include "../../../idlib/SoftwareCache.h"
+#include "../../../idlib/sys/sys_threading.h"
 
 #include "../../../idlib/math/Vector.h"
 #include "../../../idlib/math/Matrix.h"
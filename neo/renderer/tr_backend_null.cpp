@@ -0,0 +1,135 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#pragma hdrstop
+#include "precompiled.h"
+
+#include "tr_local.h"
+
+/*
+===============================================================================
+
+	Null backend
+
+	Used when r_nullRenderer is set.  The command buffer is walked exactly
+	like the GL backend does, including waiting on the shadow volume jobs
+	the frontend kicked off, but nothing is ever drawn.  This keeps the
+	frontend and game timings of a timedemo honest on machines without a
+	GPU or a display.
+
+===============================================================================
+*/
+
+/*
+====================
+RB_NullWaitForShadowVolumes
+
+The GL backend blocks on unfinished shadow volumes right before it draws
+them, so do the same to keep the job timings comparable.
+====================
+*/
+static void RB_NullWaitForShadowVolumes( const drawSurf_t* drawSurfs )
+{
+	for( const drawSurf_t* drawSurf = drawSurfs; drawSurf != NULL; drawSurf = drawSurf->nextOnLight )
+	{
+		if( drawSurf->shadowVolumeState != SHADOWVOLUME_DONE )
+		{
+			assert( drawSurf->shadowVolumeState == SHADOWVOLUME_UNFINISHED || drawSurf->shadowVolumeState == SHADOWVOLUME_DONE );
+			
+			uint64 start = Sys_Microseconds();
+			while( drawSurf->shadowVolumeState == SHADOWVOLUME_UNFINISHED )
+			{
+				Sys_Yield();
+			}
+			uint64 end = Sys_Microseconds();
+			
+			backEnd.pc.shadowMicroSec += end - start;
+		}
+	}
+}
+
+/*
+====================
+RB_NullDrawView
+====================
+*/
+static void RB_NullDrawView( const drawSurfsCommand_t* cmd )
+{
+	const viewDef_t* viewDef = cmd->viewDef;
+	
+	backEnd.viewDef = viewDef;
+	backEnd.pc.c_surfaces += viewDef->numDrawSurfs;
+	
+	for( const viewLight_t* vLight = viewDef->viewLights; vLight != NULL; vLight = vLight->next )
+	{
+		RB_NullWaitForShadowVolumes( vLight->globalShadows );
+		RB_NullWaitForShadowVolumes( vLight->localShadows );
+		RB_NullWaitForShadowVolumes( vLight->localInteractions );
+		RB_NullWaitForShadowVolumes( vLight->globalInteractions );
+		RB_NullWaitForShadowVolumes( vLight->translucentInteractions );
+	}
+}
+
+/*
+====================
+RB_ExecuteNullBackEndCommands
+====================
+*/
+void RB_ExecuteNullBackEndCommands( const emptyCommand_t* cmds )
+{
+	if( cmds->commandId == RC_NOP && !cmds->next )
+	{
+		return;
+	}
+	
+	uint64 backEndStartTime = Sys_Microseconds();
+	
+	for( ; cmds != NULL; cmds = ( const emptyCommand_t* )cmds->next )
+	{
+		switch( cmds->commandId )
+		{
+			case RC_NOP:
+			case RC_SET_BUFFER:
+			case RC_COPY_RENDER:
+			case RC_POST_PROCESS:
+				break;
+			case RC_DRAW_VIEW_3D:
+			case RC_DRAW_VIEW_GUI:
+				RB_NullDrawView( ( const drawSurfsCommand_t* )cmds );
+				break;
+			default:
+				common->Error( "RB_ExecuteNullBackEndCommands: bad commandId" );
+				break;
+		}
+	}
+	
+	backEnd.viewDef = NULL;
+	
+	uint64 backEndFinishTime = Sys_Microseconds();
+	backEnd.pc.totalMicroSec = backEndFinishTime - backEndStartTime;
+}
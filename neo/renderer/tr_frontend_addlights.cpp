@@ -39,6 +39,7 @@ extern idCVar r_useShadowPreciseInsideTest;
 
 idCVar r_useAreasConnectedForShadowCulling( "r_useAreasConnectedForShadowCulling", "2", CVAR_RENDERER | CVAR_INTEGER, "cull entities cut off by doors" );
 idCVar r_useParallelAddLights( "r_useParallelAddLights", "1", CVAR_RENDERER | CVAR_BOOL, "aadd all lights in parallel with jobs" );
+idCVar r_useCachedLightEntityRefs( "r_useCachedLightEntityRefs", "1", CVAR_RENDERER | CVAR_BOOL, "only walk the areas of a light for entities again after something in them changed" );
 
 /*
 ============================
@@ -83,6 +84,231 @@ bool idRenderEntityLocal::IsDirectlyVisible() const
 	return true;
 }
 
+/*
+===================
+R_AddSingleLightEntity
+
+Decides if an entity sharing an area with the light needs an interaction, and
+chains it on vLight->shadowOnlyViewEntities if it is only needed for shadows.
+
+If culledToLight is not NULL it holds the cached result of culling the entity
+reference bounds to the light volume.
+===================
+*/
+static void R_AddSingleLightEntity( viewLight_t* vLight, idRenderEntityLocal* edef, const bool* culledToLight )
+{
+	const viewDef_t* viewDef = tr.viewDef;
+	const idRenderLightLocal* light = vLight->lightDef;
+	const bool lightCastsShadows = light->LightCastsShadows();
+	
+	// until proven otherwise
+	vLight->entityInteractionState[ edef->index ] = viewLight_t::INTERACTION_NO;
+	
+	// The table is updated at interaction::AllocAndLink() and interaction::UnlinkAndFree()
+	const idInteraction* inter = light->world->interactionTable[ light->index * light->world->interactionTableWidth + edef->index ];
+	
+	const renderEntity_t& eParms = edef->parms;
+	const idRenderModel* eModel = eParms.hModel;
+	
+	// a large fraction of static entity / light pairs will still have no interactions even though
+	// they are both present in the same area(s)
+	if( eModel != NULL && !eModel->IsDynamicModel() && inter == INTERACTION_EMPTY )
+	{
+		// the interaction was statically checked, and it didn't generate any surfaces,
+		// so there is no need to force the entity onto the view list if it isn't
+		// already there
+		return;
+	}
+	
+	// We don't want the lights on weapons to illuminate anything else.
+	// There are two assumptions here -- that allowLightInViewID is only
+	// used for weapon lights, and that all weapons will have weaponDepthHack.
+	// A more general solution would be to have an allowLightOnEntityID field.
+	// HACK: the armor-mounted flashlight is a private spot light, which is probably
+	// wrong -- you would expect to see them in multiplayer.
+	//	if( light->parms.allowLightInViewID && light->parms.pointLight && !eParms.weaponDepthHack )
+	//	{
+	//		continue;
+	//	}
+	
+	// non-shadow casting entities don't need to be added if they aren't
+	// directly visible
+	if( ( eParms.noShadow || ( eModel && !eModel->ModelHasShadowCastingSurfaces() ) ) && !edef->IsDirectlyVisible() )
+	{
+		return;
+	}
+	
+	// if the model doesn't accept lighting or cast shadows, it doesn't need to be added
+	if( eModel && !eModel->ModelHasInteractingSurfaces() && !eModel->ModelHasShadowCastingSurfaces() )
+	{
+		return;
+	}
+	
+	// no interaction present, so either the light or entity has moved
+	// assert( lightHasMoved || edef->entityHasMoved );
+	if( inter == NULL )
+	{
+		// some big outdoor meshes are flagged to not create any dynamic interactions
+		// when the level designer knows that nearby moving lights shouldn't actually hit them
+		if( eParms.noDynamicInteractions )
+		{
+			return;
+		}
+		
+		// do a check of the entity reference bounds against the light frustum to see if they can't
+		// possibly interact, despite sharing one or more world areas
+		if( culledToLight != NULL ? *culledToLight : R_CullModelBoundsToLight( light, edef->localReferenceBounds, edef->modelRenderMatrix ) )
+		{
+			return;
+		}
+	}
+	
+	// we now know that the entity and light do overlap
+	
+	if( edef->IsDirectlyVisible() )
+	{
+		// entity is directly visible, so the interaction is definitely needed
+		vLight->entityInteractionState[ edef->index ] = viewLight_t::INTERACTION_YES;
+		return;
+	}
+	
+	// the entity is not directly visible, but if we can tell that it may cast
+	// shadows onto visible surfaces, we must make a viewEntity for it
+	if( !lightCastsShadows )
+	{
+		// surfaces are never shadowed in this light
+		return;
+	}
+	// if we are suppressing its shadow in this view (player shadows, etc), skip
+	if( !r_skipSuppress.GetBool() )
+	{
+		if( eParms.suppressShadowInViewID && eParms.suppressShadowInViewID == viewDef->renderView.viewID )
+		{
+			return;
+		}
+		if( eParms.suppressShadowInLightID && eParms.suppressShadowInLightID == light->parms.lightId )
+		{
+			return;
+		}
+	}
+	
+	// should we use the shadow bounds from pre-calculated interactions?
+	idBounds shadowBounds;
+	R_ShadowBounds( edef->globalReferenceBounds, light->globalLightBounds, light->globalLightOrigin, shadowBounds );
+	
+	// this test is pointless if we knew the light was completely contained
+	// in the view frustum, but the entity would also be directly visible in most
+	// of those cases.
+	
+	// this doesn't say that the shadow can't effect anything, only that it can't
+	// effect anything in the view, so we shouldn't set up a view entity
+	if( idRenderMatrix::CullBoundsToMVP( viewDef->worldSpace.mvp, shadowBounds ) )
+	{
+		return;
+	}
+	
+	// debug tool to allow viewing of only one entity at a time
+	if( r_singleEntity.GetInteger() >= 0 && r_singleEntity.GetInteger() != edef->index )
+	{
+		return;
+	}
+	
+	// we do need it for shadows
+	vLight->entityInteractionState[ edef->index ] = viewLight_t::INTERACTION_YES;
+	
+	// we will need to create a viewEntity_t for it in the serial code section
+	shadowOnlyEntity_t* shadEnt = ( shadowOnlyEntity_t* )R_FrameAlloc( sizeof( shadowOnlyEntity_t ), FRAME_ALLOC_SHADOW_ONLY_ENTITY );
+	shadEnt->next = vLight->shadowOnlyViewEntities;
+	shadEnt->edef = edef;
+	vLight->shadowOnlyViewEntities = shadEnt;
+}
+
+/*
+===================
+R_LightEntityRefCacheIsCurrent
+
+The cached entity list stays valid until the light changes shape, an entity
+is linked into or out of one of the light's areas, or a portal changes state.
+===================
+*/
+static bool R_LightEntityRefCacheIsCurrent( const idRenderLightLocal* light )
+{
+	if( light->entityRefCacheGeneration == 0 )
+	{
+		return false;
+	}
+	if( light->entityRefCacheConnectedAreaNum != light->world->connectedAreaNum )
+	{
+		return false;
+	}
+	if( light->entityRefCacheConnectedMode != r_useAreasConnectedForShadowCulling.GetInteger() )
+	{
+		return false;
+	}
+	for( const areaReference_t* lref = light->references; lref != NULL; lref = lref->ownerNext )
+	{
+		if( lref->area->entityRefGeneration > light->entityRefCacheGeneration )
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+/*
+===================
+R_BuildLightEntityRefCache
+
+Walks the light's areas and records every entity found in them, along with the
+result of culling its reference bounds to the light volume.  Only the light's
+own cache is written, so this may run in parallel with other lights.
+
+visited is a cleared array of entityDefs.Num() bytes used to skip entities
+present in more than one area.
+===================
+*/
+static void R_BuildLightEntityRefCache( idRenderLightLocal* light, byte* visited )
+{
+	const int connectedMode = r_useAreasConnectedForShadowCulling.GetInteger();
+	
+	light->entityRefCache.SetNum( 0 );
+	
+	for( areaReference_t* lref = light->references; lref != NULL; lref = lref->ownerNext )
+	{
+		portalArea_t* area = lref->area;
+		
+		// some lights have their center of projection outside the world, but otherwise
+		// we want to ignore areas that are not connected to the light center due to a closed door
+		if( light->areaNum != -1 && connectedMode == 2 )
+		{
+			if( !light->world->AreasAreConnected( light->areaNum, area->areaNum, PS_BLOCK_VIEW ) )
+			{
+				// can't possibly be seen or shadowed
+				continue;
+			}
+		}
+		
+		for( areaReference_t* eref = area->entityRefs.areaNext; eref != &area->entityRefs; eref = eref->areaNext )
+		{
+			idRenderEntityLocal* edef = eref->entity;
+			
+			if( visited[ edef->index ] != viewLight_t::INTERACTION_UNCHECKED )
+			{
+				continue;
+			}
+			visited[ edef->index ] = viewLight_t::INTERACTION_NO;
+			
+			lightEntityRef_t& ref = light->entityRefCache.Alloc();
+			ref.entityDef = edef;
+			ref.culledToLight = R_CullModelBoundsToLight( light, edef->localReferenceBounds, edef->modelRenderMatrix );
+		}
+	}
+	
+	light->entityRefCacheGeneration = light->world->entityRefGeneration;
+	light->entityRefCacheConnectedAreaNum = light->world->connectedAreaNum;
+	light->entityRefCacheConnectedMode = connectedMode;
+}
+
 /*
 ===================
 R_AddSingleLight
@@ -349,157 +575,56 @@ static void R_AddSingleLight( viewLight_t* vLight )
 	// that may cast shadows, even if they aren't directly visible.  Any real work
 	// will be deferred until we walk through the viewEntities
 	//--------------------------------------------
-	const int renderViewID = viewDef->renderView.viewID;
 	
 	// this bool array will be set true whenever the entity will visibly interact with the light
 	vLight->entityInteractionState = ( byte* )R_ClearedFrameAlloc( light->world->entityDefs.Num() * sizeof( vLight->entityInteractionState[0] ), FRAME_ALLOC_INTERACTION_STATE );
 	
-	idInteraction** const interactionTableRow = light->world->interactionTable + light->index * light->world->interactionTableWidth;
-	
-	for( areaReference_t* lref = light->references; lref != NULL; lref = lref->ownerNext )
+	if( r_useCachedLightEntityRefs.GetBool() )
 	{
-		portalArea_t* area = lref->area;
-		
-		// some lights have their center of projection outside the world, but otherwise
-		// we want to ignore areas that are not connected to the light center due to a closed door
-		if( light->areaNum != -1 && r_useAreasConnectedForShadowCulling.GetInteger() == 2 )
+		// the area walk and light culling only depend on the light and entity placement,
+		// so they are redone only after something in the light's areas has changed
+		idRenderLightLocal* cacheLight = vLight->lightDef;
+		if( !R_LightEntityRefCacheIsCurrent( cacheLight ) )
 		{
-			if( !light->world->AreasAreConnected( light->areaNum, area->areaNum, PS_BLOCK_VIEW ) )
-			{
-				// can't possibly be seen or shadowed
-				continue;
-			}
+			R_BuildLightEntityRefCache( cacheLight, vLight->entityInteractionState );
 		}
 		
-		// check all the models in this area
-		for( areaReference_t* eref = area->entityRefs.areaNext; eref != &area->entityRefs; eref = eref->areaNext )
+		const int numRefs = cacheLight->entityRefCache.Num();
+		for( int i = 0; i < numRefs; i++ )
 		{
-			idRenderEntityLocal* edef = eref->entity;
-			
-			if( vLight->entityInteractionState[ edef->index ] != viewLight_t::INTERACTION_UNCHECKED )
-			{
-				continue;
-			}
-			// until proven otherwise
-			vLight->entityInteractionState[ edef->index ] = viewLight_t::INTERACTION_NO;
-			
-			// The table is updated at interaction::AllocAndLink() and interaction::UnlinkAndFree()
-			const idInteraction* inter = interactionTableRow[ edef->index ];
-			
-			const renderEntity_t& eParms = edef->parms;
-			const idRenderModel* eModel = eParms.hModel;
-			
-			// a large fraction of static entity / light pairs will still have no interactions even though
-			// they are both present in the same area(s)
-			if( eModel != NULL && !eModel->IsDynamicModel() && inter == INTERACTION_EMPTY )
-			{
-				// the interaction was statically checked, and it didn't generate any surfaces,
-				// so there is no need to force the entity onto the view list if it isn't
-				// already there
-				continue;
-			}
-			
-			// We don't want the lights on weapons to illuminate anything else.
-			// There are two assumptions here -- that allowLightInViewID is only
-			// used for weapon lights, and that all weapons will have weaponDepthHack.
-			// A more general solution would be to have an allowLightOnEntityID field.
-			// HACK: the armor-mounted flashlight is a private spot light, which is probably
-			// wrong -- you would expect to see them in multiplayer.
-			//	if( light->parms.allowLightInViewID && light->parms.pointLight && !eParms.weaponDepthHack )
-			//	{
-			//		continue;
-			//	}
-			
-			// non-shadow casting entities don't need to be added if they aren't
-			// directly visible
-			if( ( eParms.noShadow || ( eModel && !eModel->ModelHasShadowCastingSurfaces() ) ) && !edef->IsDirectlyVisible() )
-			{
-				continue;
-			}
-			
-			// if the model doesn't accept lighting or cast shadows, it doesn't need to be added
-			if( eModel && !eModel->ModelHasInteractingSurfaces() && !eModel->ModelHasShadowCastingSurfaces() )
-			{
-				continue;
-			}
+			const lightEntityRef_t& ref = cacheLight->entityRefCache[i];
+			R_AddSingleLightEntity( vLight, ref.entityDef, &ref.culledToLight );
+		}
+	}
+	else
+	{
+		for( areaReference_t* lref = light->references; lref != NULL; lref = lref->ownerNext )
+		{
+			portalArea_t* area = lref->area;
 			
-			// no interaction present, so either the light or entity has moved
-			// assert( lightHasMoved || edef->entityHasMoved );
-			if( inter == NULL )
+			// some lights have their center of projection outside the world, but otherwise
+			// we want to ignore areas that are not connected to the light center due to a closed door
+			if( light->areaNum != -1 && r_useAreasConnectedForShadowCulling.GetInteger() == 2 )
 			{
-				// some big outdoor meshes are flagged to not create any dynamic interactions
-				// when the level designer knows that nearby moving lights shouldn't actually hit them
-				if( eParms.noDynamicInteractions )
-				{
-					continue;
-				}
-				
-				// do a check of the entity reference bounds against the light frustum to see if they can't
-				// possibly interact, despite sharing one or more world areas
-				if( R_CullModelBoundsToLight( light, edef->localReferenceBounds, edef->modelRenderMatrix ) )
+				if( !light->world->AreasAreConnected( light->areaNum, area->areaNum, PS_BLOCK_VIEW ) )
 				{
+					// can't possibly be seen or shadowed
 					continue;
 				}
 			}
 			
-			// we now know that the entity and light do overlap
-			
-			if( edef->IsDirectlyVisible() )
-			{
-				// entity is directly visible, so the interaction is definitely needed
-				vLight->entityInteractionState[ edef->index ] = viewLight_t::INTERACTION_YES;
-				continue;
-			}
-			
-			// the entity is not directly visible, but if we can tell that it may cast
-			// shadows onto visible surfaces, we must make a viewEntity for it
-			if( !lightCastsShadows )
-			{
-				// surfaces are never shadowed in this light
-				continue;
-			}
-			// if we are suppressing its shadow in this view (player shadows, etc), skip
-			if( !r_skipSuppress.GetBool() )
+			// check all the models in this area
+			for( areaReference_t* eref = area->entityRefs.areaNext; eref != &area->entityRefs; eref = eref->areaNext )
 			{
-				if( eParms.suppressShadowInViewID && eParms.suppressShadowInViewID == renderViewID )
-				{
-					continue;
-				}
-				if( eParms.suppressShadowInLightID && eParms.suppressShadowInLightID == light->parms.lightId )
+				idRenderEntityLocal* edef = eref->entity;
+				
+				if( vLight->entityInteractionState[ edef->index ] != viewLight_t::INTERACTION_UNCHECKED )
 				{
 					continue;
 				}
+				
+				R_AddSingleLightEntity( vLight, edef, NULL );
 			}
-			
-			// should we use the shadow bounds from pre-calculated interactions?
-			idBounds shadowBounds;
-			R_ShadowBounds( edef->globalReferenceBounds, light->globalLightBounds, light->globalLightOrigin, shadowBounds );
-			
-			// this test is pointless if we knew the light was completely contained
-			// in the view frustum, but the entity would also be directly visible in most
-			// of those cases.
-			
-			// this doesn't say that the shadow can't effect anything, only that it can't
-			// effect anything in the view, so we shouldn't set up a view entity
-			if( idRenderMatrix::CullBoundsToMVP( viewDef->worldSpace.mvp, shadowBounds ) )
-			{
-				continue;
-			}
-			
-			// debug tool to allow viewing of only one entity at a time
-			if( r_singleEntity.GetInteger() >= 0 && r_singleEntity.GetInteger() != edef->index )
-			{
-				continue;
-			}
-			
-			// we do need it for shadows
-			vLight->entityInteractionState[ edef->index ] = viewLight_t::INTERACTION_YES;
-			
-			// we will need to create a viewEntity_t for it in the serial code section
-			shadowOnlyEntity_t* shadEnt = ( shadowOnlyEntity_t* )R_FrameAlloc( sizeof( shadowOnlyEntity_t ), FRAME_ALLOC_SHADOW_ONLY_ENTITY );
-			shadEnt->next = vLight->shadowOnlyViewEntities;
-			shadEnt->edef = edef;
-			vLight->shadowOnlyViewEntities = shadEnt;
 		}
 	}
 	
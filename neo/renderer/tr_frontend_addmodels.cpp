@@ -41,11 +41,14 @@ idCVar r_useShadowPreciseInsideTest( "r_useShadowPreciseInsideTest", "1", CVAR_R
 idCVar r_cullDynamicShadowTriangles( "r_cullDynamicShadowTriangles", "1", CVAR_RENDERER | CVAR_BOOL, "cull occluder triangles that are outside the light frustum so they do not contribute to the dynamic shadow volume" );
 idCVar r_cullDynamicLightTriangles( "r_cullDynamicLightTriangles", "1", CVAR_RENDERER | CVAR_BOOL, "cull surface triangles that are outside the light frustum so they do not get rendered for interactions" );
 idCVar r_forceShadowCaps( "r_forceShadowCaps", "0", CVAR_RENDERER | CVAR_BOOL, "0 = skip rendering shadow caps if view is outside shadow volume, 1 = always render shadow caps" );
+idCVar r_shadowVolumeJobTriangles( "r_shadowVolumeJobTriangles", "8192", CVAR_RENDERER | CVAR_INTEGER, "dynamic shadow volumes of surfaces with more triangles are split over several jobs, 0 = never split", 0, 65536 );
 // RB begin
 idCVar r_forceShadowMapsOnAlphaTestedSurfaces( "r_forceShadowMapsOnAlphaTestedSurfaces", "1", CVAR_RENDERER | CVAR_BOOL, "0 = same shadowing as with stencil shadows, 1 = ignore noshadows for alpha tested materials" );
 // RB end
 // foresthale 2014-11-24: cvar to control the material lod flags - this is the distance at which a mesh switches from lod1 to lod2, where lod3 will appear at this distance *2, lod4 at *4, and persistentLOD keyword will disable the max distance check (thus extending this LOD to all further distances, rather than disappearing)
 idCVar r_lodMaterialDistance( "r_lodMaterialDistance", "500", CVAR_RENDERER | CVAR_FLOAT, "surfaces further than this distance will use lower quality versions (if their material uses the lod1-4 keywords, persistentLOD disables the max distance checks)" );
+idCVar r_useModelLODs( "r_useModelLODs", "1", CVAR_RENDERER | CVAR_BOOL, "draw the simplified surfaces generated for static models when they are small on screen" );
+idCVar r_modelLODPixelError( "r_modelLODPixelError", "1", CVAR_RENDERER | CVAR_FLOAT, "how many pixels a simplified model surface may deviate from the original on screen" );
 
 static const float CHECK_BOUNDS_EPSILON = 1.0f;
 
@@ -156,6 +159,9 @@ bool R_IssueEntityDefCallback( idRenderEntityLocal* def )
 	}
 	tr.pc.c_entityDefCallbacks++;
 	
+	// the callback may have changed the shader parms
+	R_ClearEntityDefRegisterCache( def );
+	
 	if( def->parms.hModel == NULL )
 	{
 		common->Error( "R_IssueEntityDefCallback: dynamic entity callback didn't set model" );
@@ -272,13 +278,61 @@ idRenderModel* R_EntityDefDynamicModel( idRenderEntityLocal* def )
 	return def->dynamicModel;
 }
 
+/*
+===================
+R_ClearEntityDefRegisterCache
+===================
+*/
+void R_ClearEntityDefRegisterCache( idRenderEntityLocal* def )
+{
+	for( int i = 0; i < MAX_ENTITY_REGISTER_CACHE; i++ )
+	{
+		def->registerCache[i].material = NULL;
+	}
+}
+
+/*
+===================
+R_FindCachedShaderRegisters
+
+Only used from the job that is adding the entity to the current view.
+===================
+*/
+static const float* R_FindCachedShaderRegisters( const idRenderEntityLocal* def, const idMaterial* shader, float floatTime )
+{
+	if( !r_useCachedShaderRegisters.GetBool() )
+	{
+		return NULL;
+	}
+	
+	// the global parms, and whatever a reference shader reads, can be different in a subview
+	const bool viewDependent = ( shader->GetRegisterDependencies() & EXP_DEPEND_GLOBAL ) != 0 || def->parms.referenceShader != NULL;
+	
+	for( int i = 0; i < MAX_ENTITY_REGISTER_CACHE; i++ )
+	{
+		const entityRegisterCache_t& cache = def->registerCache[i];
+		if( cache.material != shader || cache.frameCount != tr.frameCount || cache.floatTime != floatTime )
+		{
+			continue;
+		}
+		if( viewDependent && cache.viewCount != tr.viewCount )
+		{
+			continue;
+		}
+		return cache.registers;
+	}
+	return NULL;
+}
+
 /*
 ===================
 R_SetupDrawSurfShader
 ===================
 */
-void R_SetupDrawSurfShader( drawSurf_t* drawSurf, const idMaterial* shader, const renderEntity_t* renderEntity )
+void R_SetupDrawSurfShader( drawSurf_t* drawSurf, const idMaterial* shader, idRenderEntityLocal* entityDef )
 {
+	const renderEntity_t* renderEntity = &entityDef->parms;
+	
 	drawSurf->material = shader;
 	drawSurf->sort = shader->GetSort();
 	
@@ -288,43 +342,58 @@ void R_SetupDrawSurfShader( drawSurf_t* drawSurf, const idMaterial* shader, cons
 	{
 		// shader only uses constant values
 		drawSurf->shaderRegisters = constRegs;
+		return;
 	}
-	else
+	
+	const float floatTime = tr.viewDef->renderView.time[renderEntity->timeGroup] * 0.001f;
+	
+	// other surfaces of the entity, its shadows and interactions often use the same material
+	const float* cachedRegs = R_FindCachedShaderRegisters( entityDef, shader, floatTime );
+	if( cachedRegs != NULL )
 	{
-		// by default evaluate with the entityDef's shader parms
-		const float* shaderParms = renderEntity->shaderParms;
-		
-		// a reference shader will take the calculated stage color value from another shader
-		// and use that for the parm0-parm3 of the current shader, which allows a stage of
-		// a light model and light flares to pick up different flashing tables from
-		// different light shaders
-		float generatedShaderParms[MAX_ENTITY_SHADER_PARMS];
-		if( unlikely( renderEntity->referenceShader != NULL ) )
-		{
-			// evaluate the reference shader to find our shader parms
-			float refRegs[MAX_EXPRESSION_REGISTERS];
-			renderEntity->referenceShader->EvaluateRegisters( refRegs, renderEntity->shaderParms,
-					tr.viewDef->renderView.shaderParms,
-					tr.viewDef->renderView.time[renderEntity->timeGroup] * 0.001f, renderEntity->referenceSound );
-					
-			const shaderStage_t* pStage = renderEntity->referenceShader->GetStage( 0 );
-			
-			memcpy( generatedShaderParms, renderEntity->shaderParms, sizeof( generatedShaderParms ) );
-			generatedShaderParms[0] = refRegs[ pStage->color.registers[0] ];
-			generatedShaderParms[1] = refRegs[ pStage->color.registers[1] ];
-			generatedShaderParms[2] = refRegs[ pStage->color.registers[2] ];
-			
-			shaderParms = generatedShaderParms;
-		}
+		drawSurf->shaderRegisters = cachedRegs;
+		return;
+	}
+	
+	// by default evaluate with the entityDef's shader parms
+	const float* shaderParms = renderEntity->shaderParms;
+	
+	// a reference shader will take the calculated stage color value from another shader
+	// and use that for the parm0-parm3 of the current shader, which allows a stage of
+	// a light model and light flares to pick up different flashing tables from
+	// different light shaders
+	float generatedShaderParms[MAX_ENTITY_SHADER_PARMS];
+	if( unlikely( renderEntity->referenceShader != NULL ) )
+	{
+		// evaluate the reference shader to find our shader parms
+		float refRegs[MAX_EXPRESSION_REGISTERS];
+		renderEntity->referenceShader->EvaluateRegisters( refRegs, renderEntity->shaderParms,
+				tr.viewDef->renderView.shaderParms, floatTime, renderEntity->referenceSound );
+				
+		const shaderStage_t* pStage = renderEntity->referenceShader->GetStage( 0 );
 		
-		// allocate frame memory for the shader register values
-		float* regs = ( float* )R_FrameAlloc( shader->GetNumRegisters() * sizeof( float ), FRAME_ALLOC_SHADER_REGISTER );
-		drawSurf->shaderRegisters = regs;
+		memcpy( generatedShaderParms, renderEntity->shaderParms, sizeof( generatedShaderParms ) );
+		generatedShaderParms[0] = refRegs[ pStage->color.registers[0] ];
+		generatedShaderParms[1] = refRegs[ pStage->color.registers[1] ];
+		generatedShaderParms[2] = refRegs[ pStage->color.registers[2] ];
 		
-		// process the shader expressions for conditionals / color / texcoords
-		shader->EvaluateRegisters( regs, shaderParms, tr.viewDef->renderView.shaderParms,
-								   tr.viewDef->renderView.time[renderEntity->timeGroup] * 0.001f, renderEntity->referenceSound );
+		shaderParms = generatedShaderParms;
 	}
+	
+	// allocate frame memory for the shader register values
+	float* regs = ( float* )R_FrameAlloc( shader->GetNumRegisters() * sizeof( float ), FRAME_ALLOC_SHADER_REGISTER );
+	drawSurf->shaderRegisters = regs;
+	
+	// process the shader expressions for conditionals / color / texcoords
+	shader->EvaluateRegisters( regs, shaderParms, tr.viewDef->renderView.shaderParms, floatTime, renderEntity->referenceSound );
+	
+	entityRegisterCache_t& cache = entityDef->registerCache[entityDef->nextRegisterCache];
+	entityDef->nextRegisterCache = ( entityDef->nextRegisterCache + 1 ) % MAX_ENTITY_REGISTER_CACHE;
+	cache.material = shader;
+	cache.frameCount = tr.frameCount;
+	cache.viewCount = tr.viewCount;
+	cache.floatTime = floatTime;
+	cache.registers = regs;
 }
 
 /*
@@ -353,6 +422,18 @@ void R_SetupDrawSurfJoints( drawSurf_t* drawSurf, const srfTriangles_t* tri, con
 	drawSurf->jointCache = model->jointsInvertedBuffer;
 }
 
+/*
+===================
+R_ShadowVolumeUseAVX2
+
+The dynamic shadow volume jobs do not see the SIMD processor so they are told whether to use the AVX2 path.
+===================
+*/
+static bool R_ShadowVolumeUseAVX2()
+{
+	return ( SIMDProcessor->cpuid & ( CPUID_AVX2 | CPUID_FMA3 ) ) == ( CPUID_AVX2 | CPUID_FMA3 );
+}
+
 /*
 ===================
 R_AddSingleModel
@@ -577,6 +658,15 @@ void R_AddSingleModel( viewEntity_t* vEntity )
 	idVec3 localViewOrigin;
 	R_GlobalPointToLocal( vEntity->modelMatrix, viewDef->renderView.vieworg, localViewOrigin );
 	
+	// simplified surfaces may be used when their error projects to less than
+	// r_modelLODPixelError pixels, this converts a distance to the allowed error
+	float lodErrorScale = 0.0f;
+	if( r_useModelLODs.GetBool() && model->NumSurfaceLODs() > 0 )
+	{
+		const float viewportHeight = viewDef->viewport.y2 - viewDef->viewport.y1 + 1;
+		lodErrorScale = r_modelLODPixelError.GetFloat() * 2.0f / ( viewDef->projectionMatrix[1 * 4 + 1] * viewportHeight );
+	}
+	
 	//---------------------------
 	// add all the model surfaces
 	//---------------------------
@@ -632,6 +722,27 @@ void R_AddSingleModel( viewEntity_t* vEntity )
 			}
 		}
 		
+		// switch to simplified geometry if the surface is small enough on screen,
+		// the static interactions were built for the full detail surface so they
+		// are skipped in favor of the dynamic light and shadow paths
+		bool surfaceLOD = false;
+		if( lodErrorScale > 0.0f )
+		{
+			idVec3 nearestPointOnBounds;
+			for( int i = 0; i < 3; i++ )
+			{
+				nearestPointOnBounds[i] = idMath::ClampFloat( tri->bounds[0][i], tri->bounds[1][i], localViewOrigin[i] );
+			}
+			const float distance = ( nearestPointOnBounds - localViewOrigin ).LengthFast();
+			
+			srfTriangles_t* lodTri = model->SurfaceLOD( surfaceNum, distance * lodErrorScale );
+			if( lodTri != NULL )
+			{
+				tri = lodTri;
+				surfaceLOD = true;
+			}
+		}
+		
 		// foresthale 2014-09-01: don't skip surfaces that use the "forceShadows" flag
 		if( !shader->IsDrawn() && !shader->SurfaceCastsShadow() )
 		{
@@ -748,7 +859,7 @@ void R_AddSingleModel( viewEntity_t* vEntity )
 				baseDrawSurf->extraGLState = 0;
 				baseDrawSurf->renderZFail = 0;
 				
-				R_SetupDrawSurfShader( baseDrawSurf, shader, renderEntity );
+				R_SetupDrawSurfShader( baseDrawSurf, shader, entityDef );
 				
 				shaderRegisters = baseDrawSurf->shaderRegisters;
 				
@@ -810,7 +921,7 @@ void R_AddSingleModel( viewEntity_t* vEntity )
 			
 			// check for a static interaction
 			surfaceInteraction_t* surfInter = NULL;
-			if( interaction > INTERACTION_EMPTY && interaction->staticInteraction )
+			if( interaction > INTERACTION_EMPTY && interaction->staticInteraction && !surfaceLOD )
 			{
 				// we have a static interaction that was calculated accurately
 				assert( model->NumSurfaces() == interaction->numSurfaces );
@@ -852,7 +963,7 @@ void R_AddSingleModel( viewEntity_t* vEntity )
 					if( shaderRegisters == NULL )
 					{
 						drawSurf_t scratchSurf;
-						R_SetupDrawSurfShader( &scratchSurf, shader, renderEntity );
+						R_SetupDrawSurfShader( &scratchSurf, shader, entityDef );
 						shaderRegisters = scratchSurf.shaderRegisters;
 					}
 					
@@ -905,6 +1016,7 @@ void R_AddSingleModel( viewEntity_t* vEntity )
 									dynamicShadowParms->forceShadowCaps = false;
 									dynamicShadowParms->useShadowPreciseInsideTest = false;
 									dynamicShadowParms->useShadowDepthBounds = false;
+									dynamicShadowParms->useAVX2 = R_ShadowVolumeUseAVX2();
 									dynamicShadowParms->tempFacing = NULL;
 									dynamicShadowParms->tempCulled = NULL;
 									dynamicShadowParms->tempVerts = NULL;
@@ -1099,7 +1211,7 @@ void R_AddSingleModel( viewEntity_t* vEntity )
 						
 						if( shader->Coverage() == MC_PERFORATED )
 						{
-							R_SetupDrawSurfShader( shadowDrawSurf, shader, renderEntity );
+							R_SetupDrawSurfShader( shadowDrawSurf, shader, entityDef );
 						}
 						
 						R_SetupDrawSurfJoints( shadowDrawSurf, tri, shader );
@@ -1234,6 +1346,7 @@ void R_AddSingleModel( viewEntity_t* vEntity )
 					dynamicShadowParms->forceShadowCaps = forceShadowCaps;
 					dynamicShadowParms->useShadowPreciseInsideTest = r_useShadowPreciseInsideTest.GetBool();
 					dynamicShadowParms->useShadowDepthBounds = r_useShadowDepthBounds.GetBool();
+					dynamicShadowParms->useAVX2 = R_ShadowVolumeUseAVX2();
 					dynamicShadowParms->tempFacing = NULL;
 					dynamicShadowParms->tempCulled = NULL;
 					dynamicShadowParms->tempVerts = NULL;
@@ -1318,6 +1431,415 @@ void R_LinkDrawSurfToView( drawSurf_t* drawSurf, viewDef_t* viewDef )
 	viewDef->numDrawSurfs++;
 }
 
+/*
+===================
+R_SetupDynamicShadowVolumeSplit
+
+Divides the triangles of a surface into ranges of 'trianglesPerJob' triangles and the
+vertices into the same number of ranges. The temp buffers of the parms must be allocated.
+===================
+*/
+static void R_SetupDynamicShadowVolumeSplit( dynamicShadowVolumeSplit_t* split, const dynamicShadowVolumeParms_t* parms, dynamicShadowVolumeSubParms_t* subParms, const int numSubParms, const int trianglesPerJob )
+{
+	const int numTriangles = parms->numIndexes / 3;
+	for( int i = 0; i < numSubParms; i++ )
+	{
+		subParms[i].firstTriangle = i * trianglesPerJob;
+		subParms[i].numTriangles = Min( trianglesPerJob, numTriangles - subParms[i].firstTriangle );
+		subParms[i].firstVert = parms->numVerts * i / numSubParms;
+		subParms[i].numVerts = parms->numVerts * ( i + 1 ) / numSubParms - subParms[i].firstVert;
+	}
+	DynamicShadowVolume_SetupSplit( split, parms, subParms, numSubParms );
+}
+
+/*
+===================
+R_ShadowVolumeTrianglesPerJob
+
+Returns the number of triangles per job for surfaces that are split over several jobs, or 0 if surfaces are never split.
+===================
+*/
+static int R_ShadowVolumeTrianglesPerJob()
+{
+	return ALIGN( r_shadowVolumeJobTriangles.GetInteger(), SHADOW_VOLUME_SPLIT_ALIGN );
+}
+
+/*
+===================
+R_AddSplitDynamicShadowVolumeJobs
+
+Splits the shadow volume of a large surface over several jobs so a single large (skinned) model
+does not serialize the front end. The skin jobs are added right away. The facing jobs need the
+skinned vertices so they are added by R_AddDynamicShadowVolumeFacingJobs once the skin jobs are done.
+===================
+*/
+static dynamicShadowVolumeSplit_t* R_AddSplitDynamicShadowVolumeJobs( dynamicShadowVolumeParms_t* parms, const int trianglesPerJob )
+{
+	const int numSubParms = ( parms->numIndexes / 3 + trianglesPerJob - 1 ) / trianglesPerJob;
+	
+	// the temp buffers are shared by all the jobs so they can't be allocated on the stack of a job
+	parms->tempFacing = ( byte* )R_FrameAlloc( TEMP_FACING( parms->numIndexes ), FRAME_ALLOC_SHADOW_VOLUME_PARMS );
+	parms->tempCulled = ( byte* )R_FrameAlloc( TEMP_CULL( parms->numIndexes ), FRAME_ALLOC_SHADOW_VOLUME_PARMS );
+	if( parms->joints != NULL )
+	{
+		parms->tempVerts = ( idVec4* )R_FrameAlloc( TEMP_VERTS( parms->numVerts ), FRAME_ALLOC_SHADOW_VOLUME_PARMS );
+	}
+	
+	dynamicShadowVolumeSplit_t* split = ( dynamicShadowVolumeSplit_t* )R_FrameAlloc( sizeof( *split ), FRAME_ALLOC_SHADOW_VOLUME_PARMS );
+	dynamicShadowVolumeSubParms_t* subParms = ( dynamicShadowVolumeSubParms_t* )R_FrameAlloc( numSubParms * sizeof( subParms[0] ), FRAME_ALLOC_SHADOW_VOLUME_PARMS );
+	R_SetupDynamicShadowVolumeSplit( split, parms, subParms, numSubParms, trianglesPerJob );
+	
+	if( parms->joints != NULL )
+	{
+		for( int i = 0; i < numSubParms; i++ )
+		{
+			tr.frontEndJobList->AddJob( ( jobRun_t )DynamicShadowVolumeSkinJob, &subParms[i] );
+		}
+	}
+	return split;
+}
+
+/*
+===================
+R_AddDynamicShadowVolumeFacingJobs
+===================
+*/
+static void R_AddDynamicShadowVolumeFacingJobs( dynamicShadowVolumeSplit_t* splits )
+{
+	for( dynamicShadowVolumeSplit_t* split = splits; split != NULL; split = split->next )
+	{
+		for( int i = 0; i < split->numSubParms; i++ )
+		{
+			tr.frontEndJobList->AddJob( ( jobRun_t )DynamicShadowVolumeFacingJob, &split->subParms[i] );
+		}
+	}
+}
+
+/*
+==============================================================================================
+
+DYNAMIC SHADOW VOLUME BENCHMARK
+
+The inputs of the dynamic shadow volume jobs of a frame can be captured and then fed
+to the jobs repeatedly to measure the performance of the shadow volume construction.
+
+==============================================================================================
+*/
+
+struct shadowVolumeCapture_t
+{
+	dynamicShadowVolumeParms_t	parms;				// the input pointers reference copies owned by the capture
+	bool						createShadowIndices;
+	bool						createLightIndices;
+};
+
+struct shadowVolumeResult_t
+{
+	triIndex_t* 				shadowIndices;
+	triIndex_t* 				lightIndices;
+	int							numShadowIndices;
+	int							numLightIndices;
+	int							renderZFail;
+	float						shadowZMin;
+	float						shadowZMax;
+	volatile shadowVolumeState_t	shadowVolumeState;
+};
+
+static idList< shadowVolumeCapture_t* > shadowVolumeCaptures;
+static bool captureShadowVolumes = false;
+
+/*
+===================
+R_FreeShadowVolumeCaptures
+===================
+*/
+static void R_FreeShadowVolumeCaptures()
+{
+	for( int i = 0; i < shadowVolumeCaptures.Num(); i++ )
+	{
+		shadowVolumeCapture_t* capture = shadowVolumeCaptures[i];
+		Mem_Free( const_cast< idDrawVert* >( capture->parms.verts ) );
+		Mem_Free( const_cast< triIndex_t* >( capture->parms.indexes ) );
+		Mem_Free( const_cast< silEdge_t* >( capture->parms.silEdges ) );
+		Mem_Free( const_cast< idJointMat* >( capture->parms.joints ) );
+		delete capture;
+	}
+	shadowVolumeCaptures.Clear();
+}
+
+/*
+===================
+R_CaptureDynamicShadowVolume
+===================
+*/
+static void R_CaptureDynamicShadowVolume( const dynamicShadowVolumeParms_t* parms )
+{
+	shadowVolumeCapture_t* capture = new( TAG_RENDER_TOOLS ) shadowVolumeCapture_t;
+	memcpy( &capture->parms, parms, sizeof( capture->parms ) );
+	capture->createShadowIndices = ( parms->shadowIndices != NULL );
+	capture->createLightIndices = ( parms->lightIndices != NULL );
+	
+	dynamicShadowVolumeParms_t& copy = capture->parms;
+	
+	idDrawVert* verts = ( idDrawVert* )Mem_Alloc( parms->numVerts * sizeof( idDrawVert ), TAG_RENDER_TOOLS );
+	memcpy( verts, parms->verts, parms->numVerts * sizeof( idDrawVert ) );
+	copy.verts = verts;
+	
+	triIndex_t* indexes = ( triIndex_t* )Mem_Alloc( parms->numIndexes * sizeof( triIndex_t ), TAG_RENDER_TOOLS );
+	memcpy( indexes, parms->indexes, parms->numIndexes * sizeof( triIndex_t ) );
+	copy.indexes = indexes;
+	
+	silEdge_t* silEdges = ( silEdge_t* )Mem_Alloc( parms->numSilEdges * sizeof( silEdge_t ), TAG_RENDER_TOOLS );
+	memcpy( silEdges, parms->silEdges, parms->numSilEdges * sizeof( silEdge_t ) );
+	copy.silEdges = silEdges;
+	
+	idJointMat* joints = NULL;
+	if( parms->joints != NULL )
+	{
+		joints = ( idJointMat* )Mem_Alloc( parms->numJoints * sizeof( idJointMat ), TAG_RENDER_TOOLS );
+		memcpy( joints, parms->joints, parms->numJoints * sizeof( idJointMat ) );
+	}
+	copy.joints = joints;
+	
+	copy.tempFacing = NULL;
+	copy.tempCulled = NULL;
+	copy.tempVerts = NULL;
+	copy.indexBuffer = NULL;
+	copy.shadowIndices = NULL;
+	copy.numShadowIndices = NULL;
+	copy.lightIndices = NULL;
+	copy.numLightIndices = NULL;
+	copy.renderZFail = NULL;
+	copy.shadowZMin = NULL;
+	copy.shadowZMax = NULL;
+	copy.shadowVolumeState = NULL;
+	copy.next = NULL;
+	
+	shadowVolumeCaptures.Append( capture );
+}
+
+/*
+===================
+R_SetupShadowVolumeBenchmarkParms
+===================
+*/
+static void R_SetupShadowVolumeBenchmarkParms( dynamicShadowVolumeParms_t& parms, const shadowVolumeCapture_t* capture, shadowVolumeResult_t& result )
+{
+	parms = capture->parms;
+	parms.shadowIndices = capture->createShadowIndices ? result.shadowIndices : NULL;
+	parms.numShadowIndices = &result.numShadowIndices;
+	parms.lightIndices = capture->createLightIndices ? result.lightIndices : NULL;
+	parms.numLightIndices = &result.numLightIndices;
+	parms.renderZFail = &result.renderZFail;
+	parms.shadowZMin = &result.shadowZMin;
+	parms.shadowZMax = &result.shadowZMax;
+	parms.shadowVolumeState = &result.shadowVolumeState;
+}
+
+/*
+===================
+R_CompareShadowVolumeResults
+===================
+*/
+static bool R_CompareShadowVolumeResults( const shadowVolumeResult_t& a, const shadowVolumeResult_t& b )
+{
+	if( a.numShadowIndices != b.numShadowIndices || a.numLightIndices != b.numLightIndices || a.renderZFail != b.renderZFail )
+	{
+		return false;
+	}
+	if( a.shadowZMin != b.shadowZMin || a.shadowZMax != b.shadowZMax )
+	{
+		return false;
+	}
+	if( memcmp( a.shadowIndices, b.shadowIndices, a.numShadowIndices * sizeof( triIndex_t ) ) != 0 )
+	{
+		return false;
+	}
+	return memcmp( a.lightIndices, b.lightIndices, a.numLightIndices * sizeof( triIndex_t ) ) == 0;
+}
+
+/*
+===================
+R_BenchmarkShadowVolumes_f
+
+"benchmarkShadowVolumes capture" captures the inputs of the dynamic shadow volume jobs of the next frame.
+"benchmarkShadowVolumes [iterations]" runs the captured inputs through the jobs one after the other
+on this thread, in parallel with one job per surface, and in parallel with large surfaces split over
+several jobs, and verifies that all produce the same indices.
+===================
+*/
+void R_BenchmarkShadowVolumes_f( const idCmdArgs& args )
+{
+	if( args.Argc() > 1 && idStr::Icmp( args.Argv( 1 ), "capture" ) == 0 )
+	{
+		R_FreeShadowVolumeCaptures();
+		captureShadowVolumes = true;
+		common->Printf( "capturing the dynamic shadow volumes of the next frame\n" );
+		return;
+	}
+	
+	if( shadowVolumeCaptures.Num() == 0 )
+	{
+		common->Printf( "usage: benchmarkShadowVolumes [capture | iterations]\n" );
+		common->Printf( "no dynamic shadow volumes have been captured\n" );
+		return;
+	}
+	
+	const int iterations = ( args.Argc() > 1 ) ? Max( atoi( args.Argv( 1 ) ), 1 ) : 100;
+	const int trianglesPerJob = Max( R_ShadowVolumeTrianglesPerJob(), SHADOW_VOLUME_SPLIT_ALIGN );
+	const int numCaptures = shadowVolumeCaptures.Num();
+	
+	idList< shadowVolumeResult_t > results[3];
+	idList< dynamicShadowVolumeParms_t > parms;
+	idList< dynamicShadowVolumeSplit_t > splits;
+	idList< idList< dynamicShadowVolumeSubParms_t > > subParms;
+	parms.SetNum( numCaptures );
+	splits.SetNum( numCaptures );
+	subParms.SetNum( numCaptures );
+	
+	int numTriangles = 0;
+	int numSkinned = 0;
+	int numSplit = 0;
+	for( int i = 0; i < numCaptures; i++ )
+	{
+		const dynamicShadowVolumeParms_t& captured = shadowVolumeCaptures[i]->parms;
+		numTriangles += captured.numIndexes / 3;
+		numSkinned += ( captured.joints != NULL );
+		numSplit += ( captured.numIndexes / 3 > trianglesPerJob );
+	}
+	
+	for( int r = 0; r < 3; r++ )
+	{
+		results[r].SetNum( numCaptures );
+		for( int i = 0; i < numCaptures; i++ )
+		{
+			const dynamicShadowVolumeParms_t& captured = shadowVolumeCaptures[i]->parms;
+			shadowVolumeResult_t& result = results[r][i];
+			memset( &result, 0, sizeof( result ) );
+			result.shadowIndices = ( triIndex_t* )Mem_Alloc( Max( captured.maxShadowIndices, 1 ) * sizeof( triIndex_t ), TAG_RENDER_TOOLS );
+			result.lightIndices = ( triIndex_t* )Mem_Alloc( Max( captured.maxLightIndices, 1 ) * sizeof( triIndex_t ), TAG_RENDER_TOOLS );
+		}
+	}
+	
+	// one job after the other on this thread
+	const int64 serialStart = Sys_Microseconds();
+	for( int n = 0; n < iterations; n++ )
+	{
+		for( int i = 0; i < numCaptures; i++ )
+		{
+			R_SetupShadowVolumeBenchmarkParms( parms[i], shadowVolumeCaptures[i], results[0][i] );
+			DynamicShadowVolumeJob( &parms[i] );
+		}
+	}
+	const int64 serialEnd = Sys_Microseconds();
+	
+	// one job per surface
+	const int64 parallelStart = Sys_Microseconds();
+	for( int n = 0; n < iterations; n++ )
+	{
+		for( int i = 0; i < numCaptures; i++ )
+		{
+			R_SetupShadowVolumeBenchmarkParms( parms[i], shadowVolumeCaptures[i], results[1][i] );
+			tr.frontEndJobList->AddJob( ( jobRun_t )DynamicShadowVolumeJob, &parms[i] );
+		}
+		tr.frontEndJobList->Submit();
+		tr.frontEndJobList->Wait();
+	}
+	const int64 parallelEnd = Sys_Microseconds();
+	
+	// large surfaces split over several jobs, the temp buffers are allocated once up front
+	idList< byte* > tempFacing;
+	idList< byte* > tempCulled;
+	idList< idVec4* > tempVerts;
+	tempFacing.SetNum( numCaptures );
+	tempCulled.SetNum( numCaptures );
+	tempVerts.SetNum( numCaptures );
+	for( int i = 0; i < numCaptures; i++ )
+	{
+		const dynamicShadowVolumeParms_t& captured = shadowVolumeCaptures[i]->parms;
+		tempFacing[i] = NULL;
+		tempCulled[i] = NULL;
+		tempVerts[i] = NULL;
+		if( captured.numIndexes / 3 > trianglesPerJob )
+		{
+			subParms[i].SetNum( ( captured.numIndexes / 3 + trianglesPerJob - 1 ) / trianglesPerJob );
+			tempFacing[i] = ( byte* )Mem_Alloc( TEMP_FACING( captured.numIndexes ), TAG_RENDER_TOOLS );
+			tempCulled[i] = ( byte* )Mem_Alloc( TEMP_CULL( captured.numIndexes ), TAG_RENDER_TOOLS );
+			if( captured.joints != NULL )
+			{
+				tempVerts[i] = ( idVec4* )Mem_Alloc( TEMP_VERTS( captured.numVerts ), TAG_RENDER_TOOLS );
+			}
+		}
+	}
+	
+	const int64 splitStart = Sys_Microseconds();
+	for( int n = 0; n < iterations; n++ )
+	{
+		dynamicShadowVolumeSplit_t* splitList = NULL;
+		for( int i = 0; i < numCaptures; i++ )
+		{
+			R_SetupShadowVolumeBenchmarkParms( parms[i], shadowVolumeCaptures[i], results[2][i] );
+			if( subParms[i].Num() == 0 )
+			{
+				tr.frontEndJobList->AddJob( ( jobRun_t )DynamicShadowVolumeJob, &parms[i] );
+				continue;
+			}
+			parms[i].tempFacing = tempFacing[i];
+			parms[i].tempCulled = tempCulled[i];
+			parms[i].tempVerts = tempVerts[i];
+			R_SetupDynamicShadowVolumeSplit( &splits[i], &parms[i], subParms[i].Ptr(), subParms[i].Num(), trianglesPerJob );
+			if( parms[i].joints != NULL )
+			{
+				for( int j = 0; j < subParms[i].Num(); j++ )
+				{
+					tr.frontEndJobList->AddJob( ( jobRun_t )DynamicShadowVolumeSkinJob, &subParms[i][j] );
+				}
+			}
+			splits[i].next = splitList;
+			splitList = &splits[i];
+		}
+		tr.frontEndJobList->Submit();
+		tr.frontEndJobList->Wait();
+		if( splitList != NULL )
+		{
+			R_AddDynamicShadowVolumeFacingJobs( splitList );
+			tr.frontEndJobList->Submit();
+			tr.frontEndJobList->Wait();
+		}
+	}
+	const int64 splitEnd = Sys_Microseconds();
+	
+	int numMismatches = 0;
+	for( int i = 0; i < numCaptures; i++ )
+	{
+		if( !R_CompareShadowVolumeResults( results[0][i], results[1][i] ) || !R_CompareShadowVolumeResults( results[0][i], results[2][i] ) )
+		{
+			numMismatches++;
+		}
+	}
+	
+	common->Printf( "%d dynamic shadow volumes, %d skinned, %d triangles, %d split at %d triangles per job\n", numCaptures, numSkinned, numTriangles, numSplit, trianglesPerJob );
+	common->Printf( "serial:   %7.3f msec\n", ( serialEnd - serialStart ) / ( iterations * 1000.0f ) );
+	common->Printf( "parallel: %7.3f msec\n", ( parallelEnd - parallelStart ) / ( iterations * 1000.0f ) );
+	common->Printf( "split:    %7.3f msec\n", ( splitEnd - splitStart ) / ( iterations * 1000.0f ) );
+	common->Printf( "%d mismatches\n", numMismatches );
+	
+	for( int i = 0; i < numCaptures; i++ )
+	{
+		Mem_Free( tempFacing[i] );
+		Mem_Free( tempCulled[i] );
+		Mem_Free( tempVerts[i] );
+	}
+	for( int r = 0; r < 3; r++ )
+	{
+		for( int i = 0; i < numCaptures; i++ )
+		{
+			Mem_Free( results[r][i].shadowIndices );
+			Mem_Free( results[r][i].lightIndices );
+		}
+	}
+}
+
 /*
 ===================
 R_AddModels
@@ -1364,8 +1886,24 @@ void R_AddModels()
 	}
 	else
 	{
+		if( captureShadowVolumes )
+		{
+			for( viewEntity_t* vEntity = tr.viewDef->viewEntitys; vEntity != NULL; vEntity = vEntity->next )
+			{
+				for( dynamicShadowVolumeParms_t* shadowParms = vEntity->dynamicShadowVolumes; shadowParms != NULL; shadowParms = shadowParms->next )
+				{
+					R_CaptureDynamicShadowVolume( shadowParms );
+				}
+			}
+			common->Printf( "captured %d dynamic shadow volumes\n", shadowVolumeCaptures.Num() );
+			captureShadowVolumes = false;
+		}
+		
 		if( r_useParallelAddShadows.GetInteger() == 1 )
 		{
+			const int trianglesPerJob = R_ShadowVolumeTrianglesPerJob();
+			dynamicShadowVolumeSplit_t* splits = NULL;
+			
 			for( viewEntity_t* vEntity = tr.viewDef->viewEntitys; vEntity != NULL; vEntity = vEntity->next )
 			{
 				for( staticShadowVolumeParms_t* shadowParms = vEntity->staticShadowVolumes; shadowParms != NULL; shadowParms = shadowParms->next )
@@ -1374,6 +1912,13 @@ void R_AddModels()
 				}
 				for( dynamicShadowVolumeParms_t* shadowParms = vEntity->dynamicShadowVolumes; shadowParms != NULL; shadowParms = shadowParms->next )
 				{
+					if( trianglesPerJob > 0 && shadowParms->numIndexes / 3 > trianglesPerJob )
+					{
+						dynamicShadowVolumeSplit_t* split = R_AddSplitDynamicShadowVolumeJobs( shadowParms, trianglesPerJob );
+						split->next = splits;
+						splits = split;
+						continue;
+					}
 					tr.frontEndJobList->AddJob( ( jobRun_t )DynamicShadowVolumeJob, shadowParms );
 				}
 				vEntity->staticShadowVolumes = NULL;
@@ -1382,6 +1927,14 @@ void R_AddModels()
 			tr.frontEndJobList->Submit();
 			// wait here otherwise the shadow volume index buffer may be unmapped before all shadow volumes have been constructed
 			tr.frontEndJobList->Wait();
+			
+			// the facing of split surfaces is calculated once all vertices have been skinned
+			if( splits != NULL )
+			{
+				R_AddDynamicShadowVolumeFacingJobs( splits );
+				tr.frontEndJobList->Submit();
+				tr.frontEndJobList->Wait();
+			}
 		}
 		else
 		{
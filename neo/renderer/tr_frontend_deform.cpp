@@ -1107,7 +1107,7 @@ static drawSurf_t* R_ParticleDeform( drawSurf_t* surf, bool useArea )
 		drawSurf->extraGLState = 0;
 		drawSurf->renderZFail = 0;
 		
-		R_SetupDrawSurfShader( drawSurf, stage->material, renderEntity );
+		R_SetupDrawSurfShader( drawSurf, stage->material, surf->space->entityDef );
 		
 		drawSurf->linkChain = NULL;
 		drawSurf->nextOnLight = drawSurfList;
@@ -137,6 +137,15 @@ struct areaReference_t
 	struct portalArea_s*		area;					// so owners can find all the areas they are in
 };
 
+// the view independent part of walking a light's areas for entities, kept across frames
+// until the light changes shape, an entity is linked into or out of one of the light's
+// areas, or a portal changes state
+struct lightEntityRef_t
+{
+	idRenderEntityLocal* 	entityDef;
+	bool					culledToLight;			// reference bounds are completely outside the light volume
+};
+
 
 // idRenderLight should become the new public interface replacing the qhandle_t to light defs in the idRenderWorld interface
 class idRenderLight
@@ -221,6 +230,26 @@ public:
 	idInteraction* 			lastInteraction;
 	
 	struct doublePortal_s* 	foggedPortals;
+	
+	// entities in the light's areas, cached by R_AddSingleLight
+	idList<lightEntityRef_t, TAG_RENDER_LIGHT>	entityRefCache;
+	uint64					entityRefCacheGeneration;		// 0 when invalid, otherwise world->entityRefGeneration when built
+	int						entityRefCacheConnectedAreaNum;	// world->connectedAreaNum when built
+	int						entityRefCacheConnectedMode;	// r_useAreasConnectedForShadowCulling when built
+};
+
+
+// material registers evaluated for an entity, so the other surfaces, interactions
+// and shadows using the same material, and subviews in the same frame, can share them
+const int MAX_ENTITY_REGISTER_CACHE = 4;
+
+struct entityRegisterCache_t
+{
+	const idMaterial* 		material;
+	int						frameCount;
+	int						viewCount;
+	float					floatTime;
+	const float* 			registers;				// in frame temporary memory
 };
 
 
@@ -283,6 +312,11 @@ public:
 	idInteraction* 			lastInteraction;
 	
 	bool					needsPortalSky;
+	
+	int						staticBatch;			// index in world->staticBatches when merged, otherwise -1
+	
+	entityRegisterCache_t	registerCache[MAX_ENTITY_REGISTER_CACHE];	// see R_SetupDrawSurfShader
+	int						nextRegisterCache;
 };
 
 struct shadowOnlyEntity_t
@@ -672,6 +706,8 @@ struct performanceCounters_t
 	int		c_entityReferences;
 	int		c_lightReferences;
 	int		c_guiSurfs;
+	int		c_guiModelSurfaces;	// idGuiModel surfaces before batching
+	int		c_guiModelBatches;	// idGuiModel surfaces actually emitted
 	int		frontEndMicroSec;	// sum of time in all RE_RenderScene's in a frame
 };
 
@@ -923,6 +959,7 @@ public:
 	drawSurf_t				testImageSurface_;
 	
 	idParallelJobList* 		frontEndJobList;
+	idParallelJobList* 		loadJobList;		// level and model loading, never shared with a frame
 	
 	unsigned				timerQueryId;		// for GL_TIME_ELAPSED_EXT queries
 };
@@ -973,6 +1010,8 @@ extern idCVar r_useLightScissors;			// 1 = use custom scissor rectangle for each
 extern idCVar r_useEntityPortalCulling;		// 0 = none, 1 = box
 extern idCVar r_skipPrelightShadows;		// 1 = skip the dmap generated static shadow volumes
 extern idCVar r_useCachedDynamicModels;		// 1 = cache snapshots of dynamic models
+extern idCVar r_useCachedShaderRegisters;	// 1 = share evaluated material registers between surfaces of an entity
+extern idCVar r_useParticleBatches;			// 1 = evaluate particle stages in SIMD batches
 extern idCVar r_useScissor;					// 1 = scissor clip as portals and lights are processed
 extern idCVar r_usePortals;					// 1 = use portals to perform area culling, otherwise draw everything
 extern idCVar r_useStateCaching;			// avoid redundant state changes in GL_*() calls
@@ -994,6 +1033,7 @@ extern idCVar r_skipSuppress;				// ignore the per-view suppressions
 extern idCVar r_skipInteractions;			// skip all light/surface interaction drawing
 extern idCVar r_skipFrontEnd;				// bypasses all front end work, but 2D gui rendering still draws
 extern idCVar r_skipBackEnd;				// don't draw anything
+extern idCVar r_nullRenderer;				// headless: run the frontend, never touch GL
 extern idCVar r_skipCopyTexture;			// do all rendering, but don't actually copyTexSubImage2D
 extern idCVar r_skipRender;					// skip 3D rendering, but pass 2D
 extern idCVar r_skipRenderContext;			// NULL the rendering context during backend 3D rendering
@@ -1315,11 +1355,13 @@ bool R_IssueEntityDefCallback( idRenderEntityLocal* def );
 idRenderModel* R_EntityDefDynamicModel( idRenderEntityLocal* def );
 void R_ClearEntityDefDynamicModel( idRenderEntityLocal* def );
 
-void R_SetupDrawSurfShader( drawSurf_t* drawSurf, const idMaterial* shader, const renderEntity_t* renderEntity );
+void R_ClearEntityDefRegisterCache( idRenderEntityLocal* def );
+void R_SetupDrawSurfShader( drawSurf_t* drawSurf, const idMaterial* shader, idRenderEntityLocal* entityDef );
 void R_SetupDrawSurfJoints( drawSurf_t* drawSurf, const srfTriangles_t* tri, const idMaterial* shader );
 void R_LinkDrawSurfToView( drawSurf_t* drawSurf, viewDef_t* viewDef );
 
 void R_AddModels();
+void R_BenchmarkShadowVolumes_f( const idCmdArgs& args );
 
 /*
 =============================================================
@@ -1391,7 +1433,8 @@ void				R_RemoveDegenerateTriangles( srfTriangles_t* tri );
 void				R_RemoveUnusedVerts( srfTriangles_t* tri );
 void				R_RangeCheckIndexes( const srfTriangles_t* tri );
 void				R_CreateVertexNormals( srfTriangles_t* tri );		// also called by dmap
-void				R_CleanupTriangles( srfTriangles_t* tri, bool createNormals, bool identifySilEdges, bool useUnsmoothedTangents );
+void				R_CleanupTriangles( srfTriangles_t* tri, bool createNormals, bool identifySilEdges, bool useUnsmoothedTangents, bool optimizeOrder = false, bool optimizeOverdraw = false, bool deriveTangents = true );
+void				R_OptimizeTriangleOrder( srfTriangles_t* tri, bool optimizeOverdraw );
 void				R_ReverseTriangles( srfTriangles_t* tri );
 
 // Only deals with vertexes and indexes, not silhouettes, planes, etc.
@@ -1403,6 +1446,11 @@ srfTriangles_t* 	R_MergeTriangles( const srfTriangles_t* tri1, const srfTriangle
 // polarity of a triangle, the tangents will be incorrect
 void				R_DeriveTangents( srfTriangles_t* tri );
 
+// derives the normals and tangents of many surfaces at once, splitting the work over the
+// front end job list, so it can't be called from a front end job
+void				R_DeriveTangentsForSurfaces( srfTriangles_t** tris, int numSurfaces );
+void				R_TestDeriveTangents_f( const idCmdArgs& args );
+
 // copy data from a front-end srfTriangles_t to a back-end drawSurf_t
 void				R_InitDrawSurfFromTri( drawSurf_t& ds, srfTriangles_t& tri );
 
@@ -1477,6 +1525,7 @@ BACKEND
 */
 
 void RB_ExecuteBackEndCommands( const emptyCommand_t* cmds );
+void RB_ExecuteNullBackEndCommands( const emptyCommand_t* cmds );
 
 /*
 ============================================================
@@ -654,83 +654,113 @@ void R_CreateDupVerts( srfTriangles_t* tri )
 /*
 ===============
 R_DefineEdge
+
+Edges are matched through a flat hash on the unordered vertex pair, hashHeads
+holds the most recently defined edge in each bucket and hashChain links each
+edge to the one defined before it in the same bucket.
 ===============
 */
-static int c_duplicatedEdges, c_tripledEdges;
-static const int MAX_SIL_EDGES			= 0x7ffff;
+struct silEdgeBuild_t
+{
+	silEdge_t* 	edges;
+	int			numEdges;
+	int* 		hashHeads;
+	int* 		hashChain;
+	int			hashMask;
+	int			numPlanes;
+	int			duplicatedEdges;
+	int			tripledEdges;
+};
 
-static void R_DefineEdge( const int v1, const int v2, const int planeNum, const int numPlanes,
-						  idList<silEdge_t>& silEdges, idHashIndex&	 silEdgeHash )
+static ID_INLINE int R_SilEdgeHash( const int v1, const int v2, const int hashMask )
+{
+	// the same for both directions so the back side of an edge is found
+	return ( ( v1 ^ v2 ) * 0x9E3779B1 + ( v1 + v2 ) ) & hashMask;
+}
+
+static void R_DefineEdge( const int v1, const int v2, const int planeNum, silEdgeBuild_t& build )
 {
-	int		i, hashKey;
-	
 	// check for degenerate edge
 	if( v1 == v2 )
 	{
 		return;
 	}
-	hashKey = silEdgeHash.GenerateKey( v1, v2 );
+	
+	const int hashKey = R_SilEdgeHash( v1, v2, build.hashMask );
+	
 	// search for a matching other side
-	for( i = silEdgeHash.First( hashKey ); i >= 0 && i < MAX_SIL_EDGES; i = silEdgeHash.Next( i ) )
+	for( int i = build.hashHeads[hashKey]; i >= 0; i = build.hashChain[i] )
 	{
-		if( silEdges[i].v1 == v1 && silEdges[i].v2 == v2 )
+		silEdge_t& edge = build.edges[i];
+		if( edge.v1 == v1 && edge.v2 == v2 )
 		{
-			c_duplicatedEdges++;
+			build.duplicatedEdges++;
 			// allow it to still create a new edge
 			continue;
 		}
-		if( silEdges[i].v2 == v1 && silEdges[i].v1 == v2 )
+		if( edge.v2 == v1 && edge.v1 == v2 )
 		{
-			if( silEdges[i].p2 != numPlanes )
+			if( edge.p2 != build.numPlanes )
 			{
-				c_tripledEdges++;
+				build.tripledEdges++;
 				// allow it to still create a new edge
 				continue;
 			}
 			// this is a matching back side
-			silEdges[i].p2 = planeNum;
+			edge.p2 = planeNum;
 			return;
 		}
-		
 	}
 	
 	// define the new edge
-	silEdgeHash.Add( hashKey, silEdges.Num() );
-	
-	silEdge_t silEdge;
-	
-	silEdge.p1 = planeNum;
-	silEdge.p2 = numPlanes;
-	silEdge.v1 = v1;
-	silEdge.v2 = v2;
-	
-	silEdges.Append( silEdge );
+	const int edgeNum = build.numEdges++;
+	build.hashChain[edgeNum] = build.hashHeads[hashKey];
+	build.hashHeads[hashKey] = edgeNum;
+	
+	silEdge_t& edge = build.edges[edgeNum];
+	edge.p1 = planeNum;
+	edge.p2 = build.numPlanes;
+	edge.v1 = v1;
+	edge.v2 = v2;
 }
 
 /*
 =================
-SilEdgeSort
+R_SortSilEdgesByPlane
+
+Two stable counting sort passes, first on p2 and then on p1, which leaves the
+edges ordered by p1 and then p2. Both keys are at most numPlanes.
 =================
 */
-static int SilEdgeSort( const void* a, const void* b )
+static void R_SortSilEdgesByPlane( const silEdge_t* in, silEdge_t* out, const int numEdges, const int numPlanes )
 {
-	if( ( ( silEdge_t* )a )->p1 < ( ( silEdge_t* )b )->p1 )
-	{
-		return -1;
-	}
-	if( ( ( silEdge_t* )a )->p1 > ( ( silEdge_t* )b )->p1 )
-	{
-		return 1;
-	}
-	if( ( ( silEdge_t* )a )->p2 < ( ( silEdge_t* )b )->p2 )
-	{
-		return -1;
-	}
-	if( ( ( silEdge_t* )a )->p2 > ( ( silEdge_t* )b )->p2 )
+	silEdge_t* temp = ( silEdge_t* )R_StaticAlloc( numEdges * sizeof( temp[0] ), TAG_TEMP );
+	int* offsets = ( int* )R_StaticAlloc( ( numPlanes + 2 ) * sizeof( offsets[0] ), TAG_TEMP );
+	
+	for( int pass = 0; pass < 2; pass++ )
 	{
-		return 1;
+		const silEdge_t* src = ( pass == 0 ) ? in : temp;
+		silEdge_t* dst = ( pass == 0 ) ? temp : out;
+		
+		memset( offsets, 0, ( numPlanes + 2 ) * sizeof( offsets[0] ) );
+		for( int i = 0; i < numEdges; i++ )
+		{
+			const int key = ( pass == 0 ) ? src[i].p2 : src[i].p1;
+			offsets[key + 1]++;
+		}
+		for( int i = 0; i <= numPlanes; i++ )
+		{
+			offsets[i + 1] += offsets[i];
+		}
+		for( int i = 0; i < numEdges; i++ )
+		{
+			const int key = ( pass == 0 ) ? src[i].p2 : src[i].p1;
+			dst[offsets[key]++] = src[i];
+		}
 	}
-	return 0;
+	
+	R_StaticFree( offsets );
+	R_StaticFree( temp );
 }
 
 /*
@@ -741,8 +771,8 @@ If the surface will not deform, coplanar edges (polygon interiors)
 can never create silhouette plains, and can be omited
 =================
 */
-int	c_coplanarSilEdges;
-int	c_totalSilEdges;
+interlockedInt_t	c_coplanarSilEdges;
+interlockedInt_t	c_totalSilEdges;
 
 void R_IdentifySilEdges( srfTriangles_t* tri, bool omitCoplanarEdges )
 {
@@ -751,19 +781,23 @@ void R_IdentifySilEdges( srfTriangles_t* tri, bool omitCoplanarEdges )
 	
 	omitCoplanarEdges = false;	// optimization doesn't work for some reason
 	
-	static const int SILEDGE_HASH_SIZE		= 1024;
-	
 	const int numTris = tri->numIndexes / 3;
 	
-	idList<silEdge_t>	silEdges( MAX_SIL_EDGES );
-	idHashIndex	silEdgeHash( SILEDGE_HASH_SIZE, MAX_SIL_EDGES );
-	int			numPlanes = numTris;
+	// there can't be more edges than indexes, and a table with at least
+	// one bucket per edge keeps the chains short
+	const int hashSize = idMath::CeilPowerOfTwo( Max( tri->numIndexes, 1 ) );
 	
+	silEdgeBuild_t build;
+	build.edges = ( silEdge_t* )R_StaticAlloc( tri->numIndexes * sizeof( build.edges[0] ), TAG_TEMP );
+	build.numEdges = 0;
+	build.hashHeads = ( int* )R_StaticAlloc( hashSize * sizeof( build.hashHeads[0] ), TAG_TEMP );
+	build.hashChain = ( int* )R_StaticAlloc( tri->numIndexes * sizeof( build.hashChain[0] ), TAG_TEMP );
+	build.hashMask = hashSize - 1;
+	build.numPlanes = numTris;
+	build.duplicatedEdges = 0;
+	build.tripledEdges = 0;
 	
-	silEdgeHash.Clear();
-	
-	c_duplicatedEdges = 0;
-	c_tripledEdges = 0;
+	memset( build.hashHeads, -1, hashSize * sizeof( build.hashHeads[0] ) );
 	
 	for( i = 0; i < numTris; i++ )
 	{
@@ -774,16 +808,23 @@ void R_IdentifySilEdges( srfTriangles_t* tri, bool omitCoplanarEdges )
 		i3 = tri->silIndexes[ i * 3 + 2 ];
 		
 		// create the edges
-		R_DefineEdge( i1, i2, i, numPlanes, silEdges, silEdgeHash );
-		R_DefineEdge( i2, i3, i, numPlanes, silEdges, silEdgeHash );
-		R_DefineEdge( i3, i1, i, numPlanes, silEdges, silEdgeHash );
+		R_DefineEdge( i1, i2, i, build );
+		R_DefineEdge( i2, i3, i, build );
+		R_DefineEdge( i3, i1, i, build );
 	}
 	
-	if( c_duplicatedEdges || c_tripledEdges )
+	R_StaticFree( build.hashHeads );
+	R_StaticFree( build.hashChain );
+	
+	if( build.duplicatedEdges || build.tripledEdges )
 	{
-		common->DWarning( "%i duplicated edge directions, %i tripled edges", c_duplicatedEdges, c_tripledEdges );
+		common->DWarning( "%i duplicated edge directions, %i tripled edges", build.duplicatedEdges, build.tripledEdges );
 	}
 	
+	silEdge_t* silEdges = build.edges;
+	int numSilEdges = build.numEdges;
+	const int numPlanes = numTris;
+	
 	// if we know that the vertexes aren't going
 	// to deform, we can remove interior triangulation edges
 	// on otherwise planar polygons.
@@ -796,7 +837,7 @@ void R_IdentifySilEdges( srfTriangles_t* tri, bool omitCoplanarEdges )
 	c_coplanarCulled = 0;
 	if( omitCoplanarEdges )
 	{
-		for( i = 0; i < silEdges.Num(); i++ )
+		for( i = 0; i < numSilEdges; i++ )
 		{
 			int			i1, i2, i3;
 			idPlane		plane;
@@ -831,23 +872,20 @@ void R_IdentifySilEdges( srfTriangles_t* tri, bool omitCoplanarEdges )
 			if( j == 3 )
 			{
 				// we can cull this sil edge
-				memmove( &silEdges[i], &silEdges[i + 1], ( silEdges.Num() - i - 1 ) * sizeof( silEdges[i] ) );
+				memmove( &silEdges[i], &silEdges[i + 1], ( numSilEdges - i - 1 ) * sizeof( silEdges[i] ) );
 				c_coplanarCulled++;
-				silEdges.SetNum( silEdges.Num() - 1 );
+				numSilEdges--;
 				i--;
 			}
 		}
 		if( c_coplanarCulled )
 		{
-			c_coplanarSilEdges += c_coplanarCulled;
+			Sys_InterlockedAdd( c_coplanarSilEdges, c_coplanarCulled );
 //			common->Printf( "%i of %i sil edges coplanar culled\n", c_coplanarCulled,
 //				c_coplanarCulled + numSilEdges );
 		}
 	}
-	c_totalSilEdges += silEdges.Num();
-	
-	// sort the sil edges based on plane number
-	qsort( silEdges.Ptr(), silEdges.Num(), sizeof( silEdges[0] ), SilEdgeSort );
+	Sys_InterlockedAdd( c_totalSilEdges, numSilEdges );
 	
 	// count up the distribution.
 	// a perfectly built model should only have shared
@@ -855,7 +893,7 @@ void R_IdentifySilEdges( srfTriangles_t* tri, bool omitCoplanarEdges )
 	// and dangling edges
 	shared = 0;
 	single = 0;
-	for( i = 0; i < silEdges.Num(); i++ )
+	for( i = 0; i < numSilEdges; i++ )
 	{
 		if( silEdges[i].p2 == numPlanes )
 		{
@@ -876,9 +914,12 @@ void R_IdentifySilEdges( srfTriangles_t* tri, bool omitCoplanarEdges )
 		tri->perfectHull = false;
 	}
 	
-	tri->numSilEdges = silEdges.Num();
-	R_AllocStaticTriSurfSilEdges( tri, silEdges.Num() );
-	memcpy( tri->silEdges, silEdges.Ptr(), silEdges.Num() * sizeof( tri->silEdges[0] ) );
+	// sort the sil edges based on plane number
+	tri->numSilEdges = numSilEdges;
+	R_AllocStaticTriSurfSilEdges( tri, numSilEdges );
+	R_SortSilEdgesByPlane( silEdges, tri->silEdges, numSilEdges, numPlanes );
+	
+	R_StaticFree( silEdges );
 }
 
 /*
@@ -1447,37 +1488,36 @@ typedef struct
 	int		faceNum;
 } indexSort_t;
 
-static int IndexSort( const void* a, const void* b )
-{
-	if( ( ( indexSort_t* )a )->vertexNum < ( ( indexSort_t* )b )->vertexNum )
-	{
-		return -1;
-	}
-	if( ( ( indexSort_t* )a )->vertexNum > ( ( indexSort_t* )b )->vertexNum )
-	{
-		return 1;
-	}
-	return 0;
-}
-
 void R_BuildDominantTris( srfTriangles_t* tri )
 {
 	int i, j;
 	dominantTri_t* dt;
 	const int numIndexes = tri->numIndexes;
 	indexSort_t* ind = ( indexSort_t* )R_StaticAlloc( numIndexes * sizeof( indexSort_t ) );
-	if( ind == NULL )
+	if( ind == NULL && numIndexes > 0 )
 	{
 		idLib::Error( "Couldn't allocate index sort array" );
 		return;
 	}
 	
-	for( i = 0; i < tri->numIndexes; i++ )
+	// group the index references by vertex with a counting sort on the vertex
+	// number, which keeps the faces of each vertex in order
+	int* vertexOffsets = ( int* )R_ClearedStaticAlloc( ( tri->numVerts + 1 ) * sizeof( vertexOffsets[0] ) );
+	for( i = 0; i < numIndexes; i++ )
+	{
+		vertexOffsets[tri->indexes[i] + 1]++;
+	}
+	for( i = 0; i < tri->numVerts; i++ )
+	{
+		vertexOffsets[i + 1] += vertexOffsets[i];
+	}
+	for( i = 0; i < numIndexes; i++ )
 	{
-		ind[i].vertexNum = tri->indexes[i];
-		ind[i].faceNum = i / 3;
+		indexSort_t& sorted = ind[vertexOffsets[tri->indexes[i]]++];
+		sorted.vertexNum = tri->indexes[i];
+		sorted.faceNum = i / 3;
 	}
-	qsort( ind, tri->numIndexes, sizeof( *ind ), IndexSort );
+	R_StaticFree( vertexOffsets );
 	
 	R_AllocStaticTriSurfDominantTris( tri, tri->numVerts );
 	dt = tri->dominantTris;
@@ -1588,323 +1628,2085 @@ void R_BuildDominantTris( srfTriangles_t* tri )
 }
 
 /*
-==================
-R_DeriveTangents
+===================================================================================
 
-This is called once for static surfaces, and every frame for deforming surfaces
+FAST TANGENT DERIVATION
 
-Builds tangents, normals, and face planes
-==================
+The functions above are the reference implementations. The versions below
+produce the same results, but evaluate four triangles or vertexes at a time
+and can split the work of a list of surfaces over the front end job list.
+r_useSIMDTangents 0 falls back to the reference code for comparisons, see
+the testDeriveTangents command.
+
+===================================================================================
 */
-void R_DeriveTangents( srfTriangles_t* tri )
+
+idCVar r_useSIMDTangents( "r_useSIMDTangents", "1", CVAR_RENDERER | CVAR_BOOL, "derive normals and tangents with the vectorized code" );
+idCVar r_tangentJobSize( "r_tangentJobSize", "4096", CVAR_RENDERER | CVAR_INTEGER, "number of triangles or vertexes per tangent job, 0 = don't use jobs", 0, 65536 );
+
+enum tangentMode_t
+{
+	TANGENTS_SMOOTHED,			// normals and tangents averaged over all triangles using a vertex
+	TANGENTS_UNSMOOTHED,		// normals and tangents of the dominant triangle of each vertex
+	TANGENTS_WITHOUT_NORMALS	// averaged tangents projected on the existing normals
+};
+
+struct tangentSurface_t
+{
+	srfTriangles_t* 	tri;
+	tangentMode_t		mode;
+	idVec3* 			faceNormals;		// NULL for TANGENTS_WITHOUT_NORMALS
+	idVec3* 			faceTangents;
+	idVec3* 			faceBitangents;
+	idVec3* 			vertexNormals;		// NULL for TANGENTS_WITHOUT_NORMALS
+	idVec3* 			vertexTangents;
+	idVec3* 			vertexBitangents;
+	int* 				vertexFaceOffsets;	// numVerts + 1 offsets into vertexFaces
+	int* 				vertexFaces;		// the triangles using each vertex in index order
+	void* 				scratch;
+};
+
+struct tangentJobParms_t
+{
+	tangentSurface_t* 	surfaces;
+	int					first;				// first triangle, vertex or surface
+	int					last;
+};
+
+/*
+=================
+R_TangentMode
+
+The same rules R_CleanupTriangles applies with createNormals set to tri->generateNormals.
+=================
+*/
+static tangentMode_t R_TangentMode( const srfTriangles_t* tri )
 {
-	if( tri->tangentsCalculated )
-	{
-		return;
-	}
-	
-	tr.pc.c_tangentIndexes += tri->numIndexes;
-	
 	if( tri->dominantTris != NULL )
 	{
-		R_DeriveUnsmoothedNormalsAndTangents( tri );
+		return TANGENTS_UNSMOOTHED;
 	}
-	else
+	if( tri->generateNormals )
 	{
-		R_DeriveNormalsAndTangents( tri );
+		return TANGENTS_SMOOTHED;
 	}
-	tri->tangentsCalculated = true;
+	return TANGENTS_WITHOUT_NORMALS;
 }
 
 /*
 =================
-R_RemoveDuplicatedTriangles
-
-silIndexes must have already been calculated
+R_DeriveFaceTangent
 
-silIndexes are used instead of indexes, because duplicated
-triangles could have different texture coordinates.
+Normal, tangent and bitangent of a single triangle, identical to the per triangle part of
+R_DeriveNormalsAndTangents. Without a normal this matches R_DeriveTangentsWithoutNormals,
+which leaves triangles with a degenerate texture space out.
 =================
 */
-void R_RemoveDuplicatedTriangles( srfTriangles_t* tri )
+static ID_INLINE void R_DeriveFaceTangent( const srfTriangles_t* tri, const int faceNum, idVec3* normal, idVec3& tangent, idVec3& bitangent )
 {
-	int		c_removed;
-	int		i, j, r;
-	int		a, b, c;
+	const idDrawVert* a = tri->verts + tri->indexes[faceNum * 3 + 0];
+	const idDrawVert* b = tri->verts + tri->indexes[faceNum * 3 + 1];
+	const idDrawVert* c = tri->verts + tri->indexes[faceNum * 3 + 2];
 	
-	c_removed = 0;
+	const idVec2 aST = a->GetTexCoord();
+	const idVec2 bST = b->GetTexCoord();
+	const idVec2 cST = c->GetTexCoord();
 	
-	// check for completely duplicated triangles
-	// any rotation of the triangle is still the same, but a mirroring
-	// is considered different
-	for( i = 0; i < tri->numIndexes; i += 3 )
+	float d0[5];
+	d0[0] = b->xyz[0] - a->xyz[0];
+	d0[1] = b->xyz[1] - a->xyz[1];
+	d0[2] = b->xyz[2] - a->xyz[2];
+	d0[3] = bST[0] - aST[0];
+	d0[4] = bST[1] - aST[1];
+	
+	float d1[5];
+	d1[0] = c->xyz[0] - a->xyz[0];
+	d1[1] = c->xyz[1] - a->xyz[1];
+	d1[2] = c->xyz[2] - a->xyz[2];
+	d1[3] = cST[0] - aST[0];
+	d1[4] = cST[1] - aST[1];
+	
+	const float area = d0[3] * d1[4] - d0[4] * d1[3];
+	
+	if( normal != NULL )
 	{
-		for( r = 0; r < 3; r++ )
-		{
-			a = tri->silIndexes[i + r];
-			b = tri->silIndexes[i + ( r + 1 ) % 3];
-			c = tri->silIndexes[i + ( r + 2 ) % 3];
-			for( j = i + 3; j < tri->numIndexes; j += 3 )
-			{
-				if( tri->silIndexes[j] == a && tri->silIndexes[j + 1] == b && tri->silIndexes[j + 2] == c )
-				{
-					c_removed++;
-					memmove( tri->indexes + j, tri->indexes + j + 3, ( tri->numIndexes - j - 3 ) * sizeof( tri->indexes[0] ) );
-					memmove( tri->silIndexes + j, tri->silIndexes + j + 3, ( tri->numIndexes - j - 3 ) * sizeof( tri->silIndexes[0] ) );
-					tri->numIndexes -= 3;
-					j -= 3;
-				}
-			}
-		}
+		( *normal )[0] = d1[1] * d0[2] - d1[2] * d0[1];
+		( *normal )[1] = d1[2] * d0[0] - d1[0] * d0[2];
+		( *normal )[2] = d1[0] * d0[1] - d1[1] * d0[0];
+		
+		const float f0 = idMath::InvSqrt( normal->x * normal->x + normal->y * normal->y + normal->z * normal->z );
+		( *normal ) *= f0;
+	}
+	else if( fabs( area ) < 1e-20f )
+	{
+		tangent.Zero();
+		bitangent.Zero();
+		return;
 	}
 	
-	if( c_removed )
+	// area sign bit
+	unsigned int signBit = ( *( unsigned int* )&area ) & ( 1 << 31 );
+#ifndef USE_INVA
+	if( normal == NULL )
 	{
-		common->Printf( "removed %i duplicated triangles\n", c_removed );
+		signBit = 0;
 	}
+#endif
+	
+	tangent[0] = d0[0] * d1[4] - d0[4] * d1[0];
+	tangent[1] = d0[1] * d1[4] - d0[4] * d1[1];
+	tangent[2] = d0[2] * d1[4] - d0[4] * d1[2];
+	
+	float f1 = idMath::InvSqrt( tangent.x * tangent.x + tangent.y * tangent.y + tangent.z * tangent.z );
+	*( unsigned int* )&f1 ^= signBit;
+	tangent *= f1;
+	
+	bitangent[0] = d0[3] * d1[0] - d0[0] * d1[3];
+	bitangent[1] = d0[3] * d1[1] - d0[1] * d1[3];
+	bitangent[2] = d0[3] * d1[2] - d0[2] * d1[3];
+	
+	float f2 = idMath::InvSqrt( bitangent.x * bitangent.x + bitangent.y * bitangent.y + bitangent.z * bitangent.z );
+	*( unsigned int* )&f2 ^= signBit;
+	bitangent *= f2;
 }
 
 /*
 =================
-R_RemoveDegenerateTriangles
+R_FinishVertexTangent
 
-silIndexes must have already been calculated
+Normalizes the summed vectors of a single vertex and compresses them into the vertex.
 =================
 */
-void R_RemoveDegenerateTriangles( srfTriangles_t* tri )
+static ID_INLINE void R_FinishVertexTangent( idDrawVert& vert, idVec3* normal, idVec3& tangent, idVec3& bitangent )
 {
-	int		c_removed;
-	int		i;
-	int		a, b, c;
-	
-	assert( tri->silIndexes != NULL );
-	
-	// check for completely degenerate triangles
-	c_removed = 0;
-	for( i = 0; i < tri->numIndexes; i += 3 )
+	idVec3 n;
+	if( normal != NULL )
 	{
-		a = tri->silIndexes[i];
-		b = tri->silIndexes[i + 1];
-		c = tri->silIndexes[i + 2];
-		if( a == b || a == c || b == c )
-		{
-			c_removed++;
-			memmove( tri->indexes + i, tri->indexes + i + 3, ( tri->numIndexes - i - 3 ) * sizeof( tri->indexes[0] ) );
-			memmove( tri->silIndexes + i, tri->silIndexes + i + 3, ( tri->numIndexes - i - 3 ) * sizeof( tri->silIndexes[0] ) );
-			tri->numIndexes -= 3;
-			i -= 3;
-		}
+		n = *normal * idMath::InvSqrt( normal->x * normal->x + normal->y * normal->y + normal->z * normal->z );
+	}
+	else
+	{
+		n = vert.GetNormal();
+		n.Normalize();
 	}
 	
-	// this doesn't free the memory used by the unused verts
+	tangent -= ( tangent * n ) * n;
+	bitangent -= ( bitangent * n ) * n;
 	
-	if( c_removed )
+	tangent *= idMath::InvSqrt( tangent.x * tangent.x + tangent.y * tangent.y + tangent.z * tangent.z );
+	bitangent *= idMath::InvSqrt( bitangent.x * bitangent.x + bitangent.y * bitangent.y + bitangent.z * bitangent.z );
+	
+	if( normal != NULL )
 	{
-		common->Printf( "removed %i degenerate triangles\n", c_removed );
+		vert.SetNormal( n );
 	}
+	vert.SetTangent( tangent );
+	vert.SetBiTangent( bitangent );
 }
 
 /*
 =================
-R_TestDegenerateTextureSpace
+R_DeriveUnsmoothedVertexTangent
+
+Identical to the per vertex part of R_DeriveUnsmoothedNormalsAndTangents.
 =================
 */
-void R_TestDegenerateTextureSpace( srfTriangles_t* tri )
+static ID_INLINE void R_DeriveUnsmoothedVertexTangent( srfTriangles_t* tri, const int vertexNum )
 {
-	int		c_degenerate;
-	int		i;
+	const dominantTri_t& dt = tri->dominantTris[vertexNum];
 	
-	// check for triangles with a degenerate texture space
-	c_degenerate = 0;
-	for( i = 0; i < tri->numIndexes; i += 3 )
-	{
-		const idDrawVert& a = tri->verts[tri->indexes[i + 0]];
-		const idDrawVert& b = tri->verts[tri->indexes[i + 1]];
-		const idDrawVert& c = tri->verts[tri->indexes[i + 2]];
-		
-		// RB: compare texcoords instead of pointers
-		if( a.GetTexCoord() == b.GetTexCoord() || b.GetTexCoord() == c.GetTexCoord() || c.GetTexCoord() == a.GetTexCoord() )
-		{
-			c_degenerate++;
-		}
-		// RB end
-	}
+	idDrawVert* a = tri->verts + vertexNum;
+	const idDrawVert* b = tri->verts + dt.v2;
+	const idDrawVert* c = tri->verts + dt.v3;
 	
-	if( c_degenerate )
+	const idVec2 aST = a->GetTexCoord();
+	const idVec2 bST = b->GetTexCoord();
+	const idVec2 cST = c->GetTexCoord();
+	
+	const float d0 = b->xyz[0] - a->xyz[0];
+	const float d1 = b->xyz[1] - a->xyz[1];
+	const float d2 = b->xyz[2] - a->xyz[2];
+	const float d4 = bST[1] - aST[1];
+	
+	const float d5 = c->xyz[0] - a->xyz[0];
+	const float d6 = c->xyz[1] - a->xyz[1];
+	const float d7 = c->xyz[2] - a->xyz[2];
+	const float d9 = cST[1] - aST[1];
+	
+	const float s0 = dt.normalizationScale[0];
+	const float s1 = dt.normalizationScale[1];
+	const float s2 = dt.normalizationScale[2];
+	
+	const float n0 = s2 * ( d6 * d2 - d7 * d1 );
+	const float n1 = s2 * ( d7 * d0 - d5 * d2 );
+	const float n2 = s2 * ( d5 * d1 - d6 * d0 );
+	
+	const float t0 = s0 * ( d0 * d9 - d4 * d5 );
+	const float t1 = s0 * ( d1 * d9 - d4 * d6 );
+	const float t2 = s0 * ( d2 * d9 - d4 * d7 );
+	
+#ifndef DERIVE_UNSMOOTHED_BITANGENT
+	const float d3 = bST[0] - aST[0];
+	const float d8 = cST[0] - aST[0];
+	
+	const float t3 = s1 * ( d3 * d5 - d0 * d8 );
+	const float t4 = s1 * ( d3 * d6 - d1 * d8 );
+	const float t5 = s1 * ( d3 * d7 - d2 * d8 );
+#else
+	const float t3 = s1 * ( n2 * t1 - n1 * t2 );
+	const float t4 = s1 * ( n0 * t2 - n2 * t0 );
+	const float t5 = s1 * ( n1 * t0 - n0 * t1 );
+#endif
+	
+	a->SetNormal( n0, n1, n2 );
+	a->SetTangent( t0, t1, t2 );
+	a->SetBiTangent( t3, t4, t5 );
+}
+
+#if defined(USE_INTRINSICS)
+
+/*
+=================
+R_InvSqrt_SSE
+
+Four wide idMath::InvSqrt with the same result for tiny and invalid lengths.
+=================
+*/
+static ID_INLINE __m128 R_InvSqrt_SSE( const __m128 x )
+{
+	const __m128 valid = _mm_cmpgt_ps( x, _mm_set1_ps( idMath::FLT_SMALLEST_NON_DENORMAL ) );
+	const __m128 r = _mm_sqrt_ps( _mm_div_ps( _mm_set1_ps( 1.0f ), x ) );
+	return _mm_or_ps( _mm_and_ps( valid, r ), _mm_andnot_ps( valid, _mm_set1_ps( idMath::INFINITY ) ) );
+}
+
+/*
+=================
+R_Dot3_SSE
+=================
+*/
+static ID_INLINE __m128 R_Dot3_SSE( const __m128 ax, const __m128 ay, const __m128 az, const __m128 bx, const __m128 by, const __m128 bz )
+{
+	return _mm_add_ps( _mm_add_ps( _mm_mul_ps( ax, bx ), _mm_mul_ps( ay, by ) ), _mm_mul_ps( az, bz ) );
+}
+
+/*
+=================
+R_LoadTangentVert_SSE
+
+Transposes the position and texture coordinates of a vertex into lane 'lane' of a 5x4 block.
+=================
+*/
+static ID_INLINE void R_LoadTangentVert_SSE( const idDrawVert& vert, float dest[5][4], const int lane )
+{
+	const idVec2 st = vert.GetTexCoord();
+	dest[0][lane] = vert.xyz.x;
+	dest[1][lane] = vert.xyz.y;
+	dest[2][lane] = vert.xyz.z;
+	dest[3][lane] = st.x;
+	dest[4][lane] = st.y;
+}
+
+/*
+=================
+R_StoreVec3_SSE
+=================
+*/
+static ID_INLINE void R_StoreVec3_SSE( idVec3* dest, const __m128 x, const __m128 y, const __m128 z )
+{
+	ALIGNTYPE16 float soa[3][4];
+	_mm_store_ps( soa[0], x );
+	_mm_store_ps( soa[1], y );
+	_mm_store_ps( soa[2], z );
+	for( int k = 0; k < 4; k++ )
 	{
-//		common->Printf( "%d triangles with a degenerate texture space\n", c_degenerate );
+		dest[k].Set( soa[0][k], soa[1][k], soa[2][k] );
 	}
 }
 
 /*
 =================
-R_RemoveUnusedVerts
+R_LoadVec3_SSE
 =================
 */
-void R_RemoveUnusedVerts( srfTriangles_t* tri )
+static ID_INLINE void R_LoadVec3_SSE( const idVec3& v, float dest[3][4], const int lane )
 {
-	int		i;
-	int*		mark;
-	int		index;
-	int		used;
+	dest[0][lane] = v.x;
+	dest[1][lane] = v.y;
+	dest[2][lane] = v.z;
+}
+
+#endif
+
+/*
+=================
+R_DeriveFaceTangents
+
+Derives the vectors of the triangles [firstFace, lastFace). Without face normals the
+degenerate texture space triangles are zeroed like R_DeriveTangentsWithoutNormals does.
+=================
+*/
+static void R_DeriveFaceTangents( const srfTriangles_t* tri, const int firstFace, const int lastFace, idVec3* faceNormals, idVec3* faceTangents, idVec3* faceBitangents )
+{
+	int i = firstFace;
+	
+#if defined(USE_INTRINSICS)
+	const __m128 vector_float_sign_bit = __m128c( _mm_set1_epi32( 1 << 31 ) );
+	const __m128 vector_float_degenerate_area = _mm_set1_ps( 1e-20f );
+	
+	for( ; i + 4 <= lastFace; i += 4 )
+	{
+		ALIGNTYPE16 float a[5][4];
+		ALIGNTYPE16 float b[5][4];
+		ALIGNTYPE16 float c[5][4];
+		
+		for( int k = 0; k < 4; k++ )
+		{
+			const triIndex_t* indexes = tri->indexes + ( i + k ) * 3;
+			R_LoadTangentVert_SSE( tri->verts[indexes[0]], a, k );
+			R_LoadTangentVert_SSE( tri->verts[indexes[1]], b, k );
+			R_LoadTangentVert_SSE( tri->verts[indexes[2]], c, k );
+		}
+		
+		const __m128 d00 = _mm_sub_ps( _mm_load_ps( b[0] ), _mm_load_ps( a[0] ) );
+		const __m128 d01 = _mm_sub_ps( _mm_load_ps( b[1] ), _mm_load_ps( a[1] ) );
+		const __m128 d02 = _mm_sub_ps( _mm_load_ps( b[2] ), _mm_load_ps( a[2] ) );
+		const __m128 d03 = _mm_sub_ps( _mm_load_ps( b[3] ), _mm_load_ps( a[3] ) );
+		const __m128 d04 = _mm_sub_ps( _mm_load_ps( b[4] ), _mm_load_ps( a[4] ) );
+		
+		const __m128 d10 = _mm_sub_ps( _mm_load_ps( c[0] ), _mm_load_ps( a[0] ) );
+		const __m128 d11 = _mm_sub_ps( _mm_load_ps( c[1] ), _mm_load_ps( a[1] ) );
+		const __m128 d12 = _mm_sub_ps( _mm_load_ps( c[2] ), _mm_load_ps( a[2] ) );
+		const __m128 d13 = _mm_sub_ps( _mm_load_ps( c[3] ), _mm_load_ps( a[3] ) );
+		const __m128 d14 = _mm_sub_ps( _mm_load_ps( c[4] ), _mm_load_ps( a[4] ) );
+		
+		const __m128 area = _mm_sub_ps( _mm_mul_ps( d03, d14 ), _mm_mul_ps( d04, d13 ) );
+		__m128 signBit = _mm_and_ps( area, vector_float_sign_bit );
+#ifndef USE_INVA
+		if( faceNormals == NULL )
+		{
+			signBit = _mm_setzero_ps();
+		}
+#endif
+		
+		if( faceNormals != NULL )
+		{
+			__m128 nx = _mm_sub_ps( _mm_mul_ps( d11, d02 ), _mm_mul_ps( d12, d01 ) );
+			__m128 ny = _mm_sub_ps( _mm_mul_ps( d12, d00 ), _mm_mul_ps( d10, d02 ) );
+			__m128 nz = _mm_sub_ps( _mm_mul_ps( d10, d01 ), _mm_mul_ps( d11, d00 ) );
+			
+			const __m128 f0 = R_InvSqrt_SSE( R_Dot3_SSE( nx, ny, nz, nx, ny, nz ) );
+			nx = _mm_mul_ps( nx, f0 );
+			ny = _mm_mul_ps( ny, f0 );
+			nz = _mm_mul_ps( nz, f0 );
+			
+			R_StoreVec3_SSE( faceNormals + i, nx, ny, nz );
+		}
+		
+		__m128 tx = _mm_sub_ps( _mm_mul_ps( d00, d14 ), _mm_mul_ps( d04, d10 ) );
+		__m128 ty = _mm_sub_ps( _mm_mul_ps( d01, d14 ), _mm_mul_ps( d04, d11 ) );
+		__m128 tz = _mm_sub_ps( _mm_mul_ps( d02, d14 ), _mm_mul_ps( d04, d12 ) );
+		
+		__m128 f1 = _mm_xor_ps( R_InvSqrt_SSE( R_Dot3_SSE( tx, ty, tz, tx, ty, tz ) ), signBit );
+		
+		__m128 bx = _mm_sub_ps( _mm_mul_ps( d03, d10 ), _mm_mul_ps( d00, d13 ) );
+		__m128 by = _mm_sub_ps( _mm_mul_ps( d03, d11 ), _mm_mul_ps( d01, d13 ) );
+		__m128 bz = _mm_sub_ps( _mm_mul_ps( d03, d12 ), _mm_mul_ps( d02, d13 ) );
+		
+		__m128 f2 = _mm_xor_ps( R_InvSqrt_SSE( R_Dot3_SSE( bx, by, bz, bx, by, bz ) ), signBit );
+		
+		if( faceNormals == NULL )
+		{
+			// zero the triangles with a degenerate texture space
+			const __m128 valid = _mm_cmpnlt_ps( _mm_andnot_ps( vector_float_sign_bit, area ), vector_float_degenerate_area );
+			f1 = _mm_and_ps( f1, valid );
+			f2 = _mm_and_ps( f2, valid );
+		}
+		
+		tx = _mm_mul_ps( tx, f1 );
+		ty = _mm_mul_ps( ty, f1 );
+		tz = _mm_mul_ps( tz, f1 );
+		
+		bx = _mm_mul_ps( bx, f2 );
+		by = _mm_mul_ps( by, f2 );
+		bz = _mm_mul_ps( bz, f2 );
+		
+		R_StoreVec3_SSE( faceTangents + i, tx, ty, tz );
+		R_StoreVec3_SSE( faceBitangents + i, bx, by, bz );
+	}
+#endif
+	
+	for( ; i < lastFace; i++ )
+	{
+		R_DeriveFaceTangent( tri, i, ( faceNormals != NULL ) ? &faceNormals[i] : NULL, faceTangents[i], faceBitangents[i] );
+	}
+}
+
+/*
+=================
+R_FinishVertexTangents
+
+Normalizes the summed vectors of the vertexes [firstVert, lastVert), projects the tangents
+onto the normal plane and compresses the results into the vertexes.
+=================
+*/
+static void R_FinishVertexTangents( srfTriangles_t* tri, const int firstVert, const int lastVert, idVec3* vertexNormals, idVec3* vertexTangents, idVec3* vertexBitangents )
+{
+	int i = firstVert;
+	
+#if defined(USE_INTRINSICS)
+	for( ; i + 4 <= lastVert; i += 4 )
+	{
+		ALIGNTYPE16 float n[3][4];
+		ALIGNTYPE16 float t[3][4];
+		ALIGNTYPE16 float b[3][4];
+		
+		for( int k = 0; k < 4; k++ )
+		{
+			if( vertexNormals != NULL )
+			{
+				R_LoadVec3_SSE( vertexNormals[i + k], n, k );
+			}
+			else
+			{
+				idVec3 normal = tri->verts[i + k].GetNormal();
+				normal.Normalize();
+				R_LoadVec3_SSE( normal, n, k );
+			}
+			R_LoadVec3_SSE( vertexTangents[i + k], t, k );
+			R_LoadVec3_SSE( vertexBitangents[i + k], b, k );
+		}
+		
+		__m128 nx = _mm_load_ps( n[0] );
+		__m128 ny = _mm_load_ps( n[1] );
+		__m128 nz = _mm_load_ps( n[2] );
+		
+		if( vertexNormals != NULL )
+		{
+			const __m128 normalScale = R_InvSqrt_SSE( R_Dot3_SSE( nx, ny, nz, nx, ny, nz ) );
+			nx = _mm_mul_ps( nx, normalScale );
+			ny = _mm_mul_ps( ny, normalScale );
+			nz = _mm_mul_ps( nz, normalScale );
+		}
+		
+		__m128 tx = _mm_load_ps( t[0] );
+		__m128 ty = _mm_load_ps( t[1] );
+		__m128 tz = _mm_load_ps( t[2] );
+		
+		__m128 bx = _mm_load_ps( b[0] );
+		__m128 by = _mm_load_ps( b[1] );
+		__m128 bz = _mm_load_ps( b[2] );
+		
+		const __m128 tDotN = R_Dot3_SSE( tx, ty, tz, nx, ny, nz );
+		tx = _mm_sub_ps( tx, _mm_mul_ps( tDotN, nx ) );
+		ty = _mm_sub_ps( ty, _mm_mul_ps( tDotN, ny ) );
+		tz = _mm_sub_ps( tz, _mm_mul_ps( tDotN, nz ) );
+		
+		const __m128 bDotN = R_Dot3_SSE( bx, by, bz, nx, ny, nz );
+		bx = _mm_sub_ps( bx, _mm_mul_ps( bDotN, nx ) );
+		by = _mm_sub_ps( by, _mm_mul_ps( bDotN, ny ) );
+		bz = _mm_sub_ps( bz, _mm_mul_ps( bDotN, nz ) );
+		
+		const __m128 tangentScale = R_InvSqrt_SSE( R_Dot3_SSE( tx, ty, tz, tx, ty, tz ) );
+		tx = _mm_mul_ps( tx, tangentScale );
+		ty = _mm_mul_ps( ty, tangentScale );
+		tz = _mm_mul_ps( tz, tangentScale );
+		
+		const __m128 bitangentScale = R_InvSqrt_SSE( R_Dot3_SSE( bx, by, bz, bx, by, bz ) );
+		bx = _mm_mul_ps( bx, bitangentScale );
+		by = _mm_mul_ps( by, bitangentScale );
+		bz = _mm_mul_ps( bz, bitangentScale );
+		
+		_mm_store_ps( n[0], nx );
+		_mm_store_ps( n[1], ny );
+		_mm_store_ps( n[2], nz );
+		_mm_store_ps( t[0], tx );
+		_mm_store_ps( t[1], ty );
+		_mm_store_ps( t[2], tz );
+		_mm_store_ps( b[0], bx );
+		_mm_store_ps( b[1], by );
+		_mm_store_ps( b[2], bz );
+		
+		// compress the normals and tangents, the bitangent sign depends on the compressed normal and tangent
+		for( int k = 0; k < 4; k++ )
+		{
+			idDrawVert& vert = tri->verts[i + k];
+			if( vertexNormals != NULL )
+			{
+				vert.SetNormal( n[0][k], n[1][k], n[2][k] );
+			}
+			vert.SetTangent( t[0][k], t[1][k], t[2][k] );
+			vert.SetBiTangent( b[0][k], b[1][k], b[2][k] );
+		}
+	}
+#endif
+	
+	for( ; i < lastVert; i++ )
+	{
+		R_FinishVertexTangent( tri->verts[i], ( vertexNormals != NULL ) ? &vertexNormals[i] : NULL, vertexTangents[i], vertexBitangents[i] );
+	}
+}
+
+/*
+=================
+R_DeriveUnsmoothedTangents
+
+Derives the vectors of the vertexes [firstVert, lastVert) from their dominant triangles.
+=================
+*/
+static void R_DeriveUnsmoothedTangents( srfTriangles_t* tri, const int firstVert, const int lastVert )
+{
+	int i = firstVert;
+	
+#if defined(USE_INTRINSICS)
+	for( ; i + 4 <= lastVert; i += 4 )
+	{
+		ALIGNTYPE16 float a[5][4];
+		ALIGNTYPE16 float b[5][4];
+		ALIGNTYPE16 float c[5][4];
+		ALIGNTYPE16 float s[3][4];
+		
+		for( int k = 0; k < 4; k++ )
+		{
+			const dominantTri_t& dt = tri->dominantTris[i + k];
+			R_LoadTangentVert_SSE( tri->verts[i + k], a, k );
+			R_LoadTangentVert_SSE( tri->verts[dt.v2], b, k );
+			R_LoadTangentVert_SSE( tri->verts[dt.v3], c, k );
+			s[0][k] = dt.normalizationScale[0];
+			s[1][k] = dt.normalizationScale[1];
+			s[2][k] = dt.normalizationScale[2];
+		}
+		
+		const __m128 d0 = _mm_sub_ps( _mm_load_ps( b[0] ), _mm_load_ps( a[0] ) );
+		const __m128 d1 = _mm_sub_ps( _mm_load_ps( b[1] ), _mm_load_ps( a[1] ) );
+		const __m128 d2 = _mm_sub_ps( _mm_load_ps( b[2] ), _mm_load_ps( a[2] ) );
+		const __m128 d4 = _mm_sub_ps( _mm_load_ps( b[4] ), _mm_load_ps( a[4] ) );
+		
+		const __m128 d5 = _mm_sub_ps( _mm_load_ps( c[0] ), _mm_load_ps( a[0] ) );
+		const __m128 d6 = _mm_sub_ps( _mm_load_ps( c[1] ), _mm_load_ps( a[1] ) );
+		const __m128 d7 = _mm_sub_ps( _mm_load_ps( c[2] ), _mm_load_ps( a[2] ) );
+		const __m128 d9 = _mm_sub_ps( _mm_load_ps( c[4] ), _mm_load_ps( a[4] ) );
+		
+		const __m128 s0 = _mm_load_ps( s[0] );
+		const __m128 s1 = _mm_load_ps( s[1] );
+		const __m128 s2 = _mm_load_ps( s[2] );
+		
+		const __m128 n0 = _mm_mul_ps( s2, _mm_sub_ps( _mm_mul_ps( d6, d2 ), _mm_mul_ps( d7, d1 ) ) );
+		const __m128 n1 = _mm_mul_ps( s2, _mm_sub_ps( _mm_mul_ps( d7, d0 ), _mm_mul_ps( d5, d2 ) ) );
+		const __m128 n2 = _mm_mul_ps( s2, _mm_sub_ps( _mm_mul_ps( d5, d1 ), _mm_mul_ps( d6, d0 ) ) );
+		
+		const __m128 t0 = _mm_mul_ps( s0, _mm_sub_ps( _mm_mul_ps( d0, d9 ), _mm_mul_ps( d4, d5 ) ) );
+		const __m128 t1 = _mm_mul_ps( s0, _mm_sub_ps( _mm_mul_ps( d1, d9 ), _mm_mul_ps( d4, d6 ) ) );
+		const __m128 t2 = _mm_mul_ps( s0, _mm_sub_ps( _mm_mul_ps( d2, d9 ), _mm_mul_ps( d4, d7 ) ) );
+		
+#ifndef DERIVE_UNSMOOTHED_BITANGENT
+		const __m128 d3 = _mm_sub_ps( _mm_load_ps( b[3] ), _mm_load_ps( a[3] ) );
+		const __m128 d8 = _mm_sub_ps( _mm_load_ps( c[3] ), _mm_load_ps( a[3] ) );
+		
+		const __m128 t3 = _mm_mul_ps( s1, _mm_sub_ps( _mm_mul_ps( d3, d5 ), _mm_mul_ps( d0, d8 ) ) );
+		const __m128 t4 = _mm_mul_ps( s1, _mm_sub_ps( _mm_mul_ps( d3, d6 ), _mm_mul_ps( d1, d8 ) ) );
+		const __m128 t5 = _mm_mul_ps( s1, _mm_sub_ps( _mm_mul_ps( d3, d7 ), _mm_mul_ps( d2, d8 ) ) );
+#else
+		const __m128 t3 = _mm_mul_ps( s1, _mm_sub_ps( _mm_mul_ps( n2, t1 ), _mm_mul_ps( n1, t2 ) ) );
+		const __m128 t4 = _mm_mul_ps( s1, _mm_sub_ps( _mm_mul_ps( n0, t2 ), _mm_mul_ps( n2, t0 ) ) );
+		const __m128 t5 = _mm_mul_ps( s1, _mm_sub_ps( _mm_mul_ps( n1, t0 ), _mm_mul_ps( n0, t1 ) ) );
+#endif
+		
+		ALIGNTYPE16 float n[3][4];
+		ALIGNTYPE16 float t[6][4];
+		_mm_store_ps( n[0], n0 );
+		_mm_store_ps( n[1], n1 );
+		_mm_store_ps( n[2], n2 );
+		_mm_store_ps( t[0], t0 );
+		_mm_store_ps( t[1], t1 );
+		_mm_store_ps( t[2], t2 );
+		_mm_store_ps( t[3], t3 );
+		_mm_store_ps( t[4], t4 );
+		_mm_store_ps( t[5], t5 );
+		
+		for( int k = 0; k < 4; k++ )
+		{
+			idDrawVert& vert = tri->verts[i + k];
+			vert.SetNormal( n[0][k], n[1][k], n[2][k] );
+			vert.SetTangent( t[0][k], t[1][k], t[2][k] );
+			vert.SetBiTangent( t[3][k], t[4][k], t[5][k] );
+		}
+	}
+#endif
+	
+	for( ; i < lastVert; i++ )
+	{
+		R_DeriveUnsmoothedVertexTangent( tri, i );
+	}
+}
+
+/*
+=================
+R_AllocTangentScratch
+
+One block for all the intermediate vectors of a surface. The vertex face
+lists are only needed when the vertexes are gathered by separate jobs.
+=================
+*/
+static void R_AllocTangentScratch( tangentSurface_t& surf, bool vertexFaces )
+{
+	const srfTriangles_t* tri = surf.tri;
+	const int numFaces = tri->numIndexes / 3;
+	const int numVectors = ( surf.mode == TANGENTS_WITHOUT_NORMALS ) ? 2 : 3;
+	
+	size_t bytes = numVectors * ( numFaces + tri->numVerts ) * sizeof( idVec3 );
+	if( vertexFaces )
+	{
+		bytes += ( tri->numVerts + 1 + tri->numIndexes ) * sizeof( int );
+	}
+	surf.scratch = R_StaticAlloc( bytes, TAG_TEMP );
+	
+	idVec3* vectors = ( idVec3* )surf.scratch;
+	surf.faceTangents = vectors;
+	surf.faceBitangents = vectors + numFaces;
+	surf.vertexTangents = vectors + numFaces * 2;
+	surf.vertexBitangents = vectors + numFaces * 2 + tri->numVerts;
+	vectors += ( numFaces + tri->numVerts ) * 2;
+	if( surf.mode != TANGENTS_WITHOUT_NORMALS )
+	{
+		surf.faceNormals = vectors;
+		surf.vertexNormals = vectors + numFaces;
+		vectors += numFaces + tri->numVerts;
+	}
+	else
+	{
+		surf.faceNormals = NULL;
+		surf.vertexNormals = NULL;
+	}
+	if( vertexFaces )
+	{
+		surf.vertexFaceOffsets = ( int* )vectors;
+		surf.vertexFaces = surf.vertexFaceOffsets + tri->numVerts + 1;
+	}
+	else
+	{
+		surf.vertexFaceOffsets = NULL;
+		surf.vertexFaces = NULL;
+	}
+}
+
+/*
+=================
+R_MergeDupVertNormals
+
+Same as R_DeriveNormalsAndTangents, the normals of vertexes with the same XYZ are shared.
+=================
+*/
+static void R_MergeDupVertNormals( const srfTriangles_t* tri, idVec3* vertexNormals )
+{
+	// add the normal of a duplicated vertex to the normal of the first vertex with the same XYZ
+	for( int i = 0; i < tri->numDupVerts; i++ )
+	{
+		vertexNormals[tri->dupVerts[i * 2 + 0]] += vertexNormals[tri->dupVerts[i * 2 + 1]];
+	}
+	
+	// copy vertex normals to duplicated vertices
+	for( int i = 0; i < tri->numDupVerts; i++ )
+	{
+		vertexNormals[tri->dupVerts[i * 2 + 1]] = vertexNormals[tri->dupVerts[i * 2 + 0]];
+	}
+}
+
+/*
+=================
+R_DeriveSurfaceTangents
+
+Single threaded version of the fast path, the triangle vectors are summed
+into the vertexes in the same order as the reference code.
+=================
+*/
+static void R_DeriveSurfaceTangents( srfTriangles_t* tri, const tangentMode_t mode )
+{
+	if( mode == TANGENTS_UNSMOOTHED )
+	{
+		R_DeriveUnsmoothedTangents( tri, 0, tri->numVerts );
+		tri->tangentsCalculated = true;
+		return;
+	}
+	
+	tangentSurface_t surf;
+	surf.tri = tri;
+	surf.mode = mode;
+	R_AllocTangentScratch( surf, false );
+	
+	const int numFaces = tri->numIndexes / 3;
+	R_DeriveFaceTangents( tri, 0, numFaces, surf.faceNormals, surf.faceTangents, surf.faceBitangents );
+	
+	const int numVectors = ( mode == TANGENTS_WITHOUT_NORMALS ) ? 2 : 3;
+	memset( surf.vertexTangents, 0, tri->numVerts * sizeof( idVec3 ) );
+	memset( surf.vertexBitangents, 0, tri->numVerts * sizeof( idVec3 ) );
+	if( numVectors == 3 )
+	{
+		memset( surf.vertexNormals, 0, tri->numVerts * sizeof( idVec3 ) );
+	}
+	
+	for( int i = 0; i < numFaces; i++ )
+	{
+		for( int j = 0; j < 3; j++ )
+		{
+			const int v = tri->indexes[i * 3 + j];
+			if( numVectors == 3 )
+			{
+				surf.vertexNormals[v] += surf.faceNormals[i];
+			}
+			surf.vertexTangents[v] += surf.faceTangents[i];
+			surf.vertexBitangents[v] += surf.faceBitangents[i];
+		}
+	}
+	
+	if( mode == TANGENTS_SMOOTHED )
+	{
+		R_MergeDupVertNormals( tri, surf.vertexNormals );
+	}
+	
+	R_FinishVertexTangents( tri, 0, tri->numVerts, surf.vertexNormals, surf.vertexTangents, surf.vertexBitangents );
+	
+	R_StaticFree( surf.scratch );
+	
+	tri->tangentsCalculated = true;
+}
+
+/*
+=================
+R_DeriveTangentsForMode
+
+Single surface entry point for both the reference and the fast code.
+=================
+*/
+static void R_DeriveTangentsForMode( srfTriangles_t* tri, const tangentMode_t mode )
+{
+	if( mode != TANGENTS_WITHOUT_NORMALS )
+	{
+		if( tri->tangentsCalculated )
+		{
+			return;
+		}
+		tr.pc.c_tangentIndexes += tri->numIndexes;
+	}
+	
+	if( r_useSIMDTangents.GetBool() )
+	{
+		R_DeriveSurfaceTangents( tri, mode );
+		return;
+	}
+	
+	switch( mode )
+	{
+		case TANGENTS_SMOOTHED:
+			R_DeriveNormalsAndTangents( tri );
+			break;
+		case TANGENTS_UNSMOOTHED:
+			R_DeriveUnsmoothedNormalsAndTangents( tri );
+			break;
+		case TANGENTS_WITHOUT_NORMALS:
+			R_DeriveTangentsWithoutNormals( tri );
+			break;
+	}
+	tri->tangentsCalculated = true;
+}
+
+/*
+=================
+R_DeriveSurfaceTangentsJob
+
+Derives all the vectors of the surfaces [first, last) that were too small to split.
+=================
+*/
+static void R_DeriveSurfaceTangentsJob( const tangentJobParms_t* parms )
+{
+	for( int i = parms->first; i < parms->last; i++ )
+	{
+		R_DeriveSurfaceTangents( parms->surfaces[i].tri, parms->surfaces[i].mode );
+	}
+}
+
+REGISTER_PARALLEL_JOB( R_DeriveSurfaceTangentsJob, "R_DeriveSurfaceTangentsJob" );
+
+/*
+=================
+R_DeriveFaceTangentsJob
+=================
+*/
+static void R_DeriveFaceTangentsJob( const tangentJobParms_t* parms )
+{
+	const tangentSurface_t& surf = *parms->surfaces;
+	R_DeriveFaceTangents( surf.tri, parms->first, parms->last, surf.faceNormals, surf.faceTangents, surf.faceBitangents );
+}
+
+REGISTER_PARALLEL_JOB( R_DeriveFaceTangentsJob, "R_DeriveFaceTangentsJob" );
+
+/*
+=================
+R_DeriveUnsmoothedTangentsJob
+=================
+*/
+static void R_DeriveUnsmoothedTangentsJob( const tangentJobParms_t* parms )
+{
+	R_DeriveUnsmoothedTangents( parms->surfaces->tri, parms->first, parms->last );
+}
+
+REGISTER_PARALLEL_JOB( R_DeriveUnsmoothedTangentsJob, "R_DeriveUnsmoothedTangentsJob" );
+
+/*
+=================
+R_BuildVertexFacesJob
+
+Lists the triangles using each vertex with a counting sort over the indexes, which
+keeps the triangles of a vertex in the order the single threaded code adds them.
+=================
+*/
+static void R_BuildVertexFacesJob( const tangentJobParms_t* parms )
+{
+	const tangentSurface_t& surf = *parms->surfaces;
+	const srfTriangles_t* tri = surf.tri;
+	int* offsets = surf.vertexFaceOffsets;
+	
+	memset( offsets, 0, ( tri->numVerts + 1 ) * sizeof( offsets[0] ) );
+	for( int i = 0; i < tri->numIndexes; i++ )
+	{
+		offsets[tri->indexes[i] + 1]++;
+	}
+	for( int i = 0; i < tri->numVerts; i++ )
+	{
+		offsets[i + 1] += offsets[i];
+	}
+	for( int i = 0; i < tri->numIndexes; i++ )
+	{
+		surf.vertexFaces[offsets[tri->indexes[i]]++] = i / 3;
+	}
+	
+	// the fill advanced every offset to the start of the next vertex
+	for( int i = tri->numVerts; i > 0; i-- )
+	{
+		offsets[i] = offsets[i - 1];
+	}
+	offsets[0] = 0;
+}
+
+REGISTER_PARALLEL_JOB( R_BuildVertexFacesJob, "R_BuildVertexFacesJob" );
+
+/*
+=================
+R_GatherVertexTangentsJob
+
+Sums the triangle vectors of the vertexes [first, last), each vertex is only written by one job.
+=================
+*/
+static void R_GatherVertexTangentsJob( const tangentJobParms_t* parms )
+{
+	const tangentSurface_t& surf = *parms->surfaces;
+	
+	for( int v = parms->first; v < parms->last; v++ )
+	{
+		idVec3 normal = vec3_zero;
+		idVec3 tangent = vec3_zero;
+		idVec3 bitangent = vec3_zero;
+		
+		for( int i = surf.vertexFaceOffsets[v]; i < surf.vertexFaceOffsets[v + 1]; i++ )
+		{
+			const int faceNum = surf.vertexFaces[i];
+			if( surf.faceNormals != NULL )
+			{
+				normal += surf.faceNormals[faceNum];
+			}
+			tangent += surf.faceTangents[faceNum];
+			bitangent += surf.faceBitangents[faceNum];
+		}
+		
+		if( surf.vertexNormals != NULL )
+		{
+			surf.vertexNormals[v] = normal;
+		}
+		surf.vertexTangents[v] = tangent;
+		surf.vertexBitangents[v] = bitangent;
+	}
+}
+
+REGISTER_PARALLEL_JOB( R_GatherVertexTangentsJob, "R_GatherVertexTangentsJob" );
+
+/*
+=================
+R_FinishVertexTangentsJob
+=================
+*/
+static void R_FinishVertexTangentsJob( const tangentJobParms_t* parms )
+{
+	const tangentSurface_t& surf = *parms->surfaces;
+	R_FinishVertexTangents( surf.tri, parms->first, parms->last, surf.vertexNormals, surf.vertexTangents, surf.vertexBitangents );
+}
+
+REGISTER_PARALLEL_JOB( R_FinishVertexTangentsJob, "R_FinishVertexTangentsJob" );
+
+/*
+=================
+R_AddRangeJobs
+
+Splits [0, num) into jobs of about jobSize elements.
+=================
+*/
+static void R_AddRangeJobs( idList< tangentJobParms_t >& jobs, tangentSurface_t* surf, const int num, const int jobSize )
+{
+	const int numJobs = ( num + jobSize - 1 ) / jobSize;
+	for( int i = 0; i < numJobs; i++ )
+	{
+		tangentJobParms_t& parms = jobs.Alloc();
+		parms.surfaces = surf;
+		parms.first = ( int )( ( int64 )num * i / numJobs );
+		parms.last = ( int )( ( int64 )num * ( i + 1 ) / numJobs );
+	}
+}
+
+/*
+=================
+R_AddTangentJobs
+=================
+*/
+static void R_AddTangentJobs( const idList< tangentJobParms_t >& jobs, jobRun_t function )
+{
+	for( int i = 0; i < jobs.Num(); i++ )
+	{
+		tr.loadJobList->AddJob( function, ( void* )&jobs[i] );
+	}
+}
+
+/*
+=================
+R_DeriveTangentsForSurfaces
+
+Derives the normals and tangents of a list of surfaces, picking the same method
+R_CleanupTriangles would for each surface. Small surfaces are grouped into jobs,
+large surfaces are split over several jobs. The results match R_DeriveTangents
+and R_DeriveTangentsWithoutNormals.
+
+This uses the load job list, so it must not be called from inside one of its own jobs.
+=================
+*/
+void R_DeriveTangentsForSurfaces( srfTriangles_t** tris, const int numSurfaces )
+{
+	const int jobSize = r_tangentJobSize.GetInteger();
+	if( !r_useSIMDTangents.GetBool() || jobSize <= 0 || tr.loadJobList == NULL )
+	{
+		for( int i = 0; i < numSurfaces; i++ )
+		{
+			R_DeriveTangentsForMode( tris[i], R_TangentMode( tris[i] ) );
+		}
+		return;
+	}
+	
+	idList< tangentSurface_t > smallSurfaces;
+	idList< tangentSurface_t > largeSurfaces;
+	smallSurfaces.Resize( numSurfaces );
+	largeSurfaces.Resize( numSurfaces );
+	
+	for( int i = 0; i < numSurfaces; i++ )
+	{
+		srfTriangles_t* tri = tris[i];
+		const tangentMode_t mode = R_TangentMode( tri );
+		if( mode != TANGENTS_WITHOUT_NORMALS )
+		{
+			if( tri->tangentsCalculated )
+			{
+				continue;
+			}
+			tr.pc.c_tangentIndexes += tri->numIndexes;
+		}
+		
+		const int numElements = ( mode == TANGENTS_UNSMOOTHED ) ? tri->numVerts : tri->numIndexes / 3;
+		tangentSurface_t& surf = ( numElements > jobSize ) ? largeSurfaces.Alloc() : smallSurfaces.Alloc();
+		memset( &surf, 0, sizeof( surf ) );
+		surf.tri = tri;
+		surf.mode = mode;
+	}
+	
+	idList< tangentJobParms_t > smallJobs;
+	idList< tangentJobParms_t > unsmoothedJobs;
+	idList< tangentJobParms_t > faceJobs;
+	idList< tangentJobParms_t > vertexFaceJobs;
+	
+	// the small surfaces are done in one go, grouped to about jobSize triangles per job
+	for( int i = 0; i < smallSurfaces.Num(); )
+	{
+		tangentJobParms_t& parms = smallJobs.Alloc();
+		parms.surfaces = smallSurfaces.Ptr();
+		parms.first = i;
+		for( int numFaces = 0; i < smallSurfaces.Num() && numFaces < jobSize; i++ )
+		{
+			numFaces += smallSurfaces[i].tri->numIndexes / 3;
+		}
+		parms.last = i;
+	}
+	
+	// the unsmoothed large surfaces only depend on their dominant triangles, the
+	// others start with the triangle vectors and the lists of vertex triangles
+	for( int i = 0; i < largeSurfaces.Num(); i++ )
+	{
+		tangentSurface_t& surf = largeSurfaces[i];
+		if( surf.mode == TANGENTS_UNSMOOTHED )
+		{
+			R_AddRangeJobs( unsmoothedJobs, &surf, surf.tri->numVerts, jobSize );
+			continue;
+		}
+		
+		R_AllocTangentScratch( surf, true );
+		R_AddRangeJobs( faceJobs, &surf, surf.tri->numIndexes / 3, jobSize );
+		
+		tangentJobParms_t& parms = vertexFaceJobs.Alloc();
+		parms.surfaces = &surf;
+		parms.first = 0;
+		parms.last = surf.tri->numVerts;
+	}
+	
+	R_AddTangentJobs( smallJobs, ( jobRun_t )R_DeriveSurfaceTangentsJob );
+	R_AddTangentJobs( unsmoothedJobs, ( jobRun_t )R_DeriveUnsmoothedTangentsJob );
+	R_AddTangentJobs( faceJobs, ( jobRun_t )R_DeriveFaceTangentsJob );
+	R_AddTangentJobs( vertexFaceJobs, ( jobRun_t )R_BuildVertexFacesJob );
+	tr.loadJobList->Submit();
+	tr.loadJobList->Wait();
+	
+	if( vertexFaceJobs.Num() > 0 )
+	{
+		// sum the triangle vectors into the vertexes
+		idList< tangentJobParms_t > vertexJobs;
+		for( int i = 0; i < vertexFaceJobs.Num(); i++ )
+		{
+			R_AddRangeJobs( vertexJobs, vertexFaceJobs[i].surfaces, vertexFaceJobs[i].surfaces->tri->numVerts, jobSize );
+		}
+		
+		R_AddTangentJobs( vertexJobs, ( jobRun_t )R_GatherVertexTangentsJob );
+		tr.loadJobList->Submit();
+		tr.loadJobList->Wait();
+		
+		for( int i = 0; i < vertexFaceJobs.Num(); i++ )
+		{
+			const tangentSurface_t& surf = *vertexFaceJobs[i].surfaces;
+			if( surf.mode == TANGENTS_SMOOTHED )
+			{
+				R_MergeDupVertNormals( surf.tri, surf.vertexNormals );
+			}
+		}
+		
+		// normalize and compress
+		R_AddTangentJobs( vertexJobs, ( jobRun_t )R_FinishVertexTangentsJob );
+		tr.loadJobList->Submit();
+		tr.loadJobList->Wait();
+	}
+	
+	for( int i = 0; i < largeSurfaces.Num(); i++ )
+	{
+		if( largeSurfaces[i].scratch != NULL )
+		{
+			R_StaticFree( largeSurfaces[i].scratch );
+		}
+		largeSurfaces[i].tri->tangentsCalculated = true;
+	}
+}
+
+/*
+=================
+R_CopyTangentTestSurface
+
+Only the vertexes are written by the tangent code, everything else is shared with the original.
+=================
+*/
+static srfTriangles_t* R_CopyTangentTestSurface( const srfTriangles_t* tri )
+{
+	srfTriangles_t* copy = ( srfTriangles_t* )R_StaticAlloc( sizeof( *copy ), TAG_TEMP );
+	memcpy( copy, tri, sizeof( *copy ) );
+	copy->verts = ( idDrawVert* )R_StaticAlloc( tri->numVerts * sizeof( idDrawVert ), TAG_TEMP );
+	memcpy( copy->verts, tri->verts, tri->numVerts * sizeof( idDrawVert ) );
+	copy->tangentsCalculated = false;
+	return copy;
+}
+
+/*
+=================
+R_CompareTangentTestSurface
+
+Returns the largest difference in compressed units and counts the flipped bitangent signs.
+=================
+*/
+static float R_CompareTangentTestSurface( const srfTriangles_t* reference, const srfTriangles_t* test, int& signFlips )
+{
+	float maxError = 0.0f;
+	for( int i = 0; i < reference->numVerts; i++ )
+	{
+		const idDrawVert& a = reference->verts[i];
+		const idDrawVert& b = test->verts[i];
+		
+		const idVec3 normalError = a.GetNormalRaw() - b.GetNormalRaw();
+		const idVec3 tangentError = a.GetTangentRaw() - b.GetTangentRaw();
+		for( int j = 0; j < 3; j++ )
+		{
+			maxError = Max( maxError, idMath::Fabs( normalError[j] ) );
+			maxError = Max( maxError, idMath::Fabs( tangentError[j] ) );
+		}
+		if( a.GetBiTangentSign() != b.GetBiTangentSign() )
+		{
+			signFlips++;
+		}
+	}
+	
+	// a byte covers the [-1, 1] range
+	return maxError * 255.0f / 2.0f;
+}
+
+/*
+=================
+R_TestDeriveTangents_f
+
+Runs the reference, the vectorized and the job based tangent derivation on copies
+of the surfaces of the given models, or all models in the current world, and
+compares the results.
+=================
+*/
+void R_TestDeriveTangents_f( const idCmdArgs& args )
+{
+	idList< idRenderModel* > models;
+	if( args.Argc() > 1 )
+	{
+		for( int i = 1; i < args.Argc(); i++ )
+		{
+			idRenderModel* model = renderModelManager->CheckModel( args.Argv( i ) );
+			if( model == NULL )
+			{
+				common->Printf( "model '%s' not found\n", args.Argv( i ) );
+				continue;
+			}
+			models.AddUnique( model );
+		}
+	}
+	else if( tr.primaryWorld != NULL )
+	{
+		for( int i = 0; i < tr.primaryWorld->localModels.Num(); i++ )
+		{
+			models.AddUnique( tr.primaryWorld->localModels[i] );
+		}
+		for( int i = 0; i < tr.primaryWorld->entityDefs.Num(); i++ )
+		{
+			const idRenderEntityLocal* def = tr.primaryWorld->entityDefs[i];
+			if( def != NULL && def->parms.hModel != NULL )
+			{
+				models.AddUnique( def->parms.hModel );
+			}
+		}
+	}
+	else
+	{
+		common->Printf( "usage: testDeriveTangents [model ...]\n" );
+		return;
+	}
+	
+	idList< srfTriangles_t* > sources;
+	for( int i = 0; i < models.Num(); i++ )
+	{
+		for( int j = 0; j < models[i]->NumSurfaces(); j++ )
+		{
+			const srfTriangles_t* tri = models[i]->Surface( j )->geometry;
+			if( tri == NULL || tri->verts == NULL || tri->indexes == NULL || tri->numIndexes == 0 )
+			{
+				continue;
+			}
+			sources.AddUnique( const_cast< srfTriangles_t* >( tri ) );
+		}
+	}
+	if( sources.Num() == 0 )
+	{
+		common->Printf( "no surfaces to test\n" );
+		return;
+	}
+	
+	idList< srfTriangles_t* > referenceTris;
+	idList< srfTriangles_t* > simdTris;
+	idList< srfTriangles_t* > jobTris;
+	int numVerts = 0;
+	for( int i = 0; i < sources.Num(); i++ )
+	{
+		referenceTris.Append( R_CopyTangentTestSurface( sources[i] ) );
+		simdTris.Append( R_CopyTangentTestSurface( sources[i] ) );
+		jobTris.Append( R_CopyTangentTestSurface( sources[i] ) );
+		numVerts += sources[i]->numVerts;
+	}
+	
+	const int64 referenceStart = Sys_Microseconds();
+	for( int i = 0; i < referenceTris.Num(); i++ )
+	{
+		switch( R_TangentMode( referenceTris[i] ) )
+		{
+			case TANGENTS_SMOOTHED:
+				R_DeriveNormalsAndTangents( referenceTris[i] );
+				break;
+			case TANGENTS_UNSMOOTHED:
+				R_DeriveUnsmoothedNormalsAndTangents( referenceTris[i] );
+				break;
+			case TANGENTS_WITHOUT_NORMALS:
+				R_DeriveTangentsWithoutNormals( referenceTris[i] );
+				break;
+		}
+	}
+	const int64 simdStart = Sys_Microseconds();
+	for( int i = 0; i < simdTris.Num(); i++ )
+	{
+		R_DeriveSurfaceTangents( simdTris[i], R_TangentMode( simdTris[i] ) );
+	}
+	const int64 jobStart = Sys_Microseconds();
+	R_DeriveTangentsForSurfaces( jobTris.Ptr(), jobTris.Num() );
+	const int64 jobEnd = Sys_Microseconds();
+	
+	float simdError = 0.0f;
+	float jobError = 0.0f;
+	int simdSignFlips = 0;
+	int jobSignFlips = 0;
+	for( int i = 0; i < sources.Num(); i++ )
+	{
+		simdError = Max( simdError, R_CompareTangentTestSurface( referenceTris[i], simdTris[i], simdSignFlips ) );
+		jobError = Max( jobError, R_CompareTangentTestSurface( referenceTris[i], jobTris[i], jobSignFlips ) );
+		
+		R_StaticFree( referenceTris[i]->verts );
+		R_StaticFree( referenceTris[i] );
+		R_StaticFree( simdTris[i]->verts );
+		R_StaticFree( simdTris[i] );
+		R_StaticFree( jobTris[i]->verts );
+		R_StaticFree( jobTris[i] );
+	}
+	
+	common->Printf( "%i surfaces, %i verts\n", sources.Num(), numVerts );
+	common->Printf( "reference: %5i usec\n", ( int )( simdStart - referenceStart ) );
+	common->Printf( "simd:      %5i usec, max error %1.2f, %i bitangent sign flips\n", ( int )( jobStart - simdStart ), simdError, simdSignFlips );
+	common->Printf( "jobs:      %5i usec, max error %1.2f, %i bitangent sign flips\n", ( int )( jobEnd - jobStart ), jobError, jobSignFlips );
+	
+	// a rounding difference may move a component to the next byte value
+	if( simdError > 1.0f || jobError > 1.0f )
+	{
+		common->Warning( "testDeriveTangents: results differ by more than one unit" );
+	}
+}
+
+/*
+==================
+R_DeriveTangents
+
+This is called once for static surfaces, and every frame for deforming surfaces
+
+Builds tangents, normals, and face planes
+==================
+*/
+void R_DeriveTangents( srfTriangles_t* tri )
+{
+	R_DeriveTangentsForMode( tri, ( tri->dominantTris != NULL ) ? TANGENTS_UNSMOOTHED : TANGENTS_SMOOTHED );
+}
+
+/*
+=================
+R_RemoveDuplicatedTriangles
+
+silIndexes must have already been calculated
+
+silIndexes are used instead of indexes, because duplicated
+triangles could have different texture coordinates.
+=================
+*/
+void R_RemoveDuplicatedTriangles( srfTriangles_t* tri )
+{
+	int		c_removed;
+	int		i, j, r;
+	int		a, b, c;
+	
+	c_removed = 0;
+	
+	// check for completely duplicated triangles
+	// any rotation of the triangle is still the same, but a mirroring
+	// is considered different
+	for( i = 0; i < tri->numIndexes; i += 3 )
+	{
+		for( r = 0; r < 3; r++ )
+		{
+			a = tri->silIndexes[i + r];
+			b = tri->silIndexes[i + ( r + 1 ) % 3];
+			c = tri->silIndexes[i + ( r + 2 ) % 3];
+			for( j = i + 3; j < tri->numIndexes; j += 3 )
+			{
+				if( tri->silIndexes[j] == a && tri->silIndexes[j + 1] == b && tri->silIndexes[j + 2] == c )
+				{
+					c_removed++;
+					memmove( tri->indexes + j, tri->indexes + j + 3, ( tri->numIndexes - j - 3 ) * sizeof( tri->indexes[0] ) );
+					memmove( tri->silIndexes + j, tri->silIndexes + j + 3, ( tri->numIndexes - j - 3 ) * sizeof( tri->silIndexes[0] ) );
+					tri->numIndexes -= 3;
+					j -= 3;
+				}
+			}
+		}
+	}
+	
+	if( c_removed )
+	{
+		common->Printf( "removed %i duplicated triangles\n", c_removed );
+	}
+}
+
+/*
+=================
+R_RemoveDegenerateTriangles
+
+silIndexes must have already been calculated
+=================
+*/
+void R_RemoveDegenerateTriangles( srfTriangles_t* tri )
+{
+	int		c_removed;
+	int		i;
+	int		a, b, c;
+	
+	assert( tri->silIndexes != NULL );
+	
+	// check for completely degenerate triangles
+	c_removed = 0;
+	for( i = 0; i < tri->numIndexes; i += 3 )
+	{
+		a = tri->silIndexes[i];
+		b = tri->silIndexes[i + 1];
+		c = tri->silIndexes[i + 2];
+		if( a == b || a == c || b == c )
+		{
+			c_removed++;
+			memmove( tri->indexes + i, tri->indexes + i + 3, ( tri->numIndexes - i - 3 ) * sizeof( tri->indexes[0] ) );
+			memmove( tri->silIndexes + i, tri->silIndexes + i + 3, ( tri->numIndexes - i - 3 ) * sizeof( tri->silIndexes[0] ) );
+			tri->numIndexes -= 3;
+			i -= 3;
+		}
+	}
+	
+	// this doesn't free the memory used by the unused verts
+	
+	if( c_removed )
+	{
+		common->Printf( "removed %i degenerate triangles\n", c_removed );
+	}
+}
+
+/*
+=================
+R_TestDegenerateTextureSpace
+=================
+*/
+void R_TestDegenerateTextureSpace( srfTriangles_t* tri )
+{
+	int		c_degenerate;
+	int		i;
+	
+	// check for triangles with a degenerate texture space
+	c_degenerate = 0;
+	for( i = 0; i < tri->numIndexes; i += 3 )
+	{
+		const idDrawVert& a = tri->verts[tri->indexes[i + 0]];
+		const idDrawVert& b = tri->verts[tri->indexes[i + 1]];
+		const idDrawVert& c = tri->verts[tri->indexes[i + 2]];
+		
+		// RB: compare texcoords instead of pointers
+		if( a.GetTexCoord() == b.GetTexCoord() || b.GetTexCoord() == c.GetTexCoord() || c.GetTexCoord() == a.GetTexCoord() )
+		{
+			c_degenerate++;
+		}
+		// RB end
+	}
+	
+	if( c_degenerate )
+	{
+//		common->Printf( "%d triangles with a degenerate texture space\n", c_degenerate );
+	}
+}
+
+/*
+=================
+R_RemoveUnusedVerts
+=================
+*/
+void R_RemoveUnusedVerts( srfTriangles_t* tri )
+{
+	int		i;
+	int*		mark;
+	int		index;
+	int		used;
 	
 	mark = ( int* )R_ClearedStaticAlloc( tri->numVerts * sizeof( *mark ) );
 	
-	for( i = 0; i < tri->numIndexes; i++ )
+	for( i = 0; i < tri->numIndexes; i++ )
+	{
+		index = tri->indexes[i];
+		if( index < 0 || index >= tri->numVerts )
+		{
+			common->Error( "R_RemoveUnusedVerts: bad index" );
+		}
+		mark[ index ] = 1;
+		
+		if( tri->silIndexes )
+		{
+			index = tri->silIndexes[i];
+			if( index < 0 || index >= tri->numVerts )
+			{
+				common->Error( "R_RemoveUnusedVerts: bad index" );
+			}
+			mark[ index ] = 1;
+		}
+	}
+	
+	used = 0;
+	for( i = 0; i < tri->numVerts; i++ )
+	{
+		if( !mark[i] )
+		{
+			continue;
+		}
+		mark[i] = used + 1;
+		used++;
+	}
+	
+	if( used != tri->numVerts )
+	{
+		for( i = 0; i < tri->numIndexes; i++ )
+		{
+			tri->indexes[i] = mark[ tri->indexes[i] ] - 1;
+			if( tri->silIndexes )
+			{
+				tri->silIndexes[i] = mark[ tri->silIndexes[i] ] - 1;
+			}
+		}
+		tri->numVerts = used;
+		
+		for( i = 0; i < tri->numVerts; i++ )
+		{
+			index = mark[ i ];
+			if( !index )
+			{
+				continue;
+			}
+			tri->verts[ index - 1 ] = tri->verts[i];
+		}
+		
+		// this doesn't realloc the arrays to save the memory used by the unused verts
+	}
+	
+	R_StaticFree( mark );
+}
+
+/*
+=================
+R_MergeSurfaceList
+
+Only deals with vertexes and indexes, not silhouettes, planes, etc.
+Does NOT perform a cleanup triangles, so there may be duplicated verts in the result.
+=================
+*/
+srfTriangles_t* R_MergeSurfaceList( const srfTriangles_t** surfaces, int numSurfaces )
+{
+	srfTriangles_t*	newTri;
+	const srfTriangles_t*	tri;
+	int				i, j;
+	int				totalVerts;
+	int				totalIndexes;
+	
+	totalVerts = 0;
+	totalIndexes = 0;
+	for( i = 0; i < numSurfaces; i++ )
+	{
+		totalVerts += surfaces[i]->numVerts;
+		totalIndexes += surfaces[i]->numIndexes;
+	}
+	
+	newTri = R_AllocStaticTriSurf();
+	newTri->numVerts = totalVerts;
+	newTri->numIndexes = totalIndexes;
+	R_AllocStaticTriSurfVerts( newTri, newTri->numVerts );
+	R_AllocStaticTriSurfIndexes( newTri, newTri->numIndexes );
+	
+	totalVerts = 0;
+	totalIndexes = 0;
+	for( i = 0; i < numSurfaces; i++ )
+	{
+		tri = surfaces[i];
+		memcpy( newTri->verts + totalVerts, tri->verts, tri->numVerts * sizeof( *tri->verts ) );
+		for( j = 0; j < tri->numIndexes; j++ )
+		{
+			newTri->indexes[ totalIndexes + j ] = totalVerts + tri->indexes[j];
+		}
+		totalVerts += tri->numVerts;
+		totalIndexes += tri->numIndexes;
+	}
+	
+	return newTri;
+}
+
+/*
+=================
+R_MergeTriangles
+
+Only deals with vertexes and indexes, not silhouettes, planes, etc.
+Does NOT perform a cleanup triangles, so there may be duplicated verts in the result.
+=================
+*/
+srfTriangles_t* R_MergeTriangles( const srfTriangles_t* tri1, const srfTriangles_t* tri2 )
+{
+	const srfTriangles_t*	tris[2];
+	
+	tris[0] = tri1;
+	tris[1] = tri2;
+	
+	return R_MergeSurfaceList( tris, 2 );
+}
+
+/*
+=================
+R_ReverseTriangles
+
+Lit two sided surfaces need to have the triangles actually duplicated,
+they can't just turn on two sided lighting, because the normal and tangents
+are wrong on the other sides.
+
+This should be called before R_CleanupTriangles
+=================
+*/
+void R_ReverseTriangles( srfTriangles_t* tri )
+{
+	int			i;
+	
+	// flip the normal on each vertex
+	// If the surface is going to have generated normals, this won't matter,
+	// but if it has explicit normals, this will keep it on the correct side
+	for( i = 0; i < tri->numVerts; i++ )
+	{
+		tri->verts[i].SetNormal( vec3_origin - tri->verts[i].GetNormal() );
+	}
+	
+	// flip the index order to make them back sided
+	for( i = 0; i < tri->numIndexes; i += 3 )
+	{
+		triIndex_t	temp;
+		
+		temp = tri->indexes[ i + 0 ];
+		tri->indexes[ i + 0 ] = tri->indexes[ i + 1 ];
+		tri->indexes[ i + 1 ] = temp;
+	}
+}
+
+/*
+===================================================================================
+
+TRIANGLE ORDER OPTIMIZATION
+
+Static surfaces are reordered for the post-transform vertex cache with
+Tom Forsyth's "Linear-Speed Vertex Cache Optimisation", optionally sorted in
+clusters so outward facing triangles are drawn first to reduce overdraw, and
+finally the vertexes are renumbered in the order of their first reference so
+vertex fetches walk linearly through memory.
+
+This runs inside R_CleanupTriangles before the sil edges, dup verts and
+mirrored verts are created, so everything derived from the triangle and vertex
+numbers stays consistent and ends up in the binary model caches.
+
+===================================================================================
+*/
+
+idCVar r_optimizeTriangles( "r_optimizeTriangles", "1", CVAR_RENDERER | CVAR_BOOL, "reorder static model triangles and vertexes for vertex cache locality" );
+idCVar r_optimizeOverdraw( "r_optimizeOverdraw", "0", CVAR_RENDERER | CVAR_BOOL, "sort clusters of opaque static model triangles to reduce overdraw" );
+idCVar r_showTriangleOptimization( "r_showTriangleOptimization", "0", CVAR_RENDERER | CVAR_BOOL, "print ACMR / ATVR before and after optimizing each surface" );
+
+static const int	VERTEX_CACHE_OPTIMIZE_SIZE = 32;	// LRU size the optimizer assumes
+static const int	VERTEX_CACHE_ANALYZE_SIZE = 16;		// FIFO size used for the ACMR / ATVR statistics
+
+/*
+=================
+R_AnalyzeVertexCache
+
+Simulates a FIFO post-transform cache.
+ACMR is the average number of vertex transforms per triangle, 0.5 is the
+best possible and 3.0 the worst. ATVR is the average number of transforms
+per referenced vertex, 1.0 is optimal.
+=================
+*/
+static void R_AnalyzeVertexCache( const triIndex_t* indexes, int numIndexes, int numVerts, float& acmr, float& atvr )
+{
+	int* cacheTime = ( int* )R_ClearedStaticAlloc( numVerts * sizeof( cacheTime[0] ) );
+	
+	int misses = 0;
+	int referenced = 0;
+	for( int i = 0; i < numIndexes; i++ )
+	{
+		const int v = indexes[i];
+		if( cacheTime[v] == 0 )
+		{
+			referenced++;
+		}
+		// cacheTime holds the number of the miss that last transformed the vertex, 0 if never
+		if( cacheTime[v] == 0 || misses - cacheTime[v] >= VERTEX_CACHE_ANALYZE_SIZE )
+		{
+			misses++;
+			cacheTime[v] = misses;
+		}
+	}
+	
+	R_StaticFree( cacheTime );
+	
+	acmr = ( numIndexes > 0 ) ? ( float )misses / ( numIndexes / 3 ) : 0.0f;
+	atvr = ( referenced > 0 ) ? ( float )misses / referenced : 0.0f;
+}
+
+/*
+=================
+R_VertexCacheScore
+=================
+*/
+static float R_VertexCacheScore( int cachePosition, int remainingTris )
+{
+	if( remainingTris == 0 )
 	{
-		index = tri->indexes[i];
-		if( index < 0 || index >= tri->numVerts )
+		// no triangle needs this vertex anymore
+		return -1.0f;
+	}
+	
+	float score = 0.0f;
+	if( cachePosition >= 0 )
+	{
+		if( cachePosition < 3 )
 		{
-			common->Error( "R_RemoveUnusedVerts: bad index" );
+			// used by the last triangle, a fixed score keeps it from favouring
+			// either of the last triangle's edges
+			score = 0.75f;
 		}
-		mark[ index ] = 1;
-		
-		if( tri->silIndexes )
+		else
 		{
-			index = tri->silIndexes[i];
-			if( index < 0 || index >= tri->numVerts )
-			{
-				common->Error( "R_RemoveUnusedVerts: bad index" );
-			}
-			mark[ index ] = 1;
+			const float scale = 1.0f / ( VERTEX_CACHE_OPTIMIZE_SIZE - 3 );
+			score = idMath::Pow( 1.0f - ( cachePosition - 3 ) * scale, 1.5f );
 		}
 	}
 	
-	used = 0;
-	for( i = 0; i < tri->numVerts; i++ )
+	// boost vertexes with few triangles left so lone triangles don't get stranded
+	score += 2.0f * idMath::InvSqrt( ( float )remainingTris );
+	
+	return score;
+}
+
+/*
+=================
+R_OptimizeVertexCacheOrder
+
+Greedily emits the triangle with the best score among the triangles that use a
+vertex in the simulated LRU cache. Only falls back to a full search when the
+cache has no candidates left, which happens once per disconnected island.
+=================
+*/
+static void R_OptimizeVertexCacheOrder( const triIndex_t* indexes, int numIndexes, int numVerts, int* triOrder )
+{
+	const int numTris = numIndexes / 3;
+	
+	int* vertTriStart = ( int* )R_ClearedStaticAlloc( ( numVerts + 1 ) * sizeof( vertTriStart[0] ) );
+	int* vertTriCount = ( int* )R_ClearedStaticAlloc( numVerts * sizeof( vertTriCount[0] ) );
+	int* vertTris = ( int* )R_StaticAlloc( numIndexes * sizeof( vertTris[0] ) );
+	int* vertCachePos = ( int* )R_StaticAlloc( numVerts * sizeof( vertCachePos[0] ) );
+	float* vertScore = ( float* )R_StaticAlloc( numVerts * sizeof( vertScore[0] ) );
+	float* triScore = ( float* )R_StaticAlloc( numTris * sizeof( triScore[0] ) );
+	bool* triEmitted = ( bool* )R_ClearedStaticAlloc( numTris * sizeof( triEmitted[0] ) );
+	
+	// build the vertex to triangle adjacency
+	for( int i = 0; i < numIndexes; i++ )
 	{
-		if( !mark[i] )
+		vertTriStart[indexes[i] + 1]++;
+	}
+	for( int i = 0; i < numVerts; i++ )
+	{
+		vertTriStart[i + 1] += vertTriStart[i];
+	}
+	for( int i = 0; i < numIndexes; i++ )
+	{
+		const int v = indexes[i];
+		vertTris[vertTriStart[v] + vertTriCount[v]++] = i / 3;
+	}
+	
+	for( int i = 0; i < numVerts; i++ )
+	{
+		vertCachePos[i] = -1;
+		vertScore[i] = R_VertexCacheScore( -1, vertTriCount[i] );
+	}
+	
+	int bestTri = -1;
+	float bestScore = -1.0f;
+	for( int i = 0; i < numTris; i++ )
+	{
+		triScore[i] = vertScore[indexes[i * 3 + 0]] + vertScore[indexes[i * 3 + 1]] + vertScore[indexes[i * 3 + 2]];
+		if( triScore[i] > bestScore )
 		{
-			continue;
+			bestScore = triScore[i];
+			bestTri = i;
 		}
-		mark[i] = used + 1;
-		used++;
 	}
 	
-	if( used != tri->numVerts )
+	int cache[VERTEX_CACHE_OPTIMIZE_SIZE + 3];
+	int cacheSize = 0;
+	int scanStart = 0;
+	
+	for( int emitted = 0; emitted < numTris; emitted++ )
 	{
-		for( i = 0; i < tri->numIndexes; i++ )
+		if( bestTri < 0 )
 		{
-			tri->indexes[i] = mark[ tri->indexes[i] ] - 1;
-			if( tri->silIndexes )
+			// nothing in the cache touches a remaining triangle, start a new island
+			bestScore = -1.0f;
+			for( int i = scanStart; i < numTris; i++ )
 			{
-				tri->silIndexes[i] = mark[ tri->silIndexes[i] ] - 1;
+				if( triEmitted[i] )
+				{
+					if( i == scanStart )
+					{
+						scanStart++;
+					}
+					continue;
+				}
+				if( triScore[i] > bestScore )
+				{
+					bestScore = triScore[i];
+					bestTri = i;
+				}
 			}
 		}
-		tri->numVerts = used;
 		
-		for( i = 0; i < tri->numVerts; i++ )
+		assert( bestTri >= 0 && !triEmitted[bestTri] );
+		
+		triOrder[emitted] = bestTri;
+		triEmitted[bestTri] = true;
+		
+		// detach the triangle from its vertexes
+		const triIndex_t* tri = indexes + bestTri * 3;
+		for( int j = 0; j < 3; j++ )
 		{
-			index = mark[ i ];
-			if( !index )
+			const int v = tri[j];
+			int* list = vertTris + vertTriStart[v];
+			for( int k = 0; k < vertTriCount[v]; k++ )
 			{
-				continue;
+				if( list[k] == bestTri )
+				{
+					list[k] = list[--vertTriCount[v]];
+					break;
+				}
 			}
-			tri->verts[ index - 1 ] = tri->verts[i];
 		}
 		
-		// this doesn't realloc the arrays to save the memory used by the unused verts
+		// move the triangle's vertexes to the front of the cache
+		int newCache[VERTEX_CACHE_OPTIMIZE_SIZE + 3];
+		int newCacheSize = 0;
+		for( int j = 0; j < 3; j++ )
+		{
+			newCache[newCacheSize++] = tri[j];
+		}
+		for( int j = 0; j < cacheSize; j++ )
+		{
+			const int v = cache[j];
+			if( v != tri[0] && v != tri[1] && v != tri[2] )
+			{
+				newCache[newCacheSize++] = v;
+			}
+		}
+		
+		// vertexes pushed past the cache size get their uncached score back
+		for( int j = 0; j < newCacheSize; j++ )
+		{
+			const int v = newCache[j];
+			const int pos = ( j < VERTEX_CACHE_OPTIMIZE_SIZE ) ? j : -1;
+			const float newScore = R_VertexCacheScore( pos, vertTriCount[v] );
+			const float delta = newScore - vertScore[v];
+			
+			vertCachePos[v] = pos;
+			vertScore[v] = newScore;
+			
+			for( int k = 0; k < vertTriCount[v]; k++ )
+			{
+				triScore[vertTris[vertTriStart[v] + k]] += delta;
+			}
+		}
+		
+		cacheSize = Min( newCacheSize, VERTEX_CACHE_OPTIMIZE_SIZE );
+		memcpy( cache, newCache, cacheSize * sizeof( cache[0] ) );
+		
+		// the next triangle is picked among the ones touching the cache
+		bestTri = -1;
+		bestScore = -1.0f;
+		for( int j = 0; j < cacheSize; j++ )
+		{
+			const int v = cache[j];
+			for( int k = 0; k < vertTriCount[v]; k++ )
+			{
+				const int t = vertTris[vertTriStart[v] + k];
+				if( triScore[t] > bestScore )
+				{
+					bestScore = triScore[t];
+					bestTri = t;
+				}
+			}
+		}
 	}
 	
-	R_StaticFree( mark );
+	R_StaticFree( vertTriStart );
+	R_StaticFree( vertTriCount );
+	R_StaticFree( vertTris );
+	R_StaticFree( vertCachePos );
+	R_StaticFree( vertScore );
+	R_StaticFree( triScore );
+	R_StaticFree( triEmitted );
 }
 
+struct triCluster_t
+{
+	int		firstTri;
+	int		numTris;
+	float	sortKey;
+};
+
 /*
 =================
-R_MergeSurfaceList
+R_SortTriClusters
+=================
+*/
+static int R_SortTriClusters( const void* a, const void* b )
+{
+	const triCluster_t* ca = ( const triCluster_t* )a;
+	const triCluster_t* cb = ( const triCluster_t* )b;
+	
+	if( ca->sortKey > cb->sortKey )
+	{
+		return -1;
+	}
+	if( ca->sortKey < cb->sortKey )
+	{
+		return 1;
+	}
+	return ca->firstTri - cb->firstTri;
+}
 
-Only deals with vertexes and indexes, not silhouettes, planes, etc.
-Does NOT perform a cleanup triangles, so there may be duplicated verts in the result.
+/*
+=================
+R_OptimizeOverdrawOrder
+
+Splits the cache optimized triangle order into clusters wherever the simulated
+cache would start over anyway, so the clusters can be moved around without
+hurting the cache efficiency much. Clusters that face away from the center of
+the surface are likely to occlude the others and are drawn first.
 =================
 */
-srfTriangles_t* R_MergeSurfaceList( const srfTriangles_t** surfaces, int numSurfaces )
+static void R_OptimizeOverdrawOrder( const srfTriangles_t* tri, int* triOrder )
 {
-	srfTriangles_t*	newTri;
-	const srfTriangles_t*	tri;
-	int				i, j;
-	int				totalVerts;
-	int				totalIndexes;
+	const int numTris = tri->numIndexes / 3;
 	
-	totalVerts = 0;
-	totalIndexes = 0;
-	for( i = 0; i < numSurfaces; i++ )
+	triCluster_t* clusters = ( triCluster_t* )R_StaticAlloc( numTris * sizeof( clusters[0] ) );
+	int* cacheTime = ( int* )R_ClearedStaticAlloc( tri->numVerts * sizeof( cacheTime[0] ) );
+	
+	int numClusters = 0;
+	int misses = 0;
+	for( int i = 0; i < numTris; i++ )
 	{
-		totalVerts += surfaces[i]->numVerts;
-		totalIndexes += surfaces[i]->numIndexes;
+		const triIndex_t* indexes = tri->indexes + triOrder[i] * 3;
+		
+		int triMisses = 0;
+		for( int j = 0; j < 3; j++ )
+		{
+			const int v = indexes[j];
+			if( cacheTime[v] == 0 || misses - cacheTime[v] >= VERTEX_CACHE_ANALYZE_SIZE )
+			{
+				misses++;
+				cacheTime[v] = misses;
+				triMisses++;
+			}
+		}
+		
+		if( triMisses == 3 || numClusters == 0 )
+		{
+			clusters[numClusters].firstTri = i;
+			clusters[numClusters].numTris = 0;
+			numClusters++;
+		}
+		clusters[numClusters - 1].numTris++;
 	}
 	
-	newTri = R_AllocStaticTriSurf();
-	newTri->numVerts = totalVerts;
-	newTri->numIndexes = totalIndexes;
-	R_AllocStaticTriSurfVerts( newTri, newTri->numVerts );
-	R_AllocStaticTriSurfIndexes( newTri, newTri->numIndexes );
+	R_StaticFree( cacheTime );
 	
-	totalVerts = 0;
-	totalIndexes = 0;
-	for( i = 0; i < numSurfaces; i++ )
+	if( numClusters > 1 )
 	{
-		tri = surfaces[i];
-		memcpy( newTri->verts + totalVerts, tri->verts, tri->numVerts * sizeof( *tri->verts ) );
-		for( j = 0; j < tri->numIndexes; j++ )
+		// area weighted centroid of the whole surface
+		idVec3 center = vec3_zero;
+		float totalArea = 0.0f;
+		for( int i = 0; i < numTris; i++ )
 		{
-			newTri->indexes[ totalIndexes + j ] = totalVerts + tri->indexes[j];
+			const idVec3& a = tri->verts[tri->indexes[i * 3 + 0]].xyz;
+			const idVec3& b = tri->verts[tri->indexes[i * 3 + 1]].xyz;
+			const idVec3& c = tri->verts[tri->indexes[i * 3 + 2]].xyz;
+			const float area = ( ( b - a ).Cross( c - a ) ).Length();
+			center += ( a + b + c ) * area;
+			totalArea += area;
 		}
-		totalVerts += tri->numVerts;
-		totalIndexes += tri->numIndexes;
+		if( totalArea > 0.0f )
+		{
+			center /= totalArea * 3.0f;
+		}
+		
+		for( int i = 0; i < numClusters; i++ )
+		{
+			idVec3 clusterCenter = vec3_zero;
+			idVec3 clusterNormal = vec3_zero;
+			float clusterArea = 0.0f;
+			for( int j = 0; j < clusters[i].numTris; j++ )
+			{
+				const triIndex_t* indexes = tri->indexes + triOrder[clusters[i].firstTri + j] * 3;
+				const idVec3& a = tri->verts[indexes[0]].xyz;
+				const idVec3& b = tri->verts[indexes[1]].xyz;
+				const idVec3& c = tri->verts[indexes[2]].xyz;
+				// triangles are clockwise, so this points to the front side
+				const idVec3 normal = ( c - a ).Cross( b - a );
+				const float area = normal.Length();
+				clusterCenter += ( a + b + c ) * area;
+				clusterNormal += normal;
+				clusterArea += area;
+			}
+			if( clusterArea > 0.0f )
+			{
+				clusterCenter /= clusterArea * 3.0f;
+			}
+			clusterNormal.Normalize();
+			clusters[i].sortKey = ( clusterCenter - center ) * clusterNormal;
+		}
+		
+		qsort( clusters, numClusters, sizeof( clusters[0] ), R_SortTriClusters );
+		
+		int* sortedOrder = ( int* )R_StaticAlloc( numTris * sizeof( sortedOrder[0] ) );
+		int numSorted = 0;
+		for( int i = 0; i < numClusters; i++ )
+		{
+			memcpy( sortedOrder + numSorted, triOrder + clusters[i].firstTri, clusters[i].numTris * sizeof( triOrder[0] ) );
+			numSorted += clusters[i].numTris;
+		}
+		memcpy( triOrder, sortedOrder, numTris * sizeof( triOrder[0] ) );
+		R_StaticFree( sortedOrder );
 	}
 	
-	return newTri;
+	R_StaticFree( clusters );
 }
 
 /*
 =================
-R_MergeTriangles
+R_OptimizeVertexFetchOrder
 
-Only deals with vertexes and indexes, not silhouettes, planes, etc.
-Does NOT perform a cleanup triangles, so there may be duplicated verts in the result.
+Renumbers the vertexes in the order of their first reference. Vertexes only
+referenced by silIndexes are kept right after the first triangle using them,
+unreferenced vertexes move to the end.
 =================
 */
-srfTriangles_t* R_MergeTriangles( const srfTriangles_t* tri1, const srfTriangles_t* tri2 )
+static void R_OptimizeVertexFetchOrder( srfTriangles_t* tri )
 {
-	const srfTriangles_t*	tris[2];
+	int* remap = ( int* )R_StaticAlloc( tri->numVerts * sizeof( remap[0] ) );
+	memset( remap, -1, tri->numVerts * sizeof( remap[0] ) );
 	
-	tris[0] = tri1;
-	tris[1] = tri2;
+	int numRemapped = 0;
+	for( int i = 0; i < tri->numIndexes; i++ )
+	{
+		if( remap[tri->indexes[i]] == -1 )
+		{
+			remap[tri->indexes[i]] = numRemapped++;
+		}
+		if( tri->silIndexes != NULL && remap[tri->silIndexes[i]] == -1 )
+		{
+			remap[tri->silIndexes[i]] = numRemapped++;
+		}
+	}
+	for( int i = 0; i < tri->numVerts; i++ )
+	{
+		if( remap[i] == -1 )
+		{
+			remap[i] = numRemapped++;
+		}
+	}
+	assert( numRemapped == tri->numVerts );
 	
-	return R_MergeSurfaceList( tris, 2 );
+	idDrawVert* oldVerts = ( idDrawVert* )R_StaticAlloc( tri->numVerts * sizeof( oldVerts[0] ) );
+	memcpy( oldVerts, tri->verts, tri->numVerts * sizeof( oldVerts[0] ) );
+	for( int i = 0; i < tri->numVerts; i++ )
+	{
+		tri->verts[remap[i]] = oldVerts[i];
+	}
+	R_StaticFree( oldVerts );
+	
+	for( int i = 0; i < tri->numIndexes; i++ )
+	{
+		tri->indexes[i] = remap[tri->indexes[i]];
+		if( tri->silIndexes != NULL )
+		{
+			tri->silIndexes[i] = remap[tri->silIndexes[i]];
+		}
+	}
+	
+	R_StaticFree( remap );
 }
 
 /*
 =================
-R_ReverseTriangles
-
-Lit two sided surfaces need to have the triangles actually duplicated,
-they can't just turn on two sided lighting, because the normal and tangents
-are wrong on the other sides.
+R_OptimizeTriangleOrder
 
-This should be called before R_CleanupTriangles
+silIndexes must have already been calculated and sil edges must not
+have been created yet.
 =================
 */
-void R_ReverseTriangles( srfTriangles_t* tri )
+void R_OptimizeTriangleOrder( srfTriangles_t* tri, bool optimizeOverdraw )
 {
-	int			i;
+	assert( tri->silEdges == NULL && tri->dupVerts == NULL && tri->mirroredVerts == NULL );
 	
-	// flip the normal on each vertex
-	// If the surface is going to have generated normals, this won't matter,
-	// but if it has explicit normals, this will keep it on the correct side
-	for( i = 0; i < tri->numVerts; i++ )
+	const int numTris = tri->numIndexes / 3;
+	if( numTris < 2 )
 	{
-		tri->verts[i].SetNormal( vec3_origin - tri->verts[i].GetNormal() );
+		return;
 	}
 	
-	// flip the index order to make them back sided
-	for( i = 0; i < tri->numIndexes; i += 3 )
+	float acmrBefore = 0.0f, atvrBefore = 0.0f;
+	if( r_showTriangleOptimization.GetBool() )
 	{
-		triIndex_t	temp;
-		
-		temp = tri->indexes[ i + 0 ];
-		tri->indexes[ i + 0 ] = tri->indexes[ i + 1 ];
-		tri->indexes[ i + 1 ] = temp;
+		R_AnalyzeVertexCache( tri->indexes, tri->numIndexes, tri->numVerts, acmrBefore, atvrBefore );
+	}
+	
+	int* triOrder = ( int* )R_StaticAlloc( numTris * sizeof( triOrder[0] ) );
+	
+	R_OptimizeVertexCacheOrder( tri->indexes, tri->numIndexes, tri->numVerts, triOrder );
+	
+	if( optimizeOverdraw )
+	{
+		R_OptimizeOverdrawOrder( tri, triOrder );
+	}
+	
+	// apply the new triangle order to both index lists
+	triIndex_t* oldIndexes = ( triIndex_t* )R_StaticAlloc( tri->numIndexes * sizeof( oldIndexes[0] ) * 2 );
+	triIndex_t* oldSilIndexes = oldIndexes + tri->numIndexes;
+	memcpy( oldIndexes, tri->indexes, tri->numIndexes * sizeof( oldIndexes[0] ) );
+	if( tri->silIndexes != NULL )
+	{
+		memcpy( oldSilIndexes, tri->silIndexes, tri->numIndexes * sizeof( oldSilIndexes[0] ) );
+	}
+	for( int i = 0; i < numTris; i++ )
+	{
+		const int src = triOrder[i] * 3;
+		for( int j = 0; j < 3; j++ )
+		{
+			tri->indexes[i * 3 + j] = oldIndexes[src + j];
+			if( tri->silIndexes != NULL )
+			{
+				tri->silIndexes[i * 3 + j] = oldSilIndexes[src + j];
+			}
+		}
+	}
+	R_StaticFree( oldIndexes );
+	R_StaticFree( triOrder );
+	
+	R_OptimizeVertexFetchOrder( tri );
+	
+	if( r_showTriangleOptimization.GetBool() )
+	{
+		float acmrAfter, atvrAfter;
+		R_AnalyzeVertexCache( tri->indexes, tri->numIndexes, tri->numVerts, acmrAfter, atvrAfter );
+		common->Printf( "%6i tris: ACMR %1.3f -> %1.3f, ATVR %1.3f -> %1.3f\n", numTris, acmrBefore, acmrAfter, atvrBefore, atvrAfter );
 	}
 }
 
@@ -1913,9 +3715,16 @@ void R_ReverseTriangles( srfTriangles_t* tri )
 R_CleanupTriangles
 
 FIXME: allow createFlat and createSmooth normals, as well as explicit
+
+optimizeOrder may reorder triangles and vertexes, it must only be set for surfaces
+that don't depend on the authored draw order. optimizeOverdraw additionally sorts
+the triangles to reduce overdraw and is only useful for opaque surfaces.
+
+Without deriveTangents the normals and tangents are left to a following
+R_DeriveTangentsForSurfaces call.
 =================
 */
-void R_CleanupTriangles( srfTriangles_t* tri, bool createNormals, bool identifySilEdges, bool useUnsmoothedTangents )
+void R_CleanupTriangles( srfTriangles_t* tri, bool createNormals, bool identifySilEdges, bool useUnsmoothedTangents, bool optimizeOrder, bool optimizeOverdraw, bool deriveTangents )
 {
 	R_RangeCheckIndexes( tri );
 	
@@ -1929,6 +3738,11 @@ void R_CleanupTriangles( srfTriangles_t* tri, bool createNormals, bool identifyS
 	
 //	R_RemoveUnusedVerts( tri );
 
+	if( optimizeOrder && r_optimizeTriangles.GetBool() )
+	{
+		R_OptimizeTriangleOrder( tri, optimizeOverdraw && r_optimizeOverdraw.GetBool() );
+	}
+
 	if( identifySilEdges )
 	{
 		R_IdentifySilEdges( tri, true );	// assume it is non-deformable, and omit coplanar edges
@@ -1944,11 +3758,21 @@ void R_CleanupTriangles( srfTriangles_t* tri, bool createNormals, bool identifyS
 	if( useUnsmoothedTangents )
 	{
 		R_BuildDominantTris( tri );
+	}
+	
+	if( !deriveTangents )
+	{
+		// the caller derives them for many surfaces at once with R_DeriveTangentsForSurfaces
+		return;
+	}
+	
+	if( useUnsmoothedTangents )
+	{
 		R_DeriveTangents( tri );
 	}
 	else if( !createNormals )
 	{
-		R_DeriveTangentsWithoutNormals( tri );
+		R_DeriveTangentsForMode( tri, TANGENTS_WITHOUT_NORMALS );
 	}
 	else
 	{
@@ -267,6 +267,7 @@ private:
 	
 	idBlockAlloc< idSWFSpriteInstance, 16 >	spriteInstanceAllocator;
 	idBlockAlloc< idSWFTextInstance, 16 >	textInstanceAllocator;
+	idBlockAlloc< idSWFShapeCache, 16 >		shapeCacheAllocator;
 	
 #define SWF_NATIVE_FUNCTION_SWF_DECLARE( x ) \
 	class idSWFScriptFunction_##x : public idSWFScriptFunction_Nested< idSWF > { \
@@ -437,7 +438,7 @@ private:
 	void			DrawStretchPic( const idVec4& topLeft, const idVec4& topRight, const idVec4& bottomRight, const idVec4& bottomLeft, const idMaterial* material );
 	void			RenderSprite( idRenderSystem* gui, idSWFSpriteInstance* sprite, const swfRenderState_t& renderState, int time, bool isSplitscreen = false );
 	void			RenderMask( idRenderSystem* gui, const swfDisplayEntry_t* mask, const swfRenderState_t& renderState, const int stencilMode );
-	void			RenderShape( idRenderSystem* gui, const idSWFShape* shape, const swfRenderState_t& renderState );
+	void			RenderShape( idRenderSystem* gui, const idSWFShape* shape, const swfRenderState_t& renderState, idSWFShapeCache* cache = NULL );
 	void			RenderMorphShape( idRenderSystem* gui, const idSWFShape* shape, const swfRenderState_t& renderState );
 	void			DrawEditCursor( idRenderSystem* gui, float x, float y, float w, float h, const swfMatrix_t& matrix );
 	void			DrawLine( idRenderSystem* gui, const idVec2& p1, const idVec2& p2, float width, const swfMatrix_t& matrix );
@@ -46,6 +46,9 @@ idCVar swf_skipBitmaps( "swf_skipBitmaps", "0", CVAR_BOOL, "" );
 idCVar swf_show( "swf_show", "0", CVAR_INTEGER, "" );
 // RB end
 
+idCVar swf_cacheShapes( "swf_cacheShapes", "1", CVAR_BOOL, "reuse the transformed vertexes of a shape until its transform or color changes" );
+idCVar swf_cacheTextLayout( "swf_cacheTextLayout", "1", CVAR_BOOL, "reuse the line breaks of a text field until its text or layout changes" );
+
 extern idCVar swf_textStrokeSize;
 extern idCVar swf_textStrokeSizeGlyphSpacer;
 extern idCVar in_useJoystick;
@@ -210,7 +213,7 @@ void idSWF::RenderMask( idRenderSystem* gui, const swfDisplayEntry_t* mask, cons
 	idSWFDictionaryEntry& entry = dictionary[ mask->characterID ];
 	if( entry.type == SWF_DICT_SHAPE )
 	{
-		RenderShape( gui, entry.shape, renderState2 );
+		RenderShape( gui, entry.shape, renderState2, mask->shapeCache );
 	}
 	else if( entry.type == SWF_DICT_MORPH )
 	{
@@ -449,7 +452,7 @@ void idSWF::RenderSprite( idRenderSystem* gui, idSWFSpriteInstance* spriteInstan
 		}
 		else if( entry->type == SWF_DICT_SHAPE )
 		{
-			RenderShape( gui, entry->shape, renderState2 );
+			RenderShape( gui, entry->shape, renderState2, display.shapeCache );
 		}
 		else if( entry->type == SWF_DICT_MORPH )
 		{
@@ -657,9 +660,12 @@ void idSWF::RenderMorphShape( idRenderSystem* gui, const idSWFShape* shape, cons
 /*
 ========================
 idSWF::RenderShape
+
+The transformed vertexes are kept in the display entry's cache, most shapes in a menu
+don't move or fade from one frame to the next and can just be copied out again.
 ========================
 */
-void idSWF::RenderShape( idRenderSystem* gui, const idSWFShape* shape, const swfRenderState_t& renderState )
+void idSWF::RenderShape( idRenderSystem* gui, const idSWFShape* shape, const swfRenderState_t& renderState, idSWFShapeCache* cache )
 {
 	if( shape == NULL )
 	{
@@ -667,6 +673,37 @@ void idSWF::RenderShape( idRenderSystem* gui, const idSWFShape* shape, const swf
 		return;
 	}
 	
+	// the debugging cvars change what gets drawn, so don't bother caching with them
+	if( !swf_cacheShapes.GetBool() || swf_forceAlpha.GetFloat() > 0.0f || swf_skipSolids.GetBool() || swf_skipGradients.GetBool()
+			|| swf_skipLineDraws.GetBool() || swf_skipBitmaps.GetBool() )
+	{
+		cache = NULL;
+	}
+	
+	const uint64 glState = GLStateForRenderState( renderState );
+	
+	if( cache != NULL )
+	{
+		if( cache->IsCurrent( shape, renderState, glState, scaleToVirtual ) )
+		{
+			for( int i = 0; i < cache->draws.Num(); i++ )
+			{
+				const swfShapeCacheDraw_t& draw = cache->draws[i];
+				
+				gui->SetGLState( draw.glState );
+				
+				idDrawVert* verts = gui->AllocTris( draw.numVerts, draw.indices->Ptr(), draw.indices->Num(), draw.material, renderState.stereoDepth );
+				if( verts == NULL )
+				{
+					continue;
+				}
+				memcpy( verts, cache->verts.Ptr() + draw.firstVert, draw.numVerts * sizeof( idDrawVert ) );
+			}
+			return;
+		}
+		cache->Begin( shape, renderState, glState, scaleToVirtual );
+	}
+	
 	for( int i = 0; i < shape->fillDraws.Num(); i++ )
 	{
 		const idSWFShapeDrawFill& fill = shape->fillDraws[i];
@@ -759,11 +796,17 @@ void idSWF::RenderShape( idRenderSystem* gui, const idSWFShape* shape, const swf
 		}
 		idVec2 oneOverSize( 1.0f / size.x, 1.0f / size.y );
 		
-		gui->SetGLState( GLStateForRenderState( renderState ) );
+		gui->SetGLState( glState );
 		
 		idDrawVert* verts = gui->AllocTris( fill.startVerts.Num(), fill.indices.Ptr(), fill.indices.Num(), material, renderState.stereoDepth );
 		if( verts == NULL )
 		{
+			if( cache != NULL )
+			{
+				// try again next frame instead of caching a partial shape
+				cache->Invalidate();
+				cache = NULL;
+			}
 			continue;
 		}
 		
@@ -811,6 +854,11 @@ void idSWF::RenderShape( idRenderSystem* gui, const idSWFShape* shape, const swf
 		}
 		// write any remaining verts to video memory
 		WriteDrawVerts16( & verts[fill.startVerts.Num() & ~3], tempVerts, fill.startVerts.Num() & 3 );
+		
+		if( cache != NULL )
+		{
+			cache->AddDraw( verts, fill.startVerts.Num(), fill.indices, material, glState );
+		}
 	}
 	
 	// RB begin
@@ -834,11 +882,16 @@ void idSWF::RenderShape( idRenderSystem* gui, const idSWFShape* shape, const swf
 			uint32 packedColorM = LittleLong( PackColor( color.mul ) );
 			uint32 packedColorA = LittleLong( PackColor( ( color.add * 0.5f ) + idVec4( 0.5f ) ) ); // Compress from -1..1 to 0..1
 			
-			gui->SetGLState( GLStateForRenderState( renderState ) | GLS_POLYMODE_LINE );
+			gui->SetGLState( glState | GLS_POLYMODE_LINE );
 			
 			idDrawVert* verts = gui->AllocTris( line.startVerts.Num(), line.indices.Ptr(), line.indices.Num(), white, renderState.stereoDepth );
 			if( verts == NULL )
 			{
+				if( cache != NULL )
+				{
+					cache->Invalidate();
+					cache = NULL;
+				}
 				continue;
 			}
 			
@@ -857,6 +910,11 @@ void idSWF::RenderShape( idRenderSystem* gui, const idSWFShape* shape, const swf
 				
 				WriteDrawVerts16( & verts[j], & tempVert, 1 );
 			}
+			
+			if( cache != NULL )
+			{
+				cache->AddDraw( verts, line.startVerts.Num(), line.indices, white, glState | GLS_POLYMODE_LINE );
+			}
 		}
 	}
 	// RB end
@@ -1087,8 +1145,26 @@ void idSWF::RenderEditText( idRenderSystem* gui, idSWFTextInstance* textInstance
 	
 	textInstance->maxLines = maxLines;
 	
-	idList< idStr > textLines;
-	idStr* currentLine = &textLines.Alloc();
+	// input fields, subtitles and tooltips change how the lines break from frame to frame,
+	// everything else only has to be broken into lines again when the text or layout changes
+	const bool useLayoutCache = swf_cacheTextLayout.GetBool() && !inputField && !textInstance->IsSubtitle() && tooltipIconList.Num() == 0;
+	const float glyphSpacer = textInstance->HasStroke() ? ( swf_textStrokeSizeGlyphSpacer.GetFloat() * textInstance->GetStrokeWeight() * glyphScale ) : 0.0f;
+	const uint32 layoutFlags = shape->flags & ( SWF_ET_MULTILINE | SWF_ET_WORDWRAP );
+	swfTextLayout_t& layout = textInstance->layout;
+	
+	bool layoutCached = false;
+	if( useLayoutCache )
+	{
+		layoutCached = layout.IsCurrent( text, fontInfo, glyphScale, glyphSpacer, bounds.tl.x, bounds.br.x, layoutFlags, maxLines );
+		if( !layoutCached )
+		{
+			layout.lines.Clear();
+		}
+	}
+	
+	idList< idStr > localTextLines;
+	idList< idStr >& textLines = useLayoutCache ? layout.lines : localTextLines;
+	idStr* currentLine = layoutCached ? NULL : &textLines.Alloc();
 	
 	// tracks the last breakable character we found
 	int lastbreak = 0;
@@ -1104,7 +1180,7 @@ void idSWF::RenderEditText( idRenderSystem* gui, idSWFTextInstance* textInstance
 		charIndex = textInstance->GetSubStartIndex();
 	}
 	
-	while( charIndex < text.Length() )
+	while( !layoutCached && charIndex < text.Length() )
 	{
 		if( text[ charIndex ] == '\n' )
 		{
@@ -1209,6 +1285,23 @@ void idSWF::RenderEditText( idRenderSystem* gui, idSWFTextInstance* textInstance
 		}
 	}
 	
+	if( useLayoutCache && !layoutCached )
+	{
+		layout.text = text;
+		layout.font = fontInfo;
+		layout.glyphScale = glyphScale;
+		layout.glyphSpacer = glyphSpacer;
+		layout.left = bounds.tl.x;
+		layout.right = bounds.br.x;
+		layout.flags = layoutFlags;
+		layout.maxLines = maxLines;
+		layout.lineWidths.SetNum( textLines.Num() );
+		for( int i = 0; i < textLines.Num(); i++ )
+		{
+			layout.lineWidths[i] = -1.0f;
+		}
+	}
+	
 	// Subtitle functionality
 	if( textInstance->IsSubtitle() && textInstance->IsUpdatingSubtitle() )
 	{
@@ -1443,6 +1536,7 @@ void idSWF::RenderEditText( idRenderSystem* gui, idSWFTextInstance* textInstance
 		
 		startCharacter = endCharacter;
 		
+		const int lineNum = textLine;
 		idStr& text = textLines[textLine];
 		int lastChar = text.Length();
 		if( textInstance->IsSubtitle() )
@@ -1482,6 +1576,11 @@ void idSWF::RenderEditText( idRenderSystem* gui, idSWFTextInstance* textInstance
 		float width = 0.0f;
 		insertingImage = false;
 		int i = 0;
+		if( useLayoutCache && layout.lineWidths[lineNum] >= 0.0f )
+		{
+			width = layout.lineWidths[lineNum];
+			i = lastChar;
+		}
 		while( i < lastChar )
 		{
 			if( curIcon < tooltipIconList.Num() && tooltipIconList[curIcon].startIndex == startCharacter + i )
@@ -1508,6 +1607,10 @@ void idSWF::RenderEditText( idRenderSystem* gui, idSWFTextInstance* textInstance
 				}
 			}
 		}
+		if( useLayoutCache )
+		{
+			layout.lineWidths[lineNum] = width;
+		}
 		
 		y = bounds.tl.y + ( index * linespacing );
 		
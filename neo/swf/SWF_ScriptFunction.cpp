@@ -31,6 +31,17 @@ If you have questions concerning this license or the applicable additional terms
 
 idCVar swf_debug( "swf_debug", "0", CVAR_INTEGER | CVAR_ARCHIVE, "debug swf scripts.  1 shows traces/errors.  2 also shows warnings.  3 also shows disassembly.  4 shows parameters in the disassembly." );
 idCVar swf_debugInvoke( "swf_debugInvoke", "0", CVAR_INTEGER, "debug swf functions being called from game." );
+idCVar swf_recordInvokes( "swf_recordInvokes", "0", CVAR_BOOL, "record swf functions called from game so swf_benchmarkScripts can replay them" );
+
+// functions called from game with plain parameters, replayed by swf_benchmarkScripts
+struct swfRecordedInvoke_t
+{
+	idStr			filename;
+	idStr			functionName;
+	idList< idSWFScriptVar, TAG_SWF > parms;
+};
+static idList< swfRecordedInvoke_t, TAG_SWF > swfRecordedInvokes;
+static const int MAX_RECORDED_INVOKES = 4096;
 
 idSWFConstantPool::idSWFConstantPool()
 {
@@ -85,6 +96,20 @@ idSWFScriptFunction_Script::~idSWFScriptFunction_Script()
 	{
 		prototype->Release();
 	}
+	programs.DeleteContents( true );
+}
+
+/*
+========================
+idSWFScriptFunction_Script::actionProgram_t::~actionProgram_t
+========================
+*/
+idSWFScriptFunction_Script::actionProgram_t::~actionProgram_t()
+{
+	for( int i = 0; i < constantStrings.Num(); i++ )
+	{
+		constantStrings[i]->Release();
+	}
 }
 
 /*
@@ -120,7 +145,7 @@ idSWFScriptFunction_Script::Call
 */
 idSWFScriptVar idSWFScriptFunction_Script::Call( idSWFScriptObject* thisObject, const idSWFParmList& parms )
 {
-	idSWFBitStream bitstream( data, length, false );
+	actionProgram_t* program = GetProgram();
 	
 	// We assume scope[0] is the global scope
 	assert( scope.Num() > 0 );
@@ -248,7 +273,7 @@ idSWFScriptVar idSWFScriptFunction_Script::Call( idSWFScriptObject* thisObject,
 	scope.Append( locals );
 	locals->AddRef();
 	
-	idSWFScriptVar retVal = Run( thisObject, stack, bitstream );
+	idSWFScriptVar retVal = Run( thisObject, stack, *program, 0, program->instructions.Num() );
 	
 	assert( scope.Num() == scopeSize + 1 );
 	for( int i = scopeSize; i < scope.Num(); i++ )
@@ -699,12 +724,260 @@ const char* GetSwfActionName( swfAction_t code )
 }
 }
 
+/*
+========================
+idSWFScriptFunction_Script::GetProgram
+========================
+*/
+idSWFScriptFunction_Script::actionProgram_t* idSWFScriptFunction_Script::GetProgram()
+{
+	const int key = programHash.GenerateKey( ( int )( uintptr_t )data, ( int )length );
+	for( int i = programHash.First( key ); i != -1; i = programHash.Next( i ) )
+	{
+		if( programs[i]->data == data && programs[i]->length == length )
+		{
+			return programs[i];
+		}
+	}
+	
+	actionProgram_t* program = new( TAG_SWF ) actionProgram_t;
+	program->data = data;
+	program->length = length;
+	DecodeProgram( *program );
+	programHash.Add( key, programs.Append( program ) );
+	return program;
+}
+
+/*
+========================
+idSWFScriptFunction_Script::DecodeProgram
+========================
+*/
+void idSWFScriptFunction_Script::DecodeProgram( actionProgram_t& program ) const
+{
+	idSWFBitStream bitstream( program.data, program.length, false );
+	
+	// instruction index for every byte offset that starts an action, -1 for everything else
+	idList< int, TAG_SWF > instructionAt;
+	instructionAt.SetNum( program.length + 1 );
+	for( int i = 0; i < instructionAt.Num(); i++ )
+	{
+		instructionAt[i] = -1;
+	}
+	
+	// byte offsets that jumps and with blocks want to go to, resolved once everything is decoded
+	idList< int, TAG_SWF > jumpOffsets;
+	
+	while( bitstream.Tell() < bitstream.Length() )
+	{
+		instructionAt[ bitstream.Tell() ] = program.instructions.Num();
+		
+		actionInstruction_t& instruction = program.instructions.Alloc();
+		instruction.code = ( swfAction_t )bitstream.ReadU8();
+		instruction.operand = 0;
+		instruction.count = 0;
+		instruction.slot = -1;
+		instruction.data = NULL;
+		instruction.length = 0;
+		jumpOffsets.Append( 0 );
+		
+		uint16 recordLength = 0;
+		if( instruction.code >= 0x80 )
+		{
+			if( bitstream.Tell() + 2 > bitstream.Length() )
+			{
+				instruction.code = Action_End;
+				break;
+			}
+			recordLength = bitstream.ReadU16();
+		}
+		if( bitstream.Tell() + recordLength > bitstream.Length() )
+		{
+			idLib::PrintfIf( swf_debug.GetInteger() > 0, "SWF: action %s runs past the end of the script\n", GetSwfActionName( instruction.code ) );
+			instruction.code = Action_End;
+			break;
+		}
+		instruction.data = bitstream.ReadData( recordLength );
+		instruction.length = recordLength;
+		
+		idSWFBitStream record( instruction.data, recordLength, false );
+		switch( instruction.code )
+		{
+			case Action_GotoFrame:
+				instruction.operand = record.ReadU16() + 1;
+				break;
+			case Action_StoreRegister:
+				instruction.operand = record.ReadU8();
+				break;
+			case Action_GotoFrame2:
+			{
+				uint8 flags = record.ReadU8();
+				instruction.operand = flags;
+				if( flags & 2 )
+				{
+					instruction.count = record.ReadU16();
+				}
+				break;
+			}
+			case Action_Jump:
+			case Action_If:
+			{
+				int16 offset = record.ReadS16();
+				jumpOffsets[ program.instructions.Num() - 1 ] = bitstream.Tell() + offset;
+				break;
+			}
+			case Action_With:
+			{
+				// the body follows the record and is decoded in line, the operand is where it ends
+				uint16 withSize = record.ReadU16();
+				jumpOffsets[ program.instructions.Num() - 1 ] = bitstream.Tell() + withSize;
+				break;
+			}
+			case Action_DefineFunction:
+			case Action_DefineFunction2:
+			{
+				// the record ends with the size of the function body, which directly follows it
+				uint16 codeSize = 0;
+				if( recordLength >= 2 )
+				{
+					codeSize = instruction.data[ recordLength - 2 ] | ( instruction.data[ recordLength - 1 ] << 8 );
+				}
+				if( bitstream.Tell() + codeSize > bitstream.Length() )
+				{
+					idLib::PrintfIf( swf_debug.GetInteger() > 0, "SWF: function body runs past the end of the script\n" );
+					instruction.code = Action_End;
+					break;
+				}
+				bitstream.ReadData( codeSize );
+				break;
+			}
+			case Action_ConstantPool:
+			{
+				uint16 numConstants = record.ReadU16();
+				instruction.operand = program.constantStrings.Num();
+				instruction.count = numConstants;
+				for( int i = 0; i < numConstants; i++ )
+				{
+					program.constantStrings.Append( idSWFScriptString::Alloc( record.ReadString() ) );
+				}
+				break;
+			}
+			case Action_Push:
+			{
+				instruction.operand = program.pushValues.Num();
+				while( record.Tell() < record.Length() )
+				{
+					actionPushValue_t& push = program.pushValues.Alloc();
+					push.type = record.ReadU8();
+					push.index = 0;
+					switch( push.type )
+					{
+						case 0:
+							push.value.SetString( record.ReadString() );
+							break;
+						case 1:
+							push.value.SetFloat( record.ReadFloat() );
+							break;
+						case 2:
+							push.value.SetNULL();
+							break;
+						case 3:
+							push.value.SetUndefined();
+							break;
+						case 4:
+							push.index = record.ReadU8();
+							break;
+						case 5:
+							push.value.SetBool( record.ReadU8() != 0 );
+							break;
+						case 6:
+							push.value.SetFloat( ( float )record.ReadDouble() );
+							break;
+						case 7:
+							push.value.SetInteger( record.ReadS32() );
+							break;
+						case 8:
+							push.index = record.ReadU8();
+							break;
+						case 9:
+							push.index = record.ReadU16();
+							break;
+						default:
+							// the original interpreter skipped unknown types without pushing anything
+							program.pushValues.SetNum( program.pushValues.Num() - 1 );
+							break;
+					}
+				}
+				instruction.count = program.pushValues.Num() - instruction.operand;
+				break;
+			}
+			default:
+				break;
+		}
+		
+		if( instruction.code == Action_End )
+		{
+			break;
+		}
+	}
+	instructionAt[ bitstream.Tell() ] = program.instructions.Num();
+	
+	// jumps that don't land on an action end the script, the same as running off the end of the data
+	for( int i = 0; i < program.instructions.Num(); i++ )
+	{
+		swfAction_t code = program.instructions[i].code;
+		if( code != Action_Jump && code != Action_If && code != Action_With )
+		{
+			continue;
+		}
+		int target = -1;
+		if( jumpOffsets[i] >= 0 && jumpOffsets[i] <= ( int )program.length )
+		{
+			target = instructionAt[ jumpOffsets[i] ];
+		}
+		if( target < 0 )
+		{
+			idLib::PrintfIf( swf_debug.GetInteger() > 1, "SWF: %s to an invalid offset %d\n", GetSwfActionName( program.instructions[i].code ), jumpOffsets[i] );
+			target = program.instructions.Num();
+		}
+		program.instructions[i].operand = target;
+	}
+}
+
+/*
+========================
+The switch in Run is the only dispatch with MSVC. GCC and clang also get a table of label
+addresses, so every handler jumps straight to the handler of the next instruction and each
+one gets its own indirect branch to predict. Tracing and the end of the block go back
+through the loop.
+========================
+*/
+#if defined( __GNUC__ )
+#define SWF_THREADED_DISPATCH
+#define SWF_ACTION( action )	case action: Do_##action:
+#define SWF_DEFAULT_ACTION		default: Do_Unhandled:
+#define SWF_NEXT_ACTION											\
+	{															\
+		if( pc >= end || traceActions )							\
+		{														\
+			break;												\
+		}														\
+		instruction = &program.instructions[ pc++ ];			\
+		code = instruction->code;								\
+		goto *dispatchTable[ code ];							\
+	}
+#else
+#define SWF_ACTION( action )	case action:
+#define SWF_DEFAULT_ACTION		default:
+#define SWF_NEXT_ACTION			break
+#endif
+
 /*
 ========================
 idSWFScriptFunction_Script::Run
 ========================
 */
-idSWFScriptVar idSWFScriptFunction_Script::Run( idSWFScriptObject* thisObject, idSWFStack& stack, idSWFBitStream& bitstream )
+idSWFScriptVar idSWFScriptFunction_Script::Run( idSWFScriptObject* thisObject, idSWFStack& stack, actionProgram_t& program, int start, int end )
 {
 	static int callstackLevel = -1;
 	idSWFSpriteInstance* thisSprite = thisObject->GetSprite();
@@ -717,16 +990,107 @@ idSWFScriptVar idSWFScriptFunction_Script::Run( idSWFScriptObject* thisObject, i
 	
 	callstackLevel++;
 	
-	while( bitstream.Tell() < bitstream.Length() )
+#if defined( SWF_THREADED_DISPATCH )
+	static void* dispatchTable[ 256 ];
+	if( dispatchTable[ Action_End ] == NULL )
 	{
-		swfAction_t code = ( swfAction_t )bitstream.ReadU8();
-		uint16 recordLength = 0;
-		if( code >= 0x80 )
+		for( int i = 0; i < 256; i++ )
 		{
-			recordLength = bitstream.ReadU16();
+			dispatchTable[i] = &&Do_Unhandled;
 		}
+		dispatchTable[ Action_Return ] = &&Do_Action_Return;
+		dispatchTable[ Action_End ] = &&Do_Action_End;
+		dispatchTable[ Action_NextFrame ] = &&Do_Action_NextFrame;
+		dispatchTable[ Action_PrevFrame ] = &&Do_Action_PrevFrame;
+		dispatchTable[ Action_Play ] = &&Do_Action_Play;
+		dispatchTable[ Action_Stop ] = &&Do_Action_Stop;
+		dispatchTable[ Action_ToggleQuality ] = &&Do_Action_ToggleQuality;
+		dispatchTable[ Action_StopSounds ] = &&Do_Action_StopSounds;
+		dispatchTable[ Action_GotoFrame ] = &&Do_Action_GotoFrame;
+		dispatchTable[ Action_SetTarget ] = &&Do_Action_SetTarget;
+		dispatchTable[ Action_GoToLabel ] = &&Do_Action_GoToLabel;
+		dispatchTable[ Action_Push ] = &&Do_Action_Push;
+		dispatchTable[ Action_Pop ] = &&Do_Action_Pop;
+		dispatchTable[ Action_Add ] = &&Do_Action_Add;
+		dispatchTable[ Action_Subtract ] = &&Do_Action_Subtract;
+		dispatchTable[ Action_Multiply ] = &&Do_Action_Multiply;
+		dispatchTable[ Action_Divide ] = &&Do_Action_Divide;
+		dispatchTable[ Action_Equals ] = &&Do_Action_Equals;
+		dispatchTable[ Action_Less ] = &&Do_Action_Less;
+		dispatchTable[ Action_And ] = &&Do_Action_And;
+		dispatchTable[ Action_Or ] = &&Do_Action_Or;
+		dispatchTable[ Action_Not ] = &&Do_Action_Not;
+		dispatchTable[ Action_StringEquals ] = &&Do_Action_StringEquals;
+		dispatchTable[ Action_StringLength ] = &&Do_Action_StringLength;
+		dispatchTable[ Action_StringAdd ] = &&Do_Action_StringAdd;
+		dispatchTable[ Action_StringExtract ] = &&Do_Action_StringExtract;
+		dispatchTable[ Action_StringLess ] = &&Do_Action_StringLess;
+		dispatchTable[ Action_StringGreater ] = &&Do_Action_StringGreater;
+		dispatchTable[ Action_ToInteger ] = &&Do_Action_ToInteger;
+		dispatchTable[ Action_CharToAscii ] = &&Do_Action_CharToAscii;
+		dispatchTable[ Action_AsciiToChar ] = &&Do_Action_AsciiToChar;
+		dispatchTable[ Action_Jump ] = &&Do_Action_Jump;
+		dispatchTable[ Action_If ] = &&Do_Action_If;
+		dispatchTable[ Action_GetVariable ] = &&Do_Action_GetVariable;
+		dispatchTable[ Action_SetVariable ] = &&Do_Action_SetVariable;
+		dispatchTable[ Action_GotoFrame2 ] = &&Do_Action_GotoFrame2;
+		dispatchTable[ Action_GetProperty ] = &&Do_Action_GetProperty;
+		dispatchTable[ Action_SetProperty ] = &&Do_Action_SetProperty;
+		dispatchTable[ Action_Trace ] = &&Do_Action_Trace;
+		dispatchTable[ Action_GetTime ] = &&Do_Action_GetTime;
+		dispatchTable[ Action_RandomNumber ] = &&Do_Action_RandomNumber;
+		dispatchTable[ Action_CallFunction ] = &&Do_Action_CallFunction;
+		dispatchTable[ Action_CallMethod ] = &&Do_Action_CallMethod;
+		dispatchTable[ Action_ConstantPool ] = &&Do_Action_ConstantPool;
+		dispatchTable[ Action_DefineFunction ] = &&Do_Action_DefineFunction;
+		dispatchTable[ Action_DefineFunction2 ] = &&Do_Action_DefineFunction2;
+		dispatchTable[ Action_Enumerate ] = &&Do_Action_Enumerate;
+		dispatchTable[ Action_Enumerate2 ] = &&Do_Action_Enumerate2;
+		dispatchTable[ Action_Equals2 ] = &&Do_Action_Equals2;
+		dispatchTable[ Action_StrictEquals ] = &&Do_Action_StrictEquals;
+		dispatchTable[ Action_GetMember ] = &&Do_Action_GetMember;
+		dispatchTable[ Action_SetMember ] = &&Do_Action_SetMember;
+		dispatchTable[ Action_InitArray ] = &&Do_Action_InitArray;
+		dispatchTable[ Action_InitObject ] = &&Do_Action_InitObject;
+		dispatchTable[ Action_NewObject ] = &&Do_Action_NewObject;
+		dispatchTable[ Action_Extends ] = &&Do_Action_Extends;
+		dispatchTable[ Action_TargetPath ] = &&Do_Action_TargetPath;
+		dispatchTable[ Action_With ] = &&Do_Action_With;
+		dispatchTable[ Action_ToNumber ] = &&Do_Action_ToNumber;
+		dispatchTable[ Action_ToString ] = &&Do_Action_ToString;
+		dispatchTable[ Action_TypeOf ] = &&Do_Action_TypeOf;
+		dispatchTable[ Action_Add2 ] = &&Do_Action_Add2;
+		dispatchTable[ Action_Less2 ] = &&Do_Action_Less2;
+		dispatchTable[ Action_Greater ] = &&Do_Action_Greater;
+		dispatchTable[ Action_Modulo ] = &&Do_Action_Modulo;
+		dispatchTable[ Action_BitAnd ] = &&Do_Action_BitAnd;
+		dispatchTable[ Action_BitLShift ] = &&Do_Action_BitLShift;
+		dispatchTable[ Action_BitOr ] = &&Do_Action_BitOr;
+		dispatchTable[ Action_BitRShift ] = &&Do_Action_BitRShift;
+		dispatchTable[ Action_BitURShift ] = &&Do_Action_BitURShift;
+		dispatchTable[ Action_BitXor ] = &&Do_Action_BitXor;
+		dispatchTable[ Action_Decrement ] = &&Do_Action_Decrement;
+		dispatchTable[ Action_Increment ] = &&Do_Action_Increment;
+		dispatchTable[ Action_PushDuplicate ] = &&Do_Action_PushDuplicate;
+		dispatchTable[ Action_StackSwap ] = &&Do_Action_StackSwap;
+		dispatchTable[ Action_StoreRegister ] = &&Do_Action_StoreRegister;
+		dispatchTable[ Action_DefineLocal ] = &&Do_Action_DefineLocal;
+		dispatchTable[ Action_DefineLocal2 ] = &&Do_Action_DefineLocal2;
+		dispatchTable[ Action_Delete ] = &&Do_Action_Delete;
+		dispatchTable[ Action_Delete2 ] = &&Do_Action_Delete2;
+	}
+#endif
+	const bool traceActions = swf_debug.GetInteger() >= 3;
+	
+	actionInstruction_t* instruction = NULL;
+	swfAction_t code = Action_End;
+	int pc = start;
+	while( pc < end )
+	{
+		instruction = &program.instructions[ pc++ ];
+		code = instruction->code;
 		
-		if( swf_debug.GetInteger() >= 3 )
+		if( traceActions )
 		{
 			// stack[0] is always 0 so don't read it
 			if( swf_debug.GetInteger() >= 4 )
@@ -750,13 +1114,13 @@ idSWFScriptVar idSWFScriptFunction_Script::Run( idSWFScriptObject* thisObject, i
 		
 		switch( code )
 		{
-			case Action_Return:
+			SWF_ACTION( Action_Return )
 				callstackLevel--;
 				return stack.A();
-			case Action_End:
+			SWF_ACTION( Action_End )
 				callstackLevel--;
 				return idSWFScriptVar();
-			case Action_NextFrame:
+			SWF_ACTION( Action_NextFrame )
 				if( verify( currentTarget != NULL ) )
 				{
 					currentTarget->NextFrame();
@@ -765,8 +1129,8 @@ idSWFScriptVar idSWFScriptFunction_Script::Run( idSWFScriptObject* thisObject, i
 				{
 					idLib::Printf( "SWF: no target movie clip for nextFrame\n" );
 				}
-				break;
-			case Action_PrevFrame:
+				SWF_NEXT_ACTION;
+			SWF_ACTION( Action_PrevFrame )
 				if( verify( currentTarget != NULL ) )
 				{
 					currentTarget->PrevFrame();
@@ -775,8 +1139,8 @@ idSWFScriptVar idSWFScriptFunction_Script::Run( idSWFScriptObject* thisObject, i
 				{
 					idLib::Printf( "SWF: no target movie clip for prevFrame\n" );
 				}
-				break;
-			case Action_Play:
+				SWF_NEXT_ACTION;
+			SWF_ACTION( Action_Play )
 				if( verify( currentTarget != NULL ) )
 				{
 					currentTarget->Play();
@@ -785,8 +1149,8 @@ idSWFScriptVar idSWFScriptFunction_Script::Run( idSWFScriptObject* thisObject, i
 				{
 					idLib::Printf( "SWF: no target movie clip for play\n" );
 				}
-				break;
-			case Action_Stop:
+				SWF_NEXT_ACTION;
+			SWF_ACTION( Action_Stop )
 				if( verify( currentTarget != NULL ) )
 				{
 					currentTarget->Stop();
@@ -795,15 +1159,14 @@ idSWFScriptVar idSWFScriptFunction_Script::Run( idSWFScriptObject* thisObject, i
 				{
 					idLib::Printf( "SWF: no target movie clip for stop\n" );
 				}
-				break;
-			case Action_ToggleQuality:
-				break;
-			case Action_StopSounds:
-				break;
-			case Action_GotoFrame:
+				SWF_NEXT_ACTION;
+			SWF_ACTION( Action_ToggleQuality )
+				SWF_NEXT_ACTION;
+			SWF_ACTION( Action_StopSounds )
+				SWF_NEXT_ACTION;
+			SWF_ACTION( Action_GotoFrame )
 			{
-				assert( recordLength == 2 );
-				int frameNum = bitstream.ReadU16() + 1;
+				int frameNum = instruction->operand;
 				if( verify( currentTarget != NULL ) )
 				{
 					currentTarget->RunTo( frameNum );
@@ -812,11 +1175,11 @@ idSWFScriptVar idSWFScriptFunction_Script::Run( idSWFScriptObject* thisObject, i
 				{
 					idLib::Printf( "SWF: no target movie clip for runTo %d\n", frameNum );
 				}
-				break;
+				SWF_NEXT_ACTION;
 			}
-			case Action_SetTarget:
+			SWF_ACTION( Action_SetTarget )
 			{
-				const char* targetName = ( const char* )bitstream.ReadData( recordLength );
+				const char* targetName = ( const char* )instruction->data;
 				if( verify( thisSprite != NULL ) )
 				{
 					currentTarget = thisSprite->ResolveTarget( targetName );
@@ -825,11 +1188,11 @@ idSWFScriptVar idSWFScriptFunction_Script::Run( idSWFScriptObject* thisObject, i
 				{
 					idLib::Printf( "SWF: no target movie clip for setTarget %s\n", targetName );
 				}
-				break;
+				SWF_NEXT_ACTION;
 			}
-			case Action_GoToLabel:
+			SWF_ACTION( Action_GoToLabel )
 			{
-				const char* targetName = ( const char* )bitstream.ReadData( recordLength );
+				const char* targetName = ( const char* )instruction->data;
 				if( verify( currentTarget != NULL ) )
 				{
 					currentTarget->RunTo( currentTarget->FindFrame( targetName ) );
@@ -838,139 +1201,117 @@ idSWFScriptVar idSWFScriptFunction_Script::Run( idSWFScriptObject* thisObject, i
 				{
 					idLib::Printf( "SWF: no target movie clip for runTo %s\n", targetName );
 				}
-				break;
+				SWF_NEXT_ACTION;
 			}
-			case Action_Push:
+			SWF_ACTION( Action_Push )
 			{
-				idSWFBitStream pushstream( bitstream.ReadData( recordLength ), recordLength, false );
-				while( pushstream.Tell() < pushstream.Length() )
+				for( int i = 0; i < instruction->count; i++ )
 				{
-					uint8 type = pushstream.ReadU8();
-					switch( type )
+					const actionPushValue_t& push = program.pushValues[ instruction->operand + i ];
+					switch( push.type )
 					{
-						case 0:
-							stack.Alloc().SetString( pushstream.ReadString() );
-							break;
-						case 1:
-							stack.Alloc().SetFloat( pushstream.ReadFloat() );
-							break;
-						case 2:
-							stack.Alloc().SetNULL();
-							break;
-						case 3:
-							stack.Alloc().SetUndefined();
-							break;
 						case 4:
-							stack.Alloc() = registers[ pushstream.ReadU8() ];
-							break;
-						case 5:
-							stack.Alloc().SetBool( pushstream.ReadU8() != 0 );
-							break;
-						case 6:
-							stack.Alloc().SetFloat( ( float )pushstream.ReadDouble() );
-							break;
-						case 7:
-							stack.Alloc().SetInteger( pushstream.ReadS32() );
+							stack.Alloc() = registers[ push.index ];
 							break;
 						case 8:
-							stack.Alloc().SetString( constants.Get( pushstream.ReadU8() ) );
-							break;
 						case 9:
-							stack.Alloc().SetString( constants.Get( pushstream.ReadU16() ) );
+							stack.Alloc().SetString( constants.Get( push.index ) );
+							break;
+						default:
+							stack.Alloc() = push.value;
 							break;
 					}
 				}
-				break;
+				SWF_NEXT_ACTION;
 			}
-			case Action_Pop:
+			SWF_ACTION( Action_Pop )
 				stack.Pop( 1 );
-				break;
-			case Action_Add:
+				SWF_NEXT_ACTION;
+			SWF_ACTION( Action_Add )
 				stack.B().SetFloat( stack.B().ToFloat() + stack.A().ToFloat() );
 				stack.Pop( 1 );
-				break;
-			case Action_Subtract:
+				SWF_NEXT_ACTION;
+			SWF_ACTION( Action_Subtract )
 				stack.B().SetFloat( stack.B().ToFloat() - stack.A().ToFloat() );
 				stack.Pop( 1 );
-				break;
-			case Action_Multiply:
+				SWF_NEXT_ACTION;
+			SWF_ACTION( Action_Multiply )
 				stack.B().SetFloat( stack.B().ToFloat() * stack.A().ToFloat() );
 				stack.Pop( 1 );
-				break;
-			case Action_Divide:
+				SWF_NEXT_ACTION;
+			SWF_ACTION( Action_Divide )
 				stack.B().SetFloat( stack.B().ToFloat() / stack.A().ToFloat() );
 				stack.Pop( 1 );
-				break;
-			case Action_Equals:
+				SWF_NEXT_ACTION;
+			SWF_ACTION( Action_Equals )
 				stack.B().SetBool( stack.B().ToFloat() == stack.A().ToFloat() );
 				stack.Pop( 1 );
-				break;
-			case Action_Less:
+				SWF_NEXT_ACTION;
+			SWF_ACTION( Action_Less )
 				stack.B().SetBool( stack.B().ToFloat() < stack.A().ToFloat() );
 				stack.Pop( 1 );
-				break;
-			case Action_And:
+				SWF_NEXT_ACTION;
+			SWF_ACTION( Action_And )
 				stack.B().SetBool( stack.B().ToBool() && stack.A().ToBool() );
 				stack.Pop( 1 );
-				break;
-			case Action_Or:
+				SWF_NEXT_ACTION;
+			SWF_ACTION( Action_Or )
 				stack.B().SetBool( stack.B().ToBool() || stack.A().ToBool() );
 				stack.Pop( 1 );
-				break;
-			case Action_Not:
+				SWF_NEXT_ACTION;
+			SWF_ACTION( Action_Not )
 				stack.A().SetBool( !stack.A().ToBool() );
-				break;
-			case Action_StringEquals:
+				SWF_NEXT_ACTION;
+			SWF_ACTION( Action_StringEquals )
 				stack.B().SetBool( stack.B().ToString() == stack.A().ToString() );
 				stack.Pop( 1 );
-				break;
-			case Action_StringLength:
+				SWF_NEXT_ACTION;
+			SWF_ACTION( Action_StringLength )
 				stack.A().SetInteger( stack.A().ToString().Length() );
-				break;
-			case Action_StringAdd:
+				SWF_NEXT_ACTION;
+			SWF_ACTION( Action_StringAdd )
 				stack.B().SetString( stack.B().ToString() + stack.A().ToString() );
 				stack.Pop( 1 );
-				break;
-			case Action_StringExtract:
+				SWF_NEXT_ACTION;
+			SWF_ACTION( Action_StringExtract )
 				stack.C().SetString( stack.C().ToString().Mid( stack.B().ToInteger(), stack.A().ToInteger() ) );
 				stack.Pop( 2 );
-				break;
-			case Action_StringLess:
+				SWF_NEXT_ACTION;
+			SWF_ACTION( Action_StringLess )
 				stack.B().SetBool( stack.B().ToString() < stack.A().ToString() );
 				stack.Pop( 1 );
-				break;
-			case Action_StringGreater:
+				SWF_NEXT_ACTION;
+			SWF_ACTION( Action_StringGreater )
 				stack.B().SetBool( stack.B().ToString() > stack.A().ToString() );
 				stack.Pop( 1 );
-				break;
-			case Action_ToInteger:
+				SWF_NEXT_ACTION;
+			SWF_ACTION( Action_ToInteger )
 				stack.A().SetInteger( stack.A().ToInteger() );
-				break;
-			case Action_CharToAscii:
+				SWF_NEXT_ACTION;
+			SWF_ACTION( Action_CharToAscii )
 				stack.A().SetInteger( stack.A().ToString()[0] );
-				break;
-			case Action_AsciiToChar:
+				SWF_NEXT_ACTION;
+			SWF_ACTION( Action_AsciiToChar )
 				stack.A().SetString( va( "%c", stack.A().ToInteger() ) );
-				break;
-			case Action_Jump:
-				bitstream.Seek( bitstream.ReadS16() );
-				break;
-			case Action_If:
+				SWF_NEXT_ACTION;
+			SWF_ACTION( Action_Jump )
+				pc = ( instruction->operand >= start && instruction->operand <= end ) ? instruction->operand : end;
+				SWF_NEXT_ACTION;
+			SWF_ACTION( Action_If )
 			{
-				int16 offset = bitstream.ReadS16();
 				if( stack.A().ToBool() )
 				{
-					bitstream.Seek( offset );
+					pc = ( instruction->operand >= start && instruction->operand <= end ) ? instruction->operand : end;
 				}
 				stack.Pop( 1 );
-				break;
+				SWF_NEXT_ACTION;
 			}
-			case Action_GetVariable:
+			SWF_ACTION( Action_GetVariable )
 			{
 				idStr variableName = stack.A().ToString();
 				for( int i = scope.Num() - 1; i >= 0; i-- )
 				{
-					stack.A() = scope[i]->Get( variableName );
+					stack.A() = scope[i]->Get( variableName, instruction->slot );
 					if( !stack.A().IsUndefined() )
 					{
 						break;
@@ -980,9 +1321,9 @@ idSWFScriptVar idSWFScriptFunction_Script::Run( idSWFScriptObject* thisObject, i
 				{
 					idLib::Printf( "SWF: unknown variable %s\n", variableName.c_str() );
 				}
-				break;
+				SWF_NEXT_ACTION;
 			}
-			case Action_SetVariable:
+			SWF_ACTION( Action_SetVariable )
 			{
 				idStr variableName = stack.B().ToString();
 				bool found = false;
@@ -1000,17 +1341,12 @@ idSWFScriptVar idSWFScriptFunction_Script::Run( idSWFScriptObject* thisObject, i
 					thisObject->Set( variableName, stack.A() );
 				}
 				stack.Pop( 2 );
-				break;
+				SWF_NEXT_ACTION;
 			}
-			case Action_GotoFrame2:
+			SWF_ACTION( Action_GotoFrame2 )
 			{
-			
-				uint32 frameNum = 0;
-				uint8 flags = bitstream.ReadU8();
-				if( flags & 2 )
-				{
-					frameNum += bitstream.ReadU16();
-				}
+				uint32 frameNum = instruction->count;
+				uint8 flags = instruction->operand;
 				
 				if( verify( thisSprite != NULL ) )
 				{
@@ -1044,9 +1380,9 @@ idSWFScriptVar idSWFScriptFunction_Script::Run( idSWFScriptObject* thisObject, i
 					}
 				}
 				stack.Pop( 1 );
-				break;
+				SWF_NEXT_ACTION;
 			}
-			case Action_GetProperty:
+			SWF_ACTION( Action_GetProperty )
 			{
 				if( verify( thisSprite != NULL ) )
 				{
@@ -1058,9 +1394,9 @@ idSWFScriptVar idSWFScriptFunction_Script::Run( idSWFScriptObject* thisObject, i
 					idLib::Printf( "SWF: no target movie clip for getProperty\n" );
 				}
 				stack.Pop( 1 );
-				break;
+				SWF_NEXT_ACTION;
 			}
-			case Action_SetProperty:
+			SWF_ACTION( Action_SetProperty )
 			{
 				if( verify( thisSprite != NULL ) )
 				{
@@ -1072,20 +1408,20 @@ idSWFScriptVar idSWFScriptFunction_Script::Run( idSWFScriptObject* thisObject, i
 					idLib::Printf( "SWF: no target movie clip for setProperty\n" );
 				}
 				stack.Pop( 3 );
-				break;
+				SWF_NEXT_ACTION;
 			}
-			case Action_Trace:
+			SWF_ACTION( Action_Trace )
 				idLib::PrintfIf( swf_debug.GetInteger() > 0, "SWF Trace: %s\n", stack.A().ToString().c_str() );
 				stack.Pop( 1 );
-				break;
-			case Action_GetTime:
+				SWF_NEXT_ACTION;
+			SWF_ACTION( Action_GetTime )
 				stack.Alloc().SetInteger( Sys_Milliseconds() );
-				break;
-			case Action_RandomNumber:
+				SWF_NEXT_ACTION;
+			SWF_ACTION( Action_RandomNumber )
 				assert( thisSprite && thisSprite->sprite && thisSprite->sprite->GetSWF() );
 				stack.A().SetInteger( thisSprite->sprite->GetSWF()->GetRandom().RandomInt( stack.A().ToInteger() ) );
-				break;
-			case Action_CallFunction:
+				SWF_NEXT_ACTION;
+			SWF_ACTION( Action_CallFunction )
 			{
 				idStr functionName = stack.A().ToString();
 				idSWFScriptVar function;
@@ -1120,9 +1456,9 @@ idSWFScriptVar idSWFScriptFunction_Script::Run( idSWFScriptObject* thisObject, i
 					stack.Alloc().SetUndefined();
 				}
 				
-				break;
+				SWF_NEXT_ACTION;
 			}
-			case Action_CallMethod:
+			SWF_ACTION( Action_CallMethod )
 			{
 				idStr functionName = stack.A().ToString();
 				// If the top stack is undefined but there is an object, it's calling the constructor
@@ -1165,20 +1501,22 @@ idSWFScriptVar idSWFScriptFunction_Script::Run( idSWFScriptObject* thisObject, i
 				{
 					stack.Alloc().SetUndefined();
 				}
-				break;
+				SWF_NEXT_ACTION;
 			}
-			case Action_ConstantPool:
+			SWF_ACTION( Action_ConstantPool )
 			{
 				constants.Clear();
-				uint16 numConstants = bitstream.ReadU16();
-				for( int i = 0; i < numConstants; i++ )
+				for( int i = 0; i < instruction->count; i++ )
 				{
-					constants.Append( idSWFScriptString::Alloc( bitstream.ReadString() ) );
+					idSWFScriptString* constant = program.constantStrings[ instruction->operand + i ];
+					constant->AddRef();
+					constants.Append( constant );
 				}
-				break;
+				SWF_NEXT_ACTION;
 			}
-			case Action_DefineFunction:
+			SWF_ACTION( Action_DefineFunction )
 			{
+				idSWFBitStream bitstream( instruction->data, instruction->length, false );
 				idStr functionName = bitstream.ReadString();
 				
 				idSWFScriptFunction_Script* newFunction = idSWFScriptFunction_Script::Alloc();
@@ -1192,8 +1530,9 @@ idSWFScriptVar idSWFScriptFunction_Script::Run( idSWFScriptObject* thisObject, i
 				{
 					newFunction->SetParameter( i, 0, bitstream.ReadString() );
 				}
+				// the body directly follows the record
 				uint16 codeSize = bitstream.ReadU16();
-				newFunction->SetData( bitstream.ReadData( codeSize ), codeSize );
+				newFunction->SetData( instruction->data + instruction->length, codeSize );
 				
 				if( functionName.IsEmpty() )
 				{
@@ -1204,10 +1543,11 @@ idSWFScriptVar idSWFScriptFunction_Script::Run( idSWFScriptObject* thisObject, i
 					thisObject->Set( functionName, idSWFScriptVar( newFunction ) );
 				}
 				newFunction->Release();
-				break;
+				SWF_NEXT_ACTION;
 			}
-			case Action_DefineFunction2:
+			SWF_ACTION( Action_DefineFunction2 )
 			{
+				idSWFBitStream bitstream( instruction->data, instruction->length, false );
 				idStr functionName = bitstream.ReadString();
 				
 				idSWFScriptFunction_Script* newFunction = idSWFScriptFunction_Script::Alloc();
@@ -1242,8 +1582,9 @@ idSWFScriptVar idSWFScriptFunction_Script::Run( idSWFScriptObject* thisObject, i
 					newFunction->SetParameter( i, reg, name );
 				}
 				
+				// the body directly follows the record
 				uint16 codeSize = bitstream.ReadU16();
-				newFunction->SetData( bitstream.ReadData( codeSize ), codeSize );
+				newFunction->SetData( instruction->data + instruction->length, codeSize );
 				
 				if( functionName.IsEmpty() )
 				{
@@ -1254,9 +1595,9 @@ idSWFScriptVar idSWFScriptFunction_Script::Run( idSWFScriptObject* thisObject, i
 					thisObject->Set( functionName, idSWFScriptVar( newFunction ) );
 				}
 				newFunction->Release();
-				break;
+				SWF_NEXT_ACTION;
 			}
-			case Action_Enumerate:
+			SWF_ACTION( Action_Enumerate )
 			{
 				idStr variableName = stack.A().ToString();
 				for( int i = scope.Num() - 1; i >= 0; i-- )
@@ -1282,9 +1623,9 @@ idSWFScriptVar idSWFScriptFunction_Script::Run( idSWFScriptObject* thisObject, i
 					}
 					object->Release();
 				}
-				break;
+				SWF_NEXT_ACTION;
 			}
-			case Action_Enumerate2:
+			SWF_ACTION( Action_Enumerate2 )
 			{
 				if( !stack.A().IsObject() )
 				{
@@ -1301,21 +1642,21 @@ idSWFScriptVar idSWFScriptFunction_Script::Run( idSWFScriptObject* thisObject, i
 					}
 					object->Release();
 				}
-				break;
+				SWF_NEXT_ACTION;
 			}
-			case Action_Equals2:
+			SWF_ACTION( Action_Equals2 )
 			{
 				stack.B().SetBool( stack.A().AbstractEquals( stack.B() ) );
 				stack.Pop( 1 );
-				break;
+				SWF_NEXT_ACTION;
 			}
-			case Action_StrictEquals:
+			SWF_ACTION( Action_StrictEquals )
 			{
 				stack.B().SetBool( stack.A().StrictEquals( stack.B() ) );
 				stack.Pop( 1 );
-				break;
+				SWF_NEXT_ACTION;
 			}
-			case Action_GetMember:
+			SWF_ACTION( Action_GetMember )
 			{
 				if( ( stack.B().IsUndefined() || stack.B().IsNULL() ) && swf_debug.GetInteger() > 1 )
 				{
@@ -1330,7 +1671,7 @@ idSWFScriptVar idSWFScriptFunction_Script::Run( idSWFScriptObject* thisObject, i
 					}
 					else
 					{
-						stack.B() = object->Get( stack.A().ToString() );
+						stack.B() = object->Get( stack.A().ToString(), instruction->slot );
 					}
 					if( stack.B().IsUndefined() && swf_debug.GetInteger() > 1 )
 					{
@@ -1385,9 +1726,9 @@ idSWFScriptVar idSWFScriptFunction_Script::Run( idSWFScriptObject* thisObject, i
 					stack.B().SetUndefined();
 				}
 				stack.Pop( 1 );
-				break;
+				SWF_NEXT_ACTION;
 			}
-			case Action_SetMember:
+			SWF_ACTION( Action_SetMember )
 			{
 				if( stack.C().IsObject() )
 				{
@@ -1398,13 +1739,13 @@ idSWFScriptVar idSWFScriptFunction_Script::Run( idSWFScriptObject* thisObject, i
 					}
 					else
 					{
-						object->Set( stack.B().ToString(), stack.A() );
+						object->Set( stack.B().ToString(), stack.A(), instruction->slot );
 					}
 				}
 				stack.Pop( 3 );
-				break;
+				SWF_NEXT_ACTION;
 			}
-			case Action_InitArray:
+			SWF_ACTION( Action_InitArray )
 			{
 				idSWFScriptObject* object = idSWFScriptObject::Alloc();
 				object->MakeArray();
@@ -1421,9 +1762,9 @@ idSWFScriptVar idSWFScriptFunction_Script::Run( idSWFScriptObject* thisObject, i
 				stack.Alloc().SetObject( object );
 				
 				object->Release();
-				break;
+				SWF_NEXT_ACTION;
 			}
-			case Action_InitObject:
+			SWF_ACTION( Action_InitObject )
 			{
 				idSWFScriptObject* object = idSWFScriptObject::Alloc();
 				
@@ -1439,9 +1780,9 @@ idSWFScriptVar idSWFScriptFunction_Script::Run( idSWFScriptObject* thisObject, i
 				stack.Alloc().SetObject( object );
 				
 				object->Release();
-				break;
+				SWF_NEXT_ACTION;
 			}
-			case Action_NewObject:
+			SWF_ACTION( Action_NewObject )
 			{
 				idSWFScriptObject* object = idSWFScriptObject::Alloc();
 				
@@ -1494,9 +1835,9 @@ idSWFScriptVar idSWFScriptFunction_Script::Run( idSWFScriptObject* thisObject, i
 				stack.Alloc().SetObject( object );
 				
 				object->Release();
-				break;
+				SWF_NEXT_ACTION;
 			}
-			case Action_Extends:
+			SWF_ACTION( Action_Extends )
 			{
 				idSWFScriptFunction* superclassConstructorFunction = stack.A().GetFunction();
 				idSWFScriptFunction* subclassConstructorFunction = stack.B().GetFunction();
@@ -1510,9 +1851,9 @@ idSWFScriptVar idSWFScriptFunction_Script::Run( idSWFScriptObject* thisObject, i
 				subclassConstructorFunction->SetPrototype( scriptObject );
 				
 				scriptObject->Release();
-				break;
+				SWF_NEXT_ACTION;
 			}
-			case Action_TargetPath:
+			SWF_ACTION( Action_TargetPath )
 			{
 				if( !stack.A().IsObject() )
 				{
@@ -1535,19 +1876,18 @@ idSWFScriptVar idSWFScriptFunction_Script::Run( idSWFScriptObject* thisObject, i
 						stack.A().SetString( dotName );
 					}
 				}
-				break;
+				SWF_NEXT_ACTION;
 			}
-			case Action_With:
+			SWF_ACTION( Action_With )
 			{
-				int withSize = bitstream.ReadU16();
-				idSWFBitStream bitstream2( bitstream.ReadData( withSize ), withSize, false );
+				int withEnd = ( instruction->operand >= pc && instruction->operand <= end ) ? instruction->operand : end;
 				if( stack.A().IsObject() )
 				{
 					idSWFScriptObject* withObject = stack.A().GetObject();
 					withObject->AddRef();
 					stack.Pop( 1 );
 					scope.Append( withObject );
-					Run( thisObject, stack, bitstream2 );
+					Run( thisObject, stack, program, pc, withEnd );
 					scope.SetNum( scope.Num() - 1 );
 					withObject->Release();
 				}
@@ -1559,18 +1899,19 @@ idSWFScriptVar idSWFScriptFunction_Script::Run( idSWFScriptObject* thisObject, i
 					}
 					stack.Pop( 1 );
 				}
-				break;
+				pc = withEnd;
+				SWF_NEXT_ACTION;
 			}
-			case Action_ToNumber:
+			SWF_ACTION( Action_ToNumber )
 				stack.A().SetFloat( stack.A().ToFloat() );
-				break;
-			case Action_ToString:
+				SWF_NEXT_ACTION;
+			SWF_ACTION( Action_ToString )
 				stack.A().SetString( stack.A().ToString() );
-				break;
-			case Action_TypeOf:
+				SWF_NEXT_ACTION;
+			SWF_ACTION( Action_TypeOf )
 				stack.A().SetString( stack.A().TypeOf() );
-				break;
-			case Action_Add2:
+				SWF_NEXT_ACTION;
+			SWF_ACTION( Action_Add2 )
 			{
 				if( stack.A().IsString() || stack.B().IsString() )
 				{
@@ -1581,9 +1922,9 @@ idSWFScriptVar idSWFScriptFunction_Script::Run( idSWFScriptObject* thisObject, i
 					stack.B().SetFloat( stack.B().ToFloat() + stack.A().ToFloat() );
 				}
 				stack.Pop( 1 );
-				break;
+				SWF_NEXT_ACTION;
 			}
-			case Action_Less2:
+			SWF_ACTION( Action_Less2 )
 			{
 				if( stack.A().IsString() && stack.B().IsString() )
 				{
@@ -1594,9 +1935,9 @@ idSWFScriptVar idSWFScriptFunction_Script::Run( idSWFScriptObject* thisObject, i
 					stack.B().SetBool( stack.B().ToFloat() < stack.A().ToFloat() );
 				}
 				stack.Pop( 1 );
-				break;
+				SWF_NEXT_ACTION;
 			}
-			case Action_Greater:
+			SWF_ACTION( Action_Greater )
 			{
 				if( stack.A().IsString() && stack.B().IsString() )
 				{
@@ -1607,9 +1948,9 @@ idSWFScriptVar idSWFScriptFunction_Script::Run( idSWFScriptObject* thisObject, i
 					stack.B().SetBool( stack.B().ToFloat() > stack.A().ToFloat() );
 				}
 				stack.Pop( 1 );
-				break;
+				SWF_NEXT_ACTION;
 			}
-			case Action_Modulo:
+			SWF_ACTION( Action_Modulo )
 			{
 				int32 a = stack.A().ToInteger();
 				int32 b = stack.B().ToInteger();
@@ -1622,70 +1963,69 @@ idSWFScriptVar idSWFScriptFunction_Script::Run( idSWFScriptObject* thisObject, i
 					stack.B().SetInteger( b % a );
 				}
 				stack.Pop( 1 );
-				break;
+				SWF_NEXT_ACTION;
 			}
-			case Action_BitAnd:
+			SWF_ACTION( Action_BitAnd )
 				stack.B().SetInteger( stack.B().ToInteger() & stack.A().ToInteger() );
 				stack.Pop( 1 );
-				break;
-			case Action_BitLShift:
+				SWF_NEXT_ACTION;
+			SWF_ACTION( Action_BitLShift )
 				stack.B().SetInteger( stack.B().ToInteger() << stack.A().ToInteger() );
 				stack.Pop( 1 );
-				break;
-			case Action_BitOr:
+				SWF_NEXT_ACTION;
+			SWF_ACTION( Action_BitOr )
 				stack.B().SetInteger( stack.B().ToInteger() | stack.A().ToInteger() );
 				stack.Pop( 1 );
-				break;
-			case Action_BitRShift:
+				SWF_NEXT_ACTION;
+			SWF_ACTION( Action_BitRShift )
 				stack.B().SetInteger( stack.B().ToInteger() >> stack.A().ToInteger() );
 				stack.Pop( 1 );
-				break;
-			case Action_BitURShift:
+				SWF_NEXT_ACTION;
+			SWF_ACTION( Action_BitURShift )
 				stack.B().SetInteger( ( uint32 )stack.B().ToInteger() >> stack.A().ToInteger() );
 				stack.Pop( 1 );
-				break;
-			case Action_BitXor:
+				SWF_NEXT_ACTION;
+			SWF_ACTION( Action_BitXor )
 				stack.B().SetInteger( stack.B().ToInteger() ^ stack.A().ToInteger() );
 				stack.Pop( 1 );
-				break;
-			case Action_Decrement:
+				SWF_NEXT_ACTION;
+			SWF_ACTION( Action_Decrement )
 				stack.A().SetFloat( stack.A().ToFloat() - 1.0f );
-				break;
-			case Action_Increment:
+				SWF_NEXT_ACTION;
+			SWF_ACTION( Action_Increment )
 				stack.A().SetFloat( stack.A().ToFloat() + 1.0f );
-				break;
-			case Action_PushDuplicate:
+				SWF_NEXT_ACTION;
+			SWF_ACTION( Action_PushDuplicate )
 			{
 				idSWFScriptVar dup = stack.A();
 				stack.Alloc() = dup;
-				break;
+				SWF_NEXT_ACTION;
 			}
-			case Action_StackSwap:
+			SWF_ACTION( Action_StackSwap )
 			{
 				idSWFScriptVar temp = stack.A();
 				stack.A() = stack.B();
 				stack.A() = temp;
-				break;
+				SWF_NEXT_ACTION;
 			}
-			case Action_StoreRegister:
+			SWF_ACTION( Action_StoreRegister )
 			{
-				uint8 registerNumber = bitstream.ReadU8();
-				registers[ registerNumber ] = stack.A();
-				break;
+				registers[ instruction->operand ] = stack.A();
+				SWF_NEXT_ACTION;
 			}
-			case Action_DefineLocal:
+			SWF_ACTION( Action_DefineLocal )
 			{
 				scope[scope.Num() - 1]->Set( stack.B().ToString(), stack.A() );
 				stack.Pop( 2 );
-				break;
+				SWF_NEXT_ACTION;
 			}
-			case Action_DefineLocal2:
+			SWF_ACTION( Action_DefineLocal2 )
 			{
 				scope[scope.Num() - 1]->Set( stack.A().ToString(), idSWFScriptVar() );
 				stack.Pop( 1 );
-				break;
+				SWF_NEXT_ACTION;
 			}
-			case Action_Delete:
+			SWF_ACTION( Action_Delete )
 			{
 				if( swf_debug.GetInteger() > 0 )
 				{
@@ -1693,9 +2033,9 @@ idSWFScriptVar idSWFScriptFunction_Script::Run( idSWFScriptObject* thisObject, i
 				}
 				// We no longer support deleting variables because the performance cost of updating the hash tables is not worth it
 				stack.Pop( 2 );
-				break;
+				SWF_NEXT_ACTION;
 			}
-			case Action_Delete2:
+			SWF_ACTION( Action_Delete2 )
 			{
 				if( swf_debug.GetInteger() > 0 )
 				{
@@ -1703,7 +2043,7 @@ idSWFScriptVar idSWFScriptFunction_Script::Run( idSWFScriptObject* thisObject, i
 				}
 				// We no longer support deleting variables because the performance cost of updating the hash tables is not worth it
 				stack.Pop( 1 );
-				break;
+				SWF_NEXT_ACTION;
 			}
 			// These are functions we just don't support because we never really needed to
 			case Action_CloneSprite:
@@ -1711,7 +2051,7 @@ idSWFScriptVar idSWFScriptFunction_Script::Run( idSWFScriptObject* thisObject, i
 			case Action_Call:
 			case Action_SetTarget2:
 			case Action_NewMethod:
-			default:
+			SWF_DEFAULT_ACTION
 				idLib::Warning( "SWF: Unhandled Action %s", idSWF::GetActionName( code ) );
 				// We have to abort here because the rest of the script is basically meaningless now
 				assert( false );
@@ -2764,14 +3104,18 @@ idStr idSWFScriptFunction_Script::ExportToScript( idSWFScriptObject* thisObject,
 			case Action_With:
 			{
 				int withSize = bitstream.ReadU16();
-				idSWFBitStream bitstream2( bitstream.ReadData( withSize ), withSize, false );
+				const byte* withData = bitstream.ReadData( withSize );
 				if( stack.A().IsObject() )
 				{
 					idSWFScriptObject* withObject = stack.A().GetObject();
 					withObject->AddRef();
 					stack.Pop( 1 );
 					scope.Append( withObject );
-					Run( thisObject, stack, bitstream2 );
+					actionProgram_t withProgram;
+					withProgram.data = withData;
+					withProgram.length = withSize;
+					DecodeProgram( withProgram );
+					Run( thisObject, stack, withProgram, 0, withProgram.instructions.Num() );
 					scope.SetNum( scope.Num() - 1 );
 					withObject->Release();
 				}
@@ -3003,6 +3347,119 @@ finish:
 }
 // RB end
 
+/*
+========================
+SWF_RecordInvoke
+========================
+*/
+static void SWF_RecordInvoke( const char* filename, const char* functionName, const idSWFParmList& parms )
+{
+	if( !swf_recordInvokes.GetBool() || swfRecordedInvokes.Num() >= MAX_RECORDED_INVOKES )
+	{
+		return;
+	}
+	
+	// objects and functions belong to the instance that is running, they can't be replayed on a fresh one
+	for( int i = 0; i < parms.Num(); i++ )
+	{
+		if( parms[i].IsObject() || parms[i].IsFunction() )
+		{
+			return;
+		}
+	}
+	
+	swfRecordedInvoke_t& invoke = swfRecordedInvokes.Alloc();
+	invoke.filename = filename;
+	invoke.functionName = functionName;
+	invoke.parms.SetNum( parms.Num() );
+	for( int i = 0; i < parms.Num(); i++ )
+	{
+		invoke.parms[i] = parms[i];
+	}
+}
+
+/*
+========================
+swf_benchmarkScripts
+
+Loads every swf that has recorded invokes and times running them
+========================
+*/
+CONSOLE_COMMAND( swf_benchmarkScripts, "replays the functions recorded with swf_recordInvokes, optional number of iterations", 0 )
+{
+	if( swfRecordedInvokes.Num() == 0 )
+	{
+		idLib::Printf( "No recorded invokes, set swf_recordInvokes 1 and use the menus first\n" );
+		return;
+	}
+	
+	int iterations = 100;
+	if( args.Argc() > 1 )
+	{
+		iterations = Max( atoi( args.Argv( 1 ) ), 1 );
+	}
+	
+	// don't record the replay
+	bool recording = swf_recordInvokes.GetBool();
+	swf_recordInvokes.SetBool( false );
+	
+	idStrList filenames;
+	for( int i = 0; i < swfRecordedInvokes.Num(); i++ )
+	{
+		filenames.AddUnique( swfRecordedInvokes[i].filename );
+	}
+	
+	uint64 totalTime = 0;
+	for( int i = 0; i < filenames.Num(); i++ )
+	{
+		idSWF* swf = new( TAG_SWF ) idSWF( filenames[i], NULL );
+		if( !swf->IsLoaded() )
+		{
+			idLib::Printf( "%s failed to load\n", filenames[i].c_str() );
+			delete swf;
+			continue;
+		}
+		swf->Activate( true );
+		
+		int numCalls = 0;
+		idSWFParmList parms;
+		uint64 startTime = Sys_Microseconds();
+		for( int j = 0; j < iterations; j++ )
+		{
+			for( int k = 0; k < swfRecordedInvokes.Num(); k++ )
+			{
+				const swfRecordedInvoke_t& invoke = swfRecordedInvokes[k];
+				if( invoke.filename != filenames[i] )
+				{
+					continue;
+				}
+				parms.SetNum( invoke.parms.Num() );
+				for( int p = 0; p < invoke.parms.Num(); p++ )
+				{
+					parms[p] = invoke.parms[p];
+				}
+				swf->Invoke( invoke.functionName, parms );
+				numCalls++;
+			}
+		}
+		uint64 endTime = Sys_Microseconds();
+		totalTime += endTime - startTime;
+		
+		idLib::Printf( "%s: %d calls in %.2f ms, %.2f us per call\n", filenames[i].c_str(), numCalls, ( endTime - startTime ) * 0.001f, numCalls > 0 ? ( float )( endTime - startTime ) / numCalls : 0.0f );
+		
+		swf->Activate( false );
+		delete swf;
+	}
+	idLib::Printf( "%d recorded invokes x %d iterations in %.2f ms\n", swfRecordedInvokes.Num(), iterations, totalTime * 0.001f );
+	
+	swf_recordInvokes.SetBool( recording );
+}
+
+CONSOLE_COMMAND( swf_clearRecordedInvokes, "clears the functions recorded with swf_recordInvokes", 0 )
+{
+	swfRecordedInvokes.Clear();
+}
+
 /*
 ========================
 idSWF::Invoke
@@ -3020,6 +3477,7 @@ void idSWF::Invoke( const char* functionName, const idSWFParmList& parms )
 	
 	if( scriptVar.IsFunction() )
 	{
+		SWF_RecordInvoke( GetName(), functionName, parms );
 		scriptVar.GetFunction()->Call( NULL, parms );
 	}
 }
@@ -3034,6 +3492,7 @@ void idSWF::Invoke( const char* functionName, const idSWFParmList& parms, idSWFS
 
 	if( scriptVar.IsFunction() )
 	{
+		SWF_RecordInvoke( GetName(), functionName, parms );
 		scriptVar.GetFunction()->Call( NULL, parms );
 	}
 	else
@@ -3043,6 +3502,7 @@ void idSWF::Invoke( const char* functionName, const idSWFParmList& parms, idSWFS
 		
 		if( scriptVar.IsFunction() )
 		{
+			SWF_RecordInvoke( GetName(), functionName, parms );
 			scriptVar.GetFunction()->Call( NULL, parms );
 		}
 	}
@@ -3065,6 +3525,7 @@ void idSWF::Invoke( const char*   functionName, const idSWFParmList& parms, bool
 	
 	if( scriptVar.IsFunction() )
 	{
+		SWF_RecordInvoke( GetName(), functionName, parms );
 		scriptVar.GetFunction()->Call( NULL, parms );
 		functionExists = true;
 	}
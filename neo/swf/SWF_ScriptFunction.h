@@ -257,7 +257,43 @@ public:
 	idStr CallToScript( idSWFScriptObject* thisObject, const idSWFParmList& parms, const char* filename, int characterID, int actionID );
 	
 private:
-	idSWFScriptVar Run( idSWFScriptObject* thisObject, idSWFStack& stack, idSWFBitStream& bitstream );
+	/*
+	========================
+	The action bytes are decoded once into a flat instruction list. Jumps are resolved
+	to instruction indexes, literals are built ahead of time and constant pool strings
+	are only allocated once, so running a function doesn't touch the bitstream at all.
+	========================
+	*/
+	struct actionInstruction_t
+	{
+		swfAction_t		code;
+		int				operand;	// jump target, register, frame, end of a with block, or first push value / constant
+		int				count;		// number of push values or constants, frame bias for GotoFrame2
+		int				slot;		// property slot hint for member and variable lookups
+		const byte* 	data;		// raw record for the actions that are still parsed when they run
+		uint16			length;
+	};
+	struct actionPushValue_t
+	{
+		uint8			type;		// 4 pushes a register, 8 and 9 push from the constant pool, everything else is a literal
+		uint16			index;
+		idSWFScriptVar	value;
+	};
+	struct actionProgram_t
+	{
+		~actionProgram_t();
+		
+		const byte* 	data;
+		uint32			length;
+		idList< actionInstruction_t, TAG_SWF >	instructions;
+		idList< actionPushValue_t, TAG_SWF >	pushValues;
+		idList< idSWFScriptString*, TAG_SWF >	constantStrings;
+	};
+	
+	actionProgram_t* 	GetProgram();
+	void				DecodeProgram( actionProgram_t& program ) const;
+	
+	idSWFScriptVar Run( idSWFScriptObject* thisObject, idSWFStack& stack, actionProgram_t& program, int start, int end );
 	
 	
 	
@@ -301,6 +337,10 @@ private:
 		uint8 reg;
 	};
 	idList< parmInfo_t, TAG_SWF > parameters;
+	
+	// sprite frame actions reuse the same function object with different data, so keep one program per data block
+	idList< actionProgram_t*, TAG_SWF > programs;
+	idHashIndex			programHash;		// programs by data block
 };
 
 #endif // !__SWF_SCRIPTFUNCTION_H__
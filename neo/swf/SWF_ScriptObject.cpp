@@ -222,6 +222,31 @@ idSWFScriptVar idSWFScriptObject::Get( int index )
 	}
 }
 
+/*
+========================
+idSWFScriptObject::Get
+========================
+*/
+idSWFScriptVar idSWFScriptObject::Get( const char* name, int& slot )
+{
+	swfNamedVar_t* variable = GetVariable( name, false, slot );
+	if( variable == NULL )
+	{
+		return idSWFScriptVar();
+	}
+	else
+	{
+		if( variable->native )
+		{
+			return variable->native->Get( this );
+		}
+		else
+		{
+			return variable->value;
+		}
+	}
+}
+
 /*
 ========================
 idSWFScriptObject::GetSprite
@@ -361,6 +386,31 @@ void idSWFScriptObject::Set( const char* name, const idSWFScriptVar& value )
 	}
 }
 
+/*
+========================
+idSWFScriptObject::Set
+========================
+*/
+void idSWFScriptObject::Set( const char* name, const idSWFScriptVar& value, int& slot )
+{
+	if( objectType == SWF_OBJECT_ARRAY )
+	{
+		// arrays have to keep their length up to date
+		Set( name, value );
+		return;
+	}
+	
+	swfNamedVar_t* variable = GetVariable( name, true, slot );
+	if( variable->native )
+	{
+		variable->native->Set( this, value );
+	}
+	else if( ( variable->flags & SWF_VAR_FLAG_READONLY ) == 0 )
+	{
+		variable->value = value;
+	}
+}
+
 /*
 ========================
 idSWFScriptObject::Set
@@ -559,6 +609,28 @@ idSWFScriptObject::swfNamedVar_t* idSWFScriptObject::GetVariable( const char* na
 	return NULL;
 }
 
+/*
+========================
+idSWFScriptObject::GetVariable
+========================
+*/
+idSWFScriptObject::swfNamedVar_t* idSWFScriptObject::GetVariable( const char* name, bool create, int& slot )
+{
+	if( slot >= 0 && slot < variables.Num() && variables[slot].name == name )
+	{
+		return &variables[slot];
+	}
+	
+	swfNamedVar_t* variable = GetVariable( name, create );
+	
+	// only remember variables that live on this object, prototype hits can't be validated by index
+	if( variable >= variables.Ptr() && variable < variables.Ptr() + variables.Num() )
+	{
+		slot = variable - variables.Ptr();
+	}
+	return variable;
+}
+
 /*
 ========================
 idSWFScriptObject::MakeArray
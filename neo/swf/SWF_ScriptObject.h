@@ -161,6 +161,12 @@ public:
 	idSWFTextInstance* 		GetText( const char* name );
 	void					Set( int index, const idSWFScriptVar& value );
 	void					Set( const char* name, const idSWFScriptVar& value );
+	
+	// same as above, but slot remembers where the variable was found last time so
+	// repeated lookups of the same name can skip the hash walk
+	idSWFScriptVar			Get( const char* name, int& slot );
+	void					Set( const char* name, const idSWFScriptVar& value, int& slot );
+	
 	void					SetNative( const char* name, idSWFScriptNativeVariable* native );
 	bool					HasProperty( const char* name );
 	bool					HasValidProperty( const char* name );
@@ -229,6 +235,7 @@ private:
 	
 	swfNamedVar_t* 	GetVariable( int index, bool create );
 	swfNamedVar_t* 	GetVariable( const char* name, bool create );
+	swfNamedVar_t* 	GetVariable( const char* name, bool create, int& slot );
 };
 
 #endif // !__SWF_SCRIPTOBJECT_H__
@@ -124,6 +124,7 @@ void idSWFSpriteInstance::FreeDisplayList()
 	{
 		sprite->swf->spriteInstanceAllocator.Free( displayList[i].spriteInstance );
 		sprite->swf->textInstanceAllocator.Free( displayList[i].textInstance );
+		sprite->swf->shapeCacheAllocator.Free( displayList[i].shapeCache );
 	}
 	displayList.SetNum( 0 );	// not calling Clear() so we don't continuously re-allocate memory
 	currentFrame = 0;
@@ -193,6 +194,10 @@ swfDisplayEntry_t* idSWFSpriteInstance::AddDisplayEntry( int depth, int characte
 			display.textInstance = sprite->swf->textInstanceAllocator.Alloc();
 			display.textInstance->Init( dictEntry->edittext, sprite->GetSWF() );
 		}
+		else if( dictEntry->type == SWF_DICT_SHAPE )
+		{
+			display.shapeCache = sprite->swf->shapeCacheAllocator.Alloc();
+		}
 	}
 	return &display;
 }
@@ -209,6 +214,7 @@ void idSWFSpriteInstance::RemoveDisplayEntry( int depth )
 	{
 		sprite->swf->spriteInstanceAllocator.Free( entry->spriteInstance );
 		sprite->swf->textInstanceAllocator.Free( entry->textInstance );
+		sprite->swf->shapeCacheAllocator.Free( entry->shapeCache );
 		displayList.RemoveIndex( displayList.IndexOf( entry ) );
 	}
 }
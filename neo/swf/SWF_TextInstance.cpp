@@ -130,6 +130,8 @@ void idSWFTextInstance::Init( idSWFEditText* _editText, idSWF* _swf )
 	
 	inputTextStartChar = 0;
 	
+	layout.font = NULL;
+	
 	renderDelay = swf_textRndLetterDelay.GetInteger();
 	needsSoundUpdate = false;
 	useDropShadow = false;
@@ -41,6 +41,39 @@ struct subTimingWordData_t
 	bool forceBreak;
 };
 
+// line breaks of the text as last drawn, these only depend on the string and
+// the layout so they can be reused until one of them changes
+struct swfTextLayout_t
+{
+	swfTextLayout_t()
+	{
+		font = NULL;
+		glyphScale = 0.0f;
+		glyphSpacer = 0.0f;
+		left = 0.0f;
+		right = 0.0f;
+		flags = 0;
+		maxLines = 0;
+	}
+	
+	bool IsCurrent( const idStr& text_, const idFont* font_, float glyphScale_, float glyphSpacer_, float left_, float right_, uint32 flags_, int maxLines_ ) const
+	{
+		return ( font != NULL && font == font_ && glyphScale == glyphScale_ && glyphSpacer == glyphSpacer_ && left == left_ && right == right_
+				 && flags == flags_ && maxLines == maxLines_ && text.Cmp( text_ ) == 0 );
+	}
+	
+	idStr		text;
+	const idFont* font;
+	float		glyphScale;
+	float		glyphSpacer;
+	float		left;
+	float		right;
+	uint32		flags;
+	int			maxLines;
+	idList< idStr >	lines;
+	idList< float >	lineWidths;
+};
+
 class idSWFTextInstance
 {
 public:
@@ -262,6 +295,8 @@ public:
 	// input text
 	int			inputTextStartChar;
 	
+	swfTextLayout_t	layout;
+	
 	idList< subTimingWordData_t, TAG_SWF > subtitleTimingInfo;
 };
 
@@ -130,13 +130,13 @@ struct swfMatrix_t
 	}
 	
 	// RB begin
-	bool operator==( const swfMatrix_t& a )
+	bool operator==( const swfMatrix_t& a ) const
 	{
 		return ( xx == a.xx && yy == a.yy && xy == a.xy && yx == a.yx && tx == a.tx && ty == a.ty );
 		
 	}
 	
-	bool operator!=( const swfMatrix_t& a )
+	bool operator!=( const swfMatrix_t& a ) const
 	{
 		return !( xx == a.xx && yy == a.yy && xy == a.xy && yx == a.yx && tx == a.tx && ty == a.ty );
 		
@@ -337,6 +337,8 @@ struct swfDisplayEntry_t
 	class idSWFSpriteInstance* spriteInstance;
 	// if this entry is text, then this will point to the specific instance of the text
 	class idSWFTextInstance* textInstance;
+	// if this entry is a shape, then this will hold the last transformed vertexes of it
+	class idSWFShapeCache* shapeCache;
 };
 struct swfRenderState_t
 {
@@ -351,6 +353,37 @@ struct swfRenderState_t
 	float ratio;
 	stereoDepthType_t stereoDepth;
 };
+struct swfShapeCacheDraw_t
+{
+	const idMaterial* material;
+	uint64 glState;
+	const idList< uint16, TAG_SWF >* indices;
+	int firstVert;
+	int numVerts;
+};
+class idSWFShapeCache
+{
+public:
+	idSWFShapeCache();
+	bool IsCurrent( const idSWFShape* shape, const swfRenderState_t& renderState, uint64 glState, const idVec2& scaleToVirtual ) const;
+	void Begin( const idSWFShape* shape, const swfRenderState_t& renderState, uint64 glState, const idVec2& scaleToVirtual );
+	void AddDraw( const idDrawVert* verts, int numVerts, const idList< uint16, TAG_SWF >& indices, const idMaterial* material, uint64 glState );
+	void Invalidate()
+	{
+		shape = NULL;
+	}
+	
+	const idSWFShape* shape;
+	swfMatrix_t matrix;
+	swfColorXform_t cxf;
+	const idMaterial* material;
+	int materialWidth;
+	int materialHeight;
+	uint64 glState;
+	idVec2 scaleToVirtual;
+	idList< swfShapeCacheDraw_t, TAG_SWF > draws;
+	idList< idDrawVert, TAG_SWF > verts;
+};
 
 ID_INLINE swfRect_t::swfRect_t() :
 	tl( 0.0f, 0.0f ),
@@ -473,7 +506,8 @@ ID_INLINE swfDisplayEntry_t::swfDisplayEntry_t() :
 	blendMode( 0 ),
 	ratio( 0.0f ),
 	spriteInstance( NULL ),
-	textInstance( NULL )
+	textInstance( NULL ),
+	shapeCache( NULL )
 {
 }
 
@@ -488,6 +522,49 @@ ID_INLINE swfRenderState_t::swfRenderState_t() :
 {
 }
 
+ID_INLINE idSWFShapeCache::idSWFShapeCache() :
+	shape( NULL ),
+	material( NULL ),
+	materialWidth( 0 ),
+	materialHeight( 0 ),
+	glState( 0 ),
+	scaleToVirtual( 0.0f, 0.0f )
+{
+}
+
+ID_INLINE bool idSWFShapeCache::IsCurrent( const idSWFShape* shape_, const swfRenderState_t& renderState, uint64 glState_, const idVec2& scaleToVirtual_ ) const
+{
+	return ( shape == shape_ && matrix == renderState.matrix && cxf.mul == renderState.cxf.mul && cxf.add == renderState.cxf.add
+			 && material == renderState.material && materialWidth == renderState.materialWidth && materialHeight == renderState.materialHeight
+			 && glState == glState_ && scaleToVirtual == scaleToVirtual_ );
+}
+
+ID_INLINE void idSWFShapeCache::Begin( const idSWFShape* shape_, const swfRenderState_t& renderState, uint64 glState_, const idVec2& scaleToVirtual_ )
+{
+	shape = shape_;
+	matrix = renderState.matrix;
+	cxf = renderState.cxf;
+	material = renderState.material;
+	materialWidth = renderState.materialWidth;
+	materialHeight = renderState.materialHeight;
+	glState = glState_;
+	scaleToVirtual = scaleToVirtual_;
+	draws.SetNum( 0 );
+	verts.SetNum( 0 );
+}
+
+ID_INLINE void idSWFShapeCache::AddDraw( const idDrawVert* verts_, int numVerts, const idList< uint16, TAG_SWF >& indices, const idMaterial* material_, uint64 glState_ )
+{
+	swfShapeCacheDraw_t& draw = draws.Alloc();
+	draw.material = material_;
+	draw.glState = glState_;
+	draw.indices = &indices;
+	draw.firstVert = verts.Num();
+	draw.numVerts = numVerts;
+	verts.SetNum( draw.firstVert + numVerts );
+	memcpy( verts.Ptr() + draw.firstVert, verts_, numVerts * sizeof( idDrawVert ) );
+}
+
 ID_INLINE idSWFFontGlyph::idSWFFontGlyph() :
 	code( 0 ),
 	advance( 0 )
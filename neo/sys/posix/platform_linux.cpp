@@ -80,7 +80,26 @@ Sys_GetProcessorId
 */
 cpuid_t Sys_GetProcessorId()
 {
-	return CPUID_GENERIC;
+	int flags = CPUID_GENERIC;
+	
+#if defined(__i386__) || defined(__x86_64__)
+	__builtin_cpu_init();
+	
+	// MMX and SSE are not reported so the SIMD code stays generic, AVX2 and FMA3
+	// only enable the idMatX kernels, AVX2 is only reported when the OS also saves
+	// the YMM registers
+	if( __builtin_cpu_supports( "avx2" ) )
+	{
+		flags |= CPUID_AVX2;
+	}
+	
+	if( __builtin_cpu_supports( "fma" ) )
+	{
+		flags |= CPUID_FMA3;
+	}
+#endif
+	
+	return ( cpuid_t )flags;
 }
 
 /*
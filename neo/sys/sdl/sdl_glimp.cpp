@@ -586,7 +586,11 @@ void GLimp_GrabInput( int flags )
 		
 	if( !window )
 	{
-		common->Warning( "GLimp_GrabInput called without window" );
+		// the null renderer never opens a window
+		if( !r_nullRenderer.GetBool() )
+		{
+			common->Warning( "GLimp_GrabInput called without window" );
+		}
 		return;
 	}
 	
@@ -58,7 +58,9 @@ enum cpuid_t
 	CPUID_FTZ							= 0x04000,	// Flush-To-Zero mode (denormal results are flushed to zero)
 	CPUID_DAZ							= 0x08000,	// Denormals-Are-Zero mode (denormal source operands are set to zero)
 	CPUID_XENON							= 0x10000,	// Xbox 360
-	CPUID_CELL							= 0x20000	// PS3
+	CPUID_CELL							= 0x20000,	// PS3
+	CPUID_AVX2							= 0x40000,	// Advanced Vector Extensions 2 with OS support for the 256 bit registers
+	CPUID_FMA3							= 0x80000	// three operand Fused Multiply-Add
 };
 
 enum fpuExceptions_t
@@ -31,6 +31,7 @@ If you have questions concerning this license or the applicable additional terms
 #include "precompiled.h"
 
 #include "win_local.h"
+#include <intrin.h>
 
 #pragma warning(disable:4740)	// warning C4740: flow in or out of inline asm code suppresses global optimization
 #pragma warning(disable:4731)	// warning C4731: 'XXX' : frame pointer register 'ebx' modified by inline assembly code
@@ -385,6 +386,53 @@ static bool HasSSE3() {
 }
 #endif
 
+/*
+================
+HasAVX2
+
+  uses the compiler intrinsics so the check is also available on Win64
+================
+*/
+static bool HasAVX2() {
+	int regs[4];
+
+	// bit 27 of ECX denotes OSXSAVE and bit 28 denotes AVX existence
+	__cpuid( regs, 1 );
+	if ( ( regs[_REG_ECX] & ( ( 1 << 27 ) | ( 1 << 28 ) ) ) != ( ( 1 << 27 ) | ( 1 << 28 ) ) ) {
+		return false;
+	}
+
+	// the OS has to save both the XMM and the YMM registers on a context switch
+	if ( ( _xgetbv( 0 ) & 6 ) != 6 ) {
+		return false;
+	}
+
+	// bit 5 of EBX denotes AVX2 existence
+	__cpuidex( regs, 7, 0 );
+	if ( regs[_REG_EBX] & ( 1 << 5 ) ) {
+		return true;
+	}
+	return false;
+}
+
+/*
+================
+HasFMA3
+================
+*/
+static bool HasFMA3() {
+	int regs[4];
+
+	// get CPU feature bits
+	__cpuid( regs, 1 );
+
+	// bit 12 of ECX denotes FMA3 existence
+	if ( regs[_REG_ECX] & ( 1 << 12 ) ) {
+		return true;
+	}
+	return false;
+}
+
 /*
 ================
 LogicalProcPerPhysicalProc
@@ -778,6 +826,14 @@ cpuid_t Sys_GetCPUId()
 	flags |= CPUID_SSE;
 	flags |= CPUID_SSE2;
 
+	// check for Advanced Vector Extensions 2 and Fused Multiply-Add
+	if ( HasAVX2() ) {
+		flags |= CPUID_AVX2;
+	}
+	if ( HasFMA3() ) {
+		flags |= CPUID_FMA3;
+	}
+
 	return (cpuid_t)flags;
 #else
 	int flags;
@@ -819,6 +875,14 @@ cpuid_t Sys_GetCPUId()
 		flags |= CPUID_SSE3;
 	}
 
+	// check for Advanced Vector Extensions 2 and Fused Multiply-Add
+	if ( HasAVX2() ) {
+		flags |= CPUID_AVX2;
+	}
+	if ( HasFMA3() ) {
+		flags |= CPUID_FMA3;
+	}
+
 	// check for Hyper-Threading Technology
 	if ( HasHTT() ) {
 		flags |= CPUID_HTT;